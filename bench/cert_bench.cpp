@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2017 Codership Oy <info@codership.com>
+ */
+
+/*!
+ * @file certification of non-conflicting write sets
+ *
+ * Measures the full slave-side path: write set unserialization,
+ * Certification::test() and index update. The local-side setup (trx
+ * creation, key append, serialization) happens inside the timed loop
+ * as well because every write set must carry a fresh last seen seqno,
+ * so the reported ns/op covers one replicate-and-certify round trip.
+ */
+
+#include "galera_bench.hpp"
+
+#include "certification.hpp"
+#include "replicator_smm.hpp"
+#include "galera_service_thd.hpp"
+#include "gu_time.h"
+
+#include <unistd.h> // unlink()
+
+using namespace galera;
+
+namespace
+{
+    // mirrors TestEnv in tests/write_set_check.cpp
+    class BenchEnv
+    {
+        class GCache_setup
+        {
+        public:
+
+            GCache_setup(gu::Config& conf) : name_("galera_bench.gcache")
+            {
+                conf.set("gcache.name", name_);
+                conf.set("gcache.size", "1M");
+            }
+
+            ~GCache_setup()
+            {
+                unlink(name_.c_str());
+            }
+
+        private:
+
+            std::string const name_;
+        };
+
+    public:
+
+        BenchEnv() :
+            conf_   (),
+            init_   (conf_, NULL, NULL),
+            gcache_setup_(conf_),
+            gcache_ (conf_, "."),
+            gcs_    (conf_, gcache_),
+            thd_    (gcs_,  gcache_, conf_)
+        {}
+
+        gu::Config&         conf()   { return conf_;   }
+        galera::ServiceThd& thd()    { return thd_;    }
+        gcache::GCache&     gcache() { return gcache_; }
+
+    private:
+
+        gu::Config         conf_;
+        galera::ReplicatorSMM::InitConfig init_;
+        GCache_setup       gcache_setup_;
+        gcache::GCache     gcache_;
+        galera::DummyGcs   gcs_;
+        galera::ServiceThd thd_;
+    };
+}
+
+static TrxHandle::LocalPool
+lp(TrxHandle::LOCAL_STORAGE_SIZE(), 4, "bench_local_pool");
+
+static TrxHandle::SlavePool
+sp(sizeof(TrxHandle), 4, "bench_slave_pool");
+
+int bench_cert (long long const iters)
+{
+    BenchEnv env;
+    Certification cert(env.conf(), env.thd(), env.gcache());
+
+    int const version(2);
+    cert.assign_initial_position(0, version);
+
+    TrxHandle::Params const trx_params("", version, KeySet::MAX_VERSION);
+    wsrep_uuid_t      const node = { {1, } };
+
+    long long const start(gu_time_monotonic());
+
+    for (long long i(0); i < iters; ++i)
+    {
+        TrxHandle* trx(TrxHandle::New(lp, trx_params, node, i + 1, i + 1));
+
+        // working set of 1024 distinct exclusive keys: no conflicts,
+        // occasional dependencies
+        int         k(i % 1024);
+        wsrep_buf_t key = { &k, sizeof(k) };
+
+        trx->append_key (KeyData (version, &key, 1, WSREP_KEY_EXCLUSIVE,
+                                  true));
+        trx->set_last_seen_seqno (i);
+        trx->flush (0);
+
+        const MappedBuffer& wc(trx->write_set_collection());
+        gu::Buffer buf(wc.size());
+        std::copy (&wc[0], &wc[0] + wc.size(), &buf[0]);
+        trx->unref();
+
+        trx = TrxHandle::New(sp);
+        size_t const offset(trx->unserialize (&buf[0], buf.size(), 0));
+        trx->append_write_set (&buf[0] + offset, buf.size() - offset);
+        trx->set_received (0, i + 1, i + 1);
+
+        if (cert.append_trx (trx) != Certification::TEST_OK)
+        {
+            trx->unref();
+            return 1;
+        }
+
+        cert.set_trx_committed (trx);
+        trx->unref();
+
+        // keep the certification index and trx map bounded
+        if ((i & 0xfff) == 0xfff) cert.purge_trxs_upto (i - 1024, true);
+    }
+
+    bench_report ("cert", iters, start, gu_time_monotonic());
+
+    return 0;
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2017 Codership Oy <info@codership.com>
+ */
+
+/*!
+ * @file driver for the subsystem microbenchmarks (built by 'scons bench')
+ *
+ * Usage: galera_bench [<name> [<iterations>]]
+ *
+ * Without arguments every benchmark is run with its default iteration
+ * count. Each benchmark prints a single line
+ *
+ *     <name>: <iterations> ops, <ns/op> ns/op
+ *
+ * The output is meant to be compared between releases, so the format
+ * and the default iteration counts should be kept stable.
+ */
+
+#include "galera_bench.hpp"
+
+#include "gu_time.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+struct BenchEntry
+{
+    const char* name;
+    int       (*func) (long long iters);
+    long long   iters; // default iteration count
+};
+
+static BenchEntry const benchmarks[] =
+{
+    { "to",        bench_to,        1000000 },
+    { "input_map", bench_input_map, 1000000 },
+    { "rb",        bench_rb,        1000000 },
+    { "key_set",   bench_key_set,    200000 },
+    { "cert",      bench_cert,        50000 }
+};
+
+static size_t const n_benchmarks(sizeof(benchmarks)/sizeof(benchmarks[0]));
+
+void
+bench_report (const char* const name,
+              long long   const iters,
+              long long   const start_ns,
+              long long   const end_ns)
+{
+    ::printf ("%s: %lld ops, %.1f ns/op\n",
+              name, iters, double(end_ns - start_ns) / iters);
+    ::fflush (stdout);
+}
+
+static int
+run (const BenchEntry& b, long long const iters)
+{
+    int const ret(b.func (iters > 0 ? iters : b.iters));
+
+    if (ret) ::fprintf (stderr, "%s: FAILED (%d)\n", b.name, ret);
+
+    return ret;
+}
+
+int main (int argc, char* argv[])
+{
+    if (argc > 1)
+    {
+        long long const iters(argc > 2 ? ::strtoll (argv[2], NULL, 10) : 0);
+
+        for (size_t i(0); i < n_benchmarks; ++i)
+        {
+            if (!::strcmp (argv[1], benchmarks[i].name))
+                return (run (benchmarks[i], iters) ?
+                        EXIT_FAILURE : EXIT_SUCCESS);
+        }
+
+        ::fprintf (stderr, "Unknown benchmark '%s'. Known:", argv[1]);
+        for (size_t i(0); i < n_benchmarks; ++i)
+            ::fprintf (stderr, " %s", benchmarks[i].name);
+        ::fprintf (stderr, "\n");
+
+        return EXIT_FAILURE;
+    }
+
+    int failed(0);
+
+    for (size_t i(0); i < n_benchmarks; ++i)
+        failed += (0 != run (benchmarks[i], 0));
+
+    return (failed ? EXIT_FAILURE : EXIT_SUCCESS);
+}
@@ -0,0 +1,24 @@
+/*
+ * Copyright (C) 2017 Codership Oy <info@codership.com>
+ */
+
+/*! @file declarations shared by the subsystem microbenchmarks */
+
+#ifndef GALERA_BENCH_HPP
+#define GALERA_BENCH_HPP
+
+/* Each bench_*() runs the given number of iterations of its hot
+ * operation, reports via bench_report() and returns 0 on success. */
+
+extern int bench_to        (long long iters); /* gu_to grab/release      */
+extern int bench_input_map (long long iters); /* EVS input map insert    */
+extern int bench_rb        (long long iters); /* ring buffer malloc/free */
+extern int bench_key_set   (long long iters); /* KeySetOut append + hash */
+extern int bench_cert      (long long iters); /* write set certification */
+
+extern void bench_report (const char* name,
+                          long long   iters,
+                          long long   start_ns,
+                          long long   end_ns);
+
+#endif /* GALERA_BENCH_HPP */
@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2017 Codership Oy <info@codership.com>
+ */
+
+/*! @file EVS input map insert for a single-node index */
+
+#include "galera_bench.hpp"
+
+#include "evs_input_map2.hpp"
+#include "evs_message2.hpp"
+#include "gu_time.h"
+
+using namespace gcomm;
+using namespace gcomm::evs;
+
+int bench_input_map (long long const iters)
+{
+    UUID   const uuid(1);
+    ViewId const view(V_REG, uuid, 1);
+
+    InputMap im;
+
+    seqno_t   const batch(256); // stay within the default seqno window
+    long long       done(0);
+
+    long long const start(gu_time_monotonic());
+
+    while (done < iters)
+    {
+        im.clear();
+        im.reset(1);
+
+        for (seqno_t s(0); s < batch && done < iters; ++s, ++done)
+        {
+            (void)im.insert (0, UserMessage (0, uuid, view, s));
+        }
+    }
+
+    bench_report ("input_map", done, start, gu_time_monotonic());
+
+    return 0;
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2017 Codership Oy <info@codership.com>
+ */
+
+/*! @file KeySetOut append: hashing and deduplication of 3-part keys */
+
+#include "galera_bench.hpp"
+
+#include "key_set.hpp"
+#include "gu_time.h"
+
+#include <cstring>
+
+using namespace galera;
+
+namespace
+{
+    class BenchBaseName : public gu::Allocator::BaseName
+    {
+        std::string str_;
+
+    public:
+
+        BenchBaseName(const char* name) : str_(name) {}
+        void print(std::ostream& os) const { os << str_; }
+    };
+}
+
+int bench_key_set (long long const iters)
+{
+    BenchBaseName const base_name("galera_bench_key_set");
+
+    KeySet::Version const ver(KeySet::MAX_VERSION);
+
+    int       const batch(1024); // keys per key set before starting over
+    long long       done(0);
+
+    long long const start(gu_time_monotonic());
+
+    while (done < iters)
+    {
+        gu::byte_t reserved[1024];
+        KeySetOut  kso(reserved, sizeof(reserved), base_name, ver);
+
+        // 3-part (db, table, pk) keys with a shared (db, table) prefix
+        // and a varying pk, like a batch of single-row updates
+        int         pk(0);
+        wsrep_buf_t parts[3] = {
+            { "db",  3 }, { "table", 6 }, { &pk, sizeof(pk) }
+        };
+
+        for (int i(0); i < batch && done < iters; ++i, ++done)
+        {
+            pk = i;
+            kso.append (KeyData (ver, parts, 3, WSREP_KEY_EXCLUSIVE, true));
+        }
+    }
+
+    bench_report ("key_set", done, start, gu_time_monotonic());
+
+    return 0;
+}
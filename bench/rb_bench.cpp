@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2017 Codership Oy <info@codership.com>
+ */
+
+/*! @file GCache ring buffer malloc/free of unordered buffers */
+
+#include "galera_bench.hpp"
+
+#include "gcache_rb_store.hpp"
+#include "gu_time.h"
+
+#include <unistd.h> // unlink()
+
+using namespace gcache;
+
+int bench_rb (long long const iters)
+{
+    std::string const name("galera_bench.rb");
+
+    ::unlink (name.c_str());
+
+    seqno2ptr_t s2p;
+    gu::UUID    gid(NULL, 0);
+    RingBuffer  rb(name, 1 << 20, s2p, gid, false, false);
+
+    MemOps::size_type const alloc_size(256);
+
+    long long const start(gu_time_monotonic());
+
+    for (long long i(0); i < iters; ++i)
+    {
+        void* const ptr(rb.malloc (alloc_size));
+
+        if (!ptr) { ::unlink (name.c_str()); return 1; }
+
+        BufferHeader* const bh(ptr2BH(ptr));
+        BH_release (bh);
+        rb.free (bh);
+    }
+
+    bench_report ("rb", iters, start, gu_time_monotonic());
+
+    ::unlink (name.c_str());
+
+    return 0;
+}
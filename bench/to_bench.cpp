@@ -0,0 +1,31 @@
+/*
+ * Copyright (C) 2017 Codership Oy <info@codership.com>
+ */
+
+/*! @file uncontended gu_to grab/release cycle */
+
+#include "galera_bench.hpp"
+
+#include "gu_to.h"
+#include "gu_time.h"
+
+int bench_to (long long const iters)
+{
+    gu_to_t* to(gu_to_create (1024, 0));
+
+    if (!to) return 1;
+
+    long long const start(gu_time_monotonic());
+
+    for (long long i(0); i < iters; ++i)
+    {
+        if (gu_to_grab    (to, i)) { gu_to_destroy (&to); return 1; }
+        if (gu_to_release (to, i)) { gu_to_destroy (&to); return 1; }
+    }
+
+    bench_report ("to", iters, start, gu_time_monotonic());
+
+    gu_to_destroy (&to);
+
+    return 0;
+}
@@ -531,6 +531,7 @@ typedef enum wsrep_pfs_instr_tag
     WSREP_PFS_INSTR_TAG_PRODCONS_CONDVAR,
     WSREP_PFS_INSTR_TAG_GCACHE_CONDVAR,
     WSREP_PFS_INSTR_TAG_RECVBUF_CONDVAR,
+    WSREP_PFS_INSTR_TAG_SAVED_STATE_CONDVAR,
 
     /* Thread tag */
     WSREP_PFS_INSTR_TAG_SERVICE_THD_THREAD,
@@ -540,6 +541,7 @@ typedef enum wsrep_pfs_instr_tag
     WSREP_PFS_INSTR_TAG_GCACHE_REMOVEFILE_THREAD,
     WSREP_PFS_INSTR_TAG_RECEIVER_THREAD,
     WSREP_PFS_INSTR_TAG_GCOMMCONN_THREAD,
+    WSREP_PFS_INSTR_TAG_SAVED_STATE_THREAD,
 
     /* File tag */
     WSREP_PFS_INSTR_TAG_RECORDSET_FILE,
@@ -0,0 +1,164 @@
+//
+// Copyright (C) 2026 Codership Oy <info@codership.com>
+//
+
+#include "action_recorder.hpp"
+#include "gcs_action_source.hpp" // GcsActionTrx
+#include "replicator.hpp"
+
+#include "gu_lock.hpp"
+#include "gu_throw.hpp"
+#include "gu_time.h"
+
+#include <cerrno>
+#include <cstring>
+
+galera::ActionRecorder::ActionRecorder (const std::string& path)
+    :
+    mutex_  (),
+    path_   (path),
+    fd_     (fopen(path.c_str(), "ab")),
+    failed_ (false)
+{
+    if (0 == fd_)
+    {
+        gu_throw_error(errno) << "Failed to open action log '" << path_
+                              << "' for appending";
+    }
+
+    Header const hdr = { MAGIC, VERSION };
+
+    if (fwrite(&hdr, sizeof(hdr), 1, fd_) != 1 || fflush(fd_) != 0)
+    {
+        int const err(errno);
+        fclose(fd_);
+        gu_throw_error(err) << "Failed to write action log header to '"
+                            << path_ << '\'';
+    }
+}
+
+galera::ActionRecorder::~ActionRecorder ()
+{
+    fclose(fd_);
+}
+
+void
+galera::ActionRecorder::record (const struct gcs_action& act)
+{
+    gu::Lock lock(mutex_);
+
+    if (gu_unlikely(failed_)) return;
+
+    RecordHdr hdr;
+    hdr.seqno_g      = act.seqno_g;
+    hdr.seqno_l      = act.seqno_l;
+    hdr.timestamp_ns = gu_time_calendar();
+    hdr.type         = act.type;
+    hdr.size         = act.size;
+
+    if (fwrite(&hdr, sizeof(hdr), 1, fd_) != 1 ||
+        (act.size > 0 && fwrite(act.buf, act.size, 1, fd_) != 1))
+    {
+        /* disable rather than stall or kill delivery: the log is a
+         * diagnostic aid, the cluster comes first */
+        failed_ = true;
+        log_error << "Failed to append to action log '" << path_ << "': "
+                  << strerror(errno) << ". Recording disabled.";
+    }
+}
+
+
+galera::ActionLogReader::ActionLogReader (const std::string& path)
+    :
+    path_ (path),
+    fd_   (fopen(path.c_str(), "rb"))
+{
+    if (0 == fd_)
+    {
+        gu_throw_error(errno) << "Failed to open action log '" << path_
+                              << "' for reading";
+    }
+
+    ActionRecorder::Header hdr;
+
+    if (fread(&hdr, sizeof(hdr), 1, fd_) != 1 ||
+        hdr.magic   != ActionRecorder::MAGIC ||
+        hdr.version != uint32_t(ActionRecorder::VERSION))
+    {
+        fclose(fd_);
+        gu_throw_error(EINVAL) << "'" << path_ << "' is not a version "
+                               << ActionRecorder::VERSION << " action log";
+    }
+}
+
+galera::ActionLogReader::~ActionLogReader ()
+{
+    fclose(fd_);
+}
+
+bool
+galera::ActionLogReader::next (Record& rec, std::vector<gu::byte_t>& buf)
+{
+    ActionRecorder::RecordHdr hdr;
+
+    if (fread(&hdr, sizeof(hdr), 1, fd_) != 1) return false;
+
+    if (hdr.size < 0)
+    {
+        log_warn << "Corrupt record in action log '" << path_
+                 << "', stopping replay";
+        return false;
+    }
+
+    buf.resize(hdr.size);
+
+    if (hdr.size > 0 && fread(&buf[0], hdr.size, 1, fd_) != 1)
+    {
+        /* truncated tail - recording was cut short, not an error */
+        log_info << "Action log '" << path_ << "' ends mid-record "
+                 << "(seqno " << hdr.seqno_g << "), stopping replay";
+        return false;
+    }
+
+    rec.seqno_g      = hdr.seqno_g;
+    rec.seqno_l      = hdr.seqno_l;
+    rec.timestamp_ns = hdr.timestamp_ns;
+    rec.type         = hdr.type;
+    rec.size         = hdr.size;
+
+    return true;
+}
+
+
+ssize_t
+galera::ReplayActionSource::process (void* recv_ctx, bool& exit_loop)
+{
+    ActionLogReader::Record rec;
+
+    if (!reader_.next(rec, buf_)) return 0; // end of log
+
+    if (GCS_ACT_TORDERED == rec.type && rec.seqno_g > 0)
+    {
+        struct gcs_action act;
+        act.buf     = buf_.size() > 0 ? &buf_[0] : 0;
+        act.size    = rec.size;
+        act.seqno_g = rec.seqno_g;
+        act.seqno_l = rec.seqno_l;
+        act.type    = static_cast<gcs_act_type_t>(rec.type);
+
+        GcsActionTrx trx(trx_pool_, act);
+        trx.trx()->set_state(TrxHandle::S_REPLICATING);
+        gu_trace(replicator_.process_trx(recv_ctx, trx.trx()));
+        exit_loop = trx.trx()->exit_loop();
+
+        ++replayed_;
+    }
+    else
+    {
+        /* conf changes, state transfers et al. need live cluster
+         * state, certification and apply do not */
+        ++skipped_;
+    }
+
+    return rec.size;
+}
@@ -0,0 +1,156 @@
+//
+// Copyright (C) 2026 Codership Oy <info@codership.com>
+//
+
+#ifndef GALERA_ACTION_RECORDER_HPP
+#define GALERA_ACTION_RECORDER_HPP
+
+#include "action_source.hpp"
+#include "trx_handle.hpp"
+
+#include "gcs.hpp" // struct gcs_action
+
+#include "gu_mutex.hpp"
+#include "gu_buffer.hpp"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace galera
+{
+    class Replicator;
+
+    /*! Record/replay facility for delivered action streams.
+     *
+     *  ActionRecorder appends every delivered action - payload plus
+     *  seqnos, type and a delivery timestamp - to an append-only log
+     *  file (enabled with repl.action_log). ActionLogReader walks such
+     *  a log back, and ReplayActionSource feeds the recorded writesets
+     *  through certification and apply again without a cluster, which
+     *  turns a production incident into an offline benchmark.
+     *
+     *  The format is native-endian with fixed-width fields: the log is
+     *  meant to be replayed on the same architecture it was taken on,
+     *  not exchanged between nodes. */
+
+    class ActionRecorder
+    {
+    public:
+
+        static int const VERSION = 1;
+
+        /*! Opens the log for appending. @throws gu::Exception */
+        ActionRecorder (const std::string& path);
+
+        ~ActionRecorder ();
+
+        /*! Appends one delivered action. Thread safe: concurrent
+         *  slave threads serialize on an internal mutex. A write
+         *  failure disables the recorder and logs an error once
+         *  rather than stalling delivery. */
+        void record (const struct gcs_action& act);
+
+    private:
+
+        struct Header
+        {
+            uint32_t magic;
+            uint32_t version;
+        };
+
+        struct RecordHdr
+        {
+            int64_t seqno_g;
+            int64_t seqno_l;
+            int64_t timestamp_ns; // calendar time at delivery
+            int32_t type;         // gcs_act_type_t
+            int32_t size;         // payload bytes following this header
+        };
+
+        static uint32_t const MAGIC = 0x47414c52; // "GALR"
+
+        gu::Mutex   mutex_;
+        std::string path_;
+        FILE*       fd_;
+        bool        failed_;
+
+        ActionRecorder (const ActionRecorder&);
+        ActionRecorder& operator= (const ActionRecorder&);
+
+        friend class ActionLogReader;
+    };
+
+    /*! Sequential reader for logs produced by ActionRecorder. */
+    class ActionLogReader
+    {
+    public:
+
+        struct Record
+        {
+            int64_t seqno_g;
+            int64_t seqno_l;
+            int64_t timestamp_ns;
+            int32_t type;
+            int32_t size;
+        };
+
+        /*! Opens the log and verifies the header. @throws gu::Exception */
+        ActionLogReader (const std::string& path);
+
+        ~ActionLogReader ();
+
+        /*! Reads the next record, payload goes into buf. A truncated
+         *  tail (crash during recording) ends the stream silently.
+         *  @return false at the end of the log */
+        bool next (Record& rec, std::vector<gu::byte_t>& buf);
+
+    private:
+
+        std::string path_;
+        FILE*       fd_;
+
+        ActionLogReader (const ActionLogReader&);
+        ActionLogReader& operator= (const ActionLogReader&);
+    };
+
+    /*! ActionSource that feeds a recorded log back through the
+     *  replicator: total order writesets go through the same
+     *  GcsActionTrx/process_trx() path as live delivery, everything
+     *  else (conf changes, state transfers) is skipped since it
+     *  cannot be meaningfully replayed without the cluster. */
+    class ReplayActionSource : public ActionSource
+    {
+    public:
+
+        ReplayActionSource (TrxHandle::SlavePool& sp,
+                            Replicator&           replicator,
+                            const std::string&    path)
+            :
+            trx_pool_   (sp),
+            replicator_ (replicator),
+            reader_     (path),
+            buf_        (),
+            replayed_   (0),
+            skipped_    (0)
+        { }
+
+        /*! @return action size, or 0 at the end of the log */
+        ssize_t process (void* recv_ctx, bool& exit_loop);
+
+        long long replayed() const { return replayed_; }
+        long long skipped()  const { return skipped_;  }
+
+    private:
+
+        TrxHandle::SlavePool&   trx_pool_;
+        Replicator&             replicator_;
+        ActionLogReader         reader_;
+        std::vector<gu::byte_t> buf_;
+        long long               replayed_;
+        long long               skipped_;
+    };
+
+} /* namespace galera */
+
+#endif /* GALERA_ACTION_RECORDER_HPP */
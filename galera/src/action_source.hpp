@@ -5,6 +5,8 @@
 #ifndef GALERA_ACTION_SOURCE_HPP
 #define GALERA_ACTION_SOURCE_HPP
 
+#include <sys/types.h> // ssize_t
+
 namespace galera
 {
     class ActionSource
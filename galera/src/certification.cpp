@@ -4,8 +4,10 @@
 
 #include "certification.hpp"
 #include "uuid.hpp"
+#include "galera_common.hpp"
 
 #include "gu_lock.hpp"
+#include "gu_maintenance.hpp"
 #include "gu_throw.hpp"
 
 #include <map>
@@ -23,6 +25,10 @@ static std::string const CERT_PARAM_PREFIX("cert.");
 
 std::string const galera::Certification::PARAM_LOG_CONFLICTS(CERT_PARAM_PREFIX +
                                                              "log_conflicts");
+std::string const galera::Certification::PARAM_MAX_INDEX_BYTES(
+    CERT_PARAM_PREFIX + "max_index_bytes");
+std::string const galera::Certification::PARAM_SNAPSHOT_INTERVAL(
+    CERT_PARAM_PREFIX + "snapshot_interval");
 
 static std::string const CERT_PARAM_MAX_LENGTH   (CERT_PARAM_PREFIX +
                                                   "max_length");
@@ -30,6 +36,8 @@ static std::string const CERT_PARAM_LENGTH_CHECK (CERT_PARAM_PREFIX +
                                                   "length_check");
 
 static std::string const CERT_PARAM_LOG_CONFLICTS_DEFAULT("no");
+static std::string const CERT_PARAM_MAX_INDEX_BYTES_DEFAULT("0"); // unlimited
+static std::string const CERT_PARAM_SNAPSHOT_INTERVAL_DEFAULT("0"); // off
 
 /*** It is EXTREMELY important that these constants are the same on all nodes.
  *** Don't change them ever!!! ***/
@@ -40,6 +48,10 @@ void
 galera::Certification::register_params(gu::Config& cnf)
 {
     cnf.add(CERT_PARAM_LOG_CONFLICTS, CERT_PARAM_LOG_CONFLICTS_DEFAULT);
+    cnf.add(galera::Certification::PARAM_MAX_INDEX_BYTES,
+            CERT_PARAM_MAX_INDEX_BYTES_DEFAULT);
+    cnf.add(galera::Certification::PARAM_SNAPSHOT_INTERVAL,
+            CERT_PARAM_SNAPSHOT_INTERVAL_DEFAULT);
     /* The defaults below are deliberately not reflected in conf: people
      * should not know about these dangerous setting unless they read RTFM. */
     cnf.add(CERT_PARAM_MAX_LENGTH);
@@ -66,6 +78,18 @@ length_check(const gu::Config& conf)
         return gu::Config::from_config<int>(CERT_PARAM_LENGTH_CHECK_DEFAULT);
 }
 
+/* location of the cert index snapshot, empty when snapshots are off */
+static std::string
+snapshot_file(const gu::Config& conf)
+{
+    if (conf.get<long long>(
+            galera::Certification::PARAM_SNAPSHOT_INTERVAL) <= 0)
+        return "";
+
+    return conf.get(galera::BASE_DIR, galera::BASE_DIR_DEFAULT)
+        + "/cert.index";
+}
+
 void
 galera::Certification::purge_for_trx_v1to2(TrxHandle* trx)
 {
@@ -121,10 +145,13 @@ galera::Certification::purge_for_trx_v3(TrxHandle* trx)
         KeySet::Key::Prefix const p(kp.prefix());
 
         KeyEntryNG ke(kp);
-        CertIndexNG::iterator const ci(cert_index_ng_.find(&ke));
+        unsigned int const s(cert_index_ng_.shard_of(ke));
+        gu::Lock     lock(cert_index_ng_.mutex(s));
+        CertIndexNG& index(cert_index_ng_.index(s));
+        CertIndexNG::iterator const ci(index.find(&ke));
 
-//        assert(ci != cert_index_ng_.end());
-        if (gu_unlikely(cert_index_ng_.end() == ci))
+//        assert(ci != index.end());
+        if (gu_unlikely(index.end() == ci))
         {
             log_warn << "Missing key";
             continue;
@@ -139,8 +166,9 @@ galera::Certification::purge_for_trx_v3(TrxHandle* trx)
 
             if (kep->referenced() == false)
             {
-                cert_index_ng_.erase(ci);
+                index.erase(ci);
                 delete kep;
+                cert_index_ng_.filter(s).count_erase();
             }
         }
     }
@@ -155,6 +183,472 @@ galera::Certification::purge_for_trx(TrxHandle* trx)
         purge_for_trx_v1to2(trx);
 }
 
+void
+galera::Certification::purge_and_discard(TrxHandle* trx, bool index_locked)
+{
+    {
+        TrxHandleLock lock(*trx);
+
+        if (trx->is_committed() == false)
+        {
+            log_warn << "trx not committed in purge and discard: " << *trx;
+        }
+
+        if (trx->depends_seqno() > -1)
+        {
+            if (trx->new_version() || index_locked)
+            {
+                purge_for_trx(trx);
+            }
+            else
+            {
+                /* the pre-v3 index is protected by mutex_, which the
+                 * appliers hold in do_test_v1to2 - take it here so the
+                 * background purge does not race them */
+                gu::Lock index_lock(mutex_);
+                purge_for_trx(trx);
+            }
+        }
+
+        if (trx->refcnt() > 1)
+        {
+            log_debug << "trx "     << trx->trx_id()
+                      << " refcnt " << trx->refcnt();
+        }
+    }
+    trx->unref();
+}
+
+/* how many retired trxs are purged per batch. The retire mutex is released
+ * between batches, so this bounds the stall a purge can impose on the
+ * threads retiring trxs. */
+static size_t const cert_purge_batch_size(256);
+
+/* above this retire backlog the purge runs regardless of load: deferring
+ * further would let the backlog (and the memory it pins) grow faster
+ * than a deferred purge can ever catch up */
+static size_t const cert_purge_defer_max_backlog(8192);
+
+void*
+galera::Certification::purge_thd_func(void* arg)
+{
+    galera::Certification* cert(
+        reinterpret_cast<galera::Certification*>(arg));
+
+    while (true)
+    {
+        std::vector<TrxHandle*> batch;
+        bool snapshot(false);
+
+        {
+            gu::Lock lock(cert->retire_mutex_);
+
+            cert->purge_in_progress_ = false;
+
+            while (cert->retire_list_.empty() &&
+                   cert->snapshot_due_ == false &&
+                   cert->purge_thd_exit_ == false)
+            {
+                cert->retire_drained_.broadcast();
+                lock.wait(cert->retire_cond_);
+            }
+
+            /* whatever is left in the list is drained by the destructor */
+            if (cert->purge_thd_exit_) break;
+
+            /* purge batches and snapshots are heavy enough to show up in
+             * commit latency when they collide with a replication burst.
+             * Defer them - within a bound - until the burst is over,
+             * unless somebody is waiting for the drain. */
+            gu::MaintenanceGauge const& gauge(gu::MaintenanceGauge::process());
+            long long deferred_ns(0);
+
+            while (gauge.idle() == false                            &&
+                   deferred_ns < gu::MaintenanceGauge::MAX_DEFER_NS &&
+                   cert->retire_list_.size() < cert_purge_defer_max_backlog &&
+                   cert->drain_waiters_ == 0                        &&
+                   cert->purge_thd_exit_ == false)
+            {
+                try
+                {
+                    lock.wait(cert->retire_cond_,
+                              gu::datetime::Date::calendar() +
+                              gu::MaintenanceGauge::POLL_NS);
+                }
+                catch (gu::Exception& e)
+                {
+                    if (e.get_errno() != ETIMEDOUT) throw;
+                }
+
+                deferred_ns += gu::MaintenanceGauge::POLL_NS;
+            }
+
+            if (cert->purge_thd_exit_) break;
+
+            snapshot = cert->snapshot_due_;
+            cert->snapshot_due_ = false;
+
+            size_t const n(std::min(cert->retire_list_.size(),
+                                    cert_purge_batch_size));
+
+            batch.assign(cert->retire_list_.begin(),
+                         cert->retire_list_.begin() + n);
+            cert->retire_list_.erase(cert->retire_list_.begin(),
+                                     cert->retire_list_.begin() + n);
+
+            cert->purge_in_progress_ = true;
+        }
+
+        for (size_t i(0); i < batch.size(); ++i)
+        {
+            cert->purge_and_discard(batch[i]);
+        }
+
+        /* gcache buffers may be freed once the entries aliasing them are
+         * gone - fire the release horizons this batch completed */
+        {
+            wsrep_seqno_t release(-1);
+
+            {
+                gu::Lock lock(cert->retire_mutex_);
+
+                cert->purged_count_ += batch.size();
+
+                while (cert->release_list_.empty() == false &&
+                       cert->release_list_.front().count <=
+                       cert->purged_count_)
+                {
+                    release = cert->release_list_.front().seqno;
+                    cert->release_list_.pop_front();
+                }
+            }
+
+            if (release > 0) cert->service_thd_.release_seqno(release);
+        }
+
+        /* erases accumulate stale bits in the shard bloom filters,
+         * refresh them while off the hot path anyway */
+        cert->cert_index_ng_.maybe_rebuild_filters();
+
+        if (gu_unlikely(snapshot)) cert->write_snapshot_();
+    }
+
+    return 0;
+}
+
+void
+galera::Certification::drain_retired()
+{
+    gu::Lock lock(retire_mutex_);
+
+    ++drain_waiters_;
+    retire_cond_.signal(); // wake the worker if it is deferring
+
+    while (retire_list_.empty() == false || purge_in_progress_ == true)
+    {
+        lock.wait(retire_drained_);
+    }
+
+    --drain_waiters_;
+}
+
+/* Snapshot format, native-endian and fixed-width (a snapshot is only ever
+ * read back by the same node): header with magic, format version and the
+ * certification position at the time the dump was triggered, then one
+ * record per index entry - key length, last shared and exclusive reference
+ * seqnos, raw serialized key bytes - and a zero key length terminator
+ * marking a complete file. */
+static uint32_t const CERT_SNAPSHOT_MAGIC  (0x47434958); // "GCIX"
+static uint32_t const CERT_SNAPSHOT_VERSION(1);
+
+/* in-memory image of one snapshot record while loading */
+struct CertSnapshotRec
+{
+    size_t   off;
+    uint32_t len;
+    int64_t  seqnos[galera::KeySet::Key::P_LAST + 1];
+};
+
+void
+galera::Certification::write_snapshot_()
+{
+    assert(!snapshot_file_.empty());
+
+    std::string const tmp(snapshot_file_ + ".tmp");
+    FILE* const fd(fopen(tmp.c_str(), "wb"));
+
+    if (!fd)
+    {
+        log_warn << "Failed to open cert index snapshot file '" << tmp
+                 << "': " << errno << " (" << strerror(errno) << ')';
+        return;
+    }
+
+    long long const start(gu_time_monotonic());
+    int64_t   const position(snapshot_position_);
+
+    bool ok(fwrite(&CERT_SNAPSHOT_MAGIC,   sizeof(uint32_t), 1, fd) == 1 &&
+            fwrite(&CERT_SNAPSHOT_VERSION, sizeof(uint32_t), 1, fd) == 1 &&
+            fwrite(&position,              sizeof(position), 1, fd) == 1);
+
+    size_t entries(0);
+
+    for (unsigned int s(0); ok && s < CertIndexShardedNG::N_SHARDS; ++s)
+    {
+        /* shards are dumped one at a time, so entries retired or added
+         * while the dump runs may be missed - acceptable, the snapshot
+         * only seeds dependency tracking */
+        gu::Lock lock(cert_index_ng_.mutex(s));
+        CertIndexNG& index(cert_index_ng_.index(s));
+
+        for (CertIndexNG::const_iterator i(index.begin());
+             ok && i != index.end(); ++i)
+        {
+            const KeyEntryNG* const ke(*i);
+
+            int64_t seqnos[KeySet::Key::P_LAST + 1];
+            bool    referenced(false);
+
+            for (int p(0); p <= KeySet::Key::P_LAST; ++p)
+            {
+                const TrxHandle* const ref(
+                    ke->ref_trx(KeySet::Key::Prefix(p)));
+                seqnos[p] = (ref ? ref->global_seqno() :
+                             WSREP_SEQNO_UNDEFINED);
+                referenced = (referenced || 0 != ref);
+            }
+
+            if (!referenced) continue;
+
+            uint32_t const key_len(ke->key().serial_size());
+
+            ok = (fwrite(&key_len, sizeof(key_len), 1, fd)  == 1 &&
+                  fwrite(seqnos,   sizeof(seqnos),  1, fd)  == 1 &&
+                  fwrite(ke->key().ptr(), key_len,  1, fd)  == 1);
+            ++entries;
+        }
+    }
+
+    uint32_t const terminator(0);
+    ok = ok && (fwrite(&terminator, sizeof(terminator), 1, fd) == 1);
+    ok = (0 == fclose(fd)) && ok;
+    if (ok) ok = (0 == rename(tmp.c_str(), snapshot_file_.c_str()));
+
+    if (ok)
+    {
+        log_info << "Cert index snapshot at " << position << ": "
+                 << entries << " entries, "
+                 << (gu_time_monotonic() - start)/1000000 << "ms";
+    }
+    else
+    {
+        log_warn << "Failed to write cert index snapshot '"
+                 << snapshot_file_ << '\'';
+        unlink(tmp.c_str());
+    }
+}
+
+void
+galera::Certification::load_snapshot_(wsrep_seqno_t const position)
+{
+    assert(restored_position_ == -1);
+
+    FILE* const fd(fopen(snapshot_file_.c_str(), "rb"));
+
+    if (!fd) return; // no snapshot saved, normal on first start
+
+    uint32_t magic(0), fmt(0);
+    int64_t  snap_pos(WSREP_SEQNO_UNDEFINED);
+
+    if (fread(&magic, sizeof(magic), 1, fd) != 1 ||
+        magic != CERT_SNAPSHOT_MAGIC             ||
+        fread(&fmt, sizeof(fmt), 1, fd)     != 1 ||
+        fmt   != CERT_SNAPSHOT_VERSION           ||
+        fread(&snap_pos, sizeof(snap_pos), 1, fd) != 1)
+    {
+        log_warn << "Ignoring unreadable cert index snapshot '"
+                 << snapshot_file_ << '\'';
+        fclose(fd);
+        return;
+    }
+
+    if (snap_pos <= 0 || snap_pos > position ||
+        position - snap_pos > max_length_)
+    {
+        log_info << "Ignoring cert index snapshot at " << snap_pos
+                 << ": not usable at position " << position;
+        fclose(fd);
+        return;
+    }
+
+    /* first slurp the records - restored_buf_ must stop growing before
+     * index entries can point into it */
+    std::vector<CertSnapshotRec> recs;
+    bool complete(false);
+
+    while (true)
+    {
+        CertSnapshotRec rec;
+
+        if (fread(&rec.len, sizeof(rec.len), 1, fd) != 1) break;
+        if (0 == rec.len) { complete = true; break; }
+        if (rec.len > KeySet::KeyPart::TMP_STORE_SIZE) break; // corrupt
+
+        rec.off = restored_buf_.size();
+        if (fread(rec.seqnos, sizeof(rec.seqnos), 1, fd) != 1) break;
+        restored_buf_.resize(rec.off + rec.len);
+        if (fread(&restored_buf_[rec.off], rec.len, 1, fd) != 1) break;
+        recs.push_back(rec);
+    }
+
+    fclose(fd);
+
+    if (!complete)
+    {
+        log_warn << "Ignoring truncated cert index snapshot '"
+                 << snapshot_file_ << '\'';
+        std::vector<gu::byte_t>().swap(restored_buf_);
+        return;
+    }
+
+    /* rebuild the entries, one placeholder trx handle per distinct
+     * referenced seqno */
+    typedef std::map<wsrep_seqno_t, TrxHandle*> PlaceholderMap;
+    PlaceholderMap placeholders;
+    size_t         entries(0);
+
+    for (size_t r(0); r < recs.size(); ++r)
+    {
+        try
+        {
+            KeySet::KeyPart const kp(&restored_buf_[recs[r].off],
+                                     recs[r].len);
+            KeyEntryNG ke(kp);
+
+            size_t       const h(KeyEntryHashNG()(ke));
+            unsigned int const s(cert_index_ng_.shard_of(ke));
+            gu::Lock           lock(cert_index_ng_.mutex(s));
+            CertIndexNG&       index(cert_index_ng_.index(s));
+
+            CertIndexNG::iterator const ci(index.find(&ke));
+            KeyEntryNG* kep;
+
+            if (index.end() == ci)
+            {
+                kep = new KeyEntryNG(ke);
+                index.insert(kep);
+                cert_index_ng_.filter(s).add(h);
+                ++entries;
+            }
+            else
+            {
+                kep = *ci;
+            }
+
+            for (int p(0); p <= KeySet::Key::P_LAST; ++p)
+            {
+                wsrep_seqno_t const seqno(recs[r].seqnos[p]);
+
+                if (seqno < 0) continue;
+
+                TrxHandle* trx;
+                PlaceholderMap::iterator const pi(placeholders.find(seqno));
+
+                if (placeholders.end() == pi)
+                {
+                    trx = TrxHandle::New(restored_pool_);
+                    trx->set_received(0, -1, seqno);
+                    placeholders.insert(std::make_pair(seqno, trx));
+                    restored_trxs_.push_back(trx);
+                }
+                else
+                {
+                    trx = pi->second;
+                }
+
+                kep->ref(KeySet::Key::Prefix(p), kp, trx);
+            }
+        }
+        catch (gu::Exception& e)
+        {
+            log_warn << "Abandoning cert index snapshot load: " << e.what();
+            break;
+        }
+    }
+
+    if (!restored_trxs_.empty())
+    {
+        restored_position_ = snap_pos;
+        log_info << "Restored cert index snapshot at " << snap_pos << ": "
+                 << entries << " entries, " << restored_trxs_.size()
+                 << " pre-restart writesets known for dependency tracking";
+    }
+    else
+    {
+        std::vector<gu::byte_t>().swap(restored_buf_);
+    }
+}
+
+void
+galera::Certification::sweep_restored_()
+{
+    if (restored_position_ < 0) return;
+
+    size_t erased(0);
+
+    for (unsigned int s(0); s < CertIndexShardedNG::N_SHARDS; ++s)
+    {
+        gu::Lock lock(cert_index_ng_.mutex(s));
+        CertIndexNG& index(cert_index_ng_.index(s));
+
+        for (CertIndexNG::iterator i(index.begin()); i != index.end();)
+        {
+            KeyEntryNG* const kep(*i);
+
+            for (int p(0); p <= KeySet::Key::P_LAST; ++p)
+            {
+                KeySet::Key::Prefix const pfx(
+                    static_cast<KeySet::Key::Prefix>(p));
+                const TrxHandle*    const ref(kep->ref_trx(pfx));
+
+                /* anything at or below the restored position can only be
+                 * a placeholder - live trxs are all beyond it */
+                if (ref && ref->global_seqno() <= restored_position_)
+                {
+                    kep->unref(pfx, const_cast<TrxHandle*>(ref));
+                }
+            }
+
+            if (kep->referenced() == false)
+            {
+                CertIndexNG::iterator const victim(i);
+                ++i;
+                index.erase(victim);
+                delete kep;
+                cert_index_ng_.filter(s).count_erase();
+                ++erased;
+            }
+            else
+            {
+                ++i;
+            }
+        }
+    }
+
+    for (size_t t(0); t < restored_trxs_.size(); ++t)
+    {
+        restored_trxs_[t]->unref();
+    }
+
+    restored_trxs_.clear();
+    std::vector<gu::byte_t>().swap(restored_buf_);
+
+    log_info << "Dropped restored cert index state: " << erased
+             << " entries, horizon " << restored_position_;
+
+    restored_position_ = WSREP_SEQNO_UNDEFINED;
+}
+
 
 /*! for convenience returns true if conflict and false if not */
 static inline bool
@@ -479,7 +973,8 @@ static inline bool
 certify_and_depend_v3(const galera::KeyEntryNG*   const found,
                       const galera::KeySet::KeyPart&    key,
                       galera::TrxHandle*          const trx,
-                      bool                        const log_conflict)
+                      bool                        const log_conflict,
+                      wsrep_seqno_t               const restored_horizon)
 {
     const galera::TrxHandle* const ref_trx(
         found->ref_trx(galera::KeySet::Key::P_EXCLUSIVE));
@@ -500,7 +995,13 @@ certify_and_depend_v3(const galera::KeyEntryNG*   const found,
         // cert conflict takes place if
         // 1) write sets originated from different nodes, are within cert range
         // 2) ref_trx is in isolation mode, write sets are within cert range
+        // References at or below the restored horizon come from a loaded
+        // index snapshot: they sharpen depends_seqno below but must never
+        // decide a conflict - a node restarted into pre-restart history
+        // cannot make that call consistently with the rest of the group
+        // (a joiner with an empty index would pass such a writeset too).
         if ((trx->source_id() != ref_trx->source_id() || ref_trx->is_toi()) &&
+            ref_seqno >  restored_horizon                                   &&
             ref_seqno >  trx->last_seen_seqno())
         {
             if (gu_unlikely(log_conflict == true))
@@ -530,9 +1031,16 @@ certify_and_depend_v3(const galera::KeyEntryNG*   const found,
 
             depends_seqno = std::max(ref_shared_trx->global_seqno(),
                                      depends_seqno);
+
+            /* the index keeps only the latest shared ref, earlier readers
+             * are covered only by the seqno watermark */
+            trx->add_dep_base(ref_shared_trx->global_seqno());
         }
     }
 
+    /* exclusive ref identifies the dependency exactly */
+    if (0 != ref_trx) trx->add_dep_seqno(ref_seqno);
+
     trx->set_depends_seqno(std::max(trx->depends_seqno(), depends_seqno));
 
     return false;
@@ -541,20 +1049,45 @@ certify_and_depend_v3(const galera::KeyEntryNG*   const found,
 
 /* returns true on collision, false otherwise */
 static bool
-certify_v3(galera::Certification::CertIndexNG& cert_index_ng,
+certify_v3(galera::Certification::CertIndexShardedNG& cert_index_sharded,
            const galera::KeySet::KeyPart&      key,
            galera::TrxHandle*                  trx,
-           bool const store_keys, bool const   log_conflicts)
+           bool const store_keys, bool const   log_conflicts,
+           wsrep_seqno_t const                 restored_horizon)
 {
     galera::KeyEntryNG ke(key);
+    size_t const       h(galera::KeyEntryHashNG()(ke));
+    unsigned int const s(cert_index_sharded.shard_of(ke));
+    gu::Lock           lock(cert_index_sharded.mutex(s));
+    galera::Certification::CertIndexNG& cert_index_ng(
+        cert_index_sharded.index(s));
+    galera::Certification::CertIndexShardedNG::KeyFilter& filter(
+        cert_index_sharded.filter(s));
+
+    /* most keys probe the index in vain - let the bloom filter resolve
+     * definite misses without touching the hash map buckets */
+    if (filter.maybe_contains(h) == false)
+    {
+        if (store_keys)
+        {
+            cert_index_ng.insert(new galera::KeyEntryNG(ke));
+            filter.add(h);
+
+            cert_debug << "created new entry";
+        }
+        return false;
+    }
+
     galera::Certification::CertIndexNG::iterator ci(cert_index_ng.find(&ke));
 
     if (cert_index_ng.end() == ci)
     {
+        /* bloom filter false positive */
         if (store_keys)
         {
             galera::KeyEntryNG* const kep(new galera::KeyEntryNG(ke));
             ci = cert_index_ng.insert(kep).first;
+            filter.add(h);
 
             cert_debug << "created new entry";
         }
@@ -568,7 +1101,8 @@ certify_v3(galera::Certification::CertIndexNG& cert_index_ng,
         // Note: For we skip certification for isolated trxs, only
         // cert index and key_list is populated.
         return (!trx->is_toi() &&
-                certify_and_depend_v3(kep, key, trx, log_conflicts));
+                certify_and_depend_v3(kep, key, trx, log_conflicts,
+                                      restored_horizon));
     }
 }
 
@@ -593,13 +1127,22 @@ galera::Certification::do_test_v3(TrxHandle* trx, bool store_keys)
     {
         const KeySet::KeyPart& key(key_set.next());
 
-        if (certify_v3(cert_index_ng_, key, trx, store_keys, log_conflicts_))
+        if (certify_v3(cert_index_ng_, key, trx, store_keys, log_conflicts_,
+                       restored_position_))
         {
+            count_conflict(key);
             goto cert_fail;
         }
     }
 
-    trx->set_depends_seqno(std::max(trx->depends_seqno(), last_pa_unsafe_));
+    {
+        gu::Lock lock(mutex_);
+        trx->set_depends_seqno(std::max(trx->depends_seqno(),
+                                        last_pa_unsafe_));
+        /* a pa-unsafe trx entered the apply monitor alone, so once it has
+         * left everything below it has left too - a watermark dep */
+        trx->add_dep_base(last_pa_unsafe_);
+    }
 
     if (store_keys == true)
     {
@@ -610,20 +1153,33 @@ galera::Certification::do_test_v3(TrxHandle* trx, bool store_keys)
         {
             const KeySet::KeyPart& k(key_set.next());
             KeyEntryNG ke(k);
-            CertIndexNG::const_iterator ci(cert_index_ng_.find(&ke));
+            unsigned int const s(cert_index_ng_.shard_of(ke));
+            gu::Lock     shard_lock(cert_index_ng_.mutex(s));
+            CertIndexNG& index(cert_index_ng_.index(s));
+            CertIndexNG::const_iterator ci(index.find(&ke));
+            KeyEntryNG* kep;
 
-            if (ci == cert_index_ng_.end())
+            if (gu_likely(ci != index.end()))
             {
-                gu_throw_fatal << "could not find key '" << k
-                               << "' from cert index";
+                kep = *ci;
+            }
+            else
+            {
+                /* the shard lock was dropped between certification above
+                 * and taking the reference here, so a concurrent purge
+                 * (commit cut) may have discarded an unreferenced entry
+                 * in between - recreate it */
+                kep = new KeyEntryNG(ke);
+                index.insert(kep);
+                cert_index_ng_.filter(s).add(KeyEntryHashNG()(ke));
             }
-
-            KeyEntryNG* const kep(*ci);
 
             kep->ref(k.prefix(), k, trx);
 
         }
 
+        gu::Lock lock(mutex_);
+
         if (trx->pa_unsafe()) last_pa_unsafe_ = trx->global_seqno();
 
         key_count_ += key_count;
@@ -648,18 +1204,22 @@ cert_fail:
         {
             KeyEntryNG ke(key_set.next());
 
-            // Clean up cert_index_ from entries which were added by this trx
-            CertIndexNG::iterator ci(cert_index_ng_.find(&ke));
+            // Clean up cert index from entries which were added by this trx
+            unsigned int const s(cert_index_ng_.shard_of(ke));
+            gu::Lock     shard_lock(cert_index_ng_.mutex(s));
+            CertIndexNG& index(cert_index_ng_.index(s));
+            CertIndexNG::iterator ci(index.find(&ke));
 
-            if (gu_likely(ci != cert_index_ng_.end()))
+            if (gu_likely(ci != index.end()))
             {
                 KeyEntryNG* kep(*ci);
 
                 if (kep->referenced() == false)
                 {
-                    // kel was added to cert_index_ by this trx -
-                    // remove from cert_index_ and fall through to delete
-                    cert_index_ng_.erase(ci);
+                    // kel was added to cert index by this trx -
+                    // remove from cert index and fall through to delete
+                    index.erase(ci);
+                    cert_index_ng_.filter(s).count_erase();
                 }
                 else continue;
 
@@ -723,27 +1283,41 @@ galera::Certification::do_test(TrxHandle* trx, bool store_keys)
 
     TestResult res(TEST_FAILED);
 
-    gu::Lock lock(mutex_); // why do we need that? - e.g. set_trx_committed()
-
-    /* initialize parent seqno */
-    if ((trx->flags() & (TrxHandle::F_ISOLATION | TrxHandle::F_PA_UNSAFE))
-        || trx_map_.empty())
     {
-        trx->set_depends_seqno(trx->global_seqno() - 1);
-    }
-    else
-    {
-        trx->set_depends_seqno(
-            trx_map_.begin()->second->global_seqno() - 1);
+        gu::Lock lock(mutex_); // why do we need that? - e.g. set_trx_committed()
+
+        /* initialize parent seqno */
+        if ((trx->flags() & (TrxHandle::F_ISOLATION | TrxHandle::F_PA_UNSAFE))
+            || trx_map_.empty())
+        {
+            trx->set_depends_seqno(trx->global_seqno() - 1);
+        }
+        else
+        {
+            trx->set_depends_seqno(
+                trx_map_.begin()->second->global_seqno() - 1);
+
+            /* exact dependency tracking: everything below the parent seqno
+             * must have been applied, dependencies above it are recorded
+             * one by one as index matches are found */
+            if (3 == version_) trx->reset_dep_seqnos(trx->depends_seqno());
+        }
     }
 
     switch (version_)
     {
     case 1:
     case 2:
+    {
+        gu::Lock lock(mutex_);
         res = do_test_v1to2(trx, store_keys);
         break;
+    }
     case 3:
+        /* the v3 index is sharded by key hash and each shard is locked
+         * individually as keys are scanned, so certification of trxs with
+         * independent key sets proceeds in parallel without blocking on
+         * mutex_. */
         res = do_test_v3(trx, store_keys);
         break;
     default:
@@ -751,18 +1325,50 @@ galera::Certification::do_test(TrxHandle* trx, bool store_keys)
                        << version_ << " not implemented";
     }
 
+    {
+        gu::Lock lock(mutex_);
+
+        if (store_keys == true && res == TEST_OK)
+        {
+            ++trx_count_;
+        }
+
+        byte_count_ += trx->size();
+
+        if (gu_unlikely(max_index_bytes_ > 0))
+        {
+            long long const bytes(KeyEntryNG::allocated_bytes());
+
+            if (bytes > max_index_bytes_ && !index_cap_warned_)
+            {
+                index_cap_warned_ = true;
+                log_warn << "certification index holds " << bytes
+                         << " bytes, over the " << PARAM_MAX_INDEX_BYTES
+                         << " limit of " << max_index_bytes_
+                         << ". The index is freed only by advancing the "
+                            "purge horizon - check for a lagging node "
+                            "holding back flow control.";
+            }
+            else if (index_cap_warned_ && bytes < max_index_bytes_/2)
+            {
+                index_cap_warned_ = false;
+                log_info << "certification index size " << bytes
+                         << " back under the " << PARAM_MAX_INDEX_BYTES
+                         << " limit";
+            }
+        }
+    }
+
     if (store_keys == true && res == TEST_OK)
     {
-        ++trx_count_;
-        gu::Lock lock(stats_mutex_);
         ++n_certified_;
         deps_dist_ += (trx->global_seqno() - trx->depends_seqno());
+        deps_dist_hist_.record(trx->global_seqno() - trx->depends_seqno());
         cert_interval_ += (trx->global_seqno() - trx->last_seen_seqno() - 1);
-        index_size_ = (cert_index_.size() + cert_index_ng_.size());
+        index_size_ = static_cast<long long>(cert_index_.size() +
+                                             cert_index_ng_.size());
     }
 
-    byte_count_ += trx->size();
-
     return res;
 }
 
@@ -828,23 +1434,48 @@ galera::Certification::Certification(gu::Config& conf, ServiceThd& thd, gcache::
     last_pa_unsafe_        (-1),
     last_preordered_seqno_ (position_),
     last_preordered_id_    (0),
-#ifdef HAVE_PSI_INTERFACE
-    stats_mutex_           (WSREP_PFS_INSTR_TAG_STATS_MUTEX),
-#else
-    stats_mutex_           (),
-#endif /* HAVE_PSI_INTERFACE */
     n_certified_           (0),
     deps_dist_             (0),
     cert_interval_         (0),
     index_size_            (0),
+    deps_dist_hist_        (),
+    conflict_mutex_        (),
+    conflict_counts_       (),
     key_count_             (0),
     byte_count_            (0),
     trx_count_             (0),
 
+    retire_mutex_          (),
+    retire_cond_           (),
+    retire_drained_        (),
+    retire_list_           (),
+    release_list_          (),
+    retired_count_         (0),
+    purged_count_          (0),
+    purge_in_progress_     (false),
+    drain_waiters_         (0),
+    purge_thd_exit_        (false),
+    purge_thd_              (),
+
+    snapshot_file_         (snapshot_file(conf)),
+    snapshot_interval_     (conf.get<long long>(PARAM_SNAPSHOT_INTERVAL)),
+    next_snapshot_seqno_   (-1),
+    snapshot_due_          (false),
+    snapshot_position_     (-1),
+
+    restored_pool_         (sizeof(TrxHandle), 16, "RestoredTrxHandle"),
+    restored_buf_          (),
+    restored_trxs_         (),
+    restored_position_     (-1),
+
     max_length_            (max_length(conf)),
     max_length_check_      (length_check(conf)),
-    log_conflicts_         (conf.get<bool>(CERT_PARAM_LOG_CONFLICTS))
-{}
+    log_conflicts_         (conf.get<bool>(CERT_PARAM_LOG_CONFLICTS)),
+    max_index_bytes_       (conf.get<long long>(PARAM_MAX_INDEX_BYTES)),
+    index_cap_warned_      (false)
+{
+    gu_thread_create(&purge_thd_, NULL, purge_thd_func, this);
+}
 
 
 galera::Certification::~Certification()
@@ -861,9 +1492,24 @@ galera::Certification::~Certification()
     log_debug << "avg cert interval "          << avg_cert_interval;
     log_debug << "cert index size "            << index_size;
 
+    /* stop background purge and drain whatever is left of the retire list */
+    {
+        gu::Lock lock(retire_mutex_);
+        purge_thd_exit_ = true;
+        retire_cond_.signal();
+    }
+    gu_thread_join(purge_thd_, NULL);
+
+    while (retire_list_.empty() == false)
+    {
+        purge_and_discard(retire_list_.front());
+        retire_list_.pop_front();
+    }
+
     gu::Lock lock(mutex_);
 
     for_each(trx_map_.begin(), trx_map_.end(), PurgeAndDiscard(*this));
+    sweep_restored_();
     service_thd_.release_seqno(position_);
     service_thd_.flush();
 }
@@ -886,8 +1532,16 @@ void galera::Certification::assign_initial_position(wsrep_seqno_t seqno,
                        << version << " not supported";
     }
 
+    /* all retired trxs must be purged before the index emptiness asserts
+     * below can hold */
+    drain_retired();
+
     gu::Lock lock(mutex_);
 
+    /* restored entries are not backed by trx_map_, drop them first so
+     * that the index emptiness asserts below hold */
+    sweep_restored_();
+
     if (seqno >= position_)
     {
         std::for_each(trx_map_.begin(), trx_map_.end(), PurgeAndDiscard(*this));
@@ -900,8 +1554,6 @@ void galera::Certification::assign_initial_position(wsrep_seqno_t seqno,
                  << seqno;
         std::for_each(cert_index_.begin(), cert_index_.end(),
                       gu::DeleteObject());
-        std::for_each(cert_index_ng_.begin(), cert_index_ng_.end(),
-                      gu::DeleteObject());
         std::for_each(trx_map_.begin(), trx_map_.end(),
                       Unref2nd<TrxMap::value_type>());
         cert_index_.clear();
@@ -913,6 +1565,8 @@ void galera::Certification::assign_initial_position(wsrep_seqno_t seqno,
     log_info << "Assign initial position for certification: " << seqno
              << ", protocol version: " << version;
 
+    bool const first_assignment(initial_position_ == -1);
+
     initial_position_      = seqno;
     position_              = seqno;
     safe_to_discard_seqno_ = seqno;
@@ -920,6 +1574,18 @@ void galera::Certification::assign_initial_position(wsrep_seqno_t seqno,
     last_preordered_seqno_ = position_;
     last_preordered_id_    = 0;
     version_               = version;
+
+    if (snapshot_interval_ > 0 && seqno >= 0)
+    {
+        next_snapshot_seqno_ = seqno + snapshot_interval_;
+
+        /* seed the index with the pre-restart snapshot, startup only -
+         * later reassignments mean the state came from elsewhere */
+        if (first_assignment && version >= 3 && seqno > 0)
+        {
+            load_snapshot_(seqno);
+        }
+    }
 }
 
 
@@ -942,6 +1608,61 @@ galera::Certification::test(TrxHandle* trx, bool bval)
 }
 
 
+void
+galera::Certification::count_conflict(const KeySet::KeyPart& key)
+{
+    uint32_t const digest(static_cast<uint32_t>(key.hash()));
+
+    gu::Lock lock(conflict_mutex_);
+
+    ConflictMap::iterator i(conflict_counts_.find(digest));
+
+    if (i != conflict_counts_.end())
+    {
+        ++(i->second);
+    }
+    else if (conflict_counts_.size() < MAX_CONFLICT_DIGESTS)
+    {
+        conflict_counts_.insert(std::make_pair(digest, 1LL));
+    }
+    /* else: map is full, new digests go uncounted until stats_reset() -
+     * better than unbounded growth on a pathological workload */
+}
+
+
+std::string
+galera::Certification::conflict_digests() const
+{
+    /* invert into count order and report the top entries */
+    typedef std::multimap<long long, uint32_t> ByCount;
+    ByCount by_count;
+
+    {
+        gu::Lock lock(conflict_mutex_);
+
+        for (ConflictMap::const_iterator i(conflict_counts_.begin());
+             i != conflict_counts_.end(); ++i)
+        {
+            by_count.insert(std::make_pair(i->second, i->first));
+        }
+    }
+
+    static size_t const MAX_REPORTED = 8;
+
+    std::ostringstream os;
+    size_t n(0);
+
+    for (ByCount::const_reverse_iterator i(by_count.rbegin());
+         i != by_count.rend() && n < MAX_REPORTED; ++i, ++n)
+    {
+        if (n > 0) os << ',';
+        os << std::hex << i->second << std::dec << ':' << i->first;
+    }
+
+    return os.str();
+}
+
+
 wsrep_seqno_t galera::Certification::get_safe_to_discard_seqno_() const
 {
     wsrep_seqno_t retval;
@@ -967,10 +1688,46 @@ galera::Certification::purge_trxs_upto_(wsrep_seqno_t const seqno,
 
     cert_debug << "purging index up to " << seqno;
 
-    for_each(trx_map_.begin(), purge_bound, PurgeAndDiscard(*this));
+    /* detach the purged range under the cert lock and leave the index
+     * cleanup and freeing to the background purge thread */
+    {
+        gu::Lock lock(retire_mutex_);
+
+        for (TrxMap::iterator i(trx_map_.begin()); i != purge_bound; ++i)
+        {
+            retire_list_.push_back(i->second);
+            ++retired_count_;
+        }
+
+        if (handle_gcache)
+        {
+            /* index entries alias writeset buffers in gcache, so the
+             * buffers may be released only once every trx detached so far
+             * has been purged - leave the release to the purge thread */
+            if (purged_count_ >= retired_count_)
+            {
+                service_thd_.release_seqno(seqno);
+            }
+            else
+            {
+                ReleaseMark mark;
+                mark.count = retired_count_;
+                mark.seqno = seqno;
+                release_list_.push_back(mark);
+            }
+        }
+
+        if (retire_list_.empty() == false) retire_cond_.signal();
+    }
+
     trx_map_.erase(trx_map_.begin(), purge_bound);
 
-    if (handle_gcache) service_thd_.release_seqno(seqno);
+    /* once the purge horizon covers the snapshot position the organic
+     * index has re-learned everything the restored entries knew */
+    if (gu_unlikely(restored_position_ >= 0 && seqno >= restored_position_))
+    {
+        sweep_restored_();
+    }
 
     if (0 == ((trx_map_.size() + 1) % 10000))
     {
@@ -1011,6 +1768,18 @@ galera::Certification::append_trx(TrxHandle* trx)
 
         position_ = trx->global_seqno();
 
+        if (gu_unlikely(snapshot_interval_ > 0 &&
+                        position_ >= next_snapshot_seqno_))
+        {
+            next_snapshot_seqno_ = position_ + snapshot_interval_;
+
+            /* hand the dump to the background purge thread */
+            gu::Lock rlock(retire_mutex_);
+            snapshot_due_      = true;
+            snapshot_position_ = position_;
+            retire_cond_.signal();
+        }
+
         if (gu_unlikely(!(position_ & max_length_check_) &&
                         (trx_map_.size() > static_cast<size_t>(max_length_))))
         {
@@ -1119,3 +1888,29 @@ galera::Certification::set_log_conflicts(const std::string& str)
     }
 }
 
+void
+galera::Certification::set_max_index_bytes(const std::string& str)
+{
+    try
+    {
+        long long const val(gu::Config::from_config<long long>(str));
+
+        if (val < 0)
+        {
+            gu_throw_error(EINVAL) << "Negative value '" << str
+                                   << "' for parameter '"
+                                   << PARAM_MAX_INDEX_BYTES << '\'';
+        }
+
+        gu::Lock lock(mutex_);
+        max_index_bytes_  = val;
+        index_cap_warned_ = false; // rearm the warning for the new limit
+    }
+    catch (gu::NotFound& e)
+    {
+        gu_throw_error(EINVAL) << "Bad value '" << str
+                               << "' for parameter '"
+                               << PARAM_MAX_INDEX_BYTES << '\'';
+    }
+}
+
@@ -11,11 +11,16 @@
 
 #include "gu_unordered.hpp"
 #include "gu_lock.hpp"
+#include "gu_atomic.hpp"
+#include "gu_hdr_histogram.hpp"
 #include "gu_config.hpp"
+#include "gu_utils.hpp"
 
+#include <deque>
 #include <map>
 #include <set>
 #include <list>
+#include <vector>
 
 namespace galera
 {
@@ -24,6 +29,8 @@ namespace galera
     public:
 
         static std::string const PARAM_LOG_CONFLICTS;
+        static std::string const PARAM_MAX_INDEX_BYTES;
+        static std::string const PARAM_SNAPSHOT_INTERVAL;
 
         static void register_params(gu::Config&);
 
@@ -34,6 +41,237 @@ namespace galera
                                  KeyEntryPtrHashNG, KeyEntryPtrEqualNG>
         CertIndexNG;
 
+        /* CertIndexNG partitioned by key hash into independently locked
+         * shards, so that index operations on unrelated keys don't contend
+         * on a common mutex. Key hash is stable across key versions, hence
+         * matching keys always map to the same shard. */
+        class CertIndexShardedNG
+        {
+        public:
+
+            static unsigned int const N_SHARDS = 16; // must be power of 2
+
+            /* Blocked bloom filter in front of a shard: two bits per key
+             * within a single cache line sized block, so a negative probe
+             * costs one memory access instead of a bucket array miss plus
+             * a chain walk. Bits are set on insert and never cleared -
+             * erases only bump a staleness counter - hence "absent"
+             * answers are always reliable. The filter is rebuilt from the
+             * surviving entries (and sized to the current population) by
+             * maybe_rebuild(), which the purge thread runs between
+             * batches. All access happens under the owning shard mutex. */
+            class KeyFilter
+            {
+            public:
+
+                KeyFilter()
+                    : words_(MIN_WORDS, 0), keys_(0), erased_(0),
+                      probes_(0), negatives_(0)
+                {}
+
+                void add(size_t const h)
+                {
+                    words_[word1(h)] |= bit1(h);
+                    words_[word2(h)] |= bit2(h);
+                    ++keys_;
+                }
+
+                bool maybe_contains(size_t const h) const
+                {
+                    ++probes_;
+                    bool const ret((words_[word1(h)] & bit1(h)) != 0 &&
+                                   (words_[word2(h)] & bit2(h)) != 0);
+                    negatives_ += !ret;
+                    return ret;
+                }
+
+                long long probes()    const { return probes_;    }
+                long long negatives() const { return negatives_; }
+
+                void count_erase() { ++erased_; }
+
+                void maybe_rebuild(const CertIndexNG& index)
+                {
+                    /* rebuild when erased keys have accumulated enough to
+                     * hurt the negative hit rate or when the population
+                     * has outgrown the filter */
+                    bool const stale(erased_ > 64 && erased_ > keys_/4);
+                    bool const full (keys_ > 8*words_.size());
+
+                    if (gu_unlikely(stale || full)) rebuild(index);
+                }
+
+                void reset()
+                {
+                    words_.assign(MIN_WORDS, 0);
+                    keys_      = 0;
+                    erased_    = 0;
+                    probes_    = 0;
+                    negatives_ = 0;
+                }
+
+            private:
+
+                static size_t const MIN_WORDS   = 256; // 2K, power of 2
+                static size_t const BLOCK_WORDS = 8;   // 64-byte cache line
+
+                /* the low log2(N_SHARDS) hash bits select the shard and
+                 * carry no information here, the block index consumes the
+                 * bits above them and the in-block bit picks come from a
+                 * multiplicative remix of the remainder */
+                size_t block(size_t const h) const
+                {
+                    return (((h >> 4) & (words_.size()/BLOCK_WORDS - 1))
+                            * BLOCK_WORDS);
+                }
+
+                static size_t remix(size_t const h)
+                {
+                    /* the high half of a multiplicative hash - the low
+                     * product bits depend only on the low input bits
+                     * already consumed by block() */
+                    return (((h >> 4) * 2654435761U) >> 14);
+                }
+
+                size_t   word1(size_t const h) const
+                { return (block(h) + (remix(h) & (BLOCK_WORDS - 1))); }
+
+                size_t   word2(size_t const h) const
+                { return (block(h) + ((remix(h) >> 9) & (BLOCK_WORDS - 1))); }
+
+                static uint64_t bit1(size_t const h)
+                { return (uint64_t(1) << ((remix(h) >> 3) & 63)); }
+
+                static uint64_t bit2(size_t const h)
+                { return (uint64_t(1) << ((remix(h) >> 12) & 63)); }
+
+                void rebuild(const CertIndexNG& index)
+                {
+                    /* two bits per key in at least 8 keys per word keeps
+                     * the fill factor around 25% */
+                    size_t words(MIN_WORDS);
+                    while (words * 8 < index.size()) words <<= 1;
+
+                    words_.assign(words, 0);
+                    keys_   = 0;
+                    erased_ = 0;
+
+                    for (CertIndexNG::const_iterator i(index.begin());
+                         i != index.end(); ++i)
+                    {
+                        add((*i)->key().hash());
+                    }
+                }
+
+                std::vector<uint64_t> words_;
+                size_t                keys_;   // keys added since rebuild
+                size_t                erased_; // keys erased since rebuild
+                /* probe statistics, cumulative across rebuilds; mutable
+                 * because counting happens in the const probe path (all
+                 * access is under the shard mutex regardless) */
+                mutable long long     probes_;
+                mutable long long     negatives_;
+            };
+
+            unsigned int shard_of(const KeyEntryNG& ke) const
+            {
+                return (KeyEntryHashNG()(ke) & (N_SHARDS - 1));
+            }
+
+            CertIndexNG& index (unsigned int const s) { return index_[s];  }
+            gu::Mutex&   mutex (unsigned int const s) { return mutex_[s];  }
+            KeyFilter&   filter(unsigned int const s) { return filter_[s]; }
+
+            /* filter rebuilds are folded into the purge cycle, see
+             * purge_thd_func() */
+            void maybe_rebuild_filters()
+            {
+                for (unsigned int s(0); s < N_SHARDS; ++s)
+                {
+                    gu::Lock lock(mutex_[s]);
+                    filter_[s].maybe_rebuild(index_[s]);
+                }
+            }
+
+            size_t size() const
+            {
+                size_t ret(0);
+                for (unsigned int s(0); s < N_SHARDS; ++s)
+                {
+                    gu::Lock lock(mutex_[s]);
+                    ret += index_[s].size();
+                }
+                return ret;
+            }
+
+            size_t bucket_count()
+            {
+                size_t ret(0);
+                for (unsigned int s(0); s < N_SHARDS; ++s)
+                {
+                    gu::Lock lock(mutex_[s]);
+                    ret += index_[s].bucket_count();
+                }
+                return ret;
+            }
+
+            /* longest and average hash chain over all shards - the upper
+             * bound and the expected cost of an index probe. O(bucket
+             * count), meant for stats scrapes only. */
+            void chain_stats(size_t& max_chain, double& avg_chain)
+            {
+                size_t max_c(0), entries(0), buckets(0);
+                for (unsigned int s(0); s < N_SHARDS; ++s)
+                {
+                    gu::Lock lock(mutex_[s]);
+                    size_t const bc(index_[s].bucket_count());
+                    for (size_t b(0); b < bc; ++b)
+                    {
+                        max_c = std::max(max_c, index_[s].bucket_size(b));
+                    }
+                    entries += index_[s].size();
+                    buckets += bc;
+                }
+                max_chain = max_c;
+                avg_chain = buckets ? double(entries)/buckets : 0;
+            }
+
+            /* cumulative filter probes and definite-miss short circuits
+             * over all shards - negatives/probes is the fraction of key
+             * certifications that never touched the hash map */
+            void filter_stats(long long& probes, long long& negatives)
+            {
+                long long p(0), n(0);
+                for (unsigned int s(0); s < N_SHARDS; ++s)
+                {
+                    gu::Lock lock(mutex_[s]);
+                    p += filter_[s].probes();
+                    n += filter_[s].negatives();
+                }
+                probes    = p;
+                negatives = n;
+            }
+
+            /* deletes all remaining entries, leaves the index empty */
+            void clear()
+            {
+                for (unsigned int s(0); s < N_SHARDS; ++s)
+                {
+                    gu::Lock lock(mutex_[s]);
+                    std::for_each(index_[s].begin(), index_[s].end(),
+                                  gu::DeleteObject());
+                    index_[s].clear();
+                    filter_[s].reset();
+                }
+            }
+
+        private:
+
+            CertIndexNG index_ [N_SHARDS];
+            gu::Mutex   mutex_ [N_SHARDS];
+            KeyFilter   filter_[N_SHARDS];
+        };
+
     private:
 
         typedef std::multiset<wsrep_seqno_t>        DepsSet;
@@ -85,24 +323,51 @@ namespace galera
                        double& avg_deps_dist,
                        size_t& index_size) const
         {
-            gu::Lock lock(stats_mutex_);
+            /* lock-free monitoring snapshot: the counters are relaxed
+             * atomics, so they may be mutually inconsistent by a
+             * transaction or two - fine for statistics */
+            long long const n(n_certified_());
+
             avg_cert_interval = 0;
             avg_deps_dist = 0;
-            if (n_certified_)
+            if (n)
             {
-                avg_cert_interval = double(cert_interval_) / n_certified_;
-                avg_deps_dist = double(deps_dist_) / n_certified_;
+                avg_cert_interval = double(cert_interval_()) / n;
+                avg_deps_dist = double(deps_dist_()) / n;
             }
-            index_size = index_size_;
+            index_size = index_size_();
+        }
+
+        /* distribution of dependency distance (seqno - depends_seqno)
+         * over certified writesets - predicts achievable apply
+         * parallelism much better than the running average above */
+        const gu::HdrHistogram& deps_dist_histogram() const
+        {
+            return deps_dist_hist_;
+        }
+
+        /* "digest:count,..." of the most conflict-prone keys */
+        std::string conflict_digests() const;
+
+        void index_chain_stats(size_t& max_chain, double& avg_chain)
+        {
+            cert_index_ng_.chain_stats(max_chain, avg_chain);
+        }
+
+        void index_filter_stats(long long& probes, long long& negatives)
+        {
+            cert_index_ng_.filter_stats(probes, negatives);
         }
 
         void stats_reset()
         {
-            gu::Lock lock(stats_mutex_);
             cert_interval_ = 0;
             deps_dist_ = 0;
             n_certified_ = 0;
             index_size_ = 0;
+            deps_dist_hist_.clear();
+            gu::Lock lock(conflict_mutex_);
+            conflict_counts_.clear();
         }
 
         size_t bucket_count ()
@@ -111,7 +376,17 @@ namespace galera
                 cert_index_ng_.bucket_count();
         }
 
+        /* bytes consumed by the certification index: live entries plus
+         * hash bucket arrays. Only v3 entries are counted precisely -
+         * the legacy v1-2 index predates the accounting. */
+        long long index_bytes()
+        {
+            return KeyEntryNG::allocated_bytes() +
+                static_cast<long long>(bucket_count() * sizeof(void*));
+        }
+
         void set_log_conflicts(const std::string& str);
+        void set_max_index_bytes(const std::string& str);
 
     private:
 
@@ -127,6 +402,34 @@ namespace galera
         wsrep_seqno_t get_safe_to_discard_seqno_() const;
         wsrep_seqno_t purge_trxs_upto_(wsrep_seqno_t, bool sync);
 
+        /* purge a single retired trx: unreference its keys in the cert
+         * index and drop our reference to it. index_locked tells whether
+         * the caller already holds mutex_ (needed for the pre-v3 index). */
+        void purge_and_discard(TrxHandle*, bool index_locked = false);
+
+        /* wait until the background thread has drained the retire list */
+        void drain_retired();
+
+        static void* purge_thd_func(void*);
+
+        /* cert index snapshot / restore.
+         *
+         * The index is periodically dumped to <base_dir>/cert.index by the
+         * background purge thread (key bytes plus the seqnos of the last
+         * shared and exclusive references) and restored at startup, so
+         * that a quickly restarting node resumes with its dependency
+         * knowledge instead of an empty index. Restored entries reference
+         * placeholder trx handles and are used ONLY to compute
+         * depends_seqno: conflict decisions against pre-restart history
+         * cannot be made consistently with the rest of the group (a fresh
+         * joiner would not make them either), so certify_and_depend_v3()
+         * treats any reference at or below restored_position_ as
+         * dependency-only. The whole restored set is dropped in one sweep
+         * once the purge horizon passes the snapshot position. */
+        void write_snapshot_();
+        void load_snapshot_(wsrep_seqno_t position);
+        void sweep_restored_(); // under mutex_
+
         bool index_purge_required()
         {
             static unsigned int const KEYS_THRESHOLD (1   << 10); // 1K
@@ -150,28 +453,8 @@ namespace galera
 
             void operator()(TrxMap::value_type& vt) const
             {
-                {
-                    TrxHandle* trx(vt.second);
-                    TrxHandleLock lock(*trx);
-
-                    if (trx->is_committed() == false)
-                    {
-                        log_warn << "trx not committed in purge and discard: "
-                                 << *trx;
-                    }
-
-                    if (trx->depends_seqno() > -1)
-                    {
-                        cert_.purge_for_trx(trx);
-                    }
-
-                    if (trx->refcnt() > 1)
-                    {
-                        log_debug << "trx "     << trx->trx_id()
-                                  << " refcnt " << trx->refcnt();
-                    }
-                }
-                vt.second->unref();
+                /* for_each callers hold mutex_ already */
+                cert_.purge_and_discard(vt.second, true);
             }
 
             PurgeAndDiscard(const PurgeAndDiscard& other) : cert_(other.cert_)
@@ -183,10 +466,26 @@ namespace galera
             Certification& cert_;
         };
 
+        /* Retired trxs detached from trx_map_, waiting to be purged by the
+         * background purge thread in bounded batches. This keeps the long
+         * index cleanup walks out of the cert lock. */
+        typedef std::deque<TrxHandle*> RetireList;
+
+        /* gcache release horizon pending on purge completion: index
+         * entries alias writeset buffers in gcache, so the buffers up to
+         * seqno may be freed only after every trx detached before the
+         * mark (count) has been purged */
+        struct ReleaseMark
+        {
+            long long     count;
+            wsrep_seqno_t seqno;
+        };
+        typedef std::deque<ReleaseMark> ReleaseList;
+
         int           version_;
         TrxMap        trx_map_;
         CertIndex     cert_index_;
-        CertIndexNG   cert_index_ng_;
+        CertIndexShardedNG cert_index_ng_;
         DepsSet       deps_set_;
         ServiceThd&   service_thd_;
         gcache::GCache& gcache_;
@@ -203,21 +502,54 @@ namespace galera
         wsrep_seqno_t last_pa_unsafe_;
         wsrep_seqno_t last_preordered_seqno_;
         wsrep_trx_id_t last_preordered_id_;
-#ifdef HAVE_PSI_INTERFACE
-        gu::MutexWithPFS
-                      stats_mutex_;
-#else
-        gu::Mutex     stats_mutex_;
-#endif /* HAVE_PSI_INTERFACE */
-        size_t        n_certified_;
-        wsrep_seqno_t deps_dist_;
-        wsrep_seqno_t cert_interval_;
-        size_t        index_size_;
+        /* statistics counters, kept as relaxed atomics so that
+         * stats_get() never has to take a certification-path lock */
+        gu::StatCounter<long long> n_certified_;
+        gu::StatCounter<long long> deps_dist_;
+        gu::StatCounter<long long> cert_interval_;
+        gu::StatCounter<long long> index_size_;
+        gu::HdrHistogram      deps_dist_hist_;
+
+        /* conflict counters keyed by digest of the certification key that
+         * failed the test. Updated only on cert failure (slow path), so a
+         * plain map under its own mutex is fine. Capped so that a workload
+         * conflicting on ever-changing rows can't grow it unboundedly. */
+        typedef std::map<uint32_t, long long> ConflictMap;
+        static size_t const MAX_CONFLICT_DIGESTS = 1024;
+        gu::Mutex     conflict_mutex_;
+        ConflictMap   conflict_counts_;
+
+        void count_conflict(const KeySet::KeyPart& key);
 
         size_t        key_count_;
         size_t        byte_count_;
         size_t        trx_count_;
 
+        gu::Mutex     retire_mutex_;
+        gu::Cond      retire_cond_;    // wakes up the purge thread
+        gu::Cond      retire_drained_; // signals that retire list is empty
+        RetireList    retire_list_;
+        ReleaseList   release_list_;  // under retire_mutex_
+        long long     retired_count_; // total trxs ever detached
+        long long     purged_count_;  // total trxs purged so far
+        bool          purge_in_progress_;
+        int           drain_waiters_;   // threads blocked in drain_retired()
+        bool          purge_thd_exit_;
+        gu_thread_t   purge_thd_;
+
+        /* snapshot state, see write_snapshot_() */
+        std::string   const snapshot_file_;     // empty - disabled
+        long long     const snapshot_interval_; // seqnos between snapshots
+        wsrep_seqno_t       next_snapshot_seqno_;
+        bool                snapshot_due_;      // under retire_mutex_
+        wsrep_seqno_t       snapshot_position_; // position at trigger time
+
+        /* restored index state, see load_snapshot_() */
+        TrxHandle::SlavePool    restored_pool_;
+        std::vector<gu::byte_t> restored_buf_;  // owns restored key bytes
+        std::vector<TrxHandle*> restored_trxs_; // placeholder references
+        wsrep_seqno_t           restored_position_; // -1: nothing restored
+
         /* The only reason those are not static constants is because
          * there might be a need to thange them without recompilation.
          * see #454 */
@@ -228,6 +560,14 @@ namespace galera
         unsigned int const max_length_check_; /* Mask how often to check */
 
         bool               log_conflicts_;
+
+        /* soft cap on index_bytes(), 0 - unlimited. The index can't be
+         * evicted or spilled without breaking certification determinism
+         * (all nodes must probe identical state), so breaching the cap
+         * logs an escalating warning instead - the actual pressure relief
+         * is the purge horizon advancing. */
+        long long          max_index_bytes_;
+        bool               index_cap_warned_;
     };
 }
 
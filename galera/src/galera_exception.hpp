@@ -29,6 +29,21 @@ public:
         }
     }
 
+    /*! Status-only construction for expected high-frequency outcomes
+     *  (apply retry after conflict, BF abort): nothing is formatted,
+     *  the catcher logs whatever diagnostic it needs from the context
+     *  it already has. */
+    explicit ApplyException (int err)
+        : gu::Exception ("", err)
+    {
+        if (err < 0) // sanity check
+        {
+            log_fatal
+                << "Attempt to throw exception with a " << err << " code";
+            abort();
+        }
+    }
+
     /* this is just int because we must handle any positive value */
     int status () { return get_errno(); }
 };
@@ -60,6 +60,12 @@ namespace galera
         virtual void    get_stats(gcs_stats*) const = 0;
         virtual void    flush_stats() = 0;
         virtual void    get_status(gu::Status&) const = 0;
+
+        /*! Registers the slave queue watermark callback, see
+         *  gcs_set_recv_q_watermark_cb(). */
+        virtual void    set_recv_q_watermark_cb(gcs_watermark_cb_t cb,
+                                                void* ctx) = 0;
+
         /*! @throws NotFound */
         virtual void    param_set (const std::string& key,
                                    const std::string& value) = 0;
@@ -215,6 +221,11 @@ namespace galera
             gcs_get_status(conn_, status);
         }
 
+        void set_recv_q_watermark_cb(gcs_watermark_cb_t cb, void* ctx)
+        {
+            gcs_set_recv_q_watermark_cb(conn_, cb, ctx);
+        }
+
         void param_set (const std::string& key, const std::string& value)
         {
             long ret = gcs_param_set (conn_, key.c_str(), value.c_str());
@@ -384,6 +395,8 @@ namespace galera
         void get_status(gu::Status& status) const
         {}
 
+        void set_recv_q_watermark_cb(gcs_watermark_cb_t, void*) {}
+
         void  param_set (const std::string& key, const std::string& value)
         {}
 
@@ -7,13 +7,25 @@
 
 #include "galera_service_thd.hpp"
 
+#include <gu_thread.hpp>
+
 const uint32_t galera::ServiceThd::A_NONE = 0;
 
-static const uint32_t A_LAST_COMMITTED = 1U <<  0;
 static const uint32_t A_RELEASE_SEQNO  = 1U <<  1;
 static const uint32_t A_FLUSH          = 1U << 30;
 static const uint32_t A_EXIT           = 1U << 31;
 
+std::string const
+galera::ServiceThd::PARAM_REPORT_INTERVAL("repl.report_interval");
+
+static std::string const PARAM_REPORT_INTERVAL_DEFAULT("PT0.1S");
+
+void
+galera::ServiceThd::register_params (gu::Config& cnf)
+{
+    cnf.add(PARAM_REPORT_INTERVAL, PARAM_REPORT_INTERVAL_DEFAULT);
+}
+
 void*
 galera::ServiceThd::thd_func (void* arg)
 {
@@ -27,21 +39,45 @@ galera::ServiceThd::thd_func (void* arg)
                        NULL, NULL, NULL);
 #endif /* HAVE_PSI_INTERFACE */
 
+    gu::thread_cpu_register("service");
+
     while (!exit)
     {
         galera::ServiceThd::Data data;
+        gcs_seqno_t lc      (0);
+        bool        send_lc (false);
 
         {
             gu::Lock lock(st->mtx_);
 
-            if (A_NONE == st->data_.act_) lock.wait(st->cond_);
+            if (A_NONE == st->data_.act_)
+            {
+                /* committers publish to the mailbox without signaling,
+                 * wake up periodically to sample it */
+                try
+                {
+                    lock.wait(st->cond_, gu::datetime::Date::calendar() +
+                              st->report_interval_);
+                }
+                catch (gu::Exception& e)
+                {
+                    if (e.get_errno() != ETIMEDOUT) throw;
+                }
+            }
 
             data = st->data_;
             st->data_.act_ = A_NONE; // clear pending actions
 
+            lc = st->last_committed_();
+            if (lc > st->data_.last_committed_)
+            {
+                st->data_.last_committed_ = lc;
+                send_lc = true;
+            }
+
             if (data.act_ & A_FLUSH)
             {
-                if (A_FLUSH == data.act_)
+                if (A_FLUSH == data.act_ && !send_lc)
                 { // no other actions scheduled (all previous are "flushed")
                     log_info << "Service thread queue flushed.";
                     st->flush_.broadcast();
@@ -57,22 +93,20 @@ galera::ServiceThd::thd_func (void* arg)
 
         if (!exit)
         {
-            if (data.act_ & A_LAST_COMMITTED)
+            if (send_lc)
             {
-                ssize_t const ret
-                    (st->gcs_.set_last_applied(data.last_committed_));
+                ssize_t const ret (st->gcs_.set_last_applied(lc));
 
                 if (gu_unlikely(ret < 0))
                 {
                     log_warn << "Failed to report last committed "
-                             << data.last_committed_ << ", " << ret
+                             << lc << ", " << ret
                              << " (" << strerror (-ret) << ')';
                     // @todo: figure out what to do in this case
                 }
                 else
                 {
-                    log_debug << "Reported last committed: "
-                              << data.last_committed_;
+                    log_debug << "Reported last committed: " << lc;
                 }
             }
 
@@ -91,6 +125,8 @@ galera::ServiceThd::thd_func (void* arg)
         }
     }
 
+    gu::thread_cpu_unregister();
+
 #ifdef HAVE_PSI_INTERFACE
     pfs_instr_callback(WSREP_PFS_INSTR_TYPE_THREAD,
                        WSREP_PFS_INSTR_OPS_DESTROY,
@@ -101,7 +137,8 @@ galera::ServiceThd::thd_func (void* arg)
     return 0;
 }
 
-galera::ServiceThd::ServiceThd (GcsI& gcs, gcache::GCache& gcache) :
+galera::ServiceThd::ServiceThd (GcsI& gcs, gcache::GCache& gcache,
+                                const gu::Config& conf) :
     gcache_ (gcache),
     gcs_    (gcs),
     thd_    (),
@@ -114,7 +151,10 @@ galera::ServiceThd::ServiceThd (GcsI& gcs, gcache::GCache& gcache) :
     cond_   (),
     flush_  (),
 #endif /* HAVE_PSI_INTERFACE */
-    data_   ()
+    data_   (),
+    last_committed_  (0),
+    report_interval_ (conf.get(PARAM_REPORT_INTERVAL,
+                               PARAM_REPORT_INTERVAL_DEFAULT))
 {
     gu_thread_create (&thd_, NULL, thd_func, this);
 }
@@ -150,21 +190,24 @@ galera::ServiceThd::reset()
     gu::Lock lock(mtx_);
     data_.act_ = A_NONE;
     data_.last_committed_ = 0;
+    last_committed_ = 0;
 }
 
 void
 galera::ServiceThd::report_last_committed(gcs_seqno_t seqno)
 {
-    gu::Lock lock(mtx_);
-
-    if (data_.last_committed_ < seqno)
-    {
-        data_.last_committed_ = seqno;
+    /* wait-free publish, the service thread samples and reports at
+     * report_interval_ - no mutex on the commit hot path */
+    last_committed_.set_if_greater(seqno);
+}
 
-        if (data_.act_ == A_NONE) cond_.signal();
+void
+galera::ServiceThd::report_interval(const std::string& str)
+{
+    gu::datetime::Period const p(str); // may throw before locking
 
-        data_.act_ |= A_LAST_COMMITTED;
-    }
+    gu::Lock lock(mtx_);
+    report_interval_ = p;
 }
 
 void
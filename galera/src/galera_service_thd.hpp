@@ -8,6 +8,8 @@
 #include "galera_gcs.hpp"
 #include <GCache.hpp>
 
+#include <gu_atomic.hpp>
+#include <gu_datetime.hpp>
 #include <gu_lock.hpp> // gu::Mutex and gu::Cond
 
 namespace galera
@@ -16,7 +18,12 @@ namespace galera
     {
     public:
 
-        ServiceThd (GcsI& gcs, gcache::GCache& gcache);
+        static std::string const PARAM_REPORT_INTERVAL;
+
+        static void register_params (gu::Config&);
+
+        ServiceThd (GcsI& gcs, gcache::GCache& gcache,
+                    const gu::Config& conf);
 
         ~ServiceThd ();
 
@@ -32,19 +39,24 @@ namespace galera
          * actions are scheduled with the service thread after that.
          * !!! */
 
-        /*! schedule seqno to be reported as last committed */
+        /*! schedule seqno to be reported as last committed. Wait-free:
+         *  publishes to an atomic mailbox which the service thread samples
+         *  and reports at PARAM_REPORT_INTERVAL intervals. */
         void report_last_committed (gcs_seqno_t seqno);
 
         /*! release write sets up to and including seqno */
         void release_seqno (gcs_seqno_t seqno);
 
+        /*! change reporting interval during runtime */
+        void report_interval (const std::string& str);
+
     private:
 
         static const uint32_t A_NONE;
 
         struct Data
         {
-            gcs_seqno_t last_committed_;
+            gcs_seqno_t last_committed_; // watermark of what was reported
             gcs_seqno_t release_seqno_;
             uint32_t    act_;
 
@@ -70,6 +82,11 @@ namespace galera
 #endif /* HAVE_PSI_INTERFACE */
         Data            data_;
 
+        /* committers publish last committed seqno here without taking
+         * mtx_, the service thread samples it at report_interval_ */
+        gu::Atomic<gcs_seqno_t> last_committed_;
+        gu::datetime::Period    report_interval_; // guarded by mtx_
+
         static void* thd_func (void*);
 
         ServiceThd (const ServiceThd&);
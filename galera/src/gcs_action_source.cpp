@@ -4,6 +4,7 @@
 
 #include "replicator.hpp"
 #include "gcs_action_source.hpp"
+#include "action_recorder.hpp"
 #include "trx_handle.hpp"
 
 #include "gu_serialize.hpp"
@@ -83,6 +84,10 @@ galera::GcsActionTrx::GcsActionTrx(TrxHandle::SlavePool&    pool,
 //    size_t offset(trx_->unserialize(buf, act.size, 0));
     gu_trace(trx_->unserialize(buf, act.size, 0));
 
+    /* we are still unordered here, warm up the keyset before
+     * certification does it in the total order critical section */
+    trx_->preload_keys();
+
     //trx_->append_write_set(buf + offset, act.size - offset);
     // moved to unserialize trx_->set_write_set_buffer(buf + offset, act.size - offset);
     trx_->set_received(act.buf, act.seqno_l, act.seqno_g);
@@ -168,6 +173,15 @@ void galera::GcsActionSource::dispatch(void* const              recv_ctx,
 }
 
 
+/* NOTE on batching: process() is invoked concurrently by all applier
+ * threads, so the slave pipeline is not single-threaded per se - each
+ * thread deserializes and certifies its own action while gcs_recv() only
+ * hands out the next queued action under a short lock. Parallelism between
+ * deserialization and certification of one writeset already exists for
+ * large writesets: WriteSetIn::init() offloads checksumming to a side
+ * thread above SIZE_THRESHOLD. Batching the dequeue itself (pulling
+ * several queued actions per recv) has to happen inside the GCS recv
+ * queue, not here, since gcs_recv() is the total-order hand-off point. */
 ssize_t galera::GcsActionSource::process(void* recv_ctx, bool& exit_loop)
 {
     struct gcs_action act;
@@ -178,6 +192,9 @@ ssize_t galera::GcsActionSource::process(void* recv_ctx, bool& exit_loop)
         Release release(act, gcache_);
         ++received_;
         received_bytes_ += rc;
+        /* record before dispatch so that an action which crashes the
+         * apply path still makes it into the log */
+        if (gu_unlikely(recorder_ != 0)) recorder_->record(act);
         gu_trace(dispatch(recv_ctx, act, exit_loop));
     }
     return rc;
@@ -16,6 +16,8 @@
 
 namespace galera
 {
+    class ActionRecorder;
+
     class GcsActionSource : public galera::ActionSource
     {
     public:
@@ -30,7 +32,8 @@ namespace galera
             replicator_    (replicator),
             gcache_        (gcache    ),
             received_      (0         ),
-            received_bytes_(0         )
+            received_bytes_(0         ),
+            recorder_      (0         )
         { }
 
         ~GcsActionSource()
@@ -42,16 +45,23 @@ namespace galera
         long long received()       const { return received_(); }
         long long received_bytes() const { return received_bytes_(); }
 
+        /* optional delivered action log, see action_recorder.hpp */
+        void set_recorder(ActionRecorder* rec) { recorder_ = rec; }
+
     private:
 
+        GcsActionSource(const GcsActionSource&);
+        void operator=(const GcsActionSource&);
+
         void dispatch(void*, const gcs_action&, bool& exit_loop);
 
         TrxHandle::SlavePool& trx_pool_;
         GCS_IMPL&             gcs_;
         Replicator&           replicator_;
         gcache::GCache&       gcache_;
-        gu::Atomic<long long> received_;
-        gu::Atomic<long long> received_bytes_;
+        gu::StatCounter<long long> received_;
+        gu::StatCounter<long long> received_bytes_;
+        ActionRecorder*            recorder_;
     };
 
     class GcsActionTrx
@@ -9,6 +9,7 @@
 #include "gu_uri.hpp"
 #include "gu_debug_sync.hpp"
 #include "gu_progress.hpp"
+#include "gu_time.h"
 
 #include "GCache.hpp"
 #include "galera_common.hpp"
@@ -16,10 +17,26 @@
 #include <fstream>
 #include <algorithm>
 
+#include <poll.h>
+
 namespace
 {
     static std::string const CONF_KEEP_KEYS     ("ist.keep_keys");
     static bool        const CONF_KEEP_KEYS_DEFAULT (true);
+
+    /* Socket buffer sizes for the IST connection. Over long fat WAN links
+     * the kernel default SO_SNDBUF/SO_RCVBUF caps the TCP congestion
+     * window well below the bandwidth-delay product, which makes large
+     * IST catch-ups bandwidth-limited by a single stream. 0 - use system
+     * default. */
+    static std::string const CONF_SEND_BUF_SIZE ("ist.send_buf_size");
+    static std::string const CONF_RECV_BUF_SIZE ("ist.recv_buf_size");
+    static long        const CONF_BUF_SIZE_DEFAULT (0);
+
+    /* Whether the sender backs off when the donor's own commit latency
+     * degrades, see Pacer below. */
+    static std::string const CONF_THROTTLE ("ist.throttle");
+    static bool        const CONF_THROTTLE_DEFAULT (true);
 }
 
 
@@ -37,7 +54,8 @@ namespace galera
                         AsyncSenderMap& asmap,
                         int version)
                 :
-                Sender (conf, asmap.gcache(), peer, version),
+                Sender (conf, asmap.gcache(), peer, version,
+                        asmap.latency_source()),
                 conf_  (conf),
                 peer_  (peer),
                 first_ (first),
@@ -82,6 +100,9 @@ galera::ist::register_params(gu::Config& conf)
     conf.add(Receiver::RECV_ADDR);
     conf.add(Receiver::RECV_BIND);
     conf.add(CONF_KEEP_KEYS);
+    conf.add(CONF_SEND_BUF_SIZE);
+    conf.add(CONF_RECV_BUF_SIZE);
+    conf.add(CONF_THROTTLE);
 }
 
 galera::ist::Receiver::Receiver(gu::Config&           conf,
@@ -100,7 +121,12 @@ galera::ist::Receiver::Receiver(gu::Config&           conf,
     mutex_        (),
     cond_         (),
 #endif /* HAVE_PSI_INTERFACE */
-    consumers_    (),
+    trx_queue_    (),
+#ifdef HAVE_PSI_INTERFACE
+    recv_cond_    (WSREP_PFS_INSTR_TAG_IST_CONSUMER_CONDVAR),
+#else
+    recv_cond_    (),
+#endif /* HAVE_PSI_INTERFACE */
     current_seqno_(-1),
     first_seqno_  (-1),
     last_seqno_   (-1),
@@ -335,6 +361,15 @@ galera::ist::Receiver::prepare(wsrep_seqno_t first_seqno,
         asio::ip::tcp::resolver::iterator i(resolver.resolve(query));
         acceptor_.open(i->endpoint().protocol());
         acceptor_.set_option(asio::ip::tcp::socket::reuse_address(true));
+        long const rcvbuf(conf_.get(CONF_RECV_BUF_SIZE,
+                                    CONF_BUF_SIZE_DEFAULT));
+        if (rcvbuf > 0)
+        {
+            /* must be set on the acceptor before listen() so that the TCP
+             * window scale is negotiated accordingly on accepted sockets */
+            acceptor_.set_option(
+                asio::socket_base::receive_buffer_size(rcvbuf));
+        }
         gu::set_fd_options(acceptor_);
         acceptor_.bind(*i);
         acceptor_.listen();
@@ -379,14 +414,16 @@ galera::ist::Receiver::prepare(wsrep_seqno_t first_seqno,
 void galera::ist::Receiver::run()
 {
     asio::ip::tcp::socket socket(io_service_);
-    asio::ssl::stream<asio::ip::tcp::socket> ssl_stream(io_service_, ssl_ctx_);
+    asio::ssl::stream<asio::ip::tcp::socket>* ssl_stream(0);
     try
     {
         if (use_ssl_ == true)
         {
-            acceptor_.accept(ssl_stream.lowest_layer());
-            gu::set_fd_options(ssl_stream.lowest_layer());
-            ssl_stream.handshake(asio::ssl::stream<asio::ip::tcp::socket>::server);
+            ssl_stream = new asio::ssl::stream<asio::ip::tcp::socket>(
+                io_service_, ssl_ctx_);
+            acceptor_.accept(ssl_stream->lowest_layer());
+            gu::set_fd_options(ssl_stream->lowest_layer());
+            ssl_stream->handshake(asio::ssl::stream<asio::ip::tcp::socket>::server);
         }
         else
         {
@@ -396,13 +433,21 @@ void galera::ist::Receiver::run()
     }
     catch (asio::system_error& e)
     {
+        delete ssl_stream;
         gu_throw_error(e.code().value()) << "accept() failed"
                                          << "', asio error '"
                                          << e.what() << "': "
                                          << gu::extra_error_info(e.code());
     }
+    /* remember where we listened: if the stream breaks the acceptor is
+     * re-opened on the same endpoint so that the donor can reconnect
+     * and resume the transfer from where it was cut off */
+    asio::ip::tcp::endpoint const listen_ep(acceptor_.local_endpoint());
     acceptor_.close();
     int ec(0);
+    int resumes(0);
+    static int const max_resume(30);
+    static int const resume_accept_timeout(30); // seconds per attempt
     try
     {
         Proto p(trx_pool_, version_,
@@ -410,9 +455,9 @@ void galera::ist::Receiver::run()
 
         if (use_ssl_ == true)
         {
-            p.send_handshake(ssl_stream);
-            p.recv_handshake_response(ssl_stream);
-            p.send_ctrl(ssl_stream, Ctrl::C_OK);
+            p.send_handshake(*ssl_stream);
+            p.recv_handshake_response(*ssl_stream);
+            p.send_ctrl(*ssl_stream, Ctrl::C_OK);
         }
         else
         {
@@ -438,47 +483,143 @@ void galera::ist::Receiver::run()
 
         while (true)
         {
-            TrxHandle* trx;
+          try
+          {
+            while (true)
+            {
+                TrxHandle* trx;
+                if (use_ssl_ == true)
+                {
+                    trx = p.recv_trx(*ssl_stream);
+                }
+                else
+                {
+                    trx = p.recv_trx(socket);
+                }
+                if (trx != 0)
+                {
+                    if (trx->global_seqno() != current_seqno_)
+                    {
+                        log_error << "unexpected trx seqno: "
+                                  << trx->global_seqno()
+                                  << " expected: " << current_seqno_;
+                        trx->unref();
+                        ec = EINVAL;
+                        goto err;
+                    }
+                    ++current_seqno_;
+
+                    progress.update(1);
+                }
+                gu::Lock lock(mutex_);
+                assert(ready_ || interrupted_);
+                while (trx_queue_.size() >= RECV_QUEUE_MAX)
+                {
+                    if (interrupted_)
+                    {
+                        if (trx != 0) trx->unref();
+                        goto Intrrupted;
+                    }
+                    lock.wait(cond_);
+                }
+                if (interrupted_)
+                {
+                    if (trx != 0) trx->unref();
+                    goto Intrrupted;
+                }
+                trx_queue_.push_back(trx);
+                recv_cond_.signal();
+                if (trx == 0)
+                {
+                    log_debug << "eof received, closing socket";
+                    break;
+                }
+            }
+
+            break; /* EOF - transfer complete */
+          }
+          catch (asio::system_error& e)
+          {
+            if (interrupted_ || ++resumes > max_resume) throw;
+
+            log_info << "IST stream broken at seqno " << current_seqno_
+                     << ": " << e.what()
+                     << ". Waiting for donor to reconnect and resume.";
+
+            /* tear down the dead connection and listen again */
             if (use_ssl_ == true)
             {
-                trx = p.recv_trx(ssl_stream);
+                delete ssl_stream;
+                ssl_stream = 0;
             }
             else
             {
-                trx = p.recv_trx(socket);
+                socket.close();
             }
-            if (trx != 0)
+            acceptor_.open(listen_ep.protocol());
+            acceptor_.set_option(asio::ip::tcp::socket::reuse_address(true));
+            gu::set_fd_options(acceptor_);
+            acceptor_.bind(listen_ep);
+            acceptor_.listen();
+
+            /* the donor may be dead (the common IST failure) or speak an
+             * older protocol and never reconnect - bound the wait so the
+             * joiner fails over to SST instead of hanging in accept().
+             * An interrupt() connection also wakes the poll and takes
+             * the regular interrupted exit below. */
             {
-                if (trx->global_seqno() != current_seqno_)
+                struct pollfd pfd;
+                pfd.fd      = acceptor_.native();
+                pfd.events  = POLLIN;
+                pfd.revents = 0;
+
+                int const pret(::poll(&pfd, 1,
+                                      resume_accept_timeout * 1000));
+                if (pret <= 0)
                 {
-                    log_error << "unexpected trx seqno: " << trx->global_seqno()
-                              << " expected: " << current_seqno_;
-                    ec = EINVAL;
-                    goto err;
+                    log_error << "donor did not reconnect to resume IST "
+                              << "within " << resume_accept_timeout
+                              << " seconds, giving up";
+                    acceptor_.close();
+                    throw; // the original stream error
                 }
-                ++current_seqno_;
+            }
 
-                progress.update(1);
+            if (use_ssl_ == true)
+            {
+                ssl_stream = new asio::ssl::stream<asio::ip::tcp::socket>(
+                    io_service_, ssl_ctx_);
+                acceptor_.accept(ssl_stream->lowest_layer());
+                gu::set_fd_options(ssl_stream->lowest_layer());
+                ssl_stream->handshake(
+                    asio::ssl::stream<asio::ip::tcp::socket>::server);
             }
-            gu::Lock lock(mutex_);
-            assert(ready_ || interrupted_);
-            while (consumers_.empty())
+            else
             {
-                if (interrupted_)
-                {
-                    goto Intrrupted;
-                }
-                lock.wait(cond_);
+                acceptor_.accept(socket);
+                gu::set_fd_options(socket);
             }
-            Consumer* cons(consumers_.top());
-            consumers_.pop();
-            cons->trx(trx);
-            cons->cond().signal();
-            if (trx == 0)
+            acceptor_.close();
+
+            /* repeat the handshake, but this time tell the donor where
+             * to pick up. An interrupt() connection answers the
+             * handshake with C_EOF, which throws EINTR here and takes
+             * the regular interrupted exit. */
+            if (use_ssl_ == true)
             {
-                log_debug << "eof received, closing socket";
-                break;
+                p.send_handshake(*ssl_stream);
+                p.recv_handshake_response(*ssl_stream);
+                p.send_ctrl(*ssl_stream, Ctrl::C_RESUME, current_seqno_);
             }
+            else
+            {
+                p.send_handshake(socket);
+                p.recv_handshake_response(socket);
+                p.send_ctrl(socket, Ctrl::C_RESUME, current_seqno_);
+            }
+
+            log_info << "IST resumed at seqno " << current_seqno_;
+          }
         }
 
         progress.finish();
@@ -502,8 +643,11 @@ err:
     gu::Lock lock(mutex_);
     if (use_ssl_ == true)
     {
-        ssl_stream.lowest_layer().close();
-        // ssl_stream.shutdown();
+        if (ssl_stream != 0)
+        {
+            ssl_stream->lowest_layer().close();
+            delete ssl_stream;
+        }
     }
     else
     {
@@ -521,11 +665,7 @@ err:
     {
         error_code_ = ec;
     }
-    while (consumers_.empty() == false)
-    {
-        consumers_.top()->cond().signal();
-        consumers_.pop();
-    }
+    recv_cond_.broadcast();
 }
 
 
@@ -538,29 +678,29 @@ void galera::ist::Receiver::ready()
 
 int galera::ist::Receiver::recv(TrxHandle** trx)
 {
-    Consumer cons;
     gu::Lock lock(mutex_);
-    if (running_ == false)
+
+    while (trx_queue_.empty() == true && running_ == true)
     {
-        if (error_code_ != 0)
-        {
-            gu_throw_error(error_code_) << "IST receiver reported error";
-        }
-        return EINTR;
+        lock.wait(recv_cond_);
     }
-    consumers_.push(&cons);
-    cond_.signal();
-    lock.wait(cons.cond());
-    if (cons.trx() == 0)
+
+    /* drain prefetched trxs even after the reader has stopped */
+    if (trx_queue_.empty() == false && trx_queue_.front() != 0)
     {
-        if (error_code_ != 0)
-        {
-            gu_throw_error(error_code_) << "IST receiver reported error";
-        }
-        return EINTR;
+        *trx = trx_queue_.front();
+        trx_queue_.pop_front();
+        cond_.signal(); // reader may be waiting for queue space
+        return 0;
     }
-    *trx = cons.trx();
-    return 0;
+
+    /* empty queue with stopped reader, or a sticky EOF marker which is
+     * left in place for the other appliers */
+    if (error_code_ != 0)
+    {
+        gu_throw_error(error_code_) << "IST receiver reported error";
+    }
+    return EINTR;
 }
 
 
@@ -595,12 +735,16 @@ wsrep_seqno_t galera::ist::Receiver::finished()
 
         running_ = false;
 
-        while (consumers_.empty() == false)
+        /* release unconsumed prefetched trxs */
+        while (trx_queue_.empty() == false)
         {
-            consumers_.top()->cond().signal();
-            consumers_.pop();
+            TrxHandle* trx(trx_queue_.front());
+            trx_queue_.pop_front();
+            if (trx != 0) trx->unref();
         }
 
+        recv_cond_.broadcast();
+
         recv_addr_ = "";
     }
 
@@ -662,10 +806,11 @@ void galera::ist::Receiver::interrupt()
 }
 
 
-galera::ist::Sender::Sender(const gu::Config&  conf,
-                            gcache::GCache&    gcache,
-                            const std::string& peer,
-                            int                version)
+galera::ist::Sender::Sender(const gu::Config&          conf,
+                            gcache::GCache&            gcache,
+                            const std::string&         peer,
+                            int                        version,
+                            const CommitLatencySource* latency)
     :
     io_service_(),
     socket_    (io_service_),
@@ -673,10 +818,19 @@ galera::ist::Sender::Sender(const gu::Config&  conf,
     ssl_stream_(0),
     conf_      (conf),
     gcache_    (gcache),
+    peer_      (peer),
+    latency_   (latency),
     version_   (version),
-    use_ssl_   (false)
+    use_ssl_   (false),
+    cancelled_ (false)
 {
-    gu::URI uri(peer);
+    connect();
+}
+
+
+void galera::ist::Sender::connect()
+{
+    gu::URI uri(peer_);
     try
     {
         asio::ip::tcp::resolver resolver(io_service_);
@@ -685,6 +839,8 @@ galera::ist::Sender::Sender(const gu::Config&  conf,
                   uri.get_port(),
                   asio::ip::tcp::resolver::query::flags(0));
         asio::ip::tcp::resolver::iterator i(resolver.resolve(query));
+        long const sndbuf(conf_.get(CONF_SEND_BUF_SIZE,
+                                    CONF_BUF_SIZE_DEFAULT));
         if (uri.get_scheme() == "ssl")
         {
             use_ssl_ = true;
@@ -692,16 +848,28 @@ galera::ist::Sender::Sender(const gu::Config&  conf,
         if (use_ssl_ == true)
         {
             log_info << "IST sender using ssl";
-            ssl_prepare_context(conf, ssl_ctx_);
+            ssl_prepare_context(conf_, ssl_ctx_);
             // ssl_stream must be created after ssl_ctx_ is prepared...
             ssl_stream_ = new asio::ssl::stream<asio::ip::tcp::socket>(
                 io_service_, ssl_ctx_);
+            ssl_stream_->lowest_layer().open(i->endpoint().protocol());
+            if (sndbuf > 0)
+            {
+                ssl_stream_->lowest_layer().set_option(
+                    asio::socket_base::send_buffer_size(sndbuf));
+            }
             ssl_stream_->lowest_layer().connect(*i);
             gu::set_fd_options(ssl_stream_->lowest_layer());
             ssl_stream_->handshake(asio::ssl::stream<asio::ip::tcp::socket>::client);
         }
         else
         {
+            socket_.open(i->endpoint().protocol());
+            if (sndbuf > 0)
+            {
+                socket_.set_option(
+                    asio::socket_base::send_buffer_size(sndbuf));
+            }
             socket_.connect(*i);
             gu::set_fd_options(socket_);
         }
@@ -709,8 +877,30 @@ galera::ist::Sender::Sender(const gu::Config&  conf,
     catch (asio::system_error& e)
     {
         gu_throw_error(e.code().value()) << "IST sender, failed to connect '"
-                                         << peer.c_str() << "': " << e.what();
+                                         << peer_.c_str() << "': " << e.what();
+    }
+}
+
+
+void galera::ist::Sender::reconnect()
+{
+    if (cancelled_) gu_throw_error(ECANCELED) << "IST sender cancelled";
+
+    if (use_ssl_ == true)
+    {
+        if (ssl_stream_ != 0)
+        {
+            ssl_stream_->lowest_layer().close();
+            delete ssl_stream_;
+            ssl_stream_ = 0;
+        }
     }
+    else
+    {
+        socket_.close();
+    }
+
+    connect();
 }
 
 
@@ -728,13 +918,186 @@ galera::ist::Sender::~Sender()
     gcache_.seqno_unlock();
 }
 
-void galera::ist::Sender::send(wsrep_seqno_t first, wsrep_seqno_t last)
+namespace
+{
+    /* transient network errors worth a reconnect attempt; anything
+     * else (protocol errors, cancellation, missing history) is final */
+    static bool retryable_error(int err)
+    {
+        switch (err)
+        {
+        case ECONNRESET:
+        case ECONNABORTED:
+        case ECONNREFUSED:
+        case EPIPE:
+        case ETIMEDOUT:
+        case EHOSTUNREACH:
+        case ENETUNREACH:
+        case ENETDOWN:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    /* Donor-side transfer pacing (ist.throttle). Gcache page reads and
+     * socket writes compete with the donor's own commit path, so the
+     * sender polls the donor commit latency (a responsive EWMA from the
+     * commit monitor) a few times a second. While latency stays within a
+     * few multiples of what it was when the transfer started the sender
+     * runs at full speed; when it spikes the send rate is halved, and it
+     * is raised again while latency is healthy - additive increase,
+     * multiplicative decrease, like TCP. The rate floor keeps the
+     * transfer crawling forward on a donor that is saturated for other
+     * reasons, and per-batch sleep debt is capped so that pacing never
+     * stalls the sender (or its cancellation) for more than a second. */
+    static long long const min_threshold_ns_ = 2000000;   // 2ms
+    static long long const min_rate_         = 1 << 20;   // 1MB/s
+    static long long const max_rate_         = 1LL << 30; // "unlimited"
+    static long long const tick_ns_          = 200000000; // 200ms
+
+    class Pacer
+    {
+    public:
+
+        Pacer(const galera::ist::CommitLatencySource* const src)
+            :
+            src_      (src),
+            threshold_(0),
+            rate_     (0), // B/s, 0 - unlimited
+            tick_time_(gu_time_monotonic()),
+            tick_bytes_(0),
+            next_send_(0)
+        {
+            if (src_ != 0)
+            {
+                long long const baseline(src_->commit_latency_ns());
+                threshold_ = std::max(4*baseline, min_threshold_ns_);
+            }
+        }
+
+        /* account bytes put on the wire and sleep if over rate */
+        void sent(size_t const bytes)
+        {
+            if (src_ == 0) return;
+
+            tick_bytes_ += bytes;
+
+            long long now(gu_time_monotonic());
+
+            if (now - tick_time_ >= tick_ns_)
+            {
+                long long const lat(src_->commit_latency_ns());
+
+                if (lat > threshold_)
+                {
+                    /* observed throughput over the last tick, so that the
+                     * first cut starts from the actual full speed rate */
+                    long long const observed(
+                        tick_bytes_*1000000000LL/(now - tick_time_));
+                    long long const cur(
+                        rate_ > 0 ? std::min(rate_, observed) : observed);
+
+                    rate_ = std::max(cur/2, min_rate_);
+
+                    log_info << "IST sender throttled to " << rate_
+                             << " B/s: local commit latency " << lat
+                             << "ns exceeds " << threshold_ << "ns";
+                }
+                else if (rate_ > 0)
+                {
+                    rate_ += std::max(rate_/4, min_rate_);
+
+                    if (rate_ >= max_rate_)
+                    {
+                        rate_ = 0;
+                        log_info << "IST sender back to full speed";
+                    }
+                }
+
+                tick_time_  = now;
+                tick_bytes_ = 0;
+            }
+
+            if (rate_ > 0)
+            {
+                if (next_send_ < now) next_send_ = now;
+                next_send_ += bytes*1000000000LL/rate_;
+
+                long long const max_debt_ns(1000000000LL);
+                if (next_send_ > now + max_debt_ns)
+                    next_send_ = now + max_debt_ns;
+
+                if (next_send_ > now) usleep((next_send_ - now)/1000);
+            }
+        }
+
+    private:
+
+        const galera::ist::CommitLatencySource* const src_;
+        long long threshold_;
+        long long rate_;
+        long long tick_time_;
+        long long tick_bytes_;
+        long long next_send_;
+    };
+}
+
+
+void galera::ist::Sender::send(wsrep_seqno_t const first,
+                               wsrep_seqno_t const last)
 {
     if (first > last)
     {
         gu_throw_error(EINVAL) << "sender send first greater than last: "
                                << first << " > " << last ;
     }
+
+    /* A broken stream is retried by reconnecting: the receiver listens
+     * again after a stream error and replies with C_RESUME carrying the
+     * next seqno it expects, so a WAN blip costs a reconnect instead of
+     * restarting the whole range (or falling back to SST). The sleep
+     * between attempts gives the receiver time to notice the break on
+     * its side of the dead connection and start listening again. */
+    static int const max_resume(30);
+
+    int resumes(0);
+
+    while (true)
+    {
+        try
+        {
+            if (resumes > 0)
+            {
+                usleep(1000000);
+                reconnect();
+            }
+            send_from(first, last);
+            return;
+        }
+        catch (gu::Exception& e)
+        {
+            if (cancelled_ || !retryable_error(e.get_errno()) ||
+                ++resumes > max_resume)
+            {
+                throw;
+            }
+            log_info << "IST send to " << peer_ << " failed: " << e.what()
+                     << "; will reconnect and resume";
+        }
+    }
+}
+
+
+/* NOTE on parallelism: the IST protocol carries the seqno range over a
+ * single ordered stream and the receiver accepts exactly one connection,
+ * so splitting the range across several sockets would have to be
+ * negotiated in the handshake - a protocol version change which cannot be
+ * made unilaterally within this IST protocol generation. What a single
+ * stream can do over a long fat link is governed by the congestion window
+ * cap, hence the ist.send_buf_size/ist.recv_buf_size options above. */
+void galera::ist::Sender::send_from(wsrep_seqno_t first, wsrep_seqno_t last)
+{
     try
     {
         TrxHandle::SlavePool unused(1, 0, "");
@@ -742,78 +1105,108 @@ void galera::ist::Sender::send(wsrep_seqno_t first, wsrep_seqno_t last)
                 conf_.get(CONF_KEEP_KEYS, CONF_KEEP_KEYS_DEFAULT));
         int32_t ctrl;
 
+        uint64_t resume_at(0);
+
         if (use_ssl_ == true)
         {
             p.recv_handshake(*ssl_stream_);
             p.send_handshake_response(*ssl_stream_);
-            ctrl = p.recv_ctrl(*ssl_stream_);
+            ctrl = p.recv_ctrl(*ssl_stream_, resume_at);
         }
         else
         {
             p.recv_handshake(socket_);
             p.send_handshake_response(socket_);
-            ctrl = p.recv_ctrl(socket_);
+            ctrl = p.recv_ctrl(socket_, resume_at);
         }
         if (ctrl < 0)
         {
             gu_throw_error(EPROTO)
                 << "ist send failed, peer reported error: " << ctrl;
         }
+        if (Ctrl::C_RESUME == ctrl)
+        {
+            wsrep_seqno_t const seqno(resume_at);
+
+            if (seqno < first || seqno > last)
+            {
+                gu_throw_error(EPROTO)
+                    << "peer requested resume from " << seqno
+                    << ", which is outside [" << first << ", " << last << "]";
+            }
+
+            log_info << "peer requested IST resume from seqno " << seqno;
+            first = seqno;
+        }
 
         std::vector<gcache::GCache::Buffer> buf_vec(
             std::min(static_cast<size_t>(last - first + 1),
                      static_cast<size_t>(1024)));
         ssize_t n_read;
+
+        Pacer pacer(conf_.get(CONF_THROTTLE, CONF_THROTTLE_DEFAULT) ?
+                    latency_ : 0);
         while ((n_read = gcache_.seqno_get_buffers(buf_vec, first)) > 0)
         {
             GU_DBUG_SYNC_WAIT("ist_sender_send_after_get_buffers")
             //log_info << "read " << first << " + " << n_read << " from gcache";
-            for (wsrep_seqno_t i(0); i < n_read; ++i)
+
+            // buf_vec is resized to never scan past last, so if last is
+            // present in this batch it is the final element
+            bool const eof(buf_vec[n_read - 1].seqno_g() == last);
+
+            if (use_ssl_ == true)
+            {
+                p.send_trx_batch(*ssl_stream_, buf_vec, n_read);
+            }
+            else
+            {
+                p.send_trx_batch(socket_, buf_vec, n_read);
+            }
+
+            if (eof)
             {
-                // log_info << "sending " << buf_vec[i].seqno_g();
                 if (use_ssl_ == true)
                 {
-                    p.send_trx(*ssl_stream_, buf_vec[i]);
+                    p.send_ctrl(*ssl_stream_, Ctrl::C_EOF);
                 }
                 else
                 {
-                    p.send_trx(socket_, buf_vec[i]);
+                    p.send_ctrl(socket_, Ctrl::C_EOF);
                 }
-
-                if (buf_vec[i].seqno_g() == last)
+                // wait until receiver closes the connection
+                try
                 {
+                    gu::byte_t b;
+                    size_t n;
                     if (use_ssl_ == true)
                     {
-                        p.send_ctrl(*ssl_stream_, Ctrl::C_EOF);
+                        n = asio::read(*ssl_stream_, asio::buffer(&b, 1));
                     }
                     else
                     {
-                        p.send_ctrl(socket_, Ctrl::C_EOF);
+                        n = asio::read(socket_, asio::buffer(&b, 1));
                     }
-                    // wait until receiver closes the connection
-                    try
+                    if (n > 0)
                     {
-                        gu::byte_t b;
-                        size_t n;
-                        if (use_ssl_ == true)
-                        {
-                            n = asio::read(*ssl_stream_, asio::buffer(&b, 1));
-                        }
-                        else
-                        {
-                            n = asio::read(socket_, asio::buffer(&b, 1));
-                        }
-                        if (n > 0)
-                        {
-                            log_warn << "received " << n
-                                     << " bytes, expected none";
-                        }
+                        log_warn << "received " << n
+                                 << " bytes, expected none";
                     }
-                    catch (asio::system_error& e)
-                    { }
-                    return;
                 }
+                catch (asio::system_error& e)
+                { }
+                return;
             }
+
+            size_t batch_bytes(0);
+            for (ssize_t i(0); i < n_read; ++i)
+            {
+                // rolled back writesets are sent without payload
+                if (buf_vec[i].seqno_d() != -1)
+                    batch_bytes += buf_vec[i].size();
+            }
+            pacer.sent(batch_bytes);
+
             first += n_read;
             // resize buf_vec to avoid scanning gcache past last
             size_t next_size(std::min(static_cast<size_t>(last - first + 1),
@@ -824,6 +1217,12 @@ void galera::ist::Sender::send(wsrep_seqno_t first, wsrep_seqno_t last)
                 buf_vec.resize(next_size);
             }
         }
+
+        /* the loop is left only when the next seqno is not in gcache:
+         * the range can no longer be served, report instead of silently
+         * returning an incomplete transfer */
+        gu_throw_error(ERANGE) << "writesets from " << first
+                               << " no longer in gcache, can't continue IST";
     }
     catch (asio::system_error& e)
     {
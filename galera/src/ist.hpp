@@ -14,7 +14,7 @@
 #include "gu_monitor.hpp"
 #include "gu_asio.hpp"
 
-#include <stack>
+#include <deque>
 #include <set>
 
 namespace gcache
@@ -30,6 +30,18 @@ namespace galera
     {
         void register_params(gu::Config& conf);
 
+        /*! Live commit latency signal from the donor itself, implemented
+         *  by the replicator over its commit monitor. The sender throttle
+         *  polls it to tell whether the transfer is hurting the donor's
+         *  own commit path. */
+        class CommitLatencySource
+        {
+        public:
+            virtual long long commit_latency_ns() const = 0;
+        protected:
+            virtual ~CommitLatencySource() { }
+        };
+
         class Receiver
         {
         public:
@@ -67,44 +79,19 @@ namespace galera
             gu::Cond                                      cond_;
 #endif /* HAVE_PSI_INTERFACE */
 
-            class Consumer
-            {
-            public:
-
-#ifdef HAVE_PSI_INTERFACE
-                Consumer()
-                    :
-                    cond_(WSREP_PFS_INSTR_TAG_IST_CONSUMER_CONDVAR),
-                    trx_(0)
-                { }
-#else
-                Consumer() : cond_(), trx_(0) { }
-#endif
-                ~Consumer() { }
+            /* Bounded prefetch queue between the socket reader thread and
+             * applier threads: the reader keeps pulling trxs off the wire
+             * while appliers are busy, so IST proceeds at the speed of the
+             * slower of network and apply rather than their sum of
+             * latencies. A null entry is a sticky EOF marker. */
+            static size_t const RECV_QUEUE_MAX = 64;
 
+            std::deque<TrxHandle*> trx_queue_;
 #ifdef HAVE_PSI_INTERFACE
-                gu::CondWithPFS&  cond()        { return cond_; }
+            gu::CondWithPFS        recv_cond_; // appliers wait for trxs
 #else
-                gu::Cond&  cond()              { return cond_; }
+            gu::Cond               recv_cond_; // appliers wait for trxs
 #endif /* HAVE_PSI_INTERFACE */
-                void       trx(TrxHandle* trx) { trx_ = trx;   }
-                TrxHandle* trx() const         { return trx_;  }
-
-            private:
-
-                // Non-copyable
-                Consumer(const Consumer&);
-                Consumer& operator=(const Consumer&);
-
-#ifdef HAVE_PSI_INTERFACE
-                gu::CondWithPFS   cond_;
-#else
-                gu::Cond   cond_;
-#endif /* HAVE_PSI_INTERFACE */
-                TrxHandle* trx_;
-            };
-
-            std::stack<Consumer*> consumers_;
             wsrep_seqno_t         current_seqno_;
             wsrep_seqno_t         first_seqno_;
             wsrep_seqno_t         last_seqno_;
@@ -130,16 +117,18 @@ namespace galera
             Sender(const gu::Config& conf,
                    gcache::GCache& gcache,
                    const std::string& peer,
-                   int version);
+                   int version,
+                   const CommitLatencySource* latency = 0);
             virtual ~Sender();
 
             void send(wsrep_seqno_t first, wsrep_seqno_t last);
 
             void cancel()
             {
+                cancelled_ = true;
                 if (use_ssl_ == true)
                 {
-                    ssl_stream_->lowest_layer().close();
+                    if (ssl_stream_ != 0) ssl_stream_->lowest_layer().close();
                 }
                 else
                 {
@@ -149,14 +138,26 @@ namespace galera
 
         private:
 
+            // (re)establishes the connection to peer_
+            void connect();
+
+            // tears down a broken connection and connects again
+            void reconnect();
+
+            // a single transfer attempt over the current connection
+            void send_from(wsrep_seqno_t first, wsrep_seqno_t last);
+
             asio::io_service                          io_service_;
             asio::ip::tcp::socket                     socket_;
             asio::ssl::context                        ssl_ctx_;
             asio::ssl::stream<asio::ip::tcp::socket>* ssl_stream_;
             const gu::Config&                         conf_;
             gcache::GCache&                           gcache_;
+            std::string const                         peer_;
+            const CommitLatencySource* const          latency_;
             int                                       version_;
             bool                                      use_ssl_;
+            bool                                      cancelled_;
 
             Sender(const Sender&);
             void operator=(const Sender&);
@@ -167,7 +168,8 @@ namespace galera
         class AsyncSenderMap
         {
         public:
-            AsyncSenderMap(GCS_IMPL& gcs, gcache::GCache& gcache)
+            AsyncSenderMap(GCS_IMPL& gcs, gcache::GCache& gcache,
+                           const CommitLatencySource* latency = 0)
                 :
                 senders_(),
 #ifdef HAVE_PSI_INTERFACE
@@ -176,7 +178,8 @@ namespace galera
 #else
                 monitor_(),
 #endif /* HAVE_PSI_INTERFACE */
-                gcache_(gcache) { }
+                gcache_(gcache),
+                latency_(latency) { }
             void run(const gu::Config& conf,
                      const std::string& peer,
                      wsrep_seqno_t,
@@ -185,11 +188,17 @@ namespace galera
             void remove(AsyncSender*, wsrep_seqno_t);
             void cancel();
             gcache::GCache& gcache() { return gcache_; }
+            const CommitLatencySource* latency_source() const
+            { return latency_; }
         private:
+            AsyncSenderMap(const AsyncSenderMap&);
+            void operator=(const AsyncSenderMap&);
+
             std::set<AsyncSender*> senders_;
             // use monitor instead of mutex, it provides cancellation point
             gu::Monitor            monitor_;
             gcache::GCache&        gcache_;
+            const CommitLatencySource* latency_;
         };
 
 
@@ -36,6 +36,14 @@
 // send_ctrl(EOF)            ----->
 //                          <-----   close()
 // close()
+//
+// If the stream breaks mid-transfer the receiver listens again and the
+// sender reconnects; the handshake is repeated as above, except that
+// instead of send_ctrl(OK) the receiver replies send_ctrl(RESUME) with
+// the next expected seqno in the message length field, and the sender
+// continues from there. A peer that does not support resumption simply
+// never reconnects (sender) or never re-listens (receiver), so the
+// exchange degrades to the old single-attempt behavior.
 
 //
 // Note about protocol/message versioning:
@@ -216,11 +224,14 @@ namespace galera
             {
                 // negative values reserved for error codes
                 C_OK = 0,
-                C_EOF = 1
+                C_EOF = 1,
+                // sent instead of C_OK on a resumed connection, the
+                // message length field carries the seqno to resume from
+                C_RESUME = 2
             };
-            Ctrl(int version = -1, int8_t code = 0)
+            Ctrl(int version = -1, int8_t code = 0, uint64_t len = 0)
                 :
-                Message(version, Message::T_CTRL, 0, code, 0)
+                Message(version, Message::T_CTRL, 0, code, len)
             { }
         };
 
@@ -372,9 +383,9 @@ namespace galera
             }
 
             template <class ST>
-            void send_ctrl(ST& socket, int8_t code)
+            void send_ctrl(ST& socket, int8_t code, uint64_t len = 0)
             {
-                Ctrl       ctrl(version_, code);
+                Ctrl       ctrl(version_, code, len);
                 gu::Buffer buf(ctrl.serial_size());
                 size_t offset(ctrl.serialize(&buf[0], buf.size(), 0));
                 size_t n(asio::write(socket, asio::buffer(&buf[0],buf.size())));
@@ -386,6 +397,15 @@ namespace galera
 
             template <class ST>
             int8_t recv_ctrl(ST& socket)
+            {
+                uint64_t len;
+                return recv_ctrl(socket, len);
+            }
+
+            /* like the above, but also returns the message length field,
+             * which carries the resume seqno with Ctrl::C_RESUME */
+            template <class ST>
+            int8_t recv_ctrl(ST& socket, uint64_t& len)
             {
                 Message    msg(version_);
                 gu::Buffer buf(msg.serial_size());
@@ -409,10 +429,21 @@ namespace galera
                     gu_throw_error(EPROTO) << "unexpected message type: "
                                            << msg.type();
                 }
+                len = msg.len();
                 return msg.ctrl();
             }
 
 
+            /* NOTE on copies: the payload buffers below point straight
+             * into the gcache mapping (buffer.ptr(), or the gathered
+             * writeset sections within it when keys are stripped), so the
+             * scatter write is already zero-copy in userspace - only the
+             * message header is serialized into a temporary. The remaining
+             * copy is the kernel's writev into socket buffers; avoiding it
+             * with sendfile()/splice() would only apply to the plain-TCP
+             * case (SSL must pass through the stream), needs header/payload
+             * interleaving with corked sends outside asio, and saves less
+             * than writeset checksumming costs on the same path. */
             template <class ST>
             void send_trx(ST&                           socket,
                           const gcache::GCache::Buffer& buffer)
@@ -478,6 +509,77 @@ namespace galera
                 log_debug << "sent " << sent << " bytes";
             }
 
+            /* Coalesces a run of consecutive trx messages into a single
+             * scatter write. Messages are self-delimiting, so packing
+             * several of them into one writev() leaves the wire format
+             * unchanged - it only saves a syscall per event, which is
+             * what dominates IST throughput with small OLTP writesets.
+             * Only applicable when events are sent as stored: then the
+             * payload buffers alias the gcache mapping and stay valid
+             * until the write completes. When keys are stripped the
+             * gathered buffers may point into per-writeset storage
+             * (see WriteSetIn::gather()), so events go out one by one. */
+            template <class ST>
+            void send_trx_batch(ST&                                        socket,
+                                const std::vector<gcache::GCache::Buffer>& bufs,
+                                size_t const                               count)
+            {
+                assert(count <= bufs.size());
+
+                if (!keep_keys_ && version_ >= WS_NG_VERSION)
+                {
+                    for (size_t i(0); i < count; ++i)
+                    {
+                        send_trx(socket, bufs[i]);
+                    }
+                    return;
+                }
+
+                size_t const trx_meta_size(
+                    8 /* serial_size(seqno_g) */ +
+                    8 /* serial_size(seqno_d) */
+                    );
+
+                /* all message headers go into one temporary, payloads are
+                 * referenced in place */
+                gu::Buffer hdrs(count *
+                                (Trx(version_, 0).serial_size() +
+                                 trx_meta_size));
+                std::vector<asio::const_buffer> cbs;
+                cbs.reserve(2 * count);
+
+                size_t offset(0);
+
+                for (size_t i(0); i < count; ++i)
+                {
+                    const gcache::GCache::Buffer& buffer(bufs[i]);
+                    const bool rolled_back(buffer.seqno_d() == -1);
+                    size_t const payload_size(rolled_back ? 0 :
+                                              size_t(buffer.size()));
+
+                    Trx trx_msg(version_, trx_meta_size + payload_size);
+
+                    size_t const hdr_begin(offset);
+                    offset = trx_msg.serialize(&hdrs[0], hdrs.size(), offset);
+                    offset = gu::serialize8(buffer.seqno_g(),
+                                            &hdrs[0], hdrs.size(), offset);
+                    offset = gu::serialize8(buffer.seqno_d(),
+                                            &hdrs[0], hdrs.size(), offset);
+
+                    cbs.push_back(asio::const_buffer(&hdrs[hdr_begin],
+                                                     offset - hdr_begin));
+                    if (gu_likely(payload_size > 0))
+                    {
+                        cbs.push_back(asio::const_buffer(buffer.ptr(),
+                                                         payload_size));
+                    }
+                }
+
+                size_t const sent(asio::write(socket, cbs));
+                log_debug << "sent " << sent << " bytes in " << count
+                          << " events";
+            }
+
 
             template <class ST>
             galera::TrxHandle*
@@ -509,10 +611,40 @@ namespace galera
 
                     buf.resize(sizeof(seqno_g) + sizeof(seqno_d));
 
-                    n = asio::read(socket, asio::buffer(&buf[0], buf.size()));
-                    if (n != buf.size())
+                    if (gu_unlikely(msg.len() < buf.size()))
+                    {
+                        gu_throw_error(EPROTO) << "trx message too short: "
+                                               << msg.len();
+                    }
+
+                    galera::TrxHandle* trx(galera::TrxHandle::New(trx_pool_));
+
+                    /* the payload length is known from the message header,
+                     * so meta data and write set body are pulled in with a
+                     * single scatter read */
+                    MappedBuffer& wbuf(trx->write_set_collection());
+                    size_t const  wsize(msg.len() - buf.size());
+
+                    if (wsize > 0)
+                    {
+                        wbuf.resize(wsize);
+
+                        boost::array<asio::mutable_buffer, 2> mbs;
+                        mbs[0] = asio::buffer(&buf[0],  buf.size());
+                        mbs[1] = asio::buffer(&wbuf[0], wbuf.size());
+
+                        n = asio::read(socket, mbs);
+                    }
+                    else
+                    {
+                        n = asio::read(socket,
+                                       asio::buffer(&buf[0], buf.size()));
+                    }
+
+                    if (gu_unlikely(n != buf.size() + wsize))
                     {
-                        gu_throw_error(EPROTO) << "error reading trx meta data";
+                        trx->unref();
+                        gu_throw_error(EPROTO) << "error reading trx data";
                     }
 
                     size_t offset(gu::unserialize8(&buf[0], buf.size(), 0,
@@ -520,12 +652,11 @@ namespace galera
                     offset = gu::unserialize8(&buf[0], buf.size(), offset,
                                               seqno_d);
 
-                    galera::TrxHandle* trx(galera::TrxHandle::New(trx_pool_));
-
                     if (seqno_d == WSREP_SEQNO_UNDEFINED)
                     {
-                        if (offset != msg.len())
+                        if (wsize != 0)
                         {
+                            trx->unref();
                             gu_throw_error(EINVAL)
                                 << "message size " << msg.len()
                                 << " does not match expected size " << offset;
@@ -533,35 +664,22 @@ namespace galera
                     }
                     else
                     {
-                        MappedBuffer& wbuf(trx->write_set_collection());
-                        size_t const wsize(msg.len() - offset);
-                        wbuf.resize(wsize);
-
-                        n = asio::read(socket,
-                                       asio::buffer(&wbuf[0], wbuf.size()));
-
-                        if (gu_unlikely(n != wbuf.size()))
+                        if (gu_unlikely(wsize == 0))
                         {
-                            gu_throw_error(EPROTO)
-                                << "error reading write set data";
+                            trx->unref();
+                            gu_throw_error(EPROTO) << "zero length write set";
                         }
-
-                        trx->unserialize(&wbuf[0], wbuf.size(), 0);
                     }
 
-                    if (seqno_d == WSREP_SEQNO_UNDEFINED ||
-                        trx->version() < 3)
-                    {
-                        trx->set_received(0, -1, seqno_g);
-                        trx->set_depends_seqno(seqno_d);
-                    }
-                    else
-                    {
-                        trx->set_received_from_ws();
-                        assert(trx->global_seqno() == seqno_g);
-                        assert(trx->depends_seqno() >= seqno_d);
-                    }
-                    trx->mark_certified();
+                    /* seqnos from the message meta data are enough for the
+                     * reader thread to order and queue the trx - parsing of
+                     * the writeset itself is left to the applier threads
+                     * (TrxHandle::unserialize_ist()), so that the single
+                     * reader does not become the serial stage of the
+                     * transfer while appliers run in parallel */
+                    trx->set_received(0, -1, seqno_g);
+                    trx->set_depends_seqno(seqno_d);
+                    if (wsize == 0) trx->mark_certified();
 
                     log_debug << "received trx body: " << *trx;
                     return trx;
@@ -7,6 +7,9 @@
 
 #include "trx_handle.hpp"
 
+#include "gu_mem_pool.hpp"
+#include "gu_atomic.hpp"
+
 namespace galera
 {
     class TrxHandle;
@@ -97,8 +100,51 @@ namespace galera
             assert(!referenced());
         }
 
+        /* Entries are allocated and freed in bursts as the cert index grows
+         * and gets purged, which makes plain new/delete a malloc hotspot.
+         * Draw them from a shared slab pool instead: a purge storm recycles
+         * slabs into the pool and the following index growth reuses them
+         * without ever entering the allocator. */
+        static void* operator new(size_t size)
+        {
+            assert(size == sizeof(KeyEntryNG));
+            (void)size;
+            ++live_count();
+            return pool().acquire();
+        }
+
+        static void operator delete(void* ptr)
+        {
+            if (ptr)
+            {
+                --live_count();
+                pool().recycle(ptr);
+            }
+        }
+
+        /*! bytes held by live KeyEntryNG objects - the dominant share of
+         *  certification index memory (bucket arrays are accounted for by
+         *  the index owner) */
+        static long long allocated_bytes()
+        {
+            return live_count()() * static_cast<long long>(sizeof(KeyEntryNG));
+        }
+
     private:
 
+        static gu::Atomic<long long>& live_count()
+        {
+            static gu::Atomic<long long> count(0);
+            return count;
+        }
+
+        static gu::MemPool<true>& pool()
+        {
+            static gu::MemPool<true> pool_(sizeof(KeyEntryNG), 1024,
+                                           "KeyEntryNG");
+            return pool_;
+        }
+
         TrxHandle*      refs_[KeySet::Key::P_LAST + 1];
         KeySet::KeyPart key_;
 
@@ -21,7 +21,7 @@ KeySet::throw_version(int ver)
 
 static const char* ver_str[KeySet::MAX_VERSION + 1] =
 {
-    "EMPTY", "FLAT8", "FLAT8A", "FLAT16", "FLAT16A"
+    "EMPTY", "FLAT8", "FLAT8A", "FLAT16", "FLAT16A", "FLAT8AP", "FLAT16AP"
 };
 
 KeySet::Version
@@ -41,16 +41,22 @@ KeySet::version (const std::string& ver)
 size_t
 KeySet::KeyPart::store_annotation (const wsrep_buf_t* const parts,
                                    int const part_num,
-                                   gu::byte_t* buf, int const size)
+                                   gu::byte_t* buf, int const size,
+                                   bool const share_prefix)
 {
     assert(size >= 0);
 
     static size_t const max_len(std::numeric_limits<gu::byte_t>::max());
 
+    /* with shared prefix, parent parts are elided: they are guaranteed to
+     * be stored in the same key set with their own annotations, so only
+     * the count of elided parts and this part's bytes are recorded */
+    int const first(share_prefix ? part_num : 0);
+
     ann_size_t ann_size;
-    int        tmp_size(sizeof(ann_size));
+    int        tmp_size(sizeof(ann_size) + share_prefix);
 
-    for (int i(0); i <= part_num; ++i)
+    for (int i(first); i <= part_num; ++i)
     {
         tmp_size += 1 + std::min<size_t>(parts[i].len, max_len);
     }
@@ -66,7 +72,13 @@ KeySet::KeyPart::store_annotation (const wsrep_buf_t* const parts,
 
     ::memcpy(buf, &tmp, off);
 
-    for (int i(0); i <= part_num && off < ann_size; ++i)
+    if (share_prefix)
+    {
+        buf[off] = std::min<size_t>(first, max_len); /* elided part count */
+        ++off;
+    }
+
+    for (int i(first); i <= part_num && off < ann_size; ++i)
     {
         size_t const left(ann_size - off - 1);
         gu::byte_t const part_len
@@ -90,14 +102,21 @@ KeySet::KeyPart::store_annotation (const wsrep_buf_t* const parts,
 }
 
 void
-KeySet::KeyPart::print_annotation(std::ostream& os, const gu::byte_t* buf)
+KeySet::KeyPart::print_annotation(std::ostream& os, const gu::byte_t* buf,
+                                  bool const share_prefix)
 {
     ann_size_t const ann_size(gu::gtoh<ann_size_t>(
                                   *reinterpret_cast<const ann_size_t*>(buf)));
 
-    size_t const begin(sizeof(ann_size_t));
+    size_t const begin(sizeof(ann_size_t) + share_prefix);
     size_t off(begin);
 
+    if (share_prefix && off <= ann_size)
+    {
+        /* elided parent parts are annotated on their own records */
+        for (gu::byte_t i(0); i < buf[sizeof(ann_size_t)]; ++i) os << "../";
+    }
+
     while (off < ann_size)
     {
         if (off != begin) os << '/';
@@ -149,10 +168,19 @@ KeySet::KeyPart::print (std::ostream& os) const
     if (annotated(ver))
     {
         os << "=";
-        print_annotation (os, data_ + size);
+        print_annotation (os, data_ + size, prefix_annotated(ver));
     }
 }
 
+/* NOTE on hashing cost: key part hashes computed here are not node-local -
+ * they are serialized into the writeset and compared across nodes during
+ * certification, so the algorithm (MurmurHash3-128) is part of the
+ * replication protocol and can't be swapped for a faster hardware hash
+ * (CRC32C & co.) without a protocol version bump on all nodes. What keeps
+ * the cost down instead is incremental hashing: the context is chained
+ * from the parent part, and KeySetOut::append() reuses hash contexts of
+ * branch parts shared with the previously appended key, so common
+ * (db, table) prefixes are hashed once per run, not once per key. */
 KeySetOut::KeyPart::KeyPart (KeyParts&      added,
                              KeySetOut&     store,
                              const KeyPart* parent,
@@ -344,14 +372,13 @@ KeySetOut::append (const KeyData& kd)
             KeyPart kp(added_, *this, parent, kd, i);
 
 #ifdef CHECK_PREVIOUS_KEY
-            if (size_t(j) < new_.size())
-            {
-                new_[j] = kp;
-            }
-            else
+            /* swap into the slot instead of assigning: kp dies at the
+             * end of the iteration, no point copying its hash context */
+            if (size_t(j) >= new_.size())
             {
-                new_().push_back (kp);
+                new_().push_back (KeyPart(version_));
             }
+            swap(new_[j], kp);
             parent = &new_[j];
 #else
             if (kd.copy) kp.acquire();
@@ -379,9 +406,16 @@ KeySetOut::append (const KeyData& kd)
     assert (anc + j == kd.parts_num);
 
 #ifdef CHECK_PREVIOUS_KEY
-    /* copy new parts to prev_ */
+    /* hand the new parts over to prev_ - swap rather than copy, the
+     * new_ slots are scratch space for the next append anyway (note
+     * that plain assignment would not save much either: the copy ctor
+     * already steals value ownership, only the hash context and
+     * metadata get duplicated) */
     prev_().resize(1 + kd.parts_num);
-    std::copy(new_().begin(), new_().begin() + j, prev_().begin() + anc + 1);
+    for (int k(0); k < j; ++k)
+    {
+        swap(prev_[anc + 1 + k], new_[k]);
+    }
 
     /* acquire key part value if it is volatile */
     if (kd.copy)
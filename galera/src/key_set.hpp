@@ -10,8 +10,11 @@
 #include "gu_unordered.hpp"
 #include "gu_logger.hpp"
 #include "gu_hexdump.hpp"
+#include "gu_throw.hpp"
 #include "key_data.hpp"
 
+#include <cstdlib> // malloc()/free() for KeySetOut::KeyParts
+
 
 namespace galera
 {
@@ -31,7 +34,15 @@ public:
         FLAT16,   /* 16-byte hash (flat) */
         FLAT16A,  /* 16-byte hash (flat), annotated */
 //      TREE8,    /*  8-byte hash + full serialized key */
-        MAX_VERSION = FLAT16A
+        /* annotated with shared prefix: a part annotates only its own
+         * bytes, parent parts are elided since deduplication guarantees
+         * that each of them is stored (fully annotated) in the same key
+         * set. Cuts the repeated schema/table prefixes from every leaf.
+         * NOTE: may be configured only after every node in the cluster
+         * understands these versions. */
+        FLAT8AP,  /*  8-byte hash (flat), prefix-annotated */
+        FLAT16AP, /* 16-byte hash (flat), prefix-annotated */
+        MAX_VERSION = FLAT16AP
     };
 
     static Version version (unsigned int ver)
@@ -82,9 +93,7 @@ public:
         {
             assert(ver > EMPTY && ver <= MAX_VERSION);
 
-            /* 16 if ver in { FLAT16, FLAT16A }, 8 otherwise */
-            int const key_size
-                (8 << (static_cast<unsigned int>(ver - FLAT16) <= 1));
+            int const key_size(hash_size(ver));
 
             memcpy (tmp.buf, hash.buf, key_size);
 
@@ -104,7 +113,8 @@ public:
             if (annotated(ver))
             {
                 store_annotation(parts, part_num,
-                                 tmp.buf + key_size,sizeof(tmp.buf) - key_size);
+                                 tmp.buf + key_size,sizeof(tmp.buf) - key_size,
+                                 prefix_annotated(ver));
             }
         }
 
@@ -161,21 +171,23 @@ public:
             const uint32_t* rhs(reinterpret_cast<const uint32_t*>(kp.data_));
 #endif /* WORDSIZE */
 
-            switch (std::min(version(), kp.version()))
+            if (gu_unlikely(EMPTY == version() || EMPTY == kp.version()))
             {
-            case EMPTY:
                 assert(0);
                 throw_match_empty_key(version(), kp.version());
-            case FLAT16:
-            case FLAT16A:
+            }
+
+            /* compare the hash width common to both versions */
+            switch (std::min(hash_size(version()), hash_size(kp.version())))
+            {
+            case 16:
 #if GU_WORDSIZE == 64
                 ret = (lhs[1] == rhs[1]);
 #else
                 ret = (lhs[2] == rhs[2] && lhs[3] == rhs[3]);
 #endif /* WORDSIZE */
                 /* fall through */
-            case FLAT8:
-            case FLAT8A:
+            case 8:
                 /* shift is to clear up the header */
 #if GU_WORDSIZE == 64
                 ret = ret && ((gtoh64(lhs[0]) >> HEADER_BITS) ==
@@ -251,16 +263,17 @@ public:
         const gu::byte_t* data_; // it never owns the buffer
 
         static size_t
-        base_size (Version const ver,
-                   const gu::byte_t* const buf, size_t const size)
+        hash_size (Version const ver)
         {
             switch (ver)
             {
             case FLAT16:
             case FLAT16A:
+            case FLAT16AP:
                 return 16;
             case FLAT8:
             case FLAT8A:
+            case FLAT8AP:
                 return 8;
             case EMPTY: assert(0);
             }
@@ -268,10 +281,24 @@ public:
             abort();
         }
 
+        static size_t
+        base_size (Version const ver,
+                   const gu::byte_t* const buf, size_t const size)
+        {
+            return hash_size(ver);
+        }
+
         static bool
         annotated (Version const ver)
         {
-            return (ver == FLAT16A || ver == FLAT8A);
+            return (ver == FLAT16A  || ver == FLAT8A ||
+                    prefix_annotated(ver));
+        }
+
+        static bool
+        prefix_annotated (Version const ver)
+        {
+            return (ver == FLAT16AP || ver == FLAT8AP);
         }
 
         typedef uint16_t ann_size_t;
@@ -296,10 +323,11 @@ public:
 
         static size_t
         store_annotation (const wsrep_buf_t* parts, int part_num,
-                          gu::byte_t* buf, int size);
+                          gu::byte_t* buf, int size, bool share_prefix);
 
         static void
-        print_annotation (std::ostream& os, const gu::byte_t* buf);
+        print_annotation (std::ostream& os, const gu::byte_t* buf,
+                          bool share_prefix);
 
         static void
         throw_buffer_too_short (size_t expected, size_t got) GU_NORETURN;
@@ -344,6 +372,13 @@ operator << (std::ostream& os, const KeySet::KeyPart& kp)
 # pragma GCC diagnostic ignored "-Weffc++"
 #endif
 
+/* NOTE: serializing a bloom filter of the key hashes alongside the key
+ * set (as a new KeySet/WriteSetNG version) was considered and rejected:
+ * certification here tests keys against the shared cert index, never
+ * one writeset against another, and every certified writeset inserts
+ * its keys into the index regardless, so a per-writeset filter has no
+ * reader. The constant-time negative path lives index-side instead -
+ * see Certification::CertIndexShardedNG::KeyFilter. */
 class KeySetOut : public gu::RecordSetOut<KeySet::KeyPart>
 {
 public:
@@ -357,21 +392,43 @@ public:
 #else
     KeyPartSet;
 
-    /* This is a naive mock up of an "unordered set" that first tries to use
-     * preallocated set of buckets and falls back to a "real" heap-based
-     * unordered set from STL/TR1 when preallocated one is exhausted.
-     * The goal is to make sure that at least 3 keys can be inserted without
-     * the need for dynamic allocation.
-     * In practice, with 64 "buckets" and search depth of 3, the average
-     * number of inserted keys before there is a need to go for heap is 25.
-     * 128 buckets will give you 45 and 256 - around 80. */
+    /* This is a flat open-addressing "unordered set" (linear probing, load
+     * factor capped at 1/2). Key part bytes live in the writeset buffer, so
+     * an element here is just a pointer to them, stored in a cell drawn from
+     * an internal append-only arena. The probe table holds pointers to cells
+     * and is free to regrow (doubling, starting from a preallocated 64-slot
+     * array), while the cells themselves never move - iterators returned
+     * from insert() stay valid for the lifetime of the set, which the rest
+     * of KeySetOut relies upon. Unlike a node-based set this costs no
+     * allocation per key: a 10k-row statement makes ~10 arena/table
+     * allocations instead of 10k node ones. */
     class KeyParts
     {
     public:
-        KeyParts() : first_(), second_(NULL), first_size_(0)
-        { ::memset(first_, 0, sizeof(first_)); }
+        KeyParts()
+            :
+            cells0_ (),
+            tab0_   (),
+            tab_    (tab0_),
+            mask_   (INIT_MASK),
+            size_   (0),
+            cells_  (0),
+            cell_   (cells0_),
+            left_   (INIT_CELLS),
+            chunks_ (NULL)
+        {}
+
+        ~KeyParts()
+        {
+            while (chunks_)
+            {
+                Chunk* const next(chunks_->next_);
+                ::free(chunks_);
+                chunks_ = next;
+            }
 
-        ~KeyParts() { delete second_; }
+            if (tab_ != tab0_) ::free(tab_);
+        }
 
         /* This iterator class is declared for compatibility with
          * unordered_set. We may actually use a more simple interface here. */
@@ -379,8 +436,8 @@ public:
         {
         public:
             iterator(const KeySet::KeyPart* kp) : kp_(kp) {}
-            /* This is sort-of a dirty hack to ensure that first_ array
-             * of KeyParts class can be treated like a POD array.
+            /* This is sort-of a dirty hack to ensure that an arena cell
+             * of KeyParts class can be treated like a KeySet::KeyPart.
              * It uses the fact that the only non-static member of
              * KeySet::KeyPart is gu::byte_t* and so does direct casts between
              * pointers. I wish someone could make it cleaner. */
@@ -407,22 +464,16 @@ public:
 
         const iterator find(const KeySet::KeyPart& kp)
         {
-            unsigned int idx(kp.hash());
+            unsigned int idx(kp.hash() & mask_);
 
-            for (unsigned int i(0); i < FIRST_DEPTH; ++i, ++idx)
+            while (0 != tab_[idx])
             {
-                idx &= FIRST_MASK;
-
-                if (0 !=first_[idx] && KeySet::KeyPart(first_[idx]).matches(kp))
+                if (KeySet::KeyPart(*tab_[idx]).matches(kp))
                 {
-                    return iterator(&first_[idx]);
+                    return iterator(tab_[idx]);
                 }
-            }
 
-            if (second_ && second_->size() > 0)
-            {
-                KeyPartSet::iterator i2(second_->find(kp));
-                if (i2 != second_->end()) return iterator(&(*i2));
+                idx = (idx + 1) & mask_;
             }
 
             return end();
@@ -430,77 +481,153 @@ public:
 
         std::pair<iterator, bool> insert(const KeySet::KeyPart& kp)
         {
-            unsigned int idx(kp.hash());
+            /* grow ahead of insertion to keep load factor under 1/2 */
+            if (gu_unlikely(2*(size_ + 1) > mask_ + 1)) grow();
 
-            for (unsigned int i(0); i < FIRST_DEPTH; ++i, ++idx)
-            {
-                idx &= FIRST_MASK;
+            unsigned int idx(kp.hash() & mask_);
 
-                if (0 == first_[idx])
+            while (0 != tab_[idx])
+            {
+                if (KeySet::KeyPart(*tab_[idx]).matches(kp))
                 {
-                    first_[idx] = kp.ptr();
-                    ++first_size_;
-                    return
-                        std::pair<iterator, bool>(iterator(&first_[idx]), true);
+                    return std::pair<iterator, bool>(iterator(tab_[idx]),
+                                                     false);
                 }
 
-                if (KeySet::KeyPart(first_[idx]).matches(kp))
-                {
-                    return
-                        std::pair<iterator, bool>(iterator(&first_[idx]),false);
-                }
+                idx = (idx + 1) & mask_;
             }
 
-            if (!second_)
-            {
-                second_ = new KeyPartSet();
-//                log_info << "Requesting heap at load factor "
-//                         << first_size_ << '/' << FIRST_SIZE << " = "
-//                         << (double(first_size_)/FIRST_SIZE);
-            }
+            const gu::byte_t** const cell(new_cell());
 
-            std::pair<KeyPartSet::iterator, bool> res = second_->insert(kp);
-            return std::pair<iterator, bool>(iterator(&(*res.first)),
-                                             res.second);
+            *cell = kp.ptr();
+            tab_[idx] = cell;
+            ++size_;
+
+            return std::pair<iterator, bool>(iterator(cell), true);
         }
 
         iterator erase(iterator it)
         {
-            unsigned int idx(it->hash());
+            unsigned int i(it->hash() & mask_);
+
+            while (0 != tab_[i])
+            {
+                if (KeySet::KeyPart(*tab_[i]).matches(*it)) break;
+                i = (i + 1) & mask_;
+            }
+
+            if (0 == tab_[i]) return end();
 
-            for (unsigned int i(0); i < FIRST_DEPTH; ++i, ++idx)
+            /* backward-shift deletion keeps probe chains intact;
+             * the cell itself stays in the arena */
+            unsigned int j(i);
+
+            for (;;)
             {
-                idx &= FIRST_MASK;
+                j = (j + 1) & mask_;
+
+                if (0 == tab_[j]) break;
 
-                if (first_[idx] && KeySet::KeyPart(first_[idx]).matches(*it))
+                unsigned int const k(KeySet::KeyPart(*tab_[j]).hash() & mask_);
+
+                if (((j - k) & mask_) >= ((j - i) & mask_))
                 {
-                    first_[idx] = 0;
-                    --first_size_;
-                    return iterator(&first_[(idx + 1) & FIRST_MASK]);
+                    tab_[i] = tab_[j];
+                    i = j;
                 }
             }
 
-            if (second_ && second_->size() > 0)
+            tab_[i] = 0;
+            --size_;
+
+            return end();
+        }
+
+        size_t size() const { return size_; }
+
+    private:
+
+        static unsigned int const INIT_MASK  = 0x3f; // 64 slots
+        static unsigned int const INIT_SIZE  = INIT_MASK + 1;
+        static unsigned int const INIT_CELLS = INIT_SIZE/2; // max load is 1/2
+
+        /* arena chunk header, cells follow it in the same allocation */
+        struct Chunk { Chunk* next_; };
+
+        /* rehash into a table of twice the size; cells don't move, so
+         * iterators handed out earlier are unaffected */
+        void grow()
+        {
+            unsigned int const new_mask(((mask_ + 1) << 1) - 1);
+
+            const gu::byte_t*** const new_tab(
+                static_cast<const gu::byte_t***>(
+                    ::calloc(new_mask + 1, sizeof(tab_[0]))));
+
+            if (gu_unlikely(NULL == new_tab))
+            {
+                gu_throw_error(ENOMEM) << "Could not grow key part table to "
+                                       << (new_mask + 1) << " slots";
+            }
+
+            for (unsigned int i(0); i <= mask_; ++i)
             {
-                KeyPartSet::iterator it2(second_->erase(second_->find(*it)));
+                const gu::byte_t** const cell(tab_[i]);
+
+                if (0 == cell) continue;
+
+                unsigned int idx(KeySet::KeyPart(*cell).hash() & new_mask);
 
-                if (it2 != second_->end()) return iterator(&(*it2));
+                while (0 != new_tab[idx]) idx = (idx + 1) & new_mask;
+
+                new_tab[idx] = cell;
             }
 
-            return end();
+            if (tab_ != tab0_) ::free(tab_);
+
+            tab_  = new_tab;
+            mask_ = new_mask;
         }
 
-        size_t size() const { return (first_size_ + second_->size()); }
+        /* next cell from the arena, allocating a chunk that doubles the
+         * total cell count when the current one runs out */
+        const gu::byte_t** new_cell()
+        {
+            if (gu_unlikely(0 == left_))
+            {
+                unsigned int const n(cells_);
+
+                Chunk* const c(static_cast<Chunk*>(
+                    ::malloc(sizeof(Chunk) + n*sizeof(const gu::byte_t*))));
 
-    private:
+                if (gu_unlikely(NULL == c))
+                {
+                    gu_throw_error(ENOMEM)
+                        << "Could not allocate key part arena chunk of "
+                        << n << " cells";
+                }
 
-        static unsigned int const FIRST_MASK  = 0x3f; // 63
-        static unsigned int const FIRST_SIZE  = FIRST_MASK + 1;
-        static unsigned int const FIRST_DEPTH = 3;
+                c->next_ = chunks_;
+                chunks_  = c;
+                cell_    = reinterpret_cast<const gu::byte_t**>(c + 1);
+                left_    = n;
+            }
+
+            --left_;
+            ++cells_;
+
+            return cell_++;
+        }
 
-        const gu::byte_t* first_[FIRST_SIZE];
-        KeyPartSet*       second_;
-        unsigned int      first_size_;
+        const gu::byte_t*   cells0_[INIT_CELLS]; // preallocated arena
+        const gu::byte_t**  tab0_  [INIT_SIZE];  // preallocated probe table
+        const gu::byte_t*** tab_;
+        unsigned int        mask_;
+        unsigned int        size_;   // elements in the set
+        unsigned int        cells_;  // cells drawn from the arena so far
+        const gu::byte_t**  cell_;   // next free cell
+        unsigned int        left_;   // free cells left in the current chunk
+        Chunk*              chunks_; // heap-allocated arena chunks
     };
 #endif /* 1 */
 
@@ -692,6 +819,15 @@ operator << (std::ostream& os, const KeySetOut::KeyPart& kp)
 }
 
 
+/* NOTE: there is no decode/interning cache here on purpose. A record
+ * returned by next() is a pointer into the writeset buffer - nothing is
+ * parsed or allocated per key. The stored form of a part is its hash,
+ * so KeyPart::hash() is a single load and matches() a word compare;
+ * a cache keyed by a hash of the serialized bytes would hash the very
+ * bytes it is meant to avoid reading. Cross-writeset sharing of
+ * repeated parts (same table, same schema) is what the certification
+ * index provides: a KeyEntryNG is allocated only when a key is first
+ * seen and is then referenced by every later writeset. */
 class KeySetIn : public gu::RecordSetIn<KeySet::KeyPart>
 {
 public:
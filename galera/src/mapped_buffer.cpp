@@ -8,6 +8,7 @@
 
 #include "gu_throw.hpp"
 #include "gu_logger.hpp"
+#include "gu_mem_pool.hpp"
 
 #include "gu_macros.h"
 
@@ -25,6 +26,57 @@
 using namespace std;
 using namespace gu;
 
+/* Address space to reserve (in units of threshold_) when the buffer first
+ * spills to file. The backing file is extended with ftruncate() and stays
+ * sparse, and MAP_NORESERVE keeps the mapping from counting against memory
+ * overcommit, so over-reserving costs nothing but address space - while
+ * every reserve() call that fits in the reservation becomes a no-op instead
+ * of a munmap()/mmap() cycle that refaults the whole buffer. */
+static size_t const map_reserve_factor(16);
+
+/* Recycling pool for small in-memory buffers. During IST catch-up a
+ * buffer is allocated per received writeset at six-figure rates, and the
+ * malloc()/free() pair per trx makes the allocator the bottleneck. The
+ * pool is self-sizing (see gu_mem_pool.hpp), so it tracks the number of
+ * writesets in flight between the receiver and the appliers. Writesets
+ * that outgrow a pool buffer fall back to private allocation - they are
+ * rare enough not to matter. The pool is deliberately never destructed:
+ * trx buffers can outlive static destruction order at shutdown. */
+static size_t const pool_buf_size(1 << 16);
+
+static gu::MemPool<true>& buf_pool()
+{
+    static gu::MemPool<true>* const pool(
+        new gu::MemPool<true>(pool_buf_size, 16, "mapped_buffer"));
+    return *pool;
+}
+
+/* Maps length bytes of fd and applies fault-friendly madvise hints.
+ * Returns MAP_FAILED with errno set on mapping failure (hint failures
+ * are ignored - they only affect performance). */
+static byte_t* map_file(int const fd, size_t const length)
+{
+    int flags(MAP_PRIVATE);
+#if defined(MAP_NORESERVE)
+    flags |= MAP_NORESERVE;
+#endif
+
+    void* const ret(mmap(NULL, length, PROT_READ | PROT_WRITE, flags, fd, 0));
+
+    if (ret == MAP_FAILED) return reinterpret_cast<byte_t*>(MAP_FAILED);
+
+#if defined(MADV_HUGEPAGE)
+    /* best effort only: kernels without file-backed THP support reject
+     * the hint with EINVAL, and the mapping works fine without it */
+    if (madvise(ret, length, MADV_HUGEPAGE) != 0)
+    {
+        log_debug << "madvise(MADV_HUGEPAGE) failed: " << errno;
+    }
+#endif
+
+    return reinterpret_cast<byte_t*>(ret);
+}
+
 
 galera::MappedBuffer::MappedBuffer(const std::string& working_dir,
                                    size_t threshold)
@@ -35,7 +87,8 @@ galera::MappedBuffer::MappedBuffer(const std::string& working_dir,
     threshold_    (threshold),
     buf_          (0),
     buf_size_     (0),
-    real_buf_size_(0)
+    real_buf_size_(0),
+    pooled_       (false)
 {
 
 }
@@ -74,6 +127,26 @@ void galera::MappedBuffer::reserve(size_t sz)
             sz = (sz/threshold_ + 1)*threshold_;
         }
 
+        if (fd_ == -1)
+        {
+            // over-reserve on first mapping, see map_reserve_factor above
+            if (gu_likely(threshold_ <=
+                          std::numeric_limits<size_t>::max()/map_reserve_factor))
+            {
+                sz = max(sz, threshold_*map_reserve_factor);
+            }
+        }
+        else
+        {
+            // reservation exhausted, grow geometrically so that remapping
+            // happens O(log(size)) times rather than on every threshold_
+            if (gu_likely(real_buf_size_ <=
+                          std::numeric_limits<size_t>::max()/2))
+            {
+                sz = max(sz, real_buf_size_*2);
+            }
+        }
+
         if (gu_unlikely(sz >
                         static_cast<size_t>(std::numeric_limits<off_t>::max())))
         {
@@ -92,47 +165,72 @@ void galera::MappedBuffer::reserve(size_t sz)
             {
                 gu_throw_error(errno) << "ftruncate() failed";
             }
-            byte_t* tmp(reinterpret_cast<byte_t*>(
-                            mmap(NULL, sz, PROT_READ | PROT_WRITE, MAP_PRIVATE,
-                                 fd_, 0)));
+            byte_t* tmp(map_file(fd_, sz));
             if (tmp == MAP_FAILED)
             {
                 int dummy_errno = errno;
-                free(buf_);
-                buf_ = 0;
+                free_buf();
                 clear();
                 gu_throw_error(dummy_errno) << "mmap() failed";
             }
             copy(buf_, buf_ + buf_size_, tmp);
-            free(buf_);
+            free_buf();
             buf_ = tmp;
         }
         else
         {
-            if (munmap(buf_, real_buf_size_) != 0)
-            {
-                gu_throw_error(errno) << "munmap() failed";
-            }
             if (ftruncate(fd_, sz) == -1)
             {
-                gu_throw_error(errno) << "fruncate() failed";
+                gu_throw_error(errno) << "ftruncate() failed";
             }
-            byte_t* tmp(reinterpret_cast<byte_t*>(
-                            mmap(NULL, sz, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd_, 0)));
+            byte_t* tmp(map_file(fd_, sz));
             if (tmp == MAP_FAILED)
             {
                 int dummy_errno = errno;
-                buf_ = 0;
                 clear();
                 gu_throw_error(dummy_errno) << "mmap() failed";
             }
+            /* mapping is MAP_PRIVATE, so modified pages live in anonymous
+             * memory and are discarded by munmap() - the contents must be
+             * copied to the new mapping before the old one is dropped */
+            copy(buf_, buf_ + buf_size_, tmp);
+            if (munmap(buf_, real_buf_size_) != 0)
+            {
+                int dummy_errno = errno;
+                munmap(tmp, sz);
+                buf_ = 0;
+                clear();
+                gu_throw_error(dummy_errno) << "munmap() failed";
+            }
             buf_ = tmp;
         }
     }
+    else if (buf_ == 0 && sz <= pool_buf_size)
+    {
+        // common case: the contents fit a recycled pool buffer
+        buf_    = reinterpret_cast<byte_t*>(buf_pool().acquire());
+        pooled_ = true;
+        sz      = pool_buf_size;
+    }
     else
     {
         sz = min(threshold_, sz*2);
-        byte_t* tmp(reinterpret_cast<byte_t*>(realloc(buf_, sz)));
+        byte_t* tmp;
+        if (pooled_)
+        {
+            // grew out of the pool buffer, move to a private one
+            tmp = reinterpret_cast<byte_t*>(malloc(sz));
+            if (tmp != 0)
+            {
+                copy(buf_, buf_ + buf_size_, tmp);
+                buf_pool().recycle(buf_);
+                pooled_ = false;
+            }
+        }
+        else
+        {
+            tmp = reinterpret_cast<byte_t*>(realloc(buf_, sz));
+        }
         if (tmp == 0)
         {
             gu_throw_error(errno) << "realloc failed";
@@ -143,6 +241,23 @@ void galera::MappedBuffer::reserve(size_t sz)
 }
 
 
+void galera::MappedBuffer::free_buf()
+{
+    if (pooled_)
+    {
+        assert(buf_ != 0);
+        buf_pool().recycle(buf_);
+        pooled_ = false;
+    }
+    else
+    {
+        free(buf_);
+    }
+
+    buf_ = 0;
+}
+
+
 void galera::MappedBuffer::resize(size_t sz)
 {
     reserve(sz);
@@ -160,7 +275,7 @@ void galera::MappedBuffer::clear()
     }
     else
     {
-        free(buf_);
+        free_buf();
     }
 
     fd_            = -1;
@@ -46,6 +46,9 @@ namespace galera
         MappedBuffer(const MappedBuffer&);
         void operator=(const MappedBuffer&);
 
+        // returns the in-memory buffer to where it came from
+        void free_buf();
+
         const std::string& working_dir_; // working dir for data files
         std::string  file_;
         int          fd_;            // file descriptor
@@ -53,6 +56,7 @@ namespace galera
         gu::byte_t*  buf_;           // data buffer
         size_t       buf_size_;      // buffer size (inserted data size)
         size_t       real_buf_size_; // real buffer size (allocated size)
+        bool         pooled_;        // buf_ came from the recycling pool
     };
 }
 
@@ -8,11 +8,22 @@
 #include "trx_handle.hpp"
 #include <gu_lock.hpp> // for gu::Mutex and gu::Cond
 #include <gu_limits.h>
+#include <gu_hdr_histogram.hpp>
+#include <gu_atomic.h>
+#include <gu_time.h>
 
 #include <vector>
 
 namespace galera
 {
+    /* Wakeup granularity: each process slot carries its own condition
+     * variables (cond_ for entry, wait_cond_ for seqno waiters), so leave()
+     * wakes only the successors whose entry condition is satisfied - there
+     * is no monitor-wide thundering herd on the ordered path. The global
+     * cond_ is used solely for window-full producers and drainers, and
+     * gu::Cond elides the system call when there are no waiters. Replacing
+     * the pthread primitives with raw futexes would duplicate what they
+     * already do underneath (futex wait/wake per condvar). */
     template <class C>
     class Monitor
     {
@@ -20,11 +31,13 @@ namespace galera
 
         struct Process
         {
-            Process() : obj_(0), cond_(), wait_cond_(), state_(S_IDLE) { }
+            Process() : obj_(0), cond_(), wait_cond_(), enter_time_(0),
+                        state_(S_IDLE) { }
 
-            const C* obj_;
-            gu::Cond cond_;
-            gu::Cond wait_cond_;
+            const C*  obj_;
+            gu::Cond  cond_;
+            gu::Cond  wait_cond_;
+            long long enter_time_; // when the occupant entered, for busy_ns_
             enum State
             {
                 S_IDLE,     // Slot is free
@@ -64,7 +77,14 @@ namespace galera
             entered_(0),
             oooe_(0),
             oool_(0),
-            win_size_(0)
+            win_size_(0),
+            waiters_(0),
+            active_(0),
+            busy_ns_(0),
+            wait_ns_(0),
+            max_spin_ns_(16384), // ~16us
+            avg_wait_ns_(0),
+            wait_hist_()
         { }
 
         ~Monitor()
@@ -82,6 +102,15 @@ namespace galera
             }
         }
 
+        /* Caps the adaptive spin in maybe_spin(). Raised by the latency
+         * profile, where burning some CPU ahead of the condvar is an
+         * accepted trade for tail latency; 0 disables spinning. */
+        void set_max_spin_ns(long long ns)
+        {
+            gu::Lock lock(mutex_);
+            max_spin_ns_ = ns;
+        }
+
         void set_initial_position(wsrep_seqno_t seqno)
         {
             gu::Lock lock(mutex_);
@@ -108,6 +137,10 @@ namespace galera
         {
             const wsrep_seqno_t obj_seqno(obj.seqno());
             const size_t        idx(indexof(obj_seqno));
+            long long const     enter_start(gu_time_monotonic());
+
+            maybe_spin(obj_seqno, enter_start);
+
             gu::Lock            lock(mutex_);
 
             assert(obj_seqno > last_left_);
@@ -124,6 +157,7 @@ namespace galera
 #ifdef GU_DBUG_ON
                 obj.debug_sync(mutex_);
 #endif // GU_DBUG_ON
+                ++waiters_;
                 while (may_enter(obj) == false &&
                        process_[idx].state_ == Process::S_WAITING)
                 {
@@ -131,6 +165,7 @@ namespace galera
                     lock.wait(process_[idx].cond_);
                     obj.lock();
                 }
+                --waiters_;
 
                 if (process_[idx].state_ != Process::S_CANCELED)
                 {
@@ -142,6 +177,18 @@ namespace galera
                     ++entered_;
                     oooe_     += ((last_left_ + 1) < obj_seqno);
                     win_size_ += (last_entered_ - last_left_);
+
+                    long long const now(gu_time_monotonic());
+                    long long const waited(now - enter_start);
+                    process_[idx].enter_time_ = now;
+                    ++active_;
+                    wait_ns_ += waited;
+                    wait_hist_.record(waited);
+                    // EWMA of enter() waits with 1/8 weight, drives
+                    // the spin decision in maybe_spin()
+                    long long const avg(avg_wait_ns_ - avg_wait_ns_/8 +
+                                        waited/8);
+                    gu_atomic_set(&avg_wait_ns_, &avg);
                     return;
                 }
             }
@@ -149,14 +196,17 @@ namespace galera
             assert(process_[idx].state_ == Process::S_CANCELED);
             process_[idx].state_ = Process::S_IDLE;
 
-            gu_throw_error(EINTR);
+            /* an interrupted wait is a normal, high-frequency outcome
+             * under BF aborts: throw a preformatted exception instead
+             * of building a message on every abort - the catchers only
+             * look at get_errno() */
+            static gu::Exception const interrupted("interrupted", EINTR);
+            throw interrupted;
         }
 
         void leave(const C& obj)
         {
-#ifndef NDEBUG
             size_t   idx(indexof(obj.seqno()));
-#endif /* NDEBUG */
             gu::Lock lock(mutex_);
 
             assert(process_[idx].state_ == Process::S_APPLYING ||
@@ -164,6 +214,12 @@ namespace galera
 
             assert(process_[indexof(last_left_)].state_ == Process::S_IDLE);
 
+            if (gu_likely(process_[idx].state_ == Process::S_APPLYING))
+            {
+                busy_ns_ += gu_time_monotonic() - process_[idx].enter_time_;
+                --active_;
+            }
+
             post_leave(obj, lock);
         }
 
@@ -248,6 +304,19 @@ namespace galera
         }
 
         void drain(wsrep_seqno_t seqno)
+        {
+            drain_begin(seqno);
+            drain_end();
+        }
+
+        /*! First phase of drain(): wait for a possible earlier drain to
+         *  finish and freeze admission above seqno. In-flight seqnos at
+         *  or below the watermark keep running and may still enter, only
+         *  seqnos above it block. Must be paired with drain_end().
+         *  Splitting the phases lets a caller freeze several monitors
+         *  up front and then wait, overlapping the drains instead of
+         *  running them back to back. */
+        void drain_begin(wsrep_seqno_t seqno)
         {
             gu::Lock lock(mutex_);
 
@@ -256,7 +325,18 @@ namespace galera
                 lock.wait(cond_);
             }
 
-            drain_common(seqno, lock);
+            drain_seqno_ = seqno;
+        }
+
+        /*! Second phase of drain(): wait until everything at or below
+         *  the watermark has left and reopen admission. */
+        void drain_end()
+        {
+            gu::Lock lock(mutex_);
+
+            assert(drain_seqno_ != GU_LLONG_MAX);
+
+            drain_common(drain_seqno_, lock);
 
             // there can be some stale canceled entries
             update_last_left();
@@ -286,15 +366,33 @@ namespace galera
         }
 
 
-        void get_stats(double* oooe, double* oool, double* win_size)
+        /* whether seqno has left the critical section. Valid only while
+         * mutex_ is held, i.e. from condition() callbacks. */
+        bool finished(wsrep_seqno_t seqno) const
         {
-            gu::Lock lock(mutex_);
+            if (seqno <= last_left_)    return true;
+            if (seqno >  last_entered_) return false;
+            return (process_[indexof(seqno)].state_ == Process::S_FINISHED);
+        }
 
-            if (entered_ > 0)
+        void get_stats(double* oooe, double* oool, double* win_size) const
+        {
+            /* Lock-free monitoring snapshot: mutex_ is the replication
+             * hot path, so the counters are read with atomic loads
+             * instead. The ratios may be off by a transaction or two,
+             * which is fine for statistics. */
+            long entered, ooo_e, ooo_l, win;
+
+            gu_atomic_get (&entered_,  &entered);
+            gu_atomic_get (&oooe_,     &ooo_e);
+            gu_atomic_get (&oool_,     &ooo_l);
+            gu_atomic_get (&win_size_, &win);
+
+            if (entered > 0)
             {
-                *oooe = (oooe_ > 0 ? double(oooe_)/entered_ : .0);
-                *oool = (oool_ > 0 ? double(oool_)/entered_ : .0);
-                *win_size = (win_size_ > 0 ? double(win_size_)/entered_ : .0);
+                *oooe = (ooo_e > 0 ? double(ooo_e)/entered : .0);
+                *oool = (ooo_l > 0 ? double(ooo_l)/entered : .0);
+                *win_size = (win > 0 ? double(win)/entered : .0);
             }
             else
             {
@@ -302,22 +400,89 @@ namespace galera
             }
         }
 
+        /*! Instantaneous occupancy and cumulative busy/wait cycle totals
+         *  over enter()-leave() pairs. busy_ns divided by applier thread
+         *  count and wall time gives pool utilization: a high wait share
+         *  with few active occupants means the appliers are starved by
+         *  dependencies, busy share near one means the pool is
+         *  saturated. Lock-free snapshot like get_stats(). */
+        void busy_stats(long* waiters, long* active,
+                        long long* busy_ns, long long* wait_ns) const
+        {
+            gu_atomic_get (&waiters_, waiters);
+            gu_atomic_get (&active_,  active);
+            gu_atomic_get (&busy_ns_, busy_ns);
+            gu_atomic_get (&wait_ns_, wait_ns);
+        }
+
         void flush_stats()
         {
             gu::Lock lock(mutex_);
             oooe_ = 0; oool_ = 0; win_size_ = 0; entered_ = 0;
+            busy_ns_ = 0; wait_ns_ = 0;
+            wait_hist_.clear();
+        }
+
+        /*! Latency percentiles of enter(): queueing for the monitor
+         *  mutex plus waiting for the entry condition. Recording is
+         *  lock-free, reading merges on demand. */
+        const gu::HdrHistogram& wait_histogram() const { return wait_hist_; }
+
+        /*! EWMA of recent enter() waits in nanoseconds - the same
+         *  average that drives the adaptive spin. Unlike the cumulative
+         *  histogram above it reacts within tens of entries, which
+         *  makes it usable as a live latency signal for backpressure
+         *  (e.g. IST donor throttling). Lock-free read. */
+        long long avg_wait_ns() const
+        {
+            long long ret;
+            gu_atomic_get(&avg_wait_ns_, &ret);
+            return ret;
         }
 
     private:
 
-        size_t indexof(wsrep_seqno_t seqno)
+        size_t indexof(wsrep_seqno_t seqno) const
         {
             return (seqno & process_mask_);
         }
 
         bool may_enter(const C& obj) const
         {
-            return obj.condition(last_entered_, last_left_);
+            return obj.condition(last_entered_, last_left_, *this);
+        }
+
+        /* Bounded adaptive spin before taking the monitor mutex. When
+         * waits are typically shorter than a park/unpark round trip it
+         * pays to poll for the immediate predecessor leaving instead of
+         * going straight for the condvar. The spin budget follows the
+         * EWMA of observed enter() waits and is active only while that
+         * average stays below max_spin_ns_, so long applying times or a
+         * backed up monitor turn spinning off by themselves. Spinning
+         * happens strictly before the mutex is acquired: the lockless
+         * reads are a heuristic only, entry conditions are re-evaluated
+         * under the mutex as before. Skipped unless the predecessor has
+         * already entered, so out-of-order entries whose dependencies
+         * are met do not stall behind an unrelated in-flight seqno. */
+        void maybe_spin(wsrep_seqno_t const obj_seqno, long long const start)
+        {
+            long long avg;
+            gu_atomic_get(&avg_wait_ns_, &avg);
+            if (avg <= 0 || avg >= max_spin_ns_) return;
+
+            wsrep_seqno_t le;
+            gu_atomic_get(&last_entered_, &le);
+            if (le < obj_seqno - 1) return;
+
+            long long budget(2*avg);
+            if (budget > max_spin_ns_) budget = max_spin_ns_;
+            wsrep_seqno_t ll;
+            do
+            {
+                gu_atomic_get(&last_left_, &ll);
+                if (ll >= obj_seqno - 1) return; // predecessors have left
+            }
+            while (gu_time_monotonic() - start < budget);
         }
 
         // wait until it is possible to grab slot in monitor,
@@ -397,6 +562,9 @@ namespace galera
             else
             {
                 process_[idx].state_ = Process::S_FINISHED;
+                // finished()-based entry conditions may become true on an
+                // out-of-order leave even though last_left_ did not advance
+                wake_up_next();
             }
 
             process_[idx].obj_ = 0;
@@ -453,6 +621,17 @@ namespace galera
         long oooe_;     // out of order entered
         long oool_;     // out of order left
         long win_size_; // window between last_left_ and last_entered_
+
+        long      waiters_; // threads currently blocked in enter()
+        long      active_;  // threads currently between enter() and leave()
+        long long busy_ns_; // cumulative enter()-to-leave() time
+        long long wait_ns_; // cumulative enter() wait time
+
+        long long max_spin_ns_; // spin budget cap, see set_max_spin_ns()
+        long long avg_wait_ns_; // EWMA of enter() waits, written under
+                                // mutex_, read lock-free in maybe_spin()
+
+        gu::HdrHistogram wait_hist_; // enter() latency
     };
 }
 
@@ -8,6 +8,7 @@ namespace galera
 {
 
 std::string const Replicator::Param::debug_log = "debug";
+std::string const Replicator::Param::profile   = "profile";
 #ifdef GU_DBUG_ON
 std::string const Replicator::Param::dbug = "dbug";
 std::string const Replicator::Param::signal = "signal";
@@ -16,6 +17,7 @@ std::string const Replicator::Param::signal = "signal";
 void Replicator::register_params(gu::Config& conf)
 {
     conf.add(Param::debug_log, "no");
+    conf.add(Param::profile, "");
 #ifdef GU_DBUG_ON
     conf.add(Param::dbug, "");
     conf.add(Param::signal, "");
@@ -28,6 +28,7 @@ namespace galera
         struct Param
         {
             static std::string const debug_log;
+            static std::string const profile;
 #ifdef GU_DBUG_ON
             static std::string const dbug;
             static std::string const signal;
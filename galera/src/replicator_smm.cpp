@@ -5,12 +5,16 @@
 #include "galera_common.hpp"
 #include "replicator_smm.hpp"
 #include "galera_exception.hpp"
+#include "action_recorder.hpp"
 #include "uuid.hpp"
 
 #include "galera_info.hpp"
 
 #include <gu_debug_sync.hpp>
 #include <gu_abort.h>
+#include <gu_probes.h>
+#include <gu_thread.hpp>
+#include <gu_maintenance.hpp>
 
 #include <sstream>
 #include <iostream>
@@ -68,7 +72,8 @@ apply_trx_ws(void*                    recv_ctx,
 
                     if (attempts <= max_apply_attempts)
                     {
-                        log_warn << e.what()
+                        log_warn << "Failed to apply app buffer: seqno: "
+                                 << trx.global_seqno() << ", status: " << err
                                  << "\nRetrying " << attempts << "th time";
                     }
                 }
@@ -113,6 +118,16 @@ std::ostream& galera::operator<<(std::ostream& os, ReplicatorSMM::State state)
     gu_throw_fatal << "invalid state " << static_cast<int>(state);
 }
 
+/* trampoline for the gcs slave queue watermark callback */
+static void
+slave_queue_watermark_cb (void* const ctx, long const q_len, long const mark,
+                          bool const over)
+{
+    static_cast<galera::ReplicatorSMM*>(ctx)->slave_queue_watermark(q_len,
+                                                                    mark,
+                                                                    over);
+}
+
 //////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////
 //                           Public
@@ -140,7 +155,8 @@ galera::ReplicatorSMM::ReplicatorSMM(const struct wsrep_init_args* args)
     trx_params_         (config_.get(BASE_DIR), -1,
                          KeySet::version(config_.get(Param::key_format)),
                          gu::from_string<int>(config_.get(
-                             Param::max_write_set_size))),
+                             Param::max_write_set_size)),
+                         config_.get<bool>(Param::strip_annotations)),
     uuid_               (WSREP_UUID_UNDEFINED),
     state_uuid_         (WSREP_UUID_UNDEFINED),
     state_uuid_str_     (),
@@ -168,13 +184,13 @@ galera::ReplicatorSMM::ReplicatorSMM(const struct wsrep_init_args* args)
     gcache_             (config_, config_.get(BASE_DIR)),
     gcs_                (config_, gcache_, proto_max_, args->proto_ver,
                          args->node_name, args->node_incoming),
-    service_thd_        (gcs_, gcache_),
+    service_thd_        (gcs_, gcache_, config_),
     slave_pool_         (sizeof(TrxHandle), 1024, "SlaveTrxHandle"),
     as_                 (0),
     gcs_as_             (slave_pool_, gcs_, *this, gcache_),
     ist_receiver_       (config_, slave_pool_, args->node_address),
     ist_prepared_       (false),
-    ist_senders_        (gcs_, gcache_),
+    ist_senders_        (gcs_, gcache_, &commit_latency_probe_),
     wsdb_               (),
     cert_               (config_, service_thd_, gcache_),
 #ifdef HAVE_PSI_INTERFACE
@@ -189,7 +205,13 @@ galera::ReplicatorSMM::ReplicatorSMM(const struct wsrep_init_args* args)
     apply_monitor_      (),
     commit_monitor_     (),
 #endif /* HAVE_PSI_INTERFACE */
+    commit_latency_probe_(commit_monitor_),
+    commit_retire_mutex_ (),
+    commit_retire_q_     (),
+    commit_retire_leader_(false),
     causal_read_timeout_(config_.get(Param::causal_read_timeout)),
+    applier_affinity_   (config_.is_set(Param::applier_affinity) ?
+                         config_.get(Param::applier_affinity) : ""),
     receivers_          (),
     replicated_         (),
     replicated_bytes_   (),
@@ -197,11 +219,16 @@ galera::ReplicatorSMM::ReplicatorSMM(const struct wsrep_init_args* args)
     keys_bytes_         (),
     data_bytes_         (),
     unrd_bytes_         (),
+    annt_stripped_bytes_(),
     local_commits_      (),
     local_rollbacks_    (),
     local_cert_failures_(),
     local_replays_      (),
     causal_reads_       (),
+    applied_            (),
+    applied_bytes_      (),
+    applied_keys_       (),
+    apply_cb_ns_        (),
     preordered_id_      (),
     incoming_list_      (""),
 #ifdef HAVE_PSI_INTERFACE
@@ -209,7 +236,11 @@ galera::ReplicatorSMM::ReplicatorSMM(const struct wsrep_init_args* args)
 #else
     incoming_mutex_     (),
 #endif /* HAVE_PSI_INTERFACE */
-    wsrep_stats_        ()
+    action_recorder_    (0),
+    slave_q_over_mark_  (false),
+    slave_q_mark_crossings_(0),
+    wsrep_stats_        (),
+    stats_vars_scratch_ ()
 {
     /*
       Register the application callback that should be called
@@ -220,6 +251,27 @@ galera::ReplicatorSMM::ReplicatorSMM(const struct wsrep_init_args* args)
         gu_abort_register_cb(abort_cb_);
     }
 
+    {
+        long long const spin_ns(gu::from_string<long long>(
+                                    config_.get(Param::monitor_spin_max)));
+        local_monitor_.set_max_spin_ns(spin_ns);
+        apply_monitor_.set_max_spin_ns(spin_ns);
+        commit_monitor_.set_max_spin_ns(spin_ns);
+    }
+
+    /* early warning before flow control: no-op unless
+     * gcs.recv_q_watermark is set */
+    gcs_.set_recv_q_watermark_cb (&slave_queue_watermark_cb, this);
+
+    if (config_.is_set(Param::action_log) &&
+        !config_.get(Param::action_log).empty())
+    {
+        std::string const path(config_.get(Param::action_log));
+        action_recorder_ = new ActionRecorder(path);
+        gcs_as_.set_recorder(action_recorder_);
+        log_info << "Recording delivered actions to '" << path << '\'';
+    }
+
     // @todo add guards (and perhaps actions)
     state_.add_transition(Transition(S_CLOSED,  S_DESTROYED));
     state_.add_transition(Transition(S_CLOSED,  S_CONNECTED));
@@ -313,6 +365,28 @@ galera::ReplicatorSMM::~ReplicatorSMM()
     case S_DESTROYED:
         break;
     }
+
+    delete action_recorder_;
+}
+
+
+void galera::ReplicatorSMM::slave_queue_watermark(long const q_len,
+                                                  long const mark,
+                                                  bool const over)
+{
+    slave_q_over_mark_ = over;
+
+    if (over)
+    {
+        ++slave_q_mark_crossings_;
+        log_warn << "Slave queue length " << q_len << " exceeded watermark "
+                 << mark << ", flow control is getting close. Consider "
+                 << "shedding load or postponing maintenance jobs.";
+    }
+    else
+    {
+        log_info << "Slave queue drained below watermark " << mark;
+    }
 }
 
 
@@ -397,6 +471,23 @@ wsrep_status_t galera::ReplicatorSMM::async_recv(void* recv_ctx)
     ++receivers_;
     as_ = &gcs_as_;
 
+    gu::thread_cpu_register("applier");
+
+    if (!applier_affinity_.empty())
+    {
+        try
+        {
+            gu::thread_set_affinity(pthread_self(), applier_affinity_);
+            log_info << "Applier thread bound to CPU(s) "
+                     << applier_affinity_;
+        }
+        catch (gu::Exception& e)
+        {
+            log_warn << "Failed to set applier thread affinity: "
+                     << e.what();
+        }
+    }
+
     bool exit_loop(false);
     wsrep_status_t retval(WSREP_OK);
 
@@ -459,6 +550,8 @@ wsrep_status_t galera::ReplicatorSMM::async_recv(void* recv_ctx)
         state_.shift_to(S_CLOSED);
     }
 
+    gu::thread_cpu_unregister();
+
     log_debug << "Slave thread exit. Return code: " << retval;
 
     return retval;
@@ -473,10 +566,19 @@ void galera::ReplicatorSMM::apply_trx(void* recv_ctx, TrxHandle* trx)
     assert(trx->global_seqno() > STATE_SEQNO());
     assert(trx->is_local() == false);
 
+    // let background maintenance know there is apply work going on
+    gu::MaintenanceGauge::process().touch();
+
     ApplyOrder ao(*trx);
     CommitOrder co(*trx, co_mode_);
 
+    /* warm up the payload before taking the order slot: the header and
+     * the keyset are already parsed by this point, the data segments are
+     * first read by the apply callback inside the ordered section */
+    trx->preload_data();
+
     gu_trace(apply_monitor_.enter(ao));
+    GU_PROBE1(apply_enter, trx->global_seqno());
     trx->set_state(TrxHandle::S_APPLYING);
 
     wsrep_trx_meta_t meta = {{state_uuid_, trx->global_seqno() },
@@ -488,10 +590,29 @@ void galera::ReplicatorSMM::apply_trx(void* recv_ctx, TrxHandle* trx)
         st_.mark_unsafe();
     }
 
+    long long const apply_start(gu_time_monotonic());
+
     gu_trace(apply_trx_ws(recv_ctx, apply_cb_, commit_cb_, *trx, meta));
     /* at this point any exception in apply_trx_ws() is fatal, not
      * catching anything. */
 
+    /* cost model sampling: relate apply callback time to writeset
+     * features. There is no admission decision to feed this into - a
+     * delivered writeset already owns an applier thread and the monitor
+     * admits it the moment its dependencies have left, so within the
+     * dependency constraints nothing can be moved earlier. The derived
+     * ns/byte and ns/key figures in the status output serve capacity
+     * planning instead: they show when large batch writesets start to
+     * dominate applier time. */
+    apply_cb_ns_   += gu_time_monotonic() - apply_start;
+    trx->lat_stamp(TrxHandle::LAT_APPLIED);
+    ++applied_;
+    applied_bytes_ += static_cast<long long>(trx->size());
+    if (trx->new_version())
+    {
+        applied_keys_ += trx->write_set_in().keyset().count();
+    }
+
     TrxHandle* commit_trx_handle = trx;
     if (gu_likely(co_mode_ != CommitOrder::BYPASS) && trx->is_toi())
     {
@@ -519,11 +640,14 @@ void galera::ReplicatorSMM::apply_trx(void* recv_ctx, TrxHandle* trx)
     if (gu_likely(co_mode_ != CommitOrder::BYPASS) && trx->is_toi())
     {
         gu_trace(commit_monitor_.leave(co));
+        GU_PROBE1(commit_leave, trx->global_seqno());
 
         // Allow tests to block the applier thread using the DBUG facilities
         GU_DBUG_SYNC_WAIT("sync.apply_trx.after_commit_leave");
     }
     trx->set_state(TrxHandle::S_COMMITTED);
+    trx->lat_stamp(TrxHandle::LAT_COMMITTED);
+    account_latency(trx);
 
     if (trx->local_seqno() != -1)
     {
@@ -538,6 +662,7 @@ void galera::ReplicatorSMM::apply_trx(void* recv_ctx, TrxHandle* trx)
     trx->unordered(recv_ctx, unordered_cb_);
 
     apply_monitor_.leave(ao);
+    GU_PROBE1(apply_leave, trx->global_seqno());
 
     if (trx->is_toi())
     {
@@ -560,6 +685,10 @@ wsrep_status_t galera::ReplicatorSMM::replicate(TrxHandle* trx,
     assert(trx->local_seqno() == WSREP_SEQNO_UNDEFINED &&
            trx->global_seqno() == WSREP_SEQNO_UNDEFINED);
 
+    GU_PROBE1(replicate_start, trx->trx_id());
+
+    trx->lat_stamp(TrxHandle::LAT_REPLICATE);
+
     wsrep_status_t retval(WSREP_TRX_FAIL);
 
     if (trx->state() == TrxHandle::S_MUST_ABORT)
@@ -569,6 +698,24 @@ wsrep_status_t galera::ReplicatorSMM::replicate(TrxHandle* trx,
         return retval;
     }
 
+    /* NOTE: for v3 writesets this path is already single-copy: gather()
+     * only collects pointers to the RecordSet pages the writeset was
+     * serialized into, and gcs_replv() performs the one gather-copy into
+     * the gcache buffer that then serves as the action buffer for local
+     * processing. Serializing straight into gcache (zero-copy) doesn't
+     * work with the ring-buffer design: the final size is unknown until
+     * the writeset is complete, and a long-running transaction would pin
+     * a hole in the cache for its whole lifetime. */
+
+    /* Coalescing writesets from concurrent committers into one gcs
+     * action was considered here and does not fit: an action maps 1:1
+     * to a global seqno, which is the unit of certification, apply and
+     * commit ordering all the way up to the wsrep API, so sub-ordering
+     * several writesets within one action is a replication protocol
+     * change. Batching already happens below, where it is free of such
+     * constraints: gcomm packs pending small messages into one datagram
+     * per MTU (evs.use_aggregate, effectiveness visible in the
+     * evs_aggregated_user status counter). */
     WriteSetNG::GatherVector actv;
 
     gcs_action act;
@@ -602,6 +749,8 @@ wsrep_status_t galera::ReplicatorSMM::replicate(TrxHandle* trx,
 
     trx->set_state(TrxHandle::S_REPLICATING);
 
+    GU_PROBE2(gcs_send, trx->trx_id(), act.size);
+
     ssize_t rcode(-1);
 
     do
@@ -672,16 +821,23 @@ wsrep_status_t galera::ReplicatorSMM::replicate(TrxHandle* trx,
     ++replicated_;
     replicated_bytes_ += rcode;
     trx->set_gcs_handle(-1);
+    trx->lat_stamp(TrxHandle::LAT_ORDERED);
+
+    // let background maintenance know the send path is busy
+    gu::MaintenanceGauge::process().touch();
 
     if (trx->new_version())
     {
         gu_trace(trx->unserialize(static_cast<const gu::byte_t*>(act.buf),
                                   act.size, 0));
         trx->update_stats(keys_count_, keys_bytes_, data_bytes_, unrd_bytes_);
+        annt_stripped_bytes_ += trx->write_set_out().annt_stripped();
     }
 
     trx->set_received(act.buf, act.seqno_l, act.seqno_g);
 
+    GU_PROBE3(replicated, trx->trx_id(), act.seqno_g, act.seqno_l);
+
     if (trx->state() == TrxHandle::S_MUST_ABORT)
     {
         retval = cert_for_aborted(trx);
@@ -1039,10 +1195,12 @@ wsrep_status_t galera::ReplicatorSMM::interim_commit(TrxHandle* trx)
     if (co_mode_ != CommitOrder::BYPASS)
     {
         commit_monitor_.leave(co);
+        GU_PROBE1(commit_leave, trx->global_seqno());
 
         // Allow tests to block the applier thread using the DBUG facilities
         GU_DBUG_SYNC_WAIT("sync.interim_commit.after_commit_leave");
     }
+    trx->lat_stamp(TrxHandle::LAT_COMMITTED);
     trx->mark_interim_committed(true);
 
     return WSREP_OK;
@@ -1067,10 +1225,64 @@ wsrep_status_t galera::ReplicatorSMM::post_commit(TrxHandle* trx)
            trx->state() == TrxHandle::S_REPLAYING);
     assert(trx->local_seqno() > -1 && trx->global_seqno() > -1);
 
+    /* Group retire: if another committer is already in a retire pass,
+     * hand the trx over and return - the leader retires the whole run
+     * of finished trxs in one go instead of every committer cycling
+     * through the monitor and certification mutexes on its own. The
+     * monitors accept leaves for any finished seqno from any thread,
+     * and set_trx_committed() handles retirement in any order. */
+    {
+        gu::Lock lock(commit_retire_mutex_);
+
+        if (commit_retire_leader_)
+        {
+            trx->ref(); // keep alive until the leader is done with it
+            commit_retire_q_.push_back(trx);
+            return WSREP_OK;
+        }
+
+        commit_retire_leader_ = true;
+    }
+
+    retire_commit_tail(trx);
+
+    while (true)
+    {
+        std::vector<TrxHandle*> batch;
+
+        {
+            gu::Lock lock(commit_retire_mutex_);
+
+            if (commit_retire_q_.empty())
+            {
+                commit_retire_leader_ = false;
+                break;
+            }
+
+            batch.swap(commit_retire_q_);
+        }
+
+        for (size_t i(0); i < batch.size(); ++i)
+        {
+            retire_commit_tail(batch[i]);
+            batch[i]->unref();
+        }
+    }
+
+    return WSREP_OK;
+}
+
+void galera::ReplicatorSMM::retire_commit_tail(TrxHandle* trx)
+{
     if (!(trx->is_interim_committed()))
     {
         CommitOrder co(*trx, co_mode_);
-        if (co_mode_ != CommitOrder::BYPASS) commit_monitor_.leave(co);
+        if (co_mode_ != CommitOrder::BYPASS)
+        {
+            commit_monitor_.leave(co);
+            GU_PROBE1(commit_leave, trx->global_seqno());
+        }
+        trx->lat_stamp(TrxHandle::LAT_COMMITTED);
 
         // Allow tests to block the applier thread using the DBUG facilities
         GU_DBUG_SYNC_WAIT("sync.post_commit.after_commit_leave");
@@ -1083,9 +1295,52 @@ wsrep_status_t galera::ReplicatorSMM::post_commit(TrxHandle* trx)
 
     trx->set_state(TrxHandle::S_COMMITTED);
 
+    account_latency(trx);
+
     ++local_commits_;
+}
 
-    return WSREP_OK;
+const char* const
+galera::ReplicatorSMM::lat_stage_names_[LAT_STAGE_MAX] =
+{
+    "order", "cert", "apply", "commit"
+};
+
+void galera::ReplicatorSMM::account_latency(const TrxHandle* trx)
+{
+    long long stage_ns[LAT_STAGE_MAX];
+
+    long long const repl(trx->lat_tstamp(TrxHandle::LAT_REPLICATE));
+    long long const ord (trx->lat_tstamp(TrxHandle::LAT_ORDERED));
+    long long const cert(trx->lat_tstamp(TrxHandle::LAT_CERTIFIED));
+    long long const appl(trx->lat_tstamp(TrxHandle::LAT_APPLIED));
+    long long const comm(trx->lat_tstamp(TrxHandle::LAT_COMMITTED));
+
+    /* a stage is defined only if the trx crossed both of its boundaries
+     * in this process: slave trxs have no order stage, local trxs no
+     * provider-side apply (the application applies them), so for local
+     * trxs the commit stage starts at the certification decision and
+     * covers transaction execution as seen from here */
+    stage_ns[LAT_STAGE_ORDER] = (repl > 0 && ord  >= repl ? ord  - repl : -1);
+    stage_ns[LAT_STAGE_CERT]  = (ord  > 0 && cert >= ord  ? cert - ord  : -1);
+    stage_ns[LAT_STAGE_APPLY] = (cert > 0 && appl >= cert ? appl - cert : -1);
+
+    long long const pre_commit(appl > 0 ? appl : cert);
+    stage_ns[LAT_STAGE_COMMIT] =
+        (pre_commit > 0 && comm >= pre_commit ? comm - pre_commit : -1);
+
+    int slowest(-1);
+
+    for (int i(0); i < LAT_STAGE_MAX; ++i)
+    {
+        if (stage_ns[i] < 0) continue;
+
+        lat_stage_hist_[i].record(stage_ns[i]);
+
+        if (slowest < 0 || stage_ns[i] > stage_ns[slowest]) slowest = i;
+    }
+
+    if (slowest >= 0) lat_slowest_[slowest] += 1;
 }
 
 
@@ -1112,13 +1367,30 @@ wsrep_status_t galera::ReplicatorSMM::post_rollback(TrxHandle* trx)
 
 wsrep_status_t galera::ReplicatorSMM::causal_read(wsrep_gtid_t* gtid)
 {
-    wsrep_seqno_t cseq(static_cast<wsrep_seqno_t>(gcs_.caused()));
+    wsrep_seqno_t cseq;
 
-    if (cseq < 0)
+    /* Read-your-writes shortcut: a caller that only needs to observe
+     * its own last write may initialize *gtid to the token previously
+     * returned in wsrep_trx_meta_t for that write. Such a session-level
+     * guarantee is answered by local commit monitor state alone -
+     * waiting for the token seqno to commit - with no group round trip.
+     * Callers after the full causal cut pass an undefined or foreign
+     * GTID (the historical calling convention) and take the gcs_caused()
+     * path below as before. */
+    if (gtid != 0 && gtid->seqno >= 0 && gtid->uuid == state_uuid_)
     {
-        log_warn << "gcs_caused() returned " << cseq << " (" << strerror(-cseq)
-                 << ')';
-        return WSREP_TRX_FAIL;
+        cseq = gtid->seqno;
+    }
+    else
+    {
+        cseq = static_cast<wsrep_seqno_t>(gcs_.caused());
+
+        if (cseq < 0)
+        {
+            log_warn << "gcs_caused() returned " << cseq
+                     << " (" << strerror(-cseq) << ')';
+            return WSREP_TRX_FAIL;
+        }
     }
 
     try
@@ -1390,6 +1662,10 @@ void galera::ReplicatorSMM::process_trx(void* recv_ctx, TrxHandle* trx)
     assert(trx->depends_seqno() == -1);
     assert(trx->state() == TrxHandle::S_REPLICATING);
 
+    GU_PROBE2(delivered, trx->global_seqno(), trx->local_seqno());
+
+    trx->lat_stamp(TrxHandle::LAT_ORDERED); // delivery is where we first see it
+
     // If the SST has been canceled, then ignore any other
     // incoming transactions, as the node should be shutting down
     if (sst_state_ == SST_CANCELED)
@@ -1569,9 +1845,14 @@ galera::ReplicatorSMM::process_conf_change(void*                    recv_ctx,
         safe_to_bootstrap_ = (view_info.memb_num == 1);
     }
 
-    apply_monitor_.drain(upto);
+    // Freeze admission above the watermark in both monitors first,
+    // then wait: in-flight work below the watermark in the two
+    // monitors finishes concurrently instead of back to back.
+    apply_monitor_.drain_begin(upto);
+    if (co_mode_ != CommitOrder::BYPASS) commit_monitor_.drain_begin(upto);
 
-    if (co_mode_ != CommitOrder::BYPASS) commit_monitor_.drain(upto);
+    apply_monitor_.drain_end();
+    if (co_mode_ != CommitOrder::BYPASS) commit_monitor_.drain_end();
 
     if (view_info.my_idx >= 0)
     {
@@ -1761,9 +2042,11 @@ void galera::ReplicatorSMM::process_join(wsrep_seqno_t seqno_j,
 
     wsrep_seqno_t const upto(cert_.position());
 
-    apply_monitor_.drain(upto);
+    apply_monitor_.drain_begin(upto);
+    if (co_mode_ != CommitOrder::BYPASS) commit_monitor_.drain_begin(upto);
 
-    if (co_mode_ != CommitOrder::BYPASS) commit_monitor_.drain(upto);
+    apply_monitor_.drain_end();
+    if (co_mode_ != CommitOrder::BYPASS) commit_monitor_.drain_end();
 
     if (seqno_j < 0 && S_JOINING == state_())
     {
@@ -1789,9 +2072,11 @@ void galera::ReplicatorSMM::process_sync(wsrep_seqno_t seqno_l)
 
     wsrep_seqno_t const upto(cert_.position());
 
-    apply_monitor_.drain(upto);
+    apply_monitor_.drain_begin(upto);
+    if (co_mode_ != CommitOrder::BYPASS) commit_monitor_.drain_begin(upto);
 
-    if (co_mode_ != CommitOrder::BYPASS) commit_monitor_.drain(upto);
+    apply_monitor_.drain_end();
+    if (co_mode_ != CommitOrder::BYPASS) commit_monitor_.drain_end();
 
     state_.shift_to(S_SYNCED);
     synced_cb_(app_ctx_);
@@ -1813,12 +2098,15 @@ wsrep_seqno_t galera::ReplicatorSMM::pause()
 
     // Get drain seqno from cert index
     wsrep_seqno_t const upto(cert_.position());
-    apply_monitor_.drain(upto);
+    apply_monitor_.drain_begin(upto);
+    if (co_mode_ != CommitOrder::BYPASS) commit_monitor_.drain_begin(upto);
+
+    apply_monitor_.drain_end();
     assert (apply_monitor_.last_left() >= upto);
 
     if (co_mode_ != CommitOrder::BYPASS)
     {
-        commit_monitor_.drain(upto);
+        commit_monitor_.drain_end();
         assert (commit_monitor_.last_left() >= upto);
         assert (commit_monitor_.last_left() == apply_monitor_.last_left());
     }
@@ -2039,6 +2327,8 @@ wsrep_status_t galera::ReplicatorSMM::cert(TrxHandle* trx)
         if (co_mode_ != CommitOrder::BYPASS) commit_monitor_.self_cancel(co);
     }
 
+    GU_PROBE3(cert_done, trx->global_seqno(), trx->depends_seqno(), retval);
+
     return retval;
 }
 
@@ -2047,7 +2337,9 @@ wsrep_status_t galera::ReplicatorSMM::cert_and_catch(TrxHandle* trx)
 {
     try
     {
-        return cert(trx);
+        wsrep_status_t const retval(cert(trx));
+        trx->lat_stamp(TrxHandle::LAT_CERTIFIED);
+        return retval;
     }
     catch (std::exception& e)
     {
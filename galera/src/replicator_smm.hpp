@@ -25,6 +25,7 @@
 #include "gcs_action_source.hpp"
 #include "ist.hpp"
 #include "gu_atomic.hpp"
+#include "gu_thread.hpp"
 #include "saved_state.hpp"
 #include "gu_debug_sync.hpp"
 
@@ -167,6 +168,11 @@ namespace galera
         void process_join(wsrep_seqno_t seqno, wsrep_seqno_t seqno_l);
         void process_sync(wsrep_seqno_t seqno_l);
 
+        /* handler behind the gcs slave queue watermark callback: logs
+         * the crossing (reaching the server through the logger hook)
+         * and keeps the state for the status output */
+        void slave_queue_watermark(long q_len, long mark, bool over);
+
         const struct wsrep_stats_var* stats_get();
         void                          stats_reset();
         void                   stats_free(struct wsrep_stats_var*);
@@ -210,6 +216,10 @@ namespace galera
             static const std::string commit_order;
             static const std::string causal_read_timeout;
             static const std::string max_write_set_size;
+            static const std::string applier_affinity;
+            static const std::string monitor_spin_max;
+            static const std::string action_log;
+            static const std::string strip_annotations;
         };
 
         typedef std::pair<std::string, std::string> Default;
@@ -241,6 +251,27 @@ namespace galera
         wsrep_status_t cert_and_catch(TrxHandle* trx);
         wsrep_status_t cert_for_aborted(TrxHandle* trx);
 
+        /* monitor leaves and last-committed reporting for one finished
+         * trx, the per-trx unit of the batched post_commit() tail */
+        void retire_commit_tail(TrxHandle* trx);
+
+        /* latency budget stages derived from the TrxHandle stamps,
+         * see account_latency() */
+        enum LatStage
+        {
+            LAT_STAGE_ORDER,  /* replicate entry -> total order assigned */
+            LAT_STAGE_CERT,   /* total order -> certification decision   */
+            LAT_STAGE_APPLY,  /* certification -> apply callback done    */
+            LAT_STAGE_COMMIT, /* apply (or cert) -> commit order left    */
+            LAT_STAGE_MAX
+        };
+
+        static const char* const lat_stage_names_[LAT_STAGE_MAX];
+
+        /* fold the trx timing record into the per-stage histograms and
+         * the slowest-stage counters; called when the trx retires */
+        void account_latency(const TrxHandle* trx);
+
         void update_state_uuid (const wsrep_uuid_t& u,
                                 const wsrep_seqno_t seqno);
         void update_incoming_list (const wsrep_view_info_t& v);
@@ -269,8 +300,10 @@ namespace galera
 
             wsrep_seqno_t seqno() const { return seqno_; }
 
+            template <class MON>
             bool condition(wsrep_seqno_t last_entered,
-                           wsrep_seqno_t last_left) const
+                           wsrep_seqno_t last_left,
+                           const MON&    mon) const
             {
                 return (last_left + 1 == seqno_);
             }
@@ -309,11 +342,35 @@ namespace galera
 
             wsrep_seqno_t seqno() const { return trx_.global_seqno(); }
 
+            template <class MON>
             bool condition(wsrep_seqno_t last_entered,
-                           wsrep_seqno_t last_left) const
+                           wsrep_seqno_t last_left,
+                           const MON&    mon) const
             {
-                return (trx_.is_local() == true ||
-                        last_left >= trx_.depends_seqno());
+                if (trx_.is_local() == true ||
+                    last_left >= trx_.depends_seqno())
+                {
+                    return true;
+                }
+
+                /* depends_seqno() is only the highest dependency; when
+                 * certification recorded the exact set, enter as soon as
+                 * each recorded dependency has left the monitor, even if
+                 * unrelated writesets below depends_seqno() are still
+                 * applying (see TrxHandle::reset_dep_seqnos()). */
+                if (trx_.deps_exact() == true && last_left >= trx_.dep_base())
+                {
+                    for (int i(0); i < trx_.n_dep_seqnos(); ++i)
+                    {
+                        if (mon.finished(trx_.dep_seqno(i)) == false)
+                        {
+                            return false;
+                        }
+                    }
+                    return true;
+                }
+
+                return false;
             }
 
 #ifdef GU_DBUG_ON
@@ -349,6 +406,16 @@ namespace galera
 
     public:
 
+        /* Group commit: the one-by-one ordering here applies to monitor
+         * *entry* only, which is what establishes commit order and cannot
+         * be batched. On the release side Monitor::post_leave() already
+         * retires whole contiguous ranges of finished seqnos in one pass,
+         * so consecutive committers are woken back-to-back without extra
+         * round trips through the monitor. A leader-claims-range API would
+         * additionally need a wsrep call for the server to hand back a
+         * seqno range per fsync, which this wsrep API revision does not
+         * have; until then the server-side binlog group commit driving
+         * commits through OOOC/LOCAL_OOOC modes is the supported path. */
         class CommitOrder
         {
         public:
@@ -386,8 +453,10 @@ namespace galera
             void lock()   { trx_.lock();   }
             void unlock() { trx_.unlock(); }
             wsrep_seqno_t seqno() const { return trx_.global_seqno(); }
+            template <class MON>
             bool condition(wsrep_seqno_t last_entered,
-                           wsrep_seqno_t last_left) const
+                           wsrep_seqno_t last_left,
+                           const MON&    mon) const
             {
                 switch (mode_)
                 {
@@ -646,21 +715,68 @@ namespace galera
         Monitor<LocalOrder>  local_monitor_;
         Monitor<ApplyOrder>  apply_monitor_;
         Monitor<CommitOrder> commit_monitor_;
+
+        /* adapter handing the commit monitor latency signal to the IST
+         * sender throttle, see ist::CommitLatencySource */
+        class CommitLatencyProbe : public ist::CommitLatencySource
+        {
+        public:
+            CommitLatencyProbe(const Monitor<CommitOrder>& mon) : mon_(mon) {}
+            long long commit_latency_ns() const { return mon_.avg_wait_ns(); }
+        private:
+            const Monitor<CommitOrder>& mon_;
+        };
+
+        CommitLatencyProbe commit_latency_probe_;
+
+        /* group retire of the post_commit() tail: while one committer
+         * (the leader) is in a retire pass, others queue their finished
+         * trxs and return, and the leader retires the whole run.
+         * See post_commit(). */
+        gu::Mutex               commit_retire_mutex_;
+        std::vector<TrxHandle*> commit_retire_q_;
+        bool                    commit_retire_leader_;
         gu::datetime::Period causal_read_timeout_;
 
-        // counters
-        gu::Atomic<size_t>    receivers_;
-        gu::Atomic<long long> replicated_;
-        gu::Atomic<long long> replicated_bytes_;
-        gu::Atomic<long long> keys_count_;
-        gu::Atomic<long long> keys_bytes_;
-        gu::Atomic<long long> data_bytes_;
-        gu::Atomic<long long> unrd_bytes_;
-        gu::Atomic<long long> local_commits_;
-        gu::Atomic<long long> local_rollbacks_;
-        gu::Atomic<long long> local_cert_failures_;
-        gu::Atomic<long long> local_replays_;
-        gu::Atomic<long long> causal_reads_;
+        // CPU set applier threads are bound to on startup; with
+        // first-touch allocation this also keeps the memory they
+        // fault in local to the same NUMA node. Empty means no binding.
+        gu::ThreadAffinity applier_affinity_;
+
+        // counters; receivers_ synchronizes and stays fully fenced,
+        // the replicate-path counters are sharded to keep concurrent
+        // client threads off a shared cache line, the rest are plain
+        // relaxed statistics
+        gu::Atomic<size_t>            receivers_;
+        gu::ShardedCounter<long long> replicated_;
+        gu::ShardedCounter<long long> replicated_bytes_;
+        gu::ShardedCounter<long long> keys_count_;
+        gu::ShardedCounter<long long> keys_bytes_;
+        gu::ShardedCounter<long long> data_bytes_;
+        gu::ShardedCounter<long long> unrd_bytes_;
+        gu::ShardedCounter<long long> annt_stripped_bytes_;
+        gu::StatCounter<long long>    local_commits_;
+        gu::StatCounter<long long>    local_rollbacks_;
+        gu::StatCounter<long long>    local_cert_failures_;
+        gu::StatCounter<long long>    local_replays_;
+        gu::StatCounter<long long>    causal_reads_;
+
+        // apply cost model inputs: wall time spent in the apply
+        // callback and the size/key features of the writesets it was
+        // fed; sharded since all appliers update them concurrently.
+        // The derived ns/byte and ns/key figures are exported in the
+        // status output, see stats_get().
+        gu::ShardedCounter<long long> applied_;
+        gu::ShardedCounter<long long> applied_bytes_;
+        gu::ShardedCounter<long long> applied_keys_;
+        gu::ShardedCounter<long long> apply_cb_ns_;
+
+        // latency budget accounting: stage duration distributions over
+        // retired trxs and, per trx, which stage took the longest - the
+        // provider-side answer to "where does p999 commit latency go".
+        // Recording is lock-free, see gu::HdrHistogram.
+        gu::HdrHistogram              lat_stage_hist_[LAT_STAGE_MAX];
+        gu::ShardedCounter<long long> lat_slowest_[LAT_STAGE_MAX];
 
         gu::Atomic<long long> preordered_id_; // temporary preordered ID
 
@@ -672,11 +788,31 @@ namespace galera
         mutable gu::Mutex     incoming_mutex_;
 #endif /* HAVE_PSI_INTERFACE */
 
+        // delivered action log for offline replay, see
+        // action_recorder.hpp; NULL unless repl.action_log is set
+        ActionRecorder*       action_recorder_;
+
+        // slave queue watermark state: written by the edge-triggered
+        // gcs callback (serialized by the recv queue lock), read by
+        // the stats scrape as a plain relaxed statistic
+        bool                  slave_q_over_mark_;
+        long long             slave_q_mark_crossings_;
+
         mutable std::vector<struct wsrep_stats_var> wsrep_stats_;
 
+        /* scratch for stats_get(), reused between scrapes so that the
+         * steady state snapshot does not allocate */
+        std::vector<struct wsrep_stats_var> stats_vars_scratch_;
+
         // Storage space for dynamic status strings
         char                  interval_string_[64];
         char                  ist_status_string_[128];
+        char                  apply_latency_string_[128];
+        char                  commit_latency_string_[128];
+        char                  cert_deps_hist_string_[128];
+        char                  cert_conflicts_string_[160];
+        char                  lat_stages_string_[320];
+        char                  lat_slowest_string_[128];
     };
 
     std::ostream& operator<<(std::ostream& os, ReplicatorSMM::State state);
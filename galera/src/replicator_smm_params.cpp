@@ -24,6 +24,14 @@ const std::string galera::ReplicatorSMM::Param::key_format =
     common_prefix + "key_format";
 const std::string galera::ReplicatorSMM::Param::max_write_set_size =
     common_prefix + "max_ws_size";
+const std::string galera::ReplicatorSMM::Param::applier_affinity =
+    common_prefix + "applier_affinity";
+const std::string galera::ReplicatorSMM::Param::monitor_spin_max =
+    common_prefix + "monitor_spin_max";
+const std::string galera::ReplicatorSMM::Param::action_log =
+    common_prefix + "action_log";
+const std::string galera::ReplicatorSMM::Param::strip_annotations =
+    common_prefix + "strip_annotations";
 
 int const galera::ReplicatorSMM::MAX_PROTO_VER(7);
 
@@ -38,6 +46,10 @@ galera::ReplicatorSMM::Defaults::Defaults() : map_()
     const int max_write_set_size(galera::WriteSetNG::MAX_SIZE);
     map_.insert(Default(Param::max_write_set_size,
                         gu::to_string(max_write_set_size)));
+    map_.insert(Default(Param::applier_affinity, ""));
+    map_.insert(Default(Param::monitor_spin_max, "16384")); // ~16us
+    map_.insert(Default(Param::action_log, ""));
+    map_.insert(Default(Param::strip_annotations, "no"));
 }
 
 const galera::ReplicatorSMM::Defaults galera::ReplicatorSMM::defaults;
@@ -116,6 +128,7 @@ galera::ReplicatorSMM::InitConfig::InitConfig(gu::Config&       conf,
         gu_throw_fatal << "Error initializing GCS parameters";
     }
     Certification::register_params(conf);
+    ServiceThd::register_params(conf);
     ist::register_params(conf);
 }
 
@@ -129,6 +142,46 @@ galera::ReplicatorSMM::ParseOptions::ParseOptions(Replicator&       repl,
     }
     catch (gu::NotFound) {}
 
+    /* A profile is a named preset layered on top of the defaults before
+     * the components read their configuration. It only touches keys the
+     * user did not set explicitly, so individual overrides always win. */
+    if (conf.is_set(Replicator::Param::profile))
+    {
+        std::string const profile(conf.get(Replicator::Param::profile));
+
+        if (profile == "latency")
+        {
+            /* Trade throughput for tail latency: no message batching in
+             * the group layer, flow control kicks in while the slave
+             * queue is still short, and a raised monitor spin budget
+             * lets appliers poll past short waits instead of parking.
+             * The gcomm and gcs keys are spelled out - this module does
+             * not include headers from those layers. */
+            static const char* const preset[][2] =
+            {
+                { "evs.use_aggregate",     "false"  },
+                { "gcs.fc_limit",          "16"     },
+                { "gcs.fc_factor",         "0.5"    },
+                { "repl.monitor_spin_max", "131072" }, // ~128us
+                { 0, 0 }
+            };
+
+            for (int i(0); preset[i][0] != 0; ++i)
+            {
+                if (!conf.is_set(preset[i][0]))
+                {
+                    conf.set(preset[i][0], preset[i][1]);
+                    log_info << "profile '" << profile << "': "
+                             << preset[i][0] << " = " << preset[i][1];
+                }
+            }
+        }
+        else if (!profile.empty())
+        {
+            gu_throw_error(EINVAL) << "unknown profile '" << profile << '\'';
+        }
+    }
+
     if (conf.get<bool>(Replicator::Param::debug_log))
     {
         gu_conf_debug_on();
@@ -173,7 +226,8 @@ galera::ReplicatorSMM::set_param (const std::string& key,
     else if (key == Param::base_host ||
              key == Param::base_port ||
              key == Param::base_dir ||
-             key == Param::proto_max)
+             key == Param::proto_max ||
+             key == Param::action_log)
     {
         // nothing to do here, these params take effect only at
         // provider (re)start
@@ -186,6 +240,24 @@ galera::ReplicatorSMM::set_param (const std::string& key,
     {
         trx_params_.max_write_set_size_ = gu::from_string<int>(value);
     }
+    else if (key == Param::strip_annotations)
+    {
+        // takes effect for writesets created after the change
+        trx_params_.strip_annotations_ = gu::from_string<bool>(value);
+    }
+    else if (key == Param::applier_affinity)
+    {
+        // takes effect for applier threads started after the change,
+        // already running ones keep their binding
+        applier_affinity_ = gu::ThreadAffinity(value);
+    }
+    else if (key == Param::monitor_spin_max)
+    {
+        long long const ns(gu::from_string<long long>(value));
+        local_monitor_.set_max_spin_ns(ns);
+        apply_monitor_.set_max_spin_ns(ns);
+        commit_monitor_.set_max_spin_ns(ns);
+    }
     else
     {
         log_warn << "parameter '" << key << "' not found";
@@ -204,6 +276,13 @@ galera::ReplicatorSMM::param_set (const std::string& key,
     }
     catch (gu::NotSet&) {}
 
+    if (key == Replicator::Param::profile)
+    {
+        log_error << "setting '" << key << "' during runtime not allowed";
+        gu_throw_error(EPERM)
+            << "setting '" << key << "' during runtime not allowed";
+    }
+
     bool found(false);
 
     // Note: base_host is treated separately here as it cannot have
@@ -221,6 +300,16 @@ galera::ReplicatorSMM::param_set (const std::string& key,
         cert_.set_log_conflicts(value);
         return;
     }
+    else if (key == Certification::PARAM_MAX_INDEX_BYTES)
+    {
+        cert_.set_max_index_bytes(value);
+        return;
+    }
+    else if (key == ServiceThd::PARAM_REPORT_INTERVAL)
+    {
+        service_thd_.report_interval(value);
+        return;
+    }
     // this key might be for another module
     else if (0 != key.find(common_prefix))
     {
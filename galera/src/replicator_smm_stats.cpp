@@ -4,6 +4,8 @@
 #include "uuid.hpp"
 #include <gu_debug_sync.hpp>
 #include <gu_mem.h>
+#include <gu_string.hpp>
+#include <gu_thread.hpp>
 
 // @todo: should be protected static member of the parent class
 static const size_t GALERA_STAGE_MAX(11);
@@ -84,6 +86,7 @@ typedef enum status_vars
     STATS_KEYS_BYTES,
     STATS_DATA_BYTES,
     STATS_UNRD_BYTES,
+    STATS_ANNT_STRIPPED_BYTES,
     STATS_RECEIVED,
     STATS_RECEIVED_BYTES,
     STATS_LOCAL_COMMITS,
@@ -93,6 +96,9 @@ typedef enum status_vars
     STATS_LOCAL_SEND_QUEUE_MAX,
     STATS_LOCAL_SEND_QUEUE_MIN,
     STATS_LOCAL_SEND_QUEUE_AVG,
+    STATS_LOCAL_SEND_QUEUE_WAIT_P99,
+    STATS_LOCAL_SEND_QUEUE_WAIT_P999,
+    STATS_LOCAL_SEND_QUEUE_ENTERED,
     STATS_LOCAL_RECV_QUEUE,
     STATS_LOCAL_RECV_QUEUE_MAX,
     STATS_LOCAL_RECV_QUEUE_MIN,
@@ -100,6 +106,7 @@ typedef enum status_vars
     STATS_LOCAL_CACHED_DOWNTO,
     STATS_FC_PAUSED_NS,
     STATS_FC_PAUSED_AVG,
+    STATS_FC_PAUSES,
     STATS_FC_SSENT,
 //    STATS_FC_CSENT,
     STATS_FC_RECEIVED,
@@ -107,6 +114,8 @@ typedef enum status_vars
     STATS_FC_INTERVAL_LOW,
     STATS_FC_INTERVAL_HIGH,
     STATS_FC_STATUS,
+    STATS_RECV_Q_MARK_STATUS,
+    STATS_RECV_Q_MARK_CROSSINGS,
     STATS_CERT_DEPS_DISTANCE,
     STATS_APPLY_OOOE,
     STATS_APPLY_OOOL,
@@ -114,17 +123,53 @@ typedef enum status_vars
     STATS_COMMIT_OOOE,
     STATS_COMMIT_OOOL,
     STATS_COMMIT_WINDOW,
+    STATS_APPLY_WAITS,
+    STATS_COMMIT_WAITS,
+    STATS_LAT_STAGES,
+    STATS_LAT_SLOWEST,
+    STATS_APPLY_WAITERS,
+    STATS_APPLY_ACTIVE,
+    STATS_APPLY_BUSY_NS,
+    STATS_APPLY_WAIT_NS,
+    STATS_APPLIED,
+    STATS_APPLIED_BYTES,
+    STATS_APPLIED_KEYS,
+    STATS_APPLY_CB_NS,
+    STATS_APPLY_COST_NS_PER_BYTE,
+    STATS_APPLY_COST_NS_PER_KEY,
+    STATS_COMMIT_WAITERS,
+    STATS_COMMIT_ACTIVE,
+    STATS_COMMIT_BUSY_NS,
+    STATS_COMMIT_WAIT_NS,
     STATS_LOCAL_STATE,
     STATS_LOCAL_STATE_COMMENT,
     STATS_CERT_INDEX_SIZE,
     STATS_CERT_BUCKET_COUNT,
+    STATS_CERT_DEPS_DISTANCE_HIST,
+    STATS_CERT_CONFLICT_DIGESTS,
+    STATS_CERT_INDEX_MAX_CHAIN,
+    STATS_CERT_INDEX_AVG_CHAIN,
+    STATS_CERT_INDEX_BYTES,
+    STATS_CERT_FILTER_PROBES,
+    STATS_CERT_FILTER_NEGATIVES,
     STATS_GCACHE_POOL_SIZE,
+    STATS_GCACHE_MEM_USED,
+    STATS_GCACHE_RB_USED,
+    STATS_GCACHE_RB_SIZE,
+    STATS_GCACHE_PAGE_STORE_SIZE,
+    STATS_GCACHE_RB_OVERFLOWS,
+    STATS_GCACHE_DISCARDS,
+    STATS_GCACHE_SEQNO_WINDOW,
     STATS_CAUSAL_READS,
     STATS_CERT_INTERVAL,
     STATS_IST_RECEIVE_STATUS,
     STATS_IST_RECEIVE_SEQNO_START,
     STATS_IST_RECEIVE_SEQNO_CURRENT,
     STATS_IST_RECEIVE_SEQNO_END,
+    STATS_CPU_PROTONET_NS,
+    STATS_CPU_GCS_RECV_NS,
+    STATS_CPU_APPLIER_NS,
+    STATS_CPU_SERVICE_NS,
     STATS_INCOMING_LIST,
     STATS_MAX
 } StatusVars;
@@ -141,6 +186,7 @@ static const struct wsrep_stats_var wsrep_stats[STATS_MAX + 1] =
     { "repl_keys_bytes",          WSREP_VAR_INT64,  { 0 }  },
     { "repl_data_bytes",          WSREP_VAR_INT64,  { 0 }  },
     { "repl_other_bytes",         WSREP_VAR_INT64,  { 0 }  },
+    { "repl_annotations_stripped_bytes", WSREP_VAR_INT64, { 0 } },
     { "received",                 WSREP_VAR_INT64,  { 0 }  },
     { "received_bytes",           WSREP_VAR_INT64,  { 0 }  },
     { "local_commits",            WSREP_VAR_INT64,  { 0 }  },
@@ -150,6 +196,9 @@ static const struct wsrep_stats_var wsrep_stats[STATS_MAX + 1] =
     { "local_send_queue_max",     WSREP_VAR_INT64,  { 0 }  },
     { "local_send_queue_min",     WSREP_VAR_INT64,  { 0 }  },
     { "local_send_queue_avg",     WSREP_VAR_DOUBLE, { 0 }  },
+    { "local_send_queue_wait_p99",WSREP_VAR_INT64,  { 0 }  },
+    { "local_send_queue_wait_p999",WSREP_VAR_INT64, { 0 }  },
+    { "local_send_queue_entered", WSREP_VAR_INT64,  { 0 }  },
     { "local_recv_queue",         WSREP_VAR_INT64,  { 0 }  },
     { "local_recv_queue_max",     WSREP_VAR_INT64,  { 0 }  },
     { "local_recv_queue_min",     WSREP_VAR_INT64,  { 0 }  },
@@ -157,6 +206,7 @@ static const struct wsrep_stats_var wsrep_stats[STATS_MAX + 1] =
     { "local_cached_downto",      WSREP_VAR_INT64,  { 0 }  },
     { "flow_control_paused_ns",   WSREP_VAR_INT64,  { 0 }  },
     { "flow_control_paused",      WSREP_VAR_DOUBLE, { 0 }  },
+    { "flow_control_pauses",      WSREP_VAR_INT64,  { 0 }  },
     { "flow_control_sent",        WSREP_VAR_INT64,  { 0 }  },
 //    { "flow_control_conts_sent",  WSREP_VAR_INT64,  { 0 }  },
     { "flow_control_recv",        WSREP_VAR_INT64,  { 0 }  },
@@ -164,6 +214,8 @@ static const struct wsrep_stats_var wsrep_stats[STATS_MAX + 1] =
     { "flow_control_interval_low",WSREP_VAR_INT64,  { 0 }  },
     { "flow_control_interval_high",WSREP_VAR_INT64,  { 0 }, },
     { "flow_control_status",      WSREP_VAR_STRING, { 0 }  },
+    { "recv_q_watermark_status",  WSREP_VAR_STRING, { 0 }  },
+    { "recv_q_watermark_crossings",WSREP_VAR_INT64, { 0 }  },
     { "cert_deps_distance",       WSREP_VAR_DOUBLE, { 0 }  },
     { "apply_oooe",               WSREP_VAR_DOUBLE, { 0 }  },
     { "apply_oool",               WSREP_VAR_DOUBLE, { 0 }  },
@@ -171,17 +223,53 @@ static const struct wsrep_stats_var wsrep_stats[STATS_MAX + 1] =
     { "commit_oooe",              WSREP_VAR_DOUBLE, { 0 }  },
     { "commit_oool",              WSREP_VAR_DOUBLE, { 0 }  },
     { "commit_window",            WSREP_VAR_DOUBLE, { 0 }  },
+    { "apply_wait_latency",       WSREP_VAR_STRING, { 0 }  },
+    { "commit_wait_latency",      WSREP_VAR_STRING, { 0 }  },
+    { "repl_stage_latencies",     WSREP_VAR_STRING, { 0 }  },
+    { "repl_slowest_stage",       WSREP_VAR_STRING, { 0 }  },
+    { "apply_waiters",            WSREP_VAR_INT64,  { 0 }  },
+    { "apply_active",             WSREP_VAR_INT64,  { 0 }  },
+    { "apply_busy_ns",            WSREP_VAR_INT64,  { 0 }  },
+    { "apply_wait_ns",            WSREP_VAR_INT64,  { 0 }  },
+    { "applied",                  WSREP_VAR_INT64,  { 0 }  },
+    { "applied_bytes",            WSREP_VAR_INT64,  { 0 }  },
+    { "applied_keys",             WSREP_VAR_INT64,  { 0 }  },
+    { "apply_cb_ns",              WSREP_VAR_INT64,  { 0 }  },
+    { "apply_cost_ns_per_byte",   WSREP_VAR_DOUBLE, { 0 }  },
+    { "apply_cost_ns_per_key",    WSREP_VAR_DOUBLE, { 0 }  },
+    { "commit_waiters",           WSREP_VAR_INT64,  { 0 }  },
+    { "commit_active",            WSREP_VAR_INT64,  { 0 }  },
+    { "commit_busy_ns",           WSREP_VAR_INT64,  { 0 }  },
+    { "commit_wait_ns",           WSREP_VAR_INT64,  { 0 }  },
     { "local_state",              WSREP_VAR_INT64,  { 0 }  },
     { "local_state_comment",      WSREP_VAR_STRING, { 0 }  },
     { "cert_index_size",          WSREP_VAR_INT64,  { 0 }  },
     { "cert_bucket_count",        WSREP_VAR_INT64,  { 0 }  },
+    { "cert_deps_distance_hist",  WSREP_VAR_STRING, { 0 }  },
+    { "cert_conflict_digests",    WSREP_VAR_STRING, { 0 }  },
+    { "cert_index_max_chain",     WSREP_VAR_INT64,  { 0 }  },
+    { "cert_index_avg_chain",     WSREP_VAR_DOUBLE, { 0 }  },
+    { "cert_index_bytes",         WSREP_VAR_INT64,  { 0 }  },
+    { "cert_filter_probes",       WSREP_VAR_INT64,  { 0 }  },
+    { "cert_filter_negatives",    WSREP_VAR_INT64,  { 0 }  },
     { "gcache_pool_size",         WSREP_VAR_INT64,  { 0 }  },
+    { "gcache_mem_used",          WSREP_VAR_INT64,  { 0 }  },
+    { "gcache_rb_used",           WSREP_VAR_INT64,  { 0 }  },
+    { "gcache_rb_size",           WSREP_VAR_INT64,  { 0 }  },
+    { "gcache_page_store_size",   WSREP_VAR_INT64,  { 0 }  },
+    { "gcache_rb_overflows",      WSREP_VAR_INT64,  { 0 }  },
+    { "gcache_discards",          WSREP_VAR_INT64,  { 0 }  },
+    { "gcache_seqno_window",      WSREP_VAR_INT64,  { 0 }  },
     { "causal_reads",             WSREP_VAR_INT64,  { 0 }  },
     { "cert_interval",            WSREP_VAR_DOUBLE, { 0 }  },
     { "ist_receive_status",       WSREP_VAR_STRING, { 0 }  },
     { "ist_receive_seqno_start",  WSREP_VAR_INT64,  { 0 }  },
     { "ist_receive_seqno_current",WSREP_VAR_INT64,  { 0 }  },
     { "ist_receive_seqno_end",    WSREP_VAR_INT64,  { 0 }  },
+    { "cpu_protonet_ns",          WSREP_VAR_INT64,  { 0 }  },
+    { "cpu_gcs_recv_ns",          WSREP_VAR_INT64,  { 0 }  },
+    { "cpu_applier_ns",           WSREP_VAR_INT64,  { 0 }  },
+    { "cpu_service_ns",           WSREP_VAR_INT64,  { 0 }  },
     { "incoming_addresses",       WSREP_VAR_STRING, { 0 }  },
     { 0,                          WSREP_VAR_STRING, { 0 }  }
 };
@@ -206,7 +294,10 @@ galera::ReplicatorSMM::stats_get()
 {
     if (S_DESTROYED == state_()) return 0;
 
-    std::vector<struct wsrep_stats_var> sv(wsrep_stats_);
+    /* reuse the preallocated scratch vector: after the first scrape its
+     * capacity is retained and assign() below does not allocate */
+    std::vector<struct wsrep_stats_var>& sv(stats_vars_scratch_);
+    sv.assign(wsrep_stats_.begin(), wsrep_stats_.end());
 
     sv[STATS_PROTOCOL_VERSION   ].value._int64  = protocol_version_;
     sv[STATS_LAST_APPLIED       ].value._int64  = apply_monitor_.last_left();
@@ -217,6 +308,7 @@ galera::ReplicatorSMM::stats_get()
     sv[STATS_KEYS_BYTES         ].value._int64  = keys_bytes_();
     sv[STATS_DATA_BYTES         ].value._int64  = data_bytes_();
     sv[STATS_UNRD_BYTES         ].value._int64  = unrd_bytes_();
+    sv[STATS_ANNT_STRIPPED_BYTES].value._int64  = annt_stripped_bytes_();
     sv[STATS_RECEIVED           ].value._int64  = gcs_as_.received();
     sv[STATS_RECEIVED_BYTES     ].value._int64  = gcs_as_.received_bytes();
     sv[STATS_LOCAL_COMMITS      ].value._int64  = local_commits_();
@@ -232,6 +324,12 @@ galera::ReplicatorSMM::stats_get()
     sv[STATS_LOCAL_SEND_QUEUE_MAX].value._int64  = stats.send_q_len_max;
     sv[STATS_LOCAL_SEND_QUEUE_MIN].value._int64  = stats.send_q_len_min;
     sv[STATS_LOCAL_SEND_QUEUE_AVG].value._double = stats.send_q_len_avg;
+    /* streaming (P^2) estimates of send queue wait time, nanoseconds */
+    sv[STATS_LOCAL_SEND_QUEUE_WAIT_P99 ].value._int64 = stats.send_q_wait_p99;
+    sv[STATS_LOCAL_SEND_QUEUE_WAIT_P999].value._int64 = stats.send_q_wait_p999;
+    /* actions admitted to the send monitor since the last stats reset -
+     * the denominator for the queue length and wait figures above */
+    sv[STATS_LOCAL_SEND_QUEUE_ENTERED  ].value._int64 = stats.send_q_entered;
     sv[STATS_LOCAL_RECV_QUEUE    ].value._int64  = stats.recv_q_len;
     sv[STATS_LOCAL_RECV_QUEUE_MAX].value._int64  = stats.recv_q_len_max;
     sv[STATS_LOCAL_RECV_QUEUE_MIN].value._int64  = stats.recv_q_len_min;
@@ -240,17 +338,21 @@ galera::ReplicatorSMM::stats_get()
         seqno_min != GCS_SEQNO_ILL ? seqno_min : GCS_SEQNO_NIL;
     sv[STATS_FC_PAUSED_NS        ].value._int64  = stats.fc_paused_ns;
     sv[STATS_FC_PAUSED_AVG       ].value._double = stats.fc_paused_avg;
+    sv[STATS_FC_PAUSES           ].value._int64  = stats.fc_paused_events;
     sv[STATS_FC_SSENT            ].value._int64  = stats.fc_ssent;
 //    sv[STATS_FC_CSENT            ].value._int64  = stats.fc_csent;
     sv[STATS_FC_RECEIVED         ].value._int64  = stats.fc_received;
 
-    std::ostringstream osinterval;
-    osinterval << "[ " << stats.fc_lower_limit << ", " << stats.fc_upper_limit << " ]";
-    strncpy(interval_string_, osinterval.str().c_str(), sizeof(interval_string_));
+    gu::String<64> interval;
+    interval << "[ " << stats.fc_lower_limit << ", " << stats.fc_upper_limit << " ]";
+    strncpy(interval_string_, interval.c_str(), sizeof(interval_string_));
     sv[STATS_FC_INTERVAL         ].value._string = interval_string_;
     sv[STATS_FC_INTERVAL_LOW     ].value._int64 = stats.fc_lower_limit;
     sv[STATS_FC_INTERVAL_HIGH    ].value._int64 = stats.fc_upper_limit;
     sv[STATS_FC_STATUS           ].value._string = (stats.fc_status ? "ON" : "OFF");
+    sv[STATS_RECV_Q_MARK_STATUS  ].value._string =
+        (slave_q_over_mark_ ? "OVER" : "UNDER");
+    sv[STATS_RECV_Q_MARK_CROSSINGS].value._int64 = slave_q_mark_crossings_;
 
     double avg_cert_interval(0);
     double avg_deps_dist(0);
@@ -262,25 +364,157 @@ galera::ReplicatorSMM::stats_get()
     sv[STATS_CERT_INDEX_SIZE     ].value._int64 = index_size;
     sv[STATS_CERT_BUCKET_COUNT   ].value._int64 = cert_.bucket_count();
 
+    /* dependency distance distribution in writesets,
+     * e.g. "p50:12,p90:147,p99:1034,max:5120" - the p50 here bounds the
+     * slave thread count that can still find independent work */
+    strncpy(cert_deps_hist_string_,
+            cert_.deps_dist_histogram().to_string().c_str(),
+            sizeof(cert_deps_hist_string_) - 1);
+    cert_deps_hist_string_[sizeof(cert_deps_hist_string_) - 1] = '\0';
+    sv[STATS_CERT_DEPS_DISTANCE_HIST].value._string = cert_deps_hist_string_;
+
+    /* most conflict-prone certification key digests, "digest:count,..." */
+    strncpy(cert_conflicts_string_,
+            cert_.conflict_digests().c_str(),
+            sizeof(cert_conflicts_string_) - 1);
+    cert_conflicts_string_[sizeof(cert_conflicts_string_) - 1] = '\0';
+    sv[STATS_CERT_CONFLICT_DIGESTS].value._string = cert_conflicts_string_;
+
+    size_t max_chain(0);
+    double avg_chain(0);
+    cert_.index_chain_stats(max_chain, avg_chain);
+    sv[STATS_CERT_INDEX_MAX_CHAIN].value._int64  = max_chain;
+    sv[STATS_CERT_INDEX_AVG_CHAIN].value._double = avg_chain;
+    sv[STATS_CERT_INDEX_BYTES    ].value._int64  = cert_.index_bytes();
+
+    long long filter_probes(0);
+    long long filter_negatives(0);
+    cert_.index_filter_stats(filter_probes, filter_negatives);
+    sv[STATS_CERT_FILTER_PROBES   ].value._int64 = filter_probes;
+    sv[STATS_CERT_FILTER_NEGATIVES].value._int64 = filter_negatives;
+
     sv[STATS_GCACHE_POOL_SIZE    ].value._int64 = gcache_.allocated_pool_size();
 
+    gcache::GCache::Stats gcache_stats;
+    gcache_.get_stats(gcache_stats);
+
+    sv[STATS_GCACHE_MEM_USED     ].value._int64 = gcache_stats.mem_used;
+    sv[STATS_GCACHE_RB_USED      ].value._int64 = gcache_stats.rb_used;
+    sv[STATS_GCACHE_RB_SIZE      ].value._int64 = gcache_stats.rb_size;
+    sv[STATS_GCACHE_PAGE_STORE_SIZE].value._int64 = gcache_stats.page_used;
+    sv[STATS_GCACHE_RB_OVERFLOWS ].value._int64 = gcache_stats.rb_overflows;
+    sv[STATS_GCACHE_DISCARDS     ].value._int64 = gcache_stats.discards;
+    /* how many seqnos the cache holds for potential IST donation */
+    sv[STATS_GCACHE_SEQNO_WINDOW ].value._int64 =
+        gcache_stats.seqno_max >= gcache_stats.seqno_min &&
+        gcache_stats.seqno_min > 0 ?
+        gcache_stats.seqno_max - gcache_stats.seqno_min + 1 : 0;
+
     double oooe;
     double oool;
     double win;
-    const_cast<Monitor<ApplyOrder>&>(apply_monitor_).
-        get_stats(&oooe, &oool, &win);
+    apply_monitor_.get_stats(&oooe, &oool, &win);
 
     sv[STATS_APPLY_OOOE          ].value._double = oooe;
     sv[STATS_APPLY_OOOL          ].value._double = oool;
     sv[STATS_APPLY_WINDOW        ].value._double = win;
 
-    const_cast<Monitor<CommitOrder>&>(commit_monitor_).
-        get_stats(&oooe, &oool, &win);
+    commit_monitor_.get_stats(&oooe, &oool, &win);
 
     sv[STATS_COMMIT_OOOE         ].value._double = oooe;
     sv[STATS_COMMIT_OOOL         ].value._double = oool;
     sv[STATS_COMMIT_WINDOW       ].value._double = win;
 
+    /* monitor enter() latency percentiles in nanoseconds,
+     * e.g. "p50:1536,p90:49408,p99:394240,max:3244032" */
+    strncpy(apply_latency_string_,
+            apply_monitor_.wait_histogram().to_string().c_str(),
+            sizeof(apply_latency_string_) - 1);
+    apply_latency_string_[sizeof(apply_latency_string_) - 1] = '\0';
+    sv[STATS_APPLY_WAITS         ].value._string = apply_latency_string_;
+
+    strncpy(commit_latency_string_,
+            commit_monitor_.wait_histogram().to_string().c_str(),
+            sizeof(commit_latency_string_) - 1);
+    commit_latency_string_[sizeof(commit_latency_string_) - 1] = '\0';
+    sv[STATS_COMMIT_WAITS        ].value._string = commit_latency_string_;
+
+    /* per-trx latency budget over retired trxs: nanosecond percentiles
+     * for each stage, e.g. "order:p50:...;cert:p50:...;...", plus a
+     * per-stage count of trxs for which that stage was the longest -
+     * the stage whose count grows is where the tail latency goes */
+    {
+        std::string stages;
+        for (int i(0); i < LAT_STAGE_MAX; ++i)
+        {
+            if (i) stages += ";";
+            stages += lat_stage_names_[i];
+            stages += ":";
+            stages += lat_stage_hist_[i].to_string();
+        }
+        strncpy(lat_stages_string_, stages.c_str(),
+                sizeof(lat_stages_string_) - 1);
+        lat_stages_string_[sizeof(lat_stages_string_) - 1] = '\0';
+        sv[STATS_LAT_STAGES      ].value._string = lat_stages_string_;
+
+        gu::String<128> slowest;
+        for (int i(0); i < LAT_STAGE_MAX; ++i)
+        {
+            if (i) slowest << ",";
+            slowest << lat_stage_names_[i] << ":" << lat_slowest_[i]();
+        }
+        strncpy(lat_slowest_string_, slowest.c_str(),
+                sizeof(lat_slowest_string_) - 1);
+        lat_slowest_string_[sizeof(lat_slowest_string_) - 1] = '\0';
+        sv[STATS_LAT_SLOWEST     ].value._string = lat_slowest_string_;
+    }
+
+    /* applier pool occupancy: threads applying right now, threads parked
+     * on unmet dependencies and cumulative busy/wait time of the
+     * enter-leave cycles. busy_ns over thread count and wall time is the
+     * pool utilization; many waiters with a low busy share points at
+     * dependency starvation rather than a lack of slave threads (the
+     * undispatched backlog itself is local_recv_queue above). */
+    long      mon_waiters, mon_active;
+    long long mon_busy_ns, mon_wait_ns;
+
+    apply_monitor_.busy_stats(&mon_waiters, &mon_active,
+                              &mon_busy_ns, &mon_wait_ns);
+    sv[STATS_APPLY_WAITERS       ].value._int64 = mon_waiters;
+    sv[STATS_APPLY_ACTIVE        ].value._int64 = mon_active;
+    sv[STATS_APPLY_BUSY_NS       ].value._int64 = mon_busy_ns;
+    sv[STATS_APPLY_WAIT_NS       ].value._int64 = mon_wait_ns;
+
+    /* apply cost model: cumulative callback time and writeset features,
+     * plus the derived average unit costs. Byte and key contributions
+     * are not separated here - dividing by each feature independently
+     * is crude but monotonic, cheap and good enough to spot the mix of
+     * work shifting (e.g. batch deletes driving ns/byte down while
+     * total callback time goes up). */
+    {
+        long long const applied      (applied_());
+        long long const applied_bytes(applied_bytes_());
+        long long const applied_keys (applied_keys_());
+        long long const apply_cb_ns  (apply_cb_ns_());
+
+        sv[STATS_APPLIED      ].value._int64 = applied;
+        sv[STATS_APPLIED_BYTES].value._int64 = applied_bytes;
+        sv[STATS_APPLIED_KEYS ].value._int64 = applied_keys;
+        sv[STATS_APPLY_CB_NS  ].value._int64 = apply_cb_ns;
+
+        sv[STATS_APPLY_COST_NS_PER_BYTE].value._double =
+            applied_bytes > 0 ? double(apply_cb_ns)/applied_bytes : 0.0;
+        sv[STATS_APPLY_COST_NS_PER_KEY ].value._double =
+            applied_keys  > 0 ? double(apply_cb_ns)/applied_keys  : 0.0;
+    }
+
+    commit_monitor_.busy_stats(&mon_waiters, &mon_active,
+                               &mon_busy_ns, &mon_wait_ns);
+    sv[STATS_COMMIT_WAITERS      ].value._int64 = mon_waiters;
+    sv[STATS_COMMIT_ACTIVE       ].value._int64 = mon_active;
+    sv[STATS_COMMIT_BUSY_NS      ].value._int64 = mon_busy_ns;
+    sv[STATS_COMMIT_WAIT_NS      ].value._int64 = mon_wait_ns;
+
 
     sv[STATS_LOCAL_STATE         ].value._int64  = state2stats(state_());
     sv[STATS_LOCAL_STATE_COMMENT ].value._string = state2stats_str(state_(),
@@ -300,10 +534,10 @@ galera::ReplicatorSMM::stats_get()
         percent_complete = std::max(percent_complete, 0);
         percent_complete = std::min(percent_complete, 100);
 
-        std::ostringstream   os;
+        gu::String<128> os;
         os << percent_complete << "% complete, received seqno "
            << current << " of " << first << "-" << last;
-        strncpy(ist_status_string_, os.str().c_str(), sizeof(ist_status_string_));
+        strncpy(ist_status_string_, os.c_str(), sizeof(ist_status_string_));
         sv[STATS_IST_RECEIVE_STATUS].value._string = ist_status_string_;
 
         sv[STATS_IST_RECEIVE_SEQNO_START].value._int64 = first;
@@ -318,6 +552,12 @@ galera::ReplicatorSMM::stats_get()
         sv[STATS_IST_RECEIVE_SEQNO_END].value._int64 = 0;
     }
 
+    // Per-role CPU accounting, see gu::thread_cpu_register()
+    sv[STATS_CPU_PROTONET_NS].value._int64 = gu::thread_cpu_ns("protonet");
+    sv[STATS_CPU_GCS_RECV_NS].value._int64 = gu::thread_cpu_ns("gcs_recv");
+    sv[STATS_CPU_APPLIER_NS ].value._int64 = gu::thread_cpu_ns("applier");
+    sv[STATS_CPU_SERVICE_NS ].value._int64 = gu::thread_cpu_ns("service");
+
     // Get gcs backend status
     gu::Status status;
     gcs_.get_status(status);
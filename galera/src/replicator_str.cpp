@@ -1022,6 +1022,10 @@ void ReplicatorSMM::recv_IST(void* recv_ctx)
 
                 assert(trx != 0);
                 TrxHandleLock lock(*trx);
+                // The receiver thread defers writeset parsing so that it
+                // runs here, spread over the applier threads that share
+                // this loop (see async_recv()).
+                trx->unserialize_ist();
                 // Verify checksum before applying. This is also required
                 // to synchronize with possible background checksum thread.
                 trx->verify_checksum();
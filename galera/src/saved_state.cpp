@@ -12,6 +12,7 @@
 #include <inttypes.h>
 #include <sys/file.h>
 #include <fcntl.h>
+#include <unistd.h>
 
 namespace galera
 {
@@ -35,7 +36,15 @@ SavedState::SavedState  (const std::string& file) :
     current_len_  (0),
     total_marks_  (0),
     total_locks_  (0),
-    total_writes_ (0)
+    total_writes_ (0),
+#ifdef HAVE_PSI_INTERFACE
+    flush_cond_   (WSREP_PFS_INSTR_TAG_SAVED_STATE_CONDVAR),
+#else
+    flush_cond_   (),
+#endif /* HAVE_PSI_INTERFACE */
+    flush_thd_    (),
+    dirty_        (false),
+    closing_      (false)
 {
 
     GU_DBUG_EXECUTE("galera_init_invalidate_state",
@@ -58,6 +67,14 @@ SavedState::SavedState  (const std::string& file) :
             << "'. Check permissions and/or disk space.";
     }
 
+    int const err(gu_thread_create (&flush_thd_, NULL, flush_thd_func, this));
+
+    if (err != 0)
+    {
+        fclose(fs_);
+        gu_throw_error(err) << "Could not create state flusher thread";
+    }
+
     // We take exclusive lock on state file in order to avoid possibility
     // of two Galera replicators sharing the same state file.
     struct flock flck;
@@ -147,6 +164,14 @@ SavedState::SavedState  (const std::string& file) :
 
 SavedState::~SavedState ()
 {
+    {
+        gu::Lock lock(mtx_);
+        closing_ = true;
+        flush_cond_.signal();
+    }
+
+    gu_thread_join (flush_thd_, NULL); // writes out pending state, if any
+
     if (fs_)
     {
         // Closing file descriptor should release the lock, but still...
@@ -190,7 +215,12 @@ SavedState::set (const wsrep_uuid_t& u, wsrep_seqno_t s, bool safe_to_bootstrap)
        safe_to_bootstrap_ = safe_to_bootstrap;
 
        if (0 == unsafe_())
-          write_and_flush (u, s, safe_to_bootstrap);
+       {
+          /* advancing the recovery point can be deferred: losing the write
+           * in a crash merely recovers to an earlier position */
+          dirty_ = true;
+          flush_cond_.signal();
+       }
        else
           log_debug << "Not writing state: unsafe counter is " << unsafe_();
     }
@@ -214,8 +244,12 @@ SavedState::mark_unsafe()
 
         if (written_uuid_ != WSREP_UUID_UNDEFINED)
         {
+            /* durability barrier: invalidation must reach the disk before
+             * the caller proceeds to modify the database, and a pending
+             * deferred write must not resurrect the valid uuid after it */
+            dirty_ = false;
             write_and_flush (WSREP_UUID_UNDEFINED, WSREP_SEQNO_UNDEFINED,
-                             safe_to_bootstrap_);
+                             safe_to_bootstrap_, true);
         }
     }
 }
@@ -237,7 +271,8 @@ SavedState::mark_safe()
             assert(false == corrupt_);
             /* this will write down proper seqno if set() was called too early
              * (in unsafe state) */
-            write_and_flush (uuid_, seqno_, safe_to_bootstrap_);
+            dirty_ = true;
+            flush_cond_.signal();
         }
     }
 }
@@ -257,13 +292,60 @@ SavedState::mark_corrupt()
     seqno_ = WSREP_SEQNO_UNDEFINED;
     corrupt_ = true;
 
+    /* durability barrier, see mark_unsafe() */
+    dirty_ = false;
     write_and_flush (WSREP_UUID_UNDEFINED, WSREP_SEQNO_UNDEFINED,
-                     safe_to_bootstrap_);
+                     safe_to_bootstrap_, true);
+}
+
+void*
+SavedState::flush_thd_func (void* arg)
+{
+    SavedState* ss = reinterpret_cast<SavedState*>(arg);
+
+#ifdef HAVE_PSI_INTERFACE
+    pfs_instr_callback(WSREP_PFS_INSTR_TYPE_THREAD,
+                       WSREP_PFS_INSTR_OPS_INIT,
+                       WSREP_PFS_INSTR_TAG_SAVED_STATE_THREAD,
+                       NULL, NULL, NULL);
+#endif /* HAVE_PSI_INTERFACE */
+
+    while (true)
+    {
+        /* the write happens under mtx_ so that it can never interleave with
+         * a synchronous barrier write and overwrite it with stale state.
+         * Foreground threads meet the flusher only when a new update
+         * collides with a write in progress - bursts of updates are
+         * coalesced into a single write while the previous one is on disk */
+        gu::Lock lock(ss->mtx_);
+
+        while (!ss->dirty_ && !ss->closing_) lock.wait(ss->flush_cond_);
+
+        bool const dirty(ss->dirty_);
+        ss->dirty_ = false;
+
+        if (dirty && 0 == ss->unsafe_() && !ss->corrupt_)
+        {
+            ss->write_and_flush (ss->uuid_, ss->seqno_,
+                                 ss->safe_to_bootstrap_, false);
+        }
+
+        if (ss->closing_) break;
+    }
+
+#ifdef HAVE_PSI_INTERFACE
+    pfs_instr_callback(WSREP_PFS_INSTR_TYPE_THREAD,
+                       WSREP_PFS_INSTR_OPS_DESTROY,
+                       WSREP_PFS_INSTR_TAG_SAVED_STATE_THREAD,
+                       NULL, NULL, NULL);
+#endif /* HAVE_PSI_INTERFACE */
+
+    return 0;
 }
 
 void
 SavedState::write_and_flush(const wsrep_uuid_t& u, const wsrep_seqno_t s,
-                            bool safe_to_bootstrap)
+                            bool safe_to_bootstrap, bool durable)
 {
     assert (current_len_ <= MAX_SIZE);
 
@@ -289,6 +371,11 @@ SavedState::write_and_flush(const wsrep_uuid_t& u, const wsrep_seqno_t s,
         fwrite(buf, write_size, 1, fs_);
         fflush(fs_);
 
+        if (durable && fdatasync(fileno(fs_)))
+        {
+            log_warn << "Could not sync state file: " << ::strerror(errno);
+        }
+
         current_len_ = state_len;
         written_uuid_ = u;
         ++total_writes_;
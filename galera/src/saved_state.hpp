@@ -7,7 +7,8 @@
 
 #include "gu_atomic.hpp"
 #include "gu_mutex.hpp"
-#include "gu_lock.hpp"
+#include "gu_lock.hpp" // gu::Mutex and gu::Cond
+#include "gu_threads.h"
 
 #include "wsrep_api.h"
 
@@ -60,8 +61,23 @@ private:
     long             total_locks_;
     long             total_writes_;
 
+    /* State writes that only advance the recovery point (set(), mark_safe())
+     * are deferred to a background flusher thread which coalesces them into
+     * a single file write. Only invalidating writes (mark_unsafe(),
+     * mark_corrupt()) act as durability barriers and stay synchronous. */
+#ifdef HAVE_PSI_INTERFACE
+    gu::CondWithPFS  flush_cond_;
+#else
+    gu::Cond         flush_cond_;
+#endif /* HAVE_PSI_INTERFACE */
+    gu_thread_t      flush_thd_;
+    bool             dirty_;   // deferred write pending
+    bool             closing_;
+
+    static void* flush_thd_func (void*);
+
     void write_and_flush (const wsrep_uuid_t& u, const wsrep_seqno_t s,
-                          bool safe_to_bootstrap);
+                          bool safe_to_bootstrap, bool durable);
 
     SavedState (const SavedState&);
     SavedState& operator=(const SavedState&);
@@ -228,6 +228,27 @@ galera::TrxHandle::unserialize(const gu::byte_t* const buf, size_t const buflen,
 
             set_write_set_buffer(buf + offset, buflen - offset);
 
+            /* index data segments now so that apply and replay don't
+             * have to re-walk the key segments every time */
+            {
+                const gu::byte_t* const wsb(buf + offset);
+                size_t const wsb_len(buflen - offset);
+                size_t       wsb_off(0);
+
+                data_segs_.clear();
+
+                while (wsb_off < wsb_len)
+                {
+                    std::pair<size_t, size_t> const k(
+                        WriteSet::segment(wsb, wsb_len, wsb_off));
+                    wsb_off = k.first + k.second;
+                    std::pair<size_t, size_t> const d(
+                        WriteSet::segment(wsb, wsb_len, wsb_off));
+                    wsb_off = d.first + d.second;
+                    data_segs_.push_back(d);
+                }
+            }
+
             break;
         case 3:
             write_set_in_.read_buf (buf, buflen);
@@ -319,38 +340,51 @@ galera::TrxHandle::apply (void*                   recv_ctx,
     {
         const gu::byte_t* buf(write_set_buffer().first);
         const size_t buf_len(write_set_buffer().second);
-        size_t offset(0);
 
-        while (offset < buf_len && WSREP_CB_SUCCESS == err)
+        if (gu_likely(data_segs_.empty() == false || 0 == buf_len))
         {
-            // Skip key segment
-            std::pair<size_t, size_t> k(
-                galera::WriteSet::segment(buf, buf_len, offset));
-            offset = k.first + k.second;
-            // Data part
-            std::pair<size_t, size_t> d(
-                galera::WriteSet::segment(buf, buf_len, offset));
-            offset = d.first + d.second;
-
-            err = apply_cb (recv_ctx, buf + d.first, d.second,
-                            trx_flags_to_wsrep_flags(flags()), &meta);
+            // Data segments were indexed once in unserialize(), key
+            // segments need not be walked again here.
+            for (size_t i(0); i < data_segs_.size() &&
+                     WSREP_CB_SUCCESS == err; ++i)
+            {
+                err = apply_cb (recv_ctx,
+                                buf + data_segs_[i].first,
+                                data_segs_[i].second,
+                                trx_flags_to_wsrep_flags(flags()), &meta);
+            }
         }
+        else
+        {
+            // Buffer was attached without going through unserialize()
+            // (unit tests, preloaded write set collections).
+            size_t offset(0);
 
-        assert(offset == buf_len);
+            while (offset < buf_len && WSREP_CB_SUCCESS == err)
+            {
+                // Skip key segment
+                std::pair<size_t, size_t> k(
+                    galera::WriteSet::segment(buf, buf_len, offset));
+                offset = k.first + k.second;
+                // Data part
+                std::pair<size_t, size_t> d(
+                    galera::WriteSet::segment(buf, buf_len, offset));
+                offset = d.first + d.second;
+
+                err = apply_cb (recv_ctx, buf + d.first, d.second,
+                                trx_flags_to_wsrep_flags(flags()), &meta);
+            }
+
+            assert(offset == buf_len);
+        }
     }
 
     if (gu_unlikely(err > 0))
     {
-        std::ostringstream os;
-
-        os << "Failed to apply app buffer: seqno: " << global_seqno()
-           << ", status: " << err;
-
-        galera::ApplyException ae(os.str(), err);
-
-        GU_TRACE(ae);
-
-        throw ae;
+        /* a normal outcome under conflict load, not an error: don't
+         * format anything here, the catcher logs the seqno and status
+         * from the trx if it decides to, see apply_trx_ws() */
+        throw galera::ApplyException(err);
     }
 
     return;
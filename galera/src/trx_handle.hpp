@@ -49,10 +49,13 @@ namespace galera
             int             version_;
             KeySet::Version key_format_;
             int             max_write_set_size_;
+            bool            strip_annotations_;
             Params (const std::string& wdir, int ver, KeySet::Version kformat,
-                    int max_write_set_size = WriteSetNG::MAX_SIZE) :
+                    int  max_write_set_size = WriteSetNG::MAX_SIZE,
+                    bool strip_annotations  = false) :
                 working_dir_(wdir), version_(ver), key_format_(kformat),
-                max_write_set_size_(max_write_set_size) {}
+                max_write_set_size_(max_write_set_size),
+                strip_annotations_(strip_annotations) {}
         };
 
         static const Params Defaults;
@@ -275,6 +278,29 @@ namespace galera
         bool is_interim_committed() const { return interim_committed_; }
         void mark_interim_committed(bool val) { interim_committed_ = val; }
 
+        /* Latency budget record: coarse clock timestamps taken as the
+         * trx crosses stage boundaries, aggregated into per-stage
+         * histograms when it retires (ReplicatorSMM::account_latency()).
+         * A stamp of 0 means the trx never passed that boundary here
+         * (e.g. slave trxs have no replication stage, local trxs no
+         * provider-side apply). */
+        enum LatStamp
+        {
+            LAT_REPLICATE, /* replicate() entered (local trx only)     */
+            LAT_ORDERED,   /* total order assigned / delivered from group */
+            LAT_CERTIFIED, /* certification decision made              */
+            LAT_APPLIED,   /* apply callback finished (slave trx only) */
+            LAT_COMMITTED, /* commit order left                        */
+            LAT_STAMP_MAX
+        };
+
+        void lat_stamp(LatStamp s)
+        {
+            lat_tstamps_[s] = gu_time_monotonic_coarse();
+        }
+
+        long long lat_tstamp(LatStamp s) const { return lat_tstamps_[s]; }
+
         void set_received (const void*   action,
                            wsrep_seqno_t seqno_l,
                            wsrep_seqno_t seqno_g)
@@ -310,6 +336,37 @@ namespace galera
             set_depends_seqno(seqno_d);
         }
 
+        /* Complete deserialization of a writeset received through IST.
+         * The receiver thread only moves the writeset bytes into
+         * write_set_collection_ and records the seqnos from the message
+         * meta data (ist::Proto::recv_trx()) - the parse itself runs here,
+         * on the applier threads, in parallel. Rolled back writesets carry
+         * no payload and need no parsing. */
+        void unserialize_ist()
+        {
+            if (write_set_collection_.empty()) return;
+
+#ifndef NDEBUG
+            wsrep_seqno_t const seqno_g(global_seqno_);
+            wsrep_seqno_t const seqno_d(depends_seqno_);
+#endif
+            unserialize(&write_set_collection_[0],
+                        write_set_collection_.size(), 0);
+
+            if (version() >= 3)
+            {
+                /* the writeset provides the tighter pa_range based
+                 * dependency, recompute seqnos from it */
+                set_received_from_ws();
+                assert(global_seqno()  == seqno_g);
+                assert(depends_seqno() >= seqno_d);
+            }
+            /* pre-3 writesets carry no seqnos, the meta data values
+             * recorded by the receiver remain in effect */
+
+            mark_certified();
+        }
+
         void set_last_seen_seqno(wsrep_seqno_t last_seen_seqno)
         {
             assert (last_seen_seqno >= 0);
@@ -324,6 +381,79 @@ namespace galera
             depends_seqno_ = seqno_lt;
         }
 
+        /* Exact dependency set collected during certification.
+         *
+         * depends_seqno_ is only the highest seqno this trx depends on, so
+         * the apply monitor has to wait until *everything* up to it has been
+         * applied. Exclusive key matches in the cert index identify the
+         * dependency exactly (writer-writer dependencies chain transitively
+         * through the index), so when all of them fit in dep_seqnos_ the
+         * monitor may admit this trx as soon as each recorded seqno has
+         * left, even if unrelated writesets below depends_seqno_ are still
+         * applying. Shared-ref matches cannot be tracked exactly - the
+         * index keeps only the latest reader - so they are folded into the
+         * dep_base_ watermark, below which everything must have left.
+         * When the set overflows, the oldest tracked dependency is folded
+         * into dep_base_ - waiting for last_left to reach it subsumes
+         * waiting for it to finish - so writesets referencing many
+         * predecessors keep exact admission for the youngest ones.
+         * Pre-v3 certification clears deps_exact_ and the scalar
+         * depends_seqno_ remains the only gate. */
+        static int const MAX_DEP_SEQNOS = 8;
+
+        void reset_dep_seqnos(wsrep_seqno_t base)
+        {
+            n_dep_seqnos_ = 0;
+            dep_base_     = base;
+            deps_exact_   = true;
+        }
+
+        void add_dep_seqno(wsrep_seqno_t seqno)
+        {
+            if (seqno <= dep_base_) return;
+
+            for (int i(0); i < n_dep_seqnos_; ++i)
+            {
+                if (dep_seqnos_[i] == seqno) return;
+            }
+
+            if (gu_likely(n_dep_seqnos_ < MAX_DEP_SEQNOS))
+            {
+                dep_seqnos_[n_dep_seqnos_++] = seqno;
+            }
+            else
+            {
+                /* no room: fold the oldest dependency into the base
+                 * watermark, it is the most likely to have finished by
+                 * the time this trx reaches the apply monitor anyway */
+                int min_i(0);
+                for (int i(1); i < MAX_DEP_SEQNOS; ++i)
+                {
+                    if (dep_seqnos_[i] < dep_seqnos_[min_i]) min_i = i;
+                }
+
+                if (seqno < dep_seqnos_[min_i])
+                {
+                    dep_base_ = seqno;
+                }
+                else
+                {
+                    dep_base_       = dep_seqnos_[min_i];
+                    dep_seqnos_[min_i] = seqno;
+                }
+            }
+        }
+
+        void add_dep_base(wsrep_seqno_t seqno)
+        {
+            if (seqno > dep_base_) dep_base_ = seqno;
+        }
+
+        bool          deps_exact()     const { return deps_exact_;    }
+        wsrep_seqno_t dep_base()       const { return dep_base_;      }
+        int           n_dep_seqnos()   const { return n_dep_seqnos_;  }
+        wsrep_seqno_t dep_seqno(int i) const { return dep_seqnos_[i]; }
+
         State state() const { return state_(); }
         void set_state(State state) { state_.shift_to(state); }
 
@@ -580,6 +710,16 @@ namespace galera
             write_set_in_.verify_checksum();
         }
 
+        void preload_keys() const
+        {
+            if (new_version()) write_set_in_.preload_keys();
+        }
+
+        void preload_data() const
+        {
+            if (new_version()) write_set_in_.preload_data();
+        }
+
         uint64_t get_checksum() const
         {
             if (new_version())
@@ -596,10 +736,10 @@ namespace galera
                 return serial_size();
         }
 
-        void update_stats(gu::Atomic<long long>& kc,
-                          gu::Atomic<long long>& kb,
-                          gu::Atomic<long long>& db,
-                          gu::Atomic<long long>& ub)
+        void update_stats(gu::ShardedCounter<long long>& kc,
+                          gu::ShardedCounter<long long>& kb,
+                          gu::ShardedCounter<long long>& db,
+                          gu::ShardedCounter<long long>& ub)
         {
             assert(new_version());
             kc += write_set_in_.keyset().count();
@@ -654,12 +794,18 @@ namespace galera
             global_seqno_      (WSREP_SEQNO_UNDEFINED),
             last_seen_seqno_   (WSREP_SEQNO_UNDEFINED),
             depends_seqno_     (WSREP_SEQNO_UNDEFINED),
+            dep_seqnos_        (),
+            dep_base_          (WSREP_SEQNO_UNDEFINED),
+            n_dep_seqnos_      (0),
+            deps_exact_        (false),
             timestamp_         (),
             write_set_         (Defaults.version_),
             write_set_in_      (),
             annotation_        (),
             cert_keys_         (),
             write_set_buffer_  (0, 0),
+            data_segs_         (),
+            lat_tstamps_       (),
             mem_pool_          (mp),
             action_            (0),
             gcs_handle_        (-1),
@@ -698,12 +844,18 @@ namespace galera
             global_seqno_      (WSREP_SEQNO_UNDEFINED),
             last_seen_seqno_   (WSREP_SEQNO_UNDEFINED),
             depends_seqno_     (WSREP_SEQNO_UNDEFINED),
+            dep_seqnos_        (),
+            dep_base_          (WSREP_SEQNO_UNDEFINED),
+            n_dep_seqnos_      (0),
+            deps_exact_        (false),
             timestamp_         (gu_time_calendar()),
             write_set_         (params.version_),
             write_set_in_      (),
             annotation_        (),
             cert_keys_         (),
             write_set_buffer_  (0, 0),
+            data_segs_         (),
+            lat_tstamps_       (),
             mem_pool_          (mp),
             action_            (0),
             gcs_handle_        (-1),
@@ -744,7 +896,8 @@ namespace galera
                                        WriteSetNG::MAX_VERSION,
                                        DataSet::MAX_VERSION,
                                        DataSet::MAX_VERSION,
-                                       params.max_write_set_size_);
+                                       params.max_write_set_size_,
+                                       params.strip_annotations_);
             }
         }
 
@@ -765,6 +918,10 @@ namespace galera
         wsrep_seqno_t          global_seqno_;
         wsrep_seqno_t          last_seen_seqno_;
         wsrep_seqno_t          depends_seqno_;
+        wsrep_seqno_t          dep_seqnos_[MAX_DEP_SEQNOS];
+        wsrep_seqno_t          dep_base_;
+        int                    n_dep_seqnos_;
+        bool                   deps_exact_;
         int64_t                timestamp_;
         WriteSet               write_set_;
         WriteSetIn             write_set_in_;
@@ -774,6 +931,14 @@ namespace galera
         // Write set buffer location if stored outside TrxHandle.
         std::pair<const gu::byte_t*, size_t> write_set_buffer_;
 
+        // Data segment index (offset, length pairs) for pre-WS_NG_VERSION
+        // writesets, built once in unserialize() so that apply and replay
+        // don't have to re-walk the key segments (see applying()).
+        std::vector<std::pair<size_t, size_t> > data_segs_;
+
+        // stage boundary timestamps, see LatStamp
+        long long lat_tstamps_[LAT_STAMP_MAX];
+
         gu::MemPool<true>&     mem_pool_;
         const void*            action_;
         long                   gcs_handle_;
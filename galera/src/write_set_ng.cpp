@@ -6,10 +6,13 @@
 #include "write_set_ng.hpp"
 
 #include "gu_time.h"
+#include "gu_lock.hpp"
 
 #include <gu_macros.hpp>
 
 #include <iomanip>
+#include <deque>
+#include <unistd.h> // sysconf()
 
 namespace galera
 {
@@ -152,10 +155,48 @@ WriteSetNG::Header::copy(bool const include_keys, bool const include_unrd) const
 }
 
 
+template <>
+ssize_t
+WriteSetNG::Header::check_size_tmpl<WriteSetNG::VER3> (
+    const gu::byte_t* const buf,
+    ssize_t const           bufsize)
+{
+    assert (bufsize > 4);
+
+    ssize_t const hsize(buf[V3_HEADER_SIZE_OFF]);
+
+    if (gu_unlikely(hsize > bufsize))
+    {
+        gu_throw_error (EMSGSIZE)
+            << "Input buffer size " << bufsize
+            << " smaller than header size " << hsize;
+    }
+
+    return hsize;
+}
+
+
+ssize_t
+WriteSetNG::Header::check_size (Version const           ver,
+                                const gu::byte_t* const buf,
+                                ssize_t const           bufsize)
+{
+    switch (ver)
+    {
+    case VER3: return check_size_tmpl<VER3>(buf, bufsize);
+    }
+
+    /* ver comes from version() above, which has already thrown on
+     * anything it does not understand */
+    gu_throw_error (EPROTO) << "Unsupported writeset version: " << ver;
+}
+
+
+template <>
 void
-WriteSetNG::Header::Checksum::verify (Version           ver,
-                                      const void* const ptr,
-                                      ssize_t const     hsize)
+WriteSetNG::Header::Checksum::verify_tmpl<WriteSetNG::VER3> (
+    const void* const ptr,
+    ssize_t const     hsize)
 {
     assert (hsize > 0);
 
@@ -180,16 +221,171 @@ WriteSetNG::Header::Checksum::verify (Version           ver,
 }
 
 
+void
+WriteSetNG::Header::Checksum::verify (Version           ver,
+                                      const void* const ptr,
+                                      ssize_t const     hsize)
+{
+    switch (ver)
+    {
+    case VER3: verify_tmpl<VER3>(ptr, hsize); return;
+    }
+
+    gu_throw_error (EPROTO) << "Unsupported writeset version: " << ver;
+}
+
+
 const char WriteSetOut::keys_suffix[] = "_keys";
 const char WriteSetOut::data_suffix[] = "_data";
 const char WriteSetOut::unrd_suffix[] = "_unrd";
 const char WriteSetOut::annt_suffix[] = "_annt";
 
 
+/* Persistent pool of checksum worker threads: incoming writesets are queued
+ * here at parse time and verified concurrently with certification lookup,
+ * replacing both the serial foreground checksum of small writesets and the
+ * one-off thread that used to be spawned for large ones. */
+class WriteSetIn::CheckPool
+{
+public:
+
+    CheckPool() : mtx_(), submitted_(), completed_(), queue_(),
+                  n_threads_(0), closing_(false)
+    {
+        long n(sysconf(_SC_NPROCESSORS_ONLN));
+
+        if (n < 1) n = 1;
+        if (n > MAX_THREADS) n = MAX_THREADS;
+
+        while (n_threads_ < n)
+        {
+            int const err(gu_thread_create(&ids_[n_threads_], NULL,
+                                           thread_func, this));
+            if (gu_unlikely(err != 0))
+            {
+                log_warn << "Failed to start writeset checksum thread: "
+                         << err << " (" << ::strerror(err) << ')';
+                break;
+            }
+
+            ++n_threads_;
+        }
+    }
+
+    ~CheckPool()
+    {
+        {
+            gu::Lock lock(mtx_);
+            closing_ = true;
+            submitted_.broadcast();
+        }
+
+        for (long i(0); i < n_threads_; ++i) gu_thread_join(ids_[i], NULL);
+    }
+
+    /* returns false if there are no worker threads to do the job */
+    bool submit(WriteSetIn* const ws)
+    {
+        gu::Lock lock(mtx_);
+
+        if (gu_unlikely(0 == n_threads_)) return false;
+
+        queue_.push_back(ws);
+        submitted_.signal();
+
+        return true;
+    }
+
+    void wait(const WriteSetIn* const ws)
+    {
+        gu::Lock lock(mtx_);
+
+        while (!ws->check_done_) lock.wait(completed_);
+    }
+
+private:
+
+    static long const MAX_THREADS = 4;
+
+    void run()
+    {
+        for (;;)
+        {
+            WriteSetIn* ws(NULL);
+
+            {
+                gu::Lock lock(mtx_);
+
+                while (queue_.empty())
+                {
+                    if (gu_unlikely(closing_)) return;
+                    lock.wait(submitted_);
+                }
+
+                ws = queue_.front();
+                queue_.pop_front();
+            }
+
+            ws->checksum();
+
+            {
+                gu::Lock lock(mtx_);
+                ws->check_done_ = true;
+                completed_.broadcast();
+            }
+        }
+    }
+
+    static void* thread_func (void* const arg)
+    {
+#ifdef HAVE_PSI_INTERFACE
+        pfs_instr_callback(WSREP_PFS_INSTR_TYPE_THREAD,
+                           WSREP_PFS_INSTR_OPS_INIT,
+                           WSREP_PFS_INSTR_TAG_WRITESET_CHECKSUM_THREAD,
+                           NULL, NULL, NULL);
+#endif /* HAVE_PSI_INTERFACE */
+
+        static_cast<CheckPool*>(arg)->run();
+
+#ifdef HAVE_PSI_INTERFACE
+        pfs_instr_callback(WSREP_PFS_INSTR_TYPE_THREAD,
+                           WSREP_PFS_INSTR_OPS_DESTROY,
+                           WSREP_PFS_INSTR_TAG_WRITESET_CHECKSUM_THREAD,
+                           NULL, NULL, NULL);
+#endif /* HAVE_PSI_INTERFACE */
+        return NULL;
+    }
+
+    gu::Mutex               mtx_;
+    gu::Cond                submitted_;
+    gu::Cond                completed_;
+    std::deque<WriteSetIn*> queue_;
+    gu_thread_t             ids_[MAX_THREADS];
+    long                    n_threads_;
+    bool                    closing_;
+};
+
+
+WriteSetIn::CheckPool&
+WriteSetIn::check_pool()
+{
+    static CheckPool pool;
+    return pool;
+}
+
+
+void
+WriteSetIn::check_wait() const
+{
+    check_pool().wait(this);
+    check_pending_ = false;
+}
+
+
 void
 WriteSetIn::init (ssize_t const st)
 {
-    assert(false == check_thr_);
+    assert(false == check_pending_);
 
     const gu::byte_t* const pptr (header_.payload());
     ssize_t           const psize(size_ - header_.size());
@@ -201,28 +397,23 @@ WriteSetIn::init (ssize_t const st)
     if (kver != KeySet::EMPTY) gu_trace(keys_.init (kver, pptr, psize));
 
     assert (false == check_);
-    assert (false == check_thr_);
+    assert (false == check_pending_);
 
     if (gu_likely(st > 0)) /* checksum enforced */
     {
-        if (size_ >= st)
-        {
-            /* buffer too big, start checksumming in background */
-            int const err(gu_thread_create (&check_thr_id_, NULL,
-                                            checksum_thread, this));
+        /* Hand the writeset over to the checksum pool so that verification
+         * runs concurrently with certification lookup: keys are parsed
+         * above, in the foreground, so certification has all it needs,
+         * and verify_checksum() collects the verdict before apply. */
+        check_done_ = false;
 
-            if (gu_likely(0 == err))
-            {
-                check_thr_ = true;
-                return;
-            }
-
-            log_warn << "Starting checksum thread failed: " << err
-                     << '(' << ::strerror(err) << ')';
-
-            /* fall through to checksum in foreground */
+        if (gu_likely(check_pool().submit(this)))
+        {
+            check_pending_ = true;
+            return;
         }
 
+        /* no worker threads, checksum in foreground */
         checksum();
         checksum_fin();
     }
@@ -20,6 +20,7 @@
 
 #include "gu_serialize.hpp"
 #include "gu_vector.hpp"
+#include "gu_limits.h" // GU_PAGE_SIZE
 
 #include <vector>
 #include <string>
@@ -102,7 +103,26 @@ namespace galera
             F_TOI         = 1 << 2,
             F_PA_UNSAFE   = 1 << 3,
             F_COMMUTATIVE = 1 << 4,
-            F_NATIVE      = 1 << 5
+            F_NATIVE      = 1 << 5,
+            /* Reserved for compressed payload support. Rationale for not
+             * just setting it on VER3 writesets: current nodes pass unknown
+             * flag bits through and would misparse a compressed payload, so
+             * the bit may only be set after a cluster-wide protocol upgrade
+             * (establish_protocol_versions() mapping a new repl protocol to
+             * a new trx version, with nodes built without the codec capping
+             * their advertised protocol). Until such a version exists this
+             * bit must stay zero on the wire. */
+            F_COMPRESSED  = 1 << 6,
+            /* Reserved for streaming replication. Transaction fragments
+             * emitted during execution will carry neither F_COMMIT nor
+             * F_ROLLBACK; F_BEGIN marks the first fragment so that replicas
+             * can open the streaming context before certifying it. Like
+             * F_COMPRESSED, this can only appear on the wire under a future
+             * repl protocol: certification and the replicator currently
+             * treat every writeset as a complete transaction, and the
+             * wsrep API in this tree has no calls for the server side to
+             * emit or apply fragments. */
+            F_BEGIN       = 1 << 7
         };
 
         /* this takes care of converting wsrep API flags to on-the-wire flags */
@@ -309,24 +329,18 @@ namespace galera
 
         private:
 
+            /* Version-templated part of the read-side checks, one
+             * explicit specialization per supported version in
+             * write_set_ng.cpp. The template parameter fixes all offsets
+             * and sizes at compile time, so past the single dispatch on
+             * the version byte the parsing path is straight-line code. */
+            template <Version>
             static ssize_t
-            check_size (Version const           ver,
-                        const gu::byte_t* const buf,
-                        ssize_t const           bufsize)
-            {
-                assert (bufsize > 4);
-
-                ssize_t const hsize(buf[V3_HEADER_SIZE_OFF]);
-
-                if (gu_unlikely(hsize > bufsize))
-                {
-                    gu_throw_error (EMSGSIZE)
-                        << "Input buffer size " << bufsize
-                        << " smaller than header size " << hsize;
-                }
+            check_size_tmpl (const gu::byte_t* buf, ssize_t bufsize);
 
-                return hsize;
-            }
+            /* run-time dispatch on the version read from the buffer */
+            static ssize_t
+            check_size (Version ver, const gu::byte_t* buf, ssize_t bufsize);
 
             static int const V3_CHECKSUM_SIZE = 8;
 
@@ -343,6 +357,12 @@ namespace galera
                     value = gu::htog<type_t>(value);
                 }
 
+                /* verification proper, specialized per version like
+                 * check_size_tmpl() above */
+                template <Version>
+                static void
+                verify_tmpl (const void* ptr, ssize_t size);
+
                 static void
                 verify (Version ver, const void* ptr, ssize_t size);
 
@@ -494,7 +514,8 @@ namespace galera
                      WriteSetNG::Version     ver      = WriteSetNG::MAX_VERSION,
                      DataSet::Version        dver     = DataSet::MAX_VERSION,
                      DataSet::Version        uver     = DataSet::MAX_VERSION,
-                     size_t                  max_size = WriteSetNG::MAX_SIZE)
+                     size_t                  max_size = WriteSetNG::MAX_SIZE,
+                     bool                    strip_annt = false)
             :
             header_(ver),
             base_name_(dir_name, id),
@@ -514,7 +535,9 @@ namespace galera
             annt_  (NULL),
             left_  (max_size - keys_.size() - data_.size() - unrd_.size()
                     - header_.size()),
-            flags_ (flags)
+            flags_ (flags),
+            strip_annt_    (strip_annt),
+            annt_stripped_ (0)
         {}
 
         ~WriteSetOut() { delete annt_; }
@@ -570,10 +593,16 @@ namespace galera
                           + unrd_.page_count() + 1 /* global header */);
 
 
+            /* annotations may be withheld from the replicated payload:
+             * the set stays in this object for the originator's own use
+             * (logging, diagnostics), the header just records that no
+             * annotation set follows. */
+            bool const annotated (NULL != annt_ && !strip_annt_);
+
             size_t out_size (header_.gather (keys_.version(),
                                              data_.version(),
                                              unrd_.version() != DataSet::EMPTY,
-                                             NULL != annt_,
+                                             annotated,
                                              flags_, source, conn, trx,
                                              out));
 
@@ -581,11 +610,25 @@ namespace galera
             out_size += data_.gather(out);
             out_size += unrd_.gather(out);
 
-            if (NULL != annt_) out_size += annt_->gather(out);
+            if (annotated)
+            {
+                out_size += annt_->gather(out);
+            }
+            else if (NULL != annt_)
+            {
+                /* measure exactly what the set would have added to the
+                 * payload (gather() trims unused header slack) */
+                WriteSetNG::GatherVector scratch;
+                annt_stripped_ = annt_->gather(scratch);
+            }
 
             return out_size;
         }
 
+        /*! bytes of annotation data withheld from the replicated payload,
+         *  valid after gather() */
+        size_t annt_stripped() const { return annt_stripped_; }
+
         void set_last_seen (const wsrep_seqno_t& ls)
         {
             header_.set_last_seen(ls);
@@ -655,6 +698,8 @@ namespace galera
         DataSetOut*         annt_;
         ssize_t             left_;
         uint16_t            flags_;
+        bool                strip_annt_;
+        size_t              annt_stripped_;
 
         void check_size()
         {
@@ -679,8 +724,8 @@ namespace galera
               data_  (),
               unrd_  (),
               annt_  (NULL),
-              check_thr_id_(),
-              check_thr_(false),
+              check_pending_(false),
+              check_done_   (false),
               check_ (false)
         {
             init (st);
@@ -693,8 +738,8 @@ namespace galera
               data_  (),
               unrd_  (),
               annt_  (NULL),
-              check_thr_id_(),
-              check_thr_(false),
+              check_pending_(false),
+              check_done_   (false),
               check_ (false)
         {}
 
@@ -719,10 +764,10 @@ namespace galera
 
         ~WriteSetIn ()
         {
-            if (gu_unlikely(check_thr_))
+            if (gu_unlikely(check_pending_))
             {
-                /* checksum was performed in a parallel thread */
-                gu_thread_join (check_thr_id_, NULL);
+                /* checksum is being performed in the background */
+                check_wait();
             }
 
             delete annt_;
@@ -755,15 +800,44 @@ namespace galera
          * and before it is finalized. */
         void verify_checksum() const /* throws */
         {
-            if (gu_unlikely(check_thr_))
+            if (gu_unlikely(check_pending_))
             {
-                /* checksum was performed in a parallel thread */
-                gu_thread_join (check_thr_id_, NULL);
-                check_thr_ = false;
+                /* checksum is being performed in the background */
+                check_wait();
                 checksum_fin();
             }
         }
 
+        /* Walks the keyset once to fault in the backing pages and parse
+         * the key records while the caller still runs in parallel with
+         * other appliers. Certification re-reads the keys under the
+         * total order monitor, so a first touch there would serialize
+         * page faults and record parsing behind it. Parse errors are
+         * left for certification to detect - it has the established
+         * handling for corrupted writesets. */
+        void preload_keys() const
+        {
+            try
+            {
+                keys_.rewind();
+                for (int i(0); i < keys_.count(); ++i) keys_.next();
+            }
+            catch (...) {}
+        }
+
+        /* Faults in the data payload pages while the applier is still
+         * waiting for its apply order slot. The apply callback makes the
+         * first payload read inside the ordered section, so a writeset
+         * that went cold in gcache (mapped pages evicted since delivery)
+         * would stall there with every later trx queued behind it.
+         * Reading one byte per page ahead of the monitor moves those
+         * faults into the parallel part of the applier loop. */
+        void preload_data() const
+        {
+            preload_pages (data_.buf());
+            preload_pages (unrd_.buf());
+        }
+
         uint64_t get_checksum() const
         {
             /* since data segment is the only thing that definitely stays
@@ -792,20 +866,30 @@ namespace galera
 
     private:
 
+        /* persistent pool of checksum worker threads shared by all
+         * WriteSetIn instances, see write_set_ng.cpp */
+        class CheckPool;
+
+        static CheckPool& check_pool();
+
         WriteSetNG::Header header_;
         ssize_t            size_;
         KeySetIn           keys_;
         DataSetIn          data_;
         DataSetIn          unrd_;
         DataSetIn*         annt_;
-        gu_thread_t        check_thr_id_;
-        bool mutable       check_thr_;
+        bool mutable       check_pending_; // submitted to pool, not waited yet
+        bool mutable       check_done_;    // completion flag, set by worker
         bool               check_;
 
         static size_t const SIZE_THRESHOLD = 1 << 22; /* 4Mb */
 
         void checksum (); /* checksums writeset, stores result in check_ */
 
+        /* waits for the background checksum to finish, clears
+         * check_pending_ */
+        void check_wait() const;
+
         void checksum_fin() const
         {
             if (gu_unlikely(!check_))
@@ -814,25 +898,19 @@ namespace galera
             }
         }
 
-        static void* checksum_thread (void* arg)
+        /* reads one byte per page of buf; the volatile sink keeps the
+         * otherwise dead loads from being optimized away */
+        static void preload_pages (const gu::Buf& buf)
         {
-#ifdef HAVE_PSI_INTERFACE
-            pfs_instr_callback(WSREP_PFS_INSTR_TYPE_THREAD,
-                               WSREP_PFS_INSTR_OPS_INIT,
-                               WSREP_PFS_INSTR_TAG_WRITESET_CHECKSUM_THREAD,
-                               NULL, NULL, NULL);
-#endif /* HAVE_PSI_INTERFACE */
-
-            WriteSetIn* ws(reinterpret_cast<WriteSetIn*>(arg));
-            ws->checksum();
-
-#ifdef HAVE_PSI_INTERFACE
-            pfs_instr_callback(WSREP_PFS_INSTR_TYPE_THREAD,
-                               WSREP_PFS_INSTR_OPS_DESTROY,
-                               WSREP_PFS_INSTR_TAG_WRITESET_CHECKSUM_THREAD,
-                               NULL, NULL, NULL);
-#endif /* HAVE_PSI_INTERFACE */
-            return NULL;
+            const gu::byte_t* const ptr
+                (static_cast<const gu::byte_t*>(buf.ptr));
+            ssize_t const           page(GU_PAGE_SIZE);
+            gu::byte_t volatile     sink(0);
+
+            for (ssize_t off(0); off < buf.size; off += page)
+            {
+                sink += ptr[off];
+            }
         }
 
         /* late initialization after default constructor */
@@ -13,11 +13,15 @@
 void galera::Wsdb::print(std::ostream& os) const
 {
     os << "trx map:\n";
-    for (galera::Wsdb::TrxMap::const_iterator i = trx_map_.begin();
-         i != trx_map_.end();
-         ++i)
+    for (unsigned int s(0); s < N_STRIPES; ++s)
     {
-        os << i->first << " " << *i->second << "\n";
+        for (galera::Wsdb::TrxMap::const_iterator i =
+                 stripes_[s].trx_map_.begin();
+             i != stripes_[s].trx_map_.end();
+             ++i)
+        {
+            os << i->first << " " << *i->second << "\n";
+        }
     }
     os << "conn query map:\n";
     for (galera::Wsdb::ConnMap::const_iterator i = conn_map_.begin();
@@ -33,13 +37,7 @@ void galera::Wsdb::print(std::ostream& os) const
 galera::Wsdb::Wsdb()
     :
     trx_pool_  (TrxHandle::LOCAL_STORAGE_SIZE(), 512, "LocalTrxHandle"),
-    trx_map_     (),
-    conn_trx_map_(),
-#ifdef HAVE_PSI_INTERFACE
-    trx_mutex_   (WSREP_PFS_INSTR_TAG_WSDB_TRX_MUTEX),
-#else
-    trx_mutex_   (),
-#endif /* HAVE_PSI_INTERFACE */
+    stripes_     (),
     conn_map_    (),
 #ifdef HAVE_PSI_INTERFACE
     conn_mutex_  (WSREP_PFS_INSTR_TAG_WSDB_CONN_MUTEX)
@@ -51,7 +49,13 @@ galera::Wsdb::Wsdb()
 
 galera::Wsdb::~Wsdb()
 {
-    log_debug << "wsdb trx map usage " << trx_map_.size()
+    size_t trx_map_size(0);
+    for (unsigned int s(0); s < N_STRIPES; ++s)
+    {
+        trx_map_size += stripes_[s].trx_map_.size();
+    }
+
+    log_debug << "wsdb trx map usage " << trx_map_size
              << " conn query map usage " << conn_map_.size();
     log_debug << trx_pool_;
 
@@ -60,10 +64,14 @@ galera::Wsdb::~Wsdb()
 #ifndef NDEBUG
     std::cerr << *this;
 #else
-    for_each(trx_map_.begin(), trx_map_.end(), Unref2nd<TrxMap::value_type>());
-    for_each(conn_trx_map_.begin(),
-             conn_trx_map_.end(),
-             Unref2nd<ConnTrxMap::value_type>());
+    for (unsigned int s(0); s < N_STRIPES; ++s)
+    {
+        for_each(stripes_[s].trx_map_.begin(), stripes_[s].trx_map_.end(),
+                 Unref2nd<TrxMap::value_type>());
+        for_each(stripes_[s].conn_trx_map_.begin(),
+                 stripes_[s].conn_trx_map_.end(),
+                 Unref2nd<ConnTrxMap::value_type>());
+    }
 #endif // !NDEBUG
 }
 
@@ -71,8 +79,6 @@ galera::Wsdb::~Wsdb()
 inline galera::TrxHandle*
 galera::Wsdb::find_trx(wsrep_trx_id_t const trx_id)
 {
-    gu::Lock lock(trx_mutex_);
-
     galera::TrxHandle* trx;
     /* trx-id = 0 is safe-guard condition.
     trx-id is generally assigned from thd->query-id
@@ -85,16 +91,20 @@ galera::Wsdb::find_trx(wsrep_trx_id_t const trx_id)
     {
         /* trx_id is valid and valid ids are unique.
         Search for valid trx_id in trx_id -> trx map. */
-        TrxMap::iterator const i(trx_map_.find(trx_id));
-        trx = (trx_map_.end() == i ? NULL : i->second);
+        TrxStripe& str(stripe(trx_id));
+        gu::Lock lock(str.mutex_);
+        TrxMap::iterator const i(str.trx_map_.find(trx_id));
+        trx = (str.trx_map_.end() == i ? NULL : i->second);
     }
     else
     {
         /* trx_id is default so search for repsective connection id
         in connection-transaction map. */
         pthread_t const id = pthread_self();
-        ConnTrxMap::iterator const i(conn_trx_map_.find(id));
-        trx = (conn_trx_map_.end() == i ? NULL : i->second);
+        TrxStripe& str(thread_stripe());
+        gu::Lock lock(str.mutex_);
+        ConnTrxMap::iterator const i(str.conn_trx_map_.find(id));
+        trx = (str.conn_trx_map_.end() == i ? NULL : i->second);
     }
 
     return (trx);
@@ -108,15 +118,15 @@ galera::Wsdb::create_trx(const TrxHandle::Params& params,
 {
     TrxHandle* trx(TrxHandle::New(trx_pool_, params, source_id, -1, trx_id));
 
-    gu::Lock lock(trx_mutex_);
-
     galera::TrxHandle* trx_ref;
     if (trx_id != wsrep_trx_id_t(-1))
     {
         /* trx_id is valid add it to trx-map as valid trx_id is unique
         accross connections. */
+        TrxStripe& str(stripe(trx_id));
+        gu::Lock lock(str.mutex_);
         std::pair<TrxMap::iterator, bool> i
-            (trx_map_.insert(std::make_pair(trx_id, trx)));
+            (str.trx_map_.insert(std::make_pair(trx_id, trx)));
         if (gu_unlikely(i.second == false)) gu_throw_fatal;
         trx_ref = i.first->second;
     }
@@ -124,8 +134,10 @@ galera::Wsdb::create_trx(const TrxHandle::Params& params,
     {
         /* trx_id is default so add trx object to connection map
         that is maintained based on pthread_id (alias for connection_id). */
-         std::pair<ConnTrxMap::iterator, bool> i
-             (conn_trx_map_.insert(std::make_pair(pthread_self(), trx)));
+        TrxStripe& str(thread_stripe());
+        gu::Lock lock(str.mutex_);
+        std::pair<ConnTrxMap::iterator, bool> i
+            (str.conn_trx_map_.insert(std::make_pair(pthread_self(), trx)));
         if (gu_unlikely(i.second == false)) gu_throw_fatal;
         trx_ref = i.first->second;
     }
@@ -199,24 +211,27 @@ galera::Wsdb::get_conn_query(const TrxHandle::Params& params,
 
 void galera::Wsdb::discard_trx(wsrep_trx_id_t trx_id)
 {
-    gu::Lock lock(trx_mutex_);
     if (trx_id != wsrep_trx_id_t(-1))
     {
+        TrxStripe& str(stripe(trx_id));
+        gu::Lock lock(str.mutex_);
         TrxMap::iterator i;
-        if ((i = trx_map_.find(trx_id)) != trx_map_.end())
+        if ((i = str.trx_map_.find(trx_id)) != str.trx_map_.end())
         {
             i->second->unref();
-            trx_map_.erase(i);
+            str.trx_map_.erase(i);
         }
     }
     else
     {
+        TrxStripe& str(thread_stripe());
+        gu::Lock lock(str.mutex_);
         ConnTrxMap::iterator i;
         pthread_t id = pthread_self();
-        if ((i = conn_trx_map_.find(id)) != conn_trx_map_.end())
+        if ((i = str.conn_trx_map_.find(id)) != str.conn_trx_map_.end())
         {
             i->second->unref();
-            conn_trx_map_.erase(i);
+            str.conn_trx_map_.erase(i);
         }
     }
 }
@@ -115,16 +115,32 @@ namespace galera
 
         static const size_t trx_mem_limit_ = 1 << 20;
 
+        /* Trx maps are striped by trx/thread id so that client threads
+         * don't serialize on a single mutex for trx handle lookup. */
+        static unsigned int const N_STRIPES = 64; // must be power of 2
+
+        struct TrxStripe
+        {
+            TrxMap     trx_map_;
+            ConnTrxMap conn_trx_map_;
+            gu::Mutex  mutex_;
+
+            TrxStripe() : trx_map_(), conn_trx_map_(), mutex_() {}
+        };
+
+        TrxStripe& stripe(wsrep_trx_id_t const trx_id)
+        {
+            return stripes_[TrxHash()(trx_id) & (N_STRIPES - 1)];
+        }
+
+        TrxStripe& thread_stripe()
+        {
+            return stripes_[ConnTrxHash()(pthread_self()) & (N_STRIPES - 1)];
+        }
+
         TrxHandle::LocalPool trx_pool_;
 
-        TrxMap       trx_map_;
-        ConnTrxMap   conn_trx_map_;
-#ifdef HAVE_PSI_INTERFACE
-        gu::MutexWithPFS
-                     trx_mutex_;
-#else
-        gu::Mutex    trx_mutex_;
-#endif /* HAVE_PSI_INTERFACE */
+        TrxStripe    stripes_[N_STRIPES];
         ConnMap      conn_map_;
 #ifdef HAVE_PSI_INTERFACE
         gu::MutexWithPFS
@@ -73,8 +73,10 @@ public:
     void lock() { }
     void unlock() { }
     wsrep_seqno_t seqno() const { return trx_.global_seqno(); }
+    template <class MON>
     bool condition(wsrep_seqno_t last_entered,
-                   wsrep_seqno_t last_left) const
+                   wsrep_seqno_t last_left,
+                   const MON&    mon) const
     {
         return (last_left >= trx_.depends_seqno());
     }
@@ -176,6 +178,8 @@ extern "C" void* trx_thread(void* arg)
             log_info << "terminated with " << err;
             return 0;
         }
+        // parsing is deferred to the consumer threads as in recv_IST()
+        trx->unserialize_ist();
         TestOrder to(*trx);
         targs->monitor_.enter(to);
         targs->monitor_.leave(to);
@@ -44,6 +44,7 @@ namespace
 
         gcache::GCache&   gcache()  { return gcache_; }
         galera::DummyGcs& gcs()     { return gcs_;    }
+        gu::Config&       conf()    { return conf_;   }
 
     private:
 
@@ -60,7 +61,7 @@ using namespace galera;
 START_TEST(service_thd1)
 {
     TestEnv env;
-    ServiceThd* thd = new ServiceThd(env.gcs(), env.gcache());
+    ServiceThd* thd = new ServiceThd(env.gcs(), env.gcache(), env.conf());
     fail_if (thd == 0);
     delete thd;
 }
@@ -74,7 +75,7 @@ START_TEST(service_thd2)
 {
     TestEnv env;
     DummyGcs& conn(env.gcs());
-    ServiceThd* thd = new ServiceThd(conn, env.gcache());
+    ServiceThd* thd = new ServiceThd(conn, env.gcache(), env.conf());
     fail_if (thd == 0);
 
     conn.set_last_applied(0);
@@ -119,7 +120,7 @@ END_TEST
 START_TEST(service_thd3)
 {
     TestEnv env;
-    ServiceThd* thd = new ServiceThd(env.gcs(), env.gcache());
+    ServiceThd* thd = new ServiceThd(env.gcs(), env.gcache(), env.conf());
     fail_if (thd == 0);
     // so far for empty GCache the following should be a noop.
     thd->release_seqno(-1);
@@ -44,7 +44,7 @@ namespace
             gcache_setup_(conf_),
             gcache_ (conf_, "."),
             gcs_    (conf_, gcache_),
-            thd_    (gcs_,  gcache_)
+            thd_    (gcs_,  gcache_, conf_)
         {}
 
         ~TestEnv() {}
@@ -9,15 +9,107 @@
 #include "gu_throw.hpp"
 #include "gu_assert.hpp"
 #include "gu_limits.h"
+#include "gu_lock.hpp"
 
 #include <sstream>
 #include <iomanip> // for std::setfill() and std::setw()
 
 
+namespace
+{
+    /*! Process-wide pool of recycled standard-size heap pages.
+     *
+     * In steady state every writeset that outgrows its reserved store
+     * spills into a freshly malloc'ed heap page which is freed right
+     * after replication, so page churn is pure overhead. Recycling the
+     * standard-size pages makes that path allocation-free. Odd-size
+     * pages (clamped by the RAM pool limit or stretched by oversized
+     * allocations) bypass the pool. */
+    class HeapPagePool
+    {
+    public:
+
+        HeapPagePool() : mtx_(), count_(0) {}
+
+        ~HeapPagePool() { while (count_ > 0) ::free (pages_[--count_]); }
+
+        gu::byte_t* get (gu::Allocator::page_size_type const size)
+        {
+            if (size != page_size()) return NULL;
+
+            gu::Lock lock(mtx_);
+
+            if (0 == count_) return NULL;
+
+            return pages_[--count_];
+        }
+
+        void put (gu::byte_t* const ptr,
+                  gu::Allocator::page_size_type const size)
+        {
+            if (size == page_size())
+            {
+                gu::Lock lock(mtx_);
+
+                if (count_ < POOL_MAX)
+                {
+                    pages_[count_++] = ptr;
+                    return;
+                }
+            }
+
+            ::free (ptr);
+        }
+
+        size_t count() const { return count_; } // no lock - approximate
+
+        /*! the page size the pool deals in - the heap store default */
+        static gu::Allocator::page_size_type page_size()
+        {
+            /* to avoid too frequent allocation, make it (at least) 64K */
+            static gu::Allocator::page_size_type const ret
+                (gu_page_size_multiple(1 << 16));
+            return ret;
+        }
+
+    private:
+
+        HeapPagePool (const HeapPagePool&);
+        HeapPagePool& operator= (const HeapPagePool&);
+
+        /* cap on retained pages: 64 x 64K = one default 4M RAM pool */
+        static int const POOL_MAX = 64;
+
+        gu::Mutex   mtx_;
+        int         count_;
+        gu::byte_t* pages_[POOL_MAX];
+    };
+
+    HeapPagePool heap_page_pool;
+}
+
+size_t
+gu::Allocator::heap_pages_pooled() { return heap_page_pool.count(); }
+
+
 gu::Allocator::HeapPage::HeapPage (page_size_type const size) :
-    Page (static_cast<byte_t*>(::malloc(size)), size)
+    Page (heap_page_pool.get (size), size),
+    alloc_size_ (size)
 {
-    if (0 == base_ptr_) gu_throw_error (ENOMEM);
+    if (0 == base_ptr_) // no pooled page of this size, fall back to malloc()
+    {
+        base_ptr_ = static_cast<byte_t*>(::malloc(size));
+
+        if (0 == base_ptr_) gu_throw_error (ENOMEM);
+
+        ptr_ = base_ptr_;
+    }
+}
+
+
+gu::Allocator::HeapPage::~HeapPage ()
+{
+    heap_page_pool.put (base_ptr_, alloc_size_);
 }
 
 
@@ -26,11 +118,8 @@ gu::Allocator::HeapStore::my_new_page (page_size_type const size)
 {
     if (gu_likely(size <= left_))
     {
-        /* to avoid too frequent allocation, make it (at least) 64K */
-        static page_size_type const PAGE_SIZE(gu_page_size_multiple(1 << 16));
-
         page_size_type const page_size
-            (std::min(std::max(size, PAGE_SIZE), left_));
+            (std::min(std::max(size, HeapPagePool::page_size()), left_));
 
         Page* ret = new HeapPage (page_size);
 
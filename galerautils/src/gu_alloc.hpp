@@ -57,6 +57,10 @@ public:
     /* Total count of pages */
     size_t count() const { return pages_->size(); }
 
+    /* Number of heap pages currently held by the process-wide reuse pool
+     * (approximate - for monitoring and tests) */
+    static size_t heap_pages_pooled();
+
 #ifdef GU_ALLOCATOR_DEBUG
     /* appends own vector of Buf structures to the passed one,
      * should be called only after all allocations have been made.
@@ -115,7 +119,11 @@ private:
 
         HeapPage (page_size_type max_size);
 
-        ~HeapPage () { free (base_ptr_); }
+        ~HeapPage ();
+
+    private:
+
+        page_size_type const alloc_size_;
     };
 
     class FilePage : public Page
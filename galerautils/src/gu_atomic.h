@@ -58,6 +58,15 @@ extern "C" {
 #define gu_atomic_get(ptr, vptr)                        \
     __atomic_load(ptr, vptr, GU_ATOMIC_SYNC_DEFAULT)
 
+// relaxed variants for statistics counters: atomicity (no torn values)
+// without ordering - never use these for anything that synchronizes
+#define gu_atomic_fetch_and_add_relaxed(ptr, val) \
+    __atomic_fetch_add(ptr, val, GU_ATOMIC_SYNC_NONE)
+#define gu_atomic_set_relaxed(ptr, vptr)          \
+    __atomic_store(ptr, vptr, GU_ATOMIC_SYNC_NONE)
+#define gu_atomic_get_relaxed(ptr, vptr)          \
+    __atomic_load(ptr, vptr, GU_ATOMIC_SYNC_NONE)
+
 #elif defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_8) // use __sync_XXX builtins
 
 #define GU_ATOMIC_SYNC_NONE    0
@@ -83,10 +92,18 @@ extern "C" {
 
 #define gu_atomic_get(ptr, vptr) *vptr = __sync_fetch_and_or(ptr, 0)
 
+// __sync builtins offer no relaxed ordering, fall back to full barriers
+#define gu_atomic_fetch_and_add_relaxed  __sync_fetch_and_add
+#define gu_atomic_set_relaxed            gu_atomic_set
+#define gu_atomic_get_relaxed            gu_atomic_get
+
 #else
 #error "This GCC version does not support 8-byte atomics on this platform. Use GCC >= 4.7.x."
 #endif /* __ATOMIC_RELAXED */
 
+// if *ptr equals oldv, stores newv in *ptr; returns true on success
+#define gu_atomic_bool_cas __sync_bool_compare_and_swap
+
 #else /* __GNUC__ */
 #error "Compiler not supported"
 #endif
@@ -13,6 +13,15 @@
 #include "gu_atomic.h"
 #include <memory>
 
+#include <cstring>
+#include <stdint.h>
+
+#if defined(__linux__)
+#include <sched.h>   // sched_getcpu()
+#else
+#include <pthread.h>
+#endif
+
 namespace gu
 {
     template <typename I>
@@ -76,6 +85,25 @@ namespace gu
             return (operator()() != i);
         }
 
+        /*! if the stored value equals oldv, replace it with newv;
+         *  returns true on success */
+        bool bool_cas(I oldv, I newv)
+        {
+            return gu_atomic_bool_cas(&i_, oldv, newv);
+        }
+
+        /*! raise the stored value to i if it is currently lower; retries
+         *  only if a concurrent caller raised it in between */
+        void set_if_greater(I i)
+        {
+            I cur;
+            gu_atomic_get(&i_, &cur);
+            while (cur < i && !gu_atomic_bool_cas(&i_, cur, i))
+            {
+                gu_atomic_get(&i_, &cur);
+            }
+        }
+
     private:
 #if !defined(__ATOMIC_RELAXED)
         // implementation of gu_atomic_get() via __sync_fetch_and_or()
@@ -84,6 +112,142 @@ namespace gu
 #endif
         I i_;
     };
+
+    /*! Statistics counter: same interface as Atomic but all accesses
+     *  use relaxed ordering, so an increment is a single atomic add
+     *  without the sequentially consistent fence. Reads are torn-free
+     *  but unordered with respect to other memory - never use this for
+     *  anything that synchronizes (refcounts, sequence numbers). */
+    template <typename I>
+    class StatCounter
+    {
+    public:
+        StatCounter(I i = 0) : i_(i) { }
+
+        I operator()() const
+        {
+            I i;
+            gu_atomic_get_relaxed(&i_, &i);
+            return i;
+        }
+
+        StatCounter<I>& operator=(I i)
+        {
+            gu_atomic_set_relaxed(&i_, &i);
+            return *this;
+        }
+
+        StatCounter<I>& operator++()
+        {
+            gu_atomic_fetch_and_add_relaxed(&i_, 1);
+            return *this;
+        }
+
+        StatCounter<I>& operator+=(I i)
+        {
+            gu_atomic_fetch_and_add_relaxed(&i_, i);
+            return *this;
+        }
+
+    private:
+#if !defined(__ATOMIC_RELAXED)
+        mutable
+#endif
+        I i_;
+    };
+
+    /*! Sharded statistics counter for counters bumped by many threads
+     *  at once (the replication hot path): increments go to a
+     *  cache-line-padded cell indexed by the current cpu, so concurrent
+     *  writers do not bounce one line between cores. Reads sum the
+     *  cells and are only as consistent as relaxed per-cell loads allow
+     *  - fine for statistics, nothing else. Resetting is not atomic
+     *  against concurrent increments. */
+    template <typename I>
+    class ShardedCounter
+    {
+    public:
+        ShardedCounter(I i = 0) : cells_(), storage_()
+        {
+            /* align the cell array within storage_ by hand: relying on
+             * an aligned(64) type would require every enclosing object
+             * to be allocated with matching alignment, which plain new
+             * does not guarantee before C++17 */
+            uintptr_t p(reinterpret_cast<uintptr_t>(storage_));
+            p = (p + cell_align_ - 1) & ~uintptr_t(cell_align_ - 1);
+            cells_ = reinterpret_cast<Cell*>(p);
+
+            ::memset(cells_, 0, sizeof(Cell) * n_cells_);
+            cells_[0].i_ = i;
+        }
+
+        I operator()() const
+        {
+            I sum(0);
+            for (int c(0); c < n_cells_; ++c)
+            {
+                I i;
+                gu_atomic_get_relaxed(&cells_[c].i_, &i);
+                sum += i;
+            }
+            return sum;
+        }
+
+        ShardedCounter<I>& operator=(I i)
+        {
+            I zero(0);
+            for (int c(1); c < n_cells_; ++c)
+            {
+                gu_atomic_set_relaxed(&cells_[c].i_, &zero);
+            }
+            gu_atomic_set_relaxed(&cells_[0].i_, &i);
+            return *this;
+        }
+
+        ShardedCounter<I>& operator++()
+        {
+            gu_atomic_fetch_and_add_relaxed(&cells_[cell()].i_, 1);
+            return *this;
+        }
+
+        ShardedCounter<I>& operator+=(I i)
+        {
+            gu_atomic_fetch_and_add_relaxed(&cells_[cell()].i_, i);
+            return *this;
+        }
+
+    private:
+
+        static int const n_cells_    = 16;
+        static int const cell_align_ = 64; // cache line
+
+        struct Cell
+        {
+#if !defined(__ATOMIC_RELAXED)
+            mutable
+#endif
+            I    i_;
+            char pad_[cell_align_ - sizeof(I)];
+        };
+
+        static int cell()
+        {
+#if defined(__linux__)
+            int const cpu(sched_getcpu());
+            return (cpu >= 0 ? cpu % n_cells_ : 0);
+#else
+            // no cpu id available, spread by thread identity instead
+            return static_cast<int>(((uintptr_t)pthread_self() / 64)
+                                    % n_cells_);
+#endif
+        }
+
+        ShardedCounter(const ShardedCounter&); // cells_ points into storage_
+        ShardedCounter& operator=(const ShardedCounter&);
+
+        Cell* cells_; // 64-byte aligned array of n_cells_ inside storage_
+        char  storage_[sizeof(Cell) * n_cells_ + cell_align_ - 1];
+    };
 }
 
 #endif // ::GU_ATOMIC_HPP
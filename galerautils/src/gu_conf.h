@@ -17,6 +17,7 @@ extern "C" {
 /* Logging options */
 #include <stdio.h>
 #include "gu_log.h"
+#include "gu_log_async.h" // gu_conf_async_log_on/off()
 #include "gu_threads.h"
 extern int gu_conf_set_log_file     (FILE* file);
 extern int gu_conf_set_log_callback (gu_log_cb_t callback);
@@ -100,7 +100,7 @@ gu::Config::parse (const std::string& param_list)
     if (not_found) throw gu::NotFound();
 }
 
-gu::Config::Config() : params_() {}
+gu::Config::Config() : params_(), handles_() {}
 
 void
 gu::Config::set_longlong (const std::string& key, long long val)
@@ -15,6 +15,7 @@
 #include "gu_utils.hpp"
 #include "gu_throw.hpp"
 #include "gu_logger.hpp"
+#include "gu_atomic.hpp"
 #include <map>
 
 #include <climits>
@@ -79,6 +80,9 @@ public:
 
         if (i != params_.end())
         {
+            /* refresh handles first: if the new value does not convert,
+             * this throws and neither the parameter nor the handles change */
+            notify(key, value, i->second);
             i->second.set(value);
         }
         else
@@ -201,8 +205,129 @@ public:
     const_iterator begin() const { return params_.begin(); }
     const_iterator end()   const { return params_.end();   }
 
+    /* typed cached parameter handles */
+
+    /*! Base class for typed handles, see Param<T> below */
+    class ParamBase
+    {
+    public:
+        virtual ~ParamBase() {}
+    protected:
+        ParamBase() {}
+    private:
+        friend class Config;
+        /*! refresh the cached value from the new string value,
+         *  @throw gu::Exception if conversion fails */
+        virtual void update (const std::string& value) = 0;
+    };
+
+    /*! A typed handle caching the converted value of one parameter.
+     *
+     *  The handle is refreshed by Config on every set() of its key, so a
+     *  hot-path read is a plain atomic load - no map lookup and no string
+     *  parsing. T must have a from_config<>() conversion (integer types,
+     *  double, bool). Reads are thread-safe against concurrent set();
+     *  registration/destruction are not and must be serialized with it
+     *  by the caller (normally both happen in configuration context). */
+    template <typename T>
+    class Param : public ParamBase
+    {
+    public:
+
+        /*! @param def initial cached value until the parameter is set,
+         *             for the case when the key has no value yet */
+        Param (Config& cfg, const std::string& key, T def = T())
+            : cfg_(cfg), key_(key), val_(def)
+        {
+            cfg_.attach(key_, *this); // throws NotFound on unknown key
+        }
+
+        ~Param() { cfg_.detach(key_, *this); }
+
+        /*! hot path: returns the cached converted value */
+        T operator()() const { return val_(); }
+
+        const std::string& key() const { return key_; }
+
+    private:
+
+        void update (const std::string& value)
+        {
+            val_ = Config::from_config<T>(value);
+        }
+
+        Param (const Param&);
+        Param& operator= (const Param&);
+
+        Config&           cfg_;
+        std::string const key_;
+        Atomic<T>         val_;
+    };
+
+    /*! registers a handle to be refreshed on every set(key), initializing
+     *  it from the current value if one is set.
+     *  @throw NotFound if key was not add()'ed before */
+    void
+    attach (const std::string& key, ParamBase& handle)
+    {
+        param_map_t::const_iterator const i(params_.find(key));
+
+        if (i == params_.end()) throw NotFound();
+
+        handles_.insert(std::make_pair(key, &handle));
+
+        if (i->second.is_set()) handle.update(i->second.value());
+    }
+
+    void
+    detach (const std::string& key, ParamBase& handle)
+    {
+        std::pair<handle_map_t::iterator, handle_map_t::iterator>
+            const range(handles_.equal_range(key));
+
+        for (handle_map_t::iterator i(range.first); i != range.second; ++i)
+        {
+            if (i->second == &handle)
+            {
+                handles_.erase(i);
+                return;
+            }
+        }
+    }
+
 private:
 
+    typedef std::multimap<std::string, ParamBase*> handle_map_t;
+
+    void
+    notify (const std::string& key, const std::string& value,
+            const Parameter&   old)
+    {
+        std::pair<handle_map_t::iterator, handle_map_t::iterator>
+            const range(handles_.equal_range(key));
+
+        for (handle_map_t::iterator i(range.first); i != range.second; ++i)
+        {
+            try
+            {
+                i->second->update(value);
+            }
+            catch (...)
+            {
+                /* roll back the handles already refreshed and rethrow,
+                 * so that a rejected value leaves everything unchanged */
+                if (old.is_set())
+                {
+                    for (handle_map_t::iterator j(range.first); j != i; ++j)
+                    {
+                        j->second->update(old.value());
+                    }
+                }
+                throw;
+            }
+        }
+    }
+
     static void
     check_conversion (const char* ptr, const char* endptr, const char* type,
                       bool range_error = false);
@@ -218,7 +343,8 @@ private:
 
     void set_longlong (const std::string& key, long long value);
 
-    param_map_t params_;
+    param_map_t  params_;
+    handle_map_t handles_;
 };
 
 
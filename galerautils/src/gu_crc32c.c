@@ -6,28 +6,110 @@
 
 #include "gu_crc32c.h"
 #include "gu_log.h"
+#include "gu_time.h"
 
 #include <assert.h>
+#include <stdlib.h>
 
 CRC32CFunctionPtr gu_crc32c_func = crc32cSlicingBy8; // some sensible default
 
+/* Sizes roughly covering what the provider actually checksums: small
+ * keys and action headers up to sizeable writeset fragments. Candidate
+ * implementations are timed over the whole mix and the smallest total
+ * wins, so the choice reflects a measurement on the machine we actually
+ * run on rather than compile-time assumptions. */
+static size_t const crc32c_bench_sizes[] = { 16, 64, 512, 4096, 65536 };
+
+#define CRC32C_BENCH_SIZES \
+    (sizeof(crc32c_bench_sizes)/sizeof(crc32c_bench_sizes[0]))
+#define CRC32C_BENCH_BUF  65536
+#define CRC32C_BENCH_REPS 64
+
+static long long
+crc32c_time (CRC32CFunctionPtr const func, const void* const buf)
+{
+    uint32_t  crc = GU_CRC32C_INIT;
+    long long start;
+    int       rep;
+    size_t    i;
+
+    /* warm-up pass so that cache misses don't skew the first candidate */
+    for (i = 0; i < CRC32C_BENCH_SIZES; i++)
+        crc = func (crc, buf, crc32c_bench_sizes[i]);
+
+    start = gu_time_monotonic();
+
+    for (rep = 0; rep < CRC32C_BENCH_REPS; rep++)
+    {
+        for (i = 0; i < CRC32C_BENCH_SIZES; i++)
+            crc = func (crc, buf, crc32c_bench_sizes[i]);
+    }
+
+    return (gu_time_monotonic() - start + (0 == crc));
+}
+
 void
 gu_crc32c_configure()
 {
-    gu_crc32c_func = detectBestCRC32C();
+    CRC32CFunctionPtr candidates[3];
+    const char*       names[3];
+    int               n = 0;
+    int               best;
+
+    CRC32CFunctionPtr const detected = detectBestCRC32C();
+
+    candidates[n] = crc32cSlicingBy8;
+    names[n]      = "\"slicing-by-8\" algorithm";
+    n++;
 
 #if !defined(CRC32C_NO_HARDWARE)
-    if (gu_crc32c_func == crc32cHardware64 ||
-        gu_crc32c_func == crc32cHardware32) {
-        gu_info ("CRC-32C: using hardware acceleration.");
+    if (crc32cHardware64 == detected || crc32cHardware32 == detected)
+    {
+        candidates[n] = detected;
+        names[n]      = "hardware acceleration";
+        n++;
+#if defined(CRC32C_x86_64) && defined(__LP64__)
+        if (crc32cHardware64 == detected)
+        {
+            /* break the crc32q latency chain on large buffers */
+            gu_crc32c_hardware64_3way_init();
+            candidates[n] = gu_crc32c_hardware64_3way;
+            names[n]      = "3-way hardware acceleration";
+            n++;
+        }
+#endif /* CRC32C_x86_64 && __LP64__ */
     }
     else
 #endif /* !CRC32C_NO_HARDWARE */
-    if (gu_crc32c_func == crc32cSlicingBy8) {
-        gu_info ("CRC-32C: using \"slicing-by-8\" algorithm.");
-    }
-    else {
+    if (detected != crc32cSlicingBy8)
+    {
         gu_fatal ("unexpected CRC-32C implementation.");
         abort();
     }
+
+    best = n - 1; // old heuristic preference as a fallback
+
+    if (n > 1)
+    {
+        void* const buf = calloc (CRC32C_BENCH_BUF, 1);
+
+        if (buf)
+        {
+            long long best_time = 0;
+            int       i;
+
+            for (i = 0; i < n; i++)
+            {
+                long long const t = crc32c_time (candidates[i], buf);
+
+                if (0 == i || t < best_time) { best = i; best_time = t; }
+            }
+
+            free (buf);
+        }
+    }
+
+    gu_crc32c_func = candidates[best];
+
+    gu_info ("CRC-32C: using %s.", names[best]);
 }
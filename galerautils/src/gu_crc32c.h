@@ -23,6 +23,17 @@ gu_crc32c_configure();
 
 extern CRC32CFunctionPtr gu_crc32c_func;
 
+#if defined(CRC32C_x86_64) && !defined(CRC32C_NO_HARDWARE) && defined(__LP64__)
+/*! Three-way interleaved crc32q kernel for large buffers (gu_crc32c_x86.c).
+ *  Requires SSE 4.2 - only gu_crc32c_configure() may install it. */
+extern uint32_t
+gu_crc32c_hardware64_3way (uint32_t crc, const void* data, size_t length);
+
+/*! Precomputes the GF(2) block-combination tables used by the above. */
+extern void
+gu_crc32c_hardware64_3way_init();
+#endif /* CRC32C_x86_64 && !CRC32C_NO_HARDWARE && __LP64__ */
+
 typedef uint32_t gu_crc32c_t;
 
 static gu_crc32c_t const GU_CRC32C_INIT = 0xFFFFFFFF;
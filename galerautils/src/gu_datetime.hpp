@@ -139,6 +139,16 @@ namespace gu
              */
             static inline Date monotonic() { return gu_time_monotonic(); }
 
+            /*!
+             * @brief Get time from coarse monotonic clock.
+             *
+             * Cheaper than monotonic() but only accurate to a few
+             * milliseconds. For stats and bookkeeping on hot paths;
+             * timeout arithmetic should keep using monotonic().
+             */
+            static inline Date monotonic_coarse()
+            { return gu_time_monotonic_coarse(); }
+
             /*!
              * @brief Get maximum representable timestamp.
              */
@@ -441,27 +441,28 @@ long gu_fifo_max_length (gu_fifo_t* q)
 void gu_fifo_stats_get (gu_fifo_t* q, int* q_len, int* q_len_max,
                         int* q_len_min, double* q_len_avg)
 {
-    fifo_lock (q);
-
-    *q_len = q->used;
-    *q_len_max = q->used_max;
-    *q_len_min = q->used_min;
-
-    long long len     = q->q_len;
-    long long samples = q->q_len_samples;
-
-    fifo_unlock (q);
-
-    if (len >= 0 && samples >= 0) {
-        if (samples > 0)
-        {
-            *q_len_avg = ((double)len) / samples;
-        }
-        else
-        {
-            assert (0 == len);
-            *q_len_avg = 0.0;
-        }
+    /* lock-free monitoring snapshot: the queue lock is shared with the
+     * replication path, so the counters are read with atomic loads
+     * instead. The values may be mutually inconsistent by an operation
+     * or two, which is fine for statistics. */
+    uint      used, used_max, used_min;
+    long long len, samples;
+
+    gu_atomic_get (&q->used,     &used);
+    gu_atomic_get (&q->used_max, &used_max);
+    gu_atomic_get (&q->used_min, &used_min);
+    gu_atomic_get (&q->q_len,         &len);
+    gu_atomic_get (&q->q_len_samples, &samples);
+
+    *q_len     = used;
+    *q_len_max = used_max;
+    *q_len_min = used_min;
+
+    if (len >= 0 && samples > 0) {
+        *q_len_avg = ((double)len) / samples;
+    }
+    else if (len >= 0 && samples >= 0) {
+        *q_len_avg = 0.0;
     }
     else {
         *q_len_avg = -1.0;
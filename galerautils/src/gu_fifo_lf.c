@@ -0,0 +1,293 @@
+/*
+ * Copyright (C) 2017 Codership Oy <info@codership.com>
+ *
+ * Lock-free bounded queue (FIFO) class implementation
+ *
+ * Every slot carries a sequence counter. A producer claims a slot by
+ * advancing the shared tail with CAS when the slot counter says the
+ * slot is free, copies the item in, then publishes it by bumping the
+ * slot counter. Consumers mirror that at the head. The fast path is
+ * two atomic operations and a copy, with no syscalls: contending
+ * threads retry on the next position instead of parking on a mutex.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <sched.h>  // sched_yield()
+#include <string.h>
+#include <stdbool.h>
+
+#include "gu_assert.h"
+#include "gu_limits.h"
+#include "gu_mem.h"
+#include "gu_atomic.h"
+#include "gu_log.h"
+#include "gu_fifo_lf.h"
+
+#include "galerautils.h"
+
+struct gu_fifo_lf
+{
+    ulong     length;      /* number of slots, power of 2 */
+    ulong     length_mask;
+    size_t    item_size;
+    size_t    slot_size;   /* item size + sequence counter, aligned */
+    ulong     head;        /* next position to pop  */
+    ulong     tail;        /* next position to push */
+    int       closed;
+    long long q_len;         /* stats: sum of lengths over pushes */
+    long long q_len_samples;
+    uint      used_max;
+    uint      used_min;
+    uint8_t*  slots;
+};
+
+/* each slot starts with a ulong sequence counter followed by item data */
+static inline ulong*
+slot_seq (gu_fifo_lf_t* q, ulong pos)
+{
+    return (ulong*)(q->slots + (pos & q->length_mask) * q->slot_size);
+}
+
+static inline void*
+slot_item (gu_fifo_lf_t* q, ulong pos)
+{
+    return q->slots + (pos & q->length_mask) * q->slot_size + sizeof(ulong);
+}
+
+gu_fifo_lf_t*
+gu_fifo_lf_create (size_t length, size_t item_size)
+{
+    if (0 == length || 0 == item_size) return NULL;
+
+    ulong len = 2;
+    while (len < length && len != 0) len <<= 1;
+
+    if (0 == len || len > (ulong)GU_LONG_MAX) {
+        gu_error ("Requested FIFO length %zu exceeds max allowed", length);
+        return NULL;
+    }
+
+    /* keep the per-slot sequence counters naturally aligned */
+    size_t const slot_size =
+        (sizeof(ulong) + item_size + sizeof(ulong) - 1) / sizeof(ulong) *
+        sizeof(ulong);
+
+    gu_fifo_lf_t* const ret = gu_calloc (1, sizeof(gu_fifo_lf_t));
+
+    if (!ret) {
+        gu_error ("Failed to allocate FIFO object");
+        return NULL;
+    }
+
+    ret->slots = gu_calloc (len, slot_size);
+
+    if (!ret->slots) {
+        gu_error ("Failed to allocate %zu bytes for FIFO slots",
+                  len * slot_size);
+        gu_free (ret);
+        return NULL;
+    }
+
+    ret->length      = len;
+    ret->length_mask = len - 1;
+    ret->item_size   = item_size;
+    ret->slot_size   = slot_size;
+
+    /* slot with counter == position is free for the producer of that
+     * position, counter == position + 1 means it holds that item */
+    ulong i;
+    for (i = 0; i < len; i++) *slot_seq (ret, i) = i;
+
+    return ret;
+}
+
+void
+gu_fifo_lf_close (gu_fifo_lf_t* q)
+{
+    int closed = 1;
+    gu_atomic_set (&q->closed, &closed);
+}
+
+void
+gu_fifo_lf_open (gu_fifo_lf_t* q)
+{
+    int closed = 0;
+    gu_atomic_set (&q->closed, &closed);
+}
+
+void
+gu_fifo_lf_destroy (gu_fifo_lf_t* q)
+{
+    assert (q->head == q->tail);
+
+    gu_free (q->slots);
+    gu_free (q);
+}
+
+static inline int
+fifo_lf_closed (gu_fifo_lf_t* q)
+{
+    int closed;
+    gu_atomic_get (&q->closed, &closed);
+    return closed;
+}
+
+/* bump a watermark to val if it is beyond the current one */
+static inline void
+fifo_lf_watermark (uint* mark, uint val, bool up)
+{
+    uint cur;
+    gu_atomic_get (mark, &cur);
+    while ((up ? val > cur : val < cur) &&
+           !gu_atomic_bool_cas (mark, cur, val)) {
+        gu_atomic_get (mark, &cur);
+    }
+}
+
+int
+gu_fifo_lf_try_push (gu_fifo_lf_t* q, const void* item)
+{
+    if (gu_unlikely (fifo_lf_closed (q))) return -ENODATA;
+
+    ulong pos;
+    gu_atomic_get (&q->tail, &pos);
+
+    for (;;) {
+        ulong seq;
+        gu_atomic_get (slot_seq (q, pos), &seq);
+
+        long const dif = (long)(seq - pos);
+
+        if (0 == dif) {
+            /* slot free: claim the position */
+            if (gu_atomic_bool_cas (&q->tail, pos, pos + 1)) break;
+            pos++; /* lost the race, next position was at least claimed */
+        }
+        else if (dif < 0) {
+            return -EAGAIN; /* consumer has not freed this slot: full */
+        }
+        else {
+            gu_atomic_get (&q->tail, &pos); /* stale position, reload */
+        }
+    }
+
+    memcpy (slot_item (q, pos), item, q->item_size);
+    /* publish: consumer of this position waits for counter == pos + 1 */
+    ulong const seq = pos + 1;
+    gu_atomic_set (slot_seq (q, pos), &seq);
+
+    /* stats: racy by design, watermarks are advisory */
+    long const used = gu_fifo_lf_length (q);
+    gu_atomic_fetch_and_add (&q->q_len, used > 0 ? used - 1 : 0);
+    gu_atomic_fetch_and_add (&q->q_len_samples, 1);
+    fifo_lf_watermark (&q->used_max, used, true);
+
+    return 0;
+}
+
+int
+gu_fifo_lf_try_pop (gu_fifo_lf_t* q, void* item)
+{
+    ulong pos;
+    gu_atomic_get (&q->head, &pos);
+
+    for (;;) {
+        ulong seq;
+        gu_atomic_get (slot_seq (q, pos), &seq);
+
+        long const dif = (long)(seq - (pos + 1));
+
+        if (0 == dif) {
+            /* slot holds this position's item: claim it */
+            if (gu_atomic_bool_cas (&q->head, pos, pos + 1)) break;
+            pos++;
+        }
+        else if (dif < 0) {
+            return gu_unlikely (fifo_lf_closed (q)) ? -ENODATA : -EAGAIN;
+        }
+        else {
+            gu_atomic_get (&q->head, &pos);
+        }
+    }
+
+    memcpy (item, slot_item (q, pos), q->item_size);
+    /* free the slot for the producer one lap ahead */
+    ulong const seq = pos + q->length;
+    gu_atomic_set (slot_seq (q, pos), &seq);
+
+    long const used = gu_fifo_lf_length (q);
+    fifo_lf_watermark (&q->used_min, used > 0 ? used : 0, false);
+
+    return 0;
+}
+
+int
+gu_fifo_lf_push (gu_fifo_lf_t* q, const void* item)
+{
+    int ret;
+
+    while (-EAGAIN == (ret = gu_fifo_lf_try_push (q, item))) sched_yield();
+
+    return ret;
+}
+
+int
+gu_fifo_lf_pop (gu_fifo_lf_t* q, void* item)
+{
+    int ret;
+
+    while (-EAGAIN == (ret = gu_fifo_lf_try_pop (q, item))) sched_yield();
+
+    return ret;
+}
+
+long
+gu_fifo_lf_length (gu_fifo_lf_t* q)
+{
+    ulong head, tail;
+
+    gu_atomic_get (&q->head, &head);
+    gu_atomic_get (&q->tail, &tail);
+
+    long const len = (long)(tail - head);
+
+    return len > 0 ? len : 0;
+}
+
+long
+gu_fifo_lf_max_length (const gu_fifo_lf_t* q)
+{
+    return q->length;
+}
+
+void
+gu_fifo_lf_stats_get (gu_fifo_lf_t* q, int* q_len, int* q_len_max,
+                      int* q_len_min, double* q_len_avg)
+{
+    uint      used_max, used_min;
+    long long len, samples;
+
+    *q_len = gu_fifo_lf_length (q);
+
+    gu_atomic_get (&q->used_max, &used_max);
+    gu_atomic_get (&q->used_min, &used_min);
+    gu_atomic_get (&q->q_len, &len);
+    gu_atomic_get (&q->q_len_samples, &samples);
+
+    *q_len_max = used_max;
+    *q_len_min = used_min;
+    *q_len_avg = samples > 0 ? ((double)len) / samples : 0.0;
+}
+
+void
+gu_fifo_lf_stats_flush (gu_fifo_lf_t* q)
+{
+    uint const   used = gu_fifo_lf_length (q);
+    long long const z = 0;
+
+    gu_atomic_set (&q->used_max, &used);
+    gu_atomic_set (&q->used_min, &used);
+    gu_atomic_set (&q->q_len, &z);
+    gu_atomic_set (&q->q_len_samples, &z);
+}
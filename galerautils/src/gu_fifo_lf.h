@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2017 Codership Oy <info@codership.com>
+ *
+ * Lock-free bounded queue (FIFO) class definition
+ *
+ * A fixed-size multi-producer/multi-consumer queue that needs no mutex
+ * on push/pop: slot handover is done with per-slot sequence counters
+ * and atomic operations only (Vyukov-style bounded queue).
+ *
+ * Unlike gu_fifo it cannot hand out in-queue item pointers - a slot must
+ * be free for reuse the moment the counter is advanced - so the API is
+ * copy-in/copy-out. Usage watermarks and average length statistics
+ * follow gu_fifo semantics.
+ */
+
+#ifndef _gu_fifo_lf_h_
+#define _gu_fifo_lf_h_
+
+#include <errno.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct gu_fifo_lf gu_fifo_lf_t;
+
+/*! constructor: length is rounded up to a power of 2 */
+extern gu_fifo_lf_t* gu_fifo_lf_create (size_t length, size_t item_size);
+/*! puts FIFO into closed state: pushes fail, pops drain what is left */
+extern void gu_fifo_lf_close   (gu_fifo_lf_t* q);
+/*! (re)opens FIFO */
+extern void gu_fifo_lf_open    (gu_fifo_lf_t* q);
+/*! destructor - the queue must be closed and drained */
+extern void gu_fifo_lf_destroy (gu_fifo_lf_t* q);
+
+/*! Copies item into the queue tail, blocks (yielding) while full.
+ * @retval 0 or -ENODATA if the queue is closed */
+extern int  gu_fifo_lf_push     (gu_fifo_lf_t* q, const void* item);
+/*! Same as above, but returns -EAGAIN instead of blocking */
+extern int  gu_fifo_lf_try_push (gu_fifo_lf_t* q, const void* item);
+/*! Copies the head item out, blocks (yielding) while empty.
+ * @retval 0 or -ENODATA if the queue is closed and drained */
+extern int  gu_fifo_lf_pop      (gu_fifo_lf_t* q, void* item);
+/*! Same as above, but returns -EAGAIN instead of blocking */
+extern int  gu_fifo_lf_try_pop  (gu_fifo_lf_t* q, void* item);
+
+/*! Return how many items are in the queue (approximate) */
+extern long gu_fifo_lf_length     (gu_fifo_lf_t* q);
+/*! Returns the maximum number of items allowed in the queue */
+extern long gu_fifo_lf_max_length (const gu_fifo_lf_t* q);
+/*! Return usage watermarks and average length per push */
+extern void gu_fifo_lf_stats_get  (gu_fifo_lf_t* q, int* q_len,
+                                   int* q_len_max, int* q_len_min,
+                                   double* q_len_avg);
+/*! Flush stats counters */
+extern void gu_fifo_lf_stats_flush(gu_fifo_lf_t* q);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _gu_fifo_lf_h_ */
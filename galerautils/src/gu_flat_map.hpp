@@ -0,0 +1,336 @@
+//
+// Copyright (C) 2017 Codership Oy <info@codership.com>
+//
+
+//!
+// @file gu_flat_map.hpp open-addressing hash map
+//
+// A cache-friendly alternative to gu::UnorderedMap for hot lookup paths:
+// elements are stored in a single flat array probed linearly, so a lookup
+// costs one cache miss instead of a bucket node chase per element.
+// The interface mirrors gu::UnorderedMap so that containers can switch
+// with a typedef change.
+//
+// Differences from the node-based map that callers must be aware of:
+//  - element references and iterators are invalidated by insert()
+//    (the table may rehash) - not just by erase();
+//  - erased slots leave tombstones which are purged on the next rehash.
+//
+
+#ifndef GU_FLAT_MAP_HPP
+#define GU_FLAT_MAP_HPP
+
+#include "gu_unordered.hpp" // UnorderedHash
+#include "gu_types.hpp"     // byte_t
+#include "gu_macros.h"      // gu_unlikely()
+#include "gu_throw.hpp"
+
+#include <new>              // placement new
+#include <utility>
+#include <cstring>          // memset()
+
+namespace gu
+{
+    template <typename K, typename V, typename H = UnorderedHash<K>,
+              class P = std::equal_to<K> >
+    class UnorderedFlatMap
+    {
+    public:
+
+        typedef std::pair<const K, V> value_type;
+
+    private:
+
+        enum SlotState { S_EMPTY = 0, S_FULL, S_DELETED };
+
+        template <typename MapPtr, typename ValPtr>
+        class iter
+        {
+        public:
+
+            iter() : map_(0), idx_(0) {}
+
+            iter(MapPtr map, size_t idx) : map_(map), idx_(idx) {}
+
+            // also serves as iterator -> const_iterator conversion
+            template <typename MapPtr2, typename ValPtr2>
+            iter(const iter<MapPtr2, ValPtr2>& other)
+                : map_(other.map()), idx_(other.idx()) {}
+
+            ValPtr& operator* () const { return  map_->slots_[idx_]; }
+            ValPtr* operator->() const { return &map_->slots_[idx_]; }
+
+            iter& operator++()
+            {
+                idx_ = map_->next_full(idx_ + 1);
+                return *this;
+            }
+
+            iter operator++(int) { iter ret(*this); ++*this; return ret; }
+
+            bool operator==(const iter& other) const
+            {
+                return (map_ == other.map_ && idx_ == other.idx_);
+            }
+
+            bool operator!=(const iter& other) const
+            {
+                return !(*this == other);
+            }
+
+            MapPtr map() const { return map_; }
+            size_t idx() const { return idx_; }
+
+        private:
+
+            MapPtr map_;
+            size_t idx_;
+        };
+
+    public:
+
+        typedef iter<UnorderedFlatMap*, value_type>             iterator;
+        typedef iter<const UnorderedFlatMap*, const value_type> const_iterator;
+
+        UnorderedFlatMap()
+            : hash_(), eq_(), states_(0), slots_(0), capacity_(0),
+              size_(0), used_(0)
+        {}
+
+        UnorderedFlatMap(const UnorderedFlatMap& other)
+            : hash_(other.hash_), eq_(other.eq_), states_(0), slots_(0),
+              capacity_(0), size_(0), used_(0)
+        {
+            insert_all(other);
+        }
+
+        UnorderedFlatMap& operator=(const UnorderedFlatMap& other)
+        {
+            if (this != &other)
+            {
+                clear();
+                insert_all(other);
+            }
+            return *this;
+        }
+
+        ~UnorderedFlatMap()
+        {
+            clear();
+            deallocate();
+        }
+
+        iterator       begin()       { return iterator(this, next_full(0)); }
+        const_iterator begin() const
+        { return const_iterator(this, next_full(0)); }
+
+        iterator       end()         { return iterator(this, capacity_); }
+        const_iterator end()   const { return const_iterator(this,capacity_); }
+
+        std::pair<iterator, bool> insert(const std::pair<K, V>& kv)
+        {
+            if (gu_unlikely((used_ + 1) * 4 > capacity_ * 3)) grow();
+
+            size_t const mask(capacity_ - 1);
+            size_t idx(hash_(kv.first) & mask);
+            size_t ins(capacity_);
+
+            for (;;)
+            {
+                SlotState const s(SlotState(states_[idx]));
+
+                if (S_EMPTY == s)
+                {
+                    if (capacity_ == ins) ins = idx;
+                    break;
+                }
+
+                if (S_FULL == s && eq_(slots_[idx].first, kv.first))
+                {
+                    return std::pair<iterator, bool>(iterator(this, idx),
+                                                     false);
+                }
+
+                // remember the first tombstone to fill, but keep probing:
+                // the key may still be found further down the chain
+                if (S_DELETED == s && capacity_ == ins) ins = idx;
+
+                idx = (idx + 1) & mask;
+            }
+
+            used_ += (S_EMPTY == states_[ins]);
+            new (&slots_[ins]) value_type(kv.first, kv.second);
+            states_[ins] = S_FULL;
+            ++size_;
+
+            return std::pair<iterator, bool>(iterator(this, ins), true);
+        }
+
+        iterator insert_unique(const std::pair<K, V>& kv)
+        {
+            std::pair<iterator, bool> ret(insert(kv));
+            if (ret.second == false) gu_throw_fatal << "insert unique failed";
+            return ret.first;
+        }
+
+        iterator find(const K& key) { return iterator(this, find_idx(key)); }
+
+        const_iterator find(const K& key) const
+        {
+            return const_iterator(this, find_idx(key));
+        }
+
+        iterator erase(iterator i)
+        {
+            size_t const idx(i.idx());
+
+            slots_[idx].~value_type();
+            states_[idx] = S_DELETED; // tombstone, purged on next rehash
+            --size_;
+
+            return iterator(this, next_full(idx + 1));
+        }
+
+        size_t size()  const { return size_;      }
+        bool   empty() const { return 0 == size_; }
+
+        void clear()
+        {
+            for (size_t i(0); i < capacity_; ++i)
+            {
+                if (S_FULL == states_[i]) slots_[i].~value_type();
+            }
+
+            if (capacity_ > 0) ::memset (states_, S_EMPTY, capacity_);
+
+            size_ = 0;
+            used_ = 0;
+        }
+
+        void rehash(size_t n)
+        {
+            size_t const min_cap(min_capacity(size_));
+            rehash_to (capacity_for(n > min_cap ? n : min_cap));
+        }
+
+        void reserve(size_t n)
+        {
+            size_t const cap(capacity_for(min_capacity(n)));
+            if (cap > capacity_) rehash_to (cap);
+        }
+
+        size_t bucket_count() const { return capacity_; }
+
+    private:
+
+        static size_t const INITIAL_CAPACITY = 16;
+
+        /* minimum capacity to hold n elements at < 3/4 load factor */
+        static size_t min_capacity(size_t const n) { return n + n/3 + 1; }
+
+        /* next power of 2 >= n (and >= INITIAL_CAPACITY) */
+        static size_t capacity_for(size_t const n)
+        {
+            size_t ret(INITIAL_CAPACITY);
+            while (ret < n) ret <<= 1;
+            return ret;
+        }
+
+        size_t next_full(size_t idx) const
+        {
+            while (idx < capacity_ && states_[idx] != S_FULL) ++idx;
+            return idx;
+        }
+
+        /* returns capacity_ (== end()) if not found */
+        size_t find_idx(const K& key) const
+        {
+            if (gu_unlikely(0 == capacity_)) return capacity_;
+
+            size_t const mask(capacity_ - 1);
+            size_t idx(hash_(key) & mask);
+
+            while (states_[idx] != S_EMPTY)
+            {
+                if (S_FULL == states_[idx] && eq_(slots_[idx].first, key))
+                    return idx;
+
+                idx = (idx + 1) & mask;
+            }
+
+            return capacity_;
+        }
+
+        void grow()
+        {
+            /* if at least half of the occupied slots are tombstones,
+             * rehashing in place is enough */
+            rehash_to (capacity_for(size_ * 2 <= used_ ?
+                                    capacity_ : min_capacity(size_ * 2)));
+        }
+
+        void rehash_to(size_t const cap)
+        {
+            byte_t*     const old_states  (states_);
+            value_type* const old_slots   (slots_);
+            size_t      const old_capacity(capacity_);
+
+            states_ = static_cast<byte_t*>(::operator new(cap));
+            slots_  = static_cast<value_type*>(
+                ::operator new(cap * sizeof(value_type)));
+            ::memset (states_, S_EMPTY, cap);
+            capacity_ = cap;
+            used_     = size_;
+
+            size_t const mask(cap - 1);
+
+            for (size_t i(0); i < old_capacity; ++i)
+            {
+                if (S_FULL == old_states[i])
+                {
+                    size_t idx(hash_(old_slots[i].first) & mask);
+
+                    while (states_[idx] != S_EMPTY) idx = (idx + 1) & mask;
+
+                    new (&slots_[idx]) value_type(old_slots[i]);
+                    states_[idx] = S_FULL;
+
+                    old_slots[i].~value_type();
+                }
+            }
+
+            ::operator delete(old_states);
+            ::operator delete(old_slots);
+        }
+
+        void deallocate()
+        {
+            ::operator delete(states_);
+            ::operator delete(slots_);
+            states_   = 0;
+            slots_    = 0;
+            capacity_ = 0;
+        }
+
+        void insert_all(const UnorderedFlatMap& other)
+        {
+            reserve (other.size());
+
+            for (const_iterator i(other.begin()); i != other.end(); ++i)
+            {
+                insert (std::pair<K, V>(i->first, i->second));
+            }
+        }
+
+        H           hash_;
+        P           eq_;
+        byte_t*     states_;
+        value_type* slots_;
+        size_t      capacity_; // always a power of 2 (or 0 before first use)
+        size_t      size_;     // number of live elements
+        size_t      used_;     // live elements + tombstones
+    };
+
+} /* namespace gu */
+
+#endif // GU_FLAT_MAP_HPP
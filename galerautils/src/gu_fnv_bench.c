@@ -13,7 +13,13 @@
  * on CentOS some play with -lcrypto++ may be needed (also see includes below)
  *
  * To run:
- * gu_fnv_bench <buffer size> <N loops>
+ * gu_fnv_bench [<buffer size> [<N loops>]]
+ *
+ * Without arguments sweeps the size distribution writesets actually
+ * have (16-byte keys up to 10MB payloads), scaling the loop count so
+ * that every size processes the same byte volume. Note that
+ * gu_crc32c_configure() itself picks the CRC-32C implementation from
+ * startup measurements, see gu_crc32c.c.
  */
 
 #include "gu_crc32c.h"
@@ -211,25 +217,18 @@ static int timer (const void* const buf, ssize_t const len,
                    h ? "" : " ");
 }
 
-int main (int argc, char* argv[])
+static void bench_algs (const void* const buf, ssize_t const buf_size,
+                        long long const loops,
+                        CRC32CFunctionPtr const configured)
 {
-    ssize_t buf_size = (1<<20); // 1Mb
-    long long loops = 10000;
-
-    if (argc > 1) buf_size = strtoll (argv[1], NULL, 10);
-    if (argc > 2) loops    = strtoll (argv[2], NULL, 10);
-
-    /* initialization of data buffer */
-    ssize_t buf_size_int = buf_size / sizeof(int) + 1;
-    int* buf = (int*) malloc (buf_size_int * sizeof(int));
-    if (!buf) return ENOMEM;
-    while (buf_size_int) buf[--buf_size_int] = rand();
-
+    gu_crc32c_func = crc32cSlicingBy8;
     timer (buf, buf_size, loops, CRC32sw);
 
-    CRC32CFunctionPtr const old = gu_crc32c_func;
-    gu_crc32c_configure();
-    if (old != gu_crc32c_func) timer(buf, buf_size, loops, CRC32hw);
+    if (configured != crc32cSlicingBy8)
+    {
+        gu_crc32c_func = configured;
+        timer (buf, buf_size, loops, CRC32hw);
+    }
 
     timer (buf, buf_size, loops, FNV32);
     timer (buf, buf_size, loops, FNV64);
@@ -242,6 +241,51 @@ int main (int argc, char* argv[])
 //    timer (buf, buf_size, loops, MD5CPP);
     timer (buf, buf_size, loops, FAST128);
     timer (buf, buf_size, loops, TABLE);
+}
+
+int main (int argc, char* argv[])
+{
+    /* representative writeset size distribution: keys to payloads */
+    static ssize_t const sweep[] =
+        { 16, 40, 128, 1024, 16384, 262144, 1<<20, 10<<20 };
+    static size_t const sweep_len = sizeof(sweep)/sizeof(sweep[0]);
+
+    ssize_t   buf_size = 0; // 0 - sweep over the sizes above
+    long long loops    = 0; // 0 - scale to a fixed byte volume per size
+
+    if (argc > 1) buf_size = strtoll (argv[1], NULL, 10);
+    if (argc > 2) loops    = strtoll (argv[2], NULL, 10);
+
+    ssize_t const max_size = buf_size ? buf_size : sweep[sweep_len - 1];
+
+    /* initialization of data buffer */
+    ssize_t buf_size_int = max_size / sizeof(int) + 1;
+    int* buf = (int*) malloc (buf_size_int * sizeof(int));
+    if (!buf) return ENOMEM;
+    while (buf_size_int) buf[--buf_size_int] = rand();
+
+    gu_crc32c_configure(); // measured selection, see gu_crc32c.c
+    CRC32CFunctionPtr const configured = gu_crc32c_func;
+
+    if (buf_size)
+    {
+        bench_algs (buf, buf_size, loops ? loops : 10000, configured);
+    }
+    else
+    {
+        size_t i;
+
+        for (i = 0; i < sweep_len; i++)
+        {
+            /* equal byte volume per size to keep runtimes comparable */
+            long long const n = loops ? loops : (64LL<<20) / sweep[i];
+
+            printf ("--- %lld bytes:\n", (long long)sweep[i]);
+            bench_algs (buf, sweep[i], n, configured);
+        }
+    }
+
+    free (buf);
 
     return 0;
 }
@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2017 Codership Oy <info@codership.com>
+ */
+
+#include "gu_hdr_histogram.hpp"
+
+#include "gu_atomic.h"
+#include "gu_threads.h"
+#include "gu_macros.h"
+
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+static inline int
+msb_of (unsigned long long v)
+{
+#if defined(__GNUC__)
+    return 63 - __builtin_clzll(v);
+#else
+    int msb(0);
+    while (v >>= 1) msb++;
+    return msb;
+#endif
+}
+
+int
+gu::HdrHistogram::bin_of (long long value)
+{
+    unsigned long long const v(value);
+
+    if (gu_likely(v >= static_cast<unsigned long long>(SUB_COUNT)))
+    {
+        int const msb  (msb_of(v));
+        int const group(msb - SUB_BITS + 1);
+        int const sub  (static_cast<int>((v >> (msb - SUB_BITS)) &
+                                         (SUB_COUNT - 1)));
+        return (group << SUB_BITS) + sub;
+    }
+
+    return static_cast<int>(v); /* group 0: bins of width 1 */
+}
+
+long long
+gu::HdrHistogram::bin_value (int bin)
+{
+    int const group(bin >> SUB_BITS);
+    int const sub  (bin & (SUB_COUNT - 1));
+
+    if (0 == group) return sub;
+
+    int const msb(group + SUB_BITS - 1);
+
+    unsigned long long const low(
+        (1ULL << msb) + (static_cast<unsigned long long>(sub) <<
+                         (msb - SUB_BITS)));
+    unsigned long long const width(1ULL << (msb - SUB_BITS));
+
+    return static_cast<long long>(low + width/2);
+}
+
+gu::HdrHistogram::HdrHistogram()
+{
+    std::memset(counts_, 0, sizeof(counts_));
+}
+
+void
+gu::HdrHistogram::record (long long value)
+{
+    if (gu_unlikely(value < 0)) value = 0; /* clock skew artifact */
+
+    size_t const id(reinterpret_cast<size_t>(
+                        reinterpret_cast<const void*>(gu_thread_self())));
+    int const stripe(static_cast<int>((id ^ (id >> 12)) & (STRIPES - 1)));
+
+    gu_atomic_fetch_and_add (&counts_[stripe][bin_of(value)], 1LL);
+}
+
+long long
+gu::HdrHistogram::merge (long long* bins) const
+{
+    long long total(0);
+
+    for (int s(0); s < STRIPES; ++s)
+    {
+        for (int b(0); b < BINS; ++b)
+        {
+            long long cnt;
+            gu_atomic_get (&counts_[s][b], &cnt);
+            bins[b] += cnt;
+            total   += cnt;
+        }
+    }
+
+    return total;
+}
+
+long long
+gu::HdrHistogram::count() const
+{
+    std::vector<long long> bins(BINS, 0);
+    return merge(&bins[0]);
+}
+
+/* value of the bin where the cumulative count reaches given percentile */
+static long long
+value_at (const long long* bins, int n_bins, long long total, double prc,
+          long long (*bin_value)(int))
+{
+    long long const rank(
+        static_cast<long long>(double(total) * prc / 100.0 + 0.5));
+    long long cumulative(0);
+
+    for (int b(0); b < n_bins; ++b)
+    {
+        cumulative += bins[b];
+        if (cumulative >= rank) return bin_value(b);
+    }
+
+    return 0;
+}
+
+long long
+gu::HdrHistogram::percentile (double prc) const
+{
+    std::vector<long long> bins(BINS, 0);
+    long long const total(merge(&bins[0]));
+
+    if (0 == total) return 0;
+
+    return value_at (&bins[0], BINS, total, prc, &HdrHistogram::bin_value);
+}
+
+void
+gu::HdrHistogram::clear()
+{
+    long long const zero(0);
+
+    for (int s(0); s < STRIPES; ++s)
+    {
+        for (int b(0); b < BINS; ++b)
+        {
+            gu_atomic_set (&counts_[s][b], &zero);
+        }
+    }
+}
+
+std::string
+gu::HdrHistogram::to_string() const
+{
+    std::vector<long long> bins(BINS, 0);
+    long long const total(merge(&bins[0]));
+
+    if (0 == total) return "";
+
+    int max_bin(0);
+    for (int b(0); b < BINS; ++b) if (bins[b] > 0) max_bin = b;
+
+    std::ostringstream os;
+
+    os << "p50:" << value_at(&bins[0], BINS, total, 50.0, &bin_value)
+       << ",p90:" << value_at(&bins[0], BINS, total, 90.0, &bin_value)
+       << ",p99:" << value_at(&bins[0], BINS, total, 99.0, &bin_value)
+       << ",max:" << bin_value(max_bin);
+
+    return os.str();
+}
+
+std::ostream&
+gu::operator<< (std::ostream& os, const HdrHistogram& hs)
+{
+    return (os << hs.to_string());
+}
@@ -115,15 +115,25 @@ gu_log_cb_default (int severity, const char* msg)
  */
 gu_log_cb_t gu_log_cb = gu_log_cb_default;
 
+/**
+ * True when the message will ultimately be written by gu_log_cb_default
+ * and hence needs the severity prefix. Kept separate from gu_log_cb
+ * identity because the asynchronous sink (gu_log_async.c) wraps the
+ * callback without changing the final destination.
+ */
+bool gu_log_cb_default_final = true;
+
 int
 gu_conf_set_log_callback (gu_log_cb_t callback)
 {
     if (callback) {
         gu_debug ("Logging function changed by application");
         gu_log_cb = callback;
+        gu_log_cb_default_final = false;
     } else {
         gu_debug ("Logging function restored to default");
         gu_log_cb = gu_log_cb_default;
+        gu_log_cb_default_final = true;
     }
     return 0;
 }
@@ -150,7 +160,7 @@ gu_log (gu_log_severity_t severity,
 
     if (gu_likely(max_string > 0)) {
         const char* log_level_str =
-            gu_log_cb_default == gu_log_cb ? gu_log_level_str[severity] : "";
+            gu_log_cb_default_final ? gu_log_level_str[severity] : "";
 
         /* provide file:func():line info only if debug logging is on */
         if (gu_likely(!gu_log_debug && severity > GU_LOG_ERROR)) {
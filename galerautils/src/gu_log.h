@@ -97,6 +97,7 @@ extern "C"
 {
 extern bool        gu_log_self_tstamp;
 extern gu_log_cb_t gu_log_cb;
+extern bool        gu_log_cb_default_final;
 extern void        gu_log_cb_default (int, const char*);
 extern const char* gu_log_level_str[];
 }
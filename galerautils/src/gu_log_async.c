@@ -0,0 +1,184 @@
+// Copyright (C) 2017 Codership Oy <info@codership.com>
+
+/**
+ * @file Asynchronous logging sink implementation
+ *
+ * $Id$
+ */
+
+#define _DEFAULT_SOURCE // usleep()
+
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include "gu_log_async.h"
+#include "gu_log.h"
+#include "gu_fifo_lf.h"
+#include "gu_threads.h"
+#include "gu_atomic.h"
+#include "gu_macros.h"
+
+/* not exported through gu_log.h for C - see the __GU_LOGGER__ section there */
+extern gu_log_cb_t gu_log_cb;
+
+/* ring length and record size: 1024 x 1KiB slots = 1MiB of buffering,
+ * longer messages are truncated (formatting buffer in gu_log() is 2KiB,
+ * but messages of that size are practically unheard of) */
+#define LOG_ASYNC_RING_LEN 1024
+
+typedef struct log_record
+{
+    int  severity;
+    char msg[1016 - sizeof(int)]; /* whole record is 1016 bytes, which
+                                   * makes a 1KiB slot with the sequence
+                                   * counter (see gu_fifo_lf.c) */
+}
+log_record_t;
+
+static gu_fifo_lf_t* log_ring      = NULL;
+static gu_log_cb_t   underlying_cb = NULL;
+static gu_thread_t   flusher;
+
+static long long     dropped  = 0; /* total drops, updated by producers */
+static long long     reported = 0; /* drops already reported, flusher only */
+
+static void
+gu_log_async_cb (int severity, const char* msg)
+{
+    log_record_t rec;
+
+    if (gu_unlikely(GU_LOG_FATAL == severity))
+    {
+        /* the process is about to abort, this must hit the log now */
+        underlying_cb (severity, msg);
+        return;
+    }
+
+    if (gu_unlikely(gu_thread_equal (gu_thread_self(), flusher)))
+    {
+        /* the flusher's own messages (the drop report) must not re-enter
+         * the ring: producers may have refilled it since the empty pop
+         * and the report itself would then count as a drop */
+        underlying_cb (severity, msg);
+        return;
+    }
+
+    rec.severity = severity;
+    strncpy (rec.msg, msg, sizeof(rec.msg) - 1);
+    rec.msg[sizeof(rec.msg) - 1] = '\0';
+
+    if (gu_fifo_lf_try_push (log_ring, &rec))
+    {
+        /* full ring: drop rather than stall the caller */
+        gu_atomic_fetch_and_add (&dropped, 1);
+    }
+}
+
+static void*
+log_flusher (void* arg)
+{
+    (void)arg;
+
+    for (;;)
+    {
+        log_record_t rec;
+        long const err = gu_fifo_lf_try_pop (log_ring, &rec);
+
+        if (gu_likely(0 == err))
+        {
+            underlying_cb (rec.severity, rec.msg);
+            continue;
+        }
+
+        if (-ENODATA == err) break; /* ring closed and drained */
+
+        /* ring empty: a good moment to account for drops and to nap
+         * (the report is delivered synchronously - see the flusher
+         * thread check in gu_log_async_cb) */
+        {
+            long long drp;
+            gu_atomic_get (&dropped, &drp);
+            if (gu_unlikely(drp > reported))
+            {
+                gu_warn ("asynchronous logger dropped %lld message(s)",
+                         drp - reported);
+                reported = drp;
+                continue;
+            }
+        }
+
+        usleep (1000);
+    }
+
+    return NULL;
+}
+
+int
+gu_conf_async_log_on (void)
+{
+    int err;
+
+    if (log_ring) return 0;
+
+    log_ring = gu_fifo_lf_create (LOG_ASYNC_RING_LEN, sizeof(log_record_t));
+
+    if (!log_ring) return -ENOMEM;
+
+    underlying_cb = gu_log_cb;
+
+    err = gu_thread_create (&flusher, NULL, log_flusher, NULL);
+
+    if (err)
+    {
+        gu_fifo_lf_close   (log_ring);
+        gu_fifo_lf_destroy (log_ring);
+        log_ring = NULL;
+        return -err;
+    }
+
+    /* log while still synchronous - the module's own bookkeeping must
+     * not compete with application messages for ring slots */
+    gu_debug ("Asynchronous logging on");
+    gu_log_cb = gu_log_async_cb;
+
+    return 0;
+}
+
+int
+gu_conf_async_log_off (void)
+{
+    long long drp;
+
+    if (!log_ring) return 0;
+
+    gu_log_cb = underlying_cb;     /* new messages go synchronously again */
+
+    /* logged after the switch above: a full ring would otherwise count
+     * this very message as an application drop */
+    gu_debug ("Turning asynchronous logging off");
+
+    gu_fifo_lf_close (log_ring);   /* pushes fail, pops drain */
+    gu_thread_join   (flusher, NULL);
+
+    gu_atomic_get (&dropped, &drp);
+    if (drp > reported)
+    {
+        gu_warn ("asynchronous logger dropped %lld message(s)",
+                 drp - reported);
+        reported = drp;
+    }
+
+    gu_fifo_lf_destroy (log_ring);
+    log_ring = NULL;
+
+    return 0;
+}
+
+long long
+gu_log_async_dropped (void)
+{
+    long long ret;
+    gu_atomic_get (&dropped, &ret);
+    return ret;
+}
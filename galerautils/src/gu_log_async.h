@@ -0,0 +1,46 @@
+// Copyright (C) 2017 Codership Oy <info@codership.com>
+
+/**
+ * @file Asynchronous logging sink
+ *
+ * Decouples message formatting from the actual write: producers deposit
+ * preformatted records into a bounded lock-free ring (see gu_fifo_lf.h)
+ * and a dedicated flusher thread passes them to the underlying log
+ * callback. When the ring is full records are dropped and accounted for
+ * rather than stalling the caller, so the logging cost on hot paths is
+ * bounded regardless of how slow the log destination is.
+ *
+ * FATAL messages bypass the ring and are written synchronously - the
+ * process is about to abort and the message must not be lost.
+ *
+ * $Id$
+ */
+
+#ifndef _gu_log_async_h_
+#define _gu_log_async_h_
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*! Starts the flusher thread and installs the asynchronous sink on top
+ *  of the current log callback. No-op if already enabled.
+ *  @return 0 on success, negative error code otherwise */
+extern int
+gu_conf_async_log_on (void);
+
+/*! Restores the underlying log callback, drains the ring and stops the
+ *  flusher thread. No-op if not enabled.
+ *  @return 0 on success, negative error code otherwise */
+extern int
+gu_conf_async_log_off (void);
+
+/*! @return total number of messages dropped due to ring overflow */
+extern long long
+gu_log_async_dropped (void);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* _gu_log_async_h_ */
@@ -77,7 +77,13 @@ namespace gu
                                 const char* func,
                                 int         line)
         {
+#ifdef _gu_log_h_
+            // flag instead of callback identity: the message may go
+            // through the async sink wrapper (see gu_log_async.h)
+            if (gu_log_cb_default_final)
+#else
             if (default_logger == logger)
+#endif
             {
                 prepare_default();       // prefix with timestamp and log level
             }
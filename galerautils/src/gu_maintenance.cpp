@@ -0,0 +1,11 @@
+/*
+ * Copyright (C) 2026 Codership Oy <info@codership.com>
+ */
+
+#include "gu_maintenance.hpp"
+
+long long const gu::MaintenanceGauge::LULL_NS      (5000000LL);
+long long const gu::MaintenanceGauge::MAX_DEFER_NS (500000000LL);
+long long const gu::MaintenanceGauge::POLL_NS      (50000000LL);
+
+gu::MaintenanceGauge gu::MaintenanceGauge::process_;
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2026 Codership Oy <info@codership.com>
+ */
+
+/*! @file quiescence gauge for background maintenance
+ *
+ * Heavy background maintenance (certification index purge, page file
+ * retirement) used to run whenever its own backlog said so, sometimes
+ * colliding with a replication burst and showing up as periodic latency
+ * ripples. This gauge lets maintenance workers notice such bursts: the
+ * replication hot paths stamp the gauge on every processed writeset and
+ * a worker consults idle() before a heavy step, deferring it - within a
+ * bound - until the stamps stop coming.
+ *
+ * The foreground cost is one relaxed timestamp store, the gauge never
+ * blocks anybody, and deferral is always bounded, so maintenance cannot
+ * be starved by sustained load.
+ */
+
+#ifndef _gu_maintenance_hpp_
+#define _gu_maintenance_hpp_
+
+#include "gu_atomic.h"
+#include "gu_time.h"
+
+namespace gu
+{
+    class MaintenanceGauge
+    {
+    public:
+
+        /*! activity gap after which the process counts as quiescent */
+        static long long const LULL_NS;      /*   5ms */
+
+        /*! how long one maintenance step may be deferred under load */
+        static long long const MAX_DEFER_NS; /* 500ms */
+
+        /*! how often a deferring worker rechecks the gauge */
+        static long long const POLL_NS;      /*  50ms */
+
+        MaintenanceGauge() : last_active_(0) {}
+
+        /*! stamp foreground activity (replication send/apply paths) */
+        void touch()
+        {
+            long long now(gu_time_monotonic());
+            gu_atomic_set_relaxed(&last_active_, &now);
+        }
+
+        /*! true if no activity was stamped within the last lull_ns */
+        bool idle(long long lull_ns = LULL_NS) const
+        {
+            long long last;
+            gu_atomic_get_relaxed(&last_active_, &last);
+            return (gu_time_monotonic() - last >= lull_ns);
+        }
+
+        /*! the process-wide instance shared by all modules */
+        static MaintenanceGauge& process() { return process_; }
+
+    private:
+
+#if !defined(__ATOMIC_RELAXED)
+        // implementation of gu_atomic_get() via __sync_fetch_and_or()
+        // is not read-only for GCC
+        mutable
+#endif
+        long long last_active_; // gu_time_monotonic() of the last touch()
+
+        static MaintenanceGauge process_;
+    };
+}
+
+#endif /* _gu_maintenance_hpp_ */
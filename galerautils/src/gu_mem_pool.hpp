@@ -18,6 +18,7 @@
 
 #include <assert.h>
 
+#include <algorithm> // std::find
 #include <vector>
 #include <ostream>
 
@@ -168,7 +169,12 @@ namespace gu
     /* Thread-safe MemPool specialization.
      * Even though MemPool<true> technically IS-A MemPool<false>, the need to
      * overload nearly all public methods and practical uselessness of
-     * polymorphism in this case make inheritance undesirable. */
+     * polymorphism in this case make inheritance undesirable.
+     *
+     * Each thread keeps a small magazine of buffers in front of the shared
+     * pool, so that steady-state acquire()/recycle() never touch the pool
+     * mutex. The magazine exchanges half of its capacity with the shared
+     * pool when it runs empty or full. */
     template <>
     class MemPool<true>
     {
@@ -178,21 +184,55 @@ namespace gu
         MemPool(int buf_size, int reserve = 0, const char* name = "")
             :
             base_(buf_size, reserve, name),
+            magazines_(),
 #ifdef HAVE_PSI_INTERFACE
-            mtx_ (WSREP_PFS_INSTR_TAG_MEMPOOL_MUTEX)
+            mtx_ (WSREP_PFS_INSTR_TAG_MEMPOOL_MUTEX),
 #else
-            mtx_ ()
+            mtx_ (),
 #endif /* HAVE_PSI_INTERFACE */
-        {}
+            key_ ()
+        {
+            pthread_key_create(&key_, thread_exit_cb);
+        }
 
-        ~MemPool() {}
+        /* all threads using the pool must be done with it by the time the
+         * pool is destroyed, see base_ dtor accounting assert */
+        ~MemPool()
+        {
+            for (size_t i(0); i < magazines_.size(); ++i)
+            {
+                Magazine* const m(magazines_[i]);
+
+                while (m->count_ > 0)
+                {
+                    void* const buf(m->bufs_[--m->count_]);
+                    if (!base_.to_pool(buf)) base_.free(buf);
+                }
+
+                delete m;
+            }
+
+            pthread_key_delete(key_);
+        }
 
         void* acquire()
         {
+            Magazine& m(magazine());
+
+            if (gu_likely(m.count_ > 0)) return m.bufs_[--m.count_];
+
             void* ret;
 
             {
                 Lock lock(mtx_);
+
+                /* refill half a magazine while at it */
+                while (m.count_ < Magazine::MAX_BUFS/2 &&
+                       base_.pool_.size() > 0)
+                {
+                    m.bufs_[m.count_++] = base_.from_pool();
+                }
+
                 ret = base_.from_pool();
             }
 
@@ -203,32 +243,124 @@ namespace gu
 
         void recycle(void* buf)
         {
-            bool pooled;
+            Magazine& m(magazine());
+
+            if (gu_likely(m.count_ < Magazine::MAX_BUFS))
+            {
+                m.bufs_[m.count_++] = buf;
+                return;
+            }
+
+            /* magazine full: flush half of it into the shared pool */
+            void* drop[Magazine::MAX_BUFS + 1];
+            int   ndrop(0);
 
             {
                 Lock lock(mtx_);
-                pooled = base_.to_pool(buf);
+
+                while (m.count_ > Magazine::MAX_BUFS/2)
+                {
+                    void* const b(m.bufs_[--m.count_]);
+                    if (!base_.to_pool(b)) drop[ndrop++] = b;
+                }
+
+                if (!base_.to_pool(buf)) drop[ndrop++] = buf;
             }
 
-            if (!pooled) base_.free(buf);
+            while (ndrop > 0) base_.free(drop[--ndrop]);
         }
 
         void print(std::ostream& os) const
         {
             Lock lock(mtx_);
             base_.print(os);
+            os << ", magazines: " << magazines_.size();
         }
 
         size_t buf_size() const { return base_.buf_size(); }
 
     private:
 
-        MemPool<false> base_;
+        struct Magazine
+        {
+            static int const MAX_BUFS = 16;
+
+            MemPool<true>* const pool_; // for the thread exit callback
+            void* bufs_[MAX_BUFS];
+            int   count_;
+
+            Magazine(MemPool<true>* pool)
+                : pool_(pool), bufs_(), count_(0) {}
+
+        private:
+
+            Magazine (const Magazine&);
+            Magazine& operator= (const Magazine&);
+        };
+
+        /* runs at thread exit for threads that touched the pool: without
+         * it the magazine (and the buffers it holds) would be stranded,
+         * growing magazines_ without bound as threads come and go */
+        static void thread_exit_cb(void* p)
+        {
+            Magazine* const m(static_cast<Magazine*>(p));
+            m->pool_->retire(*m);
+        }
+
+        /* return magazine contents to the shared pool and drop the
+         * magazine from the bookkeeping */
+        void retire(Magazine& m)
+        {
+            void* drop[Magazine::MAX_BUFS];
+            int   ndrop(0);
+
+            {
+                Lock lock(mtx_);
+
+                while (m.count_ > 0)
+                {
+                    void* const b(m.bufs_[--m.count_]);
+                    if (!base_.to_pool(b)) drop[ndrop++] = b;
+                }
+
+                std::vector<Magazine*>::iterator const i(
+                    std::find(magazines_.begin(), magazines_.end(), &m));
+                assert(i != magazines_.end());
+                if (i != magazines_.end()) magazines_.erase(i);
+            }
+
+            while (ndrop > 0) base_.free(drop[--ndrop]);
+
+            delete &m;
+        }
+
+        /* returns calling thread's magazine, allocating it on first use */
+        Magazine& magazine()
+        {
+            void* p(pthread_getspecific(key_));
+
+            if (gu_unlikely(NULL == p))
+            {
+                Magazine* const m(new Magazine(this));
+                pthread_setspecific(key_, m);
+
+                Lock lock(mtx_);
+                magazines_.push_back(m);
+
+                p = m;
+            }
+
+            return *static_cast<Magazine*>(p);
+        }
+
+        MemPool<false>         base_;
+        std::vector<Magazine*> magazines_;
 #ifdef HAVE_PSI_INTERFACE
         gu::MutexWithPFS mtx_;
 #else
         gu::Mutex      mtx_;
 #endif /* HAVE_PSI_INTERFACE */
+        pthread_key_t          key_;
 
     }; /* class MemPool<true>: thread-safe */
 
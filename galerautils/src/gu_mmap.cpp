@@ -14,6 +14,9 @@
 
 #include <cerrno>
 #include <sys/mman.h>
+#if defined(__linux__)
+#include <sys/syscall.h> // SYS_mbind, SYS_get_mempolicy
+#endif
 #include <stdint.h>
 #include <stddef.h>
 #include <stdlib.h>
@@ -39,7 +42,8 @@ namespace gu
         size   (fd.size()),
         ptr    (mmap (NULL, size, PROT_READ|PROT_WRITE,
                       MAP_SHARED|MAP_NORESERVE, fd.get(), 0)),
-        mapped (ptr != GU_MAP_FAILED)
+        mapped (ptr != GU_MAP_FAILED),
+        locked_(0)
     {
         if (!mapped)
         {
@@ -84,6 +88,141 @@ namespace gu
         }
     }
 
+    void
+    MMap::sequential(bool const on) const
+    {
+        int const advice(on ? MADV_SEQUENTIAL : MADV_NORMAL);
+
+        if (posix_madvise(reinterpret_cast<char*>(ptr), size, advice))
+        {
+            log_warn << "Failed to set "
+                     << (on ? "MADV_SEQUENTIAL" : "MADV_NORMAL")
+                     << " on " << ptr << ": "
+                     << errno << " (" << strerror(errno) << ')';
+        }
+    }
+
+    void
+    MMap::hugepage(bool const on) const
+    {
+        /* MAP_HUGETLB does not apply here: the mapping is file-backed
+         * on a regular filesystem, and explicit hugepages work only on
+         * hugetlbfs. Transparent hugepage advice is the best that can
+         * be done, and on kernels that do not support it for this
+         * mapping the madvise() is a logged no-op. */
+#if defined(MADV_HUGEPAGE) && defined(MADV_NOHUGEPAGE)
+        int const advice(on ? MADV_HUGEPAGE : MADV_NOHUGEPAGE);
+
+        if (madvise(reinterpret_cast<char*>(ptr), size, advice))
+        {
+            int const err(errno);
+            log_warn << "Failed to set "
+                     << (on ? "MADV_HUGEPAGE" : "MADV_NOHUGEPAGE")
+                     << " on " << ptr << ": "
+                     << err << " (" << strerror(err) << ')';
+        }
+        else if (on)
+        {
+            log_info << "Advised transparent hugepages on " << size
+                     << " bytes mapping at " << ptr;
+        }
+#else
+        (void)on;
+        log_warn << "Transparent hugepage advice not supported "
+                    "on this platform";
+#endif
+    }
+
+    void
+    MMap::interleave (bool const on) const
+    {
+        /* mbind() and get_mempolicy() are plain syscalls, the libc
+         * wrappers live in libnuma which is not a dependency here, so
+         * call them directly with locally defined policy constants
+         * (values from numaif.h, part of the kernel ABI). */
+#if defined(__linux__) && defined(SYS_mbind) && defined(SYS_get_mempolicy)
+        static int const GU_MPOL_DEFAULT        = 0;
+        static int const GU_MPOL_INTERLEAVE     = 3;
+        static int const GU_MPOL_F_MEMS_ALLOWED = (1 << 2);
+
+        unsigned long nodemask[16] = { 0, };
+        unsigned long const maxnode(sizeof(nodemask) * 8);
+
+        long ret;
+
+        if (on)
+        {
+            /* interleave over whatever nodes the process is allowed
+             * to allocate from */
+            ret = syscall (SYS_get_mempolicy, NULL, nodemask, maxnode,
+                           NULL, GU_MPOL_F_MEMS_ALLOWED);
+
+            if (0 == ret)
+            {
+                ret = syscall (SYS_mbind, ptr, size, GU_MPOL_INTERLEAVE,
+                               nodemask, maxnode, 0);
+            }
+        }
+        else
+        {
+            ret = syscall (SYS_mbind, ptr, size, GU_MPOL_DEFAULT,
+                           NULL, 0, 0);
+        }
+
+        if (ret)
+        {
+            int const err(errno);
+            log_warn << "Failed to set "
+                     << (on ? "MPOL_INTERLEAVE" : "MPOL_DEFAULT")
+                     << " on " << ptr << ": "
+                     << err << " (" << strerror(err) << ')';
+        }
+        else if (on)
+        {
+            log_info << "Interleaving " << size
+                     << " bytes mapping at " << ptr << " over NUMA nodes";
+        }
+#else
+        (void)on;
+        log_warn << "NUMA memory policy not supported on this platform";
+#endif
+    }
+
+    void
+    MMap::lock_head (size_t length)
+    {
+        if (length > size) length = size;
+
+        if (length == locked_) return;
+
+        if (locked_ > 0 && munlock(ptr, locked_))
+        {
+            int const err(errno);
+            log_warn << "munlock(" << ptr << ", " << locked_
+                     << ") failed: " << err << " (" << strerror(err) << ')';
+        }
+
+        locked_ = 0;
+
+        if (length > 0)
+        {
+            if (mlock(ptr, length))
+            {
+                int const err(errno);
+                log_warn << "Failed to lock " << length
+                         << " bytes of the mapping in memory: " << err
+                         << " (" << strerror(err)
+                         << "), check RLIMIT_MEMLOCK";
+            }
+            else
+            {
+                locked_ = length;
+                log_info << "Locked first " << length
+                         << " bytes of the mapping in memory";
+            }
+        }
+    }
+
     void
     MMap::sync(void* const addr, size_t const length) const
     {
@@ -25,13 +25,31 @@ public:
     ~MMap ();
 
     void dont_need() const;
+    /* hint sequential access (aggressive read-ahead) for the whole
+     * mapping, or return to the default access pattern */
+    void sequential(bool on) const;
+    /* advise the kernel to back the mapping with transparent
+     * hugepages (or stop doing so) - cuts TLB misses on mappings of
+     * tens of gigabytes. Advice only, failure is logged, not thrown. */
+    void hugepage(bool on) const;
+    /* spread the mapping's pages round-robin over all allowed NUMA
+     * nodes (MPOL_INTERLEAVE), or return to the default first-touch
+     * policy. Affects pages faulted in after the call, so it should
+     * be applied right after mapping. Advice only, failure is logged,
+     * not thrown. */
+    void interleave(bool on) const;
+    /* mlock() the first length bytes of the mapping (the hot head
+     * region), unlocking whatever was locked before; 0 unlocks.
+     * Failure (usually RLIMIT_MEMLOCK) is logged, not thrown. */
+    void lock_head(size_t length);
     void sync(void *addr, size_t length) const;
     void sync() const;
     void unmap();
 
 private:
 
-    bool mapped;
+    bool   mapped;
+    size_t locked_; // length of the mlock()ed head region
 
     // This class is definitely non-copyable
     MMap (const MMap&);
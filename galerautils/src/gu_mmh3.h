@@ -284,6 +284,31 @@ gu_mmh128_32 (const void* const msg, size_t len)
     return (uint32_t)res[0];
 }
 
+/*! Hashes a batch of independent buffers in one call.
+ *  outs must have room for 16 bytes per buffer, hashes come out in the
+ *  same canonical byte order as gu_mmh128().
+ *
+ *  NOTE: this is a plain loop over the inlined single-buffer kernel.
+ *  MMH3 carries a serial dependency chain through every block of one
+ *  message, so there is nothing to vectorize within a single short key;
+ *  a SIMD win would need several keys processed in register lanes at
+ *  once, and this function is the seam where such a kernel would go.
+ *  Until call sites actually accumulate key batches it is not worth the
+ *  ISA dispatch machinery (cf. gu_crc32c, where a dedicated hardware
+ *  instruction pays off even per call). */
+static GU_INLINE void
+gu_mmh128_batch (const void* const* const msgs,
+                 const size_t*      const lens,
+                 size_t             const num,
+                 void*              const outs)
+{
+    size_t i;
+    for (i = 0; i < num; i++)
+    {
+        gu_mmh128 (msgs[i], lens[i], (uint8_t*)outs + (i << 4));
+    }
+}
+
 /*
  * Functions to hash message by parts
  * (only 128-bit version, 32-bit is not relevant any more)
@@ -14,6 +14,7 @@
 #define __GU_MONITOR_HPP__
 
 #include <gu_lock.hpp>
+#include <gu_atomic.hpp>
 
 #include <cassert>
 
@@ -23,9 +24,24 @@ namespace gu
     class Critical;
 }
 
+/* The critical sections guarded by the monitor are typically
+ * sub-microsecond, so a contending thread first spins for the flag and
+ * parks on the condition variable only when spinning does not pay off.
+ * The spin limit adapts: it grows when spinning acquires the monitor
+ * and shrinks when the thread ends up parking anyway, so on long
+ * occupancy the monitor degrades to plain blocking behavior. The
+ * uncontended path is a single compare-and-swap with no mutex
+ * acquisition at all. */
 class gu::Monitor
 {
-    int mutable refcnt;
+    static int const min_spin = 16;
+    static int const max_spin = 1 << 12;
+
+    gu::Atomic<int>       mutable busy;       // 0 - free, 1 - held
+    gu::Atomic<int>       mutable waiters;    // threads parked or parking
+    gu::Atomic<int>       mutable spin_limit;
+    gu::Atomic<long long> mutable spin_cnt;   // entries acquired by spinning
+    gu::Atomic<long long> mutable park_cnt;   // entries that had to block
 #ifdef HAVE_PSI_INTERFACE
     gu::MutexWithPFS mutex;
     gu::CondWithPFS  cond;
@@ -44,18 +60,49 @@ class gu::Monitor
     Monitor(const Monitor&);
     void operator=(const Monitor&);
 
+    bool try_enter() const
+    {
+        return (busy() == 0 && busy.bool_cas(0, 1));
+    }
+
+    void park() const
+    {
+        ++park_cnt;
+        int const limit(spin_limit());
+        if (limit > min_spin) spin_limit = limit / 2;
+
+        Lock lock(mutex);
+        // the waiter count is raised under the mutex before the final
+        // flag check, so leave() either sees it and signals under the
+        // same mutex or the flag is already free here
+        ++waiters;
+        while (!try_enter())
+        {
+            lock.wait(cond);
+        }
+        --waiters;
+    }
+
 public:
 
 #ifdef HAVE_PSI_INTERFACE
     Monitor(wsrep_pfs_instr_tag mtag, wsrep_pfs_instr_tag ctag)
         :
-        refcnt(0),
+        busy(0),
+        waiters(0),
+        spin_limit(min_spin),
+        spin_cnt(0),
+        park_cnt(0),
         mutex(mtag),
         cond(ctag)
 #else
     Monitor()
         :
-        refcnt(0),
+        busy(0),
+        waiters(0),
+        spin_limit(min_spin),
+        spin_cnt(0),
+        park_cnt(0),
         mutex(),
         cond()
 #endif /* HAVE_PSI_INTERFACE */
@@ -68,15 +115,28 @@ public:
 
     void enter() const
     {
-        Lock lock(mutex);
-
-// Teemu, pthread_equal() check seems redundant, refcnt too (counted in cond)
-//        while (refcnt > 0 && pthread_equal(holder, pthread_self()) == 0)
-        while (refcnt)
+        if (!try_enter())
         {
-            lock.wait(cond);
+            int const limit(spin_limit());
+            int i(0);
+
+            while (i < limit && !try_enter())
+            {
+                cpu_relax();
+                ++i;
+            }
+
+            if (i < limit)
+            {
+                // spinning paid off, allow a little more of it next time
+                ++spin_cnt;
+                if (limit < max_spin) spin_limit = limit * 2;
+            }
+            else
+            {
+                park();
+            }
         }
-        refcnt++;
 #ifndef NDEBUG
         holder = gu_thread_self();
 #endif
@@ -84,17 +144,22 @@ public:
 
     void leave() const
     {
-        Lock lock(mutex);
-
-        assert(refcnt > 0);
+        assert(busy() == 1);
         assert(gu_thread_equal(holder, gu_thread_self()) != 0);
 
-        refcnt--;
-        if (refcnt == 0)
+        busy = 0; // full barrier, releases the monitor
+
+        if (waiters() > 0)
         {
+            // the mutex is taken so that the wakeup cannot slip in
+            // between a parking thread's last flag check and its wait
+            Lock lock(mutex);
             cond.signal();
         }
     }
+
+    long long spin_count() const { return spin_cnt(); }
+    long long park_count() const { return park_cnt(); }
 };
 
 class gu::Critical
@@ -9,12 +9,24 @@
 #include "gu_macros.h"
 #include "gu_threads.h"
 #include "gu_throw.hpp"
+#include "gu_atomic.h"
 
+#include <cassert>
 #include <cerrno>
 #include <cstring>
 
 namespace gu
 {
+    /*! yield the pipeline to a hyperthread sibling inside a busy-wait */
+    static inline void cpu_relax()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __asm__ __volatile__("rep; nop" ::: "memory"); // PAUSE
+#else
+        __asm__ __volatile__("" ::: "memory");
+#endif
+    }
+
     class Mutex
     {
     public:
@@ -115,6 +127,94 @@ namespace gu
     };
 #endif /* HAVE_PSI_INTERFACE */
 
+    /*! Test-and-test-and-set spinlock with exponential backoff, for
+     *  critical sections of tens of nanoseconds (free list pops,
+     *  pointer compares) where the park/unpark round trip of a pthread
+     *  mutex costs more than the whole section. Never hold one across
+     *  anything that can block, and there is deliberately no condition
+     *  variable support - use Mutex for that. */
+    class SpinLock
+    {
+    public:
+
+        SpinLock() : locked_(0)
+#ifndef NDEBUG
+                   , owner_()
+#endif
+        { }
+
+        ~SpinLock() { assert(0 == locked_); }
+
+        void lock() const
+        {
+            int backoff(1);
+
+            while (gu_unlikely(!try_lock()))
+            {
+                do
+                {
+                    for (int i(0); i < backoff; ++i) cpu_relax();
+                    if (backoff < max_backoff) backoff *= 2;
+                }
+                while (0 != locked_); // test before test-and-set
+            }
+#ifndef NDEBUG
+            owner_ = gu_thread_self();
+#endif
+        }
+
+        void unlock() const
+        {
+            assert(owned());
+#ifndef NDEBUG
+            owner_ = gu_thread_t();
+#endif
+            int unlocked(0);
+            gu_atomic_set(&locked_, &unlocked);
+        }
+
+#ifndef NDEBUG
+        bool owned() const
+        {
+            return (gu_thread_equal(owner_, gu_thread_self()) != 0);
+        }
+#endif
+
+    private:
+
+        bool try_lock() const
+        {
+            return (0 == locked_ && gu_atomic_bool_cas(&locked_, 0, 1));
+        }
+
+        static int const max_backoff = 1 << 10;
+
+        int mutable volatile locked_;
+#ifndef NDEBUG
+        gu_thread_t mutable  owner_;
+#endif
+
+        SpinLock (const SpinLock&);
+        SpinLock& operator= (const SpinLock&);
+    };
+
+    /*! scoped holder for SpinLock, counterpart of Lock for Mutex */
+    class SpinGuard
+    {
+    public:
+
+        SpinGuard(const SpinLock& sl) : sl_(sl) { sl_.lock(); }
+
+        ~SpinGuard() { sl_.unlock(); }
+
+    private:
+
+        const SpinLock& sl_;
+
+        SpinGuard (const SpinGuard&);
+        SpinGuard& operator= (const SpinGuard&);
+    };
+
     class RecursiveMutex
     {
     public:
@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2017 Codership Oy <info@codership.com>
+ */
+
+/*!
+ * @file permanent USDT tracepoints
+ *
+ * When built on a system with <sys/sdt.h> (systemtap-sdt-dev) each
+ * probe compiles to a single nop plus an ELF note, so the tracepoints
+ * are always on and essentially free until a tracer (perf, bpftrace,
+ * systemtap) attaches - no rebuild needed in production.
+ *
+ * All probes use provider name "galera". Nanosecond timestamps are
+ * taken by the tracer at the probe site; the arguments carry trx ids
+ * and seqnos for correlating one transaction across threads, e.g.
+ *
+ *   perf probe -x libgalera_smm.so sdt_galera:apply_enter
+ *   bpftrace -e 'usdt:libgalera_smm.so:galera:apply_enter { ... }'
+ *
+ * Without <sys/sdt.h> the macros expand to nothing.
+ */
+
+#ifndef _gu_probes_h_
+#define _gu_probes_h_
+
+#if defined(HAVE_SYS_SDT_H)
+
+#include <sys/sdt.h>
+
+#define GU_PROBE(name)              DTRACE_PROBE(galera, name)
+#define GU_PROBE1(name, a1)         DTRACE_PROBE1(galera, name, a1)
+#define GU_PROBE2(name, a1, a2)     DTRACE_PROBE2(galera, name, a1, a2)
+#define GU_PROBE3(name, a1, a2, a3) DTRACE_PROBE3(galera, name, a1, a2, a3)
+
+#else /* !HAVE_SYS_SDT_H */
+
+#define GU_PROBE(name)
+#define GU_PROBE1(name, a1)
+#define GU_PROBE2(name, a1, a2)
+#define GU_PROBE3(name, a1, a2, a3)
+
+#endif /* HAVE_SYS_SDT_H */
+
+#endif /* _gu_probes_h_ */
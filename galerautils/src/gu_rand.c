@@ -13,6 +13,10 @@
 
 #include "gu_rand.h"
 #include "gu_hash.h"
+#include "gu_time.h"
+
+#include <stdbool.h>
+#include <unistd.h> // for getpid()
 
 /*! Structure to hold entropy data.
  *  Should be at least 20 bytes on 32-bit systems and 28 bytes on 64-bit */
@@ -44,3 +48,55 @@ gu_rand_seed_int  (long long time, const void* heap_ptr, pid_t pid)
 }
 
 #endif /* GU_WORDSIZE == 32 */
+
+/* per-thread xorshift128+ state, lazily seeded on the first draw */
+static __thread uint64_t rand_state[2];
+static __thread bool     rand_seeded = false;
+
+/* SplitMix64 step: expands a single seed word into well-mixed state words
+ * and guarantees the state never ends up all-zero */
+static uint64_t
+rand_mix (uint64_t z)
+{
+    z += 0x9e3779b97f4a7c15ULL;
+    z  = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z  = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+static void
+rand_seed (void)
+{
+    /* rand_state address is thread-local, so concurrently starting threads
+     * get distinct seeds even with identical time and pid */
+    uint64_t const s =
+        gu_rand_seed_long (gu_time_calendar(), rand_state, getpid());
+
+    rand_state[0] = rand_mix (s);
+    rand_state[1] = rand_mix (rand_state[0]);
+    rand_seeded   = true;
+}
+
+uint64_t
+gu_rand64 (void)
+{
+    uint64_t s0, s1;
+
+    if (!rand_seeded) rand_seed();
+
+    s1 = rand_state[0];
+    s0 = rand_state[1];
+
+    rand_state[0] = s0;
+    s1 ^= s1 << 23;
+    rand_state[1] = s1 ^ s0 ^ (s1 >> 18) ^ (s0 >> 5);
+
+    return rand_state[1] + s0;
+}
+
+uint64_t
+gu_rand64_bounded (uint64_t limit)
+{
+    /* modulo bias is negligible for the jitter/backoff draws this serves */
+    return gu_rand64() % limit;
+}
@@ -2,12 +2,14 @@
 
 /**
  * @file routines to generate "random" seeds for RNGs by collecting some easy
- *       entropy.
+ *       entropy, and a fast per-thread pseudorandom generator built on them.
  *
  * gu_rand_seed_long() goes for srand48()
  *
  * gu_rand_seed_int()  goes for srand() and rand_r()
  *
+ * gu_rand64()         draws from a per-thread xorshift128+ generator
+ *
  * $Id$
  */
 
@@ -16,8 +18,13 @@
 
 #include "gu_arch.h"
 
+#include <stdint.h>    // for uint64_t
 #include <sys/types.h> // for pid_t
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 extern long int
 gu_rand_seed_long (long long time, const void* heap_ptr, pid_t pid);
 
@@ -32,4 +39,20 @@ gu_rand_seed_int  (long long time, const void* heap_ptr, pid_t pid);
 
 #endif /* GU_WORDSIZE */
 
+/*! Returns the next value from a per-thread xorshift128+ generator.
+ *  The state lives in thread-local storage and is lazily seeded on the
+ *  first draw, so a draw costs a few cycles and never touches shared
+ *  state. Not suitable for cryptographic purposes. */
+extern uint64_t
+gu_rand64 (void);
+
+/*! Like gu_rand64(), but returns a value in [0, limit).
+ *  limit must be positive. */
+extern uint64_t
+gu_rand64_bounded (uint64_t limit);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* _gu_rand_h_ */
@@ -0,0 +1,31 @@
+// Copyright (C) 2015 Codership Oy <info@codership.com>
+
+/**
+ * @file C++ face of the per-thread pseudorandom generator from gu_rand.h
+ *
+ * $Id$
+ */
+
+#ifndef _gu_rand_hpp_
+#define _gu_rand_hpp_
+
+#include "gu_rand.h"
+
+namespace gu
+{
+    /* Draws come from per-thread xorshift128+ state: a few cycles each,
+     * no sharing, no locks, so they are safe on hot paths. Not suitable
+     * for cryptographic purposes. */
+    class Random
+    {
+    public:
+
+        /*! next pseudorandom 64-bit value */
+        static uint64_t next() { return gu_rand64(); }
+
+        /*! next pseudorandom value in [0, limit), limit must be positive */
+        static uint64_t next(uint64_t limit) { return gu_rand64_bounded(limit); }
+    };
+}
+
+#endif /* _gu_rand_hpp_ */
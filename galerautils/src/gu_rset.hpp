@@ -91,7 +91,11 @@ public:
     /*! return number of disjoint pages in the record set */
     ssize_t page_count() const { return bufs_->size(); }
 
-    /*! return vector of RecordSet fragments in adjusent order */
+    /*! return vector of RecordSet fragments in adjusent order.
+     *  NOTE: the payload checksum is accumulated incrementally as records
+     *  are appended (while the data is still cache-hot), so this involves
+     *  no extra pass over the records - only the header gets digested and
+     *  written out here. */
     ssize_t gather (GatherVector& out);
 
 protected:
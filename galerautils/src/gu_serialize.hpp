@@ -167,6 +167,115 @@ namespace gu
         return __private_unserialize<uint64_t>(buf, buflen, offset, t);
     }
 
+    /*
+     * Field group serialization. Fixed format message headers write a
+     * dozen scalar fields in a row and each of the operations above
+     * pays its own bounds check with a throw path behind it. For such
+     * groups check the buffer space once with check_bounds() and use
+     * the *_unchecked variants below, which compile to straight
+     * byteswap loads/stores. Never use them without a preceding check
+     * covering the whole group.
+     */
+    GU_FORCE_INLINE void check_bounds(size_t const end, size_t const buflen)
+    {
+        if (gu_unlikely(end > buflen))
+        {
+            gu_throw_error(EMSGSIZE) << end << " > " << buflen;
+        }
+    }
+
+    /* Should not be used directly! */
+    template <typename TO, typename FROM>
+    inline size_t
+    __private_serialize_unchecked(const FROM& f, void* const buf,
+                                  size_t const offset)
+    {
+        GU_COMPILE_ASSERT(std::numeric_limits<TO>::is_integer, not_integer1);
+        GU_COMPILE_ASSERT(std::numeric_limits<FROM>::is_integer, not_integer2);
+        GU_COMPILE_ASSERT(sizeof(FROM) == sizeof(TO), size_differs);
+        void* const pos(reinterpret_cast<byte_t*>(buf) + offset);
+        *reinterpret_cast<TO*>(pos) = htog<TO>(f);
+        return offset + sizeof(TO);
+    }
+
+    /* Should not be used directly! */
+    template <typename FROM, typename TO>
+    inline size_t
+    __private_unserialize_unchecked(const void* const buf,
+                                    size_t const offset, TO& t)
+    {
+        GU_COMPILE_ASSERT(std::numeric_limits<TO>::is_integer, not_integer1);
+        GU_COMPILE_ASSERT(std::numeric_limits<FROM>::is_integer, not_integer2);
+        GU_COMPILE_ASSERT(sizeof(FROM) == sizeof(TO), size_differs);
+        const void* const pos(reinterpret_cast<const byte_t*>(buf) + offset);
+        t = gtoh<FROM>(*reinterpret_cast<const FROM*>(pos));
+        return offset + sizeof(FROM);
+    }
+
+    template <typename T>
+    GU_FORCE_INLINE size_t serialize1_unchecked(const T&     t,
+                                                void*  const buf,
+                                                size_t const offset)
+    {
+        return __private_serialize_unchecked<uint8_t>(t, buf, offset);
+    }
+
+    template <typename T>
+    GU_FORCE_INLINE size_t unserialize1_unchecked(const void* const buf,
+                                                  size_t      const offset,
+                                                  T&                t)
+    {
+        return __private_unserialize_unchecked<uint8_t>(buf, offset, t);
+    }
+
+    template <typename T>
+    GU_FORCE_INLINE size_t serialize2_unchecked(const T&     t,
+                                                void*  const buf,
+                                                size_t const offset)
+    {
+        return __private_serialize_unchecked<uint16_t>(t, buf, offset);
+    }
+
+    template <typename T>
+    GU_FORCE_INLINE size_t unserialize2_unchecked(const void* const buf,
+                                                  size_t      const offset,
+                                                  T&                t)
+    {
+        return __private_unserialize_unchecked<uint16_t>(buf, offset, t);
+    }
+
+    template <typename T>
+    GU_FORCE_INLINE size_t serialize4_unchecked(const T&     t,
+                                                void*  const buf,
+                                                size_t const offset)
+    {
+        return __private_serialize_unchecked<uint32_t>(t, buf, offset);
+    }
+
+    template <typename T>
+    GU_FORCE_INLINE size_t unserialize4_unchecked(const void* const buf,
+                                                  size_t      const offset,
+                                                  T&                t)
+    {
+        return __private_unserialize_unchecked<uint32_t>(buf, offset, t);
+    }
+
+    template <typename T>
+    GU_FORCE_INLINE size_t serialize8_unchecked(const T&     t,
+                                                void*  const buf,
+                                                size_t const offset)
+    {
+        return __private_serialize_unchecked<uint64_t>(t, buf, offset);
+    }
+
+    template <typename T>
+    GU_FORCE_INLINE size_t unserialize8_unchecked(const void* const buf,
+                                                  size_t      const offset,
+                                                  T&                t)
+    {
+        return __private_unserialize_unchecked<uint64_t>(buf, offset, t);
+    }
+
     template <typename ST>
     inline size_t __private_serial_size(const Buffer& sb)
     {
@@ -70,3 +70,99 @@ std::ostream& gu::operator<<(std::ostream& os, const gu::Stats& stats)
             << stats.std_dev() << "/"
             << stats.times());
 }
+
+// Jain & Chlamtac: "The P^2 algorithm for dynamic calculation of
+// quantiles and histograms without storing observations", CACM 1985.
+
+void gu::Quantile::init(double prc)
+{
+    prc_ = prc;
+    cnt_ = 0;
+
+    for (int i = 0; i < 5; ++i)
+    {
+        q_[i]    = 0.0;
+        pos_[i]  = i;
+    }
+
+    npos_[0] = 0.0;
+    npos_[1] = 2.0*prc;
+    npos_[2] = 4.0*prc;
+    npos_[3] = 2.0 + 2.0*prc;
+    npos_[4] = 4.0;
+}
+
+void gu::Quantile::insert(double val)
+{
+    if (gu_unlikely(cnt_ < 5))
+    {
+        q_[cnt_++] = val;
+        if (5 == cnt_) std::sort(q_, q_ + 5);
+        return;
+    }
+
+    int k;
+
+    if (val < q_[0])      { q_[0] = val; k = 0; }
+    else if (val >= q_[4]) { q_[4] = val; k = 3; }
+    else for (k = 0; val >= q_[k + 1]; ++k) {}
+
+    for (int i = k + 1; i < 5; ++i) pos_[i]++;
+
+    npos_[1] += prc_/2.0;
+    npos_[2] += prc_;
+    npos_[3] += (1.0 + prc_)/2.0;
+    npos_[4] += 1.0;
+
+    for (int i = 1; i <= 3; ++i)
+    {
+        double const d(npos_[i] - pos_[i]);
+
+        if ((d >=  1.0 && pos_[i + 1] - pos_[i] >  1) ||
+            (d <= -1.0 && pos_[i - 1] - pos_[i] < -1))
+        {
+            int const s(d >= 0.0 ? 1 : -1);
+
+            // parabolic prediction (P^2), fall back to linear when it
+            // would break marker ordering
+            double const qp(
+                q_[i] + double(s) / (pos_[i + 1] - pos_[i - 1]) *
+                ((pos_[i] - pos_[i - 1] + s) * (q_[i + 1] - q_[i]) /
+                 (pos_[i + 1] - pos_[i]) +
+                 (pos_[i + 1] - pos_[i] - s) * (q_[i] - q_[i - 1]) /
+                 (pos_[i] - pos_[i - 1])));
+
+            if (q_[i - 1] < qp && qp < q_[i + 1])
+            {
+                q_[i] = qp;
+            }
+            else
+            {
+                q_[i] = q_[i] + double(s) * (q_[i + s] - q_[i]) /
+                    (pos_[i + s] - pos_[i]);
+            }
+
+            pos_[i] += s;
+        }
+    }
+
+    cnt_++;
+}
+
+double gu::Quantile::value() const
+{
+    if (gu_likely(cnt_ >= 5)) return q_[2];
+
+    if (0 == cnt_) return 0.0;
+
+    // too few observations for the estimator: answer from the sample
+    double tmp[5];
+    std::copy(q_, q_ + cnt_, tmp);
+    std::sort(tmp, tmp + cnt_);
+
+    int idx(static_cast<int>(std::ceil(prc_ * cnt_)) - 1);
+    if (idx < 0) idx = 0;
+    if (idx >= static_cast<int>(cnt_)) idx = cnt_ - 1;
+
+    return tmp[idx];
+}
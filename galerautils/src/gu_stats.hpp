@@ -41,6 +41,49 @@ namespace gu
     };
 
     std::ostream& operator<<(std::ostream&, const Stats&);
+
+    /*!
+     * Streaming estimator for a single quantile using the P-square
+     * algorithm (Jain & Chlamtac, CACM 1985): five markers are adjusted
+     * on every observation so no samples are stored. The estimate is
+     * exact until five values have been seen.
+     *
+     * The class is deliberately trivial (plain doubles, no bases) so it
+     * can be embedded in C-style malloc'ed structs and brought to a
+     * defined state with init().
+     */
+    class Quantile
+    {
+    public:
+        /*! For embedding in aggregates - call init() before use */
+        Quantile() : prc_(), cnt_(), q_(), npos_(), pos_() { init(0.5); }
+
+        explicit Quantile(double prc)
+            : prc_(), cnt_(), q_(), npos_(), pos_()
+        {
+            init(prc);
+        }
+
+        /*! (Re)initialize for given quantile, 0 < prc < 1 (e.g. 0.99) */
+        void init(double prc);
+
+        /*! Drop accumulated state, keep the quantile */
+        void clear() { init(prc_); }
+
+        void insert(double value);
+
+        /*! Current estimate, 0 if nothing was inserted */
+        double value() const;
+
+        unsigned int times() const { return cnt_; }
+
+    private:
+        double       prc_;
+        unsigned int cnt_;
+        double       q_[5];    // marker heights
+        double       npos_[5]; // desired marker positions
+        int          pos_[5];  // actual marker positions
+    };
 }
 
 #endif // _gu_stats_hpp_
@@ -103,49 +103,71 @@ public:
 
     StringBase& operator<< (const long long &i)
     {
-        convert ("%lld", 21, i);
+        if (gu_likely(NULL == fmt_)) append_signed (i);
+        else convert ("%lld", 21, i);
         return *this;
     }
 
     StringBase& operator<< (const unsigned long long &i)
     {
-        convert ("%llu", 20, i);
+        if (gu_likely(NULL == fmt_)) append_unsigned (i);
+        else convert ("%llu", 20, i);
+        return *this;
+    }
+
+    StringBase& operator<< (const long &i)
+    {
+        if (gu_likely(NULL == fmt_)) append_signed (i);
+        else convert ("%ld", 21, i);
+        return *this;
+    }
+
+    StringBase& operator<< (const unsigned long &i)
+    {
+        if (gu_likely(NULL == fmt_)) append_unsigned (i);
+        else convert ("%lu", 20, i);
         return *this;
     }
 
     StringBase& operator<< (const int &i)
     {
-        convert ("%d", 11, i);
+        if (gu_likely(NULL == fmt_)) append_signed (i);
+        else convert ("%d", 11, i);
         return *this;
     }
 
     StringBase& operator<< (const unsigned int &i)
     {
-        convert ("%u", 10, i);
+        if (gu_likely(NULL == fmt_)) append_unsigned (i);
+        else convert ("%u", 10, i);
         return *this;
     }
 
     StringBase& operator<< (const short &i)
     {
-        convert ("%hd", 6, i);
+        if (gu_likely(NULL == fmt_)) append_signed (i);
+        else convert ("%hd", 6, i);
         return *this;
     }
 
     StringBase& operator<< (const unsigned short &i)
     {
-        convert ("%hu", 5, i);
+        if (gu_likely(NULL == fmt_)) append_unsigned (i);
+        else convert ("%hu", 5, i);
         return *this;
     }
 
     StringBase& operator<< (const char &c)
     {
-        convert ("%c", 1, c);
+        if (gu_likely(NULL == fmt_)) append_string (&c, 1);
+        else convert ("%c", 1, c);
         return *this;
     }
 
     StringBase& operator<< (const unsigned char &c)
     {
-        convert ("%hhu", 3, c);
+        if (gu_likely(NULL == fmt_)) append_unsigned (c);
+        else convert ("%hhu", 3, c);
         return *this;
     }
 
@@ -204,6 +226,29 @@ protected:
         str_[size_] = 0;
     }
 
+    /* direct integer-to-chars conversion for the default format: fills a
+     * small stack buffer backwards, so the common path of streaming many
+     * values (status snapshots, log lines) skips snprintf() entirely.
+     * A custom Fmt still goes through convert(). */
+    void append_unsigned (unsigned long long x)
+    {
+        char  tmp[20]; // fits 2^64 - 1
+        char* p(tmp + sizeof(tmp));
+        do { *(--p) = char('0' + x % 10); x /= 10; } while (x);
+        append_string (p, tmp + sizeof(tmp) - p);
+    }
+
+    void append_signed (long long x)
+    {
+        if (x < 0)
+        {
+            append_string ("-", 1);
+            /* negate in unsigned domain: -LLONG_MIN overflows */
+            append_unsigned (0ULL - static_cast<unsigned long long>(x));
+        }
+        else append_unsigned (x);
+    }
+
     template <typename X>
     void convert (const char* const format, size_type max_len, const X& x)
     {
@@ -7,10 +7,19 @@
 #include "gu_utils.hpp"
 #include "gu_string_utils.hpp"
 #include "gu_throw.hpp"
+#include "gu_lock.hpp"
 
+#include <algorithm>
 #include <iostream>
+#include <map>
 #include <vector>
 
+#include <time.h>
+
+#if defined(__linux__)
+#include <sched.h> // cpu_set_t
+#endif
+
 static std::string const SCHED_OTHER_STR  ("other");
 static std::string const SCHED_FIFO_STR   ("fifo");
 static std::string const SCHED_RR_STR     ("rr");
@@ -66,6 +75,151 @@ void gu::ThreadSchedparam::print(std::ostream& os) const
     os << policy_str << ":" << prio();
 }
 
+gu::ThreadAffinity::ThreadAffinity(const std::string& param)
+    :
+    cpus_()
+{
+    if (param == "") return;
+
+    std::vector<std::string> sv(gu::strsplit(param, ','));
+
+    for (size_t i(0); i < sv.size(); ++i)
+    {
+        std::string::size_type const dash(sv[i].find('-'));
+
+        int begin, end;
+
+        try
+        {
+            if (dash == std::string::npos)
+            {
+                begin = end = gu::from_string<int>(sv[i]);
+            }
+            else
+            {
+                begin = gu::from_string<int>(sv[i].substr(0, dash));
+                end   = gu::from_string<int>(sv[i].substr(dash + 1));
+            }
+        }
+        catch (gu::NotFound&)
+        {
+            gu_throw_error(EINVAL) << "Invalid CPU index: " << sv[i];
+        }
+
+        if (begin < 0 || end < begin)
+        {
+            gu_throw_error(EINVAL) << "Invalid CPU range: " << sv[i];
+        }
+
+        for (int cpu(begin); cpu <= end; ++cpu) cpus_.push_back(cpu);
+    }
+
+    std::sort(cpus_.begin(), cpus_.end());
+    cpus_.erase(std::unique(cpus_.begin(), cpus_.end()), cpus_.end());
+}
+
+void gu::ThreadAffinity::print(std::ostream& os) const
+{
+    for (size_t i(0); i < cpus_.size(); ++i)
+    {
+        if (i > 0) os << ',';
+        os << cpus_[i];
+    }
+}
+
+namespace
+{
+    // Sample a per-thread CPU clock, in nanoseconds
+    static inline long long cpu_clock_ns(clockid_t cid)
+    {
+        struct timespec ts;
+        if (clock_gettime(cid, &ts) != 0) return 0;
+        return (ts.tv_sec * 1000000000LL + ts.tv_nsec);
+    }
+
+    struct CpuEntry
+    {
+        std::string role;
+        clockid_t   cid;
+
+        CpuEntry() : role(), cid() { }
+    };
+
+    // Registry of live worker threads plus CPU time retired by exited
+    // ones, keyed by role name. All access is under mutex; the maps
+    // stay small (a handful of long-lived threads) and are only walked
+    // when a status snapshot is taken.
+    class CpuRegistry
+    {
+    public:
+        CpuRegistry() : mutex_(), live_(), retired_() { }
+
+        void insert(const std::string& role)
+        {
+            clockid_t cid;
+            // if the platform cannot provide a per-thread clock the
+            // thread simply remains unaccounted
+            if (pthread_getcpuclockid(pthread_self(), &cid) != 0) return;
+
+            CpuEntry entry;
+            entry.role = role;
+            entry.cid  = cid;
+
+            gu::Lock lock(mutex_);
+            live_[pthread_self()] = entry;
+        }
+
+        void erase()
+        {
+            gu::Lock lock(mutex_);
+            std::map<pthread_t, CpuEntry>::iterator
+                i(live_.find(pthread_self()));
+            if (i == live_.end()) return;
+            // fold final CPU time into the retired total so that the
+            // role counter never goes backwards
+            retired_[i->second.role] += cpu_clock_ns(i->second.cid);
+            live_.erase(i);
+        }
+
+        long long role_ns(const std::string& role)
+        {
+            gu::Lock lock(mutex_);
+            long long ret(0);
+            std::map<std::string, long long>::const_iterator
+                r(retired_.find(role));
+            if (r != retired_.end()) ret = r->second;
+            for (std::map<pthread_t, CpuEntry>::const_iterator
+                     i(live_.begin()); i != live_.end(); ++i)
+            {
+                if (i->second.role == role) ret += cpu_clock_ns(i->second.cid);
+            }
+            return ret;
+        }
+
+    private:
+        gu::Mutex                        mutex_;
+        std::map<pthread_t, CpuEntry>    live_;
+        std::map<std::string, long long> retired_;
+    };
+
+    static CpuRegistry cpu_registry;
+}
+
+void gu::thread_cpu_register(const std::string& role)
+{
+    cpu_registry.insert(role);
+}
+
+void gu::thread_cpu_unregister()
+{
+    cpu_registry.erase();
+}
+
+long long gu::thread_cpu_ns(const std::string& role)
+{
+    return cpu_registry.role_ns(role);
+}
+
 gu::ThreadSchedparam gu::thread_get_schedparam(pthread_t thd)
 {
     int policy;
@@ -91,3 +245,32 @@ void gu::thread_set_schedparam(pthread_t thd, const gu::ThreadSchedparam& sp)
         gu_throw_error(err) << "Failed to set thread schedparams " << sp;
     }
 }
+
+void gu::thread_set_affinity(pthread_t thd, const gu::ThreadAffinity& af)
+{
+    if (af.empty()) return;
+
+#if defined(__linux__)
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+
+    const std::vector<int>& cpus(af.cpus());
+
+    for (size_t i(0); i < cpus.size(); ++i)
+    {
+        if (cpus[i] >= CPU_SETSIZE)
+        {
+            gu_throw_error(EINVAL) << "CPU index out of range: " << cpus[i];
+        }
+        CPU_SET(cpus[i], &cpuset);
+    }
+
+    int err;
+    if ((err = pthread_setaffinity_np(thd, sizeof(cpuset), &cpuset)) != 0)
+    {
+        gu_throw_error(err) << "Failed to set thread affinity " << af;
+    }
+#else
+    gu_throw_error(ENOSYS) << "Thread affinity not supported on this platform";
+#endif // __linux__
+}
@@ -12,6 +12,7 @@
 #include "gu_threads.h"
 
 #include <string>
+#include <vector>
 
 namespace gu
 {
@@ -83,6 +84,45 @@ namespace gu
         int prio_;   // Scheduling priority
     };
 
+    //
+    // Wrapper class for thread CPU affinity.
+    //
+    class ThreadAffinity
+    {
+    public:
+        //
+        // Default constructor. Initializes to empty CPU set, which
+        // means no binding (scheduler is free to migrate the thread).
+        //
+        ThreadAffinity()
+            :
+            cpus_()
+        { }
+
+        //
+        // Construct ThreadAffinity from given string representation
+        // which must be a comma separated list of CPU indexes and
+        // inclusive ranges, e.g.
+        //
+        //  0-3,8,10
+        //
+        // An empty string results in an empty CPU set.
+        //
+        ThreadAffinity(const std::string& param);
+
+        // Return list of CPU indexes the thread may run on
+        const std::vector<int>& cpus() const { return cpus_; }
+
+        // Return true if no binding was requested
+        bool empty() const { return cpus_.empty(); }
+
+        void print(std::ostream& os) const;
+
+    private:
+
+        std::vector<int> cpus_; // CPU indexes, ascending
+    };
+
     //
     // Return current scheduling parameters for given thread
     //
@@ -95,6 +135,34 @@ namespace gu
     //
     void thread_set_schedparam(gu_thread_t thread, const ThreadSchedparam&);
 
+    //
+    // Bind given thread to the CPU set. Empty set is a no-op.
+    //
+    // Throws gu::Exception if binding fails or is not supported
+    // on the platform.
+    //
+    void thread_set_affinity(gu_thread_t thread, const ThreadAffinity&);
+
+    //
+    // Per-role CPU time accounting for long-lived worker threads.
+    //
+    // A worker registers itself under a role name ("protonet",
+    // "applier", ...) when it starts and unregisters before exiting.
+    // thread_cpu_ns() samples the per-thread CPU clocks of all live
+    // threads of the role and adds time retired by exited ones, so
+    // the sampling cost is paid by the observer and the workers run
+    // uninstrumented.
+    //
+
+    // Register the calling thread under given role
+    void thread_cpu_register  (const std::string& role);
+
+    // Remove the calling thread from accounting, retiring its CPU time
+    void thread_cpu_unregister();
+
+    // Return cumulative CPU time of the role in nanoseconds
+    long long thread_cpu_ns   (const std::string& role);
+
     //
     // Insertion operator for ThreadSchedparam
     //
@@ -103,6 +171,15 @@ namespace gu
     {
         sp.print(os); return os;
     }
+
+    //
+    // Insertion operator for ThreadAffinity
+    //
+    inline std::ostream& operator<<(std::ostream& os,
+                                    const gu::ThreadAffinity& af)
+    {
+        af.print(os); return os;
+    }
 }
 
 
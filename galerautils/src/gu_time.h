@@ -101,6 +101,22 @@ gu_time_monotonic()
 #endif
 }
 
+/*! Coarse monotonic clock: reads the kernel-cached timestamp where the
+ *  platform provides one (a few ms resolution, no hardware clock access).
+ *  Meant for frequent stats/bookkeeping reads on hot paths; use
+ *  gu_time_monotonic() for timeout arithmetic that needs fresh time. */
+static inline long long
+gu_time_monotonic_coarse()
+{
+#if defined(CLOCK_MONOTONIC_COARSE)
+    struct timespec tmp;
+    clock_gettime (CLOCK_MONOTONIC_COARSE, &tmp);
+    return ((tmp.tv_sec * 1000000000LL) + tmp.tv_nsec);
+#else
+    return gu_time_monotonic();
+#endif
+}
+
 #ifdef CLOCK_PROCESS_CPUTIME_ID
 static inline long long
 gu_time_process_cputime()
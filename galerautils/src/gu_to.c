@@ -152,27 +152,20 @@ long gu_to_destroy (gu_to_t** to)
     return 0;
 }
 
-long gu_to_grab (gu_to_t* to, gu_seqno_t seqno)
+/** Grab logic proper, called with to->lock held (and released over the
+ *  cond wait as usual) */
+static long to_grab (gu_to_t* to, gu_seqno_t seqno)
 {
-    long err;
+    long err = 0;
     to_waiter_t *w;
 
-    assert (seqno >= 0);
-
-    if ((err = gu_mutex_lock(&to->lock))) {
-        gu_fatal("Mutex lock failed (%d): %s", err, strerror(err));
-        abort();
-    }
-
     if (seqno < to->seqno) {
-        gu_mutex_unlock(&to->lock);
         return -ECANCELED;
     }
 
     if ((w = to_get_waiter (to, seqno)) == NULL) {
-        gu_mutex_unlock(&to->lock);
         return -EAGAIN;
-    }        
+    }
     /* we have a valid waiter now */
 
     switch (w->state) {
@@ -230,11 +223,64 @@ long gu_to_grab (gu_to_t* to, gu_seqno_t seqno)
         gu_fatal("TO queue over wrap");
         abort();
     }
-    
+
+    return err;
+}
+
+long gu_to_grab (gu_to_t* to, gu_seqno_t seqno)
+{
+    long err;
+
+    assert (seqno >= 0);
+
+    if ((err = gu_mutex_lock(&to->lock))) {
+        gu_fatal("Mutex lock failed (%d): %s", err, strerror(err));
+        abort();
+    }
+
+    err = to_grab (to, seqno);
+
     gu_mutex_unlock(&to->lock);
     return err;
 }
 
+long gu_to_grab_range (gu_to_t* to, gu_seqno_t first, gu_seqno_t last,
+                       gu_seqno_t* grabbed)
+{
+    long        err;
+    gu_seqno_t  s;
+
+    assert (first >= 0);
+    assert (first <= last);
+    assert (grabbed != NULL);
+
+    if ((err = gu_mutex_lock(&to->lock))) {
+        gu_fatal("Mutex lock failed (%d): %s", err, strerror(err));
+        abort();
+    }
+
+    if ((err = to_grab (to, first))) {
+        gu_mutex_unlock(&to->lock);
+        return err;
+    }
+
+    /* claim as many consecutive free seqnos as possible in the same
+     * lock cycle; stop at queue end or at a seqno somebody else has
+     * touched (waiting, canceled or interrupted) */
+    for (s = first + 1; s <= last; s++) {
+        to_waiter_t* w = to_get_waiter (to, s);
+
+        if (w == NULL || w->state != RELEASED) break;
+
+        w->state = HOLDER;
+    }
+
+    *grabbed = s - 1;
+
+    gu_mutex_unlock(&to->lock);
+    return 0;
+}
+
 static inline long
 to_wake_waiter (to_waiter_t* w)
 {
@@ -308,6 +354,55 @@ long gu_to_release (gu_to_t *to, gu_seqno_t seqno)
     return err;
 }
 
+long gu_to_release_range (gu_to_t* to, gu_seqno_t first, gu_seqno_t last)
+{
+    long         err;
+    to_waiter_t* w;
+    gu_seqno_t   s;
+
+    assert (first >= 0);
+    assert (first <= last);
+
+    if ((err = gu_mutex_lock(&to->lock))) {
+        gu_fatal("Mutex lock failed (%d): %s", err, strerror(err));
+        abort();
+    }
+
+    if (first != to->seqno) {
+        gu_error("Out of order batch release: first seqno %llu, "
+                 "TO seqno %llu", first, to->seqno);
+        gu_mutex_unlock(&to->lock);
+        return -ERANGE;
+    }
+
+    if (to_get_waiter (to, last) == NULL) {
+        gu_mutex_unlock(&to->lock);
+        return -EAGAIN;
+    }
+    /* the whole range maps to valid waiters now */
+
+    for (s = first; s < last; s++) {
+        w = to_get_waiter (to, s);
+
+        if (w->state != HOLDER && w->state != CANCELED &&
+            w->state != RELEASED) {
+            gu_fatal("Illegal state in batch release: %d, seqno %llu",
+                     w->state, s);
+            abort();
+        }
+
+        w->state  = RELEASED;
+        to->seqno = s + 1;
+    }
+
+    /* the last seqno of the range wakes the next waiter beyond it */
+    to_release_and_wake_next (to, to_get_waiter (to, last));
+
+    gu_mutex_unlock(&to->lock);
+
+    return 0;
+}
+
 gu_seqno_t gu_to_seqno (gu_to_t* to)
 {
     return to->seqno - 1;
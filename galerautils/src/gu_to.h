@@ -75,6 +75,41 @@ extern long gu_to_grab (gu_to_t* to, gu_seqno_t seqno);
  */
 extern long gu_to_release (gu_to_t* to, gu_seqno_t seqno);
 
+/*! @brief Grabs a range of TO resources with a single lock cycle.
+ * Waits for the turn of first just like gu_to_grab(), then extends the
+ * hold over the following seqnos as long as they are still untouched,
+ * stopping early at the first one some other thread is waiting on (or
+ * has canceled) and at the end of the queue. Grabbed ranges must be
+ * released with gu_to_release_range() and, like with release, no other
+ * thread may grab or cancel seqnos within the claimed range.
+ *
+ * @param to      TO resource to be acquired.
+ * @param first   The first seqno of the desired range, @see gu_to_grab().
+ * @param last    The last seqno of the desired range (inclusive).
+ * @param grabbed On success, the last seqno actually claimed
+ *                (first <= grabbed <= last).
+ * @return 0 in case of success (at least first was grabbed), otherwise
+ *         the gu_to_grab() error code for first.
+ */
+extern long gu_to_grab_range (gu_to_t* to, gu_seqno_t first, gu_seqno_t last,
+                              gu_seqno_t* grabbed);
+
+/*! @brief Releases a range of TO resources with a single lock cycle.
+ * Equivalent to releasing every seqno in [first, last] in order, but
+ * takes the queue lock once and wakes the next waiter only after the
+ * whole range has been advanced. The caller must own the range: first
+ * must be the current TO seqno and no other thread may be grabbing
+ * seqnos within the range (canceled waiters are fine).
+ *
+ * @param to    TO resource that was previously acquired with gu_to_grab().
+ * @param first The first seqno of the owned range.
+ * @param last  The last seqno of the owned range (inclusive).
+ * @return 0 in case of success, negative code in case of error.
+ *         -ERANGE if first is not the current TO seqno.
+ */
+extern long gu_to_release_range (gu_to_t* to, gu_seqno_t first,
+                                 gu_seqno_t last);
+
 /*! @brief The last sequence number that had been used to access TO object.
  * Note that since no locks are held, it is a conservative estimation.
  * It is guaranteed however that returned seqno is no longer in use.
@@ -97,6 +97,7 @@ namespace gu
         void clear() { impl_.clear(); }
         void rehash(size_t n) { impl_.rehash(n); }
         size_t bucket_count() { return impl_.bucket_count(); }
+        size_t bucket_size(size_t n) { return impl_.bucket_size(n); }
     };
 
 
@@ -12,10 +12,14 @@
 #include <cerrno>
 #include <vector>
 
+#include <map>
+#include <utility>
+
 #include "gu_assert.h"
 #include "gu_throw.hpp"
 #include "gu_logger.hpp"
 #include "gu_string_utils.hpp" // strsplit()
+#include "gu_lock.hpp"
 
 #include "gu_uri.hpp"
 
@@ -121,6 +125,53 @@ static gu::URIQueryList extract_query_list(const string& s,
     return ret;
 }
 
+namespace
+{
+    /* Cache of parsed URIs. Addresses are passed around as plain
+     * strings and reconstructed as URIs over and over (gmcast keeps
+     * peer addresses as string keys), and every parse costs a regex
+     * match plus authority splitting. Successfully parsed URIs are
+     * memoized here keyed by the raw string, so re-parsing a known
+     * address is a map lookup and a member copy. The cache is bounded
+     * and simply dropped when full; distinct URI strings are few in
+     * practice (peer addresses and option sets). */
+    typedef std::map<std::pair<std::string, bool>, gu::URI> URICacheMap;
+
+    class URICache
+    {
+    public:
+
+        URICache() : mtx_(), map_() { }
+
+        bool lookup(const std::string& str, bool const strict, gu::URI& uri)
+        {
+            gu::Lock lock(mtx_);
+            URICacheMap::const_iterator const i(
+                map_.find(std::make_pair(str, strict)));
+            if (i == map_.end()) return false;
+            uri = i->second;
+            return true;
+        }
+
+        void store(const std::string& str, bool const strict,
+                   const gu::URI& uri)
+        {
+            gu::Lock lock(mtx_);
+            if (map_.size() >= max_size_) map_.clear();
+            map_.insert(std::make_pair(std::make_pair(str, strict), uri));
+        }
+
+    private:
+
+        static size_t const max_size_ = 128;
+
+        gu::Mutex   mtx_;
+        URICacheMap map_;
+    };
+
+    URICache uri_cache;
+}
+
 gu::URI::URI(const string& uri_str, bool const strict)
     :
     modified_  (true), // recompose to normalize on the first call to_string()
@@ -131,7 +182,11 @@ gu::URI::URI(const string& uri_str, bool const strict)
     fragment_  (),
     query_list_()
 {
-    parse(uri_str, strict);
+    if (uri_cache.lookup(uri_str, strict, *this) == false)
+    {
+        parse(uri_str, strict);
+        uri_cache.store(uri_str, strict, *this);
+    }
 }
 
 /*! regexp suggested by RFC 3986 to parse URI into 5 canonical parts */
@@ -17,7 +17,6 @@
 #include "gu_time.h"
 #include "gu_rand.h"
 
-#include <stdlib.h>   // for rand_r()
 #include <string.h>   // for memcmp()
 #include <stdio.h>    // for fopen() et al
 #include <sys/time.h> // for gettimeofday()
@@ -83,17 +82,16 @@ uuid_urand_node (uint8_t* node, size_t node_len)
 #define uuid_urand_node(a,b) true
 #endif
 
-/** Fills node part with pseudorandom data from rand_r() */
+/** Fills node part with pseudorandom data from gu_rand64() */
 static void
 uuid_rand_node (uint8_t* node, size_t node_len)
 {
-    unsigned int seed = gu_rand_seed_int (gu_time_calendar(), node, getpid());
-    size_t       i;
+    size_t i;
 
-    for (i = 0; i < node_len; i++) {
-        uint32_t r = (uint32_t) rand_r (&seed);
-        /* combine all bytes into the lowest byte */
-        node[i] = (uint8_t)((r) ^ (r >> 8) ^ (r >> 16) ^ (r >> 24));
+    for (i = 0; i < node_len; i += sizeof(uint64_t)) {
+        uint64_t     r = gu_rand64();
+        size_t const n = node_len - i < sizeof(r) ? node_len - i : sizeof(r);
+        memcpy (node + i, &r, n);
     }
 }
 
@@ -144,7 +142,23 @@ long
 gu_uuid_compare (const gu_uuid_t* left,
                  const gu_uuid_t* right)
 {
-    return memcmp (left, right, sizeof(gu_uuid_t));
+    /* two word compares instead of a byte-wise memcmp(); the UUID is
+     * stored as a BE integer, so byte order equals numeric order and
+     * a swap to host order preserves it. memcpy() because the struct
+     * is only byte-aligned - compiles to plain loads. */
+    uint64_t l, r;
+
+    memcpy (&l, left->data,  sizeof(l));
+    memcpy (&r, right->data, sizeof(r));
+
+    if (l != r) return (gu_be64(l) < gu_be64(r) ? -1 : 1);
+
+    memcpy (&l, left->data  + sizeof(l), sizeof(l));
+    memcpy (&r, right->data + sizeof(r), sizeof(r));
+
+    if (l != r) return (gu_be64(l) < gu_be64(r) ? -1 : 1);
+
+    return 0;
 }
 
 static uint64_t
@@ -14,6 +14,8 @@
 
 #include "gu_types.h"
 
+#include <string.h> // memcpy() in gu_uuid_equal()
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -74,6 +76,22 @@ extern long
 gu_uuid_compare (const gu_uuid_t* left,
                  const gu_uuid_t* right);
 
+/*!
+ * Equality check as two word compares - cheaper than full comparison
+ * when the order is not needed (map lookups, message source checks).
+ * memcpy() rather than a cast since gu_uuid_t is only byte-aligned;
+ * compilers turn it into two plain loads.
+ */
+static inline bool
+gu_uuid_equal (const gu_uuid_t* left,
+               const gu_uuid_t* right)
+{
+    uint64_t l[2], r[2];
+    memcpy (l, left->data,  sizeof(l));
+    memcpy (r, right->data, sizeof(r));
+    return (l[0] == r[0] && l[1] == r[1]);
+}
+
 /*!
  * Compare ages of two UUIDs
  * @return -1, 0, 1 if left is respectively younger, equal or older than right
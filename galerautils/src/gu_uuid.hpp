@@ -9,13 +9,14 @@
 #include "gu_uuid.h"
 #include "gu_assert.hpp"
 #include "gu_buffer.hpp"
+#include "gu_string.hpp"
 #include "gu_throw.hpp"
 
 #include <iostream>
 
 inline bool operator==(const gu_uuid_t& a, const gu_uuid_t& b)
 {
-    return gu_uuid_compare(&a, &b) == 0;
+    return gu_uuid_equal(&a, &b);
 }
 
 inline bool operator!=(const gu_uuid_t& a, const gu_uuid_t& b)
@@ -33,6 +34,30 @@ inline std::ostream& operator<<(std::ostream& os, const gu_uuid_t& uuid)
     return (os << uuid_buf);
 }
 
+/*! Writes canonical UUID representation directly into a char buffer of at
+ *  least GU_UUID_STR_LEN + 1 bytes, bypassing snprintf(). Returns buf. */
+inline const char* gu_uuid_to_chars(const gu_uuid_t& uuid, char* buf)
+{
+    static const char hex[] = "0123456789abcdef";
+    char* p(buf);
+
+    for (int i(0); i < GU_UUID_LEN; ++i)
+    {
+        *(p++) = hex[uuid.data[i] >> 4];
+        *(p++) = hex[uuid.data[i] & 0x0f];
+        if (3 == i || 5 == i || 7 == i || 9 == i) *(p++) = '-';
+    }
+
+    *p = '\0';
+    return buf;
+}
+
+inline gu::StringBase<>& operator<<(gu::StringBase<>& s, const gu_uuid_t& uuid)
+{
+    char uuid_buf[GU_UUID_STR_LEN + 1];
+    return (s << gu_uuid_to_chars(uuid, uuid_buf));
+}
+
 inline ssize_t gu_uuid_from_string(const std::string& s, gu_uuid_t& uuid)
 {
     ssize_t ret(gu_uuid_scan(s.c_str(), s.size(), &uuid));
@@ -127,7 +152,7 @@ public:
 
     bool operator==(const UUID& cmp) const
     {
-        return (gu_uuid_compare(&uuid_, &cmp.uuid_) == 0);
+        return gu_uuid_equal(&uuid_, &cmp.uuid_);
     }
 
     bool operator!=(const UUID& cmp) const
@@ -167,6 +192,11 @@ inline std::istream& operator>>(std::istream& is, gu::UUID& uuid)
     uuid.read_stream(is);
     return is;
 }
+
+inline gu::StringBase<>& operator<<(gu::StringBase<>& s, const gu::UUID& uuid)
+{
+    return (s << *uuid.uuid_ptr());
+}
 } // namespace gu
 
 #endif // _gu_uuid_hpp_
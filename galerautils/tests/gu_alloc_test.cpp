@@ -82,10 +82,44 @@ START_TEST (basic)
 }
 END_TEST
 
+START_TEST (page_reuse)
+{
+    size_t const pooled(gu::Allocator::heap_pages_pooled());
+
+    TestBaseName test_name("gu_alloc_test_reuse");
+    void* p0;
+
+    {
+        gu::Allocator a(test_name);
+        bool n;
+        void* p = a.alloc(1 << 15, n); /* spills into a standard heap page */
+        fail_if (0 == p);
+        fail_if (!n);
+        p0 = p;
+    }
+
+    /* the standard-size page must have been returned to the pool... */
+    fail_if (gu::Allocator::heap_pages_pooled() != pooled + 1);
+
+    {
+        gu::Allocator a(test_name);
+        bool n;
+        void* p = a.alloc(1 << 15, n);
+        fail_if (0 == p);
+        /* ... and recycled by the next allocator */
+        fail_if (gu::Allocator::heap_pages_pooled() != pooled);
+        fail_if (p != p0);
+    }
+
+    fail_if (gu::Allocator::heap_pages_pooled() != pooled + 1);
+}
+END_TEST
+
 Suite* gu_alloc_suite ()
 {
     TCase* t = tcase_create ("Allocator");
     tcase_add_test (t, basic);
+    tcase_add_test (t, page_reuse);
 
     Suite* s = suite_create ("gu::Allocator");
     suite_add_tcase (s, t);
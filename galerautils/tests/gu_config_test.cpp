@@ -58,6 +58,60 @@ START_TEST (gu_config_test)
 }
 END_TEST
 
+START_TEST (gu_config_param_test)
+{
+    gu::Config cnf;
+
+    cnf.add(key, "42");
+
+    /* unknown key must be rejected at registration */
+    try
+    {
+        gu::Config::Param<int> p(cnf, another_key);
+        fail("gu::NotFound expected");
+    }
+    catch (gu::NotFound&) {}
+
+    gu::Config::Param<long long> p(cnf, key);
+
+    /* handle initialized from the current value */
+    fail_if(p() != 42);
+
+    /* refreshed on string set() */
+    cnf.set(key, "123K");
+    fail_if(p() != (123LL << 10));
+
+    /* refreshed on typed set() */
+    cnf.set<int>(key, 7);
+    fail_if(p() != 7);
+
+    /* a value failing conversion must throw from set() and leave both
+     * the parameter and the handle unchanged */
+    try { cnf.set(key, "garbage"); fail("gu::Exception expected"); }
+    catch (gu::Exception&) {}
+    fail_if(p() != 7);
+    fail_if(cnf.get(key) != "7");
+
+    {
+        gu::Config::Param<long long> p2(cnf, key);
+        fail_if(p2() != 7);
+    }
+
+    /* second handle detached above, first one must still work */
+    cnf.set(key, "16");
+    fail_if(p() != 16);
+
+    /* default value is served until the parameter is set */
+    cnf.add(another_key);
+
+    gu::Config::Param<bool> b(cnf, another_key, true);
+
+    fail_unless(b());
+    cnf.set(another_key, "off");
+    fail_if(b());
+}
+END_TEST
+
 Suite *gu_config_suite(void)
 {
   Suite *s  = suite_create("gu::Config");
@@ -65,6 +119,7 @@ Suite *gu_config_suite(void)
 
   suite_add_tcase (s, tc);
   tcase_add_test  (tc, gu_config_test);
+  tcase_add_test  (tc, gu_config_param_test);
   return s;
 }
 
@@ -129,6 +129,39 @@ START_TEST(test_hardware)
 }
 END_TEST
 
+// verifies the 3-way interleaved kernel against slicing-by-8 on buffers
+// large enough to enter the interleaved loop (>= 3 x 4096 bytes)
+START_TEST(test_hardware_3way)
+{
+#if defined(CRC32C_x86_64) && !defined(CRC32C_NO_HARDWARE) && defined(__LP64__)
+    gu_crc32c_configure();
+
+    if (gu_crc32c_func != gu_crc32c_hardware64_3way) return; // no SSE 4.2
+
+    enum { buf_size = 4 * 3 * 4096 + 61 };
+    static uint8_t buf[buf_size];
+    int i;
+
+    for (i = 0; i < buf_size; i++) buf[i] = (uint8_t)(i * 2654435761U >> 13);
+
+    // odd offsets and lengths to cover misaligned starts and remainders
+    for (i = 0; i < 8; i++)
+    {
+        size_t const off = i * 1021;
+        size_t const len = buf_size - 2 * off;
+
+        uint32_t const hw = gu_crc32c_hardware64_3way
+                            (GU_CRC32C_INIT, buf + off, len);
+        uint32_t const sw = crc32cSlicingBy8
+                            (GU_CRC32C_INIT, buf + off, len);
+
+        fail_if (hw != sw, "Offset %zu, length %zu: generated %#08x, "
+                 "expected %#08x\n", off, len, hw, sw);
+    }
+#endif /* CRC32C_x86_64 && !CRC32C_NO_HARDWARE && __LP64__ */
+}
+END_TEST
+
 Suite *gu_crc32c_suite(void)
 {
     Suite *suite = suite_create("CRC32C implementation");
@@ -143,6 +176,7 @@ Suite *gu_crc32c_suite(void)
     TCase *hw = tcase_create("test_hw");
     suite_add_tcase (suite, hw);
     tcase_add_test  (hw, test_hardware);
+    tcase_add_test  (hw, test_hardware_3way);
 
     return suite;
 }
@@ -0,0 +1,152 @@
+// Copyright (C) 2017 Codership Oy <info@codership.com>
+
+// $Id$
+
+#include <check.h>
+#include "gu_fifo_lf_test.h"
+#include "../src/galerautils.h"
+#include "../src/gu_fifo_lf.h"
+
+#define FIFO_LF_LENGTH 1024L
+
+START_TEST (gu_fifo_lf_test)
+{
+    gu_fifo_lf_t* fifo;
+    long i;
+    long item;
+
+    fifo = gu_fifo_lf_create (0, 1);
+    fail_if (fifo != NULL);
+
+    fifo = gu_fifo_lf_create (1, 0);
+    fail_if (fifo != NULL);
+
+    fifo = gu_fifo_lf_create (FIFO_LF_LENGTH, sizeof(i));
+    fail_if (fifo == NULL);
+    fail_if (gu_fifo_lf_length(fifo) != 0,
+             "queue length is %ld for an empty FIFO",
+             gu_fifo_lf_length(fifo));
+    fail_if (gu_fifo_lf_max_length(fifo) < FIFO_LF_LENGTH);
+
+    // fill FIFO to capacity
+    for (i = 0; i < gu_fifo_lf_max_length(fifo); i++) {
+        fail_if (gu_fifo_lf_try_push (fifo, &i) != 0,
+                 "could not push item %ld", i);
+    }
+
+    // full now
+    fail_if (gu_fifo_lf_try_push (fifo, &i) != -EAGAIN);
+    fail_if (gu_fifo_lf_length(fifo) != gu_fifo_lf_max_length(fifo));
+
+    // drain in order
+    for (i = 0; i < gu_fifo_lf_max_length(fifo); i++) {
+        fail_if (gu_fifo_lf_try_pop (fifo, &item) != 0,
+                 "could not pop item %ld", i);
+        fail_if (item != i, "got %ld, expected %ld", item, i);
+    }
+
+    fail_if (gu_fifo_lf_length(fifo) != 0);
+    fail_if (gu_fifo_lf_try_pop (fifo, &item) != -EAGAIN);
+
+    // closed and drained queue returns -ENODATA, remaining items are
+    // still served
+    i = 42;
+    fail_if (gu_fifo_lf_try_push (fifo, &i) != 0);
+    gu_fifo_lf_close (fifo);
+    fail_if (gu_fifo_lf_try_push (fifo, &i) != -ENODATA);
+    fail_if (gu_fifo_lf_try_pop  (fifo, &item) != 0);
+    fail_if (item != 42);
+    fail_if (gu_fifo_lf_try_pop  (fifo, &item) != -ENODATA);
+
+    gu_fifo_lf_open (fifo);
+    fail_if (gu_fifo_lf_try_push (fifo, &i) != 0);
+    fail_if (gu_fifo_lf_try_pop  (fifo, &item) != 0);
+
+    gu_fifo_lf_destroy (fifo);
+}
+END_TEST
+
+#define PRODUCERS 4
+#define CONSUMERS 4
+#define ITEMS_PER_PRODUCER 10000L
+
+static void*
+producer_thread (void* arg)
+{
+    gu_fifo_lf_t* q = arg;
+    long i;
+
+    for (i = 1; i <= ITEMS_PER_PRODUCER; i++) {
+        fail_if (gu_fifo_lf_push (q, &i) != 0);
+    }
+
+    return NULL;
+}
+
+static void*
+consumer_thread (void* arg)
+{
+    gu_fifo_lf_t* q = arg;
+    long long sum = 0;
+    long item;
+
+    while (0 == gu_fifo_lf_pop (q, &item)) sum += item;
+
+    return (void*)(intptr_t)sum;
+}
+
+START_TEST (gu_fifo_lf_mt_test)
+{
+    gu_fifo_lf_t* fifo = gu_fifo_lf_create (64, sizeof(long));
+    gu_thread_t producers[PRODUCERS];
+    gu_thread_t consumers[CONSUMERS];
+    long i;
+
+    fail_if (fifo == NULL);
+
+    for (i = 0; i < CONSUMERS; i++) {
+        fail_if (gu_thread_create (&consumers[i], NULL,
+                                   consumer_thread, fifo));
+    }
+
+    for (i = 0; i < PRODUCERS; i++) {
+        fail_if (gu_thread_create (&producers[i], NULL,
+                                   producer_thread, fifo));
+    }
+
+    for (i = 0; i < PRODUCERS; i++) {
+        fail_if (gu_thread_join (producers[i], NULL));
+    }
+
+    gu_fifo_lf_close (fifo);
+
+    long long sum = 0;
+
+    for (i = 0; i < CONSUMERS; i++) {
+        void* ret = NULL;
+        fail_if (gu_thread_join (consumers[i], &ret));
+        sum += (intptr_t)ret;
+    }
+
+    /* every pushed item must be popped exactly once */
+    fail_if (sum != PRODUCERS *
+             (ITEMS_PER_PRODUCER * (ITEMS_PER_PRODUCER + 1) / 2),
+             "sum is %lld", sum);
+    fail_if (gu_fifo_lf_length (fifo) != 0);
+
+    gu_fifo_lf_destroy (fifo);
+}
+END_TEST
+
+Suite *gu_fifo_lf_suite(void)
+{
+    Suite *s  = suite_create("galerautils FIFO_LF functions");
+    TCase *tc = tcase_create("gu_fifo_lf");
+
+    suite_add_tcase (s, tc);
+    tcase_add_test  (tc, gu_fifo_lf_test);
+    tcase_add_test  (tc, gu_fifo_lf_mt_test);
+    tcase_set_timeout(tc, 60);
+
+    return s;
+}
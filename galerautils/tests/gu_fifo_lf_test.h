@@ -0,0 +1,10 @@
+// Copyright (C) 2017 Codership Oy <info@codership.com>
+
+// $Id$
+
+#ifndef __gu_fifo_lf_test__
+#define __gu_fifo_lf_test__
+
+Suite *gu_fifo_lf_suite(void);
+
+#endif /* __gu_fifo_lf_test__ */
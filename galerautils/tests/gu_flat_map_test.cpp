@@ -0,0 +1,186 @@
+/* Copyright (C) 2017 Codership Oy <info@codership.com>
+ *
+ * $Id$
+ */
+
+#include "../src/gu_flat_map.hpp"
+
+#include "gu_flat_map_test.hpp"
+
+#include <map>
+#include <cstdlib>
+
+typedef gu::UnorderedFlatMap<int, int> TestMap;
+
+START_TEST (basic)
+{
+    TestMap m;
+
+    fail_unless (m.empty());
+    fail_if     (m.size() != 0);
+    fail_if     (m.find(1) != m.end());
+    fail_if     (m.begin() != m.end());
+
+    std::pair<TestMap::iterator, bool> ret(m.insert(std::make_pair(1, 10)));
+
+    fail_unless (ret.second);
+    fail_if     (ret.first->first  != 1);
+    fail_if     (ret.first->second != 10);
+    fail_if     (m.size() != 1);
+
+    /* duplicate insert must be a no-op pointing at the existing element */
+    ret = m.insert(std::make_pair(1, 20));
+
+    fail_if     (ret.second);
+    fail_if     (ret.first->second != 10);
+    fail_if     (m.size() != 1);
+
+    TestMap::iterator i(m.find(1));
+
+    fail_if     (i == m.end());
+    fail_if     (i->second != 10);
+
+    i = m.erase(i);
+
+    fail_if     (i != m.end());
+    fail_unless (m.empty());
+    fail_if     (m.find(1) != m.end());
+}
+END_TEST
+
+START_TEST (growth)
+{
+    TestMap m;
+    int const N(10000);
+
+    for (int k(0); k < N; ++k)
+    {
+        fail_unless (m.insert(std::make_pair(k, k * 2)).second);
+    }
+
+    fail_if (m.size() != size_t(N));
+
+    for (int k(0); k < N; ++k)
+    {
+        TestMap::iterator i(m.find(k));
+        fail_if (i == m.end());
+        fail_if (i->second != k * 2);
+    }
+
+    /* erase odd keys, then make sure tombstones don't break probing */
+    for (int k(1); k < N; k += 2)
+    {
+        m.erase(m.find(k));
+    }
+
+    fail_if (m.size() != size_t(N / 2));
+
+    size_t count(0);
+    for (TestMap::const_iterator i(m.begin()); i != m.end(); ++i, ++count)
+    {
+        fail_if (i->first % 2 != 0);
+        fail_if (i->second != i->first * 2);
+    }
+    fail_if (count != m.size());
+
+    /* reinsert over tombstones */
+    for (int k(1); k < N; k += 2)
+    {
+        fail_unless (m.insert(std::make_pair(k, -k)).second);
+    }
+
+    fail_if (m.size() != size_t(N));
+    fail_if (m.find(4999)->second != -4999);
+    fail_if (m.find(5000)->second != 10000);
+}
+END_TEST
+
+START_TEST (random_ops)
+{
+    /* randomized cross-check against a reference std::map */
+    TestMap m;
+    std::map<int, int> ref;
+
+    ::srand(2017);
+
+    for (int n(0); n < 100000; ++n)
+    {
+        int const key(::rand() % 1000);
+
+        if (::rand() % 3)
+        {
+            int const val(::rand());
+            bool const inserted(m.insert(std::make_pair(key, val)).second);
+            fail_if (inserted !=
+                     ref.insert(std::make_pair(key, val)).second);
+        }
+        else
+        {
+            TestMap::iterator i(m.find(key));
+            std::map<int, int>::iterator r(ref.find(key));
+
+            fail_if ((i == m.end()) != (r == ref.end()));
+
+            if (i != m.end())
+            {
+                fail_if (i->second != r->second);
+                m.erase(i);
+                ref.erase(r);
+            }
+        }
+
+        fail_if (m.size() != ref.size());
+    }
+
+    for (std::map<int, int>::iterator r(ref.begin()); r != ref.end(); ++r)
+    {
+        TestMap::iterator i(m.find(r->first));
+        fail_if (i == m.end());
+        fail_if (i->second != r->second);
+    }
+}
+END_TEST
+
+START_TEST (copy)
+{
+    TestMap m;
+
+    for (int k(0); k < 100; ++k) m.insert(std::make_pair(k, k + 1));
+
+    TestMap c(m);
+
+    fail_if (c.size() != m.size());
+
+    m.clear();
+
+    fail_unless (m.empty());
+    fail_if     (c.size() != 100);
+
+    for (int k(0); k < 100; ++k)
+    {
+        TestMap::const_iterator i(c.find(k));
+        fail_if (i == c.end());
+        fail_if (i->second != k + 1);
+    }
+
+    m = c;
+
+    fail_if (m.size() != c.size());
+    fail_if (m.find(99) == m.end());
+}
+END_TEST
+
+Suite* gu_flat_map_suite ()
+{
+    TCase* t = tcase_create ("UnorderedFlatMap");
+    tcase_add_test (t, basic);
+    tcase_add_test (t, growth);
+    tcase_add_test (t, random_ops);
+    tcase_add_test (t, copy);
+    tcase_set_timeout(t, 60);
+
+    Suite* s = suite_create ("gu::UnorderedFlatMap");
+    suite_add_tcase (s, t);
+
+    return s;
+}
@@ -0,0 +1,13 @@
+/* Copyright (C) 2017 Codership Oy <info@codership.com>
+ *
+ * $Id$
+ */
+
+#ifndef __gu_flat_map_test__
+#define __gu_flat_map_test__
+
+#include <check.h>
+
+extern Suite *gu_flat_map_suite(void);
+
+#endif /* __gu_flat_map_test__ */
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2017 Codership Oy <info@codership.com>
+ */
+
+#include "../src/gu_hdr_histogram.hpp"
+#include "../src/gu_threads.h"
+
+#include "gu_hdr_histogram_test.hpp"
+
+#include <cstdlib>
+
+using namespace gu;
+
+START_TEST(test_hdr_histogram)
+{
+    HdrHistogram hs;
+
+    fail_unless(hs.count() == 0);
+    fail_unless(hs.to_string() == "");
+    fail_unless(hs.percentile(50.0) == 0);
+
+    // known distribution: values 1..10000, each once
+    for (long long v = 1; v <= 10000; ++v) hs.record(v);
+
+    fail_unless(hs.count() == 10000);
+
+    // log-linear binning with 32 sub-buckets guarantees ~3% relative
+    // accuracy plus half a bin of rounding
+    static double const percentiles[] = { 50.0, 90.0, 99.0, 99.9 };
+    for (size_t i = 0; i < sizeof(percentiles)/sizeof(percentiles[0]); ++i)
+    {
+        long long const expect(
+            static_cast<long long>(percentiles[i]/100.0 * 10000));
+        long long const got(hs.percentile(percentiles[i]));
+        fail_if(std::abs(double(got - expect)) > 0.05 * expect + 1,
+                "p%f: expected ~%lld, got %lld",
+                percentiles[i], expect, got);
+    }
+
+    fail_unless(hs.to_string() != "");
+
+    hs.clear();
+    fail_unless(hs.count() == 0);
+    fail_unless(hs.to_string() == "");
+
+    // negative values (clock artifacts) land in the zero bin
+    hs.record(-1);
+    fail_unless(hs.count() == 1);
+    fail_unless(hs.percentile(100.0) == 0);
+}
+END_TEST
+
+static void* hdr_recorder(void* arg)
+{
+    HdrHistogram* const hs(reinterpret_cast<HdrHistogram*>(arg));
+
+    for (long long v = 0; v < 10000; ++v) hs->record(v % 1000);
+
+    return 0;
+}
+
+START_TEST(test_hdr_histogram_mt)
+{
+    HdrHistogram hs;
+    gu_thread_t  thds[4];
+
+    for (int i = 0; i < 4; ++i)
+    {
+        fail_if(gu_thread_create(&thds[i], 0, hdr_recorder, &hs) != 0);
+    }
+
+    for (int i = 0; i < 4; ++i)
+    {
+        gu_thread_join(thds[i], 0);
+    }
+
+    // no increment may be lost
+    fail_unless(hs.count() == 4*10000LL,
+                "expected %lld, got %lld", 4*10000LL, hs.count());
+}
+END_TEST
+
+Suite* gu_hdr_histogram_suite()
+{
+    TCase* t = tcase_create ("test_hdr_histogram");
+    tcase_add_test (t, test_hdr_histogram);
+    tcase_add_test (t, test_hdr_histogram_mt);
+
+    Suite* s = suite_create ("gu::HdrHistogram");
+    suite_add_tcase (s, t);
+
+    return s;
+}
@@ -0,0 +1,12 @@
+/*
+ * Copyright (C) 2017 Codership Oy <info@codership.com>
+ */
+
+#ifndef __gu_hdr_histogram_test_hpp__
+#define __gu_hdr_histogram_test_hpp__
+
+#include <check.h>
+
+extern Suite* gu_hdr_histogram_suite();
+
+#endif /* __gu_hdr_histogram_test_hpp__ */
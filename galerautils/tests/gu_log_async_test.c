@@ -0,0 +1,83 @@
+// Copyright (C) 2017 Codership Oy <info@codership.com>
+
+// $Id$
+
+#include <check.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "gu_log_async_test.h"
+#include "../src/galerautils.h"
+#include "../src/gu_log_async.h"
+
+#define TEST_MSG_COUNT 20000L
+
+static long long volatile test_received = 0;
+static long     test_last_seq = -1;
+static long     test_order_breaks = 0;
+
+/* gu_log() may prefix the payload with a timestamp and, with debug
+ * logging on (the suite main() enables it), file:func():line info -
+ * locate the payload instead of assuming it starts the message */
+static void
+test_log_cb (int severity, const char* msg)
+{
+    const char* payload = strstr (msg, "async test ");
+    long seq;
+
+    (void)severity;
+
+    if (payload != NULL && sscanf (payload, "async test %ld", &seq) == 1) {
+        if (seq <= test_last_seq) test_order_breaks++;
+        test_last_seq = seq;
+        gu_atomic_fetch_and_add (&test_received, 1);
+    }
+}
+
+START_TEST (gu_log_async_test)
+{
+    long long drops_before = gu_log_async_dropped();
+    long long drops;
+    long i;
+
+    gu_conf_set_log_callback (test_log_cb);
+
+    fail_if (gu_conf_async_log_on() != 0);
+    fail_if (gu_conf_async_log_on() != 0); // second enable is a no-op
+
+    for (i = 0; i < TEST_MSG_COUNT; i++) {
+        gu_info ("async test %ld", i);
+    }
+
+    fail_if (gu_conf_async_log_off() != 0);
+    fail_if (gu_conf_async_log_off() != 0); // second disable is a no-op
+
+    drops = gu_log_async_dropped() - drops_before;
+
+    // every message is either delivered or accounted as dropped...
+    fail_if (test_received + drops != TEST_MSG_COUNT,
+             "received %lld + dropped %lld != %ld",
+             test_received, drops, TEST_MSG_COUNT);
+    // ...and a single producer's messages come out in order
+    fail_if (test_order_breaks != 0,
+             "%ld order violations", test_order_breaks);
+
+    // synchronous operation must be restored after disabling
+    test_received = 0;
+    gu_info ("async test %d", 0);
+    fail_if (test_received != 1);
+
+    gu_conf_set_log_callback (NULL);
+}
+END_TEST
+
+Suite *gu_log_async_suite(void)
+{
+  Suite *s  = suite_create("Galera async logging");
+  TCase *tc = tcase_create("gu_log_async");
+
+  suite_add_tcase (s, tc);
+  tcase_add_test  (tc, gu_log_async_test);
+  tcase_set_timeout(tc, 60);
+  return s;
+}
@@ -0,0 +1,12 @@
+// Copyright (C) 2017 Codership Oy <info@codership.com>
+
+// $Id$
+
+#ifndef __gu_log_async_test__
+#define __gu_log_async_test__
+
+#include <check.h>
+
+extern Suite *gu_log_async_suite(void);
+
+#endif /* __gu_log_async_test__ */
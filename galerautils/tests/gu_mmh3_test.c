@@ -228,6 +228,30 @@ START_TEST (gu_mmh128_partial)
 }
 END_TEST
 
+/* Tests the multi-buffer batch function against single-buffer results */
+START_TEST (gu_mmh128_batch_test)
+{
+    const void* msgs[NUM_128_TESTS];
+    size_t      lens[NUM_128_TESTS];
+    hash128_t   outs[NUM_128_TESTS];
+    int i;
+
+    for (i = 0; i < NUM_128_TESTS; i++)
+    {
+        msgs[i] = test_input;
+        lens[i] = i;
+    }
+
+    gu_mmh128_batch (msgs, lens, NUM_128_TESTS, outs);
+
+    for (i = 0; i < NUM_128_TESTS; i++)
+    {
+        fail_if(check (&test_output128[i], &outs[i], sizeof(outs[i])),
+                "gu_mmh128_batch() failed at step %d", i);
+    }
+}
+END_TEST
+
 Suite *gu_mmh3_suite(void)
 {
   Suite *s  = suite_create("MurmurHash3");
@@ -238,6 +262,7 @@ Suite *gu_mmh3_suite(void)
 //  tcase_add_test (tc, gu_mmh128_x86_test);
   tcase_add_test (tc, gu_mmh128_x64_test);
   tcase_add_test (tc, gu_mmh128_partial);
+  tcase_add_test (tc, gu_mmh128_batch_test);
 
   return s;
 }
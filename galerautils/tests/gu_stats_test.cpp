@@ -7,6 +7,7 @@
 #include "gu_stats_test.hpp"
 
 #include <cmath>
+#include <cstdlib>
 #include <limits>
 
 using namespace gu;
@@ -44,10 +45,44 @@ START_TEST(test_stats)
 }
 END_TEST
 
+START_TEST(test_quantile)
+{
+    Quantile q99(0.99);
+
+    fail_if(!double_equal(q99.value(), 0.0));
+
+    // fewer than 5 observations: exact answer from the sample
+    q99.insert(3.0);
+    q99.insert(1.0);
+    fail_if(!double_equal(q99.value(), 3.0));
+
+    // uniform [0, 10000): p99 must come out within a few percent
+    ::srand(42);
+    for (int i = 0; i < 100000; ++i)
+    {
+        q99.insert(double(::rand() % 10000));
+    }
+    fail_if(std::fabs(q99.value() - 9900.0) > 0.03 * 9900.0,
+            "p99: expected ~9900, got %f", q99.value());
+    fail_if(q99.times() != 100002);
+
+    q99.clear();
+    fail_if(q99.times() != 0);
+    fail_if(!double_equal(q99.value(), 0.0));
+
+    // median of a symmetric distribution
+    Quantile q50(0.5);
+    for (int i = 0; i < 10001; ++i) q50.insert(double(i % 101));
+    fail_if(std::fabs(q50.value() - 50.0) > 2.0,
+            "p50: expected ~50, got %f", q50.value());
+}
+END_TEST
+
 Suite* gu_stats_suite()
 {
     TCase* t = tcase_create ("test_stats");
     tcase_add_test (t, test_stats);
+    tcase_add_test (t, test_quantile);
 
     Suite* s = suite_create ("gu::Stats");
     suite_add_tcase (s, t);
@@ -16,6 +16,7 @@
 #include "gu_vlq_test.hpp"
 #include "gu_digest_test.hpp"
 #include "gu_mem_pool_test.hpp"
+#include "gu_flat_map_test.hpp"
 #include "gu_alloc_test.hpp"
 #include "gu_rset_test.hpp"
 #include "gu_string_utils_test.hpp"
@@ -24,6 +25,7 @@
 #include "gu_net_test.hpp"
 #include "gu_datetime_test.hpp"
 #include "gu_histogram_test.hpp"
+#include "gu_hdr_histogram_test.hpp"
 #include "gu_stats_test.hpp"
 #include "gu_thread_test.hpp"
 
@@ -37,6 +39,7 @@ static suite_creator_t suites[] =
     gu_vlq_suite,
     gu_digest_suite,
     gu_mem_pool_suite,
+    gu_flat_map_suite,
     gu_alloc_suite,
     gu_rset_suite,
     gu_string_utils_suite,
@@ -45,6 +48,7 @@ static suite_creator_t suites[] =
     gu_net_suite,
     gu_datetime_suite,
     gu_histogram_suite,
+    gu_hdr_histogram_suite,
     gu_stats_suite,
     gu_thread_suite,
     0
@@ -20,6 +20,8 @@
 #include "gu_dbug_test.h"
 #include "gu_time_test.h"
 #include "gu_fifo_test.h"
+#include "gu_fifo_lf_test.h"
+#include "gu_log_async_test.h"
 #include "gu_uuid_test.h"
 #include "gu_lock_step_test.h"
 #include "gu_str_test.h"
@@ -40,6 +42,8 @@ static suite_creator_t suites[] =
         gu_dbug_suite,
         gu_time_suite,
         gu_fifo_suite,
+        gu_fifo_lf_suite,
+        gu_log_async_suite,
         gu_uuid_suite,
         gu_lock_step_suite,
         gu_str_suite,
@@ -5,6 +5,9 @@
 
 
 #include "gu_thread.hpp"
+#include "gu_exception.hpp"
+
+#include <cerrno>
 #include <sstream>
 
 #include "gu_thread_test.hpp"
@@ -50,6 +53,30 @@ START_TEST(check_thread_schedparam_system_default)
 }
 END_TEST
 
+START_TEST(check_thread_affinity_parse)
+{
+    gu::ThreadAffinity af_empty("");
+    fail_unless(af_empty.empty());
+
+    gu::ThreadAffinity af("8,0-3,2");
+    fail_if(af.empty());
+
+    std::ostringstream oss;
+    oss << af;
+    fail_unless(oss.str() == "0,1,2,3,8", "'%s'", oss.str().c_str());
+
+    try
+    {
+        gu::ThreadAffinity af_bad("3-1");
+        fail("exception not thrown");
+    }
+    catch (gu::Exception& e)
+    {
+        fail_unless(e.get_errno() == EINVAL);
+    }
+}
+END_TEST
+
 Suite* gu_thread_suite()
 {
     Suite* s(suite_create("galerautils Thread"));
@@ -58,6 +85,7 @@ Suite* gu_thread_suite()
     suite_add_tcase(s, tc);
     tcase_add_test(tc, check_thread_schedparam_parse);
     tcase_add_test(tc, check_thread_schedparam_system_default);
+    tcase_add_test(tc, check_thread_affinity_parse);
 
     return s;
 }
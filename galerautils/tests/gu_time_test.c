@@ -22,6 +22,24 @@ START_TEST (gu_time_test)
 }
 END_TEST
 
+START_TEST (gu_time_monotonic_coarse_test)
+{
+    long long const coarse1 = gu_time_monotonic_coarse();
+    long long const precise = gu_time_monotonic();
+    long long const coarse2 = gu_time_monotonic_coarse();
+
+    /* coarse clock must not go backwards */
+    fail_if (coarse2 < coarse1);
+
+    /* and must stay within the advertised few ms of the precise one
+     * (allow a generous 100ms for scheduling hiccups on loaded hosts) */
+    fail_if (precise - coarse1 > 100000000LL,
+             "coarse clock lags by %lld ns", precise - coarse1);
+    fail_if (coarse2 - precise > 100000000LL,
+             "coarse clock ahead by %lld ns", coarse2 - precise);
+}
+END_TEST
+
 Suite *gu_time_suite(void)
 {
   Suite *s  = suite_create("Galera time functions");
@@ -29,6 +47,7 @@ Suite *gu_time_suite(void)
 
   suite_add_tcase (s, tc);
   tcase_add_test  (tc, gu_time_test);
+  tcase_add_test  (tc, gu_time_monotonic_coarse_test);
   return s;
 }
 
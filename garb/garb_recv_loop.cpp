@@ -62,6 +62,15 @@ RecvLoop::loop()
         switch (act.type)
         {
         case GCS_ACT_TORDERED:
+            /* NOTE: writeset bodies are never materialized here: the gcs
+             *       library garb links against is built with GCS_FOR_GARB,
+             *       which makes the defrag layer skip buffer allocation and
+             *       fragment copying altogether (see gcs_defrag.cpp), so
+             *       act.buf is NULL and only ordering metadata reaches this
+             *       loop. Not *receiving* the payloads off the wire at all
+             *       would require senders to know which members don't apply
+             *       and a group protocol version bump - it cannot be done on
+             *       the arbitrator side alone. */
             if (gu_unlikely(!(act.seqno_g & 127)))
                 /* == report_interval_ of 128 */
             {
@@ -22,6 +22,8 @@ namespace gcache
         mallocs  = 0;
         reallocs = 0;
         frees    = 0;
+        rb_overflows = 0;
+        discards     = 0;
 
         seqno_locked   = SEQNO_NONE;
         seqno_max      = SEQNO_NONE;
@@ -50,7 +52,7 @@ namespace gcache
         gid       (),
         mem       (params.mem_size(), seqno2ptr),
         rb        (params.rb_name(), params.rb_size(), seqno2ptr, gid,
-                   params.recover()),
+                   params.recover(), params.journal()),
         ps        (params.dir_name(),
                    params.keep_pages_size(),
                    params.page_size(),
@@ -61,6 +63,8 @@ namespace gcache
         mallocs   (0),
         reallocs  (0),
         frees     (0),
+        rb_overflows(0),
+        discards  (0),
         seqno_locked(SEQNO_NONE),
         seqno_max   (seqno2ptr.empty() ?
                      SEQNO_NONE : seqno2ptr.rbegin()->first),
@@ -68,7 +72,12 @@ namespace gcache
 #ifndef NDEBUG
         ,buf_tracker()
 #endif
-    {}
+    {
+        rb.set_flush_size(params.flush_size());
+        if (params.thp())            rb.set_thp(true);
+        if (params.mlock_size() > 0) rb.set_mlock_size(params.mlock_size());
+        if (params.numa_interleave()) rb.set_numa_interleave(true);
+    }
 
     GCache::~GCache ()
     {
@@ -86,6 +95,29 @@ namespace gcache
                ps.allocated_pool_size();
     }
 
+    void GCache::get_stats (Stats& stats)
+    {
+        gu::Lock lock(mtx);
+
+        stats.mem_used     = mem.allocated_pool_size();
+        stats.rb_used      = rb.size_used();
+        stats.rb_size      = rb.size();
+        stats.page_used    = ps.total_size();
+        stats.rb_overflows = rb_overflows;
+        stats.discards     = discards;
+
+        if (gu_likely(!seqno2ptr.empty()))
+        {
+            stats.seqno_min = seqno2ptr.begin()->first;
+            stats.seqno_max = seqno2ptr.rbegin()->first;
+        }
+        else
+        {
+            stats.seqno_min = SEQNO_NONE;
+            stats.seqno_max = SEQNO_NONE;
+        }
+    }
+
     /*! prints object properties */
     void print (std::ostream& os) {}
 }
@@ -104,6 +104,23 @@ namespace gcache
          */
         size_t allocated_pool_size ();
 
+        /*! Per-store occupancy and pressure counters for the stats
+         *  interface. Counters are cumulative, rates are for the caller
+         *  to derive from deltas (like mallocs/frees). */
+        struct Stats
+        {
+            size_t    mem_used;     /*!< bytes in heap store            */
+            size_t    rb_used;      /*!< bytes occupied in ring buffer  */
+            size_t    rb_size;      /*!< ring buffer capacity           */
+            size_t    page_used;    /*!< bytes in page store files      */
+            long long rb_overflows; /*!< allocs that missed the ring    */
+            long long discards;     /*!< buffers purged from history    */
+            seqno_t   seqno_min;    /*!< oldest seqno held              */
+            seqno_t   seqno_max;    /*!< newest seqno held              */
+        };
+
+        void get_stats (Stats&);
+
 
         /*!
          * Implements the cleanup policy test.
@@ -209,7 +226,12 @@ namespace gcache
             size_t page_size()           const { return page_size_;        }
             size_t keep_pages_size()     const { return keep_pages_size_;  }
             size_t keep_pages_count()    const { return keep_pages_count_; }
+            size_t flush_size()          const { return flush_size_;       }
             bool   recover()             const { return recover_;         }
+            bool   journal()             const { return journal_;         }
+            bool   thp()                 const { return thp_;             }
+            size_t mlock_size()          const { return mlock_size_;      }
+            bool   numa_interleave()     const { return numa_interleave_; }
 
             bool skip_purge(seqno_t seqno)
             {
@@ -221,7 +243,11 @@ namespace gcache
             void page_size        (size_t s) { page_size_        = s; }
             void keep_pages_size  (size_t s) { keep_pages_size_  = s; }
             void keep_pages_count (size_t c) { keep_pages_count_ = c; }
+            void flush_size       (size_t s) { flush_size_       = s; }
             void freeze_purge_at_seqno(seqno_t s) { freeze_purge_at_seqno_ = s; }
+            void thp              (bool b)   { thp_              = b; }
+            void mlock_size       (size_t s) { mlock_size_       = s; }
+            void numa_interleave  (bool b)   { numa_interleave_  = b; }
 
         private:
 
@@ -232,11 +258,32 @@ namespace gcache
             size_t            page_size_;
             size_t            keep_pages_size_;
             size_t            keep_pages_count_;
+            size_t            flush_size_;
             bool        const recover_;
+            bool        const journal_;
             seqno_t           freeze_purge_at_seqno_;
+            bool              thp_;
+            size_t            mlock_size_;
+            bool              numa_interleave_;
         }
             params;
 
+        /* NOTE: a single mutex is deliberate, even though it makes IST
+         *       donors and committers contend. Lookups are not read-only
+         *       here: every seqno_get_*() call moves seqno_locked and takes
+         *       part in the cond handshake, and a reader must observe the
+         *       map consistently with a concurrent purge, or it could chase
+         *       a pointer into space the ring head is about to overwrite.
+         *       RCU-style deferred reclamation is at odds with a fixed-size
+         *       ring: freed space must be reusable at once to bound the
+         *       cache, so a grace period would just stall the allocator
+         *       head and re-serialize everybody on memory instead of the
+         *       lock. Sharding by seqno fares no better - allocation and
+         *       purge sweep all seqnos in order, touching every shard.
+         *       With the flat seqno2ptr map the lookup critical sections
+         *       are a few loads, so the remaining long holds are in the
+         *       allocation path itself (in-lock purge and IO), not in the
+         *       lookups. */
 #ifdef HAVE_PSI_INTERFACE
         gu::MutexWithPFS mtx;
         gu::CondWithPFS  cond;
@@ -256,6 +303,8 @@ namespace gcache
         long long       mallocs;
         long long       reallocs;
         long long       frees;
+        long long       rb_overflows;
+        long long       discards;
 
         int64_t         seqno_locked;
         int64_t         seqno_max;
@@ -268,6 +317,20 @@ namespace gcache
         /* returns true when successfully discards all seqnos up to s */
         bool discard_seqno (int64_t s);
 
+        /* whether released page buffers should stay in the seqno index:
+         * with a keep policy the page files are retained on disk, so
+         * retaining the index entries lets a donor serve IST from
+         * archived pages ("deep" IST) instead of forcing a full SST */
+        bool keep_page_history() const
+        {
+            return (params.keep_pages_size() > 0 ||
+                    params.keep_pages_count() > 0);
+        }
+
+        /* bounds retained page history: discards oldest released
+         * seqnos while the page pool exceeds the keep limits */
+        void trim_page_history();
+
         // disable copying
         GCache (const GCache&);
         GCache& operator = (const GCache&);
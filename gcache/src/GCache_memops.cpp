@@ -29,6 +29,7 @@ namespace gcache
                 seqno2ptr.erase (i++); // post ++ is significant!
 
                 bh->seqno_g = SEQNO_ILL; // will never be reused
+                discards++;
 
                 switch (bh->store)
                 {
@@ -49,6 +50,20 @@ namespace gcache
         return true;
     }
 
+    void
+    GCache::trim_page_history ()
+    {
+        while (cleanup_required() && !seqno2ptr.empty())
+        {
+            int64_t const oldest(seqno2ptr.begin()->first);
+
+            /* don't pull history from under a donor that locked it */
+            if (seqno_locked != SEQNO_NONE && oldest >= seqno_locked) break;
+
+            if (!discard_seqno (oldest)) break;
+        }
+    }
+
     void*
     GCache::malloc (ssize_type const s)
     {
@@ -68,7 +83,13 @@ namespace gcache
 
             if (0 == ptr) ptr = rb.malloc(size);
 
-            if (0 == ptr) ptr = ps.malloc(size);
+            if (0 == ptr)
+            {
+                /* ring could not fit the buffer - how often this happens
+                 * relative to mallocs tells if gcache.size is too small */
+                rb_overflows += (rb.size() > 0);
+                ptr = ps.malloc(size);
+            }
 
 #ifndef NDEBUG
             if (0 != ptr) buf_tracker.insert (ptr);
@@ -117,7 +138,18 @@ namespace gcache
         case BUFFER_IN_PAGE:
             if (gu_likely(bh->seqno_g > 0))
             {
-                discard_seqno (bh->seqno_g);
+                if (keep_page_history())
+                {
+                    /* the keep policy retains the page file, so keep the
+                     * seqno index entry too: this is what makes archived
+                     * pages servable over IST. Excess history is trimmed
+                     * oldest-first to honour the keep limits. */
+                    trim_page_history ();
+                }
+                else
+                {
+                    discard_seqno (bh->seqno_g);
+                }
             }
             else
             {
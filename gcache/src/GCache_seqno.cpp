@@ -76,6 +76,10 @@ namespace gcache
 
         bh->seqno_g = seqno_g;
         bh->seqno_d = seqno_d;
+
+        /* the buffer contents are final from here on - journal them for
+         * crash recovery (no-op unless gcache.journal is enabled) */
+        if (BUFFER_IN_RB == bh->store) rb.journal_append(bh);
     }
 
     void
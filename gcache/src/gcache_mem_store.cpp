@@ -14,43 +14,43 @@ namespace gcache
 bool
 MemStore::have_free_space (size_type size)
 {
-    while ((size_ > max_size_ - size) && !seqno2ptr_.empty())
+    /* discard released bufs in one batch: pick the whole victim run first,
+     * then update the seqno map once with a single range erase */
+    seqno2ptr_iter_t i(seqno2ptr_.begin());
+
+    while ((size_ > max_size_ - size) && i != seqno2ptr_.end())
     {
-        /* try to free some released bufs */
-        seqno2ptr_iter_t const i  (seqno2ptr_.begin());
-        BufferHeader*    const bh (ptr2BH (i->second));
+        BufferHeader* const bh (ptr2BH (i->second));
+
+        if (!BH_is_released(bh)) break;
+
+        bh->seqno_g = SEQNO_ILL;
 
-        if (BH_is_released(bh)) /* discard buffer */
+        switch (bh->store)
         {
-            seqno2ptr_.erase(i);
-            bh->seqno_g = SEQNO_ILL;
-
-            switch (bh->store)
-            {
-            case BUFFER_IN_MEM:
-                discard(bh);
-                break;
-            case BUFFER_IN_RB:
-                bh->ctx->discard(bh);
-                break;
-            case BUFFER_IN_PAGE:
-            {
-                Page*      const page (static_cast<Page*>(bh->ctx));
-                PageStore* const ps   (PageStore::page_store(page));
-                ps->discard(bh);
-                break;
-            }
-            default:
-                log_fatal << "Corrupt buffer header: " << bh;
-                abort();
-            }
-        }
-        else
+        case BUFFER_IN_MEM:
+            discard(bh);
+            break;
+        case BUFFER_IN_RB:
+            bh->ctx->discard(bh);
+            break;
+        case BUFFER_IN_PAGE:
         {
+            Page*      const page (static_cast<Page*>(bh->ctx));
+            PageStore* const ps   (PageStore::page_store(page));
+            ps->discard(bh);
             break;
         }
+        default:
+            log_fatal << "Corrupt buffer header: " << bh;
+            abort();
+        }
+
+        ++i;
     }
 
+    seqno2ptr_.erase(seqno2ptr_.begin(), i);
+
     return (size_ <= max_size_ - size);
 }
 
@@ -9,6 +9,7 @@
 #include "gcache_limits.hpp"
 
 #include <gu_logger.hpp>
+#include <gu_maintenance.hpp>
 #include <gu_throw.hpp>
 
 #include <cstdio>
@@ -47,10 +48,10 @@ make_page_name (const std::string& base_name, size_t count)
     return os.str();
 }
 
-static void*
-remove_file (void* __restrict__ arg)
+void*
+gcache::PageStore::io_worker_cb (void* arg)
 {
-    char* const file_name (static_cast<char*>(arg));
+    PageStore* const ps(static_cast<PageStore*>(arg));
 
 #ifdef HAVE_PSI_INTERFACE
     pfs_instr_callback(WSREP_PFS_INSTR_TYPE_THREAD,
@@ -59,35 +60,176 @@ remove_file (void* __restrict__ arg)
                        NULL, NULL, NULL);
 #endif /* HAVE_PSI_INTERFACE */
 
-    if (NULL != file_name)
+    ps->io_worker();
+
+#ifdef HAVE_PSI_INTERFACE
+    pfs_instr_callback(WSREP_PFS_INSTR_TYPE_THREAD,
+                       WSREP_PFS_INSTR_OPS_DESTROY,
+                       WSREP_PFS_INSTR_TAG_GCACHE_REMOVEFILE_THREAD,
+                       NULL, NULL, NULL);
+#endif /* HAVE_PSI_INTERFACE */
+
+    return NULL;
+}
+
+void
+gcache::PageStore::io_worker ()
+{
+    while (true)
     {
-        if (remove (file_name))
+        IOTask task;
+
+        {
+            gu::Lock lock(io_mtx_);
+
+            while (!io_exit_ && io_queue_.empty())
+            {
+                io_idle_ = true;
+                io_done_.broadcast();
+                lock.wait(io_cond_);
+            }
+
+            /* on exit the remaining queue is still worked off */
+            if (io_queue_.empty())
+            {
+                io_idle_ = true;
+                io_done_.broadcast();
+                return;
+            }
+
+            /* file removals and cache writeback are deferred - within a
+             * bound - while replication is busy; page preparation is
+             * needed by the allocation path and always runs at once */
+            long long deferred_ns(0);
+
+            while (io_deferrable()                                  &&
+                   0 == io_waiters_                                 &&
+                   !io_exit_                                        &&
+                   deferred_ns < gu::MaintenanceGauge::MAX_DEFER_NS &&
+                   gu::MaintenanceGauge::process().idle() == false)
+            {
+                try
+                {
+                    lock.wait(io_cond_, gu::datetime::Date::calendar() +
+                              gu::MaintenanceGauge::POLL_NS);
+                }
+                catch (gu::Exception& e)
+                {
+                    if (e.get_errno() != ETIMEDOUT) throw;
+                }
+
+                deferred_ns += gu::MaintenanceGauge::POLL_NS;
+            }
+
+            /* queued tasks may have been canceled while deferring */
+            if (io_queue_.empty()) continue;
+
+            task = io_queue_.front();
+            io_queue_.pop_front();
+            io_idle_ = false;
+            if (IOTask::DROP_CACHE == task.type) io_busy_page_ = task.page;
+        }
+
+        io_execute (task);
+
+        if (IOTask::DROP_CACHE == task.type)
         {
-            int err = errno;
+            gu::Lock lock(io_mtx_);
+            io_busy_page_ = 0;
+            io_done_.broadcast();
+        }
+    }
+}
 
-            log_error << "Failed to remove page file '" << file_name << "': "
+void
+gcache::PageStore::io_execute (const IOTask& task)
+{
+    switch (task.type)
+    {
+    case IOTask::REMOVE:
+        if (remove (task.name.c_str()))
+        {
+            int const err(errno);
+            log_error << "Failed to remove page file '" << task.name << "': "
                       << err << " (" << strerror(err) << ")";
         }
         else
         {
-            log_info << "Deleted page " << file_name;
+            log_info << "Deleted page " << task.name;
         }
-
-        free (file_name);
+        break;
+    case IOTask::PREPARE:
+        /* prep_page_ is only read by other threads after join_prepare(),
+         * which drains the queue first */
+        try
+        {
+            prep_page_ = new Page (this, prep_name_, prep_size_);
+        }
+        catch (gu::Exception& e)
+        {
+            log_error << "Failed to prepare next cache page '" << prep_name_
+                      << "': " << e.what();
+            prep_page_ = NULL;
+        }
+        break;
+    case IOTask::DROP_CACHE:
+        task.page->drop_fs_cache();
+        break;
     }
-    else
+}
+
+void
+gcache::PageStore::io_submit (const IOTask& task)
+{
+    gu::Lock lock(io_mtx_);
+    io_queue_.push_back (task);
+    io_cond_.signal();
+}
+
+void
+gcache::PageStore::io_drain ()
+{
+    gu::Lock lock(io_mtx_);
+
+    ++io_waiters_;
+    io_cond_.signal(); // wake the worker if it is deferring
+
+    while (!(io_queue_.empty() && io_idle_)) lock.wait(io_done_);
+
+    --io_waiters_;
+}
+
+bool
+gcache::PageStore::io_deferrable () const
+{
+    for (std::deque<IOTask>::const_iterator i(io_queue_.begin());
+         i != io_queue_.end(); ++i)
     {
-        log_error << "Null file name in " << __FUNCTION__;
+        if (IOTask::PREPARE == i->type) return false;
     }
 
-#ifdef HAVE_PSI_INTERFACE
-    pfs_instr_callback(WSREP_PFS_INSTR_TYPE_THREAD,
-                       WSREP_PFS_INSTR_OPS_DESTROY,
-                       WSREP_PFS_INSTR_TAG_GCACHE_REMOVEFILE_THREAD,
-                       NULL, NULL, NULL);
-#endif /* HAVE_PSI_INTERFACE */
+    return true;
+}
 
-    pthread_exit(NULL);
+void
+gcache::PageStore::io_cancel_drop (const Page* page)
+{
+    gu::Lock lock(io_mtx_);
+
+    for (std::deque<IOTask>::iterator i(io_queue_.begin());
+         i != io_queue_.end();)
+    {
+        if (IOTask::DROP_CACHE == i->type && page == i->page)
+        {
+            i = io_queue_.erase(i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+
+    while (io_busy_page_ == page) lock.wait(io_done_);
 }
 
 /*
@@ -106,27 +248,20 @@ gcache::PageStore::delete_page ()
 
     pages_.pop_front();
 
-    char* const file_name(strdup(page->name().c_str()));
+    IOTask task;
+    task.type = IOTask::REMOVE;
+    task.name = page->name();
 
     total_size_ -= page->size();
 
     if (current_ == page) current_ = 0;
 
-    delete page;
+    /* a queued or in-flight cache drop must not outlive the page */
+    io_cancel_drop (page);
 
-#ifdef GCACHE_DETACH_THREAD
-    pthread_t delete_thr_;
-#else
-    if (delete_thr_ != pthread_t(-1)) pthread_join (delete_thr_, NULL);
-#endif /* GCACHE_DETACH_THERAD */
+    delete page;
 
-    int err = gu_thread_create (&delete_thr_, &delete_page_attr_, remove_file,
-                                file_name);
-    if (0 != err)
-    {
-        delete_thr_ = pthread_t(-1);
-        gu_throw_error(err) << "Failed to create page file deletion thread";
-    }
+    io_submit (task);
 
     return true;
 }
@@ -170,18 +305,85 @@ gcache::PageStore::cleanup ()
 void
 gcache::PageStore::reset ()
 {
+    discard_prepared();
+
     while (pages_.size() > 0 && delete_page()) {};
 }
 
+inline void
+gcache::PageStore::start_prepare ()
+{
+    if (0 != prep_page_) return; /* prepared page still waiting for use */
+
+    prep_name_ = make_page_name (base_name_, count_);
+    prep_size_ = page_size_;
+
+    IOTask task;
+    task.type = IOTask::PREPARE;
+    io_submit (task);
+
+    count_++;
+}
+
+inline void
+gcache::PageStore::join_prepare ()
+{
+    io_drain();
+}
+
+void
+gcache::PageStore::discard_prepared ()
+{
+    join_prepare();
+
+    if (0 != prep_page_)
+    {
+        std::string const file_name(prep_page_->name());
+
+        delete prep_page_;
+        prep_page_ = NULL;
+
+        if (remove (file_name.c_str()))
+        {
+            int const err(errno);
+            log_error << "Failed to remove page file '" << file_name << "': "
+                      << err << " (" << strerror(err) << ")";
+        }
+        else
+        {
+            log_info << "Deleted page " << file_name;
+        }
+    }
+}
+
 inline void
 gcache::PageStore::new_page (size_type size)
 {
-    Page* const page(new Page(this, make_page_name (base_name_, count_), size));
+    join_prepare();
+
+    Page* page(NULL);
+
+    if (0 != prep_page_ && prep_page_->size() >= size)
+    {
+        page = prep_page_;
+        prep_page_ = NULL;
+    }
+    else
+    {
+        /* either nothing was prepared yet or the request does not fit a
+         * standard page - create one synchronously. An unused prepared page
+         * is kept around for the next regular allocation. */
+        page = new Page(this, make_page_name (base_name_, count_), size);
+        count_++;
+    }
 
     pages_.push_back (page);
     total_size_ += page->size();
     current_ = page;
-    count_++;
+
+    /* file creation, truncation and mmapping take multi-ms on a busy disk,
+     * so keep one standard page ready ahead of demand */
+    start_prepare();
 }
 
 gcache::PageStore::PageStore (const std::string& dir_name,
@@ -197,52 +399,51 @@ gcache::PageStore::PageStore (const std::string& dir_name,
     pages_     (),
     current_   (0),
     total_size_(0),
-    delete_page_attr_()
-#ifndef GCACHE_DETACH_THREAD
-    , delete_thr_(pthread_t(-1))
-#endif /* GCACHE_DETACH_THREAD */
+    io_mtx_    (),
+    io_cond_   (),
+    io_done_   (),
+    io_queue_  (),
+    io_busy_page_(0),
+    io_waiters_(0),
+    io_exit_   (false),
+    io_idle_   (true),
+    io_thr_    (),
+    prep_page_ (NULL),
+    prep_name_ (),
+    prep_size_ (0)
 {
-    int err = pthread_attr_init (&delete_page_attr_);
-
-    if (0 != err)
-    {
-        gu_throw_error(err) << "Failed to initialize page file deletion "
-                            << "thread attributes";
-    }
+    int const err(gu_thread_create (&io_thr_, NULL, io_worker_cb, this));
 
-#ifdef GCACHE_DETACH_THREAD
-    err = pthread_attr_setdetachstate (&delete_page_attr_,
-                                       PTHREAD_CREATE_DETACHED);
     if (0 != err)
     {
-        pthread_attr_destroy (&delete_page_attr_);
-        gu_throw_error(err) << "Failed to set DETACHED attribute to "
-                            << "page file deletion thread";
+        gu_throw_error(err) << "Failed to create page store I/O thread";
     }
-#endif /* GCACHE_DETACH_THREAD */
 }
 
 gcache::PageStore::~PageStore ()
 {
     try
     {
+        discard_prepared();
         while (pages_.size() && delete_page()) {};
-#ifndef GCACHE_DETACH_THREAD
-        if (delete_thr_ != pthread_t(-1)) pthread_join (delete_thr_, NULL);
-#endif /* GCACHE_DETACH_THREAD */
     }
     catch (gu::Exception& e)
     {
         log_error << e.what() << " in ~PageStore()"; // abort() ?
     }
 
+    {
+        gu::Lock lock(io_mtx_);
+        io_exit_ = true;
+        io_cond_.signal();
+    }
+    pthread_join (io_thr_, NULL);
+
     if (pages_.size() > 0)
     {
         log_error << "Could not delete " << pages_.size()
                   << " page files: some buffers are still \"mmapped\".";
     }
-
-    pthread_attr_destroy (&delete_page_attr_);
 }
 
 inline void*
@@ -11,8 +11,11 @@
 #include "gcache_page.hpp"
 #include "gcache_seqno.hpp"
 
+#include <gu_lock.hpp>
+
 #include <string>
 #include <deque>
+#include <algorithm>
 
 namespace gcache
 {
@@ -63,6 +66,36 @@ namespace gcache
 
     private:
 
+        /* task for the background I/O worker thread */
+        struct IOTask
+        {
+            enum Type
+            {
+                REMOVE,     /* unlink a page file          */
+                PREPARE,    /* pre-create the next page    */
+                DROP_CACHE  /* writeback + cache release   */
+            };
+
+            int         type;
+            std::string name; /* REMOVE */
+            const Page* page; /* DROP_CACHE */
+
+            IOTask() : type(REMOVE), name(), page(0) { }
+
+            /* explicit copying keeps -Weffc++ quiet about the raw
+             * pointer member; tasks are values queued in a deque */
+            IOTask(const IOTask& other)
+                : type(other.type), name(other.name), page(other.page) { }
+
+            IOTask& operator= (const IOTask& other)
+            {
+                type = other.type;
+                name = other.name;
+                page = other.page;
+                return *this;
+            }
+        };
+
         std::string const base_name_; /* /.../.../gcache.page. */
         size_t            keep_size_; /* how much pages to keep after freeing*/
         size_t            page_size_; /* min size of the individual page */
@@ -71,13 +104,44 @@ namespace gcache
         std::deque<Page*> pages_;
         Page*             current_;
         size_t            total_size_;
-        pthread_attr_t    delete_page_attr_;
-#ifndef GCACHE_DETACH_THREAD
-        pthread_t         delete_thr_;
-#endif /* GCACHE_DETACH_THREAD */
+        gu::Mutex          io_mtx_;
+        gu::Cond           io_cond_;  /* worker wakeup        */
+        gu::Cond           io_done_;  /* drain/cancel wakeup  */
+        std::deque<IOTask> io_queue_;
+        const Page*        io_busy_page_; /* DROP_CACHE in flight */
+        int                io_waiters_;   /* threads blocked in io_drain() */
+        bool               io_exit_;
+        bool               io_idle_;
+        pthread_t          io_thr_;
+        Page*             prep_page_; /* pre-created page waiting for use */
+        std::string       prep_name_;
+        size_t            prep_size_;
 
         void new_page    (size_type size);
 
+        // queues pre-creation of one standard page in the background
+        void start_prepare ();
+
+        // waits for queued I/O to finish, makes prep_page_ safe to access
+        void join_prepare  ();
+
+        // deletes prepared page (if any) together with its file
+        void discard_prepared ();
+
+        /* background I/O worker: executes queued file removals, page
+         * preparation and cache writeback so that the allocation and
+         * free paths never block on disk */
+        static void* io_worker_cb (void*);
+        void io_worker      ();
+        void io_execute     (const IOTask&);
+        void io_submit      (const IOTask&);
+        void io_drain       ();
+        // drops queued and in-flight DROP_CACHE tasks for a dying page
+        void io_cancel_drop (const Page*);
+
+        // true if every queued task may wait for a replication lull
+        bool io_deferrable () const;
+
         // returns true if a page could be deleted
         bool delete_page ();
 
@@ -90,7 +154,27 @@ namespace gcache
         free_page_ptr (Page* page, BufferHeader* bh)
         {
             page->free(bh);
-            if (0 == page->used()) cleanup();
+
+            if (0 == page->used())
+            {
+                cleanup();
+
+                /* if the page survived cleanup (keep policy or a pinned
+                 * older page ahead of it), its contents are dead weight
+                 * until the page is reused - release them from RAM.
+                 * The release forces writeback of dirty pages, so it is
+                 * handed to the I/O worker instead of blocking the
+                 * caller, which sits on the replication free path. */
+                if (page != current_ &&
+                    std::find(pages_.begin(), pages_.end(), page) !=
+                    pages_.end())
+                {
+                    IOTask task;
+                    task.type = IOTask::DROP_CACHE;
+                    task.page = page;
+                    io_submit(task);
+                }
+            }
         }
 
         PageStore(const gcache::PageStore&);
@@ -18,10 +18,20 @@ static const std::string GCACHE_PARAMS_KEEP_PAGES_SIZE("gcache.keep_pages_size")
 static const std::string GCACHE_PARAMS_KEEP_PAGES_COUNT("gcache.keep_pages_count");
 static const std::string GCACHE_DEFAULT_KEEP_PAGES_SIZE("0");
 static const std::string GCACHE_DEFAULT_KEEP_PAGES_COUNT("0");
+static const std::string GCACHE_PARAMS_FLUSH_SIZE ("gcache.flush_size");
+static const std::string GCACHE_DEFAULT_FLUSH_SIZE("0");
 static const std::string GCACHE_PARAMS_RECOVER    ("gcache.recover");
 static const std::string GCACHE_DEFAULT_RECOVER   ("no");
+static const std::string GCACHE_PARAMS_JOURNAL    ("gcache.journal");
+static const std::string GCACHE_DEFAULT_JOURNAL   ("no");
 static const std::string GCACHE_PARAMS_FREEZE_PURGE_SEQNO("gcache.freeze_purge_at_seqno");
 static const std::string GCACHE_DEFAULT_FREEZE_PURGE_SEQNO("-1");
+static const std::string GCACHE_PARAMS_THP        ("gcache.thp");
+static const std::string GCACHE_DEFAULT_THP       ("no");
+static const std::string GCACHE_PARAMS_MLOCK_SIZE ("gcache.mlock_size");
+static const std::string GCACHE_DEFAULT_MLOCK_SIZE("0");
+static const std::string GCACHE_PARAMS_NUMA_INTERLEAVE ("gcache.numa_interleave");
+static const std::string GCACHE_DEFAULT_NUMA_INTERLEAVE("no");
 
 void
 gcache::GCache::Params::register_params(gu::Config& cfg)
@@ -33,8 +43,13 @@ gcache::GCache::Params::register_params(gu::Config& cfg)
     cfg.add(GCACHE_PARAMS_PAGE_SIZE,        GCACHE_DEFAULT_PAGE_SIZE);
     cfg.add(GCACHE_PARAMS_KEEP_PAGES_SIZE,  GCACHE_DEFAULT_KEEP_PAGES_SIZE);
     cfg.add(GCACHE_PARAMS_KEEP_PAGES_COUNT, GCACHE_DEFAULT_KEEP_PAGES_COUNT);
+    cfg.add(GCACHE_PARAMS_FLUSH_SIZE,       GCACHE_DEFAULT_FLUSH_SIZE);
     cfg.add(GCACHE_PARAMS_RECOVER,          GCACHE_DEFAULT_RECOVER);
+    cfg.add(GCACHE_PARAMS_JOURNAL,          GCACHE_DEFAULT_JOURNAL);
     cfg.add(GCACHE_PARAMS_FREEZE_PURGE_SEQNO, GCACHE_DEFAULT_FREEZE_PURGE_SEQNO);
+    cfg.add(GCACHE_PARAMS_THP,              GCACHE_DEFAULT_THP);
+    cfg.add(GCACHE_PARAMS_MLOCK_SIZE,       GCACHE_DEFAULT_MLOCK_SIZE);
+    cfg.add(GCACHE_PARAMS_NUMA_INTERLEAVE,  GCACHE_DEFAULT_NUMA_INTERLEAVE);
 }
 
 static const std::string&
@@ -71,8 +86,13 @@ gcache::GCache::Params::Params (gu::Config& cfg, const std::string& data_dir)
     page_size_(cfg.get<size_t>(GCACHE_PARAMS_PAGE_SIZE)),
     keep_pages_size_(cfg.get<size_t>(GCACHE_PARAMS_KEEP_PAGES_SIZE)),
     keep_pages_count_(cfg.get<size_t>(GCACHE_PARAMS_KEEP_PAGES_COUNT)),
+    flush_size_(cfg.get<size_t>(GCACHE_PARAMS_FLUSH_SIZE)),
     recover_  (cfg.get<bool>(GCACHE_PARAMS_RECOVER)),
-    freeze_purge_at_seqno_(cfg.get<seqno_t>(GCACHE_PARAMS_FREEZE_PURGE_SEQNO))
+    journal_  (cfg.get<bool>(GCACHE_PARAMS_JOURNAL)),
+    freeze_purge_at_seqno_(cfg.get<seqno_t>(GCACHE_PARAMS_FREEZE_PURGE_SEQNO)),
+    thp_      (cfg.get<bool>(GCACHE_PARAMS_THP)),
+    mlock_size_(cfg.get<size_t>(GCACHE_PARAMS_MLOCK_SIZE)),
+    numa_interleave_(cfg.get<bool>(GCACHE_PARAMS_NUMA_INTERLEAVE))
 {}
 
 void
@@ -148,11 +168,28 @@ gcache::GCache::param_set (const std::string& key, const std::string& val)
                           params.keep_pages_count() :
                           !((params.mem_size() + params.rb_size()) > 0));
    }
+   else if (key == GCACHE_PARAMS_FLUSH_SIZE)
+   {
+        size_t tmp_size = gu::Config::from_config<size_t>(val);
+
+        gu::Lock lock(mtx);
+        /* locking here serves two purposes: ensures atomic setting of config
+         * and params and syncs with malloc() method */
+
+        config.set<size_t>(key, tmp_size);
+        params.flush_size(tmp_size);
+        rb.set_flush_size(params.flush_size());
+   }
    else if (key == GCACHE_PARAMS_RECOVER)
    {
        gu_throw_error(EINVAL) << "'" << key
                               << "' has a meaning only on startup.";
    }
+   else if (key == GCACHE_PARAMS_JOURNAL)
+   {
+       gu_throw_error(EINVAL) << "'" << key
+                              << "' has a meaning only on startup.";
+   }
    else if (key == GCACHE_PARAMS_FREEZE_PURGE_SEQNO)
    {
         seqno_t seqno = -1;
@@ -181,6 +218,43 @@ gcache::GCache::param_set (const std::string& key, const std::string& val)
         params.freeze_purge_at_seqno(seqno);
         rb.set_freeze_purge_at_seqno(seqno);
    }
+   else if (key == GCACHE_PARAMS_THP)
+   {
+        bool const tmp(gu::Config::from_config<bool>(val));
+
+        gu::Lock lock(mtx);
+        /* locking here serves two purposes: ensures atomic setting of config
+         * and params. */
+
+        config.set<bool>(key, tmp);
+        params.thp(tmp);
+        rb.set_thp(tmp);
+   }
+   else if (key == GCACHE_PARAMS_MLOCK_SIZE)
+   {
+        size_t tmp_size = gu::Config::from_config<size_t>(val);
+
+        gu::Lock lock(mtx);
+        /* locking here serves two purposes: ensures atomic setting of config
+         * and params. */
+
+        config.set<size_t>(key, tmp_size);
+        params.mlock_size(tmp_size);
+        rb.set_mlock_size(tmp_size);
+   }
+   else if (key == GCACHE_PARAMS_NUMA_INTERLEAVE)
+   {
+        bool const tmp(gu::Config::from_config<bool>(val));
+
+        gu::Lock lock(mtx);
+        /* locking here serves two purposes: ensures atomic setting of config
+         * and params. Note that the policy only affects pages faulted in
+         * after the change, resident ones stay where they are. */
+
+        config.set<bool>(key, tmp);
+        params.numa_interleave(tmp);
+        rb.set_numa_interleave(tmp);
+   }
    else
    {
        throw gu::NotFound();
@@ -2,6 +2,10 @@
  * Copyright (C) 2010-2016 Codership Oy <info@codership.com>
  */
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE // sync_file_range()
+#endif
+
 #include "gcache_rb_store.hpp"
 #include "gcache_page_store.hpp"
 #include "gcache_mem_store.hpp"
@@ -12,8 +16,18 @@
 #include <gu_progress.hpp>
 #include <gu_hexdump.hpp>
 #include <gu_hash.h>
+#include <gu_lock.hpp>
+#include <gu_threads.h>
 
 #include <cassert>
+#include <cerrno>
+#include <cstdio>  // remove()
+#include <cstring> // memcmp()
+#include <fstream>
+#include <map>
+#include <vector>
+#include <fcntl.h>  // sync_file_range()
+#include <unistd.h> // sysconf()
 
 namespace gcache
 {
@@ -26,6 +40,7 @@ namespace gcache
     RingBuffer::reset()
     {
         write_preamble(false);
+        journal_reset();
 
         first_ = start_;
         next_  = start_;
@@ -47,7 +62,8 @@ namespace gcache
                             size_t             size,
                             seqno2ptr_t&       seqno2ptr,
                             gu::UUID&          gid,
-                            bool const         recover)
+                            bool const         recover,
+                            bool const         journal)
     :
 #ifdef HAVE_PSI_INTERFACE
         fd_        (name, WSREP_PFS_INSTR_TAG_RINGBUFFER_FILE, check_size(size)),
@@ -66,21 +82,32 @@ namespace gcache
         seqno2ptr_ (seqno2ptr),
         gid_       (gid),
         freeze_purge_at_seqno_(SEQNO_ILL),
+        flush_size_(0),
+        flushed_   (start_),
         size_cache_(end_ - start_ - sizeof(BufferHeader)),
         size_free_ (size_cache_),
         size_used_ (0),
         size_trail_(0),
 //        mallocs_   (0),
 //        reallocs_  (0),
-        open_      (true)
+        open_      (true),
+        journal_enabled_(journal),
+        journal_fd_(-1),
+        journal_gen_(0),
+        journal_count_(0),
+        journal_batch_()
     {
         constructor_common ();
         open_preamble(recover);
+        /* journals of the previous session were consumed by recovery
+         * above - start the new session from scratch */
+        journal_reset();
         BH_clear (BH_cast(next_));
     }
 
     RingBuffer::~RingBuffer ()
     {
+        journal_close();
         close_preamble();
         open_ = false;
         mmap_.sync();
@@ -148,6 +175,17 @@ namespace gcache
     }
 
     // returns pointer to buffer data area or 0 if no space found
+    //
+    // NOTE: allocation happens only at the rolling head on purpose. The
+    //       ring is a log, not a heap: buffer headers chain by size from
+    //       first_, which is what recovery scans after a crash and what
+    //       keeps consecutive seqnos physically adjacent for sequential
+    //       IST reads. Size-classed reuse of released interior space
+    //       would break the header chain and fragment that locality.
+    //       When the head is blocked by a pinned old buffer the relief
+    //       valve is above this layer: GCache::malloc() overflows into
+    //       the page store, so writers fall through to mmapped pages
+    //       instead of waiting for the ring (see gcache.page_size).
     BufferHeader*
     RingBuffer::get_new_buffer (size_type const size)
     {
@@ -278,9 +316,48 @@ namespace gcache
         BH_clear (BH_cast(next_));
         assert_sizes();
 
+        flush_dirty();
+
         return bh;
     }
 
+    /* initiates writeback of mmapped pages dirtied since the last call once
+     * their amount exceeds flush_size_. Spreads the flushing effort evenly
+     * over the allocation stream instead of leaving the whole cache to the
+     * kernel dirty page expiry, which tends to come in bulk bursts that
+     * compete with transaction commits for IO. SYNC_FILE_RANGE_WRITE only
+     * starts the writeback and does not wait for it, so this is cheap to
+     * call under the cache mutex. */
+    void
+    RingBuffer::flush_dirty ()
+    {
+        if (gu_likely(0 == flush_size_)) return;
+
+        if (gu_unlikely(flushed_ > next_))
+        {
+            /* head rolled over, leave the abandoned tail to the kernel */
+            flushed_ = start_;
+        }
+
+        size_t const dirty(next_ - flushed_);
+
+        if (dirty < flush_size_) return;
+
+#if defined(__linux__)
+        off_t const offset(flushed_ - static_cast<uint8_t*>(mmap_.ptr));
+
+        if (sync_file_range (fd_.get(), offset, dirty, SYNC_FILE_RANGE_WRITE))
+        {
+            int const err(errno);
+            log_warn << "Failed to initiate writeback of " << dirty
+                     << " bytes at offset " << offset << ": " << err
+                     << " (" << strerror(err) << ")";
+        }
+#endif /* __linux__ */
+
+        flushed_ = next_;
+    }
+
     void*
     RingBuffer::malloc (size_type const size)
     {
@@ -415,6 +492,7 @@ namespace gcache
     RingBuffer::seqno_reset()
     {
         write_preamble(false);
+        journal_reset(); /* the old history must not disprove the new one */
 
         if (size_cache_ == size_free_) return;
 
@@ -663,15 +741,23 @@ namespace gcache
                 log_info << "Recovering GCache ring buffer: version: " << version
                          << ", UUID: " << gid_ << ", offset: " << offset;
 
-                try
-                {
-                    recover(offset - (start_ - preamble));
-                }
-                catch (gu::Exception& e)
+                /* after a clean shutdown the index sidecar restores the
+                 * seqno map without scanning the whole file */
+                bool recovered(synced &&
+                               read_index(seqno_min, seqno_max, offset));
+
+                if (!recovered)
                 {
-                    log_warn << "Failed to recover GCache ring buffer: "
-                             << e.what();
-                    reset();
+                    try
+                    {
+                        recover(offset - (start_ - preamble));
+                    }
+                    catch (gu::Exception& e)
+                    {
+                        log_warn << "Failed to recover GCache ring buffer: "
+                                 << e.what();
+                        reset();
+                    }
                 }
             }
             else
@@ -687,7 +773,715 @@ namespace gcache
     void
     RingBuffer::close_preamble()
     {
+        bool const indexed(prepare_index());
+
         write_preamble(true);
+
+        if (indexed)
+        {
+            write_index();
+        }
+        else
+        {
+            remove(index_name().c_str()); /* don't leave a stale index */
+        }
+    }
+
+    std::string
+    RingBuffer::index_name() const
+    {
+        return fd_.name() + ".index";
+    }
+
+    /* Trims the seqno map down to what will survive restart - the last
+     * contiguous run of RB-resident seqnos - and settles the accounting of
+     * everything dropped the way recovery scan would, so that write_index()
+     * can store a consistent snapshot. Returns false when the cache state
+     * does not allow a trustworthy index (recovery will do a full scan). */
+    bool
+    RingBuffer::prepare_index()
+    {
+        /* the index assumes every buffer is released: flags on storage are
+         * then final and no used space needs to be rediscovered */
+        if (0 != size_used_ || seqno2ptr_.empty()) return false;
+
+        seqno_t const seqno_max(seqno2ptr_.rbegin()->first);
+        seqno_t       tail_min(seqno_max + 1);
+
+        for (seqno2ptr_t::reverse_iterator r(seqno2ptr_.rbegin());
+             r != seqno2ptr_.rend() && r->first + 1 == tail_min &&
+                 BUFFER_IN_RB == ptr2BH(r->second)->store; ++r)
+        {
+            tail_min = r->first;
+        }
+
+        if (tail_min > seqno_max) return false; /* newest buffer not in RB */
+
+        /* seqnos below the tail either live in other stores (gone after
+         * restart) or precede a gap; mark their RB buffers empty and credit
+         * the space as discarded, like recovery would */
+        for (seqno2ptr_t::iterator i(seqno2ptr_.begin());
+             i != seqno2ptr_.end() && i->first < tail_min;)
+        {
+            BufferHeader* const bh(ptr2BH(i->second));
+
+            if (gu_unlikely(!BH_is_released(bh))) return false;
+
+            if (BUFFER_IN_RB == bh->store)
+            {
+                empty_buffer(bh);
+                size_free_ += bh->size;
+                assert(size_free_ <= size_cache_);
+            }
+
+            seqno2ptr_.erase(i++);
+        }
+
+        return true;
+    }
+
+    void
+    RingBuffer::write_index()
+    {
+        std::string const name(index_name());
+        std::ofstream os(name.c_str(), std::ios::binary | std::ios::trunc);
+
+        if (!os)
+        {
+            log_warn << "Failed to open '" << name
+                     << "' for writing. Next recovery will do a full scan.";
+            return;
+        }
+
+        uint8_t* const preamble(reinterpret_cast<uint8_t*>(preamble_));
+        size_t   const count(seqno2ptr_.size());
+
+        std::vector<int64_t> rec;
+        rec.reserve(2*count);
+
+        for (seqno2ptr_t::iterator i(seqno2ptr_.begin());
+             i != seqno2ptr_.end(); ++i)
+        {
+            rec.push_back(i->first);
+            rec.push_back(static_cast<const uint8_t*>(i->second) - preamble);
+        }
+
+        uint8_t hash[16];
+        gu_fast_hash128(&rec[0], rec.size()*sizeof(int64_t), hash);
+
+        os << PR_KEY_VERSION   << ' ' << 1 << '\n'
+           << PR_KEY_GID       << ' ' << gid_ << '\n'
+           << PR_KEY_SEQNO_MIN << ' ' << seqno2ptr_.begin()->first  << '\n'
+           << PR_KEY_SEQNO_MAX << ' ' << seqno2ptr_.rbegin()->first << '\n'
+           << PR_KEY_OFFSET    << ' ' << first_ - preamble << '\n'
+           << "next: "   << next_ - preamble << '\n'
+           << "trail: "  << size_trail_      << '\n'
+           << "free: "   << size_free_       << '\n'
+           << '\n';
+
+        os.write(reinterpret_cast<const char*>(&rec[0]),
+                 rec.size()*sizeof(int64_t));
+        os.write(reinterpret_cast<const char*>(hash), sizeof(hash));
+
+        if (!os)
+        {
+            log_warn << "Failed to write '" << name
+                     << "'. Next recovery will do a full scan.";
+            os.close();
+            remove(name.c_str());
+        }
+        else
+        {
+            log_info << "Wrote GCache ring buffer index: " << count
+                     << " seqnos.";
+        }
+    }
+
+    /* Attempts to restore the seqno map and buffer layout from the index
+     * written at clean shutdown, instead of scanning the whole cache file
+     * buffer by buffer. Trusted only when the preamble says the cache was
+     * synced, and cross-checked against the preamble seqno range, offset
+     * and the index record hash. Buffer headers are not touched here:
+     * released flags were synced at shutdown, and bh->ctx is dereferenced
+     * only for mem/page buffers, which don't survive restart anyway. */
+    bool
+    RingBuffer::read_index(int64_t const seqno_min, int64_t const seqno_max,
+                           off_t const offset)
+    {
+        static const char* const diag_prefix("GCache ring buffer index: ");
+
+        std::string const name(index_name());
+        std::ifstream is(name.c_str(), std::ios::binary);
+
+        if (!is) return false; /* no index - no news */
+
+        int       version(-1);
+        gu::UUID  gid;
+        long long i_min(SEQNO_ILL), i_max(SEQNO_ILL);
+        long long first_off(-1), next_off(-1), trail(-1), free_sz(-1);
+
+        std::string line;
+        while (getline(is, line) && !line.empty())
+        {
+            std::istringstream istr(line);
+            std::string key;
+
+            istr >> key;
+
+            if      (PR_KEY_VERSION   == key) istr >> version;
+            else if (PR_KEY_GID       == key) istr >> gid;
+            else if (PR_KEY_SEQNO_MIN == key) istr >> i_min;
+            else if (PR_KEY_SEQNO_MAX == key) istr >> i_max;
+            else if (PR_KEY_OFFSET    == key) istr >> first_off;
+            else if ("next:"          == key) istr >> next_off;
+            else if ("trail:"         == key) istr >> trail;
+            else if ("free:"          == key) istr >> free_sz;
+        }
+
+        if (1 != version || gid != gid_ ||
+            i_min != seqno_min || i_max != seqno_max ||
+            first_off != static_cast<long long>(offset))
+        {
+            log_info << diag_prefix << "'" << name << "' does not match the "
+                     << "preamble, falling back to full scan.";
+            return false;
+        }
+
+        long long const count(i_max - i_min + 1);
+        long long const lower(start_ -
+                              reinterpret_cast<uint8_t*>(preamble_));
+        long long const upper(end_   -
+                              reinterpret_cast<uint8_t*>(preamble_));
+
+        if (count <= 0 ||
+            static_cast<unsigned long long>(count) >
+            size_cache_/sizeof(BufferHeader)                       ||
+            first_off < lower || first_off >= upper                ||
+            next_off  < lower || next_off  >= upper                ||
+            trail < 0  || static_cast<size_t>(trail) > size_cache_ ||
+            free_sz < 0 || static_cast<size_t>(free_sz) >= size_cache_)
+        {
+            log_warn << diag_prefix << "'" << name << "' is corrupt, "
+                     << "falling back to full scan.";
+            return false;
+        }
+
+        std::vector<int64_t> rec(2*count);
+        uint8_t hash_stored[16];
+        uint8_t hash[16];
+
+        is.read(reinterpret_cast<char*>(&rec[0]),
+                rec.size()*sizeof(int64_t));
+        is.read(reinterpret_cast<char*>(hash_stored), sizeof(hash_stored));
+
+        if (!is || is.peek() != std::ifstream::traits_type::eof())
+        {
+            log_warn << diag_prefix << "'" << name << "' is truncated or "
+                     << "overlong, falling back to full scan.";
+            return false;
+        }
+
+        gu_fast_hash128(&rec[0], rec.size()*sizeof(int64_t), hash);
+
+        if (::memcmp(hash, hash_stored, sizeof(hash)))
+        {
+            log_warn << diag_prefix << "'" << name << "' hash mismatch, "
+                     << "falling back to full scan.";
+            return false;
+        }
+
+        uint8_t* const preamble(reinterpret_cast<uint8_t*>(preamble_));
+
+        for (long long k(0); k < count; k++)
+        {
+            int64_t const seqno(rec[2*k]);
+            int64_t const off  (rec[2*k + 1]);
+
+            if (seqno != i_min + k ||
+                off < lower + static_cast<long long>(sizeof(BufferHeader)) ||
+                off >= upper)
+            {
+                log_warn << diag_prefix << "bogus record " << k << " in '"
+                         << name << "', falling back to full scan.";
+                seqno2ptr_.clear();
+                return false;
+            }
+
+            /* probe the buffers backing the index ends */
+            if (0 == k || count - 1 == k)
+            {
+                const BufferHeader* const bh(ptr2BH(preamble + off));
+
+                if (bh->seqno_g != seqno || !BH_is_released(bh) ||
+                    bh->size <= sizeof(BufferHeader) ||
+                    BUFFER_IN_RB != bh->store)
+                {
+                    log_warn << diag_prefix << "buffer/index mismatch at "
+                             << "seqno " << seqno
+                             << ", falling back to full scan.";
+                    seqno2ptr_.clear();
+                    return false;
+                }
+            }
+
+            seqno2ptr_.insert(seqno2ptr_.end(),
+                              seqno2ptr_pair_t(seqno, preamble + off));
+        }
+
+        first_      = preamble + first_off;
+        next_       = preamble + next_off;
+        size_trail_ = trail;
+        size_free_  = free_sz;
+        size_used_  = 0;
+
+        log_info << diag_prefix << "restored seqnos " << i_min << '-'
+                 << i_max << " (" << count << " buffers), skipping scan.";
+
+        assert_sizes();
+
+        return true;
+    }
+
+    namespace
+    {
+        /* journal records per write + fdatasync batch */
+        static size_t const JOURNAL_BATCH = 64;
+        /* records per journal generation, see journal_flush() */
+        static long long const JOURNAL_GEN_RECORDS = 1 << 16;
+    }
+
+    std::string
+    RingBuffer::journal_name(long long const gen) const
+    {
+        /* two generations alternate, see journal_flush() */
+        return fd_.name() + ((gen & 1) ? ".journal.1" : ".journal.0");
+    }
+
+    /* Opens (truncating) the journal file of the current generation and
+     * writes its text header. The GID in the header is diagnostic only:
+     * the journal never outlives the history it describes - it is reset
+     * on startup and on seqno/history reset - and verification matches
+     * record contents against the recovered buffers anyway. */
+    void
+    RingBuffer::journal_open()
+    {
+        std::string const name(journal_name(journal_gen_));
+
+        journal_fd_ = ::open(name.c_str(), O_WRONLY|O_CREAT|O_TRUNC,
+                             S_IRUSR|S_IWUSR|S_IRGRP);
+
+        if (journal_fd_ < 0)
+        {
+            int const err(errno);
+            log_warn << "Failed to open '" << name << "': " << err << " ("
+                     << strerror(err) << "). Seqno journaling disabled.";
+            return;
+        }
+
+        std::ostringstream os;
+        os << PR_KEY_VERSION << ' ' << 1 << '\n'
+           << PR_KEY_GID     << ' ' << gid_ << '\n'
+           << "gen: " << journal_gen_ << '\n' << '\n';
+
+        if (::write(journal_fd_, os.str().c_str(), os.str().length()) !=
+            static_cast<ssize_t>(os.str().length()))
+        {
+            int const err(errno);
+            log_warn << "Failed to start journal '" << name << "': " << err
+                     << " (" << strerror(err)
+                     << "). Seqno journaling disabled.";
+            ::close(journal_fd_);
+            journal_fd_ = -1;
+            return;
+        }
+
+        journal_count_ = 0;
+    }
+
+    void
+    RingBuffer::journal_close()
+    {
+        if (journal_fd_ < 0) return;
+
+        journal_flush();
+
+        if (journal_fd_ >= 0)
+        {
+            ::close(journal_fd_);
+            journal_fd_ = -1;
+        }
+    }
+
+    /* Restarts the journal from scratch. Called whenever the history the
+     * records describe is abandoned (startup, seqno reset), so that stale
+     * records can never disprove buffers of a new history that happens to
+     * reuse the same seqnos. */
+    void
+    RingBuffer::journal_reset()
+    {
+        if (!journal_enabled_) return;
+
+        if (journal_fd_ >= 0)
+        {
+            ::close(journal_fd_);
+            journal_fd_ = -1;
+        }
+
+        journal_batch_.clear();
+        remove(journal_name(0).c_str());
+        remove(journal_name(1).c_str());
+        journal_gen_ = 0;
+
+        journal_open();
+    }
+
+    void
+    RingBuffer::journal_append(const BufferHeader* const bh)
+    {
+        if (journal_fd_ < 0) return;
+
+        assert(BUFFER_IN_RB == bh->store);
+        assert(bh->seqno_g > 0);
+        assert(bh->size > sizeof(BufferHeader));
+
+        JournalRecord rec;
+        rec.seqno  = bh->seqno_g;
+        rec.offset = reinterpret_cast<const uint8_t*>(bh) -
+                     reinterpret_cast<uint8_t*>(preamble_);
+        rec.size   = bh->size;
+        rec.chk    = gu_fast_hash64(bh + 1, bh->size-sizeof(BufferHeader));
+
+        journal_batch_.push_back(rec);
+
+        if (journal_batch_.size() >= JOURNAL_BATCH) journal_flush();
+    }
+
+    /* Appends the pending batch to the journal file and makes it durable
+     * with a single fdatasync() - one sync per JOURNAL_BATCH writesets is
+     * what keeps the journal affordable on the commit path. When the
+     * current generation is full, switches to the other one (truncating
+     * it): the previous generation keeps covering the preceding window,
+     * so together the two files always describe at least the newest
+     * JOURNAL_GEN_RECORDS seqnos - which is where torn writes from an
+     * unclean shutdown live. */
+    void
+    RingBuffer::journal_flush()
+    {
+        if (journal_fd_ < 0 || journal_batch_.empty())
+        {
+            journal_batch_.clear();
+            return;
+        }
+
+        size_t const bytes(journal_batch_.size()*sizeof(JournalRecord));
+        const char* const buf
+            (reinterpret_cast<const char*>(&journal_batch_[0]));
+
+        ssize_t written(0);
+        while (written < static_cast<ssize_t>(bytes))
+        {
+            ssize_t const n(::write(journal_fd_, buf + written,
+                                    bytes - written));
+            if (n < 0)
+            {
+                if (EINTR == errno) continue;
+
+                int const err(errno);
+                log_warn << "Failed to append seqno journal: " << err
+                         << " (" << strerror(err)
+                         << "). Seqno journaling disabled.";
+                ::close(journal_fd_);
+                journal_fd_ = -1;
+                journal_batch_.clear();
+                return;
+            }
+
+            written += n;
+        }
+
+        if (::fdatasync(journal_fd_))
+        {
+            int const err(errno);
+            log_warn << "Failed to sync seqno journal: " << err << " ("
+                     << strerror(err) << "). Seqno journaling disabled.";
+            ::close(journal_fd_);
+            journal_fd_ = -1;
+            journal_batch_.clear();
+            return;
+        }
+
+        journal_count_ += journal_batch_.size();
+        journal_batch_.clear();
+
+        if (journal_count_ >= JOURNAL_GEN_RECORDS)
+        {
+            ::close(journal_fd_);
+            journal_fd_ = -1;
+            journal_gen_++;
+            journal_open();
+        }
+    }
+
+    /* Cross-checks the buffers recovered by scan() against the journal.
+     * The scan can only judge header plausibility, so a writeset torn by
+     * an unclean shutdown may still pass it; the journal stores a content
+     * checksum taken when the seqno was assigned, which proves the buffer
+     * byte for byte. Returns the highest seqno whose record contradicts
+     * the recovered buffer - that buffer and everything older cannot be
+     * served - or SEQNO_ILL when all covered buffers check out. Buffers
+     * outside journal coverage (rotated away, or crashed before their
+     * batch was synced) keep the scan-level trust they have today. */
+    int64_t
+    RingBuffer::journal_verify()
+    {
+        int64_t ret(SEQNO_ILL);
+
+        if (seqno2ptr_.empty()) return ret;
+
+        typedef std::map<int64_t, JournalRecord> journal_map_t;
+        journal_map_t records;
+
+        long long const lower_off (start_ -
+                                   reinterpret_cast<uint8_t*>(preamble_));
+        long long const upper_off (end_   -
+                                   reinterpret_cast<uint8_t*>(preamble_));
+
+        for (long long gen(0); gen < 2; gen++)
+        {
+            std::string const name(journal_name(gen));
+            std::ifstream is(name.c_str(), std::ios::binary);
+
+            if (!is) continue;
+
+            std::string line;
+            while (getline(is, line) && !line.empty()) {} /* skip header */
+
+            JournalRecord rec;
+            while (is.read(reinterpret_cast<char*>(&rec), sizeof(rec)))
+            {
+                /* an implausible record is ignored, not trusted */
+                if (rec.seqno <= 0                                     ||
+                    rec.offset < lower_off                             ||
+                    rec.size <= static_cast<int64_t>(sizeof(BufferHeader)) ||
+                    rec.offset + rec.size > upper_off) continue;
+
+                /* a seqno is journaled at most once, so the two
+                 * generations never conflict */
+                records[rec.seqno] = rec;
+            }
+            /* a trailing partial record (torn append) stops the loop */
+        }
+
+        if (records.empty()) return ret;
+
+        uint8_t* const preamble(reinterpret_cast<uint8_t*>(preamble_));
+        long long verified(0);
+        long long uncovered(0);
+
+        for (seqno2ptr_t::iterator i(seqno2ptr_.begin());
+             i != seqno2ptr_.end(); ++i)
+        {
+            if (NULL == i->second) continue; /* collision, condemned */
+
+            const BufferHeader* const bh(ptr2BH(i->second));
+            journal_map_t::iterator const j(records.find(i->first));
+
+            if (records.end() == j)
+            {
+                uncovered++;
+                continue;
+            }
+
+            JournalRecord const& rec(j->second);
+
+            if (gu_likely(
+                    rec.offset == reinterpret_cast<const uint8_t*>(bh) -
+                                  preamble                              &&
+                    rec.size   == static_cast<int64_t>(bh->size)        &&
+                    rec.chk    == static_cast<int64_t>(
+                        gu_fast_hash64(bh + 1,
+                                       bh->size - sizeof(BufferHeader)))))
+            {
+                verified++;
+            }
+            else
+            {
+                log_warn << "Seqno journal disproves buffer for seqno "
+                         << i->first
+                         << ": the writeset did not survive intact.";
+                if (i->first > ret) ret = i->first;
+            }
+        }
+
+        log_info << "Seqno journal: " << verified << " buffers verified, "
+                 << uncovered << " outside journal coverage.";
+
+        return ret;
+    }
+
+    namespace
+    {
+        /* the resync predicate of the recovery scan (see
+         * GCACHE_SCAN_BUFFER_TEST below): ptr looks like a buffer header
+         * whose size lands on another plausible header */
+        static bool
+        plausible_buffer(const uint8_t* const ptr,
+                         const uint8_t* const segment_end)
+        {
+            const BufferHeader* const bh(
+                reinterpret_cast<const BufferHeader*>(ptr));
+
+            return (BH_test(bh) && bh->size > 0 &&
+                    ptr + bh->size <= segment_end &&
+                    BH_test(ptr + bh->size));
+        }
+
+        /* Byte-wise search for the first plausible buffer header,
+         * used by recovery to resync to the trailing ring segment when
+         * its start is unknown. After an unclean shutdown the search
+         * can cover most of the ring file, and at one predicate
+         * evaluation per byte it used to burn minutes of a single core
+         * on large caches. The region is a read-only byte range and
+         * the answer is simply the lowest matching position, so the
+         * search partitions perfectly: each worker takes a contiguous
+         * chunk and reports its first match, and the lowest one wins.
+         * A worker abandons its chunk as soon as a match below it is
+         * known. Small regions are scanned inline. */
+        class HeaderSearch
+        {
+        public:
+
+            HeaderSearch(const uint8_t* const from,
+                         const uint8_t* const end,
+                         const uint8_t* const segment_end)
+                :
+                from_       (from),
+                /* positions p with p + sizeof(BufferHeader) < end are
+                 * tested, the first untested position is returned when
+                 * there is no match - exactly like the sequential loop */
+                limit_      (end - sizeof(BufferHeader) > from ?
+                             end - sizeof(BufferHeader) : from),
+                segment_end_(segment_end),
+                lock_       (),
+                best_       (0)
+            { }
+
+            const uint8_t* operator()()
+            {
+                ptrdiff_t const len(limit_ - from_);
+
+                long n(1);
+
+                if (len >= min_parallel_)
+                {
+                    n = sysconf(_SC_NPROCESSORS_ONLN);
+                    if (n < 1) n = 1;
+                    if (n > max_threads_) n = max_threads_;
+                }
+
+                if (1 == n)
+                {
+                    const uint8_t* p(from_);
+                    while (p != limit_ && !plausible_buffer(p, segment_end_))
+                        ++p;
+                    return p;
+                }
+
+                Worker workers[max_threads_];
+                ptrdiff_t const chunk((len + n - 1)/n);
+
+                for (long i(0); i < n; ++i)
+                {
+                    Worker& w(workers[i]);
+                    w.ctx   = this;
+                    w.from  = from_ + i*chunk;
+                    w.to    = std::min(w.from + chunk, limit_);
+                    w.found = 0;
+
+                    if (gu_thread_create(&w.id, 0, worker_func, &w) != 0)
+                    {
+                        run_chunk(w); // no thread - scan inline
+                        w.id = gu_thread_t();
+                        w.joinable = false;
+                    }
+                    else
+                    {
+                        w.joinable = true;
+                    }
+                }
+
+                const uint8_t* found(limit_);
+
+                for (long i(0); i < n; ++i)
+                {
+                    if (workers[i].joinable)
+                        gu_thread_join(workers[i].id, 0);
+
+                    if (workers[i].found != 0 && workers[i].found < found)
+                        found = workers[i].found;
+                }
+
+                return found;
+            }
+
+        private:
+
+            HeaderSearch(const HeaderSearch&);
+            void operator=(const HeaderSearch&);
+
+            static long      const max_threads_  = 8;
+            static ptrdiff_t const min_parallel_ = 1 << 26; /* 64Mb */
+
+            struct Worker
+            {
+                HeaderSearch*  ctx;
+                const uint8_t* from;
+                const uint8_t* to;
+                const uint8_t* found;
+                gu_thread_t    id;
+                bool           joinable;
+            };
+
+            static void* worker_func(void* const arg)
+            {
+                Worker* const w(static_cast<Worker*>(arg));
+                w->ctx->run_chunk(*w);
+                return 0;
+            }
+
+            void run_chunk(Worker& w)
+            {
+                const uint8_t* p(w.from);
+
+                while (p != w.to)
+                {
+                    if (plausible_buffer(p, segment_end_))
+                    {
+                        w.found = p;
+                        gu::SpinGuard guard(lock_);
+                        if (0 == best_ || p < best_) best_ = p;
+                        return;
+                    }
+
+                    ++p;
+
+                    /* periodically check whether an earlier chunk
+                     * already has a match */
+                    if (0 == (reinterpret_cast<uintptr_t>(p) & 0xfffff))
+                    {
+                        gu::SpinGuard guard(lock_);
+                        if (best_ != 0 && best_ < w.from) return;
+                    }
+                }
+            }
+
+            const uint8_t* const from_;
+            const uint8_t* const limit_;
+            const uint8_t* const segment_end_;
+            /* spinlock: both sections are a couple of pointer compares */
+            gu::SpinLock         lock_;
+            const uint8_t*       best_;
+        };
     }
 
     int64_t
@@ -849,13 +1643,13 @@ namespace gcache
                 assert(1 == segment_scans);
                 next_ = ptr;
 
-                while (!GCACHE_SCAN_BUFFER_TEST &&
-                       ptr + sizeof(BufferHeader) < end_)
                 {
-                    progress.update(1);
-                    ptr += 1;
-                    bh = BH_cast(ptr);
                     /* it would have been nice to use alignment of 8 or so */
+                    HeaderSearch search(ptr, end_, segment_end);
+                    uint8_t* const hit(const_cast<uint8_t*>(search()));
+                    progress.update(hit - ptr);
+                    ptr = hit;
+                    bh  = BH_cast(ptr);
                 }
 
                 if (GCACHE_SCAN_BUFFER_TEST)
@@ -915,8 +1709,20 @@ namespace gcache
     {
         static const char* const diag_prefix = "Recovering GCache ring buffer: ";
 
+        /* recovery passes walk the file in ascending order: let the
+         * kernel read ahead aggressively for their duration */
+        mmap_.sequential(true);
+
         /* scan the buffer and populate seqno2ptr map */
-        int64_t const lower(scan(offset));
+        int64_t lower(scan(offset));
+
+        {
+            /* cross-check the scan against the write-ahead seqno
+             * journal: a buffer disproved by its record, and anything
+             * older, must not be served */
+            int64_t const disproved(journal_verify());
+            if (disproved > lower) lower = disproved;
+        }
 
         if (!seqno2ptr_.empty())
         {
@@ -1069,6 +1875,8 @@ namespace gcache
             log_info << diag_prefix << "didn't recover any events.";
             reset();
         }
+
+        mmap_.sequential(false);
     }
 
 } /* namespace gcache */
@@ -16,6 +16,7 @@
 #include <gu_uuid.hpp>
 
 #include <string>
+#include <vector>
 
 namespace gcache
 {
@@ -27,7 +28,8 @@ namespace gcache
                     size_t             size,
                     seqno2ptr_t&       seqno2ptr,
                     gu::UUID&          gid,
-                    bool               recover);
+                    bool               recover,
+                    bool               journal);
 
         ~RingBuffer ();
 
@@ -47,6 +49,10 @@ namespace gcache
 
         size_t size      () const { return size_cache_; }
 
+        /* bytes occupied by buffers, including released but not yet
+         * discarded history */
+        size_t size_used () const { return size_cache_ - size_free_; }
+
         size_t rb_size   () const { return fd_.size(); }
 
         const std::string& rb_name() const { return fd_.name(); }
@@ -118,12 +124,34 @@ namespace gcache
             freeze_purge_at_seqno_ = seqno;
         }
 
+        /* sets dirty page budget for incremental writeback, 0 disables */
+        void set_flush_size(size_t size)
+        {
+            flush_size_ = size;
+            flushed_    = next_;
+        }
+
+        /* transparent hugepage advice for the ring buffer mapping */
+        void set_thp(bool on) { mmap_.hugepage(on); }
+
+        /* mlock() the first size bytes of the mapping, 0 unlocks */
+        void set_mlock_size(size_t size) { mmap_.lock_head(size); }
+
+        /* interleave the mapping over NUMA nodes (affects pages faulted
+         * in after the call) */
+        void set_numa_interleave(bool on) { mmap_.interleave(on); }
+
         bool skip_purge(seqno_t seqno)
         {
             return ((freeze_purge_at_seqno_ == SEQNO_ILL)
                     ? (false) : (seqno >= freeze_purge_at_seqno_));
         }
 
+        /* append a (seqno, offset, checksum) record for a freshly
+         * seqno'd RB buffer to the write-ahead journal, see
+         * journal_flush() */
+        void journal_append(const BufferHeader* bh);
+
     private:
 
         static size_t const PREAMBLE_LEN = 1024;
@@ -144,6 +172,9 @@ namespace gcache
 
         seqno_t            freeze_purge_at_seqno_;
 
+        size_t             flush_size_; // dirty page budget, 0 - no flushing
+        uint8_t*           flushed_;    // writeback initiated up to here
+
         size_t       const size_cache_;
         size_t             size_free_;
         size_t             size_used_;
@@ -153,6 +184,8 @@ namespace gcache
 
         BufferHeader* get_new_buffer (size_type size);
 
+        void          flush_dirty();
+
         void          constructor_common();
 
         /* preamble fields */
@@ -167,6 +200,35 @@ namespace gcache
         void          open_preamble(bool recover);
         void          close_preamble();
 
+        /* seqno index sidecar for O(1) recovery after clean shutdown */
+        std::string   index_name() const;
+        bool          prepare_index();
+        void          write_index();
+        bool          read_index(int64_t seqno_min, int64_t seqno_max,
+                                 off_t offset);
+
+        /* write-ahead seqno journal for crash consistency */
+        struct JournalRecord
+        {
+            int64_t seqno;
+            int64_t offset; // buffer offset from mmap start
+            int64_t size;   // total buffer size
+            int64_t chk;    // content hash
+        };
+
+        bool        const journal_enabled_;
+        int               journal_fd_;   // current generation, -1 if closed
+        long long         journal_gen_;  // generation counter, see flip
+        long long         journal_count_;// records in current generation
+        std::vector<JournalRecord> journal_batch_;
+
+        std::string   journal_name(long long gen) const;
+        void          journal_open();
+        void          journal_close();
+        void          journal_flush();
+        void          journal_reset();
+        int64_t       journal_verify(); // highest disproved seqno or ILL
+
         // returns lower bound (not inclusive) of valid seqno range
         int64_t       scan(off_t offset);
         void          recover(off_t offset);
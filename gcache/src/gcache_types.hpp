@@ -6,13 +6,389 @@
 #define __GCACHE_TYPES__
 
 #include "gcache_seqno.hpp"
-#include <map>
+
+#include <gu_macros.h> // gu_unlikely()
+
+#include <deque>
+#include <utility> // std::pair
+#include <cstddef> // NULL
+#include <cassert>
 
 namespace gcache
 {
-    typedef std::map<seqno_t, const void*>  seqno2ptr_t;
-    typedef seqno2ptr_t::iterator           seqno2ptr_iter_t;
-    typedef std::pair<seqno_t, const void*> seqno2ptr_pair_t;
+    /*!
+     * Flat seqno-to-pointer map.
+     *
+     * Seqnos are assigned in total order, so outside of recovery the mapped
+     * range is dense: every commit appends seqno_max + 1 and purging trims
+     * from the front. A seqno-indexed deque makes insertion and lookup O(1)
+     * instead of the O(log n) of the ordered map this class replaces, and
+     * one slot costs a pointer instead of a tree node.
+     *
+     * Only the subset of the std::map interface that GCache uses is
+     * provided, with the same semantics, so that call sites need not
+     * change. In particular NULL is a legitimate mapped value (recovery
+     * stores it to block colliding seqnos), hence unoccupied slots - gaps
+     * left by out-of-order insertion during recovery scan - are marked by
+     * an internal sentinel distinct from NULL.
+     *
+     * Iterators address elements by seqno, not by slot position, so - like
+     * with std::map - erasing one element does not invalidate iterators to
+     * the others.
+     */
+    class Seqno2PtrMap
+    {
+    public:
+
+        typedef seqno_t                           key_type;
+        typedef const void*                       mapped_type;
+        typedef std::pair<seqno_t, const void*>   value_type;
+        typedef std::deque<mapped_type>::size_type size_type;
+
+        class iterator
+        {
+        public:
+
+            /* map-compatible element access: 'first' is the seqno,
+             * 'second' refers to the stored pointer */
+            struct reference
+            {
+                seqno_t const first;
+                mapped_type&  second;
+
+                reference (seqno_t f, mapped_type& s) : first(f), second(s) {}
+            };
+
+            /* proxy to support it->first, it->second */
+            class pointer
+            {
+            public:
+                pointer (const reference& ref) : ref_(ref) {}
+                reference* operator-> () { return &ref_; }
+            private:
+                reference ref_;
+            };
+
+            iterator () : map_(0), idx_(SEQNO_ILL) {}
+
+            reference operator* () const
+            {
+                return reference (idx_, map_->slot(idx_));
+            }
+
+            pointer operator-> () const { return pointer (**this); }
+
+            iterator& operator++ ()
+            {
+                idx_ = map_->next_occupied (idx_ + 1);
+                return *this;
+            }
+
+            iterator operator++ (int)
+            {
+                iterator const ret(*this);
+                ++(*this);
+                return ret;
+            }
+
+            bool operator== (const iterator& other) const
+            {
+                return (idx_ == other.idx_);
+            }
+
+            bool operator!= (const iterator& other) const
+            {
+                return !(*this == other);
+            }
+
+        private:
+
+            friend class Seqno2PtrMap;
+
+            iterator (Seqno2PtrMap* map, seqno_t idx)
+                : map_(map), idx_(idx) {}
+
+            Seqno2PtrMap* map_;
+            seqno_t       idx_;
+        };
+
+        class const_iterator
+        {
+        public:
+
+            struct reference
+            {
+                seqno_t const first;
+                mapped_type   second;
+
+                reference (seqno_t f, mapped_type s) : first(f), second(s) {}
+            };
+
+            class pointer
+            {
+            public:
+                pointer (const reference& ref) : ref_(ref) {}
+                const reference* operator-> () const { return &ref_; }
+            private:
+                reference ref_;
+            };
+
+            const_iterator () : map_(0), idx_(SEQNO_ILL) {}
+
+            reference operator* () const
+            {
+                return reference (idx_, map_->slot(idx_));
+            }
+
+            pointer operator-> () const { return pointer (**this); }
+
+            const_iterator& operator++ ()
+            {
+                idx_ = map_->next_occupied (idx_ + 1);
+                return *this;
+            }
+
+            bool operator== (const const_iterator& other) const
+            {
+                return (idx_ == other.idx_);
+            }
+
+            bool operator!= (const const_iterator& other) const
+            {
+                return !(*this == other);
+            }
+
+        private:
+
+            friend class Seqno2PtrMap;
+
+            const_iterator (const Seqno2PtrMap* map, seqno_t idx)
+                : map_(map), idx_(idx) {}
+
+            const Seqno2PtrMap* map_;
+            seqno_t             idx_;
+        };
+
+        class reverse_iterator
+        {
+        public:
+
+            typedef iterator::reference reference;
+            typedef iterator::pointer   pointer;
+
+            reverse_iterator () : map_(0), idx_(SEQNO_ILL) {}
+
+            reference operator* () const
+            {
+                return reference (idx_, map_->slot(idx_));
+            }
+
+            pointer operator-> () const { return pointer (**this); }
+
+            reverse_iterator& operator++ ()
+            {
+                idx_ = map_->prev_occupied (idx_ - 1);
+                return *this;
+            }
+
+            bool operator== (const reverse_iterator& other) const
+            {
+                return (idx_ == other.idx_);
+            }
+
+            bool operator!= (const reverse_iterator& other) const
+            {
+                return !(*this == other);
+            }
+
+        private:
+
+            friend class Seqno2PtrMap;
+
+            reverse_iterator (Seqno2PtrMap* map, seqno_t idx)
+                : map_(map), idx_(idx) {}
+
+            Seqno2PtrMap* map_;
+            seqno_t       idx_;
+        };
+
+        Seqno2PtrMap () : slots_(), begin_(SEQNO_NONE), size_(0) {}
+
+        bool      empty () const { return (0 == size_); }
+
+        /*! number of occupied slots (gaps don't count) */
+        size_type size  () const { return size_; }
+
+        void clear ()
+        {
+            slots_.clear();
+            begin_ = SEQNO_NONE;
+            size_  = 0;
+        }
+
+        iterator begin () { return iterator (this, next_occupied(begin_)); }
+        iterator end   () { return iterator (this, end_idx()); }
+
+        const_iterator begin () const
+        {
+            return const_iterator (this, next_occupied(begin_));
+        }
+        const_iterator end () const
+        {
+            return const_iterator (this, end_idx());
+        }
+
+        reverse_iterator rbegin ()
+        {
+            return reverse_iterator (this, prev_occupied(end_idx() - 1));
+        }
+        reverse_iterator rend ()
+        {
+            return reverse_iterator (this, begin_ - 1);
+        }
+
+        iterator find (seqno_t seqno)
+        {
+            return (occupied(seqno) ? iterator (this, seqno) : end());
+        }
+
+        iterator upper_bound (seqno_t seqno)
+        {
+            return iterator (this, next_occupied(seqno + 1));
+        }
+
+        std::pair<iterator, bool> insert (const value_type& v)
+        {
+            assert (v.first > SEQNO_NONE);
+            assert (empty_slot() != v.second);
+
+            if (gu_unlikely(slots_.empty()))
+            {
+                begin_ = v.first;
+                slots_.push_back (empty_slot());
+            }
+            else if (v.first >= end_idx())
+            {
+                slots_.resize (slots_.size() + (v.first - end_idx() + 1),
+                               empty_slot());
+            }
+            else if (v.first < begin_)
+            {
+                slots_.insert (slots_.begin(), begin_ - v.first, empty_slot());
+                begin_ = v.first;
+            }
+            else if (empty_slot() != slot(v.first))
+            {
+                return std::pair<iterator, bool>(iterator (this, v.first),
+                                                 false);
+            }
+
+            slot(v.first) = v.second;
+            ++size_;
+
+            return std::pair<iterator, bool>(iterator (this, v.first), true);
+        }
+
+        /*! hint is ignored - insertion position follows from the seqno */
+        iterator insert (iterator, const value_type& v)
+        {
+            return insert(v).first;
+        }
+
+        void erase (iterator i)
+        {
+            assert (this == i.map_);
+            assert (occupied(i.idx_));
+
+            slot(i.idx_) = empty_slot();
+            --size_;
+
+            /* trim unoccupied slots at the front: keeps begin() O(1) and
+             * (since begin_ advances by the number of slots popped) leaves
+             * end_idx() - and so stored end iterators - intact */
+            while (!slots_.empty() && empty_slot() == slots_.front())
+            {
+                slots_.pop_front();
+                ++begin_;
+            }
+        }
+
+        void erase (iterator i_begin, iterator i_end)
+        {
+            while (i_begin != i_end) erase (i_begin++);
+        }
+
+        mapped_type& operator[] (seqno_t seqno)
+        {
+            if (!occupied(seqno)) insert (value_type(seqno, NULL));
+            return slot(seqno);
+        }
+
+    private:
+
+        /*! seqno one past the last slot; erase() preserves it */
+        seqno_t end_idx () const
+        {
+            return (begin_ + static_cast<seqno_t>(slots_.size()));
+        }
+
+        /*! sentinel address marking an unoccupied slot (NULL is a valid
+         *  mapped value, see scan() collision handling in RingBuffer) */
+        static mapped_type empty_slot ()
+        {
+            static const char sentinel(0);
+            return &sentinel;
+        }
+
+        bool occupied (seqno_t seqno) const
+        {
+            return (seqno >= begin_ && seqno < end_idx() &&
+                    empty_slot() != slots_[seqno - begin_]);
+        }
+
+        mapped_type& slot (seqno_t seqno)
+        {
+            assert (seqno >= begin_ && seqno < end_idx());
+            return slots_[seqno - begin_];
+        }
+
+        const mapped_type& slot (seqno_t seqno) const
+        {
+            assert (seqno >= begin_ && seqno < end_idx());
+            return slots_[seqno - begin_];
+        }
+
+        /*! first occupied seqno at or after given, end_idx() if none */
+        seqno_t next_occupied (seqno_t seqno) const
+        {
+            seqno_t const end(end_idx());
+            if (seqno < begin_) seqno = begin_;
+            while (seqno < end && empty_slot() == slots_[seqno - begin_])
+            {
+                ++seqno;
+            }
+            return (seqno < end ? seqno : end);
+        }
+
+        /*! last occupied seqno at or before given, begin_ - 1 if none */
+        seqno_t prev_occupied (seqno_t seqno) const
+        {
+            if (seqno >= end_idx()) seqno = end_idx() - 1;
+            while (seqno >= begin_ && empty_slot() == slots_[seqno - begin_])
+            {
+                --seqno;
+            }
+            return (seqno >= begin_ ? seqno : begin_ - 1);
+        }
+
+        std::deque<mapped_type> slots_; // seqno s maps to slots_[s - begin_]
+        seqno_t                 begin_; // seqno of slots_.front()
+        size_type               size_;  // number of occupied slots
+    };
+
+    typedef Seqno2PtrMap             seqno2ptr_t;
+    typedef seqno2ptr_t::iterator    seqno2ptr_iter_t;
+    typedef seqno2ptr_t::value_type  seqno2ptr_pair_t;
 
 } /* namespace gcache */
 
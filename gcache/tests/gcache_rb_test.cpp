@@ -28,9 +28,9 @@ START_TEST(test1)
 
     size_t const rb_size(ALLOC_SIZE(2) * 2);
 
-    std::map<int64_t, const void*> s2p;
+    seqno2ptr_t s2p;
     gu::UUID   gid(GID);
-    RingBuffer rb(RB_NAME, rb_size, s2p, gid, false);
+    RingBuffer rb(RB_NAME, rb_size, s2p, gid, false, false);
 
     fail_if (rb.size() != rb_size, "Expected %zd, got %zd", rb_size, rb.size());
 
@@ -139,7 +139,8 @@ START_TEST(recovery)
         RingBuffer   rb;
 
         rb_ctx(size_t s, bool recover = true) :
-            size(s), s2p(), gid(GID), rb(RB_NAME, size, s2p, gid, recover) {}
+            size(s), s2p(), gid(GID),
+            rb(RB_NAME, size, s2p, gid, recover, false) {}
 
         void seqno_assign (seqno2ptr_t& s2p, void* const ptr,
                            seqno_t const g, seqno_t const d)
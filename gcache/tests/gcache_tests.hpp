@@ -8,6 +8,7 @@
 #ifndef __gcache_tests_hpp__
 #define __gcache_tests_hpp__
 
+#include "gcache_types_test.hpp"
 #include "gcache_mem_test.hpp"
 #include "gcache_rb_test.hpp"
 #include "gcache_page_test.hpp"
@@ -20,6 +21,7 @@ typedef Suite *(*suite_creator_t)(void);
 
 static suite_creator_t suites[] =
 {
+    gcache_types_suite,
     gcache_mem_suite,
     gcache_rb_suite,
     gcache_page_suite,
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2016 Codership Oy <info@codership.com>
+ */
+
+#include "gcache_types.hpp"
+#include "gcache_types_test.hpp"
+
+using namespace gcache;
+
+static const char buf[16] = { 0, };
+
+static const void* ptr(int i) { return buf + i; }
+
+/* dense append + lookup, the common operational pattern */
+START_TEST(test_types_dense)
+{
+    seqno2ptr_t s2p;
+
+    fail_unless(s2p.empty());
+    fail_if    (s2p.size() != 0);
+    fail_unless(s2p.begin() == s2p.end());
+    fail_unless(s2p.find(1) == s2p.end());
+
+    for (seqno_t s(1); s <= 4; ++s)
+    {
+        std::pair<seqno2ptr_iter_t, bool> const res
+            (s2p.insert(seqno2ptr_pair_t(s, ptr(s))));
+        fail_unless(res.second);
+        fail_if    (res.first->first  != s);
+        fail_if    (res.first->second != ptr(s));
+    }
+
+    fail_if (s2p.size() != 4);
+
+    /* duplicate insertion reports the existing element */
+    std::pair<seqno2ptr_iter_t, bool> const dup
+        (s2p.insert(seqno2ptr_pair_t(2, ptr(7))));
+    fail_if     (dup.second);
+    fail_if     (dup.first->second != ptr(2));
+
+    seqno_t expect(1);
+    for (seqno2ptr_iter_t i(s2p.begin()); i != s2p.end(); ++i, ++expect)
+    {
+        fail_if ((*i).first  != expect);
+        fail_if ((*i).second != ptr(expect));
+    }
+    fail_if (expect != 5);
+
+    fail_unless(s2p.find(3)  != s2p.end());
+    fail_if    (s2p.find(3)->second != ptr(3));
+    fail_unless(s2p.find(5)  == s2p.end());
+    fail_unless(s2p.find(0)  == s2p.end());
+
+    fail_if    (s2p.upper_bound(2)->first != 3);
+    fail_unless(s2p.upper_bound(4) == s2p.end());
+
+    fail_if (s2p.rbegin()->first != 4);
+}
+END_TEST
+
+/* out-of-order insertion during recovery scan: gaps, prepending,
+ * NULL as a legitimate mapped value */
+START_TEST(test_types_sparse)
+{
+    seqno2ptr_t s2p;
+
+    fail_unless(s2p.insert(seqno2ptr_pair_t(5, ptr(5))).second);
+    fail_unless(s2p.insert(seqno2ptr_pair_t(9, ptr(9))).second);
+    fail_unless(s2p.insert(seqno2ptr_pair_t(3, ptr(3))).second);
+
+    fail_if (s2p.size() != 3);
+
+    /* iteration skips the gaps in both directions */
+    seqno2ptr_iter_t i(s2p.begin());
+    fail_if (i->first != 3); ++i;
+    fail_if (i->first != 5); ++i;
+    fail_if (i->first != 9); ++i;
+    fail_unless(i == s2p.end());
+
+    seqno2ptr_t::reverse_iterator r(s2p.rbegin());
+    fail_if (r->first != 9); ++r;
+    fail_if (r->first != 5); ++r;
+    fail_if (r->first != 3); ++r;
+    fail_unless(r == s2p.rend());
+
+    fail_unless(s2p.find(4) == s2p.end());
+    fail_if    (s2p.upper_bound(5)->first != 9);
+
+    /* collision handling stores NULL to condemn a seqno - NULL must be
+     * distinguishable from an unoccupied slot */
+    s2p[7] = NULL;
+    fail_if    (s2p.size() != 4);
+    fail_unless(s2p.find(7) != s2p.end());
+    fail_if    (s2p.find(7)->second != NULL);
+    fail_unless(s2p.find(6) == s2p.end());
+
+    s2p[7] = ptr(7);
+    fail_if (s2p.size() != 4); /* overwrite, not a new element */
+    fail_if (s2p.find(7)->second != ptr(7));
+}
+END_TEST
+
+/* front-trimming erase: begin() advances, stored end() stays valid */
+START_TEST(test_types_erase)
+{
+    seqno2ptr_t s2p;
+
+    for (seqno_t s(1); s <= 8; ++s)
+    {
+        s2p.insert(seqno2ptr_pair_t(s, ptr(s)));
+    }
+
+    seqno2ptr_iter_t const end(s2p.end());
+
+    /* purge from the front like discard_seqno() does */
+    s2p.erase(s2p.begin(), s2p.upper_bound(3));
+    fail_if (s2p.size() != 5);
+    fail_if (s2p.begin()->first != 4);
+    fail_unless(s2p.find(3) == s2p.end());
+    fail_unless(end == s2p.end());
+
+    /* erasing in the middle leaves neighbors addressable */
+    s2p.erase(s2p.find(6));
+    fail_if (s2p.size() != 4);
+    fail_unless(s2p.find(6) == s2p.end());
+    fail_if    (s2p.find(5)->second != ptr(5));
+    fail_if    (s2p.find(7)->second != ptr(7));
+
+    /* front trimming triggered by erasing the last front element */
+    s2p.erase(s2p.find(4));
+    s2p.erase(s2p.find(5));
+    fail_if (s2p.begin()->first != 7);
+    fail_unless(end == s2p.end());
+
+    s2p.erase(s2p.begin(), s2p.end());
+    fail_unless(s2p.empty());
+    fail_unless(s2p.begin() == s2p.end());
+
+    /* reusable after full erase and after clear() */
+    fail_unless(s2p.insert(seqno2ptr_pair_t(20, ptr(1))).second);
+    fail_if (s2p.begin()->first != 20);
+
+    s2p.clear();
+    fail_unless(s2p.empty());
+    fail_unless(s2p.insert(seqno2ptr_pair_t(2, ptr(2))).second);
+    fail_if (s2p.size() != 1);
+}
+END_TEST
+
+Suite* gcache_types_suite()
+{
+    Suite* s = suite_create("gcache::Seqno2PtrMap");
+    TCase* tc;
+
+    tc = tcase_create("test");
+    tcase_add_test(tc, test_types_dense);
+    tcase_add_test(tc, test_types_sparse);
+    tcase_add_test(tc, test_types_erase);
+    suite_add_tcase(s, tc);
+
+    return s;
+}
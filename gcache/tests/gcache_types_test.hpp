@@ -0,0 +1,13 @@
+/*
+ * Copyright (C) 2016 Codership Oy <info@codership.com>
+ */
+#ifndef __gcache_types_test_hpp__
+#define __gcache_types_test_hpp__
+
+extern "C" {
+#include <check.h>
+}
+
+extern Suite* gcache_types_suite();
+
+#endif // __gcache_types_test_hpp__
@@ -109,6 +109,25 @@ gu::datetime::Period handle_timers_helper(gcomm::Protonet&            pnet,
 }
 
 
+/* NOTE: running io_service_ from several threads would not spread the
+ *       protocol work across cores the way one might hope. Every up and
+ *       down call is serialized under the Critical<AsioProtonet> mutex,
+ *       because the GMCast and EVS state machines (and every Protolay in
+ *       between) are single-threaded by contract - so N loop threads
+ *       would mostly contend on that one lock. The per-datagram CPU is
+ *       dominated by dispatch through the protostack, which is exactly
+ *       the part that must stay serialized to preserve EVS ordering;
+ *       only the checksum and SSL cipher work could move off-thread, and
+ *       the checksum must be verified before headers are parsed. Scaling
+ *       past one core here means making the protolay stack re-entrant
+ *       first, which is a protocol-layer redesign, not a protonet mode. */
+/* The loop is batch-shaped already, even though it does not look like a
+ * batch loop: run() drains every ready completion before blocking again,
+ * so handler dispatch is not interleaved with polling; timer processing
+ * is amortized onto the deadline timer below (handle_wait()) instead of
+ * being checked per completion; and outgoing datagrams queued during a
+ * drain are coalesced into one scatter-gather write per socket by
+ * AsioTcpSocket::write_batch(). */
 void gcomm::AsioProtonet::event_loop(const gu::datetime::Period& period)
 {
     io_service_.reset();
@@ -143,16 +162,26 @@ void gcomm::AsioProtonet::interrupt()
 void gcomm::AsioProtonet::handle_wait(const asio::error_code& ec)
 {
     gu::datetime::Date now(gu::datetime::Date::now());
-    const gu::datetime::Period p(handle_timers_helper(*this, poll_until_ - now));
     using std::rel_ops::operator>=;
-    if (ec == asio::error_code() && poll_until_ >= now)
+    if (ec == asio::error_code())
     {
-        timer_.expires_from_now(boost::posix_time::nanosec(p.get_nsecs()));
-        timer_.async_wait(boost::bind(&AsioProtonet::handle_wait, this,
-                                      asio::placeholders::error));
+        const gu::datetime::Period p(handle_timers_helper(*this,
+                                                          poll_until_ - now));
+        if (poll_until_ >= now)
+        {
+            timer_.expires_from_now(boost::posix_time::nanosec(p.get_nsecs()));
+            timer_.async_wait(boost::bind(&AsioProtonet::handle_wait, this,
+                                          asio::placeholders::error));
+        }
+        else
+        {
+            io_service_.stop();
+        }
     }
     else
     {
+        // cancelled wait, the loop is being interrupted - no point in
+        // running every layer's timer computation on the way out
         io_service_.stop();
     }
 }
@@ -6,6 +6,8 @@
 #include "gcomm/util.hpp"
 #include "gcomm/common.hpp"
 
+#include <vector>
+
 
 #define FAILED_HANDLER(_e) failed_handler(_e, __FUNCTION__, __LINE__)
 
@@ -18,6 +20,7 @@ gcomm::AsioTcpSocket::AsioTcpSocket(AsioProtonet& net, const gu::URI& uri)
     ssl_socket_  (0),
 #endif /* HAVE_ASIO_SSL_HPP */
     send_q_      (),
+    staging_buf_ (),
     recv_buf_    (net_.mtu() + NetHeader::serial_size_),
     recv_offset_ (0),
     state_       (S_CLOSED),
@@ -314,14 +317,7 @@ void gcomm::AsioTcpSocket::write_handler(const asio::error_code& ec,
             }
             else if (send_q_.empty() == false)
             {
-                const Datagram& dg(send_q_.front());
-                boost::array<asio::const_buffer, 2> cbs;
-                cbs[0] = asio::const_buffer(dg.header()
-                                            + dg.header_offset(),
-                                            dg.header_len());
-                cbs[1] = asio::const_buffer(&dg.payload()[0],
-                                            dg.payload().size());
-                write_one(cbs);
+                write_batch();
             }
             else if (state_ == S_CLOSING)
             {
@@ -374,14 +370,7 @@ namespace gcomm
             if (socket_->state() == gcomm::Socket::S_CONNECTED &&
                 socket_->send_q_.empty() == false)
             {
-                const gcomm::Datagram& dg(socket_->send_q_.front());
-                boost::array<asio::const_buffer, 2> cbs;
-                cbs[0] = asio::const_buffer(dg.header()
-                                            + dg.header_offset(),
-                                            dg.header_len());
-                cbs[1] = asio::const_buffer(&dg.payload()[0],
-                                            dg.payload().size());
-                socket_->write_one(cbs);
+                socket_->write_batch();
             }
         }
     private:
@@ -466,11 +455,16 @@ void gcomm::AsioTcpSocket::read_handler(const asio::error_code& ec,
         }
         if (recv_offset_ >= hdr.len() + NetHeader::serial_size_)
         {
+            /* NOTE: the copy out of recv_buf_ is structural: the Datagram
+             *       escapes into the EVS input map where it lives until
+             *       delivered and safe, so the socket buffer cannot be
+             *       lent out. The payload buffer itself is recycled
+             *       through the shared pool in datagram.cpp, so the copy
+             *       is not bracketed by a malloc/free pair per message. */
             Datagram dg(
-                gu::SharedBuffer(
-                    new gu::Buffer(&recv_buf_[0] + NetHeader::serial_size_,
-                                   &recv_buf_[0] + NetHeader::serial_size_
-                                   + hdr.len())));
+                make_payload(
+                    &recv_buf_[0] + NetHeader::serial_size_,
+                    &recv_buf_[0] + NetHeader::serial_size_ + hdr.len()));
             if (net_.checksum_ != NetHeader::CS_NONE)
             {
 #ifdef TEST_NET_CHECKSUM_ERROR
@@ -656,12 +650,42 @@ void gcomm::AsioTcpSocket::read_one(boost::array<asio::mutable_buffer, 1>& mbs)
 }
 
 
-void gcomm::AsioTcpSocket::write_one(
-    const boost::array<asio::const_buffer, 2>& cbs)
+/* limits for a single gathered write: enough to amortize per-write
+ * overhead over a burst, small enough to keep write completion (and
+ * thus send_q_ accounting) latency bounded */
+static size_t const max_batch_bytes(1 << 16);
+static size_t const max_batch_iov  (64);
+
+void gcomm::AsioTcpSocket::write_batch()
 {
+    /* called under Protonet critical section with at most one write
+     * in flight, so send_q_ front and staging_buf_ stay untouched
+     * until write_handler() runs */
 #ifdef HAVE_ASIO_SSL_HPP
     if (ssl_socket_ != 0)
     {
+        /* the SSL layer encrypts each buffer it is handed into at least
+         * one TLS record with its own padding, MAC and syscall, which is
+         * where the TLS throughput goes on datagram bursts. Coalescing
+         * queued datagrams into a contiguous staging buffer costs one
+         * memcpy but lets the whole batch travel in maximum-size records.
+         * write_handler() pops every fully written datagram, so multi-
+         * datagram completions are already handled. */
+        staging_buf_.clear();
+
+        for (std::deque<Datagram>::const_iterator i(send_q_.begin());
+             i != send_q_.end() && staging_buf_.size() < max_batch_bytes;
+             ++i)
+        {
+            const gu::byte_t* const hb(i->header() + i->header_offset());
+            staging_buf_.insert(staging_buf_.end(), hb, hb + i->header_len());
+            staging_buf_.insert(staging_buf_.end(),
+                                i->payload().begin(), i->payload().end());
+        }
+
+        boost::array<asio::const_buffer, 1> cbs;
+        cbs[0] = asio::const_buffer(&staging_buf_[0], staging_buf_.size());
+
         async_write(*ssl_socket_, cbs,
                     boost::bind(&AsioTcpSocket::write_handler,
                                 shared_from_this(),
@@ -671,6 +695,23 @@ void gcomm::AsioTcpSocket::write_one(
     else
     {
 #endif /* HAVE_ASIO_SSL_HPP */
+        /* plain TCP: scatter-gather straight from the send queue,
+         * no copies - the kernel picks the data up via writev() */
+        std::vector<asio::const_buffer> cbs;
+        size_t bytes(0);
+
+        for (std::deque<Datagram>::const_iterator i(send_q_.begin());
+             i != send_q_.end() &&
+                 cbs.size() + 2 <= max_batch_iov && bytes < max_batch_bytes;
+             ++i)
+        {
+            cbs.push_back(asio::const_buffer(i->header() + i->header_offset(),
+                                             i->header_len()));
+            cbs.push_back(asio::const_buffer(&i->payload()[0],
+                                             i->payload().size()));
+            bytes += i->len();
+        }
+
         async_write(socket_, cbs,
                     boost::bind(&AsioTcpSocket::write_handler,
                                 shared_from_this(),
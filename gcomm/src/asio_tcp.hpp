@@ -72,7 +72,9 @@ private:
 
     void set_socket_options();
     void read_one(boost::array<asio::mutable_buffer, 1>& mbs);
-    void write_one(const boost::array<asio::const_buffer, 2>& cbs);
+    /* initiates an async write gathering datagrams from the front of
+     * send_q_; exactly one write may be in flight at a time */
+    void write_batch();
     void close_socket();
 
     // call to assign local/remote addresses at the point where it
@@ -93,6 +95,9 @@ private:
     asio::ssl::stream<asio::ip::tcp::socket>* ssl_socket_;
 #endif // HAVE_ASIO_SSL_HPP
     std::deque<Datagram>                      send_q_;
+    /* coalesced datagram batch for the SSL path, must stay intact
+     * while a write is in flight */
+    std::vector<gu::byte_t>                   staging_buf_;
     std::vector<gu::byte_t>                   recv_buf_;
     size_t                                    recv_offset_;
     State                                     state_;
@@ -10,6 +10,10 @@
 #include <boost/bind.hpp>
 #include <boost/array.hpp>
 
+#if defined(__linux__)
+#include <netinet/udp.h> // UDP_GRO
+#endif
+
 
 static bool is_multicast(const asio::ip::udp::endpoint& ep)
 {
@@ -59,7 +63,13 @@ gcomm::AsioUdpSocket::AsioUdpSocket(AsioProtonet& net, const gu::URI& uri)
     socket_(net_.io_service_),
     target_ep_(),
     source_ep_(),
-    recv_buf_((1 << 15) + NetHeader::serial_size_)
+    // GRO can coalesce up to 64KB worth of datagrams into one receive
+    recv_buf_(1 << 16),
+    fec_k_     (0),
+    fec_group_ (0),
+    fec_idx_   (0),
+    fec_parity_(),
+    fec_rx_    ()
 { }
 
 
@@ -88,6 +98,37 @@ void gcomm::AsioUdpSocket::connect(const gu::URI& uri)
     asio::ip::udp::socket::non_blocking_io cmd(true);
     socket_.io_control(cmd);
 
+#if defined(__linux__) && defined(UDP_GRO)
+    // Best effort: ask the kernel (Linux 5.0+) to coalesce bursts of
+    // datagrams from the same flow into single receives. The receive
+    // path parses the result as a sequence of headered datagrams, see
+    // handle_dgram().
+    {
+        int const one(1);
+        if (setsockopt(socket_.native(), IPPROTO_UDP, UDP_GRO,
+                       &one, sizeof(one)) == -1)
+        {
+            log_debug << "setting UDP_GRO failed: " << errno;
+        }
+    }
+#endif // __linux__ && UDP_GRO
+
+    // Optional xor based forward error correction for lossy links:
+    // socket.fec gives the number of data datagrams covered by one
+    // parity datagram, 0 disables. Must be set uniformly across the
+    // cluster, nodes without fec drop fec framed datagrams.
+    fec_k_ = gu::from_string<size_t>(uri.get_option("socket.fec", "0"));
+    if (fec_k_ != 0 && (fec_k_ < 2 || fec_k_ > fec_max_k_))
+    {
+        gu_throw_error(EINVAL) << "socket.fec must be 0 or 2.."
+                               << fec_max_k_ << ", got " << fec_k_;
+    }
+    if (fec_k_ != 0)
+    {
+        log_info << "udp fec enabled, one parity datagram per "
+                 << fec_k_ << " data datagrams";
+    }
+
     const std::string if_addr(
         gu::unescape_addr(
             uri.get_option("socket.if_addr",
@@ -131,25 +172,63 @@ void gcomm::AsioUdpSocket::close()
     state_ = S_CLOSED;
 }
 
+/* NOTE: fec framing. With socket.fec = k every data datagram is wrapped
+ *       with an 8 byte subheader | group(32) | idx(16) | k(16) | after
+ *       the NetHeader, and after k data datagrams one parity datagram
+ *       (idx 0xffff) is sent whose payload is the xor of
+ *       | len(32) | NetHeader | datagram bytes | of each group member
+ *       (len counts the datagram bytes), zero padded to the longest
+ *       member. Covering the NetHeader lets the receiver verify the
+ *       recovered datagram against its original checksum. A receiver
+ *       which got all but one member can then reconstruct the missing
+ *       datagram locally instead of waiting for an EVS gap message
+ *       round trip. Single loss per group is
+ *       repaired, heavier loss falls back to retransmission as before.
+ *       Repair may deliver a datagram which later arrives anyway; that
+ *       is no different from wire level duplication, which upper layers
+ *       tolerate. */
 int gcomm::AsioUdpSocket::send(const Datagram& dg)
 {
     Critical<AsioProtonet> crit(net_);
-    boost::array<asio::const_buffer, 3> cbs;
-    NetHeader hdr(dg.len(), net_.version_);
+    NetHeader hdr(static_cast<uint32_t>(
+                      dg.len() + (fec_k_ != 0 ? fec_hdr_size_ : 0)),
+                  net_.version_);
 
     if (net_.checksum_ != NetHeader::CS_NONE)
     {
+        // crc covers the original datagram, not the fec subheader
         hdr.set_crc32(crc32(net_.checksum_, dg), net_.checksum_);
     }
 
     gu::byte_t buf[NetHeader::serial_size_];
+    gu::byte_t fec_buf[fec_hdr_size_];
+
+    if (fec_k_ != 0)
+    {
+        hdr.set_fec();
+        size_t off(0);
+        off = gu::serialize4(fec_group_, fec_buf, sizeof(fec_buf), off);
+        off = gu::serialize2(static_cast<uint16_t>(fec_idx_),
+                             fec_buf, sizeof(fec_buf), off);
+        off = gu::serialize2(static_cast<uint16_t>(fec_k_),
+                             fec_buf, sizeof(fec_buf), off);
+    }
+
     serialize(hdr, buf, sizeof(buf), 0);
-    cbs[0] = asio::const_buffer(buf, sizeof(buf));
-    cbs[1] = asio::const_buffer(dg.header() + dg.header_offset(),
-                          dg.header_len());
-    cbs[2] = asio::const_buffer(&dg.payload()[0], dg.payload().size());
+
+    boost::array<asio::const_buffer, 4> cbs;
+    size_t n_cbs(0);
+    cbs[n_cbs++] = asio::const_buffer(buf, sizeof(buf));
+    if (fec_k_ != 0)
+    {
+        cbs[n_cbs++] = asio::const_buffer(fec_buf, sizeof(fec_buf));
+    }
+    cbs[n_cbs++] = asio::const_buffer(dg.header() + dg.header_offset(),
+                                      dg.header_len());
+    cbs[n_cbs++] = asio::const_buffer(&dg.payload()[0], dg.payload().size());
     try
     {
+        // unused trailing array slots are empty buffers, asio skips them
         socket_.send_to(cbs, target_ep_);
     }
     catch (asio::system_error& err)
@@ -157,10 +236,100 @@ int gcomm::AsioUdpSocket::send(const Datagram& dg)
         log_warn << "Error: " << err.what();
         return err.code().value();
     }
+
+    if (fec_k_ != 0)
+    {
+        fec_accumulate(buf, dg);
+        if (++fec_idx_ == fec_k_)
+        {
+            return send_fec_parity();
+        }
+    }
     return 0;
 }
 
 
+void gcomm::AsioUdpSocket::fec_accumulate(const gu::byte_t* const hdr_buf,
+                                          const Datagram&         dg)
+{
+    const size_t need(4 + NetHeader::serial_size_ + dg.len());
+    if (fec_parity_.size() < need)
+    {
+        fec_parity_.resize(need, 0);
+    }
+
+    gu::byte_t len_buf[4];
+    gu::serialize4(static_cast<uint32_t>(dg.len()), len_buf,
+                   sizeof(len_buf), 0);
+    for (size_t i(0); i < sizeof(len_buf); ++i)
+    {
+        fec_parity_[i] ^= len_buf[i];
+    }
+
+    size_t pos(4);
+    for (size_t i(0); i < NetHeader::serial_size_; ++i)
+    {
+        fec_parity_[pos++] ^= hdr_buf[i];
+    }
+
+    const gu::byte_t* const hb(dg.header() + dg.header_offset());
+    for (size_t i(0); i < dg.header_len(); ++i)
+    {
+        fec_parity_[pos++] ^= hb[i];
+    }
+    for (size_t i(0); i < dg.payload().size(); ++i)
+    {
+        fec_parity_[pos++] ^= dg.payload()[i];
+    }
+}
+
+
+int gcomm::AsioUdpSocket::send_fec_parity()
+{
+    NetHeader hdr(static_cast<uint32_t>(fec_hdr_size_ + fec_parity_.size()),
+                  net_.version_);
+    hdr.set_fec();
+
+    if (net_.checksum_ != NetHeader::CS_NONE)
+    {
+        const Datagram pdg(make_payload(&fec_parity_[0],
+                                        &fec_parity_[0] + fec_parity_.size()));
+        hdr.set_crc32(crc32(net_.checksum_, pdg), net_.checksum_);
+    }
+
+    gu::byte_t buf[NetHeader::serial_size_];
+    serialize(hdr, buf, sizeof(buf), 0);
+
+    gu::byte_t fec_buf[fec_hdr_size_];
+    size_t off(0);
+    off = gu::serialize4(fec_group_, fec_buf, sizeof(fec_buf), off);
+    off = gu::serialize2(fec_parity_idx_, fec_buf, sizeof(fec_buf), off);
+    off = gu::serialize2(static_cast<uint16_t>(fec_k_),
+                         fec_buf, sizeof(fec_buf), off);
+
+    boost::array<asio::const_buffer, 3> cbs;
+    cbs[0] = asio::const_buffer(buf, sizeof(buf));
+    cbs[1] = asio::const_buffer(fec_buf, sizeof(fec_buf));
+    cbs[2] = asio::const_buffer(&fec_parity_[0], fec_parity_.size());
+
+    int ret(0);
+    try
+    {
+        socket_.send_to(cbs, target_ep_);
+    }
+    catch (asio::system_error& err)
+    {
+        log_warn << "Error: " << err.what();
+        ret = err.code().value();
+    }
+
+    ++fec_group_;
+    fec_idx_ = 0;
+    fec_parity_.clear();
+    return ret;
+}
+
+
 void gcomm::AsioUdpSocket::read_handler(const asio::error_code& ec,
                                         size_t bytes_transferred)
 {
@@ -170,50 +339,272 @@ void gcomm::AsioUdpSocket::read_handler(const asio::error_code& ec,
         return;
     }
 
-    if (bytes_transferred >= NetHeader::serial_size_)
+    handle_dgram(bytes_transferred);
+
+    // The socket is non-blocking, so datagrams which have accumulated
+    // while this handler was pending can be drained synchronously
+    // instead of paying one reactor round trip each. This is what keeps
+    // the protonet thread alive through message storms on view changes.
+    // The drain is bounded to avoid starving other io_service work.
+    for (int n(0); n < 32; ++n)
+    {
+        asio::error_code drain_ec;
+        boost::array<asio::mutable_buffer, 1> mbs;
+        mbs[0] = asio::mutable_buffer(&recv_buf_[0], recv_buf_.size());
+        size_t const bytes(socket_.receive_from(mbs, source_ep_, 0,
+                                                drain_ec));
+        if (drain_ec) break; // would_block: nothing left to drain
+        handle_dgram(bytes);
+    }
+
+    async_receive();
+}
+
+void gcomm::AsioUdpSocket::handle_dgram(size_t bytes_transferred)
+{
+    Critical<AsioProtonet> crit(net_);
+
+    // With UDP GRO the kernel may hand over several wire datagrams
+    // coalesced back to back in a single receive. Each one carries its
+    // own NetHeader, so the buffer parses as a sequence; without GRO
+    // the loop runs exactly once.
+    size_t offset(0);
+    while (offset < bytes_transferred)
     {
-        Critical<AsioProtonet> crit(net_);
+        if (bytes_transferred - offset < NetHeader::serial_size_)
+        {
+            log_warn << "short read of " << bytes_transferred - offset
+                     << " at offset " << offset;
+            return;
+        }
         NetHeader hdr;
         try
         {
-            unserialize(&recv_buf_[0], NetHeader::serial_size_, 0, hdr);
+            unserialize(&recv_buf_[0] + offset, NetHeader::serial_size_, 0,
+                        hdr);
         }
         catch (gu::Exception& e)
         {
             log_warn << "hdr unserialize failed: " << e.get_errno();
             return;
         }
-        if (NetHeader::serial_size_ + hdr.len() != bytes_transferred)
+        if (offset + NetHeader::serial_size_ + hdr.len() > bytes_transferred)
         {
             log_warn << "len " << hdr.len()
-                     << " does not match to bytes transferred"
-                     << bytes_transferred;
+                     << " does not match to bytes transferred "
+                     << bytes_transferred - offset;
+            return;
+        }
+
+        gu::byte_t* const begin(&recv_buf_[0] + offset
+                                + NetHeader::serial_size_);
+        if (hdr.has_fec() == true)
+        {
+            handle_fec_dgram(hdr, begin);
         }
         else
         {
-            Datagram dg(
-                gu::SharedBuffer(
-                    new gu::Buffer(&recv_buf_[0] + NetHeader::serial_size_,
-                                   &recv_buf_[0] + NetHeader::serial_size_
-                                   + hdr.len())));
+            Datagram dg(make_payload(begin, begin + hdr.len()));
             if (net_.checksum_ == true && check_cs(hdr, dg))
             {
                 log_warn << "checksum failed, hdr: len=" << hdr.len()
                          << " has_crc32="  << hdr.has_crc32()
                          << " has_crc32c=" << hdr.has_crc32c()
                          << " crc32=" << hdr.crc32();
+                return;
+            }
+            net_.dispatch(id(), dg, ProtoUpMeta());
+        }
+        offset += NetHeader::serial_size_ + hdr.len();
+    }
+}
+
+
+void gcomm::AsioUdpSocket::handle_fec_dgram(const NetHeader&  hdr,
+                                            const gu::byte_t* begin)
+{
+    if (hdr.len() < fec_hdr_size_)
+    {
+        log_warn << "fec frame shorter than fec header: " << hdr.len();
+        return;
+    }
+
+    uint32_t group;
+    uint16_t idx;
+    uint16_t k;
+    size_t off(0);
+    off = gu::unserialize4(begin, fec_hdr_size_, off, group);
+    off = gu::unserialize2(begin, fec_hdr_size_, off, idx);
+    off = gu::unserialize2(begin, fec_hdr_size_, off, k);
+
+    if (k < 2 || k > fec_max_k_)
+    {
+        log_warn << "invalid fec group size " << k;
+        return;
+    }
+
+    const gu::byte_t* const inner(begin + fec_hdr_size_);
+    const size_t inner_len(hdr.len() - fec_hdr_size_);
+
+    /* every sender numbers its groups independently, so the repair state
+     * is looked up by source endpoint */
+    FecRxMap::iterator ri(fec_rx_.find(source_ep_));
+    if (ri == fec_rx_.end())
+    {
+        if (fec_rx_.size() >= fec_max_senders_)
+        {
+            // repair state is opportunistic - shed it all rather than
+            // grow without bound on endpoint churn
+            log_warn << "fec sender table full, dropping repair state";
+            fec_rx_.clear();
+        }
+        ri = fec_rx_.insert(std::make_pair(source_ep_, FecRx())).first;
+    }
+    FecRx& rx(ri->second);
+
+    if (group != rx.group)
+    {
+        // new group, whatever was missing from the previous one is
+        // beyond local repair and is left to retransmission
+        rx.group = group;
+        rx.mask  = 0;
+        rx.accum.clear();
+    }
+
+    if (idx != fec_parity_idx_)
+    {
+        if (idx >= k)
+        {
+            log_warn << "invalid fec index " << idx << " for group size "
+                     << k;
+            return;
+        }
+
+        Datagram dg(make_payload(inner, inner + inner_len));
+        if (net_.checksum_ == true && check_cs(hdr, dg))
+        {
+            // drop silently into the gap, the parity frame may still
+            // repair this index
+            log_warn << "checksum failed on fec frame, idx=" << idx;
+            return;
+        }
+
+        if ((rx.mask & (1U << idx)) == 0)
+        {
+            rx.mask |= (1U << idx);
+            const size_t need(4 + NetHeader::serial_size_ + inner_len);
+            if (rx.accum.size() < need)
+            {
+                rx.accum.resize(need, 0);
+            }
+            gu::byte_t len_buf[4];
+            gu::serialize4(static_cast<uint32_t>(inner_len), len_buf,
+                           sizeof(len_buf), 0);
+            for (size_t i(0); i < sizeof(len_buf); ++i)
+            {
+                rx.accum[i] ^= len_buf[i];
+            }
+            gu::byte_t hdr_buf[NetHeader::serial_size_];
+            serialize(hdr, hdr_buf, sizeof(hdr_buf), 0);
+            for (size_t i(0); i < sizeof(hdr_buf); ++i)
+            {
+                rx.accum[4 + i] ^= hdr_buf[i];
             }
-            else
+            size_t const doff(4 + NetHeader::serial_size_);
+            for (size_t i(0); i < inner_len; ++i)
             {
-                net_.dispatch(id(), dg, ProtoUpMeta());
+                rx.accum[doff + i] ^= inner[i];
             }
         }
+        net_.dispatch(id(), dg, ProtoUpMeta());
     }
     else
     {
-        log_warn << "short read of " << bytes_transferred;
+        if (inner_len < 4)
+        {
+            log_warn << "fec parity frame too short: " << inner_len;
+            return;
+        }
+        if (net_.checksum_ == true)
+        {
+            const Datagram pdg(make_payload(inner, inner + inner_len));
+            if (check_cs(hdr, pdg))
+            {
+                log_warn << "checksum failed on fec parity frame";
+                return;
+            }
+        }
+
+        if (static_cast<size_t>(__builtin_popcount(rx.mask)) + 1 == k)
+        {
+            // exactly one group member missing, xor of the parity and
+            // the received members reconstructs it
+            if (rx.accum.size() < inner_len)
+            {
+                rx.accum.resize(inner_len, 0);
+            }
+            for (size_t i(0); i < inner_len; ++i)
+            {
+                rx.accum[i] ^= inner[i];
+            }
+            fec_dispatch_repaired(rx, group);
+        }
+        // group is complete or beyond repair either way
+        rx.mask = 0;
+        rx.accum.clear();
     }
-    async_receive();
+}
+
+/* validate and deliver a datagram reconstructed in rx.accum as
+ * | len(32) | NetHeader | datagram bytes |. A botched reconstruction
+ * (reordered groups, sender confusion) must not leak into EVS, so the
+ * recovered frame is held to the same checks as a received one. */
+void gcomm::AsioUdpSocket::fec_dispatch_repaired(const FecRx&   rx,
+                                                 uint32_t const group)
+{
+    size_t const doff(4 + NetHeader::serial_size_);
+
+    uint32_t rec_len;
+    gu::unserialize4(&rx.accum[0], rx.accum.size(), 0, rec_len);
+
+    if (doff + rec_len > rx.accum.size())
+    {
+        log_warn << "fec recovered length " << rec_len << " out of bounds";
+        return;
+    }
+
+    NetHeader rec_hdr;
+    try
+    {
+        unserialize(&rx.accum[4], NetHeader::serial_size_, 0, rec_hdr);
+    }
+    catch (gu::Exception& e)
+    {
+        log_warn << "fec recovered header unserialize failed: "
+                 << e.get_errno();
+        return;
+    }
+
+    if (rec_hdr.len() != rec_len + fec_hdr_size_)
+    {
+        log_warn << "fec recovered header length " << rec_hdr.len()
+                 << " does not match recovered payload length " << rec_len;
+        return;
+    }
+
+    Datagram dg(make_payload(&rx.accum[0] + doff,
+                             &rx.accum[0] + doff + rec_len));
+
+    if (net_.checksum_ == true && check_cs(rec_hdr, dg))
+    {
+        log_warn << "checksum failed on fec repaired datagram, group "
+                 << group;
+        return;
+    }
+
+    log_debug << "fec repaired datagram of " << rec_len
+              << " bytes in group " << group;
+    net_.dispatch(id(), dg, ProtoUpMeta());
 }
 
 void gcomm::AsioUdpSocket::async_receive()
@@ -231,7 +622,8 @@ void gcomm::AsioUdpSocket::async_receive()
 
 size_t gcomm::AsioUdpSocket::mtu() const
 {
-    return (1 << 15);
+    // the fec subheader eats into the payload budget of every frame
+    return (1 << 15) - (fec_k_ != 0 ? fec_hdr_size_ : 0);
 }
 
 std::string gcomm::AsioUdpSocket::local_addr() const
@@ -8,6 +8,7 @@
 #include "socket.hpp"
 #include "asio_protonet.hpp"
 #include <boost/enable_shared_from_this.hpp>
+#include <map>
 #include <vector>
 
 //
@@ -47,12 +48,43 @@ public:
     SocketId id() const { return &socket_; }
 
 private:
+    void handle_dgram(size_t);
+    void handle_fec_dgram(const NetHeader& hdr, const gu::byte_t* begin);
+    void fec_accumulate(const gu::byte_t* hdr_buf, const Datagram& dg);
+    int  send_fec_parity();
+    struct FecRx;
+    void fec_dispatch_repaired(const FecRx& rx, uint32_t group);
+
+    static const size_t   fec_hdr_size_   = 8;
+    static const size_t   fec_max_k_      = 32;
+    static const uint16_t fec_parity_idx_ = 0xffff;
+    static const size_t   fec_max_senders_ = 64;
+
+    /* per-sender receiver repair state: this is a multicast socket and
+     * every sender numbers its fec groups independently from zero, so
+     * accumulators must not be shared between senders */
+    struct FecRx
+    {
+        uint32_t                group; // current group seqno
+        uint32_t                mask;  // seen-index bitmask
+        std::vector<gu::byte_t> accum; // xor accumulator
+
+        FecRx() : group(0), mask(0), accum() {}
+    };
+    typedef std::map<asio::ip::udp::endpoint, FecRx> FecRxMap;
+
     AsioProtonet&            net_;
     State                    state_;
     asio::ip::udp::socket    socket_;
     asio::ip::udp::endpoint  target_ep_;
     asio::ip::udp::endpoint  source_ep_;
     std::vector<gu::byte_t>  recv_buf_;
+    /* forward error correction state, see the note in asio_udp.cpp */
+    size_t                   fec_k_;      // data frames per parity, 0 = off
+    uint32_t                 fec_group_;  // sender group seqno
+    size_t                   fec_idx_;    // next frame index in sender group
+    std::vector<gu::byte_t>  fec_parity_; // sender parity accumulator
+    FecRxMap                 fec_rx_;     // receiver repair state per sender
 };
 
 #if defined(__GNUG__)
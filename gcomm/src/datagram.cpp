@@ -5,11 +5,108 @@
 #include "gcomm/datagram.hpp"
 
 #include "gu_crc.hpp"    // CRC-32C - optimized and potentially accelerated
+#include "gu_mutex.hpp"  // SpinLock/SpinGuard
 #include "gu_logger.hpp"
 #include "gu_throw.hpp"
 
 #include <boost/crc.hpp> // CRC32   - backward compatible
 
+#include <vector>
+
+namespace
+{
+    /* Free list of datagram payload buffers. A gu::Buffer handed out of
+     * here keeps whatever heap storage it grew on previous use, so in
+     * steady state neither the buffer object nor its storage is
+     * (de)allocated per message - the recycled vectors are effectively
+     * size-classed by their capacity history, and the small control
+     * messages (acks, gaps, keepalives) that dominate message count
+     * never touch the allocator at all. The payload still travels as a
+     * refcounted SharedBuffer (through the EVS input map and the gcs
+     * receive queue) - only its deleter changes, returning the object
+     * here instead of freeing it. The pool is created on first use and
+     * intentionally never destroyed: the last reference to a payload
+     * may be dropped during static destruction. */
+    class PayloadPool
+    {
+    public:
+
+        PayloadPool() : lock_(), bufs_() { bufs_.reserve(max_bufs_); }
+
+        gu::Buffer* acquire()
+        {
+            {
+                gu::SpinGuard guard(lock_);
+
+                if (!bufs_.empty())
+                {
+                    gu::Buffer* const ret(bufs_.back());
+                    bufs_.pop_back();
+                    return ret;
+                }
+            }
+
+            return new gu::Buffer();
+        }
+
+        void release(gu::Buffer* const buf)
+        {
+            buf->clear(); // keeps capacity
+
+            if (buf->capacity() <= max_cached_capacity_)
+            {
+                gu::SpinGuard guard(lock_);
+
+                if (bufs_.size() < size_t(max_bufs_))
+                {
+                    bufs_.push_back(buf);
+                    return;
+                }
+            }
+
+            delete buf;
+        }
+
+    private:
+
+        static int    const max_bufs_            = 256;
+        static size_t const max_cached_capacity_ = 1 << 20;
+
+        gu::SpinLock             lock_;
+        std::vector<gu::Buffer*> bufs_;
+    };
+
+    PayloadPool* const payload_pool(new PayloadPool);
+
+    struct PayloadReturn
+    {
+        void operator()(gu::Buffer* const buf) const
+        {
+            payload_pool->release(buf);
+        }
+    };
+}
+
+gu::SharedBuffer gcomm::make_payload()
+{
+    return gu::SharedBuffer(payload_pool->acquire(), PayloadReturn());
+}
+
+gu::SharedBuffer gcomm::make_payload(const gu::byte_t* const b,
+                                     const gu::byte_t* const e)
+{
+    gu::Buffer* const buf(payload_pool->acquire());
+    buf->assign(b, e);
+    return gu::SharedBuffer(buf, PayloadReturn());
+}
+
+gu::SharedBuffer gcomm::make_payload(const gu::Buffer& buf)
+{
+    gu::Buffer* const ret(payload_pool->acquire());
+    *ret = buf;
+    return gu::SharedBuffer(ret, PayloadReturn());
+}
+
 
 gcomm::NetHeader::checksum_t
 gcomm::NetHeader::checksum_type (int i)
@@ -64,6 +161,16 @@ gcomm::crc16(const gcomm::Datagram& dg, size_t offset)
     return crc.checksum();
 }
 
+/* NOTE: CS_CRC32C (the default, see AsioProtonet) is already hardware
+ *       accelerated where possible: gu::CRC32C calls through
+ *       gu_crc32c_func, which gu_crc32c_configure() points at the SSE4.2
+ *       instruction when the CPU has it and at slicing-by-8 otherwise.
+ *       CS_CRC32 stays soft for wire compatibility with old nodes.
+ *       Verification cannot be deferred off the protonet thread either:
+ *       the checksum covers the protocol headers, and EVS/GMCast act on
+ *       those headers during dispatch - by the time a delivery thread
+ *       could check the CRC, a corrupted header would already have
+ *       driven membership or ordering decisions. */
 uint32_t
 gcomm::crc32(gcomm::NetHeader::checksum_t const type,
              const gcomm::Datagram& dg, size_t offset)
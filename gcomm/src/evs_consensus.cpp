@@ -122,6 +122,8 @@ bool gcomm::evs::Consensus::equal(const Message& m1, const Message& m2) const
 
 gcomm::evs::seqno_t gcomm::evs::Consensus::highest_reachable_safe_seq() const
 {
+    if (cache_.valid_ == true) return cache_.highest_reachable_safe_seq_;
+
     std::list<seqno_t> seq_list;
     for (NodeMap::const_iterator i = known_.begin(); i != known_.end();
          ++i)
@@ -162,6 +164,8 @@ gcomm::evs::seqno_t gcomm::evs::Consensus::highest_reachable_safe_seq() const
 gcomm::evs::seqno_t
 gcomm::evs::Consensus::safe_seq_wo_all_susupected_leaving_nodes() const
 {
+    if (cache_.valid_ == true) return cache_.safe_seq_wo_leaving_;
+
     seqno_t safe_seq(-2);
     for(NodeMap::const_iterator i = proto_.known_.begin();
         i != proto_.known_.end(); ++i)
@@ -317,19 +321,17 @@ bool gcomm::evs::Consensus::is_consistent_input_map(const Message& msg) const
         return false;
     }
 
-    Map<const UUID, Range> local_insts, msg_insts;
+    InstMap  uncached_insts;
+    const InstMap* local_insts(&cache_.input_map_insts_);
 
-    for (NodeMap::const_iterator i = known_.begin(); i != known_.end(); ++i)
+    if (cache_.valid_ == false)
     {
-        const UUID& uuid(NodeMap::key(i));
-        const Node& node(NodeMap::value(i));
-        if (current_view_.is_member(uuid) == true)
-        {
-            gu_trace((void)local_insts.insert_unique(
-                         std::make_pair(uuid, input_map_.range(node.index()))));
-        }
+        gather_input_map_insts(uncached_insts);
+        local_insts = &uncached_insts;
     }
 
+    InstMap msg_insts;
+
     const MessageNodeList& m_insts(msg.node_list());
 
     for (MessageNodeList::const_iterator i = m_insts.begin();
@@ -345,9 +347,23 @@ bool gcomm::evs::Consensus::is_consistent_input_map(const Message& msg) const
     }
 
     evs_log_debug(D_CONSENSUS) << " msg_insts " << msg_insts
-                               << " local_insts " << local_insts;
+                               << " local_insts " << *local_insts;
+
+    return (msg_insts == *local_insts);
+}
 
-    return (msg_insts == local_insts);
+void gcomm::evs::Consensus::gather_input_map_insts(InstMap& insts) const
+{
+    for (NodeMap::const_iterator i = known_.begin(); i != known_.end(); ++i)
+    {
+        const UUID& uuid(NodeMap::key(i));
+        const Node& node(NodeMap::value(i));
+        if (current_view_.is_member(uuid) == true)
+        {
+            gu_trace((void)insts.insert_unique(
+                         std::make_pair(uuid, input_map_.range(node.index()))));
+        }
+    }
 }
 
 
@@ -361,22 +377,17 @@ bool gcomm::evs::Consensus::is_consistent_partitioning(const Message& msg) const
     // Compare instances that were present in the current view but are
     // not proceeding in the next view.
 
-    Map<const UUID, Range> local_insts, msg_insts;
+    InstMap  uncached_insts;
+    const InstMap* local_insts(&cache_.partitioning_insts_);
 
-    for (NodeMap::const_iterator i = known_.begin(); i != known_.end(); ++i)
+    if (cache_.valid_ == false)
     {
-        const UUID& uuid(NodeMap::key(i));
-        const Node& node(NodeMap::value(i));
-        if (node.operational()       == false &&
-            node.leave_message()     == 0     &&
-            current_view_.is_member(uuid) == true)
-        {
-            gu_trace((void)local_insts.insert_unique(
-                         std::make_pair(uuid,
-                                        input_map_.range(node.index()))));
-        }
+        gather_partitioning_insts(uncached_insts);
+        local_insts = &uncached_insts;
     }
 
+    InstMap msg_insts;
+
     const MessageNodeList& m_insts = msg.node_list();
 
     for (MessageNodeList::const_iterator i = m_insts.begin();
@@ -395,8 +406,25 @@ bool gcomm::evs::Consensus::is_consistent_partitioning(const Message& msg) const
 
 
     evs_log_debug(D_CONSENSUS) << " msg insts:\n" << msg_insts
-                               << " local insts:\n" << local_insts;
-    return (msg_insts == local_insts);
+                               << " local insts:\n" << *local_insts;
+    return (msg_insts == *local_insts);
+}
+
+void gcomm::evs::Consensus::gather_partitioning_insts(InstMap& insts) const
+{
+    for (NodeMap::const_iterator i = known_.begin(); i != known_.end(); ++i)
+    {
+        const UUID& uuid(NodeMap::key(i));
+        const Node& node(NodeMap::value(i));
+        if (node.operational()       == false &&
+            node.leave_message()     == 0     &&
+            current_view_.is_member(uuid) == true)
+        {
+            gu_trace((void)insts.insert_unique(
+                         std::make_pair(uuid,
+                                        input_map_.range(node.index()))));
+        }
+    }
 }
 
 
@@ -409,23 +437,17 @@ bool gcomm::evs::Consensus::is_consistent_leaving(const Message& msg) const
     // Compare instances that were present in the current view but are
     // not proceeding in the next view.
 
-    Map<const UUID, Range> local_insts, msg_insts;
+    InstMap  uncached_insts;
+    const InstMap* local_insts(&cache_.leaving_insts_);
 
-    for (NodeMap::const_iterator i = known_.begin(); i != known_.end(); ++i)
+    if (cache_.valid_ == false)
     {
-        const UUID& uuid(NodeMap::key(i));
-        const Node& inst(NodeMap::value(i));
-        const LeaveMessage* lm(inst.leave_message());
-
-        if (inst.operational()   == false &&
-            lm                       != 0  &&
-            lm->source_view_id() == current_view_.id())
-        {
-            gu_trace((void)local_insts.insert_unique(
-                         std::make_pair(uuid, input_map_.range(inst.index()))));
-        }
+        gather_leaving_insts(uncached_insts);
+        local_insts = &uncached_insts;
     }
 
+    InstMap msg_insts;
+
     const MessageNodeList& m_insts = msg.node_list();
 
     for (MessageNodeList::const_iterator i = m_insts.begin();
@@ -443,8 +465,26 @@ bool gcomm::evs::Consensus::is_consistent_leaving(const Message& msg) const
     }
 
     evs_log_debug(D_CONSENSUS) << " msg insts " << msg_insts
-                               << " local insts " << local_insts;
-    return (local_insts == msg_insts);
+                               << " local insts " << *local_insts;
+    return (*local_insts == msg_insts);
+}
+
+void gcomm::evs::Consensus::gather_leaving_insts(InstMap& insts) const
+{
+    for (NodeMap::const_iterator i = known_.begin(); i != known_.end(); ++i)
+    {
+        const UUID& uuid(NodeMap::key(i));
+        const Node& inst(NodeMap::value(i));
+        const LeaveMessage* lm(inst.leave_message());
+
+        if (inst.operational()   == false &&
+            lm                       != 0  &&
+            lm->source_view_id() == current_view_.id())
+        {
+            gu_trace((void)insts.insert_unique(
+                         std::make_pair(uuid, input_map_.range(inst.index()))));
+        }
+    }
 }
 
 
@@ -505,8 +545,44 @@ bool gcomm::evs::Consensus::is_consistent(const Message& msg) const
     }
 }
 
+/*!
+ * Fills the local-state cache for the duration of one is_consensus()
+ * sweep and invalidates it on scope exit. The local state cannot change
+ * while the sweep runs, so every message is checked against the same
+ * snapshot that would otherwise be recomputed per message.
+ */
+class gcomm::evs::Consensus::CacheScope
+{
+public:
+    CacheScope(const Consensus& cons) : cache_(cons.cache_)
+    {
+        gcomm_assert(cache_.valid_ == false);
+        cons.gather_input_map_insts   (cache_.input_map_insts_);
+        cons.gather_partitioning_insts(cache_.partitioning_insts_);
+        cons.gather_leaving_insts     (cache_.leaving_insts_);
+        cache_.highest_reachable_safe_seq_ =
+            cons.highest_reachable_safe_seq();
+        cache_.safe_seq_wo_leaving_ =
+            cons.safe_seq_wo_all_susupected_leaving_nodes();
+        cache_.valid_ = true;
+    }
+    ~CacheScope()
+    {
+        cache_.valid_ = false;
+        cache_.input_map_insts_.clear();
+        cache_.partitioning_insts_.clear();
+        cache_.leaving_insts_.clear();
+    }
+private:
+    CacheScope(const CacheScope&);
+    void operator=(const CacheScope&);
+    LocalCache& cache_;
+};
+
 bool gcomm::evs::Consensus::is_consensus() const
 {
+    CacheScope cache_scope(*this);
+
     const JoinMessage* my_jm =
         NodeMap::value(known_.find_checked(proto_.uuid())).join_message();
 
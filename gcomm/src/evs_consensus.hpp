@@ -6,11 +6,12 @@
 #define GCOMM_EVS_CONSENSUS_HPP
 
 #include "evs_seqno.hpp"
+#include "gcomm/map.hpp"
+#include "gcomm/uuid.hpp"
 
 
 namespace gcomm
 {
-    class UUID;
     class View;
     namespace evs
     {
@@ -32,7 +33,8 @@ public:
         proto_       (proto),
         known_       (known),
         input_map_   (input_map),
-        current_view_(current_view)
+        current_view_(current_view),
+        cache_       ()
     { }
 
     /*!
@@ -68,11 +70,46 @@ public:
     bool is_consistent(const Message&) const;
     bool is_consensus() const;
 private:
+    typedef Map<const UUID, Range> InstMap;
+
+    void gather_input_map_insts   (InstMap&) const;
+    void gather_partitioning_insts(InstMap&) const;
+    void gather_leaving_insts     (InstMap&) const;
+
+    /*!
+     * Local-state parts of the consistency checks. While is_consensus()
+     * sweeps over all known nodes' join messages these depend only on
+     * known_, input_map_ and current_view_, none of which can change
+     * during the sweep, so they are computed once per sweep instead of
+     * once per message. Valid only inside is_consensus(), see CacheScope.
+     */
+    struct LocalCache
+    {
+        LocalCache() :
+            valid_                     (false),
+            highest_reachable_safe_seq_(-1),
+            safe_seq_wo_leaving_       (-1),
+            input_map_insts_           (),
+            partitioning_insts_        (),
+            leaving_insts_             ()
+        { }
+        bool    valid_;
+        seqno_t highest_reachable_safe_seq_;
+        seqno_t safe_seq_wo_leaving_;
+        InstMap input_map_insts_;
+        InstMap partitioning_insts_;
+        InstMap leaving_insts_;
+    };
+
+    class CacheScope;
+    friend class CacheScope;
 
     const Proto&    proto_;
     const NodeMap&  known_;
     const InputMap& input_map_;
     const View&     current_view_;
+
+    mutable LocalCache cache_;
 };
 
 #endif // GCOMM_EVS_CONSENSUS_HPP
@@ -117,6 +117,7 @@ gcomm::evs::InputMap::InputMap() :
     window_         (-1),
     safe_seq_       (-1),
     aru_seq_        (-1),
+    max_hs_         (-1),
     node_index_     (new InputMapNodeIndex()),
     msg_index_      (new InputMapMsgIndex()),
     recovery_index_ (new InputMapMsgIndex())
@@ -145,6 +146,7 @@ void gcomm::evs::InputMap::reset(const size_t nodes, const seqno_t window)
     gcomm_assert(msg_index_->empty()                           == true &&
                  recovery_index_->empty()                      == true);
     node_index_->clear();
+    max_hs_ = -1;
 
     window_ = window;
     log_debug << " size " << node_index_->size();
@@ -170,12 +172,12 @@ gcomm::evs::seqno_t gcomm::evs::InputMap::min_hs() const
 
 gcomm::evs::seqno_t gcomm::evs::InputMap::max_hs() const
 {
-    seqno_t ret;
     gcomm_assert(node_index_->empty() == false);
-    ret = max_element(node_index_->begin(),
-                      node_index_->end(),
-                      NodeIndexHSCmpOp())->range().hs();
-    return ret;
+    // maintained incrementally in insert(), node hs never decreases
+    assert(max_hs_ == max_element(node_index_->begin(),
+                                  node_index_->end(),
+                                  NodeIndexHSCmpOp())->range().hs());
+    return max_hs_;
 }
 
 
@@ -194,8 +196,15 @@ void gcomm::evs::InputMap::set_safe_seq(const size_t uuid, const seqno_t seq)
     gcomm_assert(seq >= node.safe_seq())
         << "node.safe_seq=" << node.safe_seq()
         << " seq=" << seq;
+    const seqno_t prev_node_safe_seq(node.safe_seq());
     node.set_safe_seq(seq);
 
+    // Global safe seq is the minimum over all nodes. If this node was
+    // above the minimum before the update, some other node still holds
+    // it and the global value cannot have changed - the scan below can
+    // be skipped. This keeps the common case O(1) instead of O(n).
+    if (prev_node_safe_seq > safe_seq_) return;
+
     // Update global safe seq which must be monotonically increasing.
     InputMapNodeIndex::const_iterator min =
         min_element(node_index_->begin(), node_index_->end(),
@@ -228,6 +237,7 @@ void gcomm::evs::InputMap::clear()
     node_index_->clear();
     aru_seq_ = -1;
     safe_seq_ = -1;
+    max_hs_ = -1;
 }
 
 
@@ -251,6 +261,7 @@ gcomm::evs::InputMap::insert(const size_t uuid,
     gcomm_assert(uuid < node_index_->size());
     InputMapNode& node((*node_index_)[uuid]);
     range = node.range();
+    const seqno_t prev_lu(range.lu());
 
     // User should check LU before inserting. This check is left
     // also in optimized builds since violating it may cause duplicate
@@ -303,32 +314,37 @@ gcomm::evs::InputMap::insert(const size_t uuid,
                                               O_DROP)), ins_dg))));
         }
 
+        node.seen_set(s);
+
         // Update highest seen
         if (range.hs() < s)
         {
             range.set_hs(s);
         }
 
-        // Update lowest unseen
+        // Update lowest unseen. Every seqno present in either index
+        // has its bit set in the node bitmap, so the first zero bit is
+        // the first seqno missing from both. This used to be a map
+        // lookup per probed seqno.
         if (range.lu() == s)
         {
-            seqno_t i(s);
-            do
-            {
-                ++i;
-            }
-            while (
-                i <= range.hs() &&
-                (msg_index_->find(InputMapMsgKey(node.index(), i))
-                 != msg_index_->end() ||
-                 recovery_index_->find(InputMapMsgKey(node.index(), i))
-                 != recovery_index_->end()));
-            range.set_lu(i);
+            range.set_lu(node.first_unseen(s + 1));
         }
     }
 
     node.set_range(range);
-    update_aru();
+    node.seen_forget(range.lu());
+
+    if (range.hs() > max_hs_) max_hs_ = range.hs();
+
+    // aru_seq_ is min(lu) - 1 over all nodes, so it can only advance
+    // when the node that just received was the one holding it back
+    // (lu == aru_seq_ + 1). Otherwise another node still has
+    // lu == aru_seq_ + 1 and the O(n) rescan can be skipped.
+    if (prev_lu == aru_seq_ + 1)
+    {
+        update_aru();
+    }
     return range;
 }
 
@@ -362,6 +378,66 @@ gcomm::evs::InputMap::recover(const size_t uuid, const seqno_t seq) const
 }
 
 
+void
+gcomm::evs::InputMap::recover_range(const size_t uuid, const Range range,
+                                    RecoverVector& out) const
+{
+    const size_t index(node_index_->at(uuid).index());
+
+    // Entries are keyed by (seq, index), so one lower_bound per index
+    // followed by a forward scan visits all messages in the requested
+    // window in seqno order; other nodes' entries are filtered on the
+    // fly. This replaces a find() (or worse, a throwing recover()) per
+    // seqno when retransmitting a lost burst.
+    iterator mi(msg_index_->lower_bound(InputMapMsgKey(0, range.lu())));
+    iterator ri(recovery_index_->lower_bound(InputMapMsgKey(0, range.lu())));
+
+    // Seqnos below next_seq are covered by an already collected
+    // message's seq range and their placeholder entries are skipped,
+    // just like the per-seqno loops used to step over them.
+    seqno_t next_seq(range.lu());
+
+    while (true)
+    {
+        while (mi != msg_index_->end() &&
+               InputMapMsgIndex::key(mi).seq() <= range.hs() &&
+               InputMapMsgIndex::key(mi).index() != index) ++mi;
+        while (ri != recovery_index_->end() &&
+               InputMapMsgIndex::key(ri).seq() <= range.hs() &&
+               InputMapMsgIndex::key(ri).index() != index) ++ri;
+
+        const bool have_m(mi != msg_index_->end() &&
+                          InputMapMsgIndex::key(mi).seq() <= range.hs());
+        const bool have_r(ri != recovery_index_->end() &&
+                          InputMapMsgIndex::key(ri).seq() <= range.hs());
+
+        if (have_m == false && have_r == false) break;
+
+        // next message in seqno order from either index (a seqno is
+        // never present in both, see insert() and erase())
+        iterator* next;
+        if (have_m == true && have_r == true)
+        {
+            next = (InputMapMsgIndex::key(mi) < InputMapMsgIndex::key(ri) ?
+                    &mi : &ri);
+        }
+        else
+        {
+            next = (have_m == true ? &mi : &ri);
+        }
+
+        const seqno_t seq(InputMapMsgIndex::key(*next).seq());
+        if (seq >= next_seq)
+        {
+            out->push_back(*next);
+            next_seq = seq +
+                InputMapMsgIndex::value(*next).msg().seq_range() + 1;
+        }
+        ++(*next);
+    }
+}
+
+
 
 //////////////////////////////////////////////////////////////////////////
 //
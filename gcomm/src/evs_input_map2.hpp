@@ -23,6 +23,8 @@
 #include "gcomm/map.hpp"
 #include "gcomm/datagram.hpp"
 
+#include "gu_vector.hpp"
+
 #include <vector>
 
 
@@ -92,6 +94,15 @@ private:
 };
 
 
+/* NOTE: a flat ring indexed by seqno offset looks tempting for the message
+ *       index, but the ordered map is doing real work here. Delivery
+ *       iterates messages from all nodes merged in (seq, node) order, which
+ *       a per-seqno ring would have to re-sort; under packet loss the live
+ *       window is not dense (lu can trail hs by up to evs.window per node);
+ *       and the recovery index needs ordered range erase up to safe_seq.
+ *       The per-message allocation churn has a build-time answer instead:
+ *       boost_pool=1 switches this index to a pool allocator which recycles
+ *       nodes without hitting malloc in steady state. */
 #if defined(GALERA_USE_BOOST_POOL_ALLOC)
 
 #include <boost/pool/pool_alloc.hpp>
@@ -122,7 +133,8 @@ class gcomm::evs::InputMapMsgIndex :
 class gcomm::evs::InputMapNode
 {
 public:
-    InputMapNode() : idx_(), range_(0, -1), safe_seq_(-1) { }
+    InputMapNode() : idx_(), range_(0, -1), safe_seq_(-1),
+                     seen_base_(0), seen_() { }
 
     void   set_range     (const Range   r)       { range_     = r; }
     void   set_safe_seq  (const seqno_t s)       { safe_seq_  = s; }
@@ -132,10 +144,78 @@ public:
     seqno_t safe_seq  ()               const { return safe_seq_;  }
     size_t  index     ()               const { return idx_;       }
 
+    /* Bitmap of seen seqnos over the live window, one bit per seqno
+     * starting from seen_base_. A bit is set for every seqno a message
+     * has been inserted for and is never cleared while the seqno can
+     * still be scanned (InputMap::insert() slides seen_base_ forward
+     * only past lowest unseen). This makes finding the next gap a
+     * word-sized bit scan instead of a map lookup per seqno. */
+
+    /* Mark seqno as seen. */
+    void seen_set(const seqno_t seq)
+    {
+        gcomm_assert(seq >= seen_base_);
+        const size_t off (static_cast<size_t>(seq - seen_base_));
+        const size_t word(off / seen_word_bits);
+        if (word >= seen_.size())
+        {
+            seen_.resize(word + 1, 0);
+        }
+        seen_[word] |= (static_cast<uint64_t>(1) << (off % seen_word_bits));
+    }
+
+    /* First seqno at or above the given one with no message seen. */
+    seqno_t first_unseen(const seqno_t from) const
+    {
+        gcomm_assert(from >= seen_base_);
+        const size_t off (static_cast<size_t>(from - seen_base_));
+        size_t       word(off / seen_word_bits);
+        uint64_t     mask(~static_cast<uint64_t>(0) << (off % seen_word_bits));
+        while (word < seen_.size())
+        {
+            const uint64_t unseen(~seen_[word] & mask);
+            if (unseen != 0)
+            {
+                return (seen_base_ +
+                        static_cast<seqno_t>(word * seen_word_bits) +
+                        __builtin_ctzll(unseen));
+            }
+            mask = ~static_cast<uint64_t>(0);
+            ++word;
+        }
+        // all bits from 'from' up to the end of the bitmap are set
+        const seqno_t end(seen_base_ + static_cast<seqno_t>(
+                              seen_.size() * seen_word_bits));
+        return (from > end ? from : end);
+    }
+
+    /* Drop bitmap words wholly below seq, it is never scanned below
+     * the node's lowest unseen again. */
+    void seen_forget(const seqno_t seq)
+    {
+        const seqno_t new_base(seq - seq % seen_word_bits);
+        if (new_base <= seen_base_) return;
+        const size_t drop(static_cast<size_t>(
+                              (new_base - seen_base_) / seen_word_bits));
+        if (drop < seen_.size())
+        {
+            seen_.erase(seen_.begin(), seen_.begin() + drop);
+        }
+        else
+        {
+            seen_.clear();
+        }
+        seen_base_ = new_base;
+    }
+
 private:
+    static const size_t seen_word_bits = 64;
+
     size_t  idx_;
     Range   range_;
     seqno_t safe_seq_;
+    seqno_t               seen_base_; /*!< Seqno of bit 0 of seen_ */
+    std::vector<uint64_t> seen_;      /*!< Seen seqno bitmap       */
 };
 
 
@@ -154,6 +234,12 @@ public:
     typedef InputMapMsgIndex::iterator iterator;
     typedef InputMapMsgIndex::const_iterator const_iterator;
 
+    /* recover_range() output vector with room for a typical
+     * retransmission burst reserved inside the object, so collecting
+     * one does not allocate unless the burst is unusually large */
+    static size_t const RECOVER_RESERVE = 64;
+    typedef gu::Vector<iterator, RECOVER_RESERVE> RecoverVector;
+
     /*!
      * Default constructor.
      */
@@ -321,6 +407,22 @@ public:
      */
     iterator recover(const size_t uuid, const seqno_t seq) const;
 
+    /*!
+     * Recover all messages from given node within inclusive seqno range
+     * in a single pass over the indexes.
+     *
+     * Both live and recovery indexes are consulted. Found messages are
+     * appended to out in ascending seqno order. Seqnos covered by a
+     * preceding message's seq range and seqnos missing from both
+     * indexes are skipped silently.
+     *
+     * @param uuid  Message source node uuid
+     * @param range Inclusive seqno range to recover
+     * @param out   Vector found messages are appended to
+     */
+    void recover_range(const size_t uuid, const Range range,
+                       RecoverVector& out) const;
+
     /*!
      *
      */
@@ -351,6 +453,7 @@ private:
     seqno_t            window_;
     seqno_t            safe_seq_;       /*!< Safe seqno              */
     seqno_t            aru_seq_;        /*!< All received upto seqno */
+    seqno_t            max_hs_;         /*!< Maximum highest seen    */
     InputMapNodeIndex* node_index_;     /*!< Index of nodes          */
     InputMapMsgIndex*  msg_index_;      /*!< Index of messages       */
     InputMapMsgIndex*  recovery_index_; /*!< Recovery index          */
@@ -166,11 +166,13 @@ size_t gcomm::evs::Message::serialize(gu::byte_t* const buf,
     uint8_t b = static_cast<uint8_t>(zeroversion
                                      | (type_ << 2)
                                      | (order_ << 5));
-    gu_trace(offset = gu::serialize1(b, buf, buflen, offset));
-    gu_trace(offset = gu::serialize1(flags_, buf, buflen, offset));
-    gu_trace(offset = gu::serialize1(version_, buf, buflen, offset));
-    gu_trace(offset = gu::serialize1(uint8_t(0), buf, buflen, offset));
-    gu_trace(offset = gu::serialize8(fifo_seq_, buf, buflen, offset));
+    // fixed scalar field group, bounds checked once
+    gu_trace(gu::check_bounds(offset + 4 + sizeof(fifo_seq_), buflen));
+    offset = gu::serialize1_unchecked(b, buf, offset);
+    offset = gu::serialize1_unchecked(flags_, buf, offset);
+    offset = gu::serialize1_unchecked(version_, buf, offset);
+    offset = gu::serialize1_unchecked(uint8_t(0), buf, offset);
+    offset = gu::serialize8_unchecked(fifo_seq_, buf, offset);
     if (flags_ & F_SOURCE)
     {
         gu_trace(offset = source_.serialize(buf, buflen, offset));
@@ -185,7 +187,9 @@ size_t gcomm::evs::Message::unserialize(const gu::byte_t* const buf,
                                         size_t                  offset)
 {
     uint8_t b;
-    gu_trace(offset = gu::unserialize1(buf, buflen, offset, b));
+    // fixed scalar field group, bounds checked once
+    gu_trace(gu::check_bounds(offset + 4 + sizeof(fifo_seq_), buflen));
+    offset = gu::unserialize1_unchecked(buf, offset, b);
 
     // The message version will be read from offset 16 regardless what is
     // the zeroversion value. The only purpose of zeroversion is to
@@ -204,8 +208,8 @@ size_t gcomm::evs::Message::unserialize(const gu::byte_t* const buf,
                                     << order_;
     }
 
-    gu_trace(offset = gu::unserialize1(buf, buflen, offset, flags_));
-    gu_trace(offset = gu::unserialize1(buf, buflen, offset, version_));
+    offset = gu::unserialize1_unchecked(buf, offset, flags_);
+    offset = gu::unserialize1_unchecked(buf, offset, version_);
     switch (type_)
     {
     case EVS_T_JOIN:
@@ -223,9 +227,9 @@ size_t gcomm::evs::Message::unserialize(const gu::byte_t* const buf,
         break;
     }
     uint8_t reserved;
-    gu_trace(offset = gu::unserialize1(buf, buflen, offset, reserved));
+    offset = gu::unserialize1_unchecked(buf, offset, reserved);
 
-    gu_trace(offset = gu::unserialize8(buf, buflen, offset, fifo_seq_));
+    offset = gu::unserialize8_unchecked(buf, offset, fifo_seq_);
 
     if (flags_ & F_SOURCE)
     {
@@ -253,14 +257,17 @@ size_t gcomm::evs::UserMessage::serialize(gu::byte_t* const buf,
                                           size_t            offset) const
 {
     gu_trace(offset = Message::serialize(buf, buflen, offset));
-    gu_trace(offset = gu::serialize1(user_type_, buf, buflen, offset));
 
     gcomm_assert(seq_range_ <= seqno_t(0xff));
     uint8_t b = static_cast<uint8_t>(seq_range_);
-    gu_trace(offset = gu::serialize1(b, buf, buflen, offset));
-    gu_trace(offset = gu::serialize2(uint16_t(0), buf, buflen, offset));
-    gu_trace(offset = gu::serialize8(seq_, buf, buflen, offset));
-    gu_trace(offset = gu::serialize8(aru_seq_, buf, buflen, offset));
+    // fixed scalar field group, bounds checked once
+    gu_trace(gu::check_bounds(offset + 4 + sizeof(seq_) + sizeof(aru_seq_),
+                              buflen));
+    offset = gu::serialize1_unchecked(user_type_, buf, offset);
+    offset = gu::serialize1_unchecked(b, buf, offset);
+    offset = gu::serialize2_unchecked(uint16_t(0), buf, offset);
+    offset = gu::serialize8_unchecked(seq_, buf, offset);
+    offset = gu::serialize8_unchecked(aru_seq_, buf, offset);
 
     return offset;
 }
@@ -274,18 +281,21 @@ size_t gcomm::evs::UserMessage::unserialize(const gu::byte_t* const buf,
     {
         gu_trace(offset = Message::unserialize(buf, buflen, offset));
     }
-    gu_trace(offset = gu::unserialize1(buf, buflen, offset, user_type_));
+    // fixed scalar field group, bounds checked once
+    gu_trace(gu::check_bounds(offset + 4 + sizeof(seq_) + sizeof(aru_seq_),
+                              buflen));
+    offset = gu::unserialize1_unchecked(buf, offset, user_type_);
     uint8_t b;
-    gu_trace(offset = gu::unserialize1(buf, buflen, offset, b));
+    offset = gu::unserialize1_unchecked(buf, offset, b);
     seq_range_ = b;
     uint16_t pad;
-    gu_trace(offset = gu::unserialize2(buf, buflen, offset, pad));
+    offset = gu::unserialize2_unchecked(buf, offset, pad);
     if (pad != 0)
     {
         log_warn << "invalid pad: " << pad;
     }
-    gu_trace(offset = gu::unserialize8(buf, buflen, offset, seq_));
-    gu_trace(offset = gu::unserialize8(buf, buflen, offset, aru_seq_));
+    offset = gu::unserialize8_unchecked(buf, offset, seq_);
+    offset = gu::unserialize8_unchecked(buf, offset, aru_seq_);
 
     return offset;
 }
@@ -302,6 +312,69 @@ size_t gcomm::evs::UserMessage::serial_size() const
 }
 
 
+size_t gcomm::evs::UserMessageSerializer::serialize(const UserMessage& msg,
+                                                    gu::byte_t* const  buf,
+                                                    size_t      const  buflen,
+                                                    size_t             offset)
+{
+    gcomm_assert(msg.type() == Message::EVS_T_USER);
+
+    bool const has_source((msg.flags() & Message::F_SOURCE) != 0);
+
+    if (size_                 == 0           ||
+        msg.version()         != version_    ||
+        has_source            != has_source_ ||
+        msg.source_view_id()  != view_id_    ||
+        (has_source == true && msg.source() != source_))
+    {
+        // (Re)build the template. Everything the full serialization
+        // writes is captured here; the per message path below patches
+        // the variable fields over the copy.
+        size_t const size(msg.serial_size());
+        gcomm_assert(size <= sizeof(tpl_));
+        gu_trace((void)msg.serialize(tpl_, sizeof(tpl_), 0));
+        view_id_    = msg.source_view_id();
+        source_     = msg.source();
+        version_    = msg.version();
+        has_source_ = has_source;
+        size_       = size;
+    }
+
+    if (buflen < offset + size_)
+    {
+        gu_throw_error(EMSGSIZE) << "buffer too short: " << buflen
+                                 << " < " << offset + size_;
+    }
+
+    std::copy(tpl_, tpl_ + size_, buf + offset);
+
+    // patch the variable fields, offsets as in Message/UserMessage
+    // serialize()
+    uint8_t const zv(msg.version() != 0 ? 1 : 0);
+    uint8_t const b(static_cast<uint8_t>(zv
+                                         | (Message::EVS_T_USER << 2)
+                                         | (msg.order() << 5)));
+    size_t const hdr(4 + sizeof(int64_t) +
+                     (has_source == true ? UUID::serial_size() : 0) +
+                     ViewId::serial_size());
+
+    gcomm_assert(msg.seq_range() >= 0 && msg.seq_range() <= seqno_t(0xff));
+
+    gu_trace((void)gu::serialize1(b, buf, buflen, offset));
+    gu_trace((void)gu::serialize1(msg.flags(), buf, buflen, offset + 1));
+    gu_trace((void)gu::serialize8(msg.fifo_seq(), buf, buflen, offset + 4));
+    gu_trace((void)gu::serialize1(msg.user_type(), buf, buflen,
+                                  offset + hdr));
+    gu_trace((void)gu::serialize1(static_cast<uint8_t>(msg.seq_range()),
+                                  buf, buflen, offset + hdr + 1));
+    gu_trace((void)gu::serialize8(msg.seq(), buf, buflen, offset + hdr + 4));
+    gu_trace((void)gu::serialize8(msg.aru_seq(), buf, buflen,
+                                  offset + hdr + 12));
+
+    return offset + size_;
+}
+
+
 size_t gcomm::evs::AggregateMessage::serialize(gu::byte_t* const buf,
                                                size_t      const buflen,
                                                size_t            offset) const
@@ -362,8 +435,10 @@ size_t gcomm::evs::GapMessage::serialize(gu::byte_t* const buf,
                                          size_t            offset) const
 {
     gu_trace(offset = Message::serialize(buf, buflen, offset));
-    gu_trace(offset = gu::serialize8(seq_, buf, buflen, offset));
-    gu_trace(offset = gu::serialize8(aru_seq_, buf, buflen, offset));
+    gu_trace(gu::check_bounds(offset + sizeof(seq_) + sizeof(aru_seq_),
+                              buflen));
+    offset = gu::serialize8_unchecked(seq_, buf, offset);
+    offset = gu::serialize8_unchecked(aru_seq_, buf, offset);
     gu_trace(offset = range_uuid_.serialize(buf, buflen, offset));
     gu_trace(offset = range_.serialize(buf, buflen, offset));
     return offset;
@@ -378,8 +453,10 @@ size_t gcomm::evs::GapMessage::unserialize(const gu::byte_t* const buf,
     {
         gu_trace(offset = Message::unserialize(buf, buflen, offset));
     }
-    gu_trace(offset = gu::unserialize8(buf, buflen, offset, seq_));
-    gu_trace(offset = gu::unserialize8(buf, buflen, offset, aru_seq_));
+    gu_trace(gu::check_bounds(offset + sizeof(seq_) + sizeof(aru_seq_),
+                              buflen));
+    offset = gu::unserialize8_unchecked(buf, offset, seq_);
+    offset = gu::unserialize8_unchecked(buf, offset, aru_seq_);
     gu_trace(offset = range_uuid_.unserialize(buf, buflen, offset));
     gu_trace(offset = range_.unserialize(buf, buflen, offset));
     return offset;
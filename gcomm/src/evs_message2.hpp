@@ -28,6 +28,7 @@ namespace gcomm
         class Message;
         std::ostream& operator<<(std::ostream&, const Message&);
         class UserMessage;
+        class UserMessageSerializer;
         class AggregateMessage;
         std::ostream& operator<<(std::ostream&, const AggregateMessage&);
         class DelegateMessage;
@@ -449,6 +450,46 @@ public:
 };
 
 
+/*!
+ * Header template cache for serializing user messages on the send
+ * hot path. Consecutive user messages from the same source and view
+ * differ only in order, flags, fifo_seq, user_type, seq_range, seq
+ * and aru_seq; the remaining header bytes (version, source uuid if
+ * present, source view id) are serialized once into a template and
+ * only the variable fields are patched per message. The template is
+ * rebuilt whenever source, view or version change, so view changes
+ * invalidate it implicitly.
+ */
+class gcomm::evs::UserMessageSerializer
+{
+public:
+    UserMessageSerializer()
+        :
+        view_id_   (),
+        source_    (),
+        version_   (-1),
+        has_source_(false),
+        size_      (0)
+    { }
+
+    /*!
+     * Serialize msg into buf, equivalent to msg.serialize() byte for
+     * byte. Msg type must be EVS_T_USER.
+     */
+    size_t serialize(const UserMessage& msg,
+                     gu::byte_t* buf, size_t buflen, size_t offset);
+
+private:
+    ViewId     view_id_;
+    UUID       source_;
+    int        version_;
+    bool       has_source_;
+    size_t     size_;
+    // large enough for a user message header with F_SOURCE set
+    gu::byte_t tpl_[128];
+};
+
+
 class gcomm::evs::AggregateMessage
 {
 public:
@@ -18,6 +18,8 @@
 
 #include "defaults.hpp"
 
+#include "gu_vector.hpp"
+
 #include <cmath>
 
 #include <stdexcept>
@@ -63,6 +65,8 @@ gcomm::evs::Proto::Proto(gu::Config&    conf,
     sent_msgs_(7, 0),
     retrans_msgs_(0),
     recovered_msgs_(0),
+    recover_overflows_(0),
+    aggregated_msgs_(0),
     recvd_msgs_(7, 0),
     delivered_msgs_(O_LOCAL_CAUSAL + 1),
     send_user_prof_    ("send_user"),
@@ -184,6 +188,7 @@ gcomm::evs::Proto::Proto(gu::Config&    conf,
                     send_window_ + 1)),
     output_(),
     send_buf_(),
+    user_msg_serializer_(),
     max_output_size_(128),
     mtu_(mtu),
     use_aggregate_(param<bool>(conf, uri, Conf::EvsUseAggregate, "true")),
@@ -495,6 +500,8 @@ void gcomm::evs::Proto::handle_get_status(gu::Status& status) const
                       gu::to_string(sent_msgs_[Message::EVS_T_INSTALL]));
         status.insert("evs_sent_leave",
                       gu::to_string(sent_msgs_[Message::EVS_T_LEAVE]));
+        status.insert("evs_aggregated_user",
+                      gu::to_string(aggregated_msgs_));
         status.insert("evs_retransmitted", gu::to_string(retrans_msgs_));
         status.insert("evs_recovered", gu::to_string(recovered_msgs_));
         status.insert("evs_deliv_safe",
@@ -555,6 +562,8 @@ std::string gcomm::evs::Proto::stats() const
               std::ostream_iterator<double>(os, ","));
     os << "}\n\tretransmitted " << retrans_msgs_ << " ";
     os << "\n\trecovered " << recovered_msgs_;
+    os << "\n\trecover reserve overflows " << recover_overflows_;
+    os << "\n\taggregated user payloads " << aggregated_msgs_;
     os << "\n\tdelivered {";
     std::copy(delivered_msgs_.begin(), delivered_msgs_.end(),
               std::ostream_iterator<long long int>(os, ", "));
@@ -813,6 +822,19 @@ private:
 };
 
 
+gu::datetime::Period gcomm::evs::Proto::effective_retrans_period() const
+{
+    // Firing retransmission requests faster than the message and its
+    // possible ack can cross the slowest link only duplicates traffic,
+    // so clamp the configured period to twice the worst case RTT
+    // bound measured by the transport (gmcast keepalives). Zero bound
+    // means no estimate, in which case the configured value is used
+    // as is.
+    const gu::datetime::Period rtt_bound(get_rtt_bound(UUID::nil()));
+    return std::max(retrans_period_,
+                    gu::datetime::Period(2*rtt_bound.get_nsecs()));
+}
+
 gu::datetime::Date gcomm::evs::Proto::next_expiration(const Timer t) const
 {
     gcomm_assert(state() != S_CLOSED);
@@ -826,7 +848,7 @@ gu::datetime::Date gcomm::evs::Proto::next_expiration(const Timer t) const
         {
         case S_OPERATIONAL:
         case S_LEAVING:
-            return (now + retrans_period_);
+            return (now + effective_retrans_period());
         case S_GATHER:
         case S_INSTALL:
             return (now + join_retrans_period_);
@@ -875,6 +897,15 @@ void gcomm::evs::Proto::cancel_timer(Timer t)
     timer_list_erase_by_type(timers_, t);
 }
 
+/* NOTE: timers_ holds at most one entry per Timer type (four in total),
+ *       so a hashed timer wheel has nothing to amortize here - the
+ *       multimap scan is over a handful of elements. Likewise
+ *       Date::now() reads CLOCK_MONOTONIC through the vDSO, not a
+ *       syscall; if clock_gettime shows up hot in a profile the machine
+ *       has usually fallen off the tsc clocksource (check
+ *       /sys/devices/system/clocksource), and a cached coarse clock
+ *       would paper over that while degrading the retransmission and
+ *       inactivity timing that depends on fresh timestamps. */
 gu::datetime::Date gcomm::evs::Proto::handle_timers()
 {
     gu::datetime::Date now(gu::datetime::Date::now());
@@ -1561,7 +1592,16 @@ int gcomm::evs::Proto::send_user(Datagram& dg,
 
     msg.set_aru_seq(input_map_->aru_seq());
     evs_log_debug(D_USER_MSGS) << " sending " << msg;
-    gu_trace(push_header(msg, dg));
+    // push_header() equivalent going through the preserialized header
+    // template, see UserMessageSerializer
+    if (dg.header_offset() < msg.serial_size())
+    {
+        gu_throw_fatal;
+    }
+    gu_trace(user_msg_serializer_.serialize(
+                 msg, dg.header(), dg.header_size(),
+                 dg.header_offset() - msg.serial_size()));
+    dg.set_header_offset(dg.header_offset() - msg.serial_size());
     if ((ret = send_down(dg, ProtoDownMeta())) != 0)
     {
         log_debug << "send failed: "  << strerror(ret);
@@ -1578,6 +1618,16 @@ int gcomm::evs::Proto::send_user(Datagram& dg,
     return 0;
 }
 
+/* NOTE: aggregation is already driven by demand, not by a timer or a
+ *       tunable batch size. A message arriving on an empty output queue
+ *       is sent immediately (handle_down()), so an idle node pays no
+ *       batching delay at all. Messages only pile up in output_ while
+ *       the send window is exhausted, i.e. exactly when the node is
+ *       backed up, and the next transmission opportunity then drains as
+ *       many of them as fit into one MTU. Batching harder than that
+ *       would mean holding back sends on an idle node, which trades p99
+ *       latency for nothing - the window, not the batch size, is what
+ *       limits throughput here. */
 size_t gcomm::evs::Proto::aggregate_len() const
 {
     bool is_aggregate(false);
@@ -1640,10 +1690,11 @@ int gcomm::evs::Proto::send_user(const seqno_t win)
             ++n;
             ++i;
         }
-        Datagram dg(gu::SharedBuffer(new gu::Buffer(send_buf_.begin(),
-                                                        send_buf_.end())));
+        Datagram dg(make_payload(&send_buf_[0],
+                                 &send_buf_[0] + send_buf_.size()));
         if ((ret = send_user(dg, 0xff, ord, win, -1, n)) == 0)
         {
+            aggregated_msgs_ += n;
             while (n-- > 0)
             {
                 output_.pop_front();
@@ -2075,30 +2126,19 @@ void gcomm::evs::Proto::resend(const UUID& gap_source, const Range range)
                              << range.lu() << " -> "
                              << range.hs();
 
-    seqno_t seq(range.lu());
-    while (seq <= range.hs())
-    {
-        InputMap::iterator msg_i = input_map_->find(
-            NodeMap::value(self_i_).index(), seq);
-        if (msg_i == input_map_->end())
-        {
-            try
-            {
-                gu_trace(msg_i = input_map_->recover(
-                             NodeMap::value(self_i_).index(), seq));
-            }
-            catch (...)
-            {
-                evs_log_debug(D_RETRANS) << "could not recover message "
-                                         << gap_source << ":" << seq;
-                seq = seq + 1;
-                continue;
-            }
-        }
+    // collect the whole requested range from the input map in one pass
+    InputMap::RecoverVector msgs;
+    gu_trace(input_map_->recover_range(NodeMap::value(self_i_).index(),
+                                       range, msgs));
+    if (gu_unlikely(msgs->size() > InputMap::RECOVER_RESERVE))
+        ++recover_overflows_;
 
-        const UserMessage& msg(InputMapMsgIndex::value(msg_i).msg());
+    for (InputMap::RecoverVector::ContainerType::const_iterator
+             i(msgs->begin()); i != msgs->end(); ++i)
+    {
+        const UserMessage& msg(InputMapMsgIndex::value(*i).msg());
         gcomm_assert(msg.source() == uuid());
-        Datagram rb(InputMapMsgIndex::value(msg_i).rb());
+        Datagram rb(InputMapMsgIndex::value(*i).rb());
         assert(rb.offset() == 0);
 
         UserMessage um(msg.version(),
@@ -2126,7 +2166,6 @@ void gcomm::evs::Proto::resend(const UUID& gap_source, const Range range)
         {
             evs_log_debug(D_RETRANS) << "retransmitted " << um;
         }
-        seq = seq + msg.seq_range() + 1;
         retrans_msgs_++;
     }
 }
@@ -2161,27 +2200,23 @@ void gcomm::evs::Proto::recover(const UUID& gap_source,
                              << " available " << im_range;
 
 
-    seqno_t seq(range.lu());
-    while (seq <= range.hs() && seq <= im_range.hs())
-    {
-        InputMap::iterator msg_i = input_map_->find(range_node.index(), seq);
-        if (msg_i == input_map_->end())
-        {
-            try
-            {
-                gu_trace(msg_i = input_map_->recover(range_node.index(), seq));
-            }
-            catch (...)
-            {
-                seq = seq + 1;
-                continue;
-            }
-        }
+    // collect the whole requested range from the input map in one pass,
+    // clamped to what has actually been seen from the node
+    InputMap::RecoverVector msgs;
+    gu_trace(input_map_->recover_range(
+                 range_node.index(),
+                 Range(range.lu(), std::min(range.hs(), im_range.hs())),
+                 msgs));
+    if (gu_unlikely(msgs->size() > InputMap::RECOVER_RESERVE))
+        ++recover_overflows_;
 
-        const UserMessage& msg(InputMapMsgIndex::value(msg_i).msg());
+    for (InputMap::RecoverVector::ContainerType::const_iterator
+             i(msgs->begin()); i != msgs->end(); ++i)
+    {
+        const UserMessage& msg(InputMapMsgIndex::value(*i).msg());
         assert(msg.source() == range_uuid);
 
-        Datagram rb(InputMapMsgIndex::value(msg_i).rb());
+        Datagram rb(InputMapMsgIndex::value(*i).rb());
         assert(rb.offset() == 0);
         UserMessage um(msg.version(),
                        msg.source(),
@@ -2209,7 +2244,6 @@ void gcomm::evs::Proto::recover(const UUID& gap_source,
         {
             evs_log_debug(D_RETRANS) << "recover " << um;
         }
-        seq = seq + msg.seq_range() + 1;
         recovered_msgs_++;
     }
 }
@@ -3030,15 +3064,14 @@ void gcomm::evs::Proto::deliver_finish(const InputMapMsg& msg)
                                     msg.rb().payload().size(),
                                     offset));
             Datagram dg(
-                gu::SharedBuffer(
-                    new gu::Buffer(
-                        &msg.rb().payload()[0]
-                        + offset
-                        + am.serial_size(),
-                        &msg.rb().payload()[0]
-                        + offset
-                        + am.serial_size()
-                        + am.len())));
+                make_payload(
+                    &msg.rb().payload()[0]
+                    + offset
+                    + am.serial_size(),
+                    &msg.rb().payload()[0]
+                    + offset
+                    + am.serial_size()
+                    + am.len()));
             ProtoUpMeta um(msg.msg().source(),
                            msg.msg().source_view_id(),
                            0,
@@ -3891,8 +3924,10 @@ void gcomm::evs::Proto::asymmetry_elimination()
         return;
     }
 
-    // Record initial operational state for logging
-    std::vector<int> oparr_before(known_.size());
+    // Record initial operational state for logging; clusters fit into
+    // the reserve, so this scratch space never hits the heap
+    gu::Vector<int, 64> oparr_before;
+    oparr_before->resize(known_.size());
     size_t index(0);
     for (NodeMap::const_iterator i(known_.begin()); i != known_.end(); ++i)
     {
@@ -3966,7 +4001,8 @@ void gcomm::evs::Proto::asymmetry_elimination()
     }
 
     // Compute final state and log if it has changed
-    std::vector<int> oparr_after(known_.size());
+    gu::Vector<int, 64> oparr_after;
+    oparr_after->resize(known_.size());
     index = 0;
     for (NodeMap::const_iterator i(known_.begin()); i != known_.end(); ++i)
     {
@@ -3974,12 +4010,12 @@ void gcomm::evs::Proto::asymmetry_elimination()
         index++;
     }
 
-    if (oparr_before != oparr_after)
+    if (oparr_before() != oparr_after())
     {
         evs_log_info(I_STATE) << "before asym elimination";
         if (info_mask_ & I_STATE)
         {
-            std::copy(oparr_before.begin(), oparr_before.end(),
+            std::copy(oparr_before().begin(), oparr_before().end(),
                       std::ostream_iterator<int>(std::cerr, " "));
             std::cerr << "\n";
         }
@@ -3987,7 +4023,7 @@ void gcomm::evs::Proto::asymmetry_elimination()
         evs_log_info(I_STATE) << "after asym elimination";
         if (info_mask_ & I_STATE)
         {
-            std::copy(oparr_after.begin(), oparr_after.end(),
+            std::copy(oparr_after().begin(), oparr_after().end(),
                       std::ostream_iterator<int>(std::cerr, " "));
             std::cerr << "\n";
         }
@@ -4312,6 +4348,36 @@ void gcomm::evs::Proto::handle_join(const JoinMessage& msg, NodeMap::iterator ii
             set_inactive(msg.source());
         }
     }
+    // Delta fast path for retransmitted joins: if the message carries
+    // exactly the state already recorded for the source and agrees with
+    // the local join, reprocessing the full membership below
+    // (retransmissions, asymmetry elimination, join recreation) cannot
+    // change anything. Answering every such join with a fresh join
+    // broadcast is what used to turn a single member change in a large
+    // stable group into several rounds of all-to-all join traffic.
+    // The consistency requirement keeps this safe for liveness: a
+    // source that is missing messages advertises ranges that differ
+    // from the local view of it and takes the full path below.
+    if (state()           == S_GATHER &&
+        install_message_  == 0        &&
+        msg.source()      != uuid())
+    {
+        const JoinMessage* const prev_join(inst.join_message());
+        if (prev_join                   != 0                      &&
+            prev_join->source_view_id() == msg.source_view_id()   &&
+            prev_join->seq()            == msg.seq()              &&
+            prev_join->aru_seq()        == msg.aru_seq()          &&
+            prev_join->node_list()      == msg.node_list()        &&
+            consensus_.is_consistent(msg) == true)
+        {
+            evs_log_debug(D_JOIN_MSGS)
+                << "duplicate join from " << msg.source()
+                << ", skipping membership reprocessing";
+            inst.set_join_message(&msg);
+            return;
+        }
+    }
+
     inst.set_join_message(&msg);
 
     // Select nodes that are coming from the same view as seen by
@@ -333,6 +333,7 @@ public:
     void handle_install_timer();
     void handle_stats_timer();
     gu::datetime::Date next_expiration(const Timer) const;
+    gu::datetime::Period effective_retrans_period() const;
     void reset_timer(Timer);
     void cancel_timer(Timer);
     gu::datetime::Date handle_timers();
@@ -383,6 +384,8 @@ private:
     std::vector<long long int> sent_msgs_;
     long long int retrans_msgs_;
     long long int recovered_msgs_;
+    long long int recover_overflows_; // recover vectors that went to heap
+    long long int aggregated_msgs_; // user payloads shipped in aggregates
     std::vector<long long int> recvd_msgs_;
     std::vector<long long int> delivered_msgs_;
     prof::Profile send_user_prof_;
@@ -485,6 +488,8 @@ private:
     // Output message queue
     std::deque<std::pair<Datagram, ProtoDownMeta> > output_;
     std::vector<gu::byte_t> send_buf_;
+    // Header template cache for the user message send path
+    UserMessageSerializer user_msg_serializer_;
     uint32_t max_output_size_;
     size_t mtu_;
     bool use_aggregate_;
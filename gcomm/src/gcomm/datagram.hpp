@@ -24,8 +24,8 @@ namespace gcomm
     //
     // Header structure is the following (MSB first)
     //
-    // | version(4) | reserved(2) | F_CRC(2) | len(24) |
-    // |                   CRC(32)                     |
+    // | version(4) | reserved(1) | F_FEC(1) | F_CRC(2) | len(24) |
+    // |                        CRC(32)                           |
     //
     class NetHeader
     {
@@ -68,6 +68,11 @@ namespace gcomm
         bool has_crc32()  const { return (len_ & F_CRC32);  }
         bool has_crc32c() const { return (len_ & F_CRC32C); }
 
+        // marks frames belonging to a forward error correction group
+        // on fec-enabled udp links, see asio_udp.cpp
+        void set_fec()         { len_ |= F_FEC; }
+        bool has_fec()   const { return (len_ & F_FEC) != 0; }
+
         uint32_t crc32()  const { return crc32_; }
 
         int version() const
@@ -96,7 +101,8 @@ namespace gcomm
         enum
         {
             F_CRC32  = 1 << 24, /* backward compatible */
-            F_CRC32C = 1 << 25
+            F_CRC32C = 1 << 25,
+            F_FEC    = 1 << 26
         };
 
         uint32_t len_;
@@ -121,7 +127,8 @@ namespace gcomm
         {
         case 0:
             if ((hdr.len_ & NetHeader::flags_mask_) &
-                ~(NetHeader::F_CRC32 | NetHeader::F_CRC32C))
+                ~(NetHeader::F_CRC32 | NetHeader::F_CRC32C |
+                  NetHeader::F_FEC))
             {
                 gu_throw_error(EPROTO)
                     << "invalid flags "
@@ -142,6 +149,17 @@ namespace gcomm
         return NetHeader::serial_size_;
     }
 
+    /*!
+     * @brief Allocate a payload buffer from the shared pool
+     *
+     * Returned buffers recycle their storage (see datagram.cpp), so
+     * constructing datagrams through these does not hit the allocator
+     * in steady state. The overloads copy the given contents in.
+     */
+    gu::SharedBuffer make_payload();
+    gu::SharedBuffer make_payload(const gu::byte_t* b, const gu::byte_t* e);
+    gu::SharedBuffer make_payload(const gu::Buffer& buf);
+
     /*!
      * @brief  Datagram container
      *
@@ -155,7 +173,7 @@ namespace gcomm
             :
             header_       (),
             header_offset_(header_size_),
-            payload_      (new gu::Buffer()),
+            payload_      (make_payload()),
             offset_       (0)
         { }
         /*!
@@ -171,7 +189,7 @@ namespace gcomm
             :
             header_       (),
             header_offset_(header_size_),
-            payload_      (new gu::Buffer(buf)),
+            payload_      (make_payload(buf)),
             offset_       (offset)
         {
             assert(offset_ <= payload_->size());
@@ -217,7 +235,7 @@ namespace gcomm
         void normalize()
         {
             const gu::SharedBuffer old_payload(payload_);
-            payload_ = gu::SharedBuffer(new gu::Buffer);
+            payload_ = make_payload();
             payload_->reserve(header_len() + old_payload->size() - offset_);
 
             if (header_len() > offset_)
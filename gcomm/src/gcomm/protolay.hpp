@@ -25,6 +25,8 @@
 #include "gu_config.hpp"
 #include "gu_status.hpp"
 
+#include <boost/shared_ptr.hpp>
+
 #include <cerrno>
 
 #include <list>
@@ -84,7 +86,7 @@ public:
         order_(),
         to_seq_(),
         err_no_(err_no),
-        view_(0)
+        view_()
     { }
 
     ProtoUpMeta(const UUID    source         = UUID::nil(),
@@ -100,9 +102,12 @@ public:
         order_          (order          ),
         to_seq_         (to_seq         ),
         err_no_         (err_no         ),
-        view_           (view != 0 ? new View(*view) : 0)
+        view_           (view != 0 ? ViewPtr(new View(*view)) : ViewPtr())
     { }
 
+    // the view is copied once on construction and shared from there on,
+    // so copying the meta while it propagates up the stack and into
+    // event queues does not reallocate the member maps
     ProtoUpMeta(const ProtoUpMeta& um) :
         source_         (um.source_         ),
         source_view_id_ (um.source_view_id_ ),
@@ -110,10 +115,10 @@ public:
         order_          (um.order_          ),
         to_seq_         (um.to_seq_         ),
         err_no_         (um.err_no_         ),
-        view_           (um.view_ ? new View(*um.view_) : 0)
+        view_           (um.view_           )
     { }
 
-    ~ProtoUpMeta() { delete view_; }
+    ~ProtoUpMeta() { }
 
     const UUID&   source()         const { return source_; }
 
@@ -127,11 +132,13 @@ public:
 
     int           err_no()          const { return err_no_; }
 
-    bool          has_view()           const { return view_ != 0; }
+    bool          has_view()           const { return view_.get() != 0; }
 
     const View&   view()           const { return *view_; }
 
 private:
+    typedef boost::shared_ptr<const View> ViewPtr;
+
     ProtoUpMeta& operator=(const ProtoUpMeta&);
 
     UUID    const source_;
@@ -140,7 +147,7 @@ private:
     Order   const order_;
     int64_t const to_seq_;
     int     const err_no_;
-    View*   const view_;
+    ViewPtr const view_;
 };
 
 inline std::ostream& gcomm::operator<<(std::ostream& os, const ProtoUpMeta& um)
@@ -189,6 +196,15 @@ private:
     const int     segment_;
 };
 
+/* NOTE: the up/down traversal stays behind virtual dispatch even though
+ *       the production stack (gmcast - evs - pc) is known in advance.
+ *       Composition is a runtime property: layers are wired together at
+ *       connect time through Protostack::push_proto(), unit tests splice
+ *       dummy layers into the middle of the stack, and the context lists
+ *       allow fan-out to several peers. Fixing the layering with
+ *       templates would buy back two indirect calls per layer per
+ *       message, which is noise next to the serialization, map and
+ *       allocation work done inside the layers. */
 class gcomm::Protolay
 {
 public:
@@ -260,7 +276,16 @@ public:
         }
 
         CtxList::iterator i, i_next;
-        for (i = up_context_.begin(); i != up_context_.end(); i = i_next)
+        i = up_context_.begin();
+        i_next = i, ++i_next;
+        if (i_next == up_context_.end())
+        {
+            // common case, the stack is a plain chain with a single
+            // up context per layer
+            (*i)->handle_up(this, dg, up_meta);
+            return;
+        }
+        for (; i != up_context_.end(); i = i_next)
         {
             i_next = i, ++i_next;
             (*i)->handle_up(this, dg, up_meta);
@@ -370,6 +395,21 @@ public:
         return "(unknown)";
     }
 
+    // Conservative round trip time bound towards the given peer,
+    // measured by the transport layer. Nil UUID queries the worst
+    // case over all established peers. Zero period means no estimate
+    // is available (yet).
+    gu::datetime::Period get_rtt_bound(const UUID& uuid) const
+    {
+        if (down_context_.empty()) return handle_get_rtt_bound(uuid);
+        else return (*down_context_.begin())->get_rtt_bound(uuid);
+    }
+
+    virtual gu::datetime::Period handle_get_rtt_bound(const UUID& uuid) const
+    {
+        return gu::datetime::Period(0);
+    }
+
 
     virtual gu::datetime::Date handle_timers()
     {
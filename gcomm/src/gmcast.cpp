@@ -844,6 +844,8 @@ void gcomm::GMCast::update_addresses()
 
     /* Add entries reported by all other nodes to address list to
      * get complete view of existing uuids/addresses */
+    std::vector<std::string> new_addrs;
+
     for (ProtoMap::iterator i = proto_map_->begin(); i != proto_map_->end(); ++i)
     {
         Proto* rp = ProtoMap::value(i);
@@ -886,19 +888,37 @@ void gcomm::GMCast::update_addresses()
                     // max retries will be readjusted in handle stable view
                     ae.set_retry_cnt(-1);
                     ae.set_max_retries(max_initial_reconnect_attempts_);
+                    ae.set_next_reconnect(gu::datetime::Date::now());
 
-                    // Add some randomness for first reconnect to avoid
-                    // simultaneous connects
-                    gu::datetime::Date rtime(gu::datetime::Date::now());
-
-                    rtime = rtime + ::rand() % (100*gu::datetime::MSec);
-                    ae.set_next_reconnect(rtime);
-                    next_check_ = std::min(next_check_, rtime);
+                    new_addrs.push_back(link_addr);
                 }
             }
         }
     }
 
+    /* Connect to all newly learned addresses right away as a batch:
+     * handshakes are asynchronous and proceed concurrently, so a cold
+     * joiner reaches the whole cluster one topology exchange after the
+     * first established link instead of trickling through jittered
+     * timer ticks. Crossing connects from two nodes dialing each other
+     * are resolved by the duplicate link handling in handle_established().
+     * Deferred until after the loop above - gmcast_connect() inserts
+     * into proto_map_ which is being iterated there. */
+    for (std::vector<std::string>::const_iterator i(new_addrs.begin());
+         i != new_addrs.end(); ++i)
+    {
+        try
+        {
+            gu_trace(gmcast_connect(*i));
+        }
+        catch (gu::Exception& e)
+        {
+            /* failed dial falls back to the regular reconnect schedule */
+            log_debug << self_string() << " immediate connect to " << *i
+                      << " failed: " << e.what();
+        }
+    }
+
     // Build multicast tree
     log_debug << self_string() << " --- mcast tree begin ---";
     segment_map_.clear();
@@ -1204,6 +1224,25 @@ gu::datetime::Date gcomm::GMCast::handle_timers()
         next_check_ = now + check_period_;
     }
 
+    /* don't quantize pending reconnects up to the liveness check grid -
+     * with 1s retry backoff the extra half a second per round adds up
+     * during cluster bootstrap. Only future due times are considered:
+     * past-due entries either have a dial in flight already or get
+     * picked up on the regular grid. */
+    for (AddrList::const_iterator i(pending_addrs_.begin());
+         i != pending_addrs_.end(); ++i)
+    {
+        const gu::datetime::Date& nr(AddrList::value(i).next_reconnect());
+        if (nr > now) next_check_ = std::min(next_check_, nr);
+    }
+
+    for (AddrList::const_iterator i(remote_addrs_.begin());
+         i != remote_addrs_.end(); ++i)
+    {
+        const gu::datetime::Date& nr(AddrList::value(i).next_reconnect());
+        if (nr > now) next_check_ = std::min(next_check_, nr);
+    }
+
     return next_check_;
 }
 
@@ -1448,6 +1487,15 @@ void gcomm::GMCast::handle_up(const void*        id,
 }
 
 
+/* NOTE: the send path is segment-aware by design. Each message crosses
+ *       to a remote segment exactly once: it is sent to a single peer
+ *       there (rotated by self_index_ to spread forwarding load), with
+ *       F_SEGMENT_RELAY telling that peer to fan out within its own
+ *       segment - see relay(). Full fan-out is reserved for the local
+ *       segment. The failure relay set built in check_liveness() also
+ *       prefers same-segment peers (CmpUuidCounts tie-break), so relays
+ *       only go through a remote site when a remote peer is the only one
+ *       that can still reach the partitioned nodes. */
 int gcomm::GMCast::handle_down(Datagram& dg, const ProtoDownMeta& dm)
 {
     Message msg(version_, Message::GMCAST_T_USER_BASE, uuid(), 1, segment_);
@@ -1639,6 +1687,59 @@ std::string gcomm::GMCast::handle_get_address(const UUID& uuid) const
     return (ali == remote_addrs_.end() ? "" : AddrList::key(ali));
 }
 
+gu::datetime::Period
+gcomm::GMCast::handle_get_rtt_bound(const UUID& uuid) const
+{
+    // For nil UUID return the worst case over established links,
+    // otherwise the bound for the given peer. Links without samples
+    // yet contribute nothing; zero period means no estimate at all.
+    long long max_bound(0);
+    for (ProtoMap::const_iterator i(proto_map_->begin());
+         i != proto_map_->end(); ++i)
+    {
+        const gmcast::Proto* p(ProtoMap::value(i));
+        if (p->state() != gmcast::Proto::S_OK || p->has_rtt() == false)
+        {
+            continue;
+        }
+        if (uuid == UUID::nil())
+        {
+            max_bound = std::max(max_bound, p->rtt_bound().get_nsecs());
+        }
+        else if (p->remote_uuid() == uuid)
+        {
+            return p->rtt_bound();
+        }
+    }
+    return gu::datetime::Period(uuid == UUID::nil() ? max_bound : 0);
+}
+
+void gcomm::GMCast::handle_get_status(gu::Status& status) const
+{
+    std::string rtts;
+    for (ProtoMap::const_iterator i(proto_map_->begin());
+         i != proto_map_->end(); ++i)
+    {
+        const gmcast::Proto* p(ProtoMap::value(i));
+        if (p->state() != gmcast::Proto::S_OK || p->has_rtt() == false)
+        {
+            continue;
+        }
+        rtts += p->remote_uuid().full_str()
+            + ":"
+            + gu::datetime::to_string(gu::datetime::Period(p->rtt_srtt()))
+            + "/"
+            + gu::datetime::to_string(gu::datetime::Period(p->rtt_rttvar()));
+        rtts += ",";
+    }
+    // Strip trailing comma
+    if (rtts.empty() == false)
+    {
+        rtts.resize(rtts.size() - 1);
+    }
+    status.insert("gmcast_peer_rtts", rtts);
+}
+
 void gcomm::GMCast::add_or_del_addr(const std::string& val)
 {
     if (val.compare(0, 4, "add:") == 0)
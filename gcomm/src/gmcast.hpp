@@ -45,6 +45,8 @@ namespace gcomm
         void handle_stable_view(const View& view);
         void handle_evict(const UUID& uuid);
         std::string handle_get_address(const UUID& uuid) const;
+        gu::datetime::Period handle_get_rtt_bound(const UUID& uuid) const;
+        void handle_get_status(gu::Status& status) const;
         bool set_param(const std::string& key, const std::string& val);
         // Transport interface
         const UUID& uuid() const { return my_uuid_; }
@@ -30,6 +30,11 @@ std::ostream& gcomm::gmcast::operator<<(std::ostream& os, const Proto& p)
        << "pr=" << p.propagate_remote_ << ","
        << "tp=" << p.tp_ << ","
        << "ts=" << p.tstamp_;
+    if (p.has_rtt())
+    {
+        os << ",rtt=" << gu::datetime::Period(p.rtt_srtt_)
+           << "/"     << gu::datetime::Period(p.rtt_rttvar_);
+    }
     return os;
 }
 
@@ -189,6 +194,32 @@ void gcomm::gmcast::Proto::handle_ok(const Message& hs)
     if (state_ == S_OK)
     {
         log_debug << "handshake ok: " << *this;
+        // In S_OK the only source of T_OK messages is the peer
+        // acking a keepalive, so the elapsed time since the last
+        // keepalive send is an RTT sample for the link. Smooth it
+        // RFC 6298 style so that a single scheduling hiccup does
+        // not distort the estimate.
+        if (ka_sent_ != gu::datetime::Date::max())
+        {
+            const long long rtt(
+                (gu::datetime::Date::now() - ka_sent_).get_nsecs());
+            ka_sent_ = gu::datetime::Date::max();
+            if (rtt >= 0)
+            {
+                if (rtt_srtt_ < 0)
+                {
+                    rtt_srtt_   = rtt;
+                    rtt_rttvar_ = rtt/2;
+                }
+                else
+                {
+                    const long long err(rtt > rtt_srtt_ ?
+                                        rtt - rtt_srtt_ : rtt_srtt_ - rtt);
+                    rtt_rttvar_ += (err - rtt_rttvar_)/4;
+                    rtt_srtt_   += (rtt - rtt_srtt_)/8;
+                }
+            }
+        }
     }
     propagate_remote_ = true;
     set_state(S_OK);
@@ -270,6 +301,13 @@ void gcomm::gmcast::Proto::send_keepalive()
     log_debug << "sending keepalive: " << *this;
     Message msg(version_, Message::GMCAST_T_KEEPALIVE,
                 gmcast_.uuid(), local_segment_, "");
+    // Time the exchange for RTT estimation, but only if the previous
+    // keepalive has been acked - otherwise the ack for the old one
+    // would be attributed to this send and shrink the sample.
+    if (ka_sent_ == gu::datetime::Date::max())
+    {
+        ka_sent_ = gu::datetime::Date::now();
+    }
     send_msg(msg);
 }
 
@@ -89,6 +89,9 @@ public:
         tp_               (tp),
         link_map_         (),
         tstamp_           (gu::datetime::Date::now()),
+        ka_sent_          (gu::datetime::Date::max()),
+        rtt_srtt_         (-1),
+        rtt_rttvar_       (-1),
         gmcast_           (gmcast)
     { }
 
@@ -127,6 +130,19 @@ public:
     int version() const { return version_; }
     void set_tstamp(gu::datetime::Date ts) { tstamp_ = ts; }
     gu::datetime::Date tstamp() const { return tstamp_; }
+
+    // Smoothed link round trip time estimate, sampled from
+    // keepalive/ok exchanges (see handle_ok()). Negative srtt means
+    // no sample has been collected yet.
+    bool has_rtt() const { return rtt_srtt_ >= 0; }
+    long long rtt_srtt() const { return rtt_srtt_; }
+    long long rtt_rttvar() const { return rtt_rttvar_; }
+    // Conservative upper bound for the link RTT, RFC 6298 style
+    // (srtt + 4 * rttvar).
+    gu::datetime::Period rtt_bound() const
+    {
+        return gu::datetime::Period(rtt_srtt_ + 4*rtt_rttvar_);
+    }
 private:
     friend std::ostream& operator<<(std::ostream&, const Proto&);
     Proto(const Proto&);
@@ -147,6 +163,9 @@ private:
     SocketPtr         tp_;
     LinkMap           link_map_;
     gu::datetime::Date tstamp_;
+    gu::datetime::Date ka_sent_;    // send time of outstanding keepalive
+    long long         rtt_srtt_;    // smoothed RTT (nsecs), -1 if no sample
+    long long         rtt_rttvar_;  // RTT mean deviation (nsecs)
     const GMCast&     gmcast_;
 };
 
@@ -591,6 +591,18 @@ void gcomm::pc::Proto::handle_reg(const View& view)
     }
     else
     {
+        // NOTE: the state exchange runs in full on every reg view, also
+        // when a briefly partitioned node returns with a view history
+        // that is a strict prefix of ours. A digest-validated shortcut
+        // readmitting such a node without the exchange has been
+        // considered and rejected: prim conflict arbitration, weight
+        // and un-flag merging in handle_state() all require every
+        // member's state message, and a rejoiner bypassing them would
+        // leave instances_ inconsistent across the component. The
+        // exchange is a single concurrent broadcast round followed by
+        // one install message, so the room for a faster handshake is
+        // one message delay; rejoin pauses on flaky links are dominated
+        // by the EVS membership timeouts that precede this point.
         shift_to(S_STATES_EXCH);
         send_state();
     }
@@ -0,0 +1,305 @@
+/* Copyright (C) 2017 Codership Oy <info@codership.com>
+ *
+ * Performance harness on top of the deterministic EVS simulation used
+ * by check_evs2.cpp. Runs a configurable number of nodes over the
+ * PropagationMatrix with per-link latency and loss, drives a fixed
+ * message rate and reports delivery latency percentiles (in simulation
+ * ticks) plus CPU cost per delivered message, so protocol-level changes
+ * (aggregation, input map tweaks) can be quantified without a cluster:
+ *
+ *   evs_bench [n_nodes] [msgs_per_node] [rate] [loss] [lat_min] [lat_max] [seed]
+ *
+ * rate is messages per node per tick, loss is the per-link delivery
+ * probability (1.0 = lossless), latency is drawn uniformly from
+ * [lat_min, lat_max] ticks per directed link.
+ */
+
+#include "evs_proto.hpp"
+
+#include "check_trace.hpp"
+
+#include "gcomm/conf.hpp"
+
+#include "gu_asio.hpp" // gu::ssl_register_params()
+#include "gu_time.h"   // gu_time_thread_cputime()
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace gcomm;
+using gu::datetime::Period;
+
+static gu::Config bench_conf;
+
+class BenchNode : public DummyNode
+{
+public:
+    BenchNode(gu::Config& conf, const size_t index,
+              const std::list<Protolay*>& protos)
+        :
+        DummyNode  (conf, index, protos),
+        next_seq_  (0),
+        send_tick_ ()
+    { }
+
+    /* like DummyNode::send(), but remembers the tick of each successful
+     * send so delivery latency can be computed */
+    bool send_at(long long const tick)
+    {
+        const int64_t seq(next_seq_);
+        gu::byte_t buf[sizeof(seq)];
+        size_t sz;
+        gu_trace(sz = gu::serialize8(seq, buf, sizeof(buf), 0));
+        Datagram dg(gu::Buffer(buf, buf + sz));
+
+        if (send_down(dg, ProtoDownMeta(0)) != 0) return false; // flow control
+
+        send_tick_.push_back(tick);
+        ++next_seq_;
+        return true;
+    }
+
+    long long send_tick(int64_t const seq) const
+    {
+        return send_tick_[static_cast<size_t>(seq)];
+    }
+
+    int64_t sent() const { return next_seq_; }
+
+    void handle_up(const void* cid, const Datagram& rb,
+                   const ProtoUpMeta& um);
+
+private:
+    int64_t                next_seq_;
+    std::vector<long long> send_tick_;
+};
+
+class Bench
+{
+public:
+    Bench() : nodes_(), tick_(0), samples_(), delivered_(0) { }
+
+    void add_node(BenchNode* n) { nodes_.push_back(n); }
+
+    std::vector<BenchNode*>& nodes() { return nodes_; }
+
+    long long tick() const { return tick_; }
+    void next_tick() { ++tick_; }
+
+    void delivered(const UUID& source, int64_t const seq)
+    {
+        /* node index is encoded in the UUID, see create_bench_node() */
+        for (size_t i(0); i < nodes_.size(); ++i)
+        {
+            if (nodes_[i]->uuid() == source)
+            {
+                samples_.push_back(tick_ - nodes_[i]->send_tick(seq));
+                ++delivered_;
+                return;
+            }
+        }
+        gu_throw_fatal << "message from unknown source " << source;
+    }
+
+    long long n_delivered() const { return delivered_; }
+
+    bool all_delivered() const
+    {
+        int64_t sent(0);
+        for (size_t i(0); i < nodes_.size(); ++i) sent += nodes_[i]->sent();
+        /* every sent message is delivered once on every node */
+        return (delivered_ == sent * static_cast<int64_t>(nodes_.size()));
+    }
+
+    long long percentile(double const p) const
+    {
+        if (samples_.empty()) return 0;
+        size_t idx(static_cast<size_t>(p * (samples_.size() - 1)));
+        return samples_[idx];
+    }
+
+    void sort_samples() { std::sort(samples_.begin(), samples_.end()); }
+
+private:
+    Bench(const Bench&);
+    void operator=(const Bench&);
+
+    std::vector<BenchNode*> nodes_;
+    long long               tick_;
+    std::vector<long long>  samples_;
+    long long               delivered_;
+};
+
+static Bench bench;
+
+void BenchNode::handle_up(const void* cid, const Datagram& rb,
+                          const ProtoUpMeta& um)
+{
+    if (rb.len() != 0)
+    {
+        int64_t seq;
+        gu_trace(gu::unserialize8(gcomm::begin(rb), gcomm::available(rb),
+                                  0, seq));
+        bench.delivered(um.source(), seq);
+    }
+    else
+    {
+        /* views go into the regular trace so that in_cvi() keeps working */
+        DummyNode::handle_up(cid, rb, um);
+    }
+}
+
+static BenchNode* create_bench_node(size_t const idx)
+{
+    /* suspect/inactive timeouts are out of reach on purpose - membership
+     * is expected to stay stable during the run - while the retransmission
+     * period is kept short so lossy runs recover quickly */
+    std::string conf = "evs://?" + Conf::EvsViewForgetTimeout + "=PT1H&"
+        + Conf::EvsInactiveCheckPeriod + "=PT20M&"
+        + Conf::EvsSuspectTimeout + "=PT1H&"
+        + Conf::EvsInactiveTimeout + "=PT1H&"
+        + Conf::EvsKeepalivePeriod + "=PT0.1S&"
+        + Conf::EvsJoinRetransPeriod + "=PT0.1S&"
+        + Conf::EvsInfoLogMask + "=0x7";
+
+    std::list<Protolay*> protos;
+    UUID uuid(static_cast<int32_t>(idx));
+    protos.push_back(new DummyTransport(uuid, false));
+    protos.push_back(new evs::Proto(bench_conf, uuid, 0, conf));
+    return new BenchNode(bench_conf, idx, protos);
+}
+
+static uint32_t max_view_seq(const std::vector<BenchNode*>& nodes, size_t n)
+{
+    uint32_t ret(0);
+    for (size_t i(0); i < n; ++i)
+    {
+        ret = std::max(ret,
+                       nodes[i]->trace().current_view_trace().view().id().seq());
+    }
+    return ret;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t    const n_nodes (argc > 1 ? atol(argv[1]) : 4);
+    long long const n_msgs  (argc > 2 ? atoll(argv[2]) : 10000);
+    double    const rate    (argc > 3 ? atof(argv[3]) : 1.0);
+    double    const loss    (argc > 4 ? atof(argv[4]) : 1.0);
+    size_t    const lat_min (argc > 5 ? atol(argv[5]) : 1);
+    size_t    const lat_max (argc > 6 ? atol(argv[6]) : lat_min);
+    unsigned  const seed    (argc > 7 ? atol(argv[7])
+                                      : static_cast<unsigned>(time(0)));
+
+    if (n_nodes < 2 || n_msgs <= 0 || rate <= 0. ||
+        loss <= 0. || loss > 1. || lat_min < 1 || lat_max < lat_min)
+    {
+        std::cerr << "usage: " << argv[0] << " [n_nodes] [msgs_per_node] "
+                  << "[rate] [loss] [lat_min] [lat_max] [seed]" << std::endl;
+        return 1;
+    }
+
+    std::cout << "nodes " << n_nodes << " msgs/node " << n_msgs
+              << " rate " << rate << " loss " << loss
+              << " latency [" << lat_min << ", " << lat_max << "]"
+              << " seed " << seed << std::endl;
+    srand(seed);
+
+    gu::ssl_register_params(bench_conf);
+    gcomm::Conf::register_params(bench_conf);
+
+    PropagationMatrix prop;
+
+    for (size_t i(1); i <= n_nodes; ++i)
+    {
+        bench.add_node(create_bench_node(i));
+    }
+
+    std::vector<BenchNode*>& nodes(bench.nodes());
+
+    /* group formation, as in test_proto_join_n */
+    uint32_t view_seq(0);
+    for (size_t i(0); i < n_nodes; ++i)
+    {
+        prop.insert_tp(nodes[i]);
+        nodes[i]->connect(i == 0);
+        for (size_t j(0); j <= i; ++j)
+        {
+            nodes[j]->set_cvi(ViewId(V_REG, nodes[0]->uuid(), view_seq + 1));
+        }
+        prop.propagate_until_cvi(false);
+        view_seq = max_view_seq(nodes, i + 1);
+    }
+
+    /* per-link latency and loss, drawn once per directed link */
+    for (size_t i(1); i <= n_nodes; ++i)
+    {
+        for (size_t j(1); j <= n_nodes; ++j)
+        {
+            if (i == j) continue;
+            prop.set_latency(i, j,
+                             lat_min + rand() % (lat_max - lat_min + 1));
+            prop.set_loss(i, j, loss);
+        }
+    }
+
+    long long const cpu_start(gu_time_thread_cputime());
+
+    /* message generation: every node accumulates rate credit per tick and
+     * sends whole credits away; sends refused by flow control retry on
+     * subsequent ticks */
+    std::vector<double> credit(n_nodes, 0.);
+    bool sending(true);
+
+    while (sending || bench.all_delivered() == false)
+    {
+        sending = false;
+
+        for (size_t i(0); i < n_nodes; ++i)
+        {
+            if (nodes[i]->sent() < n_msgs)
+            {
+                sending = true;
+                credit[i] += rate;
+                while (credit[i] >= 1. && nodes[i]->sent() < n_msgs)
+                {
+                    if (nodes[i]->send_at(bench.tick()) == false) break;
+                    credit[i] -= 1.;
+                }
+            }
+        }
+
+        prop.propagate_n(1);
+        bench.next_tick();
+
+        /* drive retransmission timers while draining lossy runs */
+        if (sending == false && bench.tick() % 10 == 0)
+        {
+            for (size_t i(0); i < n_nodes; ++i) nodes[i]->handle_timers();
+        }
+    }
+
+    long long const cpu_ns(gu_time_thread_cputime() - cpu_start);
+
+    bench.sort_samples();
+
+    std::cout << "delivered " << bench.n_delivered() << " msgs ("
+              << n_msgs << "/node x " << n_nodes << " nodes) in "
+              << bench.tick() << " ticks" << std::endl;
+    std::cout << "delivery latency (ticks): "
+              << "p50 "  << bench.percentile(.50)
+              << " p90 " << bench.percentile(.90)
+              << " p99 " << bench.percentile(.99)
+              << " max " << bench.percentile(1.) << std::endl;
+    std::cout << "cpu: " << cpu_ns / bench.n_delivered()
+              << " ns/delivered msg (" << double(cpu_ns)/gu::datetime::Sec
+              << "s total)" << std::endl;
+
+    std::vector<DummyNode*> dnodes(nodes.begin(), nodes.end());
+    check_trace(dnodes);
+    std::for_each(dnodes.begin(), dnodes.end(), gu::DeleteObject());
+
+    return 0;
+}
@@ -0,0 +1,247 @@
+/* Copyright (C) 2017 Codership Oy <info@codership.com>
+ *
+ * Point-to-point throughput benchmark for the gcomm socket layer.
+ * Run the same binary once as server and once as client against
+ * tcp:// and ssl:// URIs to compare the plain and encrypted paths:
+ *
+ *   net_bench -s <conf> tcp://127.0.0.1:10001
+ *   net_bench -c <conf> tcp://127.0.0.1:10001 [msg_size] [msg_count]
+ *
+ * The server reports received throughput periodically, the client
+ * reports the send-side rate when done.
+ */
+
+#include "gcomm/protonet.hpp"
+#include "gcomm/util.hpp"
+#include "gcomm/conf.hpp"
+
+#include "gu_datetime.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+
+static gu::Config conf;
+
+class BenchClient : public gcomm::Toplay
+{
+public:
+    BenchClient(gcomm::Protonet& pnet, const std::string& uri)
+        :
+        gcomm::Toplay(conf),
+        uri_   (uri),
+        pnet_  (pnet),
+        pstack_(),
+        socket_(pnet_.socket(uri))
+    {
+        pstack_.push_proto(this);
+        pnet_.insert(&pstack_);
+    }
+
+    ~BenchClient()
+    {
+        pnet_.erase(&pstack_);
+        pstack_.pop_proto(this);
+        socket_->close();
+    }
+
+    void connect()
+    {
+        socket_->connect(uri_);
+        while (socket_->state() == gcomm::Socket::S_CONNECTING)
+        {
+            pnet_.event_loop(gu::datetime::Period(10*gu::datetime::MSec));
+        }
+        if (socket_->state() != gcomm::Socket::S_CONNECTED)
+        {
+            throw std::runtime_error("connect failed");
+        }
+    }
+
+    void run(size_t const msg_size, long long const msg_count)
+    {
+        static long long const burst(32);
+
+        gcomm::Datagram dg;
+        dg.payload().resize(msg_size);
+
+        gu::datetime::Date const start(gu::datetime::Date::now());
+
+        for (long long sent(0); sent < msg_count; )
+        {
+            for (long long i(0); i < burst && sent < msg_count; ++i, ++sent)
+            {
+                if (socket_->send(dg) != 0)
+                {
+                    throw std::runtime_error("send failed");
+                }
+            }
+            /* let the event loop flush the burst */
+            pnet_.event_loop(gu::datetime::Period(0));
+        }
+
+        /* drain */
+        pnet_.event_loop(gu::datetime::Period(1*gu::datetime::Sec));
+
+        double const sec(double(gu::datetime::Date::now().get_utc()
+                                - start.get_utc()) / gu::datetime::Sec);
+        double const mb(double(msg_count)*msg_size/(1 << 20));
+
+        std::cout << "sent " << msg_count << " x " << msg_size
+                  << "B in " << sec << "s: " << mb/sec << " MB/s, "
+                  << msg_count/sec << " msg/s" << std::endl;
+    }
+
+    void handle_up(const void* id, const gcomm::Datagram& dg,
+                   const gcomm::ProtoUpMeta& um)
+    {
+        if (um.err_no() != 0)
+        {
+            log_error << "socket failed: " << um.err_no();
+            socket_->close();
+            throw std::runtime_error("socket failed");
+        }
+    }
+
+private:
+    BenchClient(const BenchClient&);
+    void operator=(const BenchClient&);
+
+    gu::URI           uri_;
+    gcomm::Protonet&  pnet_;
+    gcomm::Protostack pstack_;
+    gcomm::SocketPtr  socket_;
+};
+
+
+class BenchServer : public gcomm::Toplay
+{
+public:
+    BenchServer(gcomm::Protonet& pnet, const std::string& uri)
+        :
+        gcomm::Toplay(conf),
+        uri_      (uri),
+        pnet_     (pnet),
+        pstack_   (),
+        listener_ (),
+        smap_     (),
+        bytes_    (0),
+        msgs_     (0),
+        last_     (gu::datetime::Date::now())
+    {
+        pstack_.push_proto(this);
+        pnet_.insert(&pstack_);
+        listener_ = pnet_.acceptor(uri_);
+    }
+
+    ~BenchServer()
+    {
+        delete listener_;
+        pnet_.erase(&pstack_);
+        pstack_.pop_proto(this);
+    }
+
+    void listen()
+    {
+        listener_->listen(uri_);
+    }
+
+    void handle_up(const void* id, const gcomm::Datagram& dg,
+                   const gcomm::ProtoUpMeta& um)
+    {
+        if (id == listener_->id())
+        {
+            gcomm::SocketPtr socket(listener_->accept());
+            smap_.insert(std::make_pair(socket->id(), socket));
+            bytes_ = 0;
+            msgs_  = 0;
+            last_  = gu::datetime::Date::now();
+            return;
+        }
+
+        std::map<const void*, gcomm::SocketPtr>::iterator si(smap_.find(id));
+        if (si == smap_.end()) return;
+
+        if (um.err_no() != 0)
+        {
+            si->second->close();
+            smap_.erase(si);
+            return;
+        }
+
+        bytes_ += gcomm::available(dg);
+        ++msgs_;
+
+        gu::datetime::Date const now(gu::datetime::Date::now());
+        long long const elapsed(now.get_utc() - last_.get_utc());
+
+        if (elapsed >= 1*gu::datetime::Sec)
+        {
+            double const sec(double(elapsed)/gu::datetime::Sec);
+            std::cout << "recv " << double(bytes_)/(1 << 20)/sec
+                      << " MB/s, " << msgs_/sec << " msg/s" << std::endl;
+            bytes_ = 0;
+            msgs_  = 0;
+            last_  = now;
+        }
+    }
+
+private:
+    BenchServer(const BenchServer&);
+    void operator=(const BenchServer&);
+
+    gu::URI                                 uri_;
+    gcomm::Protonet&                        pnet_;
+    gcomm::Protostack                       pstack_;
+    gcomm::Acceptor*                        listener_;
+    std::map<const void*, gcomm::SocketPtr> smap_;
+    long long                               bytes_;
+    long long                               msgs_;
+    gu::datetime::Date                      last_;
+};
+
+
+int main(int argc, char* argv[])
+{
+    if (argc < 4)
+    {
+        std::cerr << "usage: " << argv[0]
+                  << " <-s|-c> <conf> <uri> [msg_size] [msg_count]"
+                  << std::endl;
+        return 1;
+    }
+
+    gcomm::Conf::register_params(conf);
+    conf.parse(argv[2]);
+    std::auto_ptr<gcomm::Protonet> pnet(gcomm::Protonet::create(conf));
+
+    try
+    {
+        if (std::string("-s") == argv[1])
+        {
+            BenchServer server(*pnet, argv[3]);
+            server.listen();
+            while (true)
+            {
+                pnet->event_loop(gu::datetime::Period(1*gu::datetime::Sec));
+            }
+        }
+        else
+        {
+            size_t    const msg_size (argc > 4 ? atol(argv[4]) : 1024);
+            long long const msg_count(argc > 5 ? atoll(argv[5]) : 100000);
+
+            BenchClient client(*pnet, argv[3]);
+            client.connect();
+            client.run(msg_size, msg_count);
+        }
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << "benchmark failed: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -17,6 +17,8 @@
 
 #include <galerautils.h>
 #include "gu_debug_sync.hpp"
+#include "gu_histogram.hpp"
+#include "gu_thread.hpp"
 
 #include "gcs_priv.hpp"
 #include "gcs_params.hpp"
@@ -93,7 +95,19 @@ static const char* gcs_conn_state_str[GCS_CONN_STATE_MAX] =
 static bool const GCS_FC_STOP = true;
 static bool const GCS_FC_CONT = false;
 
-/** Flow control message */
+/** Flow control message
+ *
+ * NOTE: this is a fixed-size on-wire structure - receivers assert that
+ *       an FC event is exactly this long - so it cannot grow a receive
+ *       window field (for credit-based, continuously paced flow control)
+ *       without a group protocol version bump and sender-side pacing
+ *       logic on every member. Within the current binary on/off scheme
+ *       the oscillation is dampened by the gcs.fc_factor hysteresis gap
+ *       between upper_limit and lower_limit, by the fc_offset decay
+ *       in gcs_fc_cont_begin(), which lets a draining queue resume
+ *       before it empties completely, and by the gcs.fc_settle_time
+ *       grace period (gcs_fc_queue_lagging()), which keeps transient
+ *       queue spikes from pausing the cluster at all. */
 struct gcs_fc_event
 {
     uint32_t conf_id; // least significant part of configuraiton seqno
@@ -168,12 +182,34 @@ struct gcs_conn
     long         upper_limit;         // upper slave queue limit
     long         lower_limit;         // lower slave queue limit
     long         fc_offset;           // offset for catchup phase
+
+    /* slave queue watermark: early-warning callback fired before FC
+     * engages, see gcs_set_recv_q_watermark_cb() */
+    long               q_mark_high;   // fire when queue_len exceeds this
+    long               q_mark_low;    // clear when queue_len drains below
+    bool               q_over_mark;   // current side of the watermark
+    gcs_watermark_cb_t watermark_cb;
+    void*              watermark_ctx;
+
+    long long    fc_over_since;       // when queue was first seen over the
+                                      // FC limit (monotonic ns), 0 if never
+    long         fc_over_len;         // queue length at that moment
     gcs_conn_state_t max_fc_state;    // maximum state when FC is enabled
     long         stats_fc_stop_sent;  // FC stats counters
     long         stats_fc_cont_sent;  //
     long         stats_fc_received;   //
     gcs_fc_t     stfc; // state transfer FC object
 
+    /* Latency histograms, guarded by hs_lock. Exported via gcs_get_status()
+     * alongside the EVS delivery histograms they are meant to be read with:
+     * sm wait growing while delivery latency stays flat points at local
+     * send queuing, the opposite at the group/transport. */
+    gu_mutex_t     hs_lock;
+    gu::Histogram* hs_sm_wait;    // send monitor entry wait times
+    gu::Histogram* hs_repl_tord;  // TORDERED send-to-self-delivery latencies
+    gu::Histogram* hs_repl_streq; // STATE_REQ send-to-self-delivery latencies
+    gu::Histogram* hs_recvq_wait; // recv_q delivery-to-consumer-pickup waits
+
     /* #603, #606 join control */
     bool        volatile need_to_join;
     gcs_seqno_t volatile join_seqno;
@@ -208,21 +244,60 @@ struct gcs_recv_act
 {
     struct gcs_act_rcvd rcvd;
     gcs_seqno_t         local_id;
+    long long           queued_at; // gu_time_monotonic() when pushed to
+                                   // recv_q, 0 if not applicable
 };
 
 struct gcs_repl_act
 {
     const struct gu_buf* act_in;
     struct gcs_action*   action;
+    const void*          orig_buf;
     gu_mutex_t           wait_mutex;
     gu_cond_t            wait_cond;
-    gcs_repl_act(const struct gu_buf* a_act_in, struct gcs_action* a_action)
+    bool                 signaled;
+    int                  notify_fd; // eventfd to signal on delivery, or -1
+    long long            sent_at; // gu_time_monotonic() of successful send
+    gcs_repl_act(const struct gu_buf* a_act_in, struct gcs_action* a_action,
+                 int a_notify_fd = -1)
       :
         act_in(a_act_in),
-        action(a_action)
+        action(a_action),
+        orig_buf(a_action->buf),
+        signaled(false),
+        notify_fd(a_notify_fd),
+        sent_at(0)
     { }
 };
 
+/*! Signals action delivery: wakes a cond waiter and, when the submitter
+ *  requested fd-based completion, bumps the notification eventfd so a
+ *  poll/epoll loop can pick the handle up with gcs_repl_collect().
+ *  Must be called under act->wait_mutex. */
+static inline void
+_repl_act_signal (struct gcs_repl_act* act)
+{
+    act->signaled = true;
+    gu_cond_signal (&act->wait_cond);
+
+    if (act->notify_fd >= 0) {
+        uint64_t const one = 1;
+        ssize_t ret;
+
+        do {
+            ret = write (act->notify_fd, &one, sizeof(one));
+        } while (ret < 0 && EINTR == errno);
+
+        if (ret != sizeof(one)) {
+            /* the waiter is not lost - the fd is only a wakeup hint and
+             * gcs_repl_collect() polls the signaled flag - but the event
+             * loop above us may stall on this action */
+            gu_warn ("Failed to signal replication event fd %d: %d (%s)",
+                     act->notify_fd, errno, strerror (errno));
+        }
+    }
+}
+
 /*! Releases resources associated with parameters */
 static void
 _cleanup_params (gcs_conn_t* conn)
@@ -331,11 +406,25 @@ gcs_create (gu_config_t* const conf, gcache_t* const gcache,
         goto sm_create_failed;
     }
 
+    {
+        /* same bucket spacing as the EVS delivery histograms */
+        static const char* const hs_buckets =
+            "0.0,0.0001,0.00031623,0.001,0.0031623,0.01,"
+            "0.031623,0.1,0.31623,1.,3.1623,10.,31.623";
+        conn->hs_sm_wait    = new gu::Histogram (hs_buckets);
+        conn->hs_repl_tord  = new gu::Histogram (hs_buckets);
+        conn->hs_repl_streq = new gu::Histogram (hs_buckets);
+        conn->hs_recvq_wait = new gu::Histogram (hs_buckets);
+        gu_mutex_init (&conn->hs_lock, NULL);
+    }
+
     conn->state        = GCS_CONN_CLOSED;
     conn->my_idx       = -1;
     conn->local_act_id = GCS_SEQNO_FIRST;
     conn->global_seqno = 0;
     conn->fc_offset    = 0;
+    conn->fc_over_since= 0;
+    conn->fc_over_len  = 0;
     conn->timeout      = GU_TIME_ETERNITY;
     conn->gcache       = gcache;
     conn->max_fc_state = conn->params.sync_donor ?
@@ -420,16 +509,59 @@ gcs_send_fc_event (gcs_conn_t* conn, bool stop)
     return gcs_core_send_fc (conn->core, &fc, sizeof(fc));
 }
 
+/* To be called under slave queue lock when the queue is over the FC limit.
+ * Returns true if the backlog is persistent enough to warrant FC_STOP:
+ * a spike that the appliers are draining on their own is given
+ * gcs.fc_settle_time to settle before the whole cluster is paused. The
+ * settle window (re)starts whenever the queue dips below the length at
+ * which it was opened - that is, whenever drain rate caught up with the
+ * incoming rate - so only a queue that keeps net-growing trips FC.
+ * The grace period does not apply once the queue has grown to twice the
+ * limit: by then waiting any longer only deepens the eventual pause. */
+static inline bool
+gcs_fc_queue_lagging (gcs_conn_t* conn)
+{
+    if (conn->params.fc_settle_time <= 0.0) return true; // classic behavior
+
+    long const limit (conn->upper_limit + conn->fc_offset);
+
+    if (gu_unlikely(conn->queue_len > 2*limit)) {
+        conn->fc_over_since = 0;
+        return true;
+    }
+
+    long long const now (gu_time_monotonic());
+
+    if (0 == conn->fc_over_since || conn->queue_len < conn->fc_over_len) {
+        conn->fc_over_since = now;
+        conn->fc_over_len   = conn->queue_len;
+        return false;
+    }
+
+    if (now - conn->fc_over_since >=
+        (long long)(conn->params.fc_settle_time * 1.0e+9)) {
+        conn->fc_over_since = 0; // fresh window for the next episode
+        return true;
+    }
+
+    return false;
+}
+
 /* To be called under slave queue lock. Returns true if FC_STOP must be sent */
 static inline bool
 gcs_fc_stop_begin (gcs_conn_t* conn)
 {
     long err = 0;
 
-    bool ret = (conn->stop_count <= 0                                     &&
-                conn->stop_sent_ <= 0                                     &&
-                conn->queue_len  >  (conn->upper_limit + conn->fc_offset) &&
-                conn->state      <= conn->max_fc_state                    &&
+    bool const over (conn->queue_len > (conn->upper_limit + conn->fc_offset));
+
+    if (!over) conn->fc_over_since = 0;
+
+    bool ret = (conn->stop_count <= 0            &&
+                conn->stop_sent_ <= 0            &&
+                over                             &&
+                conn->state      <= conn->max_fc_state &&
+                gcs_fc_queue_lagging (conn)      &&
                 !(err = gu_mutex_lock (&conn->fc_lock)));
 
     if (gu_unlikely(err)) {
@@ -659,6 +791,13 @@ gcs_become_open (gcs_conn_t* conn)
     gcs_shift_state (conn, GCS_CONN_OPEN);
 }
 
+/* NOTE: adapting the fragment size at runtime (e.g. to observed RTT/loss
+ *       or send queue depth) is off the table until #600 is properly fixed:
+ *       resizing the send buffer races with a send in progress, which is
+ *       why runtime changes are rejected below. Also, RTT and loss are
+ *       only observed inside gcomm (evs), which exposes no such feedback
+ *       to this layer. Until then the static trade-off lives in
+ *       gcs.max_packet_size. */
 static long
 gcs_set_pkt_size (gcs_conn_t *conn, long pkt_size)
 {
@@ -854,6 +993,40 @@ _set_fc_limits (gcs_conn_t* conn)
 
     gu_info ("Flow-control interval: [%ld, %ld]",
              conn->lower_limit, conn->upper_limit);
+
+    if (conn->params.recv_q_watermark > 0.0) {
+        conn->q_mark_high = conn->upper_limit*conn->params.recv_q_watermark +.5;
+        conn->q_mark_low  = conn->q_mark_high / 2;
+        gu_info ("Recv queue watermark interval: [%ld, %ld]",
+                 conn->q_mark_low, conn->q_mark_high);
+    }
+    else {
+        conn->q_mark_high = 0;
+        conn->q_mark_low  = 0;
+    }
+}
+
+/*! Fires the watermark callback on queue length crossings. Called right
+ *  after every conn->queue_len update, so possibly under the recv queue
+ *  lock - the callback contract in gcs.hpp demands it stays cheap. */
+static inline void
+gcs_check_recv_q_watermark (gcs_conn_t* conn)
+{
+    if (gu_likely(0 == conn->q_mark_high || NULL == conn->watermark_cb))
+        return;
+
+    if (!conn->q_over_mark) {
+        if (gu_unlikely(conn->queue_len > conn->q_mark_high)) {
+            conn->q_over_mark = true;
+            conn->watermark_cb (conn->watermark_ctx, conn->queue_len,
+                                conn->q_mark_high, true);
+        }
+    }
+    else if (conn->queue_len < conn->q_mark_low) {
+        conn->q_over_mark = false;
+        conn->watermark_cb (conn->watermark_ctx, conn->queue_len,
+                            conn->q_mark_low, false);
+    }
 }
 
 /*! Handles flow control events
@@ -1266,7 +1439,7 @@ _close(gcs_conn_t* conn, bool join_recv_thread)
              * they'll quit on their own,
              * they don't depend on the conn object after waking */
             gu_mutex_lock   (&act->wait_mutex);
-            gu_cond_signal  (&act->wait_cond);
+            _repl_act_signal (act);
             gu_mutex_unlock (&act->wait_mutex);
         }
         gcs_fifo_lite_close (conn->repl_q);
@@ -1296,6 +1469,8 @@ static void *gcs_recv_thread (void *arg)
                        NULL, NULL, NULL);
 #endif /* HAVE_PSI_INTERFACE */
 
+    gu::thread_cpu_register ("gcs_recv");
+
     ssize_t     ret  = -ECONNABORTED;
 
     // To avoid race between gcs_open() and the following state check in while()
@@ -1325,8 +1500,9 @@ static void *gcs_recv_thread (void *arg)
             assert (GCS_ACT_ERROR == rcvd.act.type);
             assert (GCS_SEQNO_ILL == rcvd.id);
 
-            err_act->rcvd     = rcvd;
-            err_act->local_id = GCS_SEQNO_ILL;
+            err_act->rcvd      = rcvd;
+            err_act->local_id  = GCS_SEQNO_ILL;
+            err_act->queued_at = 0;
 
             GCS_FIFO_PUSH_TAIL (conn, rcvd.act.buf_len);
 
@@ -1381,7 +1557,7 @@ static void *gcs_recv_thread (void *arg)
             repl_act->action->seqno_l = this_act_id;
 
             gu_mutex_lock   (&repl_act->wait_mutex);
-            gu_cond_signal  (&repl_act->wait_cond);
+            _repl_act_signal (repl_act);
             gu_mutex_unlock (&repl_act->wait_mutex);
         }
         else if (gu_likely(this_act_id >= 0))
@@ -1392,10 +1568,12 @@ static void *gcs_recv_thread (void *arg)
 
             if (gu_likely (NULL != recv_act)) {
 
-                recv_act->rcvd     = rcvd;
-                recv_act->local_id = this_act_id;
+                recv_act->rcvd      = rcvd;
+                recv_act->local_id  = this_act_id;
+                recv_act->queued_at = gu_time_monotonic();
 
                 conn->queue_len = gu_fifo_length (conn->recv_q) + 1;
+                gcs_check_recv_q_watermark (conn);
                 bool const send_stop(gcs_fc_stop_begin(conn));
 
                 // release queue
@@ -1460,6 +1638,8 @@ static void *gcs_recv_thread (void *arg)
     }
     gu_info ("RECV thread exiting %d: %s", ret, strerror(-ret));
 
+    gu::thread_cpu_unregister ();
+
 #ifdef HAVE_PSI_INTERFACE
     pfs_instr_callback(WSREP_PFS_INSTR_TYPE_THREAD,
                        WSREP_PFS_INSTR_OPS_DESTROY,
@@ -1610,6 +1790,12 @@ long gcs_destroy (gcs_conn_t *conn)
 
     /* This must not last for long */
     while (gu_mutex_destroy (&conn->fc_lock));
+    while (gu_mutex_destroy (&conn->hs_lock));
+
+    delete conn->hs_sm_wait;    conn->hs_sm_wait    = NULL;
+    delete conn->hs_repl_tord;  conn->hs_repl_tord  = NULL;
+    delete conn->hs_repl_streq; conn->hs_repl_streq = NULL;
+    delete conn->hs_recvq_wait; conn->hs_recvq_wait = NULL;
 
     _cleanup_params (conn);
 
@@ -1663,127 +1849,186 @@ gcs_seqno_t gcs_caused(gcs_conn_t* conn)
 }
 
 /* Puts action in the send queue and returns after it is replicated */
-long gcs_replv (gcs_conn_t*          const conn,      //!<in
-                const struct gu_buf* const act_in,    //!<in
-                struct gcs_action*   const act,       //!<inout
-                bool                 const scheduled) //!<in
+/*! Queues the action in repl_q and sends it to group. On success the action
+ *  will eventually be delivered back and the queued gcs_repl_act signaled. */
+/*! Records the time elapsed since start_ns in a latency histogram */
+static inline void
+_hs_insert (gcs_conn_t* conn, gu::Histogram* hs, long long start_ns)
 {
-    if (gu_unlikely((size_t)act->size > GCS_MAX_ACT_SIZE)) return -EMSGSIZE;
+    double const sec ((gu_time_monotonic() - start_ns) * 1.0e-9);
 
-    long ret;
+    gu_mutex_lock   (&conn->hs_lock);
+    hs->insert (sec);
+    gu_mutex_unlock (&conn->hs_lock);
+}
 
-    assert (act);
-    assert (act->size > 0);
+static long
+_repl_submit (gcs_conn_t*          const conn,
+              struct gcs_repl_act* const repl_act,
+              bool                 const scheduled)
+{
+    struct gcs_action* const act(repl_act->action);
+    long ret;
 
     act->seqno_l = GCS_SEQNO_ILL;
     act->seqno_g = GCS_SEQNO_ILL;
 
-    /* This is good - we don't have to do a copy because we wait */
-    struct gcs_repl_act repl_act(act_in, act);
-
-    gu_mutex_init (&repl_act.wait_mutex, NULL);
-    gu_cond_init  (&repl_act.wait_cond,  NULL);
+    long long const enter_start(gu_time_monotonic());
 
-    /* Send action and wait for signal from recv_thread
-     * we need to lock a mutex before we can go wait for signal */
-    if (!(ret = gu_mutex_lock (&repl_act.wait_mutex)))
+    // Send monitor entry here does the following:
+    // 1. serializes gcs_core_send() access between gcs_repl() and
+    //    gcs_send()
+    // 2. avoids race with gcs_close() and gcs_destroy()
+    if (!(ret = gcs_sm_enter (conn->sm, &repl_act->wait_cond, scheduled, true)))
     {
-        // Lock here does the following:
-        // 1. serializes gcs_core_send() access between gcs_repl() and
-        //    gcs_send()
-        // 2. avoids race with gcs_close() and gcs_destroy()
-        if (!(ret = gcs_sm_enter (conn->sm, &repl_act.wait_cond, scheduled, true)))
+        _hs_insert (conn, conn->hs_sm_wait, enter_start);
+
+        struct gcs_repl_act** act_ptr;
+
+        // some hack here to achieve one if() instead of two:
+        // ret = -EAGAIN part is a workaround for #569
+        // if (conn->state >= GCS_CONN_CLOSE) or (act_ptr == NULL)
+        // ret will be -ENOTCONN
+        if ((ret = -EAGAIN,
+             conn->upper_limit >= conn->queue_len ||
+             act->type         != GCS_ACT_TORDERED)         &&
+            (ret = -ENOTCONN, GCS_CONN_OPEN >= conn->state) &&
+            (act_ptr = (struct gcs_repl_act**)gcs_fifo_lite_get_tail (conn->repl_q)))
         {
-            struct gcs_repl_act** act_ptr;
-
-//#ifndef NDEBUG
-            const void* const orig_buf = act->buf;
-//#endif
-
-            // some hack here to achieve one if() instead of two:
-            // ret = -EAGAIN part is a workaround for #569
-            // if (conn->state >= GCS_CONN_CLOSE) or (act_ptr == NULL)
-            // ret will be -ENOTCONN
-            if ((ret = -EAGAIN,
-                 conn->upper_limit >= conn->queue_len ||
-                 act->type         != GCS_ACT_TORDERED)         &&
-                (ret = -ENOTCONN, GCS_CONN_OPEN >= conn->state) &&
-                (act_ptr = (struct gcs_repl_act**)gcs_fifo_lite_get_tail (conn->repl_q)))
-            {
-                *act_ptr = &repl_act;
-                gcs_fifo_lite_push_tail (conn->repl_q);
-
-                // Keep on trying until something else comes out
-                while ((ret = gcs_core_send (conn->core, act_in, act->size,
-                                             act->type)) == -ERESTART) {}
-
-                if (ret < 0) {
-                    /* remove item from the queue, it will never be delivered */
-                    gu_warn ("Send action {%p, %zd, %s} returned %d (%s)",
-                             act->buf, act->size,gcs_act_type_to_str(act->type),
-                             ret, strerror(-ret));
-
-                    if (!gcs_fifo_lite_remove (conn->repl_q)) {
-                        gu_fatal ("Failed to remove unsent item from repl_q");
-                        assert(0);
-                        ret = -ENOTRECOVERABLE;
-                    }
-                }
-                else {
-                    assert (ret == (ssize_t)act->size);
+            *act_ptr = repl_act;
+            gcs_fifo_lite_push_tail (conn->repl_q);
+
+            // Keep on trying until something else comes out
+            while ((ret = gcs_core_send (conn->core, repl_act->act_in,
+                                         act->size, act->type)) == -ERESTART) {}
+
+            if (ret < 0) {
+                /* remove item from the queue, it will never be delivered */
+                gu_warn ("Send action {%p, %zd, %s} returned %d (%s)",
+                         act->buf, act->size, gcs_act_type_to_str(act->type),
+                         ret, strerror(-ret));
+
+                if (!gcs_fifo_lite_remove (conn->repl_q)) {
+                    gu_fatal ("Failed to remove unsent item from repl_q");
+                    assert(0);
+                    ret = -ENOTRECOVERABLE;
                 }
             }
+            else {
+                assert (ret == (ssize_t)act->size);
+                repl_act->sent_at = gu_time_monotonic();
+            }
+        }
+
+        gcs_sm_leave (conn->sm);
+
+        assert(ret);
+    }
 
-            gcs_sm_leave (conn->sm);
+    return ret;
+}
 
-            assert(ret);
+/*! Translates the delivery outcome of a signaled action into a return
+ *  code. Must be called only after the action has been signaled. */
+static long
+_repl_outcome (gcs_conn_t* const conn, struct gcs_repl_act* const repl_act)
+{
+    struct gcs_action* const act(repl_act->action);
+    long ret;
+
+    ret = act->size;
 
-            /* now we can go waiting for action delivery */
-            if (ret >= 0) {
-                gu_cond_wait (&repl_act.wait_cond, &repl_act.wait_mutex);
 #ifndef GCS_FOR_GARB
-                /* assert (act->buf != 0); */
-                if (act->buf == 0)
-                {
-                    /* Recv thread purged repl_q before action was delivered */
-                    ret = -ENOTCONN;
-                    goto out;
-                }
+    /* assert (act->buf != 0); */
+    if (act->buf == 0)
+    {
+        /* Recv thread purged repl_q before action was delivered */
+        return -ENOTCONN;
+    }
 #else
-                assert (act->buf == 0);
+    assert (act->buf == 0);
 #endif /* GCS_FOR_GARB */
 
-                if (act->seqno_g < 0) {
-                    assert (GCS_SEQNO_ILL    == act->seqno_l ||
-                            GCS_ACT_TORDERED != act->type);
-
-                    if (act->seqno_g == GCS_SEQNO_ILL) {
-                        /* action was not replicated for some reason */
-                        assert (orig_buf == act->buf);
-                        ret = -EINTR;
-                    }
-                    else {
-                        /* core provided an error code in global seqno */
-                        assert (orig_buf != act->buf);
-                        ret = act->seqno_g;
-                        act->seqno_g = GCS_SEQNO_ILL;
-                    }
-
-                    if (orig_buf != act->buf) // action was allocated in gcache
-                    {
-                        gu_debug("Freeing gcache buffer %p after receiving %d",
-                                 act->buf, ret);
-                        gcs_gcache_free (conn->gcache, act->buf);
-                        act->buf = orig_buf;
-                    }
-                }
-            }
+    if (act->seqno_g >= 0 && repl_act->sent_at) {
+        _hs_insert (conn,
+                    GCS_ACT_TORDERED == act->type ?
+                    conn->hs_repl_tord : conn->hs_repl_streq,
+                    repl_act->sent_at);
+    }
+
+    if (act->seqno_g < 0) {
+        assert (GCS_SEQNO_ILL    == act->seqno_l ||
+                GCS_ACT_TORDERED != act->type);
+
+        if (act->seqno_g == GCS_SEQNO_ILL) {
+            /* action was not replicated for some reason */
+            assert (repl_act->orig_buf == act->buf);
+            ret = -EINTR;
+        }
+        else {
+            /* core provided an error code in global seqno */
+            assert (repl_act->orig_buf != act->buf);
+            ret = act->seqno_g;
+            act->seqno_g = GCS_SEQNO_ILL;
+        }
+
+        if (repl_act->orig_buf != act->buf) // action was allocated in gcache
+        {
+            gu_debug("Freeing gcache buffer %p after receiving %d",
+                     act->buf, ret);
+            gcs_gcache_free (conn->gcache, act->buf);
+            act->buf = repl_act->orig_buf;
         }
-#ifndef GCS_FOR_GARB
-    out:
-#endif /* GCS_FOR_GARB */
-        gu_mutex_unlock  (&repl_act.wait_mutex);
     }
+
+    return ret;
+}
+
+/*! Waits until the action queued by _repl_submit() is delivered back by
+ *  group and translates delivery outcome into a return code. */
+static long
+_repl_wait (gcs_conn_t* const conn, struct gcs_repl_act* const repl_act)
+{
+    long ret;
+
+    if (!(ret = gu_mutex_lock (&repl_act->wait_mutex)))
+    {
+        while (!repl_act->signaled) {
+            gu_cond_wait (&repl_act->wait_cond, &repl_act->wait_mutex);
+        }
+        gu_mutex_unlock (&repl_act->wait_mutex);
+
+        ret = _repl_outcome (conn, repl_act);
+    }
+
+    return ret;
+}
+
+long gcs_replv (gcs_conn_t*          const conn,      //!<in
+                const struct gu_buf* const act_in,    //!<in
+                struct gcs_action*   const act,       //!<inout
+                bool                 const scheduled) //!<in
+{
+    if (gu_unlikely((size_t)act->size > GCS_MAX_ACT_SIZE)) return -EMSGSIZE;
+
+    long ret;
+
+    assert (act);
+    assert (act->size > 0);
+
+    /* This is good - we don't have to do a copy because we wait */
+    struct gcs_repl_act repl_act(act_in, act);
+
+    gu_mutex_init (&repl_act.wait_mutex, NULL);
+    gu_cond_init  (&repl_act.wait_cond,  NULL);
+
+    ret = _repl_submit (conn, &repl_act, scheduled);
+
+    /* now we can go waiting for action delivery */
+    if (ret >= 0) {
+        ret = _repl_wait (conn, &repl_act);
+    }
+
     gu_mutex_destroy (&repl_act.wait_mutex);
     gu_cond_destroy  (&repl_act.wait_cond);
 
@@ -1795,6 +2040,88 @@ long gcs_replv (gcs_conn_t*          const conn,      //!<in
     return ret;
 }
 
+long gcs_repl_submitv_fd (gcs_conn_t*           const conn,
+                          const struct gu_buf*  const act_in,
+                          struct gcs_action*    const act,
+                          bool                  const scheduled,
+                          int                   const notify_fd,
+                          struct gcs_repl_act** const handle)
+{
+    assert (act);
+    assert (handle);
+
+    *handle = NULL;
+
+    if (gu_unlikely((size_t)act->size > GCS_MAX_ACT_SIZE)) return -EMSGSIZE;
+
+    assert (act->size > 0);
+
+    /* unlike in gcs_replv() the action cannot live on the caller's stack */
+    struct gcs_repl_act* const repl_act(new gcs_repl_act (act_in, act,
+                                                          notify_fd));
+
+    gu_mutex_init (&repl_act->wait_mutex, NULL);
+    gu_cond_init  (&repl_act->wait_cond,  NULL);
+
+    long const ret(_repl_submit (conn, repl_act, scheduled));
+
+    if (ret < 0) {
+        gu_mutex_destroy (&repl_act->wait_mutex);
+        gu_cond_destroy  (&repl_act->wait_cond);
+        delete repl_act;
+    }
+    else {
+        *handle = repl_act;
+    }
+
+    return ret;
+}
+
+long gcs_repl_submitv (gcs_conn_t*           const conn,
+                       const struct gu_buf*  const act_in,
+                       struct gcs_action*    const act,
+                       bool                  const scheduled,
+                       struct gcs_repl_act** const handle)
+{
+    return gcs_repl_submitv_fd (conn, act_in, act, scheduled, -1, handle);
+}
+
+long gcs_repl_wait (gcs_conn_t* const conn, struct gcs_repl_act* const handle)
+{
+    assert (handle);
+
+    long const ret(_repl_wait (conn, handle));
+
+    gu_mutex_destroy (&handle->wait_mutex);
+    gu_cond_destroy  (&handle->wait_cond);
+    delete handle;
+
+    return ret;
+}
+
+long gcs_repl_collect (gcs_conn_t* const conn, struct gcs_repl_act* const handle)
+{
+    assert (handle);
+
+    long ret;
+
+    if (!(ret = gu_mutex_lock (&handle->wait_mutex)))
+    {
+        bool const signaled(handle->signaled);
+        gu_mutex_unlock (&handle->wait_mutex);
+
+        if (!signaled) return -EAGAIN; /* handle remains valid */
+
+        ret = _repl_outcome (conn, handle);
+
+        gu_mutex_destroy (&handle->wait_mutex);
+        gu_cond_destroy  (&handle->wait_cond);
+        delete handle;
+    }
+
+    return ret;
+}
+
 long gcs_request_state_transfer (gcs_conn_t  *conn,
                                  int          version,
                                  const void  *req,
@@ -1912,6 +2239,17 @@ GCS_FIFO_POP_HEAD (gcs_conn_t* conn, ssize_t size)
     gu_fifo_pop_head (conn->recv_q);
 }
 
+/* NOTE: it is tempting to split recv_q into per-consumer queues sharded by
+ *       dependency to get the fifo mutex off the applier path. That cannot
+ *       be done here: write set dependencies are known only after
+ *       certification, which happens above this layer, so GCS has nothing
+ *       to shard by. Moreover, the single queue is what makes the
+ *       configuration change barrier work (gu_fifo_cancel_gets() stops all
+ *       consumers at the CONF action) and its lock doubles as the flow
+ *       control lock - see the gu_fifo_locked() asserts in gcs_conn_t
+ *       accessors. Consumers already run concurrently past this hand-off
+ *       point, ordered by the monitors in the replicator. */
+
 /* Returns when an action from another process is received */
 long gcs_recv (gcs_conn_t*        conn,
                struct gcs_action* action)
@@ -1924,6 +2262,7 @@ long gcs_recv (gcs_conn_t*        conn,
     if ((recv_act = (struct gcs_recv_act*)gu_fifo_get_head (conn->recv_q, &err)))
     {
         conn->queue_len = gu_fifo_length (conn->recv_q) - 1;
+        gcs_check_recv_q_watermark (conn);
         bool send_cont  = gcs_fc_cont_begin   (conn);
         bool send_sync  = gcs_send_sync_begin (conn);
 
@@ -1933,6 +2272,8 @@ long gcs_recv (gcs_conn_t*        conn,
         action->seqno_g = recv_act->rcvd.id;
         action->seqno_l = recv_act->local_id;
 
+        long long const queued_at(recv_act->queued_at);
+
         if (gu_unlikely (GCS_ACT_CONF == action->type)) {
             err = gu_fifo_cancel_gets (conn->recv_q);
             if (err) {
@@ -1945,6 +2286,11 @@ long gcs_recv (gcs_conn_t*        conn,
 
         GCS_FIFO_POP_HEAD (conn, action->size); // release the queue
 
+        /* time from group delivery to consumer pickup; read with the
+         * send-to-delivery histograms this tells whether replication
+         * lag sits in the appliers or below them */
+        if (queued_at) _hs_insert (conn, conn->hs_recvq_wait, queued_at);
+
         if (gu_unlikely(send_cont) && (err = gcs_fc_cont_end(conn))) {
             // We have successfully received an action, but failed to send
             // important control message. What do we do? Inability to send CONT
@@ -2103,8 +2449,12 @@ gcs_get_stats (gcs_conn_t* conn, struct gcs_stats* stats)
                       &stats->send_q_len_max,
                       &stats->send_q_len_min,
                       &stats->send_q_len_avg,
+                      &stats->send_q_wait_p99,
+                      &stats->send_q_wait_p999,
+                      &stats->send_q_entered,
                       &stats->fc_paused_ns,
-                      &stats->fc_paused_avg);
+                      &stats->fc_paused_avg,
+                      &stats->fc_paused_events);
 
     stats->fc_ssent    = conn->stats_fc_stop_sent;
     stats->fc_csent    = conn->stats_fc_cont_sent;
@@ -2124,6 +2474,13 @@ gcs_flush_stats(gcs_conn_t* conn)
     conn->stats_fc_stop_sent = 0;
     conn->stats_fc_cont_sent = 0;
     conn->stats_fc_received  = 0;
+
+    gu_mutex_lock  (&conn->hs_lock);
+    conn->hs_sm_wait->clear();
+    conn->hs_repl_tord->clear();
+    conn->hs_repl_streq->clear();
+    conn->hs_recvq_wait->clear();
+    gu_mutex_unlock(&conn->hs_lock);
 }
 
 extern void
@@ -2142,6 +2499,13 @@ void gcs_get_status(gcs_conn_t* conn, gu::Status& status)
 #ifdef GU_DBUG_ON
         GU_DBUG_SYNC_WAIT("gcs_get_status");
 #endif
+        gu_mutex_lock  (&conn->hs_lock);
+        status.insert("gcs_sm_wait_hs",    conn->hs_sm_wait->to_string());
+        status.insert("gcs_tord_deliv_hs", conn->hs_repl_tord->to_string());
+        status.insert("gcs_streq_deliv_hs",conn->hs_repl_streq->to_string());
+        status.insert("gcs_recvq_wait_hs", conn->hs_recvq_wait->to_string());
+        gu_mutex_unlock(&conn->hs_lock);
+
         gcs_core_get_status(conn->core, status);
     }
 }
@@ -2212,6 +2576,33 @@ _set_fc_factor (gcs_conn_t* conn, const char* value)
     }
 }
 
+static long
+_set_fc_settle_time (gcs_conn_t* conn, const char* value)
+{
+    double dbl;
+    const char* const endptr = gu_str2dbl (value, &dbl);
+
+    if (dbl >= 0.0 && *endptr == '\0') {
+
+        if (dbl == conn->params.fc_settle_time) return 0;
+
+        /* read by gcs_fc_stop_begin() under the slave queue lock */
+        gu_fifo_lock(conn->recv_q);
+        {
+            conn->params.fc_settle_time = dbl;
+            conn->fc_over_since         = 0;
+        }
+        gu_fifo_release (conn->recv_q);
+
+        gu_config_set_double (conn->config, GCS_PARAMS_FC_SETTLE_TIME, dbl);
+
+        return 0;
+    }
+    else {
+        return -EINVAL;
+    }
+}
+
 static long
 _set_fc_debug (gcs_conn_t* conn, const char* value)
 {
@@ -2347,6 +2738,53 @@ bool gcs_register_params (gu_config_t* const conf)
     return (gcs_params_register (conf) | gcs_core_register (conf));
 }
 
+static long
+_set_recv_q_watermark (gcs_conn_t* conn, const char* value)
+{
+    double mark;
+    const char* const endptr = gu_str2dbl(value, &mark);
+
+    if (mark >= 0.0 && mark <= 1.0 && *endptr == '\0') {
+
+        if (mark == conn->params.recv_q_watermark) return 0;
+
+        gu_fifo_lock(conn->recv_q);
+        {
+            if (!gu_mutex_lock (&conn->fc_lock)) {
+                conn->params.recv_q_watermark = mark;
+                _set_fc_limits (conn);
+                gu_config_set_double (conn->config,
+                                      GCS_PARAMS_RECV_Q_WATERMARK,
+                                      conn->params.recv_q_watermark);
+                gu_mutex_unlock (&conn->fc_lock);
+            }
+            else {
+                gu_fatal ("Failed to lock mutex.");
+                abort();
+            }
+        }
+        gu_fifo_release (conn->recv_q);
+
+        return 0;
+    }
+    else {
+        return -EINVAL;
+    }
+}
+
+void gcs_set_recv_q_watermark_cb (gcs_conn_t* const        conn,
+                                  gcs_watermark_cb_t const cb,
+                                  void* const              ctx)
+{
+    gu_fifo_lock(conn->recv_q);
+    {
+        conn->watermark_cb  = cb;
+        conn->watermark_ctx = ctx;
+        conn->q_over_mark   = false;
+    }
+    gu_fifo_release (conn->recv_q);
+}
+
 long gcs_param_set  (gcs_conn_t* conn, const char* key, const char *value)
 {
     if (!strcmp (key, GCS_PARAMS_FC_LIMIT)) {
@@ -2355,6 +2793,9 @@ long gcs_param_set  (gcs_conn_t* conn, const char* key, const char *value)
     else if (!strcmp (key, GCS_PARAMS_FC_FACTOR)) {
         return _set_fc_factor (conn, value);
     }
+    else if (!strcmp (key, GCS_PARAMS_FC_SETTLE_TIME)) {
+        return _set_fc_settle_time (conn, value);
+    }
     else if (!strcmp (key, GCS_PARAMS_FC_DEBUG)) {
         return _set_fc_debug (conn, value);
     }
@@ -2364,6 +2805,9 @@ long gcs_param_set  (gcs_conn_t* conn, const char* key, const char *value)
     else if (!strcmp (key, GCS_PARAMS_MAX_PKT_SIZE)) {
         return _set_pkt_size (conn, value);
     }
+    else if (!strcmp (key, GCS_PARAMS_RECV_Q_WATERMARK)) {
+        return _set_recv_q_watermark (conn, value);
+    }
     else if (!strcmp (key, GCS_PARAMS_RECV_Q_HARD_LIMIT)) {
         return _set_recv_q_hard_limit (conn, value);
     }
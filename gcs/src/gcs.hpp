@@ -230,6 +230,80 @@ static inline long gcs_repl (gcs_conn_t*        const conn,
     return gcs_replv (conn, &buf, action, scheduled);
 }
 
+/*! Opaque handle to an in-flight replication, see gcs_repl_submitv() */
+struct gcs_repl_act;
+
+/*! @brief Asynchronous version of gcs_replv(): submits the action to group
+ * and returns without waiting for delivery, so the caller can overlap the
+ * group round-trip with other work. On success a handle is returned through
+ * @a handle and must be passed to gcs_repl_wait() to collect the delivery
+ * outcome; action buffers and the action struct must stay intact until then.
+ * On failure no handle is allocated and gcs_repl_wait() must not be called.
+ *
+ * @param conn      group connection handle
+ * @param act_in    action buffer vector (total size is passed in action)
+ * @param action    action struct
+ * @param scheduled whether the call was preceded by gcs_schedule()
+ * @param handle    in-flight replication handle (out)
+ * @return          negative error code, action size in case of success
+ */
+extern long gcs_repl_submitv (gcs_conn_t*           conn,
+                              const struct gu_buf*  act_in,
+                              struct gcs_action*    action,
+                              bool                  scheduled,
+                              struct gcs_repl_act** handle);
+
+/*! @brief Blocks until the action submitted with gcs_repl_submitv() is
+ * delivered back by group and releases the handle. Upon return global and
+ * local IDs are set in the action struct passed to gcs_repl_submitv().
+ *
+ * @param conn   group connection handle
+ * @param handle in-flight replication handle
+ * @return       negative error code, action size in case of success
+ * @retval -EINTR: action was not replicated
+ */
+extern long gcs_repl_wait (gcs_conn_t*          conn,
+                           struct gcs_repl_act* handle);
+
+/*! @brief Like gcs_repl_submitv(), but with fd-based completion: on action
+ * delivery an 8-byte counter value is written to @a notify_fd (an eventfd,
+ * or the write end of a pipe), making it readable. This lets the layer
+ * above multiplex many in-flight replications from a small thread pool
+ * with poll/epoll instead of parking one thread per pending commit on the
+ * handle's condition variable. The same fd may serve any number of
+ * handles: after draining it the caller probes its pending handles with
+ * gcs_repl_collect(). gcs_repl_wait() remains valid on such handles.
+ * The fd is only written to, never closed, and must stay open until the
+ * handle is released.
+ *
+ * @param conn      group connection handle
+ * @param act_in    action buffer vector (total size is passed in action)
+ * @param action    action struct
+ * @param scheduled whether the call was preceded by gcs_schedule()
+ * @param notify_fd pollable handle to signal on delivery, or -1 for none
+ * @param handle    in-flight replication handle (out)
+ * @return          negative error code, action size in case of success
+ */
+extern long gcs_repl_submitv_fd (gcs_conn_t*           conn,
+                                 const struct gu_buf*  act_in,
+                                 struct gcs_action*    action,
+                                 bool                  scheduled,
+                                 int                   notify_fd,
+                                 struct gcs_repl_act** handle);
+
+/*! @brief Non-blocking counterpart of gcs_repl_wait(): collects the
+ * delivery outcome if the action has already been delivered and releases
+ * the handle; otherwise leaves the handle valid and returns -EAGAIN.
+ *
+ * @param conn   group connection handle
+ * @param handle in-flight replication handle
+ * @return       negative error code, action size in case of success
+ * @retval -EAGAIN: action not yet delivered, handle remains valid
+ * @retval -EINTR:  action was not replicated
+ */
+extern long gcs_repl_collect (gcs_conn_t*          conn,
+                              struct gcs_repl_act* handle);
+
 /*! @brief Receives an action from group.
  * Blocks if no actions are available. Action buffer is allocated by GCS
  * and must be freed by application when action is no longer needed.
@@ -369,6 +443,26 @@ gcs_param_set (gcs_conn_t* conn, const char* key, const char *value);
 extern const char*
 gcs_param_get (gcs_conn_t* conn, const char* key);
 
+/*! Slave queue watermark callback.
+ *
+ * Invoked when the receive queue length crosses the watermark derived
+ * from gcs.recv_q_watermark (rising above it or draining back below
+ * half of it), i.e. before flow control engages cluster-wide. Runs in
+ * the queue producer/consumer context, possibly under the queue lock:
+ * the callback must be cheap and must not call back into gcs.
+ *
+ * @param ctx   registration context
+ * @param q_len queue length at the crossing
+ * @param mark  the threshold that was crossed
+ * @param over  true when rising over the watermark, false on drain */
+typedef void (*gcs_watermark_cb_t) (void* ctx, long q_len, long mark,
+                                    bool over);
+
+/*! Registers the slave queue watermark callback (NULL unregisters). */
+extern void
+gcs_set_recv_q_watermark_cb (gcs_conn_t* conn, gcs_watermark_cb_t cb,
+                             void* ctx);
+
 /* Logging options */
 extern long gcs_conf_set_log_file     (FILE *file);
 extern long gcs_conf_set_log_callback (void (*logger) (int, const char*));
@@ -431,6 +525,10 @@ typedef struct gcs_backend_stats {
 struct gcs_stats
 {
     double    send_q_len_avg; //! average send queue length per send call
+    long long send_q_wait_p99;  //! p99 send queue wait, nanoseconds
+    long long send_q_wait_p999; //! p99.9 send queue wait, nanoseconds
+    long long send_q_entered; //! actions that entered the send monitor
+    long long fc_paused_events; //! flow control pause events
     double    recv_q_len_avg; //! average recv queue length per queued action
     long long fc_paused_ns;   //! total nanoseconds spent in paused state
     double    fc_paused_avg;  //! faction of time paused due to flow control
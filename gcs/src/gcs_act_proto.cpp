@@ -5,9 +5,10 @@
  */
 /*
  * Interface to action protocol
- * (to be extended to support protocol versions, currently supports only v0)
+ * (supports versions 0 and 1)
  */
 #include <errno.h>
+#include <string.h>
 #include "gcs_act_proto.hpp"
 
 /*
@@ -19,6 +20,15 @@ bytes: 00 01                07 08       11 12       15 16       19 20
       |PV|      act_id        |  act_size |  frag_no  |AT|reserved|  data...
       +--+--+--+--+--+--+--+--+--+--+--+--+--+--+--+--+--+--+--+--+--+--+---
 
+  Version 1 appends the sender's last applied seqno (commit cut report)
+  so that it travels with every replicated fragment instead of requiring
+  a separate service message:
+
+bytes: 00                  15 16       19 20                  27 28
+      +--+--     --+--+--+--+--+--+--+--+--+--+--+--+--+--+--+--+--+--+---
+      |  as version 0        |AT|reserved|     last_applied      |  data...
+      +--+--     --+--+--+--+--+--+--+--+--+--+--+--+--+--+--+--+--+--+---
+
 PV - protocol version
 AT - action type
 
@@ -27,6 +37,8 @@ AT - action type
 static const size_t PROTO_PV_OFFSET       = 0;
 static const size_t PROTO_AT_OFFSET       = 16;
 static const size_t PROTO_DATA_OFFSET     = 20;
+static const size_t PROTO_LA_OFFSET       = 20; // v1+, not 8-byte aligned!
+static const size_t PROTO_V1_DATA_OFFSET  = 28;
 // static const size_t PROTO_ACT_ID_OFFSET   = 0;
 // static const size_t PROTO_ACT_SIZE_OFFSET = 8;
 // static const size_t PROTO_FRAG_NO_OFFSET  = 12;
@@ -37,7 +49,7 @@ static const size_t PROTO_DATA_OFFSET     = 20;
 
 static const int PROTO_VERSION = GCS_ACT_PROTO_MAX;
 
-#define PROTO_MAX_HDR_SIZE PROTO_DATA_OFFSET // for now
+#define PROTO_MAX_HDR_SIZE PROTO_V1_DATA_OFFSET
 
 /*! Writes header data into actual header of the message.
  *  Remainig fragment buf and length is in frag->frag and frag->frag_len
@@ -58,7 +70,7 @@ gcs_act_proto_write (gcs_act_frag_t* frag, void* buf, size_t buf_len)
                   frag->act_type, PROTO_AT_MAX);
         return -EOVERFLOW;
     }
-    if (frag->proto_ver != PROTO_VERSION) return -EPROTO;
+    if (frag->proto_ver > PROTO_VERSION)  return -EPROTO;
     if (buf_len      < PROTO_DATA_OFFSET) return -EMSGSIZE;
 #endif
 
@@ -71,8 +83,17 @@ gcs_act_proto_write (gcs_act_frag_t* frag, void* buf, size_t buf_len)
     ((uint8_t *)buf)[PROTO_PV_OFFSET] = frag->proto_ver;
     ((uint8_t *)buf)[PROTO_AT_OFFSET] = frag->act_type;
 
-    frag->frag     = (uint8_t*)buf + PROTO_DATA_OFFSET;
-    frag->frag_len = buf_len - PROTO_DATA_OFFSET;
+    if (frag->proto_ver >= 1) {
+        /* PROTO_LA_OFFSET is not 8-byte aligned, hence memcpy */
+        uint64_t const la = gu_be64(frag->last_applied);
+        memcpy ((uint8_t*)buf + PROTO_LA_OFFSET, &la, sizeof(la));
+        frag->frag     = (uint8_t*)buf + PROTO_V1_DATA_OFFSET;
+        frag->frag_len = buf_len - PROTO_V1_DATA_OFFSET;
+    }
+    else {
+        frag->frag     = (uint8_t*)buf + PROTO_DATA_OFFSET;
+        frag->frag_len = buf_len - PROTO_DATA_OFFSET;
+    }
 
     return 0;
 }
@@ -104,8 +125,24 @@ gcs_act_proto_read (gcs_act_frag_t* frag, const void* buf, size_t buf_len)
     frag->frag_no  = gtohl  (((uint32_t*)buf)[3]);
     frag->act_type = static_cast<gcs_act_type_t>(
         ((uint8_t*)buf)[PROTO_AT_OFFSET]);
-    frag->frag     = ((uint8_t*)buf) + PROTO_DATA_OFFSET;
-    frag->frag_len = buf_len - PROTO_DATA_OFFSET;
+
+    if (frag->proto_ver >= 1) {
+        uint64_t la;
+        if (gu_unlikely(buf_len < PROTO_V1_DATA_OFFSET)) {
+            gu_error ("Action message too short: %zu, expected at least %zu",
+                      buf_len, PROTO_V1_DATA_OFFSET);
+            return -EBADMSG;
+        }
+        memcpy (&la, (const uint8_t*)buf + PROTO_LA_OFFSET, sizeof(la));
+        frag->last_applied = gu_be64(la);
+        frag->frag     = ((uint8_t*)buf) + PROTO_V1_DATA_OFFSET;
+        frag->frag_len = buf_len - PROTO_V1_DATA_OFFSET;
+    }
+    else {
+        frag->last_applied = GCS_SEQNO_ILL; // not carried before v1
+        frag->frag     = ((uint8_t*)buf) + PROTO_DATA_OFFSET;
+        frag->frag_len = buf_len - PROTO_DATA_OFFSET;
+    }
 
     /* return 0 or -EMSGSIZE */
     return ((frag->act_size > GCS_MAX_ACT_SIZE) * -EMSGSIZE);
@@ -119,6 +156,6 @@ gcs_act_proto_hdr_size (long version)
 
     if (gu_unlikely(version < 0)) return PROTO_MAX_HDR_SIZE; // safe
 
-    return PROTO_DATA_OFFSET;
+    return version >= 1 ? PROTO_V1_DATA_OFFSET : PROTO_DATA_OFFSET;
 }
 
@@ -5,7 +5,7 @@
  */
 /*
  * Interface to action protocol
- * (to be extended to support protocol versions, currently supports only v0)
+ * (supports versions 0 and 1)
  */
 
 #ifndef _gcs_act_proto_h_
@@ -17,13 +17,25 @@
 #include <stdint.h>
 typedef uint8_t gcs_proto_t;
 
-/*! Supported protocol range (for now only version 0 is supported) */
-#define GCS_ACT_PROTO_MAX 0
+/*! Supported protocol range (v1 piggybacks sender's last applied seqno
+ *  on the fragment header) */
+#define GCS_ACT_PROTO_MAX 1
+
+/* NOTE: the fragment header is where a channel id would go if gcs were
+ *       ever to multiplex several independently ordered streams over one
+ *       membership. That would not be a header-only change though: a
+ *       single total order is assumed everywhere a global seqno is
+ *       assigned or consumed - group act_id_ assignment, commit cut
+ *       accounting, certification and the single seqno space of the
+ *       wsrep API above. Until all of those are keyed by channel, all
+ *       actions share one delivery queue by design. */
 
 /*! Internal action fragment data representation */
 typedef struct gcs_act_frag
 {
     gcs_seqno_t    act_id;
+    gcs_seqno_t    last_applied; // piggybacked commit cut report (v1+),
+                                 // GCS_SEQNO_ILL if not carried
     size_t         act_size;
     const void*    frag;     // shall override it only once
     size_t         frag_len;
@@ -73,6 +73,38 @@ long fn (gcs_backend_t* const backend,    \
          size_t         const len,        \
          gcs_msg_type_t const msg_type)
 
+/*!
+ * Send a message gathered from several buffers (optional).
+ *
+ * Semantics are those of the send function above, but the message is
+ * described by an array of buffers instead of one contiguous copy, so
+ * a caller that has the payload scattered (e.g. an action fragment
+ * spanning writeset buffers) does not have to stage it first. A
+ * backend that cannot do gather sends leaves the send_v slot NULL and
+ * the caller falls back to the plain send function.
+ *
+ * @param backend
+ *        a pointer to the backend handle
+ * @param bufs
+ *        array of buffers making up the message, in order
+ * @param n_bufs
+ *        number of elements in bufs
+ * @param len
+ *        total length of the message (sum of buffer sizes)
+ * @param msg_type
+ *        type of the message
+ * @return
+ *        negative error code in case of error
+ *        OR
+ *        amount of bytes sent
+ */
+#define GCS_BACKEND_SEND_V_FN(fn)              \
+long fn (gcs_backend_t*       const backend,   \
+         const struct gu_buf* const bufs,      \
+         long                 const n_bufs,    \
+         size_t               const len,       \
+         gcs_msg_type_t       const msg_type)
+
 /*!
  * Receive a message from the backend.
  *
@@ -167,6 +199,7 @@ typedef GCS_BACKEND_DESTROY_FN   ((*gcs_backend_destroy_t));
 typedef GCS_BACKEND_OPEN_FN      ((*gcs_backend_open_t));
 typedef GCS_BACKEND_CLOSE_FN     ((*gcs_backend_close_t));
 typedef GCS_BACKEND_SEND_FN      ((*gcs_backend_send_t));
+typedef GCS_BACKEND_SEND_V_FN    ((*gcs_backend_send_v_t));
 typedef GCS_BACKEND_RECV_FN      ((*gcs_backend_recv_t));
 typedef GCS_BACKEND_NAME_FN      ((*gcs_backend_name_t));
 typedef GCS_BACKEND_MSG_SIZE_FN  ((*gcs_backend_msg_size_t));
@@ -181,6 +214,7 @@ struct gcs_backend
     gcs_backend_close_t     close;
     gcs_backend_destroy_t   destroy;
     gcs_backend_send_t      send;
+    gcs_backend_send_v_t    send_v; // optional, NULL if unsupported
     gcs_backend_recv_t      recv;
     gcs_backend_name_t      name;
     gcs_backend_msg_size_t  msg_size;
@@ -66,12 +66,33 @@ struct gcs_core
     size_t          send_buf_len;
     gcs_seqno_t     send_act_no;
 
+    /* last applied seqno as reported by the app, stamped into outgoing
+     * action headers at proto v1+. Written by the applier/status path
+     * (gcs_core_set_last_applied()) and read by gcs_core_send() before
+     * it takes send_lock - different threads, so accessed with
+     * gu_atomic_set()/gu_atomic_get() like last_delivered_ below */
+    gcs_seqno_t     last_applied_;
+
     /* recv part */
     gcs_recv_msg_t  recv_msg;
 
+    /* commit cut advanced by a value piggybacked on an action fragment,
+     * to be delivered on the next gcs_core_recv() call (recv thread only,
+     * see core_handle_act_msg()) */
+    gcs_seqno_t     pending_cut_;
+
+    /* last delivered total order seqno, maintained by the recv thread and
+     * read with gu_atomic_get() - a lock-free monitoring watermark that
+     * does not contend with the send path (see gcs_core_last_delivered()) */
+    gcs_seqno_t     last_delivered_;
+
     /* local action FIFO */
     gcs_fifo_lite_t* fifo;
 
+    /* cache copies of local action payloads retained at send time,
+     * see the local delivery fast path in gcs_core_send() */
+    gcs_fifo_lite_t* prefill;
+
     /* group context */
     gcs_group_t     group;
 
@@ -94,6 +115,14 @@ typedef struct core_act
 }
 core_act_t;
 
+// cache copy of a local action payload retained at send time
+typedef struct prefill_act
+{
+    gcs_seqno_t sent_act_id;
+    void*       buf;
+}
+prefill_act_t;
+
 typedef struct causal_act
 {
     gcs_seqno_t* act_id;
@@ -101,7 +130,10 @@ typedef struct causal_act
     gu_cond_t*   cond;
 } causal_act_t;
 
-static int const GCS_PROTO_MAX = 0;
+/* v1: last applied seqno piggybacked on action fragment headers.
+ * The version actually used is the lowest one advertised by the group
+ * members (see gcs_state_msg_get_quorum()), so mixed clusters keep v0. */
+static int const GCS_PROTO_MAX = 1;
 
 gcs_core_t*
 gcs_core_create (gu_config_t* const conf,
@@ -134,18 +166,27 @@ gcs_core_create (gu_config_t* const conf,
                 core->fifo = gcs_fifo_lite_create (CORE_FIFO_LEN,
                                                    sizeof (core_act_t));
                 if (core->fifo) {
-                    gu_mutex_init  (&core->send_lock, NULL);
-                    core->proto_ver = -1; // shall be bumped in gcs_group_act_conf()
-                    gcs_group_init (&core->group, cache, node_name, inc_addr,
-                                    GCS_PROTO_MAX, repl_proto_ver,
-                                    appl_proto_ver);
-                    core->state = CORE_CLOSED;
-                    core->send_act_no = 1; // 0 == no actions sent
+                    core->prefill = gcs_fifo_lite_create(CORE_FIFO_LEN,
+                                                         sizeof(prefill_act_t));
+                    if (core->prefill) {
+                        gu_mutex_init  (&core->send_lock, NULL);
+                        core->proto_ver = -1; // shall be bumped in gcs_group_act_conf()
+                        gcs_group_init (&core->group, cache, node_name,
+                                        inc_addr, GCS_PROTO_MAX,
+                                        repl_proto_ver, appl_proto_ver);
+                        core->state = CORE_CLOSED;
+                        core->send_act_no = 1; // 0 == no actions sent
+                        core->last_applied_   = GCS_SEQNO_ILL;
+                        core->last_delivered_ = GCS_SEQNO_ILL;
+                        core->pending_cut_    = 0;
 #ifdef GCS_CORE_TESTING
-                    gu_lock_step_init (&core->ls);
-                    core->state_uuid = GU_UUID_NIL;
+                        gu_lock_step_init (&core->ls);
+                        core->state_uuid = GU_UUID_NIL;
 #endif
-                    return core; // success
+                        return core; // success
+                    }
+
+                    gcs_fifo_lite_destroy (core->fifo);
                 }
 
                 gu_free (core->send_buf);
@@ -164,6 +205,7 @@ long
 gcs_core_init (gcs_core_t* core, gcs_seqno_t seqno, const gu_uuid_t* uuid)
 {
     if (core->state == CORE_CLOSED) {
+        gu_atomic_set (&core->last_delivered_, &seqno);
         return gcs_group_init_history (&core->group, seqno, uuid);
     }
     else {
@@ -201,6 +243,7 @@ gcs_core_open (gcs_core_t* core,
 
         if (!(ret = core->backend.open (&core->backend, channel, bstrap))) {
             gcs_fifo_lite_open (core->fifo);
+            gcs_fifo_lite_open (core->prefill);
             core->state = CORE_NON_PRIMARY;
         }
         else {
@@ -299,6 +342,70 @@ core_msg_send_retry (gcs_core_t*    core,
     return ret;
 }
 
+/* Max number of buffers a message passed to the backend may span: one for
+ * the fragment header plus the payload pieces. A fragment crossing more
+ * writeset buffers than that falls back to staging a contiguous copy. */
+#define CORE_MSG_IOV_MAX 16
+
+/*!
+ * Vectored counterpart of core_msg_send(): same checks and locking, but
+ * the message is described by an array of buffers so that a backend with
+ * gather support (backend.send_v != NULL) picks the payload up in place.
+ */
+static inline ssize_t
+core_msg_send_v (gcs_core_t*          core,
+                 const struct gu_buf* bufs,
+                 long                 n_bufs,
+                 size_t               msg_len,
+                 gcs_msg_type_t       msg_type)
+{
+    ssize_t ret;
+
+    if (gu_unlikely(0 != gu_mutex_lock (&core->send_lock))) abort();
+    {
+        if (gu_likely((CORE_PRIMARY  == core->state) ||
+                      (CORE_EXCHANGE == core->state && GCS_MSG_STATE_MSG ==
+                       msg_type))) {
+
+            ret = core->backend.send_v (&core->backend, bufs, n_bufs,
+                                        msg_len, msg_type);
+        }
+        else {
+            ret = core_error (core->state);
+
+            if (ret >= 0) {
+                gu_fatal ("GCS internal state inconsistency: "
+                          "expected error condition.");
+                abort(); // ret = -ENOTRECOVERABLE;
+            }
+        }
+    }
+    gu_mutex_unlock (&core->send_lock);
+
+    return ret;
+}
+
+/*!
+ * Repeats attempt at sending the message if -EAGAIN was returned
+ * by core_msg_send_v()
+ */
+static inline ssize_t
+core_msg_send_v_retry (gcs_core_t*          core,
+                       const struct gu_buf* bufs,
+                       long                 n_bufs,
+                       size_t               msg_len,
+                       gcs_msg_type_t       type)
+{
+    ssize_t ret;
+    while ((ret = core_msg_send_v (core, bufs, n_bufs, msg_len, type))
+           == -EAGAIN) {
+        /* wait for primary configuration - sleep 0.01 sec */
+        gu_debug ("Backend requested wait");
+        usleep (10000);
+    }
+    return ret;
+}
+
 ssize_t
 gcs_core_send (gcs_core_t*          const conn,
                const struct gu_buf* const action,
@@ -321,14 +428,24 @@ gcs_core_send (gcs_core_t*          const conn,
      * Action header will be replicated with every message.
      * It may seem like an extra overhead, but it is tiny
      * so far and simplifies A LOT.
+     *
+     * Coalescing several small actions into one backend message here
+     * would change this one-action-per-message framing, which every node
+     * in the group parses at the current protocol version - i.e. a wire
+     * format change. It is also unnecessary: gcomm aggregates pending
+     * small user messages into a single datagram below this layer
+     * (evs.use_aggregate, on by default), which is where the send queue
+     * actually builds up and where per-message EVS bookkeeping is paid.
      */
 
     /* Initialize action constants */
-    frg.act_size  = act_size;
-    frg.act_type  = act_type;
-    frg.act_id    = conn->send_act_no; /* incremented for every new action */
-    frg.frag_no   = 0;
-    frg.proto_ver = proto_ver;
+    frg.act_size     = act_size;
+    frg.act_type     = act_type;
+    frg.act_id       = conn->send_act_no; /* incremented for every new action */
+    frg.frag_no      = 0;
+    frg.proto_ver    = proto_ver;
+    /* piggybacked at proto v1+; set from another thread, see struct comment */
+    gu_atomic_get (&conn->last_applied_, &frg.last_applied);
 
     if ((ret = gcs_act_proto_write (&frg, conn->send_buf, conn->send_buf_len)))
         return ret;
@@ -343,6 +460,44 @@ gcs_core_send (gcs_core_t*          const conn,
         return ret;
     }
 
+#ifndef GCS_FOR_GARB
+    /* Local delivery fast path: retain a cache copy of the payload now, so
+     * that when the action loops back with its ordering decision the recv
+     * thread only parses fragment headers instead of re-assembling the
+     * payload (see prefill handling in gcs_defrag). Any failure here just
+     * means falling back to copying from the wire. */
+    bool prefilled = false;
+
+    if (GCS_ACT_TORDERED == act_type) {
+        uint8_t* const copy(
+            (uint8_t*)gcs_gcache_malloc (conn->cache, act_size));
+
+        if (gu_likely(copy != NULL)) {
+            size_t off  = 0;
+            int    part = 0;
+
+            while (off < act_size) {
+                memcpy (copy + off, action[part].ptr, action[part].size);
+                off += action[part].size;
+                part++;
+            }
+            assert (off == act_size);
+
+            prefill_act_t* pa;
+
+            if (gcs_fifo_lite_not_full (conn->prefill) &&
+                (pa = (prefill_act_t*)gcs_fifo_lite_get_tail(conn->prefill))) {
+                *pa = (prefill_act_t){ conn->send_act_no, copy };
+                gcs_fifo_lite_push_tail (conn->prefill);
+                prefilled = true;
+            }
+            else {
+                gcs_gcache_free (conn->cache, copy);
+            }
+        }
+    }
+#endif /* !GCS_FOR_GARB */
+
     int            idx  = 0;
     const uint8_t* ptr  = (const uint8_t*)action[idx].ptr;
     size_t         left = action[idx].size;
@@ -351,24 +506,74 @@ gcs_core_send (gcs_core_t*          const conn,
         const size_t chunk_size =
             act_size < frg.frag_len ? act_size : frg.frag_len;
 
-        /* Here is the only time we have to cast frg.frag */
-        char* dst = (char*)frg.frag;
-        size_t to_copy = chunk_size;
+        struct gu_buf iov[CORE_MSG_IOV_MAX];
+        long          iov_len = 0;
+
+        if (conn->backend.send_v) {
+            /* Describe the fragment in place: header from send_buf plus a
+             * send vector over the source buffers, no payload staging.
+             * Committed only if the whole chunk fits in the vector. */
+            const uint8_t* p    = ptr;
+            size_t         l    = left;
+            int            ix   = idx;
+            size_t         todo = chunk_size;
+
+            iov[0].ptr  = conn->send_buf;
+            iov[0].size = hdr_size;
+            iov_len     = 1;
+
+            while (todo > 0 && iov_len < CORE_MSG_IOV_MAX) {
+                if (todo < l) {
+                    iov[iov_len].ptr  = p;
+                    iov[iov_len].size = todo;
+                    iov_len++;
+                    p   += todo;
+                    l   -= todo;
+                    todo = 0;
+                }
+                else {
+                    iov[iov_len].ptr  = p;
+                    iov[iov_len].size = l;
+                    iov_len++;
+                    todo -= l;
+                    ix++;
+                    p = (const uint8_t*)action[ix].ptr;
+                    l = action[ix].size;
+                }
+            }
 
-        while (to_copy > 0) {        // gather action bufs into one
-            if (to_copy < left) {
-                memcpy (dst, ptr, to_copy);
-                ptr     += to_copy;
-                left    -= to_copy;
-                to_copy = 0;
+            if (gu_likely(0 == todo)) {
+                /* cursors advance exactly as the copy loop below would */
+                ptr  = p;
+                left = l;
+                idx  = ix;
             }
             else {
-                memcpy (dst, ptr, left);
-                dst     += left;
-                to_copy -= left;
-                idx++;
-                ptr  = (const uint8_t*)action[idx].ptr;
-                left = action[idx].size;
+                /* chunk too scattered for one vector - stage a copy */
+                iov_len = 0;
+            }
+        }
+
+        if (0 == iov_len) {
+            /* Here is the only time we have to cast frg.frag */
+            char* dst = (char*)frg.frag;
+            size_t to_copy = chunk_size;
+
+            while (to_copy > 0) {    // gather action bufs into one
+                if (to_copy < left) {
+                    memcpy (dst, ptr, to_copy);
+                    ptr     += to_copy;
+                    left    -= to_copy;
+                    to_copy = 0;
+                }
+                else {
+                    memcpy (dst, ptr, left);
+                    dst     += left;
+                    to_copy -= left;
+                    idx++;
+                    ptr  = (const uint8_t*)action[idx].ptr;
+                    left = action[idx].size;
+                }
             }
         }
 
@@ -379,8 +584,14 @@ gcs_core_send (gcs_core_t*          const conn,
         gu_info ("Sent %p of size %zu. Total sent: %zu, left: %zu",
                  (char*)conn->send_buf + hdr_size, chunk_size, sent, act_size);
 #endif
-        ret = core_msg_send_retry (conn, conn->send_buf, send_size,
-                                   GCS_MSG_ACTION);
+        if (iov_len > 0) {
+            ret = core_msg_send_v_retry (conn, iov, iov_len, send_size,
+                                         GCS_MSG_ACTION);
+        }
+        else {
+            ret = core_msg_send_retry (conn, conn->send_buf, send_size,
+                                       GCS_MSG_ACTION);
+        }
         GU_DBUG_SYNC_WAIT("gcs_core_after_frag_send");
 #ifdef GCS_CORE_TESTING
 //        gu_lock_step_wait (&conn->ls); // pause after every fragment
@@ -436,6 +647,20 @@ gcs_core_send (gcs_core_t*          const conn,
              * 1. Action will never be received completely by this node. Hence
              *    action must be removed from fifo on behalf of sending thr.: */
             gcs_fifo_lite_remove (conn->fifo);
+#ifndef GCS_FOR_GARB
+            /* ... along with the payload copy retained above, unless the
+             * recv thread already consumed it on the action's first
+             * fragment (entries are pushed and popped in send order, so a
+             * non-empty FIFO means its tail entry is ours) */
+            if (prefilled) {
+                prefill_act_t pa;
+
+                if (gcs_fifo_lite_remove_get (conn->prefill, &pa)) {
+                    assert (pa.sent_act_id == conn->send_act_no);
+                    gcs_gcache_free (conn->cache, pa.buf);
+                }
+            }
+#endif /* !GCS_FOR_GARB */
             /* 2. Members will have to discard received fragments.
              * Two reasons could lead us here: new member(s) in configuration
              * change or broken connection (leave group). In both cases other
@@ -499,6 +724,44 @@ core_msg_recv (gcs_backend_t* backend, gcs_recv_msg_t* recv_msg,
     return ret;
 }
 
+#ifndef GCS_FOR_GARB
+/*!
+ * Helper for core_handle_act_msg(). On the first fragment of a local
+ * action looks up the payload copy retained by gcs_core_send() and hands
+ * it over to the node's defrag context. Entries are pushed and consumed
+ * in send order, so anything older than the current action belongs to an
+ * action that will never loop back (send error, configuration change)
+ * and is dropped here.
+ */
+static void
+core_prefill_take (gcs_core_t*           const core,
+                   const gcs_act_frag_t* const frg,
+                   gcs_defrag_t*         const df)
+{
+    prefill_act_t* pa;
+
+    while ((pa = (prefill_act_t*)gcs_fifo_lite_get_head (core->prefill))) {
+
+        if (pa->sent_act_id > frg->act_id) { // entry for a future action
+            gcs_fifo_lite_release (core->prefill);
+            break;
+        }
+
+        void*       const buf(pa->buf);
+        gcs_seqno_t const id (pa->sent_act_id);
+
+        gcs_fifo_lite_pop_head (core->prefill);
+
+        if (id == frg->act_id) {
+            gcs_defrag_set_prefill (df, buf);
+            break;
+        }
+
+        gcs_gcache_free (core->cache, buf); // stale entry
+    }
+}
+#endif /* !GCS_FOR_GARB */
+
 /*!
  * Helper for gcs_core_recv(). Handles GCS_MSG_ACTION.
  *
@@ -544,6 +807,26 @@ core_handle_act_msg (gcs_core_t*          core,
             return -ENOTRECOVERABLE;
         }
 
+        if (frg.last_applied > 0 && gcs_group_is_primary(group)) {
+            /* proto v1+: last applied value piggybacked on the fragment
+             * header. It arrives in total order like GCS_MSG_LAST, so all
+             * nodes advance the commit cut identically. Delivery of the
+             * new cut to the app is deferred until the current action is
+             * handed over (see gcs_core_recv()). */
+            gcs_seqno_t const cut
+                (gcs_group_handle_act_last (group, msg->sender_idx,
+                                            frg.last_applied));
+
+            if (gu_unlikely(cut > 0)) core->pending_cut_ = cut;
+        }
+
+#ifndef GCS_FOR_GARB
+        if (my_msg && 0 == frg.frag_no && GCS_ACT_SERVICE != frg.act_type) {
+            core_prefill_take (core, &frg,
+                               &group->nodes[msg->sender_idx].app);
+        }
+#endif /* !GCS_FOR_GARB */
+
         ret = gcs_group_handle_act_msg (group, &frg, msg, act,
                                         commonly_supported_version);
 
@@ -660,6 +943,28 @@ core_handle_act_msg (gcs_core_t*          core,
     return ret;
 }
 
+/*!
+ * Packages a new commit cut value as a GCS_ACT_COMMIT_CUT action.
+ *
+ * @return action size or -ENOMEM.
+ */
+static ssize_t
+core_commit_cut_act (gcs_seqno_t commit_cut, struct gcs_act* act)
+{
+    if ((act->buf = malloc (sizeof (commit_cut)))) {
+        act->type                 = GCS_ACT_COMMIT_CUT;
+        /* #701 - everything that goes into the action buffer
+         *        is expected to be serialized. */
+        *((gcs_seqno_t*)act->buf) = gcs_seqno_htog(commit_cut);
+        act->buf_len              = sizeof(commit_cut);
+        return act->buf_len;
+    }
+    else {
+        gu_fatal ("Out of memory for GCS_ACT_COMMIT_CUT");
+        return -ENOMEM;
+    }
+}
+
 /*!
  * Helper for gcs_core_recv(). Handles GCS_MSG_LAST.
  *
@@ -677,18 +982,7 @@ core_handle_last_msg (gcs_core_t*          core,
             gcs_group_handle_last_msg (&core->group, msg);
         if (commit_cut) {
             /* commit cut changed */
-            if ((act->buf = malloc (sizeof (commit_cut)))) {
-                act->type                 = GCS_ACT_COMMIT_CUT;
-                /* #701 - everything that goes into the action buffer
-                 *        is expected to be serialized. */
-                *((gcs_seqno_t*)act->buf) = gcs_seqno_htog(commit_cut);
-                act->buf_len              = sizeof(commit_cut);
-                return act->buf_len;
-            }
-            else {
-                gu_fatal ("Out of memory for GCS_ACT_COMMIT_CUT");
-                return -ENOMEM;
-            }
+            return core_commit_cut_act (commit_cut, act);
         }
     }
     else { /* Non-primary - ignore last message */
@@ -787,6 +1081,7 @@ core_handle_comp_msg (gcs_core_t*          core,
 
             if (gcs_group_my_idx(group) == -1) { // self-leave
                 gcs_fifo_lite_close (core->fifo);
+                gcs_fifo_lite_close (core->prefill);
                 core->state = CORE_CLOSED;
                 if (gcs_comp_msg_error((const gcs_comp_msg_t*)msg->buf)) {
                     ret = -gcs_comp_msg_error(
@@ -1071,6 +1366,15 @@ ssize_t gcs_core_recv (gcs_core_t*          conn,
         assert (recv_act->id          == GCS_SEQNO_ILL);
         assert (recv_act->sender_idx  == -1);
 
+        /* commit cut advanced by a value piggybacked on an action fragment
+         * (see core_handle_act_msg()) - deliver it before the next message */
+        if (gu_unlikely(conn->pending_cut_ > 0)) {
+            gcs_seqno_t const cut(conn->pending_cut_);
+            conn->pending_cut_ = 0;
+            ret = core_commit_cut_act (cut, &recv_act->act);
+            continue; /* non-zero ret terminates the loop */
+        }
+
         ret = core_msg_recv (&conn->backend, recv_msg, timeout);
         if (gu_unlikely (ret <= 0)) {
             goto out; /* backend error while receiving message */
@@ -1135,6 +1439,11 @@ out:
 
 //    gu_debug ("Returning %d", ret);
 
+    if (ret > 0 && GCS_ACT_TORDERED == recv_act->act.type &&
+        recv_act->id > 0) {
+        gu_atomic_set (&conn->last_delivered_, &recv_act->id);
+    }
+
     if (ret < 0) {
         assert (recv_act->id < 0);
 
@@ -1204,6 +1513,15 @@ long gcs_core_destroy (gcs_core_t* core)
         gcs_fifo_lite_pop_head (core->fifo);
     }
     gcs_fifo_lite_destroy (core->fifo);
+
+    prefill_act_t* pa;
+    while ((pa = (prefill_act_t*)gcs_fifo_lite_get_head (core->prefill))) {
+        // unconsumed payload copies are ours to free
+        void* const buf(pa->buf);
+        gcs_fifo_lite_pop_head (core->prefill);
+        gcs_gcache_free (core->cache, buf);
+    }
+    gcs_fifo_lite_destroy (core->prefill);
     gcs_group_free (&core->group);
 
     /* free buffers */
@@ -1299,6 +1617,12 @@ core_send_seqno (gcs_core_t* core, gcs_seqno_t seqno, gcs_msg_type_t msg_type)
 long
 gcs_core_set_last_applied (gcs_core_t* core, gcs_seqno_t seqno)
 {
+    /* cache the value for piggybacking on outgoing action headers (proto
+     * v1+). The explicit message is still sent: it is what propagates the
+     * value when this node does not replicate (e.g. an idle or apply-only
+     * node) and on older group protocol versions. */
+    gu_atomic_set (&core->last_applied_, &seqno);
+
     return core_send_seqno (core, seqno, GCS_MSG_LAST);
 }
 
@@ -1325,6 +1649,18 @@ gcs_core_send_fc (gcs_core_t* core, const void* fc, size_t fc_size)
     return ret;
 }
 
+/* NOTE: the round-trip here is not an implementation convenience, it is
+ *       the correctness argument. Self-delivery of a probe sent after the
+ *       causal read began proves that every action totally ordered before
+ *       the read has been received locally. A watermark cached from
+ *       previously delivered messages can never provide that proof: a
+ *       node that is behind sees a perfectly consistent prefix and has no
+ *       way to tell from its own deliveries that writes committed
+ *       elsewhere are still in flight to it - the stale node is precisely
+ *       the case a local cache cannot detect. Concurrent callers already
+ *       overlap: each sends its own tiny probe (send is serialized, the
+ *       waits are not), so back-to-back causal reads pay roughly one
+ *       round-trip each in parallel, not in series. */
 gcs_seqno_t
 gcs_core_caused(gcs_core_t* core)
 {
@@ -1357,6 +1693,19 @@ gcs_core_caused(gcs_core_t* core)
     return act_id;
 }
 
+/* NOTE: this is a monitoring watermark, not a causality proof - a reader
+ *       that needs to know it has seen everything ordered before some
+ *       point in time must use gcs_core_caused() (see the comment there).
+ *       The value is read atomically, so polling it does not touch
+ *       send_lock and cannot stall the send path. */
+gcs_seqno_t
+gcs_core_last_delivered (gcs_core_t* core)
+{
+    gcs_seqno_t ret;
+    gu_atomic_get (&core->last_delivered_, &ret);
+    return ret;
+}
+
 long
 gcs_core_param_set (gcs_core_t* core, const char* key, const char* value)
 {
@@ -1396,6 +1745,12 @@ gcs_core_fetch_pfs_info(
 
 void gcs_core_get_status(gcs_core_t* core, gu::Status& status)
 {
+    /* seqno bookkeeping is published atomically and is reported before
+     * taking send_lock, so that part of the poll never contends with
+     * the send path */
+    status.insert("gcs_last_delivered",
+                  gu::to_string(gcs_core_last_delivered(core)));
+
     if (gu_mutex_lock(&core->send_lock))
         gu_throw_fatal << "could not lock mutex";
     if (core->state < CORE_CLOSED)
@@ -157,6 +157,11 @@ gcs_core_send_fc (gcs_core_t* core, const void* fc, size_t fc_size);
 extern gcs_seqno_t
 gcs_core_caused(gcs_core_t* core);
 
+/* last delivered total order seqno, lock-free atomic read (monitoring
+ * watermark only - does not prove causality like gcs_core_caused()) */
+extern gcs_seqno_t
+gcs_core_last_delivered (gcs_core_t* core);
+
 extern long
 gcs_core_param_set (gcs_core_t* core, const char* key, const char* value);
 
@@ -12,7 +12,17 @@
 
 #define DF_ALLOC()                                              \
     do {                                                        \
-        df->head = static_cast<uint8_t*>(gcs_gcache_malloc (df->cache, df->size)); \
+        if (gu_unlikely(df->prefill != NULL)) {                 \
+            /* local action, payload was copied to cache at     \
+             * send time - use it and skip fragment copying */  \
+            df->head      = df->prefill;                        \
+            df->prefill   = NULL;                               \
+            df->prefilled = true;                               \
+        }                                                       \
+        else {                                                  \
+            df->prefilled = false;                              \
+            df->head = static_cast<uint8_t*>(gcs_gcache_malloc (df->cache, df->size)); \
+        }                                                       \
                                                                 \
         if(gu_likely(df->head != NULL))                         \
             df->tail = df->head;                                \
@@ -38,6 +48,19 @@
  * TODO: this function is too long, figure out a way to factor it into several
  *       smaller ones. Note that it is called for every GCS_MSG_ACTION message
  *       so it should be optimal.
+ *
+ * NOTE: the destination gcache buffer is already reserved in full on the
+ *       first fragment (DF_ALLOC), so each fragment is copied exactly once,
+ *       straight to its final offset - there is no extra reassembly copy
+ *       when the action completes. The one remaining copy is out of the
+ *       backend's message buffer, and getting rid of it would require the
+ *       transport to parse fragment headers and receive payloads into
+ *       caller-provided memory, which cuts across the gcomm/gcs boundary
+ *       (gcomm bundles and checksums datagrams in its own buffers).
+ *       For locally originated actions even that copy is skipped: the
+ *       sender retains a cache copy of the payload at send time (see
+ *       gcs_core_send()) and hands it over via gcs_defrag_set_prefill(),
+ *       so only the fragment headers are looked at here.
  */
 ssize_t
 gcs_defrag_handle_frag (gcs_defrag_t*         df,
@@ -65,8 +88,9 @@ gcs_defrag_handle_frag (gcs_defrag_t*         df,
                 df->tail     = df->head;
                 df->reset    = false;
 
-                if (df->size != frg->act_size) {
-
+                if (df->size != frg->act_size || NULL != df->prefill) {
+                    /* need a new buffer: either the size changed or the
+                     * resend retained a fresh payload copy (prefill) */
                     df->size = frg->act_size;
 
 #ifndef GCS_FOR_GARB
@@ -145,7 +169,13 @@ gcs_defrag_handle_frag (gcs_defrag_t*         df,
 
 #ifndef GCS_FOR_GARB
     assert (df->tail);
-    memcpy (df->tail, frg->frag, frg->frag_len);
+    if (gu_likely(!df->prefilled)) {
+        memcpy (df->tail, frg->frag, frg->frag_len);
+    }
+    else {
+        /* the copy retained at send time must match the wire payload */
+        assert (0 == memcmp (df->tail, frg->frag, frg->frag_len));
+    }
     df->tail += frg->frag_len;
 #else
     /* we skip memcpy since have not allocated any buffer */
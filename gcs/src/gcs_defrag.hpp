@@ -25,10 +25,13 @@ typedef struct gcs_defrag
     gcs_seqno_t    sent_id; // sent id (unique for a node)
     uint8_t*       head;    // head of action buffer
     uint8_t*       tail;    // tail of action data
+    uint8_t*       prefill; // cache copy of a local action made at send time
     size_t         size;
     size_t         received;
     ulong          frag_no; // number of fragment received
     bool           reset;
+    bool           prefilled; // head was taken from prefill: payload is
+                              // already in place, fragment copy is skipped
 }
 gcs_defrag_t;
 
@@ -69,13 +72,36 @@ gcs_defrag_free (gcs_defrag_t* df)
         gcs_gcache_free (df->cache, df->head);
         // df->head, df->tail will be zeroed in gcs_defrag_init() below
     }
+
+    if (df->prefill) {
+        gcs_gcache_free (df->cache, df->prefill);
+    }
 #else
     assert(NULL == df->head);
+    assert(NULL == df->prefill);
 #endif
 
     gcs_defrag_init (df, df->cache);
 }
 
+/*! Hand over a cache-resident copy of a local action payload made at send
+ *  time. It is consumed by the next allocation of the action buffer, which
+ *  then skips per-fragment payload copying (see gcs_defrag_handle_frag()) */
+static inline void
+gcs_defrag_set_prefill (gcs_defrag_t* df, void* buf)
+{
+#ifndef GCS_FOR_GARB
+    if (gu_unlikely(NULL != df->prefill)) {
+        /* previous prefill was never taken (e.g. aborted resend) */
+        gcs_gcache_free (df->cache, df->prefill);
+    }
+
+    df->prefill = (uint8_t*)buf;
+#else
+    assert(0); // garb never retains local payloads
+#endif
+}
+
 /*! Mark current action as reset */
 static inline void
 gcs_defrag_reset (gcs_defrag_t* df)
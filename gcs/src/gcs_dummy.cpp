@@ -298,6 +298,7 @@ GCS_BACKEND_CREATE_FN(gcs_dummy_create)
     backend->close     = dummy_close;
     backend->destroy   = dummy_destroy;
     backend->send      = dummy_send;
+    backend->send_v    = NULL;
     backend->recv      = dummy_recv;
     backend->name      = dummy_name;
     backend->msg_size  = dummy_msg_size;
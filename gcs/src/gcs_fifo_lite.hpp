@@ -10,6 +10,18 @@
  * access methods - protected and unprotected. Unprotected
  * methods assume that calling routines implement their own
  * protection, and thus are simplified for speed.
+ *
+ * NOTE: the mutex here is not a scalability concern and a lock-free ring
+ *       would not buy anything. Both users (repl_q in gcs.cpp, core action
+ *       fifo in gcs_core.cpp) push under the send monitor, which already
+ *       serializes producers, so at most one submitter and the recv thread
+ *       ever contend on this lock. More importantly, the consumer peeks the
+ *       head entry and dereferences it while still holding the lock, and
+ *       that is what makes gcs_fifo_lite_remove() on the send-failure path
+ *       safe: without the lock the entry could be removed and its owner
+ *       woken (and the action freed) between the consumer's peek and its
+ *       dereference. Going lock-free would require hazard-pointer style
+ *       deferred reclamation for a critical section of a few instructions.
  */
 
 #ifndef _GCS_FIFO_LITE_H_
@@ -188,6 +200,34 @@ gcs_fifo_lite_remove (gcs_fifo_lite_t* const fifo)
     return ret;
 }
 
+/*! Removes item from tail and copies it out, returns true if success */
+static inline bool
+gcs_fifo_lite_remove_get (gcs_fifo_lite_t* const fifo, void* const item)
+{
+    bool ret = false;
+    assert (fifo);
+    assert (item);
+
+    GCS_FIFO_LITE_LOCK;
+
+    if (fifo->used) {
+        fifo->tail = (fifo->tail - 1) & fifo->mask;
+        fifo->used--;
+        ret = true;
+
+        memcpy (item, _gcs_fifo_lite_tail (fifo), fifo->item_size);
+
+        if (fifo->put_wait > 0) {
+            fifo->put_wait--;
+            gu_cond_signal (&fifo->put_cond);
+        }
+    }
+
+    gu_mutex_unlock (&fifo->lock);
+
+    return ret;
+}
+
 static inline bool
 gcs_fifo_lite_not_full (const gcs_fifo_lite_t* const fifo)
 {
@@ -45,6 +45,12 @@ using namespace gcomm;
 using namespace prof;
 
 static const std::string gcomm_thread_schedparam_opt("gcomm.thread_prio");
+static const std::string gcomm_thread_affinity_opt  ("gcomm.thread_affinity");
+static const std::string gcomm_recv_defer_period_opt("gcomm.recv_defer_period");
+static const std::string gcomm_recv_defer_msgs_opt  ("gcomm.recv_defer_msgs");
+
+static const std::string gcomm_recv_defer_period_default("PT0.05S");
+static const std::string gcomm_recv_defer_msgs_default  ("64");
 
 class RecvBufData
 {
@@ -99,9 +105,22 @@ private:
         bool& w_;
     };
 
+    /* Last applied reports are the only messages that keep trickling in
+     * when a synchronized group is idle, and delaying commit cut
+     * advancement by a fraction of a second is harmless. Everything else
+     * (actions, views, state exchange, flow control, causal tokens) must
+     * wake the receiver immediately. */
+    static bool deferrable(const RecvBufData& d)
+    {
+        return (d.get_dgram().len() != 0 &&
+                d.get_um().err_no() == 0 &&
+                static_cast<gcs_msg_type_t>(d.get_um().user_type()) ==
+                GCS_MSG_LAST);
+    }
+
 public:
 
-    RecvBuf()
+    RecvBuf(const Period& defer_period, size_t defer_max_msgs)
         :
 #ifdef HAVE_PSI_INTERFACE
         mutex_(WSREP_PFS_INSTR_TAG_RECVBUF_MUTEX),
@@ -110,25 +129,80 @@ public:
         mutex_(),
         cond_(),
 #endif /* HAVE_PSI_INTERFACE */
-        queue_(), waiting_(false) { }
+        queue_(), waiting_(false),
+        defer_period_  (defer_period),
+        defer_max_msgs_(defer_max_msgs),
+        n_urgent_      (0),
+        flush_deadline_(Date::max())
+    { }
 
     void push_back(const RecvBufData& p)
     {
         Lock lock(mutex_);
 
+        bool const defer(defer_period_.get_nsecs() > 0 && deferrable(p));
+
         queue_.push_back(p);
+        n_urgent_ += (defer == false);
 
-        if (waiting_ == true) { cond_.signal(); }
+        if (defer == true)
+        {
+            if (flush_deadline_ == Date::max())
+            {
+                /* calendar time: both the caller supplied timeout and
+                 * the timed wait in front() are on the realtime clock */
+                flush_deadline_ = Date::calendar() + defer_period_;
+            }
+            else if (queue_.size() >= defer_max_msgs_)
+            {
+                /* batch is full - expire the deadline so that front()
+                 * keeps draining until the queue runs empty */
+                flush_deadline_ = Date::calendar();
+            }
+        }
+
+        if (waiting_ == true)
+        {
+            /* signal for urgent messages and for a full batch; also for
+             * the first queued message so that the receiver can rearm
+             * its wait to expire at flush_deadline_ (see front()) -
+             * deferred messages queued behind that don't wake it */
+            if (defer == false                   ||
+                queue_.size() >= defer_max_msgs_ ||
+                1 == queue_.size())
+            {
+                cond_.signal();
+            }
+        }
     }
 
     const RecvBufData& front(const Date& timeout)
     {
         Lock lock(mutex_);
 
-        while (queue_.empty())
+        while (queue_.empty() ||
+               (0 == n_urgent_                    &&
+                queue_.size()    < defer_max_msgs_ &&
+                Date::calendar() < flush_deadline_))
         {
             Waiting w(waiting_);
-            if (gu_likely (timeout == GU_TIME_ETERNITY))
+            if (queue_.empty() == false)
+            {
+                /* only deferred messages queued - sleep until the batch
+                 * deadline and then flush whatever has accumulated */
+                Date const wake(flush_deadline_ < timeout ?
+                                flush_deadline_ : timeout);
+                try
+                {
+                    lock.wait(cond_, wake);
+                }
+                catch (Exception& e)
+                {
+                    if (ETIMEDOUT == e.get_errno()) break;
+                    throw;
+                }
+            }
+            else if (gu_likely (timeout == GU_TIME_ETERNITY))
             {
                 lock.wait(cond_);
             }
@@ -138,6 +212,7 @@ public:
             }
         }
         assert (false == waiting_);
+        assert (queue_.empty() == false);
 
         return queue_.front();
     }
@@ -146,7 +221,13 @@ public:
     {
         Lock lock(mutex_);
         assert(queue_.empty() == false);
+
+        bool const deferred(defer_period_.get_nsecs() > 0 &&
+                            deferrable(queue_.front()));
+        n_urgent_ -= (deferred == false);
         queue_.pop_front();
+
+        if (queue_.empty()) { flush_deadline_ = Date::max(); }
     }
 
 private:
@@ -160,6 +241,10 @@ private:
 #endif /* HAVE_PSI_INTERFACE */
     RecvBufQueue queue_;
     bool waiting_;
+    Period const defer_period_;   // how long last applied reports may wait
+    size_t const defer_max_msgs_; // flush threshold for deferred messages
+    long         n_urgent_;       // queued messages that can't wait
+    Date         flush_deadline_; // when the oldest deferred message must go
 };
 
 
@@ -196,6 +281,7 @@ public:
         uuid_(),
         thd_(),
         schedparam_(conf_.get(gcomm_thread_schedparam_opt)),
+        affinity_  (conf_.get(gcomm_thread_affinity_opt)),
         barrier_(2),
         uri_(u),
         net_(Protonet::create(conf_)),
@@ -208,7 +294,11 @@ public:
         refcnt_(0),
         terminated_(false),
         error_(0),
-        recv_buf_(),
+        recv_buf_(Period(conf_.get(gcomm_recv_defer_period_opt,
+                                   gcomm_recv_defer_period_default)),
+                  gu::from_string<size_t>(
+                      conf_.get(gcomm_recv_defer_msgs_opt,
+                                gcomm_recv_defer_msgs_default))),
         current_view_(),
         prof_("gcs_gcomm")
     {
@@ -232,8 +322,12 @@ public:
                            NULL, NULL, NULL);
 #endif /* HAVE_PSI_INTERFACE */
 
+        gu::thread_cpu_register("protonet");
+
         static_cast<GCommConn*>(arg)->run();
 
+        gu::thread_cpu_unregister();
+
 #ifdef HAVE_PSI_INTERFACE
         pfs_instr_callback(WSREP_PFS_INSTR_TYPE_THREAD,
                            WSREP_PFS_INSTR_OPS_DESTROY,
@@ -279,6 +373,13 @@ public:
         log_info << "gcomm thread scheduling priority set to "
                  << thread_get_schedparam(thd_) << " ";
 
+        if (!affinity_.empty())
+        {
+            // e.g. pin the network thread to the NIC's NUMA node
+            thread_set_affinity(thd_, affinity_);
+            log_info << "gcomm thread bound to CPU(s) " << affinity_;
+        }
+
         uri_.set_option("gmcast.group", channel);
         tp_ = Transport::create(*net_, uri_);
         gcomm::connect(tp_, this);
@@ -448,6 +549,7 @@ private:
     gcomm::UUID       uuid_;
     pthread_t         thd_;
     ThreadSchedparam  schedparam_;
+    ThreadAffinity    affinity_;
     Barrier           barrier_;
     URI               uri_;
     Protonet*         net_;
@@ -606,23 +708,12 @@ static GCS_BACKEND_MSG_SIZE_FN(gcomm_msg_size)
 }
 
 
-static GCS_BACKEND_SEND_FN(gcomm_send)
+static long gcomm_send_dg(GCommConn&     conn,
+                          Datagram&      dg,
+                          size_t         len,
+                          gcs_msg_type_t msg_type)
 {
-    GCommConn::Ref ref(backend);
-
-    if (gu_unlikely(ref.get() == 0))
-    {
-        return -EBADFD;
-    }
-
-    GCommConn& conn(*ref.get());
-
-    Datagram dg(
-        SharedBuffer(
-            new Buffer(reinterpret_cast<const byte_t*>(buf),
-                       reinterpret_cast<const byte_t*>(buf) + len)));
-
-    int err;
+    int err(0);
     // Set thread scheduling params if gcomm thread runs with
     // non-default params
     gu::ThreadSchedparam orig_sp;
@@ -671,6 +762,57 @@ static GCS_BACKEND_SEND_FN(gcomm_send)
 }
 
 
+static GCS_BACKEND_SEND_FN(gcomm_send)
+{
+    GCommConn::Ref ref(backend);
+
+    if (gu_unlikely(ref.get() == 0))
+    {
+        return -EBADFD;
+    }
+
+    GCommConn& conn(*ref.get());
+
+    Datagram dg(
+        SharedBuffer(
+            new Buffer(reinterpret_cast<const byte_t*>(buf),
+                       reinterpret_cast<const byte_t*>(buf) + len)));
+
+    return gcomm_send_dg(conn, dg, len, msg_type);
+}
+
+
+static GCS_BACKEND_SEND_V_FN(gcomm_send_v)
+{
+    GCommConn::Ref ref(backend);
+
+    if (gu_unlikely(ref.get() == 0))
+    {
+        return -EBADFD;
+    }
+
+    GCommConn& conn(*ref.get());
+
+    // gather scattered message into the datagram payload in one pass -
+    // the only copy this message makes above the socket layer
+    SharedBuffer sb(new Buffer());
+    sb->reserve(len);
+
+    for (long i(0); i < n_bufs; ++i)
+    {
+        const byte_t* const ptr(
+            reinterpret_cast<const byte_t*>(bufs[i].ptr));
+        sb->insert(sb->end(), ptr, ptr + bufs[i].size);
+    }
+
+    assert(sb->size() == len);
+
+    Datagram dg(sb);
+
+    return gcomm_send_dg(conn, dg, len, msg_type);
+}
+
+
 static void fill_cmp_msg(const View& view, const gcomm::UUID& my_uuid,
                          gcs_comp_msg_t* cm)
 {
@@ -984,6 +1126,11 @@ GCS_BACKEND_REGISTER_FN(gcs_gcomm_register)
     try
     {
         reinterpret_cast<gu::Config*>(cnf)->add(gcomm_thread_schedparam_opt, "");
+        reinterpret_cast<gu::Config*>(cnf)->add(gcomm_thread_affinity_opt, "");
+        reinterpret_cast<gu::Config*>(cnf)->add(gcomm_recv_defer_period_opt,
+                                                gcomm_recv_defer_period_default);
+        reinterpret_cast<gu::Config*>(cnf)->add(gcomm_recv_defer_msgs_opt,
+                                                gcomm_recv_defer_msgs_default);
         gcomm::Conf::register_params(*reinterpret_cast<gu::Config*>(cnf));
         return false;
     }
@@ -1022,6 +1169,7 @@ GCS_BACKEND_CREATE_FN(gcs_gcomm_create)
     backend->close     = gcomm_close;
     backend->destroy   = gcomm_destroy;
     backend->send      = gcomm_send;
+    backend->send_v    = gcomm_send_v;
     backend->recv      = gcomm_recv;
     backend->name      = gcomm_name;
     backend->msg_size  = gcomm_msg_size;
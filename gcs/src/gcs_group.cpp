@@ -39,6 +39,8 @@ gcs_group_init (gcs_group_t* group, gcache_t* const cache,
     group->last_applied = GCS_SEQNO_ILL; // mark for recalculation
     group->last_node    = -1;
     group->frag_reset   = true; // just in case
+    group->min_tree     = NULL;
+    group->min_tree_cap = 0;
     group->nodes        = GU_CALLOC(group->num, gcs_node_t); // this must be removed (#474)
 
     if (!group->nodes) return -ENOMEM; // this should be removed (#474)
@@ -144,6 +146,10 @@ gcs_group_free (gcs_group_t* group)
     if (group->my_name)    free ((char*)group->my_name);
     if (group->my_address) free ((char*)group->my_address);
     group_nodes_free (group);
+
+    if (group->min_tree) gu_free (group->min_tree);
+    group->min_tree     = NULL;
+    group->min_tree_cap = 0;
 }
 
 /* Reset nodes array without breaking the statistics */
@@ -164,50 +170,119 @@ group_nodes_reset (gcs_group_t* group)
     group->frag_reset = true;
 }
 
-/* Find node with the smallest last_applied */
-static inline void
-group_redo_last_applied (gcs_group_t* group)
+/* Effective last applied value of a node in the commit cut tournament:
+ * nodes that must not be counted weigh in as maximum and never win. */
+static inline gcs_seqno_t
+group_node_eff_seqno (const gcs_group_t* group, const gcs_node_t* node)
 {
-    long       n;
-    long       last_node    = -1;
-    gu_seqno_t last_applied = GU_LLONG_MAX;
-
-    for (n = 0; n < group->num; n++) {
-        const gcs_node_t* const node = &group->nodes[n];
-        gcs_seqno_t const seqno = node->last_applied;
-        bool count = node->count_last_applied;
-
-        if (gu_unlikely (0 == group->last_applied_proto_ver)) {
-            /* @note: this may be removed after quorum v1 is phased out */
-            count = (GCS_NODE_STATE_SYNCED == node->status ||
-                     GCS_NODE_STATE_DONOR  == node->status);
-        }
+    bool count = node->count_last_applied;
+
+    if (gu_unlikely (0 == group->last_applied_proto_ver)) {
+        /* @note: this may be removed after quorum v1 is phased out */
+        count = (GCS_NODE_STATE_SYNCED == node->status ||
+                 GCS_NODE_STATE_DONOR  == node->status);
+    }
+
+    /* NOTE: It is crucial for consistency that last_applied algorithm
+     *       is absolutely identical on all nodes. Therefore for the
+     *       generality sake and future compatibility we have to assume
+     *       non-blocking donor.
+     *       GCS_BLOCKING_DONOR should never be defined unless in some
+     *       very custom builds. Hence the donor is counted above. */
+
+    if (count) {
+        assert (node->last_applied >= 0);
+        return node->last_applied;
+    }
+
+    return GU_LLONG_MAX;
+}
 
-//        gu_debug ("last_applied[%ld]: %lld", n, seqno);
-
-        /* NOTE: It is crucial for consistency that last_applied algorithm
-         *       is absolutely identical on all nodes. Therefore for the
-         *       generality sake and future compatibility we have to assume
-         *       non-blocking donor.
-         *       GCS_BLOCKING_DONOR should never be defined unless in some
-         *       very custom builds. Commenting it out for safety sake. */
-//#ifndef GCS_BLOCKING_DONOR
-        if (count
-//#else
-//        if ((GCS_NODE_STATE_SYNCED == node->status) /* ignore donor */
-//#endif
-            && (seqno < last_applied)) {
-            assert (seqno >= 0);
-            last_applied = seqno;
-            last_node    = n;
+/* (Re)builds the tournament tree from scratch: O(num). The minimum ends
+ * up in min_tree[1], leaf n (node n) lives at min_tree[min_tree_cap + n],
+ * padding leaves hold GU_LLONG_MAX. */
+static void
+group_min_tree_rebuild (gcs_group_t* group)
+{
+    long cap = 1;
+    long i;
+
+    while (cap < group->num) cap <<= 1;
+
+    if (cap != group->min_tree_cap || NULL == group->min_tree) {
+        if (group->min_tree) gu_free (group->min_tree);
+        group->min_tree     = GU_MALLOCN (2 * cap, gcs_seqno_t);
+        group->min_tree_cap = cap;
+        if (gu_unlikely (NULL == group->min_tree)) {
+            group->min_tree_cap = 0;
+            gu_abort(); // no sane way to continue without the commit cut
         }
-        // extra diagnostic, ignore
-        //else if (!count) { gu_warn("not counting %d", n); }
     }
 
-    if (gu_likely (last_node >= 0)) {
-        group->last_applied = last_applied;
-        group->last_node    = last_node;
+    for (i = 0; i < group->num; i++) {
+        group->min_tree[cap + i] =
+            group_node_eff_seqno (group, &group->nodes[i]);
+    }
+    for (i = group->num; i < cap; i++) {
+        group->min_tree[cap + i] = GU_LLONG_MAX;
+    }
+    for (i = cap - 1; i >= 1; i--) {
+        gcs_seqno_t const l = group->min_tree[2 * i];
+        gcs_seqno_t const r = group->min_tree[2 * i + 1];
+        group->min_tree[i]  = l < r ? l : r;
+    }
+}
+
+/* Refreshes node n's leaf and bubbles the minimum up: O(log num). */
+static inline void
+group_min_tree_update (gcs_group_t* group, long n)
+{
+    long i;
+
+    if (gu_unlikely (NULL == group->min_tree ||
+                     group->min_tree_cap < group->num)) {
+        group_min_tree_rebuild (group);
+        return;
+    }
+
+    i = group->min_tree_cap + n;
+    group->min_tree[i] = group_node_eff_seqno (group, &group->nodes[n]);
+
+    for (i >>= 1; i >= 1; i >>= 1) {
+        gcs_seqno_t const l   = group->min_tree[2 * i];
+        gcs_seqno_t const r   = group->min_tree[2 * i + 1];
+        gcs_seqno_t const min = l < r ? l : r;
+
+        if (min == group->min_tree[i]) break; // ancestors can't change either
+
+        group->min_tree[i] = min;
+    }
+}
+
+/* Walks the tournament down to the winning leaf, preferring the left
+ * child on ties so that, like the linear scan this replaced, the lowest
+ * node index wins. */
+static inline long
+group_min_tree_node (const gcs_group_t* group)
+{
+    long i = 1;
+
+    while (i < group->min_tree_cap) {
+        i = 2 * i + (group->min_tree[2 * i + 1] < group->min_tree[2 * i]);
+    }
+
+    return i - group->min_tree_cap;
+}
+
+/* Find node with the smallest last_applied */
+static inline void
+group_redo_last_applied (gcs_group_t* group)
+{
+    group_min_tree_rebuild (group);
+
+    if (gu_likely (group->min_tree[1] != GU_LLONG_MAX)) {
+        group->last_applied = group->min_tree[1];
+        group->last_node    = group_min_tree_node (group);
     }
 }
 
@@ -219,6 +294,7 @@ group_go_non_primary (gcs_group_t* group)
         assert(group->nodes);
 
         group->nodes[group->my_idx].status = GCS_NODE_STATE_NON_PRIM;
+        group_min_tree_update (group, group->my_idx); // status affects counting
         //@todo: Perhaps the same has to be applied to the rest of the nodes[]?
     }
     else {
@@ -308,6 +384,12 @@ group_post_state_exchange (gcs_group_t* group)
         gcs_node_update_status (&group->nodes[i], quorum);
     }
 
+    /* status updates above (and a possible last_applied_proto_ver bump)
+     * change which nodes count in the commit cut - refresh all tournament
+     * tree leaves at once so the cut keeps matching a full scan of the
+     * current flags on every node */
+    group_min_tree_rebuild (group);
+
     if (quorum->primary) {
         // primary configuration
         if (new_exchange) {
@@ -371,6 +453,21 @@ group_post_state_exchange (gcs_group_t* group)
     group_check_donor(group);
 }
 
+/* member id -> node array slot, used to index the old configuration by
+ * unique member id when remapping node contexts to a new one */
+struct group_node_id
+{
+    const char* id;
+    long        idx;
+};
+
+static int
+group_node_id_cmp (const void* a_ptr, const void* b_ptr)
+{
+    return strcmp (((const struct group_node_id*)a_ptr)->id,
+                   ((const struct group_node_id*)b_ptr)->id);
+}
+
 // does basic sanity check of the component message (in response to #145)
 static void
 group_check_comp_msg (bool prim, long my_idx, long members)
@@ -485,21 +582,58 @@ gcs_group_handle_comp_msg (gcs_group_t* group, const gcs_comp_msg_t* comp)
         group_go_non_primary (group);
     }
 
-    /* Remap old node array to new one to preserve action continuity */
-    for (new_idx = 0; new_idx < new_nodes_num; new_idx++) {
-        /* find member index in old component by unique member id */
-        for (old_idx = 0; old_idx < group->num; old_idx++) {
-            // just scan through old group
-            if (!strcmp(group->nodes[old_idx].id, new_nodes[new_idx].id)) {
-                /* the node was in previous configuration with us */
-                /* move node context to new node array */
-                gcs_node_move (&new_nodes[new_idx], &group->nodes[old_idx]);
-                break;
+    /* Remap old node array to new one to preserve action continuity.
+     * Old slots are located by unique member id through a sorted index
+     * (see group_node_id_cmp()), so the remap costs O(n log n) rather
+     * than a nested scan over both arrays. */
+    {
+        struct group_node_id* const index =
+            group->num > 0 ? GU_CALLOC (group->num, struct group_node_id) :
+            NULL;
+
+        if (index) {
+            for (old_idx = 0; old_idx < group->num; old_idx++) {
+                index[old_idx].id  = group->nodes[old_idx].id;
+                index[old_idx].idx = old_idx;
+            }
+            qsort (index, group->num, sizeof(*index), group_node_id_cmp);
+        }
+
+        for (new_idx = 0; new_idx < new_nodes_num; new_idx++) {
+            /* find member index in old component by unique member id */
+            if (index) {
+                struct group_node_id const key = { new_nodes[new_idx].id, -1 };
+                const struct group_node_id* const found =
+                    (const struct group_node_id*)
+                    bsearch (&key, index, group->num, sizeof(*index),
+                             group_node_id_cmp);
+
+                if (found) {
+                    /* the node was in previous configuration with us */
+                    /* move node context to new node array */
+                    gcs_node_move (&new_nodes[new_idx],
+                                   &group->nodes[found->idx]);
+                }
+                /* if wasn't found in new configuration, new member -
+                 * need to do state exchange */
+                new_memb |= (NULL == found);
+            }
+            else {
+                /* empty old group (or failed index allocation):
+                 * fall back to plain scan */
+                for (old_idx = 0; old_idx < group->num; old_idx++) {
+                    if (!strcmp(group->nodes[old_idx].id,
+                                new_nodes[new_idx].id)) {
+                        gcs_node_move (&new_nodes[new_idx],
+                                       &group->nodes[old_idx]);
+                        break;
+                    }
+                }
+                new_memb |= (old_idx == group->num);
             }
         }
-        /* if wasn't found in new configuration, new member -
-         * need to do state exchange */
-        new_memb |= (old_idx == group->num);
+
+        if (index) gu_free (index);
     }
 
     /* free old nodes array */
@@ -618,6 +752,33 @@ gcs_group_handle_state_msg (gcs_group_t* group, const gcs_recv_msg_t* msg)
     return group->state;
 }
 
+/*! Common part of handling an explicit GCS_MSG_LAST report and a
+ *  last applied value piggybacked on an action fragment (act proto v1).
+ *  Returns new commit cut value if it has changed, 0 otherwise */
+static gcs_seqno_t
+group_update_last_applied (gcs_group_t* group, long sender_idx,
+                           gcs_seqno_t seqno)
+{
+    gcs_node_set_last_applied (&group->nodes[sender_idx], seqno);
+
+    group_min_tree_update (group, sender_idx);
+
+    gcs_seqno_t const min = group->min_tree[1];
+
+    if (min != GU_LLONG_MAX && min > group->last_applied) {
+        /* the group minimum moved up - new commit cut */
+        group->last_applied = min;
+        group->last_node    = group_min_tree_node (group);
+
+        gu_debug ("New COMMIT CUT %lld after %lld from %d",
+                  (long long)group->last_applied,
+                  (long long)seqno, sender_idx);
+        return group->last_applied;
+    }
+
+    return 0;
+}
+
 /*! Returns new last applied value if it has changes, 0 otherwise */
 gcs_seqno_t
 gcs_group_handle_last_msg (gcs_group_t* group, const gcs_recv_msg_t* msg)
@@ -634,24 +795,20 @@ gcs_group_handle_last_msg (gcs_group_t* group, const gcs_recv_msg_t* msg)
     // between threads.
     // assert (seqno >= group->last_applied);
 
-    gcs_node_set_last_applied (&group->nodes[msg->sender_idx], seqno);
-
-    if (msg->sender_idx == group->last_node && seqno > group->last_applied) {
-        /* node that was responsible for the last value, has changed it.
-         * need to recompute it */
-        gcs_seqno_t old_val = group->last_applied;
-
-        group_redo_last_applied (group);
+    return group_update_last_applied (group, msg->sender_idx, seqno);
+}
 
-        if (old_val < group->last_applied) {
-            gu_debug ("New COMMIT CUT %lld after %lld from %d",
-                      (long long)group->last_applied,
-                      (long long)seqno, msg->sender_idx);
-            return group->last_applied;
-        }
-    }
+/*! Returns new last applied value if it has changes, 0 otherwise */
+gcs_seqno_t
+gcs_group_handle_act_last (gcs_group_t* group, long sender_idx,
+                           gcs_seqno_t seqno)
+{
+    /* every fragment of an action carries the same stamp, and a node's
+     * last applied value never decreases within a configuration - skip
+     * the recomputation for repeated and stale stamps */
+    if (seqno <= group->nodes[sender_idx].last_applied) return 0;
 
-    return 0;
+    return group_update_last_applied (group, sender_idx, seqno);
 }
 
 /*! return true if this node is the sender to notify the calling thread of
@@ -717,6 +874,9 @@ gcs_group_handle_join_msg  (gcs_group_t* group, const gcs_recv_msg_t* msg)
             }
         }
 
+        // under proto v0 the status change above affects commit cut counting
+        group_min_tree_update (group, sender_idx);
+
         // Try to find peer.
         for (j = 0; j < group->num; j++) {
 // #483            if (j == sender_idx) continue;
@@ -887,16 +1047,34 @@ group_find_node_by_state (const gcs_group_t*     const group,
 
         gcs_node_t* node = &group->nodes[idx];
 
-        if (node->status >= status && group_node_is_stateful (group, node))
-            donor = idx; /* potential donor */
-
-        if (segment == node->segment) {
-            if (donor == idx) return donor; /* found suitable donor in the
-                                             * same segment */
-            if (node->status >= GCS_NODE_STATE_JOINER) hnss = true;;
+        if (node->status >= status && group_node_is_stateful (group, node)) {
+            /* potential donor: prefer the joiner's segment, and within a
+             * segment an idle SYNCED node over one already serving a
+             * transfer (DONOR) - the only load signal the state message
+             * carries. */
+            if (donor < 0) {
+                donor = idx;
+            }
+            else {
+                gcs_node_t* const cur = &group->nodes[donor];
+                bool const node_local = (segment == node->segment);
+                bool const cur_local  = (segment == cur->segment);
+
+                if ((node_local && !cur_local) ||
+                    (node_local == cur_local &&
+                     node->status == GCS_NODE_STATE_SYNCED &&
+                     cur->status  == GCS_NODE_STATE_DONOR)) {
+                    donor = idx;
+                }
+            }
         }
+
+        if (segment == node->segment &&
+            node->status >= GCS_NODE_STATE_JOINER) hnss = true;
     }
 
+    if (donor >= 0 && segment == group->nodes[donor].segment) return donor;
+
     /* Have not found suitable donor in the same segment. */
     if (!hnss && donor >= 0) {
         if (joiner_idx == group->my_idx) {
@@ -1317,6 +1495,10 @@ group_select_donor (gcs_group_t* group,
         joiner->status = GCS_NODE_STATE_JOINER;
         donor->status  = GCS_NODE_STATE_DONOR;
 
+        // under proto v0 the status changes affect commit cut counting
+        group_min_tree_update (group, joiner_idx);
+        group_min_tree_update (group, donor_idx);
+
         if (1 == donor->desync_count) {
             /* SST or first desync */
             memcpy (donor->joiner, joiner->id, GCS_COMP_MEMB_ID_MAX_LEN+1);
@@ -51,6 +51,13 @@ typedef struct gcs_group
     bool          frag_reset;   // indicate that fragmentation was reset
     gcs_node_t*   nodes;        // array of node contexts
 
+    /* tournament tree over the nodes' last applied values: leaf n holds
+     * node n's effective value, inner slots the minimum of their children,
+     * so a single report updates the group minimum in O(log num). See
+     * group_min_tree_*() in gcs_group.cpp */
+    gcs_seqno_t*  min_tree;     // 2 * min_tree_cap slots, root at [1]
+    long          min_tree_cap; // leaf capacity, power of two >= num
+
     /* values from the last primary component */
     gu_uuid_t        prim_uuid;
     gu_seqno_t       prim_seqno;
@@ -120,6 +127,13 @@ gcs_group_handle_state_msg (gcs_group_t* group, const gcs_recv_msg_t* msg);
 extern gcs_seqno_t
 gcs_group_handle_last_msg  (gcs_group_t* group, const gcs_recv_msg_t* msg);
 
+/*! Handles last applied value piggybacked on an action fragment header
+ *  (act protocol v1).
+ *  @return new commit cut value if it has changed, 0 otherwise */
+extern gcs_seqno_t
+gcs_group_handle_act_last  (gcs_group_t* group, long sender_idx,
+                            gcs_seqno_t seqno);
+
 /*! @return 0 for success, 1 for (success && i_am_sender)
  * or negative error code */
 extern int
@@ -15,8 +15,10 @@ const char* const GCS_PARAMS_FC_FACTOR         = "gcs.fc_factor";
 const char* const GCS_PARAMS_FC_LIMIT          = "gcs.fc_limit";
 const char* const GCS_PARAMS_FC_MASTER_SLAVE   = "gcs.fc_master_slave";
 const char* const GCS_PARAMS_FC_DEBUG          = "gcs.fc_debug";
+const char* const GCS_PARAMS_FC_SETTLE_TIME    = "gcs.fc_settle_time";
 const char* const GCS_PARAMS_SYNC_DONOR        = "gcs.sync_donor";
 const char* const GCS_PARAMS_MAX_PKT_SIZE      = "gcs.max_packet_size";
+const char* const GCS_PARAMS_RECV_Q_WATERMARK  = "gcs.recv_q_watermark";
 const char* const GCS_PARAMS_RECV_Q_HARD_LIMIT = "gcs.recv_q_hard_limit";
 const char* const GCS_PARAMS_RECV_Q_SOFT_LIMIT = "gcs.recv_q_soft_limit";
 const char* const GCS_PARAMS_MAX_THROTTLE      = "gcs.max_throttle";
@@ -28,8 +30,14 @@ static const char* const GCS_PARAMS_FC_FACTOR_DEFAULT         = "1";
 static const char* const GCS_PARAMS_FC_LIMIT_DEFAULT          = "100";
 static const char* const GCS_PARAMS_FC_MASTER_SLAVE_DEFAULT   = "no";
 static const char* const GCS_PARAMS_FC_DEBUG_DEFAULT          = "0";
+/* seconds the recv queue must stay over the FC limit without draining
+ * before FC_STOP is sent; 0 - send FC_STOP on the first excess */
+static const char* const GCS_PARAMS_FC_SETTLE_TIME_DEFAULT    = "0.1";
 static const char* const GCS_PARAMS_SYNC_DONOR_DEFAULT        = "no";
 static const char* const GCS_PARAMS_MAX_PKT_SIZE_DEFAULT      = "64500";
+/* fraction of the FC limit at which the recv queue watermark callback
+ * fires (cleared again at half the watermark); 0 - disabled */
+static const char* const GCS_PARAMS_RECV_Q_WATERMARK_DEFAULT  = "0";
 static ssize_t const GCS_PARAMS_RECV_Q_HARD_LIMIT_DEFAULT     = SSIZE_MAX;
 static const char* const GCS_PARAMS_RECV_Q_SOFT_LIMIT_DEFAULT = "0.25";
 static const char* const GCS_PARAMS_MAX_THROTTLE_DEFAULT      = "0.25";
@@ -47,11 +55,16 @@ gcs_params_register(gu_config_t* conf)
                           GCS_PARAMS_FC_MASTER_SLAVE_DEFAULT);
     ret |= gu_config_add (conf, GCS_PARAMS_FC_DEBUG,
                           GCS_PARAMS_FC_DEBUG_DEFAULT);
+    ret |= gu_config_add (conf, GCS_PARAMS_FC_SETTLE_TIME,
+                          GCS_PARAMS_FC_SETTLE_TIME_DEFAULT);
     ret |= gu_config_add (conf, GCS_PARAMS_SYNC_DONOR,
                           GCS_PARAMS_SYNC_DONOR_DEFAULT);
     ret |= gu_config_add (conf, GCS_PARAMS_MAX_PKT_SIZE,
                           GCS_PARAMS_MAX_PKT_SIZE_DEFAULT);
 
+    ret |= gu_config_add (conf, GCS_PARAMS_RECV_Q_WATERMARK,
+                          GCS_PARAMS_RECV_Q_WATERMARK_DEFAULT);
+
     char tmp[32] = { 0, };
     snprintf (tmp, sizeof(tmp) - 1, "%lld",
               (long long)GCS_PARAMS_RECV_Q_HARD_LIMIT_DEFAULT);
@@ -195,6 +208,14 @@ gcs_params_init (struct gcs_params* params, gu_config_t* config)
     if ((ret = params_init_double (config, GCS_PARAMS_FC_FACTOR, 0.0, 1.0,
                                    &params->fc_resume_factor))) return ret;
 
+    if ((ret = params_init_double (config, GCS_PARAMS_FC_SETTLE_TIME,
+                                   0.0, 3600.0,
+                                   &params->fc_settle_time))) return ret;
+
+    if ((ret = params_init_double (config, GCS_PARAMS_RECV_Q_WATERMARK,
+                                   0.0, 1.0,
+                                   &params->recv_q_watermark))) return ret;
+
     if ((ret = params_init_double (config, GCS_PARAMS_RECV_Q_SOFT_LIMIT,
                                    0.0, 1.0 - 1.e-9,
                                    &params->recv_q_soft_limit))) return ret;
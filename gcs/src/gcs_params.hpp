@@ -11,6 +11,8 @@
 struct gcs_params
 {
     double  fc_resume_factor;
+    double  fc_settle_time;
+    double  recv_q_watermark;
     double  recv_q_soft_limit;
     double  max_throttle;
     ssize_t recv_q_hard_limit;
@@ -24,9 +26,11 @@ struct gcs_params
 extern const char* const GCS_PARAMS_FC_FACTOR;
 extern const char* const GCS_PARAMS_FC_LIMIT;
 extern const char* const GCS_PARAMS_FC_MASTER_SLAVE;
+extern const char* const GCS_PARAMS_FC_SETTLE_TIME;
 extern const char* const GCS_PARAMS_FC_DEBUG;
 extern const char* const GCS_PARAMS_SYNC_DONOR;
 extern const char* const GCS_PARAMS_MAX_PKT_SIZE;
+extern const char* const GCS_PARAMS_RECV_Q_WATERMARK;
 extern const char* const GCS_PARAMS_RECV_Q_HARD_LIMIT;
 extern const char* const GCS_PARAMS_RECV_Q_SOFT_LIMIT;
 extern const char* const GCS_PARAMS_MAX_THROTTLE;
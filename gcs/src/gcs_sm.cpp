@@ -15,14 +15,17 @@
 static void
 sm_init_stats (gcs_sm_stats_t* stats)
 {
-    stats->sample_start   = gu_time_monotonic();
+    stats->sample_start   = gu_time_monotonic_coarse();
     stats->pause_start    = 0;
     stats->paused_ns      = 0;
     stats->paused_sample  = 0;
+    stats->paused_events  = 0;
     stats->send_q_samples = 0;
     stats->send_q_len     = 0;
     stats->send_q_len_max = 0;
     stats->send_q_len_min = 0;
+    stats->send_q_wait_p99.init (0.99);
+    stats->send_q_wait_p999.init(0.999);
 }
 
 gcs_sm_t*
@@ -145,24 +148,34 @@ gcs_sm_stats_get (gcs_sm_t*  sm,
                   int*       q_len_max,
                   int*       q_len_min,
                   double*    q_len_avg,
+                  long long* q_wait_p99,
+                  long long* q_wait_p999,
+                  long long* q_entered,
                   long long* paused_ns,
-                  double*    paused_avg)
+                  double*    paused_avg,
+                  long long* paused_events)
 {
     gcs_sm_stats_t tmp;
     long long      now;
     bool           paused;
+    long           users, users_max, users_min;
 
-    if (gu_unlikely(gu_mutex_lock (&sm->lock))) abort();
+    /* Lock-free monitoring snapshot: sm->lock is the replication hot
+     * path, so the counters are read with atomic loads instead. The
+     * copied values may be mutually inconsistent by an operation or
+     * two, which is fine for statistics. */
+    gu_atomic_get (&sm->users_max, &users_max);
+    gu_atomic_get (&sm->users_min, &users_min);
+    gu_atomic_get (&sm->users,     &users);
+
+    *q_len_max = users_max;
+    *q_len_min = users_min;
+    *q_len     = users;
 
-    *q_len_max = sm->users_max;
-    *q_len_min = sm->users_min;
-    *q_len = sm->users;
     tmp    = sm->stats;
-    now    = gu_time_monotonic();
+    now    = gu_time_monotonic_coarse();
     paused = sm->pause;
 
-    gu_mutex_unlock (&sm->lock);
-
     if (paused) { // taking sample in a middle of a pause
         tmp.paused_ns += now - tmp.pause_start;
     }
@@ -187,6 +200,12 @@ gcs_sm_stats_get (gcs_sm_t*  sm,
     else {
         *q_len_avg = -1.0;
     }
+
+    *q_wait_p99  = (long long)tmp.send_q_wait_p99.value();
+    *q_wait_p999 = (long long)tmp.send_q_wait_p999.value();
+
+    *q_entered     = tmp.send_q_samples >= 0 ? tmp.send_q_samples : -1;
+    *paused_events = tmp.paused_events;
 }
 
 void
@@ -194,7 +213,7 @@ gcs_sm_stats_flush(gcs_sm_t* sm)
 {
     if (gu_unlikely(gu_mutex_lock (&sm->lock))) abort();
 
-    long long const now = gu_time_monotonic();
+    long long const now = gu_time_monotonic_coarse();
 
     sm->stats.sample_start = now;
 
@@ -209,6 +228,9 @@ gcs_sm_stats_flush(gcs_sm_t* sm)
     sm->stats.send_q_len_max = 0;
     sm->stats.send_q_len_min = 0;
     sm->stats.send_q_samples = 0;
+    sm->stats.paused_events  = 0;
+    sm->stats.send_q_wait_p99.clear();
+    sm->stats.send_q_wait_p999.clear();
 
     sm->users_max = sm->users;
     sm->users_min = sm->users;
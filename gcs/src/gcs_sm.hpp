@@ -6,12 +6,24 @@
 
 /*!
  * @file GCS Send Monitor. To ensure fair (FIFO) access to gcs_core_send()
+ *
+ * On batching: a group-commit style scheme where the lead sender drains
+ * queued waiters and pushes their writesets out in one backend send does
+ * not fit here. The monitor is a pure admission primitive - wait_q holds
+ * only condition variables, the actions stay with the waiting threads -
+ * and, more fundamentally, one backend message carries exactly one
+ * fragment header (see gcs_act_proto), so packing several actions into a
+ * single message is a wire format change that every node in the cluster
+ * would have to understand. Per-message group overhead is instead
+ * amortized by the fragment size (gcs.max_packet_size): fragments of one
+ * action already travel back to back without re-entering the monitor.
  */
 
 #ifndef _gcs_sm_h_
 #define _gcs_sm_h_
 
 #include "gu_datetime.hpp"
+#include "gu_stats.hpp"
 #include <galerautils.h>
 #include <errno.h>
 
@@ -34,10 +46,13 @@ typedef struct gcs_sm_stats
     long long pause_start; // start of the pause
     long long paused_ns;     // total nanoseconds paused
     long long paused_sample; // paused_ns at the beginning of the sample
+    long long paused_events; // pause() transitions in the sample period
     long long send_q_samples;
     long long send_q_len;
     long long send_q_len_max;
     long long send_q_len_min;
+    gu::Quantile send_q_wait_p99;  // send queue wait quantiles (nanoseconds);
+    gu::Quantile send_q_wait_p999; // trivial members, initialized with init()
 }
 gcs_sm_stats_t;
 
@@ -214,6 +229,7 @@ _gcs_sm_enqueue_common (gcs_sm_t* sm, gu_cond_t* cond, bool block,
 {
     sm->wait_q[tail].cond = cond;
     sm->wait_q[tail].wait = true;
+    long long const wait_start(gu_time_monotonic());
     int ret;
 
     if (block == true)
@@ -272,6 +288,13 @@ _gcs_sm_enqueue_common (gcs_sm_t* sm, gu_cond_t* cond, bool block,
     sm->wait_q[tail].cond = NULL;
     sm->wait_q[tail].wait = false;
 
+    /* record wait duration under sm->lock (reacquired by cond wait) */
+    {
+        double const waited_ns(gu_time_monotonic() - wait_start);
+        sm->stats.send_q_wait_p99.insert (waited_ns);
+        sm->stats.send_q_wait_p999.insert(waited_ns);
+    }
+
     if (gu_unlikely(0 != ret)) GCS_SM_HIST_LOG("%ld wait failed: %d", tail, ret);
 
     return ret;
@@ -423,7 +446,8 @@ gcs_sm_pause (gcs_sm_t* sm)
 
     /* don't pause closed monitor */
     if (gu_likely(0 == sm->ret) && !sm->pause) {
-        sm->stats.pause_start = gu_time_monotonic();
+        sm->stats.pause_start = gu_time_monotonic_coarse();
+        sm->stats.paused_events++;
         sm->pause = true;
     }
     GCS_SM_HIST_LOG("paused");
@@ -446,7 +470,7 @@ gcs_sm_continue (gcs_sm_t* sm)
     if (gu_likely(sm->pause)) {
         _gcs_sm_continue_common (sm);
 
-        sm->stats.paused_ns += gu_time_monotonic() - sm->stats.pause_start;
+        sm->stats.paused_ns += gu_time_monotonic_coarse() - sm->stats.pause_start;
     }
     else {
         gu_info ("Trying to continue unpaused monitor");
@@ -505,9 +529,15 @@ gcs_sm_interrupt (gcs_sm_t* sm, long handle)
  *                   new one (not including itself) (-1 if stats overflown)
  * @param q_len_max  maximum send queue length since last call
  * @param q_len_min  minimum send queue length since last call
+ * @param q_wait_p99  99th percentile of send queue wait time (nanoseconds,
+ *                    streaming estimate)
+ * @param q_wait_p999 99.9th percentile of send queue wait time (nanoseconds)
+ * @param q_entered  number of actions that entered the monitor since last
+ *                   flush (-1 if stats overflown)
  * @param paused_ns  total time paused (nanoseconds)
  * @param paused_avg set to a fraction of time which monitor spent in a paused
  *                   state (-1 if stats overflown)
+ * @param paused_events number of pause events since last flush
  */
 extern void
 gcs_sm_stats_get (gcs_sm_t*  sm,
@@ -515,8 +545,12 @@ gcs_sm_stats_get (gcs_sm_t*  sm,
                   int*       q_len_max,
                   int*       q_len_min,
                   double*    q_len_avg,
+                  long long* q_wait_p99,
+                  long long* q_wait_p999,
+                  long long* q_entered,
                   long long* paused_ns,
-                  double*    paused_avg);
+                  double*    paused_avg,
+                  long long* paused_events);
 
 /*! resets average/max/min stats calculation */
 extern void
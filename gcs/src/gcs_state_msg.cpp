@@ -89,7 +89,18 @@ gcs_state_msg_destroy (gcs_state_msg_t* state)
     gu_free (state);
 }
 
-/* Returns length needed to serialize gcs_state_msg_t for sending */
+/* Returns length needed to serialize gcs_state_msg_t for sending
+ *
+ * NOTE: delta-encoding these messages (sending only fields changed since
+ *       the previous exchange) would not help view change latency. The
+ *       full message is barely over a hundred bytes plus two short
+ *       strings, so its cost on the wire is noise next to the EVS
+ *       membership rounds that precede the exchange. Worse, a delta has
+ *       no valid baseline exactly when state exchange matters most: a
+ *       freshly joined node has seen no previous exchange, and a node
+ *       returning from a non-primary component may have missed several.
+ *       The format below is also version-locked (GCS_STATE_MSG_VER) and
+ *       parsed by all members, so the encoding cannot change per-node. */
 size_t
 gcs_state_msg_len (gcs_state_msg_t* state)
 {
@@ -496,23 +507,55 @@ struct candidate /* remerge candidate */
     gcs_seqno_t            prim_seqno;
 };
 
-static bool
-state_match_candidate (const gcs_state_msg_t* const s,
-                       struct candidate*      const c,
-                       int                    const state_exchange_version)
+struct state_digest /* sortable digest of a node state for candidate search */
+{
+    gu_uuid_t              uuid;
+    gcs_seqno_t            seqno1;
+    gcs_seqno_t            seqno2;
+    const gcs_state_msg_t* state;
+};
+
+/* Distills the part of the node state that identifies its primary component
+ * into a digest, so that nodes from the same component compare equal. */
+static void
+state_digest_init (struct state_digest*   const d,
+                   const gcs_state_msg_t* const s,
+                   int                    const state_exchange_version)
 {
     switch (state_exchange_version)
     {
     case 0:                                       // V0 compatibility (0.8.1)
-        return (0 == gu_uuid_compare(&s->prim_uuid, &c->prim_uuid));
+        d->uuid   = s->prim_uuid;
+        d->seqno1 = 0;
+        d->seqno2 = 0;
+        break;
     default:
-        return ((0 == gu_uuid_compare(&s->group_uuid, &c->state_uuid)) &&
-                (s->received == c->state_seqno) &&
-                // what if they are different components.
-                // but have same group uuid and received(0)
-                // see gh24.
-                (s->prim_seqno == c->prim_seqno));
+        d->uuid   = s->group_uuid;
+        d->seqno1 = s->received;
+        // what if they are different components.
+        // but have same group uuid and received(0)
+        // see gh24.
+        d->seqno2 = s->prim_seqno;
     }
+
+    d->state = s;
+}
+
+static int
+state_digest_cmp (const void* const a_ptr, const void* const b_ptr)
+{
+    const struct state_digest* const a =
+        static_cast<const struct state_digest*>(a_ptr);
+    const struct state_digest* const b =
+        static_cast<const struct state_digest*>(b_ptr);
+
+    int const uuid_cmp (gu_uuid_compare (&a->uuid, &b->uuid));
+
+    if (uuid_cmp)               return uuid_cmp;
+    if (a->seqno1 != b->seqno1) return (a->seqno1 < b->seqno1 ? -1 : 1);
+    if (a->seqno2 != b->seqno2) return (a->seqno2 < b->seqno2 ? -1 : 1);
+
+    return 0;
 }
 
 /* try to find representative remerge candidate */
@@ -572,11 +615,24 @@ state_quorum_remerge (const gcs_state_msg_t* const states[],
         return NULL;
     }
 
-    int i, j;
+    struct state_digest* digests = GU_CALLOC(states_num, struct state_digest);
+
+    if (!digests) {
+        gu_error ("Quorum: could not allocate %zd bytes for re-merge check.",
+                  states_num * sizeof(struct state_digest));
+        gu_free (candidates);
+        return NULL;
+    }
+
+    int i;
+    int digests_num     = 0;
     int candidates_found = 0;
 
-    /* 1. Sort and count all nodes who have ever been JOINED by primary
-     *    component UUID */
+    /* 1. Digest the states of all nodes who have ever been JOINED and sort
+     *    the digests, so that nodes from the same primary component end up
+     *    in a contiguous run. This keeps candidate search near-linear in
+     *    membership size instead of comparing every state against every
+     *    candidate found so far. */
     for (i = 0; i < states_num; i++) {
         bool cond;
 
@@ -605,42 +661,51 @@ state_quorum_remerge (const gcs_state_msg_t* const states[],
             assert(bootstrap ||
                    gu_uuid_compare(&states[i]->prim_uuid, &GU_UUID_NIL));
 
-            for (j = 0; j < candidates_found; j++) {
-                if (state_match_candidate (states[i], &candidates[j],
-                                           quorum->version)) {
-                    assert(states[i]->prim_joined == candidates[j].prim_joined);
-                    // comment out following two lines for pc recovery
-                    // when nodes recoveried from state files, if their states
-                    // match, so candidates[j].found > 0.
-                    // However their prim_joined == 0.
-                    // assert(candidates[j].found < candidates[j].prim_joined);
-                    // assert(candidates[j].found > 0);
+            state_digest_init (&digests[digests_num], states[i],
+                               quorum->version);
+            digests_num++;
+        }
+    }
 
-                    candidates[j].found++;
+    qsort (digests, digests_num, sizeof(struct state_digest),
+           state_digest_cmp);
 
-                    candidates[j].rep =
-                        state_nodes_compare (candidates[j].rep, states[i]);
+    /* 2. Fold each run of equal digests into a re-merge candidate. */
+    for (i = 0; i < digests_num; i++) {
+        const gcs_state_msg_t* const s = digests[i].state;
 
-                    break;
-                }
-            }
+        if (i > 0 && 0 == state_digest_cmp (&digests[i - 1], &digests[i])) {
+            struct candidate* const c = &candidates[candidates_found - 1];
 
-            if (j == candidates_found) {
-                // we don't have this candidate in the list yet
-                candidates[j].prim_uuid   = states[i]->prim_uuid;
-                candidates[j].state_uuid  = states[i]->group_uuid;
-                candidates[j].state_seqno = states[i]->received;
-                candidates[j].prim_joined = states[i]->prim_joined;
-                candidates[j].rep         = states[i];
-                candidates[j].found       = 1;
-                candidates[j].prim_seqno  = states[i]->prim_seqno;
-                candidates_found++;
+            assert(s->prim_joined == c->prim_joined);
+            // comment out following two lines for pc recovery
+            // when nodes recoveried from state files, if their states
+            // match, so candidates[j].found > 0.
+            // However their prim_joined == 0.
+            // assert(c->found < c->prim_joined);
+            // assert(c->found > 0);
 
-                assert(candidates_found <= states_num);
-            }
+            c->found++;
+
+            c->rep = state_nodes_compare (c->rep, s);
+        }
+        else {
+            // the digest differs from the previous one - a new candidate
+            candidates[candidates_found].prim_uuid   = s->prim_uuid;
+            candidates[candidates_found].state_uuid  = s->group_uuid;
+            candidates[candidates_found].state_seqno = s->received;
+            candidates[candidates_found].prim_joined = s->prim_joined;
+            candidates[candidates_found].rep         = s;
+            candidates[candidates_found].found       = 1;
+            candidates[candidates_found].prim_seqno  = s->prim_seqno;
+            candidates_found++;
+
+            assert(candidates_found <= states_num);
         }
     }
 
+    gu_free (digests);
+
 
     const gcs_state_msg_t* rep = NULL;
 
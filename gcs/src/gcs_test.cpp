@@ -61,6 +61,12 @@ typedef struct gcs_test_thread
     long              n_tries;
     void*             msg;
     char*             log_msg;
+    /* per-stage latency samples (ns), grown on demand; only REPL
+     * threads fill these */
+    long long*        lat_repl;
+    long long*        lat_to;
+    size_t            n_lat;
+    size_t            max_lat;
 }
 gcs_test_thread_t;
 
@@ -76,6 +82,10 @@ static long gcs_test_thread_create (gcs_test_thread_t *t, long id, long n_tries)
     t->act.seqno_l  = GCS_SEQNO_ILL;
     t->act.type     = GCS_ACT_TORDERED;
     t->n_tries      = n_tries;
+    t->lat_repl     = NULL;
+    t->lat_to       = NULL;
+    t->n_lat        = 0;
+    t->max_lat      = 0;
 
     if (t->msg)
     {
@@ -88,11 +98,30 @@ static long gcs_test_thread_create (gcs_test_thread_t *t, long id, long n_tries)
 
 static long gcs_test_thread_destroy (gcs_test_thread_t *t)
 {
-    if (t->msg)     free (t->msg);
-    if (t->log_msg) free (t->log_msg);
+    if (t->msg)      free (t->msg);
+    if (t->log_msg)  free (t->log_msg);
+    if (t->lat_repl) free (t->lat_repl);
+    if (t->lat_to)   free (t->lat_to);
     return 0;
 }
 
+static void gcs_test_thread_lat_push (gcs_test_thread_t* t,
+                                      long long repl_ns, long long to_ns)
+{
+    if (t->n_lat == t->max_lat) {
+        size_t max = t->max_lat ? t->max_lat * 2 : 4096;
+        long long* r = (long long*)realloc (t->lat_repl, max*sizeof(long long));
+        long long* o = (long long*)realloc (t->lat_to,   max*sizeof(long long));
+        if (!r || !o) return; // benchmark goes on, sample is dropped
+        t->lat_repl = r;
+        t->lat_to   = o;
+        t->max_lat  = max;
+    }
+    t->lat_repl[t->n_lat] = repl_ns;
+    t->lat_to  [t->n_lat] = to_ns;
+    t->n_lat++;
+}
+
 typedef struct gcs_test_thread_pool
 {
     long              n_threads;
@@ -170,6 +199,10 @@ gcs_test_thread_pool_destroy (gcs_test_thread_pool_t* pool)
 static pthread_mutex_t make_msg_lock = PTHREAD_MUTEX_INITIALIZER;
 //static long total_tries;
 
+/* action size distribution: uniform in [msg_size_min, msg_size_max] */
+static long msg_size_min = 1;
+static long msg_size_max = 1300;
+
 static inline long
 test_make_msg (char* msg, const long mlen)
 {
@@ -185,8 +218,8 @@ test_make_msg (char* msg, const long mlen)
                         rand(), (unsigned long long)count++, gcs_test_data);
     }
     else {
-        len = rand() % mlen + 1; // just random length, we don't care about
-                                 // contents
+        // just random length, we don't care about contents
+        len = msg_size_min + rand() % (msg_size_max - msg_size_min + 1);
     }
 
     if (len >= mlen)
@@ -377,11 +410,15 @@ void *gcs_test_repl (void *arg)
 
     while (thread->n_tries)
     {
+        long long t_begin, t_repld;
+
         ret = test_before_send (thread);
         if (ret < 0) break;
 
         /* replicate message */
+        t_begin = gu_time_monotonic ();
         ret = gcs_repl (gcs, &thread->act, false);
+        t_repld = gu_time_monotonic ();
 
         if (ret < 0) {
             assert (thread->act.seqno_g == GCS_SEQNO_ILL);
@@ -393,6 +430,8 @@ void *gcs_test_repl (void *arg)
         size_repld += thread->act.size;
 //      usleep ((rand() & 1) << 1);
         test_after_recv (thread);
+        gcs_test_thread_lat_push (thread, t_repld - t_begin,
+                                  gu_time_monotonic() - t_repld);
 //      puts (thread->log_msg); fflush (stdout);
     }
 //    fprintf (stderr, "REPL thread %ld exiting: %s\n",
@@ -622,6 +661,8 @@ typedef struct gcs_test_conf
     long n_repl;
     long n_send;
     long n_recv;
+    long size_min;
+    long size_max;
     const char* backend;
 }
 gcs_test_conf_t;
@@ -633,14 +674,25 @@ static long gcs_test_conf (gcs_test_conf_t *conf, long argc, char *argv[])
     char *endptr;
 
     /* defaults */
-    conf->n_tries = 10;
-    conf->n_repl  = 10;
-    conf->n_send  = 0;
-    conf->n_recv  = 1;
-    conf->backend = DEFAULT_BACKEND;
+    conf->n_tries  = 10;
+    conf->n_repl   = 10;
+    conf->n_send   = 0;
+    conf->n_recv   = 1;
+    conf->size_min = 1;
+    conf->size_max = 1300;
+    conf->backend  = DEFAULT_BACKEND;
 
     switch (argc)
     {
+    case 8:
+        conf->size_max = strtol (argv[7], &endptr, 10);
+        if ('\0' != *endptr) goto error;
+        // fall through
+    case 7:
+        conf->size_min = strtol (argv[6], &endptr, 10);
+        if ('\0' != *endptr) goto error;
+        if (7 == argc) conf->size_max = conf->size_min;
+        // fall through
     case 6:
         conf->n_recv = strtol (argv[5], &endptr, 10);
         if ('\0' != *endptr) goto error;
@@ -664,16 +716,21 @@ static long gcs_test_conf (gcs_test_conf_t *conf, long argc, char *argv[])
         break;
     }
 
+    if (conf->size_min < 1 || conf->size_max < conf->size_min ||
+        conf->size_max > MAX_MSG_LEN) goto error;
+
     printf ("Config: n_tries = %ld, n_repl = %ld, n_send = %ld, n_recv = %ld, "
-            "backend = %s\n",
+            "size = [%ld, %ld], backend = %s\n",
             conf->n_tries, conf->n_repl, conf->n_send, conf->n_recv,
-            conf->backend);
+            conf->size_min, conf->size_max, conf->backend);
 
     return 0;
 error:
-    printf ("Usage: %s [backend] [tries:%ld] [repl threads:%ld] "
-            "[send threads: %ld] [recv threads: %ld]\n",
-            argv[0], conf->n_tries, conf->n_repl, conf->n_send, conf->n_recv);
+    printf ("Usage: %s [backend] [seconds:%ld] [repl threads:%ld] "
+            "[send threads: %ld] [recv threads: %ld] "
+            "[size min: %ld] [size max: %ld]\n",
+            argv[0], conf->n_tries, conf->n_repl, conf->n_send, conf->n_recv,
+            conf->size_min, conf->size_max);
     exit (EXIT_SUCCESS);
 }
 
@@ -685,6 +742,48 @@ test_print_stat (long msgs, size_t size, double interval)
             size >> 10, (double)(size >> 10)/interval);
 }
 
+static int test_lat_cmp (const void* a, const void* b)
+{
+    long long const l(*(const long long*)a);
+    long long const r(*(const long long*)b);
+    return (l < r ? -1 : l > r ? 1 : 0);
+}
+
+/* merges per-thread samples of one stage, reports percentiles in usec */
+static void
+test_print_latency (const gcs_test_thread_pool_t* pool, const char* stage,
+                    bool to_stage)
+{
+    size_t total = 0;
+    long i;
+
+    for (i = 0; i < pool->n_threads; i++) total += pool->threads[i].n_lat;
+
+    if (0 == total) return;
+
+    long long* all = (long long*)malloc (total * sizeof(long long));
+    if (!all) return;
+
+    size_t n = 0;
+    for (i = 0; i < pool->n_threads; i++) {
+        const gcs_test_thread_t* t = pool->threads + i;
+        memcpy (all + n, to_stage ? t->lat_to : t->lat_repl,
+                t->n_lat * sizeof(long long));
+        n += t->n_lat;
+    }
+
+    qsort (all, total, sizeof(long long), test_lat_cmp);
+
+#define LAT_USEC(p) (all[(size_t)((p) * (total - 1))] / 1000.0)
+    printf ("%s latency (usec): p50 %9.1f  p90 %9.1f  p99 %9.1f  "
+            "max %9.1f (%zu samples)\n",
+            stage, LAT_USEC(.50), LAT_USEC(.90), LAT_USEC(.99), LAT_USEC(1.),
+            total);
+#undef LAT_USEC
+
+    free (all);
+}
+
 int main (int argc, char *argv[])
 {
     long err = 0;
@@ -724,7 +823,9 @@ int main (int argc, char *argv[])
     if ((err  = gcs_open   (gcs, channel, conf.backend, bstrap))) goto out;
     printf ("Connected\n");
 
-    msg_len = 1300;
+    msg_size_min = conf.size_min;
+    msg_size_max = conf.size_max;
+    msg_len = msg_size_max;
     if (msg_len > MAX_MSG_LEN) msg_len = MAX_MSG_LEN;
     gcs_conf_set_pkt_size (gcs, 7570); // to test fragmentation
 
@@ -741,8 +842,10 @@ int main (int argc, char *argv[])
     gcs_test_thread_pool_start (&repl_pool);
     gcs_test_thread_pool_start (&send_pool);
 
-    printf ("Press any key to start the load:");
-    fgetc (stdin);
+    if (isatty (fileno (stdin))) {
+        printf ("Press any key to start the load:");
+        fgetc (stdin);
+    }
 
     puts ("Started load.");
     gettimeofday (&t_begin, NULL);
@@ -788,10 +891,18 @@ int main (int argc, char *argv[])
         printf ("Overhead at 10000 actions/sec: %5.2f%%\n",
                 1000000.0 * interval / (msg_repld + msg_recvd));
         puts("");
+        /* per-stage breakdown for the REPL path: "repl" is the gcs_repl()
+         * call itself (group ordering), "TO" is everything after it up to
+         * action release (TO grab, last-applied bookkeeping) */
+        test_print_latency (&repl_pool, "repl", false);
+        test_print_latency (&repl_pool, "TO  ", true);
+        puts("");
     }
 
-    printf ("Press any key to exit the program:\n");
-    fgetc (stdin);
+    if (isatty (fileno (stdin))) {
+        printf ("Press any key to exit the program:\n");
+        fgetc (stdin);
+    }
 
     printf ("Freeing GCS connection handle...");
     if ((err = gcs_destroy (gcs))) goto out;
@@ -223,8 +223,12 @@ START_TEST (gcs_sm_test_pause)
     int       q_len_max;
     int       q_len_min;
     double    q_len_avg;
+    long long q_wait_p99;
+    long long q_wait_p999;
+    long long q_entered;
     long long paused_ns;
     double    paused_avg;
+    long long paused_events;
 
     gcs_sm_t* sm = gcs_sm_create(4, 1);
 
@@ -238,9 +242,14 @@ START_TEST (gcs_sm_test_pause)
     gu_thread_t thr;
 
     gcs_sm_stats_get (sm, &q_len, &q_len_max, &q_len_min, &q_len_avg,
-                      &paused_ns, &paused_avg);
+                      &q_wait_p99, &q_wait_p999, &q_entered,
+                      &paused_ns, &paused_avg, &paused_events);
     fail_if (paused_ns != 0,
              "paused_ns: expected 0, got %lld", paused_ns);
+    fail_if (q_entered != 0,
+             "q_entered: expected 0, got %lld", q_entered);
+    fail_if (paused_events != 0,
+             "paused_events: expected 0, got %lld", paused_events);
     fail_if (fabs(paused_avg) > EPS,
              "paused_avg: expected <= %e, got %e", EPS, fabs(paused_avg));
     fail_if (fabs(q_len_avg) > EPS,
@@ -260,9 +269,12 @@ START_TEST (gcs_sm_test_pause)
 
     // testing taking stats in the middle of the pause pt. 1
     gcs_sm_stats_get (sm, &q_len, &q_len_max, &q_len_min, &q_len_avg,
-                      &paused_ns, &paused_avg);
+                      &q_wait_p99, &q_wait_p999, &q_entered,
+                      &paused_ns, &paused_avg, &paused_events);
     fail_if (paused_ns  <= 0.0);
     fail_if (paused_avg <= 0.0);
+    fail_if (paused_events != 1,
+             "paused_events: expected 1, got %lld", paused_events);
     fail_if (fabs(q_len_avg) > EPS,
              "q_len_avg: expected <= %e, got %e", EPS, fabs(q_len_avg));
 
@@ -279,7 +291,8 @@ START_TEST (gcs_sm_test_pause)
     // testing taking stats in the middle of the pause pt. 2
     long long tmp;
     gcs_sm_stats_get (sm, &q_len, &q_len_max, &q_len_min, &q_len_avg,
-                      &tmp, &paused_avg);
+                      &q_wait_p99, &q_wait_p999, &q_entered,
+                      &tmp, &paused_avg, &paused_events);
     fail_if (tmp <= paused_ns); paused_ns = tmp;
     fail_if (paused_avg <= 0.0);
     fail_if (fabs(q_len_avg) > EPS,
@@ -310,10 +323,15 @@ START_TEST (gcs_sm_test_pause)
             sm->wait_q_tail);
 
     gcs_sm_stats_get (sm, &q_len, &q_len_max, &q_len_min, &q_len_avg,
-                      &tmp, &paused_avg);
+                      &q_wait_p99, &q_wait_p999, &q_entered,
+                      &tmp, &paused_avg, &paused_events);
     fail_if (tmp < paused_ns); paused_ns = tmp;
     fail_if (fabs(paused_avg) > EPS,
              "paused_avg: expected <= %e, got %e", EPS, fabs(paused_avg));
+    fail_if (q_entered != 2,
+             "q_entered: expected 2, got %lld", q_entered);
+    fail_if (paused_events != 0, // flushed above
+             "paused_events: expected 0, got %lld", paused_events);
     fail_if (q_len != sm->users, "found q_len %d, expected = %d",
              q_len, sm->users);
     fail_if (q_len_max != q_len, "found q_len_max %d, expected = %d",
@@ -358,9 +376,12 @@ START_TEST (gcs_sm_test_pause)
     fail_if (pause_order != 3, "pause_order = %d, expected 3");
 
     gcs_sm_stats_get (sm, &q_len, &q_len_max, &q_len_min, &q_len_avg,
-                      &tmp, &paused_avg);
+                      &q_wait_p99, &q_wait_p999, &q_entered,
+                      &tmp, &paused_avg, &paused_events);
     fail_if (tmp <= paused_ns); paused_ns = tmp;
     fail_if (paused_avg <= 0.0);
+    fail_if (paused_events != 2,
+             "paused_events: expected 2, got %lld", paused_events);
     fail_if (fabs(q_len_avg) > EPS,
              "q_len_avg: expected <= %e, got %e", EPS, fabs(q_len_avg));
 
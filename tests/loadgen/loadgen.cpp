@@ -0,0 +1,548 @@
+/*
+ * Copyright (C) 2017 Codership Oy <info@codership.com>
+ */
+/***********************************************************************/
+/*  Distributed load driver for the wsrep provider.                    */
+/*                                                                     */
+/*  One process is one cluster node: it loads libgalera_smm.so the     */
+/*  same way a DBMS would, joins the cluster and replicates synthetic  */
+/*  writesets with parameterized payload size, key skew and conflict   */
+/*  rate, while applier threads consume replicated writesets from the  */
+/*  other nodes. Throughput and commit latency percentiles are         */
+/*  reported per interval and summarized on exit, so that production   */
+/*  regressions can be reproduced on lab hardware without a DBMS on    */
+/*  top. See README in this directory for multi-node invocation.      */
+/***********************************************************************/
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <assert.h>
+#include <math.h>
+#include <dlfcn.h>
+
+#include "wsrep_api.h"
+
+#include "gu_atomic.h"
+#include "gu_time.h"
+#include "gu_hdr_histogram.hpp"
+
+static struct config
+{
+    const char* provider;   // path to libgalera_smm.so
+    const char* cluster;    // cluster name
+    const char* address;    // gcomm:// cluster address
+    const char* node_name;  // symbolic name of this node
+    const char* base_addr;  // address for the provider to bind to
+    const char* options;    // extra provider options string
+    long        writers;    // writer (master) threads
+    long        appliers;   // applier (slave) threads
+    long        duration;   // test duration, seconds
+    long        interval;   // reporting interval, seconds
+    size_t      payload;    // writeset payload size, bytes
+    long        keyspace;   // number of distinct keys
+    double      skew;       // key skew exponent, 1.0 = uniform
+    long        hot_keys;   // size of the hot key set
+    double      conflict;   // probability of hitting the hot set
+    bool        bootstrap;  // bootstrap a new cluster
+}
+config =
+{
+    "../../libgalera_smm.so",
+    "loadgen",
+    "gcomm://",
+    "loadgen_node",
+    "",
+    "",
+    4,      // writers
+    4,      // appliers
+    60,     // duration
+    10,     // interval
+    1024,   // payload
+    100000, // keyspace
+    1.0,    // skew
+    100,    // hot_keys
+    0.0,    // conflict
+    false
+};
+
+static wsrep_t* provider = NULL;
+
+/* synced_cb/view_cb handshake */
+static pthread_mutex_t sync_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  sync_cond = PTHREAD_COND_INITIALIZER;
+static bool            synced    = false;
+
+static volatile bool stop_writers = false;
+
+/* global counters, updated by writer/applier threads */
+static volatile long long commits   = 0;
+static volatile long long conflicts = 0;
+static volatile long long repl_bytes = 0;
+static volatile long long applied   = 0;
+
+/* commit latency over the whole replicate + certify + commit path */
+static gu::HdrHistogram latency;
+
+/* monotonically growing source of node-unique trx IDs */
+static volatile long long trx_source = 0;
+
+static void
+logger_cb (wsrep_log_level_t const level, const char* const msg)
+{
+    static const char* const prefix[] = { "FATAL", " ERROR", "  WARN",
+                                          "  INFO", " DEBUG" };
+    fprintf (stderr, "%s: %s\n", prefix[level], msg);
+}
+
+static enum wsrep_cb_status
+view_cb (void*                    app_ctx,
+         void*                    recv_ctx,
+         const wsrep_view_info_t* view,
+         const char*              state,
+         size_t                   state_len,
+         void**                   sst_req,
+         size_t*                  sst_req_len)
+{
+    (void)app_ctx; (void)recv_ctx; (void)state; (void)state_len;
+
+    fprintf (stdout, "loadgen: view %lld, status %d, members %d, my_idx %d\n",
+             (long long)view->view, (int)view->status, view->memb_num,
+             view->my_idx);
+
+    *sst_req     = NULL;
+    *sst_req_len = 0;
+
+    if (view->state_gap)
+    {
+        /* there is no application state to transfer - request trivial ST
+         * so that the provider serves the missing writesets through IST */
+        *sst_req     = strdup (WSREP_STATE_TRANSFER_TRIVIAL);
+        *sst_req_len = strlen (WSREP_STATE_TRANSFER_TRIVIAL) + 1;
+    }
+
+    return WSREP_CB_SUCCESS;
+}
+
+static enum wsrep_cb_status
+apply_cb (void*                   recv_ctx,
+          const void*             data,
+          size_t                  size,
+          uint32_t                flags,
+          const wsrep_trx_meta_t* meta)
+{
+    (void)recv_ctx; (void)data; (void)flags; (void)meta;
+
+    /* a real application would apply the writeset here; the driver
+     * measures pure replication pipeline cost, so just account it */
+    gu_atomic_fetch_and_add (&applied, (long long)size);
+
+    return WSREP_CB_SUCCESS;
+}
+
+static enum wsrep_cb_status
+commit_cb (void*                   recv_ctx,
+           const void*             trx_handle,
+           uint32_t                flags,
+           const wsrep_trx_meta_t* meta,
+           wsrep_bool_t*           exit_loop,
+           wsrep_bool_t            commit)
+{
+    (void)recv_ctx; (void)trx_handle; (void)flags; (void)meta; (void)commit;
+    *exit_loop = false;
+    return WSREP_CB_SUCCESS;
+}
+
+static enum wsrep_cb_status
+unordered_cb (void* recv_ctx, const void* data, size_t size)
+{
+    (void)recv_ctx; (void)data; (void)size;
+    return WSREP_CB_SUCCESS;
+}
+
+static enum wsrep_cb_status
+sst_donate_cb (void*               app_ctx,
+               void*               recv_ctx,
+               const void*         msg,
+               size_t              msg_len,
+               const wsrep_gtid_t* state_id,
+               const char*         state,
+               size_t              state_len,
+               wsrep_bool_t        bypass)
+{
+    (void)app_ctx; (void)recv_ctx; (void)msg; (void)msg_len;
+    (void)state; (void)state_len; (void)bypass;
+
+    /* no application state - report the transfer complete right away */
+    provider->sst_sent (provider, state_id, 0);
+
+    return WSREP_CB_SUCCESS;
+}
+
+static void
+synced_cb (void* app_ctx)
+{
+    (void)app_ctx;
+    pthread_mutex_lock   (&sync_lock);
+    synced = true;
+    pthread_cond_signal  (&sync_cond);
+    pthread_mutex_unlock (&sync_lock);
+}
+
+static void*
+applier_thread (void* const arg)
+{
+    wsrep_status_t const ret(provider->recv (provider, arg));
+
+    if (ret != WSREP_OK && ret != WSREP_CONN_FAIL)
+    {
+        fprintf (stderr, "loadgen: recv() failed: %d\n", ret);
+    }
+
+    return NULL;
+}
+
+/* Pick a key: with probability config.conflict take one of the few hot
+ * keys (this is what makes concurrent writers certify against each
+ * other), otherwise draw from the full keyspace with a power-law skew -
+ * skew 1.0 is uniform, larger values concentrate the mass on low keys. */
+static long
+pick_key (unsigned int* const seed)
+{
+    double const u((double)rand_r (seed) / RAND_MAX);
+
+    if (u < config.conflict)
+    {
+        return rand_r (seed) % config.hot_keys;
+    }
+
+    double const v((double)rand_r (seed) / RAND_MAX);
+
+    return config.hot_keys +
+        (long)((config.keyspace - config.hot_keys) * pow (v, config.skew));
+}
+
+static void*
+writer_thread (void* const arg)
+{
+    long const       id((long)(uintptr_t)arg);
+    wsrep_conn_id_t const conn_id(id + 1);
+    unsigned int     seed(id * 2654435761U + getpid());
+
+    char* const payload(static_cast<char*>(malloc (config.payload)));
+    for (size_t i(0); i < config.payload; i++) payload[i] = rand_r (&seed);
+
+    wsrep_ws_handle_t ws = { 0, NULL };
+
+    while (!stop_writers)
+    {
+        wsrep_trx_id_t const trx_id(gu_atomic_fetch_and_add (&trx_source, 1));
+        wsrep_ws_handle_for_trx (&ws, trx_id);
+
+        long     const row(pick_key (&seed));
+        wsrep_buf_t key_parts[2] = {
+            { config.cluster, strlen (config.cluster) },
+            { &row,           sizeof (row)            }
+        };
+        wsrep_key_t const key = { key_parts, 2 };
+
+        wsrep_buf_t const data = { payload, config.payload };
+
+        wsrep_trx_meta_t meta = { WSREP_GTID_UNDEFINED,
+                                  WSREP_SEQNO_UNDEFINED };
+
+        wsrep_status_t ret(provider->append_key (provider, &ws, &key, 1,
+                                                 WSREP_KEY_EXCLUSIVE, true));
+        if (ret == WSREP_OK)
+        {
+            ret = provider->append_data (provider, &ws, &data, 1,
+                                         WSREP_DATA_ORDERED, true);
+        }
+
+        if (ret != WSREP_OK)
+        {
+            fprintf (stderr, "loadgen: writeset population failed: %d\n", ret);
+            break;
+        }
+
+        long long const start(gu_time_monotonic());
+
+        ret = provider->replicate_pre_commit (provider, conn_id, &ws,
+                                              WSREP_FLAG_COMMIT, &meta);
+
+        switch (ret)
+        {
+        case WSREP_OK:
+            provider->post_commit (provider, &ws);
+            latency.record (gu_time_monotonic() - start);
+            gu_atomic_fetch_and_add (&commits, 1);
+            gu_atomic_fetch_and_add (&repl_bytes, (long long)config.payload);
+            break;
+        case WSREP_TRX_FAIL:
+        case WSREP_BF_ABORT:
+        case WSREP_PRECOMMIT_ABORT:
+            provider->post_rollback (provider, &ws);
+            gu_atomic_fetch_and_add (&conflicts, 1);
+            break;
+        default:
+            fprintf (stderr, "loadgen: replication failed: %d\n", ret);
+            stop_writers = true;
+        }
+    }
+
+    provider->free_connection (provider, conn_id);
+    free (payload);
+
+    return NULL;
+}
+
+static void
+report (long long const elapsed_sec,
+        long long const d_commits,
+        long long const d_conflicts,
+        long long const d_bytes,
+        long long const d_applied)
+{
+    fprintf (stdout,
+             "%4llds: %lld trx/s, %.2f MB/s out, %.2f MB/s in, "
+             "%lld conflicts, latency %s\n",
+             elapsed_sec,
+             d_commits   / config.interval,
+             (double)d_bytes   / config.interval / (1 << 20),
+             (double)d_applied / config.interval / (1 << 20),
+             d_conflicts,
+             latency.to_string().c_str());
+    fflush (stdout);
+}
+
+static void
+usage (const char* const name)
+{
+    fprintf (stderr,
+             "Usage: %s [options]\n"
+             "  -p <path>  wsrep provider library (%s)\n"
+             "  -g <name>  cluster name (%s)\n"
+             "  -a <addr>  cluster address, gcomm://... (%s)\n"
+             "  -n <name>  node name (%s)\n"
+             "  -l <addr>  base (listen) address for this node\n"
+             "  -o <opts>  extra provider options string\n"
+             "  -w <num>   writer threads (%ld)\n"
+             "  -r <num>   applier threads (%ld)\n"
+             "  -t <sec>   test duration (%ld)\n"
+             "  -i <sec>   reporting interval (%ld)\n"
+             "  -s <bytes> writeset payload size (%zu)\n"
+             "  -k <num>   keyspace size (%ld)\n"
+             "  -z <exp>   key skew exponent, 1.0 = uniform (%.1f)\n"
+             "  -H <num>   hot key set size (%ld)\n"
+             "  -c <prob>  probability of writing a hot key (%.2f)\n"
+             "  -b         bootstrap a new cluster (first node)\n",
+             name, config.provider, config.cluster, config.address,
+             config.node_name, config.writers, config.appliers,
+             config.duration, config.interval, config.payload,
+             config.keyspace, config.skew, config.hot_keys,
+             config.conflict);
+}
+
+static bool
+parse_args (int argc, char* argv[])
+{
+    int opt;
+
+    while ((opt = getopt (argc, argv, "p:g:a:n:l:o:w:r:t:i:s:k:z:H:c:bh"))
+           != -1)
+    {
+        switch (opt)
+        {
+        case 'p': config.provider  = optarg;       break;
+        case 'g': config.cluster   = optarg;       break;
+        case 'a': config.address   = optarg;       break;
+        case 'n': config.node_name = optarg;       break;
+        case 'l': config.base_addr = optarg;       break;
+        case 'o': config.options   = optarg;       break;
+        case 'w': config.writers   = atol (optarg); break;
+        case 'r': config.appliers  = atol (optarg); break;
+        case 't': config.duration  = atol (optarg); break;
+        case 'i': config.interval  = atol (optarg); break;
+        case 's': config.payload   = atol (optarg); break;
+        case 'k': config.keyspace  = atol (optarg); break;
+        case 'z': config.skew      = atof (optarg); break;
+        case 'H': config.hot_keys  = atol (optarg); break;
+        case 'c': config.conflict  = atof (optarg); break;
+        case 'b': config.bootstrap = true;         break;
+        case 'h':
+        default:
+            usage (argv[0]);
+            return false;
+        }
+    }
+
+    if (config.writers < 1 || config.appliers < 1 || config.payload < 1 ||
+        config.keyspace < 1 || config.hot_keys > config.keyspace ||
+        config.conflict < 0.0 || config.conflict > 1.0 || config.skew <= 0.0)
+    {
+        fprintf (stderr, "%s: inconsistent parameters\n", argv[0]);
+        return false;
+    }
+
+    return true;
+}
+
+/* wsrep_load() lives in libwsrep.a which is part of the DBMS build, not
+ * of this tree, so resolve the provider entry point by hand */
+static int
+load_provider (const char* const path)
+{
+    void* const dlh(dlopen (path, RTLD_NOW | RTLD_LOCAL));
+
+    if (!dlh)
+    {
+        fprintf (stderr, "loadgen: failed to open '%s': %s\n",
+                 path, dlerror());
+        return EINVAL;
+    }
+
+    typedef int (*loader_fn) (wsrep_t*);
+    union { void* sym; loader_fn fn; } loader;
+    loader.sym = dlsym (dlh, "wsrep_loader");
+
+    if (!loader.sym)
+    {
+        fprintf (stderr, "loadgen: no wsrep_loader in '%s': %s\n",
+                 path, dlerror());
+        return EINVAL;
+    }
+
+    provider = static_cast<wsrep_t*>(malloc (sizeof (wsrep_t)));
+
+    int const ret(loader.fn (provider));
+
+    if (ret != WSREP_OK)
+    {
+        fprintf (stderr, "loadgen: provider initialization failed: %d\n", ret);
+        return EINVAL;
+    }
+
+    provider->dlh = dlh;
+
+    return 0;
+}
+
+int
+main (int argc, char* argv[])
+{
+    if (!parse_args (argc, argv)) return EXIT_FAILURE;
+
+    if (load_provider (config.provider)) return EXIT_FAILURE;
+
+    struct wsrep_init_args args;
+    memset (&args, 0, sizeof (args));
+
+    args.app_ctx         = NULL;
+    args.node_name       = config.node_name;
+    args.node_address    = config.base_addr;
+    args.node_incoming   = "";
+    args.data_dir        = ".";
+    args.options         = config.options;
+    args.proto_ver       = 1;
+    args.state_id        = &WSREP_GTID_UNDEFINED;
+    args.state           = NULL;
+    args.state_len       = 0;
+    args.logger_cb       = logger_cb;
+    args.view_handler_cb = view_cb;
+    args.apply_cb        = apply_cb;
+    args.commit_cb       = commit_cb;
+    args.unordered_cb    = unordered_cb;
+    args.sst_donate_cb   = sst_donate_cb;
+    args.synced_cb       = synced_cb;
+
+    wsrep_status_t ret(provider->init (provider, &args));
+    if (ret != WSREP_OK)
+    {
+        fprintf (stderr, "loadgen: init() failed: %d\n", ret);
+        return EXIT_FAILURE;
+    }
+
+    ret = provider->connect (provider, config.cluster, config.address, "",
+                             config.bootstrap);
+    if (ret != WSREP_OK)
+    {
+        fprintf (stderr, "loadgen: connect(%s) failed: %d\n",
+                 config.address, ret);
+        return EXIT_FAILURE;
+    }
+
+    pthread_t* const recv_thr(static_cast<pthread_t*>
+                              (calloc (config.appliers, sizeof (pthread_t))));
+    for (long i(0); i < config.appliers; i++)
+    {
+        pthread_create (&recv_thr[i], NULL, applier_thread, NULL);
+    }
+
+    pthread_mutex_lock (&sync_lock);
+    while (!synced) pthread_cond_wait (&sync_cond, &sync_lock);
+    pthread_mutex_unlock (&sync_lock);
+
+    fprintf (stdout, "loadgen: synced, starting %ld writers for %lds "
+             "(payload %zu, keyspace %ld, skew %.1f, conflict %.2f)\n",
+             config.writers, config.duration, config.payload,
+             config.keyspace, config.skew, config.conflict);
+
+    pthread_t* const writer_thr(static_cast<pthread_t*>
+                                (calloc (config.writers, sizeof (pthread_t))));
+    for (long i(0); i < config.writers; i++)
+    {
+        pthread_create (&writer_thr[i], NULL, writer_thread,
+                        (void*)(uintptr_t)i);
+    }
+
+    long long last_commits(0), last_conflicts(0), last_bytes(0),
+              last_applied(0);
+
+    for (long long elapsed(0); elapsed < config.duration && !stop_writers;)
+    {
+        sleep (config.interval);
+        elapsed += config.interval;
+
+        long long const c(commits),  f(conflicts);
+        long long const b(repl_bytes), a(applied);
+
+        report (elapsed, c - last_commits, f - last_conflicts,
+                b - last_bytes, a - last_applied);
+
+        last_commits = c; last_conflicts = f;
+        last_bytes   = b; last_applied   = a;
+    }
+
+    stop_writers = true;
+
+    for (long i(0); i < config.writers; i++)
+    {
+        pthread_join (writer_thr[i], NULL);
+    }
+
+    fprintf (stdout, "loadgen: total %lld commits, %lld conflicts "
+             "(%.2f%%), latency %s\n",
+             commits, conflicts,
+             commits + conflicts > 0 ?
+             100.0 * conflicts / (commits + conflicts) : 0.0,
+             latency.to_string().c_str());
+
+    provider->disconnect (provider);
+
+    for (long i(0); i < config.appliers; i++)
+    {
+        pthread_join (recv_thr[i], NULL);
+    }
+
+    void* const dlh(provider->dlh);
+    provider->free (provider);
+    free (provider);
+    free (writer_thr);
+    free (recv_thr);
+    dlclose (dlh);
+
+    return EXIT_SUCCESS;
+}